@@ -639,7 +639,8 @@ macro (get_boost)
 
   # Boost components for (non-Python) libraries
   set (BOOST_REQUIRED_COMPONENTS_FOR_LIB
-    date_time random iostreams serialization filesystem system locale regex)
+    date_time random iostreams serialization filesystem system locale regex
+    thread)
 
   # Boost components for Python extensions
   if (NEED_PYTHON)
@@ -17,9 +17,19 @@ create table optd_por (
  envelope_id int(11) default NULL,
  date_from date default NULL,
  date_until date default NULL,
- serialised_place varchar(12000) default NULL
+ serialised_place_pb blob default NULL
 );
 
+--
+-- Version of the schema (2: the POR are stored as Protobuf records, rather
+-- than raw data strings, within the serialised_place_pb column)
+--
+drop table if exists optd_por_schema;
+create table optd_por_schema (
+ version int(11) NOT NULL
+);
+insert into optd_por_schema values (2);
+
 --
 -- MySQL/MariaDB standard load statement (however, there is no correspondance
 -- between the table and CSV file formats)
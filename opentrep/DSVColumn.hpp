@@ -0,0 +1,94 @@
+#ifndef __OPENTREP_DSVCOLUMN_HPP
+#define __OPENTREP_DSVCOLUMN_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+#include <vector>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * @brief Enumeration of the columns which may be selected for the
+   *        delimiter-separated (CSV and TSV) output formats.
+   *
+   * The labels are the same as the keys of the JSON output format
+   * (e.g., "iata_code", "lat", "matching_percentage"), and are used
+   * for the header line.
+   */
+  struct DSVColumn {
+  public:
+    typedef enum {
+      IATA_CODE = 0,
+      GEONAMES_ID,
+      LATITUDE,
+      LONGITUDE,
+      COUNTRY_CODE,
+      PAGE_RANK,
+      MATCHING_PERCENTAGE,
+      CORRECTED_KEYWORDS,
+      LAST_VALUE
+    } EN_DSVColumn;
+
+    /**
+     * List of columns, in the order in which they are output.
+     */
+    typedef std::vector<EN_DSVColumn> DSVColumnList_T;
+
+    /**
+     * Get the label as a string (e.g., "iata_code", "lat").
+     */
+    static const std::string& getLabel (const EN_DSVColumn&);
+
+    /**
+     * Get the column value from its label (e.g., "iata_code", "lat").
+     */
+    static EN_DSVColumn getColumn (const std::string&);
+
+    /**
+     * List the labels.
+     */
+    static std::string describeLabels();
+
+    /**
+     * Get the list of all the columns, in the order of the enumeration.
+     */
+    static const DSVColumnList_T& getAllColumns();
+
+    /**
+     * Parse a comma-separated list of column labels (e.g.,
+     * "iata_code,lat,lon"). An empty string gives all the columns.
+     *
+     * An exception (CodeConversionException) is thrown when a label is
+     * not known.
+     *
+     * @param const std::string& Comma-separated list of column labels.
+     * @return DSVColumnList_T List of columns.
+     */
+    static DSVColumnList_T parseColumnList (const std::string&);
+
+  private:
+    /**
+     * Default constructor.
+     */
+    DSVColumn();
+
+
+  private:
+    /**
+     * String version of the enumeration.
+     */
+    static const std::string _labels[LAST_VALUE];
+  };
+
+  /**
+   * List of columns of the delimiter-separated output formats.
+   */
+  typedef DSVColumn::DSVColumnList_T DSVColumnList_T;
+
+}
+#endif // __OPENTREP_DSVCOLUMN_HPP
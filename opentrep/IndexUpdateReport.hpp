@@ -0,0 +1,166 @@
+#ifndef __OPENTREP_INDEXUPDATEREPORT_HPP
+#define __OPENTREP_INDEXUPDATEREPORT_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <iosfwd>
+#include <string>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/OPENTREP_Abstract.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * @brief Structure reporting the outcome of an incremental update of
+   *        the Xapian index and/or SQL database, from a new version of
+   *        the POR (points of reference) data file.
+   *
+   * Every POR record of the new file is either added (it was not indexed
+   * yet), changed (its content differs from the indexed one) or unchanged.
+   * The indexed POR records, which are no longer in the new file, are
+   * removed.
+   */
+  struct IndexUpdateReport : public OPENTREP_Abstract {
+  public:
+    // //////////////// Getters ///////////////
+    /**
+     * Get the number of added POR records.
+     */
+    const NbOfDBEntries_T& getNbOfAddedPOR() const {
+      return _nbOfAddedPOR;
+    }
+
+    /**
+     * Get the number of changed POR records.
+     */
+    const NbOfDBEntries_T& getNbOfChangedPOR() const {
+      return _nbOfChangedPOR;
+    }
+
+    /**
+     * Get the number of removed POR records.
+     */
+    const NbOfDBEntries_T& getNbOfRemovedPOR() const {
+      return _nbOfRemovedPOR;
+    }
+
+    /**
+     * Get the number of unchanged POR records.
+     */
+    const NbOfDBEntries_T& getNbOfUnchangedPOR() const {
+      return _nbOfUnchangedPOR;
+    }
+
+    /**
+     * Get the number of POR records of the new POR data file, i.e.,
+     * the added, changed and unchanged ones.
+     */
+    NbOfDBEntries_T getNbOfPOR() const {
+      return _nbOfAddedPOR + _nbOfChangedPOR + _nbOfUnchangedPOR;
+    }
+
+
+  public:
+    // //////////////// Setters ///////////////
+    /**
+     * Count one more added POR record.
+     */
+    void incrementNbOfAddedPOR() {
+      ++_nbOfAddedPOR;
+    }
+
+    /**
+     * Count one more changed POR record.
+     */
+    void incrementNbOfChangedPOR() {
+      ++_nbOfChangedPOR;
+    }
+
+    /**
+     * Count one more removed POR record.
+     */
+    void incrementNbOfRemovedPOR() {
+      ++_nbOfRemovedPOR;
+    }
+
+    /**
+     * Count one more unchanged POR record.
+     */
+    void incrementNbOfUnchangedPOR() {
+      ++_nbOfUnchangedPOR;
+    }
+
+
+  public:
+    // ////////////// Display methods //////////////
+    /**
+     * Dump the structure into an output stream.
+     *
+     * @param ostream& the output stream.
+     */
+    void toStream (std::ostream&) const;
+
+    /**
+     * Read a structure from an input stream.
+     *
+     * @param istream& the input stream.
+     */
+    void fromStream (std::istream&);
+
+    /**
+     * Get the serialised version of the structure.
+     */
+    std::string toString() const;
+
+    /**
+     * Get a string describing the whole structure.
+     */
+    std::string describe() const;
+
+
+  public:
+    // ////////////// Constructors and destructors //////////////
+    /**
+     * Default constructor, for an update without any change.
+     */
+    IndexUpdateReport();
+
+    /**
+     * Default copy constructor.
+     */
+    IndexUpdateReport (const IndexUpdateReport&);
+
+    /**
+     * Destructor.
+     */
+    ~IndexUpdateReport();
+
+
+  private:
+    // //////////////////// Attributes ///////////////////////
+    /**
+     * Number of added POR records.
+     */
+    NbOfDBEntries_T _nbOfAddedPOR;
+
+    /**
+     * Number of changed POR records.
+     */
+    NbOfDBEntries_T _nbOfChangedPOR;
+
+    /**
+     * Number of removed POR records.
+     */
+    NbOfDBEntries_T _nbOfRemovedPOR;
+
+    /**
+     * Number of unchanged POR records.
+     */
+    NbOfDBEntries_T _nbOfUnchangedPOR;
+  };
+
+}
+#endif // __OPENTREP_INDEXUPDATEREPORT_HPP
@@ -10,13 +10,18 @@
 // OpenTREP
 #include <opentrep/OPENTREP_Types.hpp>
 #include <opentrep/DBType.hpp>
+#include <opentrep/PORParserType.hpp>
+#include <opentrep/SQLDBLoadMode.hpp>
 #include <opentrep/LocationList.hpp>
+#include <opentrep/OriginHint.hpp>
+#include <opentrep/IndexUpdateReport.hpp>
 #include <opentrep/DistanceErrorRule.hpp>
 
 namespace OPENTREP {
 
   // Forward declaration
   class OPENTREP_ServiceContext;
+  class IndexHotSwapper;
 
 
   /** 
@@ -58,6 +63,96 @@ namespace OPENTREP {
     NbOfMatches_T interpretTravelRequest (const std::string& iTravelQuery,
                                           LocationList_T&, WordList_T&);
 
+    /**
+     * Match the given string, thanks to a full-text search on the
+     * underlying Xapian index (named "database"), biasing the ranking
+     * towards the given origin (e.g., the position of the user).
+     *
+     * For ambiguous names (e.g., "san jose", "portland"), the POR (points
+     * of reference) close to that origin, and/or within the same country,
+     * are preferred. An empty origin hint gives the same results as
+     * the above method.
+     *
+     * @param const std::string& (Travel-related) query string (e.g.,
+     *        "san jose portland").
+     * @param LocationList_T& List of (geographical) locations, if any,
+     *        matching the given query string.
+     * @param WordList_T& List of non-matched words of the query string.
+     * @param const OriginHint& Origin of the travel request (geographical
+     *        coordinates and/or country code).
+     * @return NbOfMatches_T Number of matches. 
+     */
+    NbOfMatches_T interpretTravelRequest (const std::string& iTravelQuery,
+                                          LocationList_T&, WordList_T&,
+                                          const OriginHint&);
+
+
+    /**
+     * Find the POR (points of reference) nearest to a given geographical
+     * point, for instance the airports within 100 km of a GPS position,
+     * or the nearest railway station.
+     *
+     * The search relies on an in-memory spatial index (k-d tree), built
+     * from the Xapian database (index) at the first call, and re-built
+     * whenever the Xapian database file-path changes (e.g., when the
+     * deployment number is toggled) or the Xapian index is re-indexed
+     * (i.e., marked as ready again). The Xapian database is kept open
+     * from a call to the next one, just reopened on its latest revision.
+     *
+     * @param const Latitude_T& Latitude of the point, in degrees.
+     * @param const Longitude_T& Longitude of the point, in degrees.
+     * @param const Distance_T& Search radius, in kilometers. A null or
+     *        negative radius means that the distance is not bounded.
+     * @param const NbOfMatches_T& Maximum number of POR to be returned.
+     *        Zero means that all the POR within the radius are returned.
+     * @param const std::string& Geonames feature code (e.g., AIRP, RSTN)
+     *        the POR should have. An empty string means no filter.
+     * @param LocationList_T& List of (geographical) locations, sorted by
+     *        increasing distance.
+     * @return NbOfMatches_T Number of matches.
+     */
+    NbOfMatches_T findNearby (const Latitude_T&, const Longitude_T&,
+                              const Distance_T& iRadius,
+                              const NbOfMatches_T& iK,
+                              const std::string& iFeatureFilter,
+                              LocationList_T&);
+
+    /**
+     * Calculate the matrix of the great circle distances, in kilometers,
+     * between two lists of (geographical) locations.
+     *
+     * The distances are calculated in batch, thanks to a vectorised kernel,
+     * the rows being spread across several threads for large matrices.
+     *
+     * @param const LocationList_T& First list of locations (rows).
+     * @param const LocationList_T& Second list of locations (columns).
+     * @param DistanceMatrix_T& Distance matrix, of the size of the first
+     *        list times the size of the second list.
+     */
+    void calculateDistanceMatrix (const LocationList_T&, const LocationList_T&,
+                                  DistanceMatrix_T&);
+
+    /**
+     * Calculate the matrix of the great circle distances, in kilometers,
+     * between two lists of POR (points of reference) codes (e.g., "NCE",
+     * "SFO").
+     *
+     * Each IATA/ICAO/UNLOCODE code or Geonames ID is resolved exactly,
+     * from the SQL database or, when there is none, from the Xapian
+     * database/index. When several POR correspond to a code (e.g., SFO
+     * gives both the airport and the city), the one having the greatest
+     * PageRank is taken. The distances involving a code, which can not be
+     * resolved, are set to NaN (not a number).
+     *
+     * @param const WordList_T& First list of codes (rows).
+     * @param const WordList_T& Second list of codes (columns).
+     * @param DistanceMatrix_T& Distance matrix, of the size of the first
+     *        list times the size of the second list.
+     * @return NbOfMatches_T Number of distinct codes, which have been
+     *         resolved.
+     */
+    NbOfMatches_T calculateDistanceMatrix (const WordList_T&, const WordList_T&,
+                                           DistanceMatrix_T&);
 
     /**
      * Get the file-paths of the Xapian database/index and of the OPTD-maintained
@@ -82,6 +177,16 @@ namespace OPENTREP {
      */
     const DeploymentNumber_T& getDeploymentNumber() const;
 
+    /**
+     * Get the number of the deployment actually used by the searches.
+     * It differs from the deployment number given at initialisation
+     * time once the searches have been hot-swapped to the other
+     * deployment (see startIndexHotSwap()).
+     *
+     * @return DeploymentNumber_T The deployment number used by the searches.
+     */
+    DeploymentNumber_T getActiveDeploymentNumber() const;
+
     /**
      * Check that the directory hosting the Xapian database/index exists
      * and is accessible.
@@ -137,6 +242,71 @@ namespace OPENTREP {
      * @return OPENTREP::DeploymentNumber_T New value of the deployment number
      */
     OPENTREP::DeploymentNumber_T toggleDeploymentNumber();
+
+    /**
+     * Keep the Xapian index and SQL database of the current deployment
+     * open for the searches, and hot-swap them, without any downtime,
+     * as soon as the indexer has marked a new version of the other
+     * deployment as ready.
+     *
+     * The searches in progress go on with the former deployment, which is
+     * closed once the last of them is over. See IndexHotSwapper for
+     * the details.
+     *
+     * @param const PollingPeriod_T& Period, in milliseconds, with which
+     *        a background thread checks the other deployment. When it is
+     *        0, no background thread is started, and the checks are made
+     *        only by checkIndexHotSwap().
+     */
+    void startIndexHotSwap (const PollingPeriod_T&);
+
+    /**
+     * Check, synchronously, whether a new version of the other deployment
+     * is ready and, if so, hot-swap to it. The hot-swap is started, if
+     * not already done.
+     *
+     * @return bool Whether the deployment has been swapped.
+     */
+    bool checkIndexHotSwap();
+
+    /**
+     * Stop the hot-swap: the searches again open the Xapian index of
+     * the deployment given at initialisation time (or by
+     * toggleDeploymentNumber()) for every query, and borrow the SQL
+     * database sessions, along with their prepared statements, from
+     * the pool of that deployment.
+     */
+    void stopIndexHotSwap();
+
+    /**
+     * Select the parser of the POR records: the Boost Spirit grammar
+     * (the default one), the SIMD field splitter, or both, cross-checked
+     * (e.g., to validate the SIMD parser on a whole POR file). The parser
+     * is used by the next indexing, update and export operations of the
+     * service, as well as for decoding the raw data strings of the search
+     * results of the process.
+     *
+     * @param const PORParserType& Type of the POR parser.
+     */
+    void setPORParserType (const PORParserType&);
+
+    /**
+     * Select the way of opening the SQLite database: directly from the
+     * disk (the default), copied in memory, or opened as read-only and
+     * mapped in memory. Without hot-swap, the pool of SQL database sessions
+     * of the current deployment is re-opened with the new mode by the next
+     * search. With hot-swap (see startIndexHotSwap()), the SQLite database
+     * is loaded again every time a deployment is opened, so that must be
+     * done before starting the hot-swap. That has no effect on
+     * a MySQL/MariaDB database.
+     *
+     * The IN_MEMORY mode needs SOCI 4.0 and SQLite 3.36 (or later), and
+     * the MMAP mode SOCI 4.0; otherwise, an exception is thrown when
+     * the SQLite database is opened.
+     *
+     * @param const SQLDBLoadMode& Way of opening the SQLite database.
+     */
+    void setSQLDBLoadMode (const SQLDBLoadMode&);
     
     /**
      * Toggle the flag stating whether to index non-IATA-referenced POR
@@ -176,6 +346,70 @@ namespace OPENTREP {
      */
     NbOfDBEntries_T insertIntoDBAndXapian();    
 
+    /**
+     * Same as above, specifying the number of threads parsing the POR and
+     * building their sets of terms. The Xapian documents are added by
+     * a single thread, in the order of the file, so that their IDs do not
+     * depend on the number of threads.
+     *
+     * @param const NbOfThreads_T& Number of threads (0 means the number
+     *        of hardware threads).
+     * @return NbOfDBEntries_T Number of documents of the file (stream).
+     */
+    NbOfDBEntries_T insertIntoDBAndXapian (const NbOfThreads_T&);
+
+    /**
+     * Same as above, splitting the Xapian index into the given number of
+     * shards, built at once from contiguous chunks of the POR file.
+     * The shards are then either merged (compacted) into a single Xapian
+     * database, with the same document IDs as when not sharded, or
+     * referenced by a Xapian stub database, which is faster to build but
+     * slower to search.
+     *
+     * @param const NbOfThreads_T& Number of threads (0 means the number
+     *        of hardware threads), spread across the shards.
+     * @param const NbOfShards_T& Number of shards (1 means no sharding).
+     * @param const shouldMergeIndexShards_T& Whether the shards should be
+     *        merged into a single Xapian database.
+     * @return NbOfDBEntries_T Number of documents of the file (stream).
+     */
+    NbOfDBEntries_T insertIntoDBAndXapian (const NbOfThreads_T&,
+                                           const NbOfShards_T&,
+                                           const shouldMergeIndexShards_T&);
+
+    /**
+     * From a new version of the file of OPTD-maintained POR (points of
+     * reference), update incrementally the SQL database and/or the Xapian
+     * index, if the corresponding flags are set: only the POR records
+     * added, changed or removed since the last indexing are written.
+     *
+     * The Xapian index must have been (fully) built beforehand, by
+     * insertIntoDBAndXapian(), and must not be made of shards referenced
+     * by a stub database.
+     *
+     * @return IndexUpdateReport Numbers of added, changed, removed and
+     *         unchanged POR records.
+     */
+    IndexUpdateReport updateDBAndXapian();
+
+    /**
+     * Export all the POR (points of reference) into a columnar file (see
+     * ColumnarPORWriter), which can be read back column by column (see
+     * ColumnarPORReader). The POR are retrieved from the SQL database or,
+     * when there is no SQL database, from the file of POR.
+     *
+     * The POR are decoded by several threads, and written by row groups,
+     * so that the memory used does not depend on the number of POR.
+     *
+     * @param const FilePath_T& File-path of the columnar file to be
+     *        (re-)created.
+     * @param const NbOfThreads_T& Number of threads (0 means the number
+     *        of hardware threads).
+     * @return NbOfDBEntries_T Number of exported POR.
+     */
+    NbOfDBEntries_T exportToColumnarFile (const FilePath_T&,
+                                          const NbOfThreads_T&);
+
     /**
      * Retrieve the number of POR (points of reference)
      * within the SQL database.
@@ -349,6 +583,11 @@ namespace OPENTREP {
      * Opentrep context. 
      */
     OPENTREP_ServiceContext* _opentrepServiceContext;
+
+    /**
+     * Watcher hot-swapping the deployments (NULL when not started).
+     */
+    IndexHotSwapper* _indexHotSwapper;
   };
 }
 #endif // __OPENTREP_SVC_OPENTREP_SERVICE_HPP
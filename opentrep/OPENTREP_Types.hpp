@@ -10,6 +10,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <vector>
 // Boost Date-Time
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
@@ -145,6 +146,14 @@ namespace OPENTREP {
    */
   typedef bool shouldAddPORInSQLDB_T;
 
+  /**
+   * Whether or not to merge (and compact) the shards of the Xapian index
+   * into a single database. Otherwise, the shards are kept as they are,
+   * and referenced by a stub database, which the search process opens as
+   * a combined database.
+   */
+  typedef bool shouldMergeIndexShards_T;
+
   /**
    * IATA three-letter code (e.g., ORD for Chicago O'Hare, IL, USA).
    *
@@ -563,6 +572,21 @@ namespace OPENTREP {
   typedef GeoCoord_T Latitude_T;
   typedef GeoCoord_T Longitude_T;
 
+  /**
+   * Great circle distance, in kilometers (e.g., 6.3 or 9124.2).
+   */
+  typedef double Distance_T;
+
+  /**
+   * List of distances, in kilometers.
+   */
+  typedef std::vector<Distance_T> DistanceList_T;
+
+  /**
+   * Dense matrix of distances, in kilometers, stored row by row.
+   */
+  typedef std::vector<DistanceList_T> DistanceMatrix_T;
+
   /**
    * Wikipedia link (e.g., http://en.wikipedia.org/wiki/Chicago).
    */
@@ -649,6 +673,12 @@ namespace OPENTREP {
    */
   typedef unsigned int XapianDocID_T;
 
+  /**
+   * Xapian value slot number, for the values (e.g., geographical
+   * coordinates) stored along with the Xapian documents.
+   */
+  typedef unsigned int XapianValueSlot_T;
+
   /**
    * Weight when indexing terms of a Xapian document.
    */
@@ -678,6 +708,24 @@ namespace OPENTREP {
    * Number of entries in the Xapian database.
    */
   typedef unsigned int NbOfDBEntries_T;
+
+  /**
+   * Version of the schema of the SQL database (e.g., 2 when the POR are
+   * stored as Protobuf records, next to their raw data strings).
+   */
+  typedef unsigned short SQLDBSchemaVersion_T;
+
+  /**
+   * Hash of the content of a POR record (e.g., "a3f1c2d4e5b60718"), i.e.,
+   * the hexadecimal representation of a 64-bit hash of its raw data string.
+   */
+  typedef std::string ContentHash_T;
+
+  /**
+   * Hashes of the content of the POR records, indexed by the unique IDs
+   * of those records (see Place::describeUniqueID()).
+   */
+  typedef std::map<std::string, ContentHash_T> ContentHashMap_T;
   
   /**
    * Word, which is the atomic element of a query string.
@@ -718,6 +766,22 @@ namespace OPENTREP {
    * Number of errors.
    */
   typedef unsigned short NbOfErrors_T;
+
+  /**
+   * Number of (worker) threads.
+   */
+  typedef unsigned short NbOfThreads_T;
+
+  /**
+   * Number of shards (independent Xapian databases) of the index.
+   */
+  typedef unsigned short NbOfShards_T;
+
+  /**
+   * Period, in milliseconds, of a polling (e.g., of the other deployment,
+   * for the hot-swap of the Xapian index and SQL database).
+   */
+  typedef unsigned int PollingPeriod_T;
   
   /**
    * Number of (distance) errors allowed for a given number of letters.
@@ -0,0 +1,171 @@
+#ifndef __OPENTREP_ORIGINHINT_HPP
+#define __OPENTREP_ORIGINHINT_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <iosfwd>
+#include <string>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/OPENTREP_Abstract.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * @brief Structure modelling the origin of a travel request, as given
+   *        by the caller of the API (e.g., the GPS position of the user,
+   *        or the country of the point of sale).
+   *
+   * When given, the origin biases the ranking of the matching POR (points
+   * of reference) for ambiguous names (e.g., "san jose", "portland"),
+   * through the heuristic weight: the POR close to the origin, and/or
+   * within the same country, are preferred.
+   *
+   * Both the geographical coordinates and the country code are optional.
+   * A default-constructed origin hint is empty, and has no effect.
+   */
+  struct OriginHint : public OPENTREP_Abstract {
+  public:
+    // //////////////// Getters ///////////////
+    /**
+     * State whether the geographical coordinates are given.
+     */
+    bool hasCoordinates() const {
+      return _hasCoordinates;
+    }
+
+    /**
+     * Get the latitude, in degrees.
+     */
+    const Latitude_T& getLatitude() const {
+      return _latitude;
+    }
+
+    /**
+     * Get the longitude, in degrees.
+     */
+    const Longitude_T& getLongitude() const {
+      return _longitude;
+    }
+
+    /**
+     * State whether the country code is given.
+     */
+    bool hasCountryCode() const {
+      return !_countryCode.empty();
+    }
+
+    /**
+     * Get the (ISO 3166-1 alpha-2, upper case) country code (e.g., US).
+     */
+    const CountryCode_T& getCountryCode() const {
+      return _countryCode;
+    }
+
+    /**
+     * State whether the origin hint is empty, i.e., has neither
+     * geographical coordinates nor country code.
+     */
+    bool isEmpty() const {
+      return (_hasCoordinates == false && _countryCode.empty() == true);
+    }
+
+
+  public:
+    // ////////////// Display methods //////////////
+    /**
+     * Dump the structure into an output stream.
+     *
+     * @param ostream& the output stream.
+     */
+    void toStream (std::ostream&) const;
+
+    /**
+     * Read a structure from an input stream.
+     *
+     * @param istream& the input stream.
+     */
+    void fromStream (std::istream&);
+
+    /**
+     * Get the serialised version of the structure.
+     */
+    std::string toString() const;
+
+    /**
+     * Get a string describing the whole structure.
+     */
+    std::string describe() const;
+
+
+  public:
+    // ////////////// Constructors and destructors //////////////
+    /**
+     * Default constructor, for an empty origin hint.
+     */
+    OriginHint();
+
+    /**
+     * Constructor from geographical coordinates.
+     *
+     * @param const Latitude_T& Latitude of the origin, in degrees.
+     * @param const Longitude_T& Longitude of the origin, in degrees.
+     */
+    OriginHint (const Latitude_T&, const Longitude_T&);
+
+    /**
+     * Constructor from a country code.
+     *
+     * @param const CountryCode_T& ISO 3166-1 alpha-2 country code (e.g., US).
+     *        The case does not matter.
+     */
+    OriginHint (const CountryCode_T&);
+
+    /**
+     * Constructor from both geographical coordinates and a country code.
+     *
+     * @param const Latitude_T& Latitude of the origin, in degrees.
+     * @param const Longitude_T& Longitude of the origin, in degrees.
+     * @param const CountryCode_T& ISO 3166-1 alpha-2 country code (e.g., US).
+     *        The case does not matter.
+     */
+    OriginHint (const Latitude_T&, const Longitude_T&, const CountryCode_T&);
+
+    /**
+     * Default copy constructor.
+     */
+    OriginHint (const OriginHint&);
+
+    /**
+     * Destructor.
+     */
+    ~OriginHint();
+
+
+  private:
+    // //////////////////// Attributes ///////////////////////
+    /**
+     * Whether the geographical coordinates are given.
+     */
+    bool _hasCoordinates;
+
+    /**
+     * Latitude of the origin, in degrees.
+     */
+    Latitude_T _latitude;
+
+    /**
+     * Longitude of the origin, in degrees.
+     */
+    Longitude_T _longitude;
+
+    /**
+     * Upper case country code of the origin (empty when not given).
+     */
+    CountryCode_T _countryCode;
+  };
+
+}
+#endif // __OPENTREP_ORIGINHINT_HPP
@@ -13,6 +13,10 @@ namespace OPENTREP {
 
   /**
    * @brief Enumeration of output formats.
+   *
+   * The CSV (comma-separated values) and TSV (tabulation-separated values)
+   * formats give one line per POR, made of a selection of columns
+   * (see DSVColumn), so that they can be loaded in bulk.
    */
   struct OutputFormat {
   public:
@@ -21,27 +25,32 @@ namespace OPENTREP {
       FULL,
       JSON,
       PROTOBUF,
+      CSV,
+      TSV,
       LAST_VALUE
     } EN_OutputFormat;
 
     /**
-     * Get the label as a string (e.g., "Short", "Full", "JSON" or "PROTOBUF").
+     * Get the label as a string (e.g., "Short", "Full", "JSON", "PROTOBUF",
+     * "CSV" or "TSV").
      */
     static const std::string& getLabel (const EN_OutputFormat&);
 
     /**
-     * Get the format value from parsing a single char (e.g., 'S', 'F', 'J'
-     * or 'P').
+     * Get the format value from parsing a single char (e.g., 'S', 'F', 'J',
+     * 'P', 'C' or 'T').
      */
     static EN_OutputFormat getFormat (const char);
 
     /**
-     * Get the label as a single char (e.g., 'S', 'F', 'J' or 'P').
+     * Get the label as a single char (e.g., 'S', 'F', 'J', 'P', 'C'
+     * or 'T').
      */
     static char getFormatLabel (const EN_OutputFormat&);
 
     /**
-     * Get the label as a string of a single char (e.g., "S", "F", "J" or "P").
+     * Get the label as a string of a single char (e.g., "S", "F", "J",
+     * "P", "C" or "T").
      */
     static std::string getFormatLabelAsString (const EN_OutputFormat&);
 
@@ -56,18 +65,20 @@ namespace OPENTREP {
     EN_OutputFormat getFormat() const;
 
     /**
-     * Get the enumerated value as a short string (e.g., 'S', 'F', 'J' or 'P').
+     * Get the enumerated value as a short string (e.g., 'S', 'F', 'J', 'P', 'C'
+     * or 'T').
      */
     char getFormatAsChar() const;
     
     /**
-     * Get the enumerated value as a short string (e.g., "S", "F", "J" or "P").
+     * Get the enumerated value as a short string (e.g., "S", "F", "J",
+     * "P", "C" or "T").
      */
     std::string getFormatAsString() const;
     
     /**
-     * Give a description of the structure (e.g., "Short", "Full", "JSON"
-     * or "PROTOBUF").
+     * Give a description of the structure (e.g., "Short", "Full", "JSON",
+     * "PROTOBUF", "CSV" or "TSV").
      */
     const std::string describe() const;
 
@@ -0,0 +1,133 @@
+#ifndef __OPENTREP_PORPARSERTYPE_HPP
+#define __OPENTREP_PORPARSERTYPE_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * @brief Enumeration of the parsers of the POR (points of reference)
+   *        records.
+   *
+   * <ul>
+   *   <li>SPIRIT: the Boost Spirit grammar (see PORStringParser).</li>
+   *   <li>SIMD: the field splitter locating the separators with SSE2/AVX2
+   *       instructions (see PORFastStringParser).</li>
+   *   <li>CROSS_CHECK: both parsers, the Location structures they give
+   *       being compared. That is slow, and meant to validate the SIMD
+   *       parser on a whole POR file.</li>
+   * </ul>
+   */
+  struct PORParserType {
+  public:
+    typedef enum {
+      SPIRIT = 0,
+      SIMD,
+      CROSS_CHECK,
+      LAST_VALUE
+    } EN_PORParserType;
+
+    /**
+     * Get the label as a string (e.g., "Spirit", "SIMD", "CrossCheck").
+     */
+    static const std::string& getLabel (const EN_PORParserType&);
+
+    /**
+     * Get the type value from parsing a single char (e.g., 'G', 'S', 'C')
+     */
+    static EN_PORParserType getType (const char);
+
+    /**
+     * Get the label as a single char (e.g., 'G', 'S', 'C')
+     */
+    static char getTypeLabel (const EN_PORParserType&);
+
+    /**
+     * Get the label as a string of a single char (e.g., 'G', 'S', 'C')
+     */
+    static std::string getTypeLabelAsString (const EN_PORParserType&);
+
+    /**
+     * List the labels.
+     */
+    static std::string describeLabels();
+
+    /**
+     * Get the enumerated value.
+     */
+    EN_PORParserType getType() const;
+
+    /**
+     * Get the enumerated value as a short string (e.g., "G", "S", "C")
+     */
+    char getTypeAsChar() const;
+
+    /**
+     * Get the enumerated value as a short string (e.g., "G", "S", "C")
+     */
+    std::string getTypeAsString() const;
+
+    /**
+     * Give a description of the structure (e.g., "Spirit", "SIMD",
+     * "CrossCheck").
+     */
+    const std::string describe() const;
+
+  public:
+    /**
+     * Comparison operators.
+     */
+    bool operator== (const EN_PORParserType&) const;
+    bool operator== (const PORParserType&) const;
+
+  public:
+    /**
+     * Main constructor.
+     */
+    PORParserType (const EN_PORParserType&);
+    /**
+     * Alternative constructor.
+     */
+    PORParserType (const char iType);
+    /**
+     * Alternative constructor.
+     */
+    PORParserType (const std::string& iType);
+    /**
+     * Default copy constructor.
+     */
+    PORParserType (const PORParserType&);
+
+  private:
+    /**
+     * Default constructor.
+     */
+    PORParserType();
+
+
+  private:
+    /**
+     * String version of the enumeration.
+     */
+    static const std::string _labels[LAST_VALUE];
+    /**
+     * Type version of the enumeration.
+     */
+    static const char _typeLabels[LAST_VALUE];
+
+  private:
+    // //////// Attributes /////////
+    /**
+     * Parser type.
+     */
+    EN_PORParserType _type;
+  };
+
+}
+#endif // __OPENTREP_PORPARSERTYPE_HPP
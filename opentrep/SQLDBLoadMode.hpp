@@ -0,0 +1,140 @@
+#ifndef __OPENTREP_SQLDBLOADMODE_HPP
+#define __OPENTREP_SQLDBLOADMODE_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * @brief Enumeration of the ways of opening the SQLite database
+   *        of the deployment used by the searches.
+   *
+   * <ul>
+   *   <li>ON_DISK: every connection reads the database file through
+   *       the file-system, as for any other SQLite database.</li>
+   *   <li>IN_MEMORY: the database file is copied in memory (with the SQLite
+   *       backup API) when the deployment is opened, and all the
+   *       connections of that deployment share that copy. That needs
+   *       SOCI 4.0 and SQLite 3.36 (and its "memdb" VFS) or later.</li>
+   *   <li>MMAP: the database file is opened as read-only, and mapped
+   *       in memory. That needs SOCI 4.0 or later.</li>
+   * </ul>
+   *
+   * The database file should not be altered while it is used with
+   * the IN_MEMORY and MMAP modes: the indexer works on the other
+   * deployment, and the services reload the database when they hot-swap
+   * to that other deployment, or when they toggle to it without hot-swap.
+   * The modes have no effect on a MySQL/MariaDB database.
+   */
+  struct SQLDBLoadMode {
+  public:
+    typedef enum {
+      ON_DISK = 0,
+      IN_MEMORY,
+      MMAP,
+      LAST_VALUE
+    } EN_SQLDBLoadMode;
+
+    /**
+     * Get the label as a string (e.g., "Disk", "Memory", "MMap").
+     */
+    static const std::string& getLabel (const EN_SQLDBLoadMode&);
+
+    /**
+     * Get the mode value from parsing a single char (e.g., 'D', 'M', 'P')
+     */
+    static EN_SQLDBLoadMode getMode (const char);
+
+    /**
+     * Get the label as a single char (e.g., 'D', 'M', 'P')
+     */
+    static char getModeLabel (const EN_SQLDBLoadMode&);
+
+    /**
+     * Get the label as a string of a single char (e.g., 'D', 'M', 'P')
+     */
+    static std::string getModeLabelAsString (const EN_SQLDBLoadMode&);
+
+    /**
+     * List the labels.
+     */
+    static std::string describeLabels();
+
+    /**
+     * Get the enumerated value.
+     */
+    EN_SQLDBLoadMode getMode() const;
+
+    /**
+     * Get the enumerated value as a short string (e.g., "D", "M", "P")
+     */
+    char getModeAsChar() const;
+
+    /**
+     * Get the enumerated value as a short string (e.g., "D", "M", "P")
+     */
+    std::string getModeAsString() const;
+
+    /**
+     * Give a description of the structure (e.g., "Disk", "Memory", "MMap").
+     */
+    const std::string describe() const;
+
+  public:
+    /**
+     * Comparison operators.
+     */
+    bool operator== (const EN_SQLDBLoadMode&) const;
+    bool operator== (const SQLDBLoadMode&) const;
+
+  public:
+    /**
+     * Main constructor.
+     */
+    SQLDBLoadMode (const EN_SQLDBLoadMode&);
+    /**
+     * Alternative constructor.
+     */
+    SQLDBLoadMode (const char iMode);
+    /**
+     * Alternative constructor.
+     */
+    SQLDBLoadMode (const std::string& iMode);
+    /**
+     * Default copy constructor.
+     */
+    SQLDBLoadMode (const SQLDBLoadMode&);
+
+  private:
+    /**
+     * Default constructor.
+     */
+    SQLDBLoadMode();
+
+
+  private:
+    /**
+     * String version of the enumeration.
+     */
+    static const std::string _labels[LAST_VALUE];
+    /**
+     * Mode version of the enumeration.
+     */
+    static const char _modeLabels[LAST_VALUE];
+
+  private:
+    // //////// Attributes /////////
+    /**
+     * Load mode.
+     */
+    EN_SQLDBLoadMode _mode;
+  };
+
+}
+#endif // __OPENTREP_SQLDBLOADMODE_HPP
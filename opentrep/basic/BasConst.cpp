@@ -68,6 +68,59 @@ namespace OPENTREP {
    */
   const unsigned short DEFAULT_OPENTREP_DEPLOYMENT_NUMBER_SIZE (2);
 
+  /**
+   * Name of the file, written within the directory of the Xapian
+   * index/database once the indexer has successfully built or updated it
+   * (e.g., "opentrep.ready"). The file holds the (UTC) date-time of the
+   * end of the indexing, with a micro-second resolution, so that the
+   * services can detect that a new version of the other deployment is
+   * ready, and hot-swap to it.
+   */
+  const std::string DEFAULT_OPENTREP_READY_MARKER_FILENAME ("opentrep.ready");
+
+  /**
+   * Default period, in milliseconds, with which the services check whether
+   * a new version of the other deployment is ready (e.g., 5,000 ms).
+   */
+  const unsigned int DEFAULT_OPENTREP_HOT_SWAP_POLLING_PERIOD (5000);
+
+  /**
+   * Number of the most frequent terms (e.g., 100), the posting lists
+   * of which are walked through when warming up a newly opened Xapian
+   * index, before hot-swapping to it.
+   */
+  const unsigned short DEFAULT_OPENTREP_WARM_UP_NB_OF_TERMS (100);
+
+  /**
+   * Default way of opening the SQLite database of the deployment used
+   * by the searches (see SQLDBLoadMode): directly from the disk, as
+   * historically.
+   */
+  const char DEFAULT_OPENTREP_SQL_DB_LOAD_MODE ('D');
+
+  /**
+   * Default parser of the POR records (see PORParserType): the Boost
+   * Spirit grammar. The SIMD field splitter is to become the default one
+   * only once it has been cross-checked against the former on the whole
+   * OPTD POR file (see the --parser check option of opentrep-indexer).
+   */
+  const char DEFAULT_OPENTREP_POR_PARSER_TYPE ('G');
+
+  /**
+   * Maximum size, in bytes, of the SQLite database file mapped in memory,
+   * when it is opened with the SQLDBLoadMode::MMAP mode (e.g., 1 GB,
+   * i.e., far above the size of the OPTD POR database).
+   */
+  const long long DEFAULT_OPENTREP_SQLITE_MMAP_SIZE (1073741824LL);
+
+  /**
+   * Maximum number of attempts, when copying the SQLite database file in
+   * memory, while that file is busy or locked, and delay, in milliseconds,
+   * between two attempts (i.e., at most 5 seconds of waiting).
+   */
+  const unsigned short DEFAULT_OPENTREP_SQLITE_BACKUP_MAX_ATTEMPTS (50);
+  const int DEFAULT_OPENTREP_SQLITE_BACKUP_RETRY_DELAY (100);
+
   /**
    * Whether or not the non-IATA-referenced POR should be included
    * (and indexed).
@@ -129,6 +182,12 @@ namespace OPENTREP {
   const char* K_ICU_GENERIC_TRANSLITERATOR_RULE =
     "Any-Latin; NFD; [:M:] Remove; NFC; Lower;";
 
+  /**
+   * Maximal number of (non-ASCII) strings memoised by the Unicode
+   * transliterator, for every transformation (e.g., 65,536).
+   */
+  const NbOfDBEntries_T K_DEFAULT_TRANSFORMATION_CACHE_SIZE (65536);
+
 
   // /////////////// General ////////////////
   /**
@@ -189,6 +248,163 @@ namespace OPENTREP {
    */
   const NbOfWords_T K_DEFAULT_MAXIMUM_NUMBER_OF_WORDS_IN_STRING (14);
 
+  /**
+   * Mean radius of the Earth, in kilometers (e.g., 6371.0).
+   */
+  const Distance_T K_DEFAULT_EARTH_RADIUS (6371.0);
+
+  /**
+   * Minimal number of distances a thread should calculate, when a distance
+   * matrix is spread across several threads (e.g., 65,536).
+   */
+  const NbOfDBEntries_T K_DEFAULT_MIN_NB_OF_DISTANCES_PER_THREAD (65536);
+
+  /**
+   * Default number of threads parsing the POR and building their sets of
+   * terms, when indexing (0 means the number of hardware threads).
+   */
+  const NbOfThreads_T K_DEFAULT_NB_OF_INDEXING_THREADS (0);
+
+  /**
+   * Maximal number of POR being processed at once by the indexing pipeline,
+   * i.e., read but not written yet into the Xapian index (e.g., 1,024).
+   */
+  const NbOfDBEntries_T K_DEFAULT_INDEXING_QUEUE_SIZE (1024);
+
+  /**
+   * Default number of threads of the asynchronous search of the Python
+   * extension (0 means the number of hardware threads).
+   */
+  const NbOfThreads_T K_DEFAULT_NB_OF_ASYNC_SEARCH_THREADS (0);
+
+  /**
+   * Maximal number of travel queries waiting for a thread of the
+   * asynchronous search of the Python extension (e.g., 4,096).
+   */
+  const NbOfDBEntries_T K_DEFAULT_ASYNC_SEARCH_QUEUE_SIZE (4096);
+
+  /**
+   * Number of rows inserted at once, within a single transaction, when
+   * loading the POR into the SQL database (e.g., 1,000).
+   */
+  const NbOfDBEntries_T K_DEFAULT_SQL_BULK_LOAD_BATCH_SIZE (1000);
+
+  /**
+   * Number of rows inserted by a single execution of the insert statement,
+   * when loading the POR into the SQL database (e.g., 50, i.e., 650
+   * parameters, below the 999 allowed by the older versions of SQLite).
+   * It should divide the size of the batches.
+   */
+  const NbOfDBEntries_T K_DEFAULT_SQL_BULK_INSERT_NB_OF_ROWS (50);
+
+  /**
+   * Maximal number of codes looked up at once, within a single SQL
+   * query (e.g., 500, well below the 999 parameters allowed by the
+   * older versions of SQLite).
+   */
+  const NbOfDBEntries_T K_DEFAULT_SQL_CODE_LIST_SIZE (500);
+
+  /**
+   * Version of the schema of the SQL database created by OpenTREP:
+   * + 1: the POR are stored as raw data strings (serialised_place);
+   * + 2: the POR are stored as compact Protobuf records, as BLOB
+   *      (serialised_place_pb), decoded without any parsing.
+   */
+  const SQLDBSchemaVersion_T K_SQL_DB_SCHEMA_VERSION (2);
+
+  /**
+   * Default number of shards of the Xapian index (1 means no sharding).
+   */
+  const NbOfShards_T K_DEFAULT_NB_OF_INDEX_SHARDS (1);
+
+  /**
+   * Prefix of the directory names of the Xapian index shards
+   * (e.g., shard0, shard1).
+   */
+  const std::string K_XAPIAN_SHARD_DIRNAME_PREFIX ("shard");
+
+  /**
+   * Suffix of the temporary directory hosting the Xapian index shards,
+   * before they are merged (e.g., /tmp/opentrep/xapian_traveldb0_shards).
+   */
+  const std::string K_XAPIAN_SHARDS_DIR_SUFFIX ("_shards");
+
+  /**
+   * Name of the Xapian stub database file, referencing the shards
+   * (see https://xapian.org/docs/admin_notes.html#stub-database-format).
+   */
+  const std::string K_XAPIAN_STUB_DB_FILENAME ("XAPIANDB");
+
+  /**
+   * Magic string opening and closing the columnar export files of the POR
+   * (see ColumnarPORWriter), i.e., "OTREPCOL".
+   */
+  const std::string K_COLUMNAR_FILE_MAGIC ("OTREPCOL");
+
+  /**
+   * Version of the layout of the columnar export files of the POR
+   * (e.g., 1).
+   */
+  const unsigned int K_COLUMNAR_FILE_VERSION (1);
+
+  /**
+   * Default number of POR of a row group of the columnar export files
+   * (e.g., 8,192).
+   */
+  const NbOfDBEntries_T K_DEFAULT_COLUMNAR_ROW_GROUP_SIZE (8192);
+
+  /**
+   * Maximal number of row groups being processed at once by the columnar
+   * export pipeline, i.e., read but not written yet (e.g., 8).
+   */
+  const NbOfDBEntries_T K_DEFAULT_COLUMNAR_QUEUE_SIZE (8);
+
+  /**
+   * Xapian value slot storing the latitude of the POR (e.g., 0).
+   */
+  const XapianValueSlot_T K_XAPIAN_VALUE_SLOT_LATITUDE (0);
+
+  /**
+   * Xapian value slot storing the longitude of the POR (e.g., 1).
+   */
+  const XapianValueSlot_T K_XAPIAN_VALUE_SLOT_LONGITUDE (1);
+
+  /**
+   * Xapian value slot storing the ISO country code of the POR (e.g., 2).
+   */
+  const XapianValueSlot_T K_XAPIAN_VALUE_SLOT_COUNTRY_CODE (2);
+
+  /**
+   * Xapian value slot storing the hash of the content of the POR
+   * record (e.g., 3).
+   */
+  const XapianValueSlot_T K_XAPIAN_VALUE_SLOT_CONTENT_HASH (3);
+
+  /**
+   * Prefix of the Xapian (boolean) term holding the unique ID of the POR
+   * record (e.g., "Q", as advised by the Xapian term prefix conventions).
+   */
+  const std::string K_XAPIAN_UNIQUE_ID_TERM_PREFIX ("Q");
+
+  /**
+   * Minimal heuristic percentage (e.g., 10.0%), given by the origin hint
+   * to the POR far away from that origin.
+   */
+  const Percentage_T K_DEFAULT_HEURISTIC_MIN_PCT (10.0);
+
+  /**
+   * Distance, in kilometers, over which the heuristic percentage given
+   * by the origin hint decays (e.g., 1,000 km). Beyond a few times that
+   * distance, the heuristic percentage is almost the minimal one.
+   */
+  const Distance_T K_DEFAULT_HEURISTIC_DISTANCE_DECAY (1000.0);
+
+  /**
+   * Heuristic percentage (e.g., 50.0%) given to the POR, which are not
+   * in the country of the origin hint.
+   */
+  const Percentage_T K_DEFAULT_HEURISTIC_OTHER_COUNTRY_PCT (50.0);
+
   /**
    * Black list, i.e., a list of words which should not be indexed
    * and/or searched for (e.g., "airport", "international").
@@ -6,6 +6,7 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <ctime>
+#include <string>
 // OpenTrep
 #include <opentrep/OPENTREP_Types.hpp>
 
@@ -70,6 +71,163 @@ namespace OPENTREP {
    */
   extern const NbOfWords_T K_DEFAULT_MAXIMUM_NUMBER_OF_WORDS_IN_STRING;
 
+  /**
+   * Mean radius of the Earth, in kilometers (e.g., 6371.0).
+   */
+  extern const Distance_T K_DEFAULT_EARTH_RADIUS;
+
+  /**
+   * Minimal number of distances a thread should calculate, when a distance
+   * matrix is spread across several threads (e.g., 65,536).
+   */
+  extern const NbOfDBEntries_T K_DEFAULT_MIN_NB_OF_DISTANCES_PER_THREAD;
+
+  /**
+   * Default number of threads parsing the POR and building their sets of
+   * terms, when indexing (0 means the number of hardware threads).
+   */
+  extern const NbOfThreads_T K_DEFAULT_NB_OF_INDEXING_THREADS;
+
+  /**
+   * Maximal number of POR being processed at once by the indexing pipeline,
+   * i.e., read but not written yet into the Xapian index (e.g., 1,024).
+   */
+  extern const NbOfDBEntries_T K_DEFAULT_INDEXING_QUEUE_SIZE;
+
+  /**
+   * Default number of threads of the asynchronous search of the Python
+   * extension (0 means the number of hardware threads).
+   */
+  extern const NbOfThreads_T K_DEFAULT_NB_OF_ASYNC_SEARCH_THREADS;
+
+  /**
+   * Maximal number of travel queries waiting for a thread of the
+   * asynchronous search of the Python extension (e.g., 4,096).
+   */
+  extern const NbOfDBEntries_T K_DEFAULT_ASYNC_SEARCH_QUEUE_SIZE;
+
+  /**
+   * Number of rows inserted at once, within a single transaction, when
+   * loading the POR into the SQL database (e.g., 1,000).
+   */
+  extern const NbOfDBEntries_T K_DEFAULT_SQL_BULK_LOAD_BATCH_SIZE;
+
+  /**
+   * Number of rows inserted by a single execution of the insert statement,
+   * when loading the POR into the SQL database (e.g., 50, i.e., 650
+   * parameters, below the 999 allowed by the older versions of SQLite).
+   * It should divide the size of the batches.
+   */
+  extern const NbOfDBEntries_T K_DEFAULT_SQL_BULK_INSERT_NB_OF_ROWS;
+
+  /**
+   * Maximal number of codes looked up at once, within a single SQL
+   * query (e.g., 500, well below the 999 parameters allowed by the
+   * older versions of SQLite).
+   */
+  extern const NbOfDBEntries_T K_DEFAULT_SQL_CODE_LIST_SIZE;
+
+  /**
+   * Version of the schema of the SQL database created by OpenTREP:
+   * + 1: the POR are stored as raw data strings (serialised_place);
+   * + 2: the POR are stored as compact Protobuf records, as BLOB
+   *      (serialised_place_pb), decoded without any parsing.
+   */
+  extern const SQLDBSchemaVersion_T K_SQL_DB_SCHEMA_VERSION;
+
+  /**
+   * Default number of shards of the Xapian index (1 means no sharding).
+   */
+  extern const NbOfShards_T K_DEFAULT_NB_OF_INDEX_SHARDS;
+
+  /**
+   * Prefix of the directory names of the Xapian index shards
+   * (e.g., shard0, shard1).
+   */
+  extern const std::string K_XAPIAN_SHARD_DIRNAME_PREFIX;
+
+  /**
+   * Suffix of the temporary directory hosting the Xapian index shards,
+   * before they are merged (e.g., /tmp/opentrep/xapian_traveldb0_shards).
+   */
+  extern const std::string K_XAPIAN_SHARDS_DIR_SUFFIX;
+
+  /**
+   * Name of the Xapian stub database file, referencing the shards
+   * (see https://xapian.org/docs/admin_notes.html#stub-database-format).
+   */
+  extern const std::string K_XAPIAN_STUB_DB_FILENAME;
+
+  /**
+   * Magic string opening and closing the columnar export files of the POR
+   * (see ColumnarPORWriter), i.e., "OTREPCOL".
+   */
+  extern const std::string K_COLUMNAR_FILE_MAGIC;
+
+  /**
+   * Version of the layout of the columnar export files of the POR
+   * (e.g., 1).
+   */
+  extern const unsigned int K_COLUMNAR_FILE_VERSION;
+
+  /**
+   * Default number of POR of a row group of the columnar export files
+   * (e.g., 8,192).
+   */
+  extern const NbOfDBEntries_T K_DEFAULT_COLUMNAR_ROW_GROUP_SIZE;
+
+  /**
+   * Maximal number of row groups being processed at once by the columnar
+   * export pipeline, i.e., read but not written yet (e.g., 8).
+   */
+  extern const NbOfDBEntries_T K_DEFAULT_COLUMNAR_QUEUE_SIZE;
+
+  /**
+   * Xapian value slot storing the latitude of the POR (e.g., 0).
+   */
+  extern const XapianValueSlot_T K_XAPIAN_VALUE_SLOT_LATITUDE;
+
+  /**
+   * Xapian value slot storing the longitude of the POR (e.g., 1).
+   */
+  extern const XapianValueSlot_T K_XAPIAN_VALUE_SLOT_LONGITUDE;
+
+  /**
+   * Xapian value slot storing the ISO country code of the POR (e.g., 2).
+   */
+  extern const XapianValueSlot_T K_XAPIAN_VALUE_SLOT_COUNTRY_CODE;
+
+  /**
+   * Xapian value slot storing the hash of the content of the POR
+   * record (e.g., 3).
+   */
+  extern const XapianValueSlot_T K_XAPIAN_VALUE_SLOT_CONTENT_HASH;
+
+  /**
+   * Prefix of the Xapian (boolean) term holding the unique ID of the POR
+   * record (e.g., "Q", as advised by the Xapian term prefix conventions).
+   */
+  extern const std::string K_XAPIAN_UNIQUE_ID_TERM_PREFIX;
+
+  /**
+   * Minimal heuristic percentage (e.g., 10.0%), given by the origin hint
+   * to the POR far away from that origin.
+   */
+  extern const Percentage_T K_DEFAULT_HEURISTIC_MIN_PCT;
+
+  /**
+   * Distance, in kilometers, over which the heuristic percentage given
+   * by the origin hint decays (e.g., 1,000 km). Beyond a few times that
+   * distance, the heuristic percentage is almost the minimal one.
+   */
+  extern const Distance_T K_DEFAULT_HEURISTIC_DISTANCE_DECAY;
+
+  /**
+   * Heuristic percentage (e.g., 50.0%) given to the POR, which are not
+   * in the country of the origin hint.
+   */
+  extern const Percentage_T K_DEFAULT_HEURISTIC_OTHER_COUNTRY_PCT;
+
   /**
    * Default "black list".
    */
@@ -100,6 +100,60 @@ namespace OPENTREP {
    */
   extern const unsigned short DEFAULT_OPENTREP_DEPLOYMENT_NUMBER_SIZE;
 
+  /**
+   * Name of the file, written within the directory of the Xapian
+   * index/database once the indexer has successfully built or updated it
+   * (e.g., "opentrep.ready"). The file holds the (UTC) date-time of the
+   * end of the indexing, with a micro-second resolution, so that the
+   * services can detect that a new version of the other deployment is
+   * ready, and hot-swap to it.
+   */
+  extern const std::string DEFAULT_OPENTREP_READY_MARKER_FILENAME;
+
+  /**
+   * Default period, in milliseconds, with which the services check whether
+   * a new version of the other deployment is ready (e.g., 5,000 ms).
+   */
+  extern const unsigned int DEFAULT_OPENTREP_HOT_SWAP_POLLING_PERIOD;
+
+  /**
+   * Number of the most frequent terms (e.g., 100), the posting lists
+   * of which are walked through when warming up a newly opened Xapian
+   * index, before hot-swapping to it.
+   */
+  extern const unsigned short DEFAULT_OPENTREP_WARM_UP_NB_OF_TERMS;
+
+  /**
+   * Default way of opening the SQLite database of the deployment used
+   * by the searches (see SQLDBLoadMode): directly from the disk, as
+   * historically.
+   */
+  extern const char DEFAULT_OPENTREP_SQL_DB_LOAD_MODE;
+
+  /**
+   * Default parser of the POR records (see PORParserType): the Boost
+   * Spirit grammar. The SIMD field splitter is to become the default one
+   * only once it has been cross-checked against the former on the whole
+   * OPTD POR file (see the --parser check option of opentrep-indexer).
+   */
+  extern const char DEFAULT_OPENTREP_POR_PARSER_TYPE;
+
+  /**
+   * Maximum size, in bytes, of the SQLite database file mapped in memory,
+   * when it is opened with the SQLDBLoadMode::MMAP mode (e.g., 1 GB,
+   * i.e., far above the size of the OPTD POR database).
+   */
+  extern const long long DEFAULT_OPENTREP_SQLITE_MMAP_SIZE;
+
+  /**
+   * Maximum number of attempts, when copying the SQLite database file in
+   * memory (with the SQLDBLoadMode::IN_MEMORY mode), while that file is
+   * busy or locked (e.g., by a writer), and delay, in milliseconds,
+   * between two attempts.
+   */
+  extern const unsigned short DEFAULT_OPENTREP_SQLITE_BACKUP_MAX_ATTEMPTS;
+  extern const int DEFAULT_OPENTREP_SQLITE_BACKUP_RETRY_DELAY;
+
   /**
    * Whether or not the non-IATA-referenced POR should be included
    * (and indexed).
@@ -4,6 +4,8 @@
 // //////////////////////////////////////////////////////////////////////
 // Import section
 // //////////////////////////////////////////////////////////////////////
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
 
 namespace OPENTREP {
 
@@ -31,5 +33,11 @@ namespace OPENTREP {
    */
   extern const char* K_ICU_GENERIC_TRANSLITERATOR_RULE;
 
+  /**
+   * Maximal number of (non-ASCII) strings memoised by the Unicode
+   * transliterator, for every transformation (e.g., 65,536).
+   */
+  extern const NbOfDBEntries_T K_DEFAULT_TRANSFORMATION_CACHE_SIZE;
+
 }
 #endif // __OPENTREP_BAS_BASCONST_UNICODE_HPP
@@ -0,0 +1,103 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+// OpenTREP
+#include <opentrep/DSVColumn.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string DSVColumn::_labels[LAST_VALUE] =
+    { "iata_code", "geonames_id", "lat", "lon", "country_code", "page_rank",
+      "matching_percentage", "corrected_keywords" };
+
+  // //////////////////////////////////////////////////////////////////////
+  DSVColumn::DSVColumn() {
+    assert (false);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string& DSVColumn::getLabel (const EN_DSVColumn& iColumn) {
+    return _labels[iColumn];
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  DSVColumn::EN_DSVColumn DSVColumn::getColumn (const std::string& iLabel) {
+    for (unsigned short idx = 0; idx != LAST_VALUE; ++idx) {
+      if (iLabel == _labels[idx]) {
+        return static_cast<EN_DSVColumn> (idx);
+      }
+    }
+
+    const std::string& lLabels = describeLabels();
+    std::ostringstream oMessage;
+    oMessage << "The output column '" << iLabel
+             << "' is not known. Known output columns: " << lLabels;
+    throw CodeConversionException (oMessage.str());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string DSVColumn::describeLabels() {
+    std::ostringstream ostr;
+    for (unsigned short idx = 0; idx != LAST_VALUE; ++idx) {
+      if (idx != 0) {
+        ostr << ", ";
+      }
+      ostr << _labels[idx];
+    }
+    return ostr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  DSVColumnList_T createAllColumnList() {
+    DSVColumnList_T oColumnList;
+    for (unsigned short idx = 0; idx != DSVColumn::LAST_VALUE; ++idx) {
+      oColumnList.push_back (static_cast<DSVColumn::EN_DSVColumn> (idx));
+    }
+    return oColumnList;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const DSVColumnList_T& DSVColumn::getAllColumns() {
+    // The list is built once, when first needed (in a thread-safe way)
+    static const DSVColumnList_T lAllColumnList (createAllColumnList());
+    return lAllColumnList;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  DSVColumnList_T DSVColumn::parseColumnList (const std::string& iLabelList) {
+    DSVColumnList_T oColumnList;
+
+    // The labels are separated by commas; the spaces around them
+    // are ignored
+    std::string::size_type lLabelPos = 0;
+    while (lLabelPos <= iLabelList.size()) {
+      std::string::size_type lCommaPos = iLabelList.find (',', lLabelPos);
+      if (lCommaPos == std::string::npos) {
+        lCommaPos = iLabelList.size();
+      }
+
+      const std::string::size_type lBeginPos =
+        iLabelList.find_first_not_of (' ', lLabelPos);
+      if (lBeginPos != std::string::npos && lBeginPos < lCommaPos) {
+        const std::string::size_type lEndPos =
+          iLabelList.find_last_not_of (' ', lCommaPos - 1);
+        assert (lEndPos != std::string::npos && lEndPos >= lBeginPos);
+        const std::string lLabel (iLabelList, lBeginPos,
+                                  lEndPos - lBeginPos + 1);
+        oColumnList.push_back (getColumn (lLabel));
+      }
+
+      lLabelPos = lCommaPos + 1;
+    }
+
+    if (oColumnList.empty() == true) {
+      return getAllColumns();
+    }
+    return oColumnList;
+  }
+
+}
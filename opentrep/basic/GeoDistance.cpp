@@ -0,0 +1,211 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <cmath>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif // __SSE2__
+// Boost
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+// OpenTrep
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/GeoDistance.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  void projectOntoUnitSphere (const Latitude_T& iLatitude,
+                              const Longitude_T& iLongitude,
+                              double oCoord[3]) {
+    const double lDegToRad = M_PI / 180.0;
+    const double lLat = iLatitude * lDegToRad;
+    const double lLon = iLongitude * lDegToRad;
+    const double lCosLat = std::cos (lLat);
+    oCoord[0] = lCosLat * std::cos (lLon);
+    oCoord[1] = lCosLat * std::sin (lLon);
+    oCoord[2] = std::sin (lLat);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void GeoCoordBuffer::addPoint (const Latitude_T& iLatitude,
+                                 const Longitude_T& iLongitude) {
+    double lCoord[3];
+    projectOntoUnitSphere (iLatitude, iLongitude, lCoord);
+    _x.push_back (lCoord[0]);
+    _y.push_back (lCoord[1]);
+    _z.push_back (lCoord[2]);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void GeoCoordBuffer::reserve (const size_t iNbOfPoints) {
+    _x.reserve (iNbOfPoints);
+    _y.reserve (iNbOfPoints);
+    _z.reserve (iNbOfPoints);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void calculateGreatCircleDistanceRow (const GeoCoordBuffer& iRowBuffer,
+                                        const size_t iRowIdx,
+                                        const GeoCoordBuffer& iColBuffer,
+                                        Distance_T* oDistanceRow) {
+    assert (iRowIdx < iRowBuffer.size());
+    const double lX = iRowBuffer._x[iRowIdx];
+    const double lY = iRowBuffer._y[iRowIdx];
+    const double lZ = iRowBuffer._z[iRowIdx];
+
+    const size_t lNbOfCols = iColBuffer.size();
+    const double* lColX = lNbOfCols != 0 ? &iColBuffer._x[0] : NULL;
+    const double* lColY = lNbOfCols != 0 ? &iColBuffer._y[0] : NULL;
+    const double* lColZ = lNbOfCols != 0 ? &iColBuffer._z[0] : NULL;
+
+    // Abramowitz & Stegun 4.4.46:
+    // asin(x) = pi/2 - sqrt(1-x) * (a0 + a1.x + ... + a7.x^7), for 0 <= x <= 1
+    const double a0 = 1.5707963050, a1 = -0.2145988016, a2 = 0.0889789874;
+    const double a3 = -0.0501743046, a4 = 0.0308918810, a5 = -0.0170881256;
+    const double a6 = 0.0066700901, a7 = -0.0012624911;
+    const double lDiameter = 2.0 * K_DEFAULT_EARTH_RADIUS;
+
+    size_t idx = 0;
+
+#if defined(__SSE2__)
+    // Two distances at a time. The square roots are explicit SSE2
+    // instructions, as the compilers do not vectorise std::sqrt()
+    // (because of errno) without specific flags.
+    const __m128d lX2 = _mm_set1_pd (lX);
+    const __m128d lY2 = _mm_set1_pd (lY);
+    const __m128d lZ2 = _mm_set1_pd (lZ);
+    const __m128d lHalf2 = _mm_set1_pd (0.5);
+    const __m128d lOne2 = _mm_set1_pd (1.0);
+    const __m128d lHalfPi2 = _mm_set1_pd (0.5 * M_PI);
+    const __m128d lDiameter2 = _mm_set1_pd (lDiameter);
+    for ( ; idx + 2 <= lNbOfCols; idx += 2) {
+      const __m128d dx = _mm_sub_pd (_mm_loadu_pd (lColX + idx), lX2);
+      const __m128d dy = _mm_sub_pd (_mm_loadu_pd (lColY + idx), lY2);
+      const __m128d dz = _mm_sub_pd (_mm_loadu_pd (lColZ + idx), lZ2);
+      const __m128d lSquaredChord =
+        _mm_add_pd (_mm_add_pd (_mm_mul_pd (dx, dx), _mm_mul_pd (dy, dy)),
+                    _mm_mul_pd (dz, dz));
+
+      // Half of the chord, bounded by 1 (rounding errors)
+      const __m128d lHalfChord =
+        _mm_min_pd (_mm_mul_pd (lHalf2, _mm_sqrt_pd (lSquaredChord)), lOne2);
+
+      __m128d lPoly = _mm_set1_pd (a7);
+      lPoly = _mm_add_pd (_mm_mul_pd (lPoly, lHalfChord), _mm_set1_pd (a6));
+      lPoly = _mm_add_pd (_mm_mul_pd (lPoly, lHalfChord), _mm_set1_pd (a5));
+      lPoly = _mm_add_pd (_mm_mul_pd (lPoly, lHalfChord), _mm_set1_pd (a4));
+      lPoly = _mm_add_pd (_mm_mul_pd (lPoly, lHalfChord), _mm_set1_pd (a3));
+      lPoly = _mm_add_pd (_mm_mul_pd (lPoly, lHalfChord), _mm_set1_pd (a2));
+      lPoly = _mm_add_pd (_mm_mul_pd (lPoly, lHalfChord), _mm_set1_pd (a1));
+      lPoly = _mm_add_pd (_mm_mul_pd (lPoly, lHalfChord), _mm_set1_pd (a0));
+      const __m128d lArcSine =
+        _mm_sub_pd (lHalfPi2,
+                    _mm_mul_pd (_mm_sqrt_pd (_mm_sub_pd (lOne2, lHalfChord)),
+                                lPoly));
+
+      _mm_storeu_pd (oDistanceRow + idx, _mm_mul_pd (lDiameter2, lArcSine));
+    }
+#endif // __SSE2__
+
+    // Remaining distances (or all of them, without SSE2)
+    for ( ; idx < lNbOfCols; ++idx) {
+      const double dx = lColX[idx] - lX;
+      const double dy = lColY[idx] - lY;
+      const double dz = lColZ[idx] - lZ;
+
+      // Half of the chord, bounded by 1 (rounding errors)
+      double lHalfChord = 0.5 * std::sqrt (dx*dx + dy*dy + dz*dz);
+      lHalfChord = lHalfChord > 1.0 ? 1.0 : lHalfChord;
+
+      const double lPoly =
+        a0 + lHalfChord * (a1 + lHalfChord * (a2 + lHalfChord
+        * (a3 + lHalfChord * (a4 + lHalfChord * (a5 + lHalfChord
+        * (a6 + lHalfChord * a7))))));
+      const double lArcSine = 0.5 * M_PI - std::sqrt (1.0 - lHalfChord) * lPoly;
+
+      oDistanceRow[idx] = lDiameter * lArcSine;
+    }
+  }
+
+  /**
+   * Calculate the rows [iBeginRow, iEndRow[ of the distance matrix.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void calculateGreatCircleDistanceRows (const GeoCoordBuffer& iRowBuffer,
+                                         const GeoCoordBuffer& iColBuffer,
+                                         DistanceMatrix_T& ioDistanceMatrix,
+                                         const size_t iBeginRow,
+                                         const size_t iEndRow) {
+    const size_t lNbOfCols = iColBuffer.size();
+    for (size_t idx = iBeginRow; idx < iEndRow; ++idx) {
+      DistanceList_T& lDistanceRow = ioDistanceMatrix[idx];
+      if (lNbOfCols != 0) {
+        calculateGreatCircleDistanceRow (iRowBuffer, idx, iColBuffer,
+                                         &lDistanceRow[0]);
+      }
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void calculateGreatCircleDistanceMatrix (const GeoCoordBuffer& iRowBuffer,
+                                           const GeoCoordBuffer& iColBuffer,
+                                           DistanceMatrix_T& ioDistanceMatrix,
+                                           const NbOfThreads_T& iNbOfThreads) {
+    const size_t lNbOfRows = iRowBuffer.size();
+    const size_t lNbOfCols = iColBuffer.size();
+
+    // Allocate the matrix once for all, so that the threads only write
+    // into their own rows
+    ioDistanceMatrix.resize (lNbOfRows);
+    for (DistanceMatrix_T::iterator itRow = ioDistanceMatrix.begin();
+         itRow != ioDistanceMatrix.end(); ++itRow) {
+      DistanceList_T& lDistanceRow = *itRow;
+      lDistanceRow.resize (lNbOfCols);
+    }
+
+    // Number of threads: bounded by the hardware, and so that each thread
+    // has enough distances to calculate
+    size_t lNbOfThreads = iNbOfThreads;
+    if (lNbOfThreads == 0) {
+      lNbOfThreads = boost::thread::hardware_concurrency();
+    }
+    const size_t lNbOfDistances = lNbOfRows * lNbOfCols;
+    const size_t lMaxNbOfThreads =
+      lNbOfDistances / K_DEFAULT_MIN_NB_OF_DISTANCES_PER_THREAD;
+    if (lNbOfThreads > lMaxNbOfThreads) {
+      lNbOfThreads = lMaxNbOfThreads;
+    }
+    if (lNbOfThreads > lNbOfRows) {
+      lNbOfThreads = lNbOfRows;
+    }
+
+    // Small matrix: no need for extra threads
+    if (lNbOfThreads <= 1) {
+      calculateGreatCircleDistanceRows (iRowBuffer, iColBuffer,
+                                        ioDistanceMatrix, 0, lNbOfRows);
+      return;
+    }
+
+    // Spread the rows across the threads, by contiguous blocks
+    boost::thread_group lThreadGroup;
+    const size_t lNbOfRowsPerThread =
+      (lNbOfRows + lNbOfThreads - 1) / lNbOfThreads;
+    for (size_t lBeginRow = 0; lBeginRow < lNbOfRows;
+         lBeginRow += lNbOfRowsPerThread) {
+      size_t lEndRow = lBeginRow + lNbOfRowsPerThread;
+      if (lEndRow > lNbOfRows) {
+        lEndRow = lNbOfRows;
+      }
+      lThreadGroup.create_thread (boost::bind (calculateGreatCircleDistanceRows,
+                                               boost::cref (iRowBuffer),
+                                               boost::cref (iColBuffer),
+                                               boost::ref (ioDistanceMatrix),
+                                               lBeginRow, lEndRow));
+    }
+    lThreadGroup.join_all();
+  }
+
+}
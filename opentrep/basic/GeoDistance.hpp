@@ -0,0 +1,102 @@
+#ifndef __OPENTREP_BAS_GEODISTANCE_HPP
+#define __OPENTREP_BAS_GEODISTANCE_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <vector>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * Project the given geographical coordinates onto the unit sphere.
+   *
+   * @param const Latitude_T& Latitude of the point, in degrees.
+   * @param const Longitude_T& Longitude of the point, in degrees.
+   * @param double[3] Cartesian coordinates of the projection.
+   */
+  void projectOntoUnitSphere (const Latitude_T&, const Longitude_T&,
+                              double oCoord[3]);
+
+  /**
+   * @brief Structure-of-arrays buffer of geographical coordinates.
+   *
+   * Each point is stored as its projection onto the unit sphere, in
+   * three separate contiguous arrays, so that the distance kernels
+   * process consecutive points with the same (vectorisable) instructions,
+   * without any trigonometric call in the inner loop.
+   */
+  struct GeoCoordBuffer {
+  public:
+    /**
+     * Add a point to the buffer.
+     *
+     * @param const Latitude_T& Latitude of the point, in degrees.
+     * @param const Longitude_T& Longitude of the point, in degrees.
+     */
+    void addPoint (const Latitude_T&, const Longitude_T&);
+
+    /**
+     * Reserve the memory for the given number of points.
+     */
+    void reserve (const size_t);
+
+    /**
+     * Get the number of points.
+     */
+    size_t size() const {
+      return _x.size();
+    }
+
+  public:
+    /**
+     * Coordinates of the points on the unit sphere.
+     */
+    std::vector<double> _x;
+    std::vector<double> _y;
+    std::vector<double> _z;
+  };
+
+  /**
+   * Calculate the great circle distances, in kilometers, between a single
+   * point and all the points of the given buffer.
+   *
+   * The kernel computes the chord between the projections onto the unit
+   * sphere, and converts it into an arc thanks to a polynomial
+   * approximation of arcsine (Abramowitz & Stegun 4.4.46, with an absolute
+   * error below 2e-8 radian, i.e., 0.2 meter on the Earth). The inner loop
+   * is branch-free, and explicitly vectorised with SSE2 when available.
+   *
+   * @param const GeoCoordBuffer& Buffer holding the single point.
+   * @param const size_t Index of the single point within that buffer.
+   * @param const GeoCoordBuffer& Buffer of the other points.
+   * @param Distance_T* Output array, of (at least) the size of that latter
+   *        buffer.
+   */
+  void calculateGreatCircleDistanceRow (const GeoCoordBuffer&, const size_t,
+                                        const GeoCoordBuffer&, Distance_T*);
+
+  /**
+   * Calculate the dense matrix of the great circle distances, in kilometers,
+   * between two sets of points.
+   *
+   * The row i of the matrix holds the distances between the i-th point of
+   * the first buffer and all the points of the second buffer. When the
+   * matrix is large enough, the rows are spread across several threads.
+   *
+   * @param const GeoCoordBuffer& First set of points (rows).
+   * @param const GeoCoordBuffer& Second set of points (columns).
+   * @param DistanceMatrix_T& Distance matrix, resized by the function.
+   * @param const NbOfThreads_T& Maximum number of threads (0 means the
+   *        number of hardware threads).
+   */
+  void calculateGreatCircleDistanceMatrix (const GeoCoordBuffer&,
+                                           const GeoCoordBuffer&,
+                                           DistanceMatrix_T&,
+                                           const NbOfThreads_T& iNbOfThreads = 0);
+
+}
+#endif // __OPENTREP_BAS_GEODISTANCE_HPP
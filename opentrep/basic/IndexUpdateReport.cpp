@@ -0,0 +1,55 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+// OpenTrep
+#include <opentrep/IndexUpdateReport.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  IndexUpdateReport::IndexUpdateReport() :
+    _nbOfAddedPOR (0), _nbOfChangedPOR (0), _nbOfRemovedPOR (0),
+    _nbOfUnchangedPOR (0) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  IndexUpdateReport::IndexUpdateReport (const IndexUpdateReport& iReport) :
+    _nbOfAddedPOR (iReport._nbOfAddedPOR),
+    _nbOfChangedPOR (iReport._nbOfChangedPOR),
+    _nbOfRemovedPOR (iReport._nbOfRemovedPOR),
+    _nbOfUnchangedPOR (iReport._nbOfUnchangedPOR) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  IndexUpdateReport::~IndexUpdateReport() {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string IndexUpdateReport::describe() const {
+    std::ostringstream oStr;
+    oStr << _nbOfAddedPOR << " added, " << _nbOfChangedPOR << " changed, "
+         << _nbOfRemovedPOR << " removed and " << _nbOfUnchangedPOR
+         << " unchanged POR records";
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string IndexUpdateReport::toString() const {
+    std::ostringstream oStr;
+    oStr << describe();
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexUpdateReport::toStream (std::ostream& ioOut) const {
+    ioOut << toString();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexUpdateReport::fromStream (std::istream& ioIn) {
+  }
+
+}
@@ -3,27 +3,38 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <cassert>
+#include <cstring>
 #include <sstream>
+#include <algorithm>
 // OpenTrep
 #include <opentrep/OPENTREP_exceptions.hpp>
 #include <opentrep/basic/icu_util.hpp>
 #include <opentrep/basic/BasConst_Unicode.hpp>
+#include <opentrep/basic/Utilities.hpp>
 #include <opentrep/basic/OTransliterator.hpp>
 #include <opentrep/service/Logger.hpp>
 
 namespace OPENTREP {
 
+  // //////////////////////////////////////////////////////////////////////
+  boost::atomic<unsigned long> OTransliterator::_lastGeneration (0);
+
+  // //////////////////////////////////////////////////////////////////////
+  unsigned long OTransliterator::getNewGeneration() {
+    return ++_lastGeneration;
+  }
+
   // //////////////////////////////////////////////////////////////////////
   OTransliterator::OTransliterator()
     : _punctuationRemover (NULL), _quoteRemover (NULL), _accentRemover (NULL),
-      _tranlist (NULL) {
+      _tranlist (NULL), _generation (getNewGeneration()) {
     init();
   }
 
   // //////////////////////////////////////////////////////////////////////
   OTransliterator::OTransliterator (const OTransliterator& iTransliterator)
     : _punctuationRemover (NULL), _quoteRemover (NULL), _accentRemover (NULL),
-      _tranlist (NULL) {
+      _tranlist (NULL), _generation (getNewGeneration()) {
     assert (iTransliterator._punctuationRemover != NULL);
     _punctuationRemover = iTransliterator._punctuationRemover->clone();
 
@@ -36,6 +47,39 @@ namespace OPENTREP {
     assert (iTransliterator._tranlist != NULL);
     _tranlist = iTransliterator._tranlist->clone();
 
+    // The ASCII mappings are the same; the clones and the caches of
+    // the threads are not copied
+    std::memcpy (_hasASCIIMap, iTransliterator._hasASCIIMap,
+                 sizeof (_hasASCIIMap));
+    std::memcpy (_asciiMap, iTransliterator._asciiMap, sizeof (_asciiMap));
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  OTransliterator& OTransliterator::
+  operator= (const OTransliterator& iTransliterator) {
+    if (this == &iTransliterator) {
+      return *this;
+    }
+
+    // Clone the prototypes of the other transliterator first, so that
+    // the current object is left untouched when a clone fails
+    ThreadTransliterators lClones (iTransliterator);
+
+    finalise();
+    std::swap (_punctuationRemover, lClones._punctuationRemover);
+    std::swap (_quoteRemover, lClones._quoteRemover);
+    std::swap (_accentRemover, lClones._accentRemover);
+    std::swap (_tranlist, lClones._tranlist);
+
+    std::memcpy (_hasASCIIMap, iTransliterator._hasASCIIMap,
+                 sizeof (_hasASCIIMap));
+    std::memcpy (_asciiMap, iTransliterator._asciiMap, sizeof (_asciiMap));
+
+    // The clones of the other threads, made from the former prototypes,
+    // are now stale
+    _generation = getNewGeneration();
+
+    return *this;
   }
 
   // //////////////////////////////////////////////////////////////////////
@@ -43,6 +87,77 @@ namespace OPENTREP {
     finalise();
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  icu::Transliterator* OTransliterator::
+  clone (const icu::Transliterator& iTransliterator) {
+    icu::Transliterator* oTransliterator = iTransliterator.clone();
+
+    if (oTransliterator == NULL) {
+      std::ostringstream oStr;
+      oStr << "Unicode error: the '" << getUTF8 (iTransliterator.getID())
+           << "' Transliterator can not be cloned.";
+      OPENTREP_LOG_ERROR (oStr.str());
+      throw UnicodeTransliteratorCreationException (oStr.str());
+    }
+    assert (oTransliterator != NULL);
+
+    return oTransliterator;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  OTransliterator::ThreadTransliterators::
+  ThreadTransliterators (const OTransliterator& iTransliterator)
+    : _generation (iTransliterator._generation),
+      _punctuationRemover (NULL), _quoteRemover (NULL), _accentRemover (NULL),
+      _tranlist (NULL) {
+    try {
+      assert (iTransliterator._punctuationRemover != NULL);
+      _punctuationRemover = clone (*iTransliterator._punctuationRemover);
+
+      assert (iTransliterator._quoteRemover != NULL);
+      _quoteRemover = clone (*iTransliterator._quoteRemover);
+
+      assert (iTransliterator._accentRemover != NULL);
+      _accentRemover = clone (*iTransliterator._accentRemover);
+
+      assert (iTransliterator._tranlist != NULL);
+      _tranlist = clone (*iTransliterator._tranlist);
+
+    } catch (...) {
+      delete _punctuationRemover; delete _quoteRemover;
+      delete _accentRemover; delete _tranlist;
+      throw;
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  OTransliterator::ThreadTransliterators::~ThreadTransliterators() {
+    delete _punctuationRemover; _punctuationRemover = NULL;
+    delete _quoteRemover; _quoteRemover = NULL;
+    delete _accentRemover; _accentRemover = NULL;
+    delete _tranlist; _tranlist = NULL;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  OTransliterator::ThreadTransliterators& OTransliterator::
+  getThreadTransliterators() const {
+    ThreadTransliterators* lThreadTransliterators_ptr =
+      _threadTransliterators.get();
+
+    // First use of the transliterators by the current thread, or clones
+    // left over by a former object (or by the object before its last
+    // assignment): clone them. The prototypes are only read here, which
+    // is safe to do concurrently.
+    if (lThreadTransliterators_ptr == NULL
+        || lThreadTransliterators_ptr->_generation != _generation) {
+      lThreadTransliterators_ptr = new ThreadTransliterators (*this);
+      _threadTransliterators.reset (lThreadTransliterators_ptr);
+    }
+    assert (lThreadTransliterators_ptr != NULL);
+
+    return *lThreadTransliterators_ptr;
+  }
+
   // //////////////////////////////////////////////////////////////////////
   void OTransliterator::initPunctuationRemover() {
     // Create a remover of punctuation
@@ -59,9 +174,6 @@ namespace OPENTREP {
       throw UnicodeTransliteratorCreationException (oStr.str());
     }
     assert (_punctuationRemover != NULL);
-               
-    // Register the Unicode Transliterator
-    icu::Transliterator::registerInstance (_punctuationRemover);
   }
 
   // //////////////////////////////////////////////////////////////////////
@@ -82,9 +194,6 @@ namespace OPENTREP {
       throw UnicodeTransliteratorCreationException (oStr.str());
     }
     assert (_quoteRemover != NULL);
-               
-    // Register the Unicode Transliterator
-    icu::Transliterator::registerInstance (_quoteRemover);
   }
 
   // //////////////////////////////////////////////////////////////////////
@@ -103,9 +212,6 @@ namespace OPENTREP {
       throw UnicodeTransliteratorCreationException (oStr.str());
     }
     assert (_accentRemover != NULL);
-               
-    // Register the Unicode Transliterator
-    icu::Transliterator::registerInstance (_accentRemover);
   }
 
   // //////////////////////////////////////////////////////////////////////
@@ -124,9 +230,68 @@ namespace OPENTREP {
       throw UnicodeTransliteratorCreationException (oStr.str());
     }
     assert (_tranlist != NULL);
-               
-    // Register the Unicode Transliterator
-    icu::Transliterator::registerInstance (_tranlist);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void OTransliterator::initASCIIMaps() {
+    // Transformations applied directly by the ICU transliterators
+    for (unsigned short lTransformationIdx = PUNCTUATION_REMOVAL;
+         lTransformationIdx != NORMALISATION; ++lTransformationIdx) {
+      const EN_Transformation lTransformation =
+        static_cast<EN_Transformation> (lTransformationIdx);
+      bool& hasASCIIMap = _hasASCIIMap[lTransformation];
+      char* lASCIIMap = _asciiMap[lTransformation];
+      hasASCIIMap = true;
+
+      // The null character is never mapped (see isPlainASCII())
+      lASCIIMap[0] = '\0';
+      for (unsigned short lChar = 1; lChar != _NB_OF_ASCII_CHARS; ++lChar) {
+        icu::UnicodeString lString (static_cast<UChar> (lChar));
+        transform (lTransformation, lString);
+
+        if (lString.length() == 0) {
+          // The character is removed
+          lASCIIMap[lChar] = '\0';
+
+        } else if (lString.length() == 1 && lString.charAt (0) != 0
+                   && lString.charAt (0) < _NB_OF_ASCII_CHARS) {
+          // The character is mapped onto a single ASCII character
+          lASCIIMap[lChar] = static_cast<char> (lString.charAt (0));
+
+        } else {
+          // The character is mapped onto something else: the ICU
+          // transliterator has to be used for that transformation
+          hasASCIIMap = false;
+          break;
+        }
+      }
+    }
+
+    /**
+     * The normalisation is the composition of the other transformations,
+     * in the same order as within the normalise() method.
+     */
+    const EN_Transformation lNormalisationSteps[] =
+      { ACCENT_REMOVAL, QUOTATION_REMOVAL, PUNCTUATION_REMOVAL,
+        TRANSLITERATION };
+    bool& hasNormalisationMap = _hasASCIIMap[NORMALISATION];
+    char* lNormalisationMap = _asciiMap[NORMALISATION];
+    hasNormalisationMap = true;
+    for (unsigned short lChar = 0; lChar != _NB_OF_ASCII_CHARS; ++lChar) {
+      lNormalisationMap[lChar] = static_cast<char> (lChar);
+    }
+    for (unsigned short idx = 0; idx != 4; ++idx) {
+      const EN_Transformation& lStep = lNormalisationSteps[idx];
+      if (_hasASCIIMap[lStep] == false) {
+        hasNormalisationMap = false;
+        break;
+      }
+      for (unsigned short lChar = 0; lChar != _NB_OF_ASCII_CHARS; ++lChar) {
+        const char lImage = lNormalisationMap[lChar];
+        const unsigned char lImageIdx = static_cast<unsigned char> (lImage);
+        lNormalisationMap[lChar] = _asciiMap[lStep][lImageIdx];
+      }
+    }
   }
 
   // //////////////////////////////////////////////////////////////////////
@@ -135,10 +300,14 @@ namespace OPENTREP {
     initQuoteRemover();
     initAccentRemover();
     initTranlisterator();
+    initASCIIMaps();
   }
 
   // //////////////////////////////////////////////////////////////////////
   void OTransliterator::finalise() {
+    // The clones of the other threads are deleted when those latter exit
+    _threadTransliterators.reset();
+
     delete _punctuationRemover; _punctuationRemover = NULL;
     delete _quoteRemover; _quoteRemover = NULL;
     delete _accentRemover; _accentRemover = NULL;
@@ -148,102 +317,128 @@ namespace OPENTREP {
   // //////////////////////////////////////////////////////////////////////
   void OTransliterator::unpunctuate (icu::UnicodeString& ioString) const {
     // Apply the punctuation removal scheme
-    assert (_punctuationRemover != NULL);
-    _punctuationRemover->transliterate (ioString);
+    ThreadTransliterators& lThreadTransliterators = getThreadTransliterators();
+    assert (lThreadTransliterators._punctuationRemover != NULL);
+    lThreadTransliterators._punctuationRemover->transliterate (ioString);
   }
 
   // //////////////////////////////////////////////////////////////////////
   std::string OTransliterator::unpunctuate (const std::string& iString) const {
-    // Build a UnicodeString from the STL string
-    icu::UnicodeString lString (iString.c_str());
-
-    // Apply the punctuation removal scheme
-    unpunctuate (lString);
-
-    // Convert back from UnicodeString to UTF8-encoded STL string
-    const std::string& lPunctuatedString = getUTF8 (lString);
-
-    return lPunctuatedString;
+    return transform (PUNCTUATION_REMOVAL, iString);
   }
 
   // //////////////////////////////////////////////////////////////////////
   void OTransliterator::unquote (icu::UnicodeString& ioString) const {
     // Apply the quotation removal scheme
-    assert (_quoteRemover != NULL);
-    _quoteRemover->transliterate (ioString);
+    ThreadTransliterators& lThreadTransliterators = getThreadTransliterators();
+    assert (lThreadTransliterators._quoteRemover != NULL);
+    lThreadTransliterators._quoteRemover->transliterate (ioString);
   }
 
   // //////////////////////////////////////////////////////////////////////
   std::string OTransliterator::unquote (const std::string& iString) const {
-    // Build a UnicodeString from the STL string
-    icu::UnicodeString lString (iString.c_str());
-
-    // Apply the quotation removal scheme
-    unquote (lString);
-
-    // Convert back from UnicodeString to UTF8-encoded STL string
-    const std::string& lUnquotedString = getUTF8 (lString);
-
-    return lUnquotedString;
+    return transform (QUOTATION_REMOVAL, iString);
   }
 
   // //////////////////////////////////////////////////////////////////////
   void OTransliterator::unaccent (icu::UnicodeString& ioString) const {
     // Apply the accent removal scheme
-    assert (_accentRemover != NULL);
-    _accentRemover->transliterate (ioString);
+    ThreadTransliterators& lThreadTransliterators = getThreadTransliterators();
+    assert (lThreadTransliterators._accentRemover != NULL);
+    lThreadTransliterators._accentRemover->transliterate (ioString);
   }
 
   // //////////////////////////////////////////////////////////////////////
   std::string OTransliterator::unaccent (const std::string& iString) const {
-    // Build a UnicodeString from the STL string
-    icu::UnicodeString lString (iString.c_str());
-
-    // Apply the accent removal scheme
-    unaccent (lString);
-
-    // Convert back from UnicodeString to UTF8-encoded STL string
-    const std::string& lUnaccentuatedString = getUTF8 (lString);
-
-    return lUnaccentuatedString;
+    return transform (ACCENT_REMOVAL, iString);
   }
 
   // //////////////////////////////////////////////////////////////////////
   void OTransliterator::transliterate (icu::UnicodeString& ioString) const {
     // Apply the transliteration scheme
-    assert (_tranlist != NULL);
-    _tranlist->transliterate (ioString);
+    ThreadTransliterators& lThreadTransliterators = getThreadTransliterators();
+    assert (lThreadTransliterators._tranlist != NULL);
+    lThreadTransliterators._tranlist->transliterate (ioString);
   }
 
   // //////////////////////////////////////////////////////////////////////
   std::string OTransliterator::transliterate (const std::string& iString) const {
-    // Build a UnicodeString from the STL string
-    icu::UnicodeString lString (iString.c_str());
-
-    // Apply the transliteration scheme
-    transliterate (lString);
+    return transform (TRANSLITERATION, iString);
+  }
 
-    // Convert back from UnicodeString to UTF8-encoded STL string
-    const std::string& lTransliteratedString = getUTF8 (lString);
+  // //////////////////////////////////////////////////////////////////////
+  std::string OTransliterator::normalise (const std::string& iString) const {
+    return transform (NORMALISATION, iString);
+  }
 
-    return lTransliteratedString;
+  // //////////////////////////////////////////////////////////////////////
+  void OTransliterator::transform (const EN_Transformation& iTransformation,
+                                   icu::UnicodeString& ioString) const {
+    switch (iTransformation) {
+    case PUNCTUATION_REMOVAL: unpunctuate (ioString); break;
+    case QUOTATION_REMOVAL: unquote (ioString); break;
+    case ACCENT_REMOVAL: unaccent (ioString); break;
+    case TRANSLITERATION: transliterate (ioString); break;
+    case NORMALISATION: {
+      // Apply the whole sery of transformators
+      unaccent (ioString);
+      unquote (ioString);
+      unpunctuate (ioString);
+      transliterate (ioString);
+      break;
+    }
+    default: assert (false); break;
+    }
   }
 
   // //////////////////////////////////////////////////////////////////////
-  std::string OTransliterator::normalise (const std::string& iString) const {
+  std::string OTransliterator::
+  transform (const EN_Transformation& iTransformation,
+             const std::string& iString) const {
+    // Fast path: plain ASCII string, mapped character per character
+    if (_hasASCIIMap[iTransformation] == true
+        && isPlainASCII (iString) == true) {
+      const char* lASCIIMap = _asciiMap[iTransformation];
+      std::string oString;
+      oString.reserve (iString.size());
+      for (std::string::const_iterator itChar = iString.begin();
+           itChar != iString.end(); ++itChar) {
+        const char lImage = lASCIIMap[static_cast<unsigned char> (*itChar)];
+        if (lImage != '\0') {
+          oString.push_back (lImage);
+        }
+      }
+      return oString;
+    }
+
+    // Check whether the string has already been transformed
+    ThreadTransliterators& lThreadTransliterators = getThreadTransliterators();
+    TransformationCache_T& lCache =
+      lThreadTransliterators._cacheList[iTransformation];
+    TransformationCache_T::const_iterator itString = lCache.find (iString);
+    if (itString != lCache.end()) {
+      return itString->second;
+    }
+
     // Build a UnicodeString from the STL string
     icu::UnicodeString lString (iString.c_str());
 
-    // Apply the whole sery of transformators
-    unaccent (lString);
-    unquote (lString);
-    unpunctuate (lString);
-    transliterate (lString);
+    // Apply the transformation scheme
+    transform (iTransformation, lString);
 
     // Convert back from UnicodeString to UTF8-encoded STL string
-    const std::string& lNormalisedString = getUTF8 (lString);
+    const std::string& lTransformedString = getUTF8 (lString);
+
+    // Memoise the transformed string. When the cache is full, it is
+    // just emptied, which is simpler (and cheaper) than tracking the
+    // least recently used strings.
+    if (lCache.size() >= K_DEFAULT_TRANSFORMATION_CACHE_SIZE) {
+      lCache.clear();
+    }
+    lCache.insert (TransformationCache_T::value_type (iString,
+                                                      lTransformedString));
 
-    return lNormalisedString;
+    return lTransformedString;
   }
 
 }
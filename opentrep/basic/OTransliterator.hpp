@@ -6,14 +6,49 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <string>
+#include <unordered_map>
+// Boost
+#include <boost/atomic.hpp>
+#include <boost/thread/tss.hpp>
 // ICU
 #include <unicode/unistr.h> // UnicodeString
 #include <unicode/translit.h> // Transliterator
 
 namespace OPENTREP {
 
+  /**
+   * Memo cache of transformed strings (the keys being the original strings).
+   */
+  typedef std::unordered_map<std::string, std::string> TransformationCache_T;
+
   /**
    * Wrapper around a Unicode transliterator.
+   *
+   * As the ICU transformations are costly (conversion to and from
+   * UnicodeString, rule-based transliteration), two shortcuts are used:
+   * <ul>
+   *   <li>on plain ASCII strings, which are the most frequent ones, all the
+   *       rules amount to a character-per-character mapping (e.g., removal
+   *       of the punctuation, lower case). That mapping is derived once from
+   *       the ICU transliterators themselves, when the object is built,
+   *       and ICU is then skipped altogether;</li>
+   *   <li>the transformations of the other strings are memoised within
+   *       bounded caches.</li>
+   * </ul>
+   *
+   * As the ICU transliterators can not be used by several threads at once,
+   * the ones built by the constructor are only prototypes: each thread
+   * lazily gets its own clones (along with its own caches) the first time
+   * it transforms a string. Hence, a single OTransliterator object may be
+   * shared, without any lock, by any number of (search or indexing)
+   * threads.
+   *
+   * The clones of a thread are keyed by the address of the object: once
+   * that latter is assigned or destroyed, the clones of the other threads
+   * are stale (and another object may later be built at the same address).
+   * Hence, every object (and every assignment) gets its own generation
+   * number, and the clones of a thread are re-created when they do not
+   * bear the generation of the object.
    */
   class OTransliterator {
   public:
@@ -80,6 +115,12 @@ namespace OPENTREP {
      */
     OTransliterator (const OTransliterator&);
 
+    /**
+     * Assignment operator. The ICU transliterator prototypes are cloned,
+     * and the clones of the threads (and their caches) are discarded.
+     */
+    OTransliterator& operator= (const OTransliterator&);
+
     /**
      * Destructor.
      */
@@ -87,7 +128,101 @@ namespace OPENTREP {
 
 
   private:
+    /**
+     * Transformations supported by the transliterator.
+     */
+    typedef enum {
+      PUNCTUATION_REMOVAL = 0,
+      QUOTATION_REMOVAL,
+      ACCENT_REMOVAL,
+      TRANSLITERATION,
+      NORMALISATION,
+      LAST_VALUE
+    } EN_Transformation;
+
+    /**
+     * Number of ASCII characters.
+     */
+    static const unsigned short _NB_OF_ASCII_CHARS = 128;
+
+    /**
+     * Clones of the ICU transliterators, and memo caches, specific
+     * to a thread.
+     */
+    struct ThreadTransliterators {
+      /**
+       * Constructor, cloning the given transliterator prototypes.
+       */
+      ThreadTransliterators (const OTransliterator&);
+
+      /**
+       * Destructor, deleting the clones.
+       */
+      ~ThreadTransliterators();
+
+      /**
+       * Generation of the prototypes the clones have been made from.
+       */
+      unsigned long _generation;
+
+      /**
+       * Clones of the ICU transliterators, respectively for the removal
+       * of punctuation, of quotation, of accents, and for the
+       * transliteration.
+       */
+      icu::Transliterator* _punctuationRemover;
+      icu::Transliterator* _quoteRemover;
+      icu::Transliterator* _accentRemover;
+      icu::Transliterator* _tranlist;
+
+      /**
+       * For every transformation, the memo cache of the non-ASCII strings.
+       * A cache is emptied when it reaches its maximal size (see
+       * K_DEFAULT_TRANSFORMATION_CACHE_SIZE).
+       */
+      TransformationCache_T _cacheList[LAST_VALUE];
+    };
+
+    /**
+     * Get the clones of the ICU transliterators specific to the current
+     * thread, creating them when that thread uses them for the first time.
+     */
+    ThreadTransliterators& getThreadTransliterators() const;
+
+    /**
+     * Clone the given ICU transliterator prototype.
+     *
+     * @param const icu::Transliterator& The prototype to be cloned.
+     * @return icu::Transliterator* The clone, owned by the caller.
+     */
+    static icu::Transliterator* clone (const icu::Transliterator&);
+
+    /**
+     * Get a generation number never given before within the process.
+     */
+    static unsigned long getNewGeneration();
+
     // //////////////// Business support methods ///////////////
+    /**
+     * Apply the given transformation to the given string, through the ASCII
+     * mapping, the cache or, as a last resort, the ICU transliterators.
+     *
+     * @param const EN_Transformation& Transformation to be applied.
+     * @param const std::string& The string to be transformed.
+     * @return std::string The transformed string.
+     */
+    std::string transform (const EN_Transformation&,
+                           const std::string&) const;
+
+    /**
+     * Apply the given transformation to the given string, with the
+     * ICU transliterators.
+     *
+     * @param const EN_Transformation& Transformation to be applied.
+     * @param UnicodeString& The string to be transformed.
+     */
+    void transform (const EN_Transformation&, icu::UnicodeString&) const;
+
     /**
      * Remove the punctuation of the given string.
      *
@@ -163,6 +298,14 @@ namespace OPENTREP {
      */
     void initTranlisterator();
 
+    /**
+     * Derive, from the ICU transliterators, the mapping of the ASCII
+     * characters for every transformation. When a transformation maps
+     * an ASCII character onto a non-ASCII one, or onto several characters,
+     * there is no ASCII mapping for that transformation.
+     */
+    void initASCIIMaps();
+
     /**
      * Perform all the above initialisation operations.
      */
@@ -177,26 +320,56 @@ namespace OPENTREP {
   private:
     // /////////////////////// Attributes //////////////////////
     /**
-     * Pointer on the Unicode Transliterator for the removal of punctuation.
+     * Prototype of the Unicode Transliterator for the removal of punctuation.
      */
     icu::Transliterator* _punctuationRemover;
 
     /**
-     * Pointer on the Unicode Transliterator for the removal of quotation.
+     * Prototype of the Unicode Transliterator for the removal of quotation.
      */
     icu::Transliterator* _quoteRemover;
 
     /**
-     * Pointer on the Unicode Transliterator for the removal of accents.
+     * Prototype of the Unicode Transliterator for the removal of accents.
      */
     icu::Transliterator* _accentRemover;
 
     /**
-     * Pointer on the Unicode Transliterator for the transliteration of any
+     * Prototype of the Unicode Transliterator for the transliteration of any
      * language script (e.g., Arabic, Cyrillic, Greek, Han, Hangul, Hebrew,
      * Katakana, Thai) to Latin characters.
      */
     icu::Transliterator* _tranlist;
+
+    /**
+     * For every transformation, whether all the ASCII characters are mapped
+     * onto at most one ASCII character.
+     */
+    bool _hasASCIIMap[LAST_VALUE];
+
+    /**
+     * For every transformation, the image of the ASCII characters (the null
+     * character standing for the removal of the character).
+     */
+    char _asciiMap[LAST_VALUE][_NB_OF_ASCII_CHARS];
+
+    /**
+     * Generation of the prototypes, set when the object is built or
+     * assigned.
+     */
+    unsigned long _generation;
+
+    /**
+     * Last generation number given within the process.
+     */
+    static boost::atomic<unsigned long> _lastGeneration;
+
+    /**
+     * Clones of the Unicode Transliterators, and memo caches, of every
+     * thread using the object.
+     */
+    mutable boost::thread_specific_ptr<ThreadTransliterators>
+    _threadTransliterators;
   };
 
 }
@@ -0,0 +1,91 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+// Boost
+#include <boost/algorithm/string/case_conv.hpp>
+// OpenTrep
+#include <opentrep/OriginHint.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  OriginHint::OriginHint() :
+    _hasCoordinates (false), _latitude (0.0), _longitude (0.0),
+    _countryCode (CountryCode_T ("")) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  OriginHint::OriginHint (const Latitude_T& iLatitude,
+                          const Longitude_T& iLongitude) :
+    _hasCoordinates (true), _latitude (iLatitude), _longitude (iLongitude),
+    _countryCode (CountryCode_T ("")) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  OriginHint::OriginHint (const CountryCode_T& iCountryCode) :
+    _hasCoordinates (false), _latitude (0.0), _longitude (0.0),
+    _countryCode (CountryCode_T (boost::algorithm::to_upper_copy
+                                 (std::string (iCountryCode)))) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  OriginHint::OriginHint (const Latitude_T& iLatitude,
+                          const Longitude_T& iLongitude,
+                          const CountryCode_T& iCountryCode) :
+    _hasCoordinates (true), _latitude (iLatitude), _longitude (iLongitude),
+    _countryCode (CountryCode_T (boost::algorithm::to_upper_copy
+                                 (std::string (iCountryCode)))) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  OriginHint::OriginHint (const OriginHint& iOriginHint) :
+    _hasCoordinates (iOriginHint._hasCoordinates),
+    _latitude (iOriginHint._latitude), _longitude (iOriginHint._longitude),
+    _countryCode (iOriginHint._countryCode) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  OriginHint::~OriginHint() {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string OriginHint::describe() const {
+    std::ostringstream oStr;
+    if (isEmpty() == true) {
+      oStr << "no origin";
+      return oStr.str();
+    }
+
+    if (_hasCoordinates == true) {
+      oStr << "(" << _latitude << ", " << _longitude << ")";
+    }
+    if (_countryCode.empty() == false) {
+      if (_hasCoordinates == true) {
+        oStr << " ";
+      }
+      oStr << "in " << _countryCode;
+    }
+
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string OriginHint::toString() const {
+    std::ostringstream oStr;
+    oStr << describe();
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void OriginHint::toStream (std::ostream& ioOut) const {
+    ioOut << toString();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void OriginHint::fromStream (std::istream& ioIn) {
+  }
+
+}
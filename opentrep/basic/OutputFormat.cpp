@@ -11,10 +11,11 @@ namespace OPENTREP {
   
   // //////////////////////////////////////////////////////////////////////
   const std::string OutputFormat::_labels[LAST_VALUE] =
-    { "Short", "Full", "JSON", "PROTOBUF" };
+    { "Short", "Full", "JSON", "PROTOBUF", "CSV", "TSV" };
 
   // //////////////////////////////////////////////////////////////////////
-  const char OutputFormat::_formatLabels[LAST_VALUE] = { 'S', 'F', 'J', 'P' };
+  const char OutputFormat::_formatLabels[LAST_VALUE] =
+    { 'S', 'F', 'J', 'P', 'C', 'T' };
 
   
   // //////////////////////////////////////////////////////////////////////
@@ -43,6 +44,8 @@ namespace OPENTREP {
     case 'F': oFormat = FULL; break;
     case 'J': oFormat = JSON; break;
     case 'P': oFormat = PROTOBUF; break;
+    case 'C': oFormat = CSV; break;
+    case 'T': oFormat = TSV; break;
     default: oFormat = LAST_VALUE; break;
     }
 
@@ -0,0 +1,148 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+// OpenTREP
+#include <opentrep/PORParserType.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string PORParserType::_labels[LAST_VALUE] =
+    { "Spirit", "SIMD", "CrossCheck" };
+
+  // //////////////////////////////////////////////////////////////////////
+  const char PORParserType::_typeLabels[LAST_VALUE] = { 'G', 'S', 'C' };
+
+  // //////////////////////////////////////////////////////////////////////
+  PORParserType::PORParserType() : _type (LAST_VALUE) {
+    assert (false);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORParserType::PORParserType (const PORParserType& iPORParserType)
+    : _type (iPORParserType._type) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORParserType::PORParserType (const EN_PORParserType& iPORParserType)
+    : _type (iPORParserType) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORParserType::EN_PORParserType
+  PORParserType::getType (const char iTypeChar) {
+    EN_PORParserType oType;
+    switch (iTypeChar) {
+    case 'G': oType = SPIRIT; break;
+    case 'S': oType = SIMD; break;
+    case 'C': oType = CROSS_CHECK; break;
+    default: oType = LAST_VALUE; break;
+    }
+
+    if (oType == LAST_VALUE) {
+      const std::string& lLabels = describeLabels();
+      std::ostringstream oMessage;
+      oMessage << "The POR parser type '" << iTypeChar
+               << "' is not known. Known POR parser types: " << lLabels;
+      throw CodeConversionException (oMessage.str());
+    }
+
+    return oType;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORParserType::PORParserType (const char iTypeChar)
+    : _type (getType (iTypeChar)) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORParserType::PORParserType (const std::string& iTypeStr)
+    : _type (LAST_VALUE) {
+    if (iTypeStr == "spirit" || iTypeStr == "grammar") {
+      _type = SPIRIT;
+    } else if (iTypeStr == "simd" || iTypeStr == "fast") {
+      _type = SIMD;
+    } else if (iTypeStr == "check" || iTypeStr == "crosscheck") {
+      _type = CROSS_CHECK;
+    } else {
+      _type = LAST_VALUE;
+    }
+
+    if (_type == LAST_VALUE) {
+      const std::string& lLabels = describeLabels();
+      std::ostringstream oMessage;
+      oMessage << "The POR parser type '" << iTypeStr
+               << "' is not known. Known POR parser types: " << lLabels;
+      throw CodeConversionException (oMessage.str());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string& PORParserType::getLabel (const EN_PORParserType& iType) {
+    return _labels[iType];
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  char PORParserType::getTypeLabel (const EN_PORParserType& iType) {
+    return _typeLabels[iType];
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string PORParserType::
+  getTypeLabelAsString (const EN_PORParserType& iType) {
+    std::ostringstream oStr;
+    oStr << _typeLabels[iType];
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string PORParserType::describeLabels() {
+    std::ostringstream ostr;
+    for (unsigned short idx = 0; idx != LAST_VALUE; ++idx) {
+      if (idx != 0) {
+        ostr << ", ";
+      }
+      ostr << _labels[idx];
+    }
+    return ostr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORParserType::EN_PORParserType PORParserType::getType() const {
+    return _type;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  char PORParserType::getTypeAsChar() const {
+    const char oTypeChar = _typeLabels[_type];
+    return oTypeChar;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string PORParserType::getTypeAsString() const {
+    std::ostringstream oStr;
+    oStr << _typeLabels[_type];
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string PORParserType::describe() const {
+    std::ostringstream ostr;
+    ostr << _labels[_type];
+    return ostr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  bool PORParserType::operator== (const EN_PORParserType& iType) const {
+    return (_type == iType);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  bool PORParserType::operator== (const PORParserType& iPORParserType) const {
+    return (_type == iPORParserType._type);
+  }
+
+}
@@ -0,0 +1,148 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+// OpenTREP
+#include <opentrep/SQLDBLoadMode.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string SQLDBLoadMode::_labels[LAST_VALUE] =
+    { "Disk", "Memory", "MMap" };
+
+  // //////////////////////////////////////////////////////////////////////
+  const char SQLDBLoadMode::_modeLabels[LAST_VALUE] = { 'D', 'M', 'P' };
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLDBLoadMode::SQLDBLoadMode() : _mode (LAST_VALUE) {
+    assert (false);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLDBLoadMode::SQLDBLoadMode (const SQLDBLoadMode& iSQLDBLoadMode)
+    : _mode (iSQLDBLoadMode._mode) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLDBLoadMode::SQLDBLoadMode (const EN_SQLDBLoadMode& iSQLDBLoadMode)
+    : _mode (iSQLDBLoadMode) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLDBLoadMode::EN_SQLDBLoadMode
+  SQLDBLoadMode::getMode (const char iModeChar) {
+    EN_SQLDBLoadMode oMode;
+    switch (iModeChar) {
+    case 'D': oMode = ON_DISK; break;
+    case 'M': oMode = IN_MEMORY; break;
+    case 'P': oMode = MMAP; break;
+    default: oMode = LAST_VALUE; break;
+    }
+
+    if (oMode == LAST_VALUE) {
+      const std::string& lLabels = describeLabels();
+      std::ostringstream oMessage;
+      oMessage << "The SQL database load mode '" << iModeChar
+               << "' is not known. Known SQL database load modes: " << lLabels;
+      throw CodeConversionException (oMessage.str());
+    }
+
+    return oMode;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLDBLoadMode::SQLDBLoadMode (const char iModeChar)
+    : _mode (getMode (iModeChar)) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLDBLoadMode::SQLDBLoadMode (const std::string& iModeStr)
+    : _mode (LAST_VALUE) {
+    if (iModeStr == "disk" || iModeStr == "ondisk") {
+      _mode = ON_DISK;
+    } else if (iModeStr == "memory" || iModeStr == "inmemory") {
+      _mode = IN_MEMORY;
+    } else if (iModeStr == "mmap" || iModeStr == "immutable") {
+      _mode = MMAP;
+    } else {
+      _mode = LAST_VALUE;
+    }
+
+    if (_mode == LAST_VALUE) {
+      const std::string& lLabels = describeLabels();
+      std::ostringstream oMessage;
+      oMessage << "The SQL database load mode '" << iModeStr
+               << "' is not known. Known SQL database load modes: " << lLabels;
+      throw CodeConversionException (oMessage.str());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string& SQLDBLoadMode::getLabel (const EN_SQLDBLoadMode& iMode) {
+    return _labels[iMode];
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  char SQLDBLoadMode::getModeLabel (const EN_SQLDBLoadMode& iMode) {
+    return _modeLabels[iMode];
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string SQLDBLoadMode::
+  getModeLabelAsString (const EN_SQLDBLoadMode& iMode) {
+    std::ostringstream oStr;
+    oStr << _modeLabels[iMode];
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string SQLDBLoadMode::describeLabels() {
+    std::ostringstream ostr;
+    for (unsigned short idx = 0; idx != LAST_VALUE; ++idx) {
+      if (idx != 0) {
+        ostr << ", ";
+      }
+      ostr << _labels[idx];
+    }
+    return ostr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLDBLoadMode::EN_SQLDBLoadMode SQLDBLoadMode::getMode() const {
+    return _mode;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  char SQLDBLoadMode::getModeAsChar() const {
+    const char oModeChar = _modeLabels[_mode];
+    return oModeChar;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string SQLDBLoadMode::getModeAsString() const {
+    std::ostringstream oStr;
+    oStr << _modeLabels[_mode];
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string SQLDBLoadMode::describe() const {
+    std::ostringstream ostr;
+    ostr << _labels[_mode];
+    return ostr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  bool SQLDBLoadMode::operator== (const EN_SQLDBLoadMode& iMode) const {
+    return (_mode == iMode);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  bool SQLDBLoadMode::operator== (const SQLDBLoadMode& iSQLDBLoadMode) const {
+    return (_mode == iSQLDBLoadMode._mode);
+  }
+
+}
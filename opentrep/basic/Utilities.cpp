@@ -3,13 +3,19 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <cassert>
+#include <cmath>
+#include <iomanip>
 #include <ostream>
 #include <sstream>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif // __SSE2__
 // Boost (Extended STL)
 #include <boost/tokenizer.hpp>
 // OpenTrep
 #include <opentrep/OPENTREP_exceptions.hpp>
 #include <opentrep/DBType.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
 #include <opentrep/basic/Utilities.hpp>
 #include <opentrep/service/Logger.hpp>
 
@@ -102,6 +108,101 @@ namespace OPENTREP {
     return oStr.str();
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  Distance_T calculateGreatCircleDistance (const Latitude_T& iLat1,
+                                           const Longitude_T& iLon1,
+                                           const Latitude_T& iLat2,
+                                           const Longitude_T& iLon2) {
+    const double lDegToRad = M_PI / 180.0;
+    const double lLat1 = iLat1 * lDegToRad;
+    const double lLat2 = iLat2 * lDegToRad;
+    const double lSinDLat = std::sin (0.5 * (lLat2 - lLat1));
+    const double lSinDLon = std::sin (0.5 * (iLon2 - iLon1) * lDegToRad);
+
+    // Haversine formula
+    double lHav = lSinDLat * lSinDLat
+      + std::cos (lLat1) * std::cos (lLat2) * lSinDLon * lSinDLon;
+    if (lHav > 1.0) {
+      lHav = 1.0;
+    }
+    const Distance_T oDistance =
+      2.0 * K_DEFAULT_EARTH_RADIUS * std::asin (std::sqrt (lHav));
+    return oDistance;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  bool isPlainASCII (const std::string& iString) {
+    const size_t lSize = iString.size();
+    const char* lData = iString.data();
+    size_t idx = 0;
+
+#if defined(__SSE2__)
+    // The high bit of every non-ASCII byte is set, and the null bytes
+    // are equal to zero
+    const __m128i lZero = _mm_setzero_si128();
+    for ( ; idx + 16 <= lSize; idx += 16) {
+      const __m128i lBytes =
+        _mm_loadu_si128 (reinterpret_cast<const __m128i*> (lData + idx));
+      const int lNonASCIIMask = _mm_movemask_epi8 (lBytes);
+      const int lNullMask = _mm_movemask_epi8 (_mm_cmpeq_epi8 (lBytes, lZero));
+      if ((lNonASCIIMask | lNullMask) != 0) {
+        return false;
+      }
+    }
+#endif // __SSE2__
+
+    // Remaining bytes (or all of them, without SSE2)
+    for ( ; idx < lSize; ++idx) {
+      const unsigned char lByte = static_cast<unsigned char> (lData[idx]);
+      if (lByte == 0 || lByte >= 0x80) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  ContentHash_T calculateContentHash (const std::string& iContent) {
+    // 64-bit FNV-1a hash (http://www.isthe.com/chongo/tech/comp/fnv/)
+    unsigned long long lHash = 14695981039346656037ULL;
+    for (std::string::const_iterator itChar = iContent.begin();
+         itChar != iContent.end(); ++itChar) {
+      lHash ^= static_cast<unsigned char> (*itChar);
+      lHash *= 1099511628211ULL;
+    }
+
+    std::ostringstream oStr;
+    oStr << std::hex << std::setfill ('0') << std::setw (16) << lHash;
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string buildPORUniqueID (const std::string& iPK,
+                                const EnvelopeID_T& iEnvelopeID) {
+    std::ostringstream oStr;
+    oStr << iPK << "-" << iEnvelopeID;
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void splitPORUniqueID (const std::string& iUniqueID,
+                         std::string& ioPK, EnvelopeID_T& ioEnvelopeID) {
+    // The primary key itself contains dashes (e.g., NCE-CA-6299418),
+    // but the envelope ID is the last field
+    const size_t lLastDashPos = iUniqueID.rfind ('-');
+    if (lLastDashPos == std::string::npos) {
+      ioPK = iUniqueID;
+      ioEnvelopeID = 0;
+      return;
+    }
+
+    ioPK = iUniqueID.substr (0, lLastDashPos);
+    std::istringstream lEnvelopeIDStr (iUniqueID.substr (lLastDashPos + 1));
+    ioEnvelopeID = 0;
+    lEnvelopeIDStr >> ioEnvelopeID;
+  }
+
   // //////////////////////////////////////////////////////////////////////
   StringMap_T
   parseMySQLConnectionString (const SQLDBConnectionString_T& iSQLDBConnStr) {
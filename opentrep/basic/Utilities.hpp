@@ -37,6 +37,65 @@ namespace OPENTREP {
                                         const NbOfWords_T iSplitIdx = 0,
                                         const bool iFromBeginningFlag = true);
 
+  /**
+   * Calculate the great circle distance, in kilometers, between two
+   * geographical points, thanks to the haversine formula.
+   *
+   * @param const Latitude_T& Latitude of the first point, in degrees.
+   * @param const Longitude_T& Longitude of the first point, in degrees.
+   * @param const Latitude_T& Latitude of the second point, in degrees.
+   * @param const Longitude_T& Longitude of the second point, in degrees.
+   * @return Distance_T Distance between the two points, in kilometers.
+   */
+  Distance_T calculateGreatCircleDistance (const Latitude_T&,
+                                           const Longitude_T&,
+                                           const Latitude_T&,
+                                           const Longitude_T&);
+
+  /**
+   * State whether the given string is made only of (non-null) ASCII
+   * characters, i.e., of bytes between 0x01 and 0x7F.
+   *
+   * The bytes are checked 16 at a time with SSE2 instructions, when
+   * available.
+   *
+   * @param const std::string& String to be checked.
+   * @return bool Whether the string is plain ASCII.
+   */
+  bool isPlainASCII (const std::string&);
+
+  /**
+   * Calculate the hash of the given content (e.g., the raw data string of
+   * a POR record), so as to detect the changes of that content.
+   *
+   * The hash (64-bit FNV-1a) does not depend on the platform, nor on the
+   * run, as it is stored within the Xapian index.
+   *
+   * @param const std::string& Content to be hashed.
+   * @return ContentHash_T Hexadecimal representation of the hash.
+   */
+  ContentHash_T calculateContentHash (const std::string&);
+
+  /**
+   * Build the unique ID of a POR record, from its primary key and
+   * envelope ID (e.g., NCE-CA-6299418-0).
+   *
+   * @param const std::string& Primary key (see LocationKey::toString()).
+   * @param const EnvelopeID_T& Envelope ID.
+   * @return std::string Unique ID of the POR record.
+   */
+  std::string buildPORUniqueID (const std::string&, const EnvelopeID_T&);
+
+  /**
+   * Split the unique ID of a POR record into its primary key and
+   * envelope ID (see buildPORUniqueID()).
+   *
+   * @param const std::string& Unique ID of the POR record.
+   * @param std::string& Primary key.
+   * @param EnvelopeID_T& Envelope ID.
+   */
+  void splitPORUniqueID (const std::string&, std::string&, EnvelopeID_T&);
+
   /**
    * Map for character strings
    */
@@ -14,6 +14,7 @@
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
 #include <opentrep/DBType.hpp>
+#include <opentrep/PORParserType.hpp>
 #include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
 #include <opentrep/basic/Utilities.hpp>
 #include <opentrep/config/opentrep-paths.hpp>
@@ -43,6 +44,53 @@ const std::string K_OPENTREP_DEFAULT_LOG_FILENAME ("opentrep-indexer.log");
  */
 const bool K_OPENTREP_DEFAULT_POR_INCLUDING = false;
 
+/**
+ * Default number of threads parsing the POR and building their Xapian
+ * terms (0 = as many as the hardware threads).
+ */
+const unsigned short K_OPENTREP_DEFAULT_NB_OF_THREADS = 0;
+
+/**
+ * Default number of shards of the Xapian index (1 = no sharding).
+ */
+const unsigned short K_OPENTREP_DEFAULT_NB_OF_SHARDS = 1;
+
+/**
+ * Default way to finish a sharded Xapian index:
+ *  <ul>
+ *    <li>0 = Merge (compact) the shards into a single Xapian database</li>
+ *    <li>1 = Keep the shards, referenced by a Xapian stub database</li>
+ *  </ul>
+ */
+const bool K_OPENTREP_DEFAULT_STUB_DB = false;
+
+/**
+ * Default way to index the POR:
+ *  <ul>
+ *    <li>0 = Rebuild the Xapian index and SQL database from scratch</li>
+ *    <li>1 = Update them incrementally, i.e., only with the POR records
+ *        added, changed or removed since the last indexing</li>
+ *  </ul>
+ */
+const bool K_OPENTREP_DEFAULT_INCREMENTAL_UPDATE = false;
+
+/**
+ * Default parser of the POR records:
+ *  <ul>
+ *    <li>spirit = Boost Spirit grammar</li>
+ *    <li>simd = Field splitter locating the separators with SSE2/AVX2
+ *        instructions</li>
+ *    <li>check = Both parsers, cross-checked on every POR record</li>
+ *  </ul>
+ */
+const std::string K_OPENTREP_DEFAULT_POR_PARSER ("spirit");
+
+/**
+ * Default file-path of the columnar export of all the POR, once indexed
+ * (empty = no export).
+ */
+const std::string K_OPENTREP_DEFAULT_COLUMNAR_FILEPATH ("");
+
 
 // ///////// Parsing of Options & Configuration /////////
 /** Early return status (so that it can be differentiated from an error). */
@@ -58,6 +106,12 @@ int readConfiguration (int argc, char* argv[],
                        bool& ioIncludeNonIATAPOR,
                        bool& ioIndexPORInXapian,
                        bool& ioAddPORInDB,
+                       unsigned short& ioNbOfThreads,
+                       unsigned short& ioNbOfShards,
+                       bool& ioUseStubDB,
+                       bool& ioUpdateIncrementally,
+                       std::string& ioPORParserTypeString,
+                       std::string& ioColumnarFilepath,
                        std::string& ioLogFilename,
                        std::ostringstream& oStr) {
 
@@ -96,6 +150,24 @@ int readConfiguration (int argc, char* argv[],
     ("dbadd,a",
      boost::program_options::value<bool>(&ioAddPORInDB)->default_value(OPENTREP::DEFAULT_OPENTREP_ADD_IN_DB),
      "Whether or not to add and index the POR in the SQL-based database (0 = do not touch the SQL-based database, 1 = add and re-index all the POR in the SQL-based database)")
+    ("threads,j",
+     boost::program_options::value<unsigned short>(&ioNbOfThreads)->default_value(K_OPENTREP_DEFAULT_NB_OF_THREADS),
+     "Number of threads parsing the POR and building their Xapian terms (0 = as many as the hardware threads)")
+    ("shards,k",
+     boost::program_options::value<unsigned short>(&ioNbOfShards)->default_value(K_OPENTREP_DEFAULT_NB_OF_SHARDS),
+     "Number of shards of the Xapian index, built at once from contiguous chunks of the POR file (1 = no sharding)")
+    ("stubdb,b",
+     boost::program_options::value<bool>(&ioUseStubDB)->default_value(K_OPENTREP_DEFAULT_STUB_DB),
+     "Whether or not to keep the shards of the Xapian index as they are (0 = merge the shards into a single Xapian database, 1 = reference the shards by a Xapian stub database)")
+    ("update,u",
+     boost::program_options::value<bool>(&ioUpdateIncrementally)->default_value(K_OPENTREP_DEFAULT_INCREMENTAL_UPDATE),
+     "Whether or not to update the Xapian index and SQL database incrementally (0 = rebuild them from scratch, 1 = only apply the POR records added, changed or removed since the last indexing)")
+    ("parser,r",
+     boost::program_options::value< std::string >(&ioPORParserTypeString)->default_value(K_OPENTREP_DEFAULT_POR_PARSER),
+     "Parser of the POR records (spirit for the Boost Spirit grammar, simd for the SSE2/AVX2 field splitter, check for both, cross-checked on every POR record)")
+    ("columnar,c",
+     boost::program_options::value< std::string >(&ioColumnarFilepath)->default_value(K_OPENTREP_DEFAULT_COLUMNAR_FILEPATH),
+     "File-path of the columnar export of all the POR, once indexed (e.g., /tmp/opentrep/optd_por.otrepcol; empty for no export)")
     ("log,l",
      boost::program_options::value< std::string >(&ioLogFilename)->default_value(K_OPENTREP_DEFAULT_LOG_FILENAME),
      "Filepath for the logs")
@@ -217,6 +289,35 @@ int readConfiguration (int argc, char* argv[],
   
   oStr << "Add and re-index the POR in the SQL-based database? " << ioAddPORInDB
        << std::endl;
+
+  oStr << "Number of indexing threads: " << ioNbOfThreads << std::endl;
+
+  // No shard at all makes no sense, and means no sharding
+  if (ioNbOfShards == 0) {
+    ioNbOfShards = 1;
+  }
+  oStr << "Number of shards of the Xapian index: " << ioNbOfShards
+       << std::endl;
+
+  oStr << "Keep the shards, referenced by a Xapian stub database? "
+       << ioUseStubDB << std::endl;
+
+  oStr << "Update the Xapian index and SQL database incrementally? "
+       << ioUpdateIncrementally << std::endl;
+
+  if (vm.count ("parser")) {
+    ioPORParserTypeString = vm["parser"].as< std::string >();
+    oStr << "Parser of the POR records: " << ioPORParserTypeString
+         << std::endl;
+  }
+
+  if (vm.count ("columnar")) {
+    ioColumnarFilepath = vm["columnar"].as< std::string >();
+    if (ioColumnarFilepath.empty() == false) {
+      oStr << "Columnar export file-path is: " << ioColumnarFilepath
+           << std::endl;
+    }
+  }
   
   if (vm.count ("log")) {
     ioLogFilename = vm["log"].as< std::string >();
@@ -257,6 +358,24 @@ int main (int argc, char* argv[]) {
   // Whether or not to insert the POR in the SQL database
   OPENTREP::shouldAddPORInSQLDB_T lShouldAddPORInSQLDB;
 
+  // Number of indexing threads
+  OPENTREP::NbOfThreads_T lNbOfThreads;
+
+  // Number of shards of the Xapian index
+  OPENTREP::NbOfShards_T lNbOfShards;
+
+  // Whether or not to reference the shards by a Xapian stub database
+  bool lUseStubDB;
+
+  // Whether or not to update the index incrementally
+  bool lUpdateIncrementally;
+
+  // Parser of the POR records
+  std::string lPORParserTypeStr;
+
+  // File-path of the columnar export of the POR (empty = no export)
+  std::string lColumnarFilepathStr;
+
   // Log stream for the introduction part
   std::ostringstream oIntroStr;
 
@@ -265,7 +384,9 @@ int main (int argc, char* argv[]) {
     readConfiguration (argc, argv, lPORFilepathStr, lXapianDBNameStr,
                        lSQLDBTypeStr, lSQLDBConnectionStr, lDeploymentNumber,
                        lIncludeNonIATAPOR, lShouldIndexPORInXapian,
-                       lShouldAddPORInSQLDB, lLogFilename, oIntroStr);
+                       lShouldAddPORInSQLDB, lNbOfThreads, lNbOfShards,
+                       lUseStubDB, lUpdateIncrementally, lPORParserTypeStr,
+                       lColumnarFilepathStr, lLogFilename, oIntroStr);
 
   if (lOptionParserStatus == K_OPENTREP_EARLY_RETURN_STATUS) {
     return 0;
@@ -304,13 +425,33 @@ int main (int argc, char* argv[]) {
                                               lShouldIndexPORInXapian,
                                               lShouldAddPORInSQLDB);
 
-  // Launch the indexation
-  const OPENTREP::NbOfDBEntries_T lNbOfEntries =
-    opentrepService.insertIntoDBAndXapian();
+  // Select the parser of the POR records
+  const OPENTREP::PORParserType lPORParserType (lPORParserTypeStr);
+  opentrepService.setPORParserType (lPORParserType);
 
-  //
+  // Launch the indexation
   std::ostringstream oStr;
-  oStr << lNbOfEntries << " entries have been processed" << std::endl;
+  if (lUpdateIncrementally == true) {
+    const OPENTREP::IndexUpdateReport& lIndexUpdateReport =
+      opentrepService.updateDBAndXapian();
+    oStr << lIndexUpdateReport.getNbOfPOR() << " entries have been processed: "
+         << lIndexUpdateReport.describe() << std::endl;
+
+  } else {
+    const OPENTREP::NbOfDBEntries_T lNbOfEntries =
+      opentrepService.insertIntoDBAndXapian (lNbOfThreads, lNbOfShards,
+                                             !lUseStubDB);
+    oStr << lNbOfEntries << " entries have been processed" << std::endl;
+  }
+
+  // Export all the POR into a columnar file, if required
+  if (lColumnarFilepathStr.empty() == false) {
+    const OPENTREP::FilePath_T lColumnarFilepath (lColumnarFilepathStr);
+    const OPENTREP::NbOfDBEntries_T lNbOfExportedEntries =
+      opentrepService.exportToColumnarFile (lColumnarFilepath, lNbOfThreads);
+    oStr << lNbOfExportedEntries << " entries have been exported into "
+         << lColumnarFilepathStr << std::endl;
+  }
   std::cout << oStr.str();
 
   // Get the current time in UTC Timezone
@@ -0,0 +1,398 @@
+// STL
+#include <cassert>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <deque>
+#include <string>
+#include <vector>
+// Boost (Extended STL)
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/program_options.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+// Boost Asio and Beast (HTTP)
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+// OpenTREP
+#include <opentrep/config/opentrep-paths.hpp>
+
+namespace beast = boost::beast;
+namespace http = boost::beast::http;
+namespace net = boost::asio;
+
+
+// //////// Type definitions ///////
+typedef net::ip::tcp tcp;
+typedef http::request<http::empty_body> HTTPRequest_T;
+typedef http::response<http::string_body> HTTPResponse_T;
+
+/**
+ * List of the request targets (e.g., /search?q=nce), sent in turn.
+ */
+typedef std::vector<std::string> TargetList_T;
+
+/**
+ * List of latencies, in microseconds.
+ */
+typedef std::vector<long> LatencyList_T;
+
+
+// //////// Constants //////
+/**
+ * Default address and port of the OpenTREP server (opentrep-server).
+ */
+const std::string K_OPENTREP_DEFAULT_SERVER_ADDRESS ("127.0.0.1");
+const std::string K_OPENTREP_DEFAULT_SERVER_PORT ("8080");
+
+/**
+ * Default number of connections, each one being handled by its own thread.
+ */
+const unsigned short K_OPENTREP_DEFAULT_NB_OF_CONNECTIONS = 8;
+
+/**
+ * Default number of requests sent on every connection.
+ */
+const unsigned int K_OPENTREP_DEFAULT_NB_OF_REQUESTS = 1000;
+
+/**
+ * Default number of requests sent in a row on a connection, without
+ * waiting for the responses (1 means no pipelining).
+ */
+const unsigned short K_OPENTREP_DEFAULT_PIPELINE_DEPTH = 1;
+
+/**
+ * Default request targets, mixing the endpoints of the server.
+ */
+const char* K_OPENTREP_DEFAULT_TARGETS[] = {
+  "/search?q=nce",
+  "/search?q=san+francisco&format=S",
+  "/search?q=rio+de+janeiro+los+angeles",
+  "/autocomplete?q=pari&limit=5",
+  "/autocomplete?q=frankf&limit=10",
+  "/code/iata/SFO",
+  "/code/icao/LFMN?format=S",
+  "/code/geonames/6299418",
+  "/random?n=3&format=C",
+};
+
+
+// ///////// Parsing of Options & Configuration /////////
+/** Early return status (so that it can be differentiated from an error). */
+const int K_OPENTREP_EARLY_RETURN_STATUS = 99;
+
+/** Read and parse the command line options. */
+int readConfiguration (int argc, char* argv[],
+                       std::string& ioServerAddress,
+                       std::string& ioServerPort,
+                       unsigned short& ioNbOfConnections,
+                       unsigned int& ioNbOfRequests,
+                       unsigned short& ioPipelineDepth,
+                       std::string& ioTargetFilename,
+                       std::ostringstream& oStr) {
+
+  // Declare a group of options that will be allowed only on command line
+  boost::program_options::options_description generic ("Generic options");
+  generic.add_options()
+    ("prefix", "print installation prefix")
+    ("version,v", "print version string")
+    ("help,h", "produce help message");
+
+  // Declare a group of options that will be allowed both on command
+  // line and in config file
+  boost::program_options::options_description config ("Configuration");
+  config.add_options()
+    ("address,a",
+     boost::program_options::value< std::string >(&ioServerAddress)->default_value(K_OPENTREP_DEFAULT_SERVER_ADDRESS),
+     "Address of the OpenTREP server")
+    ("port,p",
+     boost::program_options::value< std::string >(&ioServerPort)->default_value(K_OPENTREP_DEFAULT_SERVER_PORT),
+     "Port of the OpenTREP server")
+    ("connections,c",
+     boost::program_options::value< unsigned short >(&ioNbOfConnections)->default_value(K_OPENTREP_DEFAULT_NB_OF_CONNECTIONS),
+     "Number of (kept alive) connections, opened at once")
+    ("requests,r",
+     boost::program_options::value< unsigned int >(&ioNbOfRequests)->default_value(K_OPENTREP_DEFAULT_NB_OF_REQUESTS),
+     "Number of requests sent on every connection")
+    ("pipeline,q",
+     boost::program_options::value< unsigned short >(&ioPipelineDepth)->default_value(K_OPENTREP_DEFAULT_PIPELINE_DEPTH),
+     "Number of requests sent in a row, without waiting for the responses (1 means no pipelining)")
+    ("targets,t",
+     boost::program_options::value< std::string >(&ioTargetFilename),
+     "File of request targets, one per line (e.g., /search?q=nce); by default, a mix of all the endpoints")
+    ;
+
+  boost::program_options::options_description cmdline_options;
+  cmdline_options.add(generic).add(config);
+
+  boost::program_options::options_description visible ("Allowed options");
+  visible.add(generic).add(config);
+
+  boost::program_options::variables_map vm;
+  boost::program_options::
+    store (boost::program_options::command_line_parser (argc, argv).
+           options (cmdline_options).run(), vm);
+  boost::program_options::notify (vm);
+
+  if (vm.count ("help")) {
+    std::cout << visible << std::endl;
+    return K_OPENTREP_EARLY_RETURN_STATUS;
+  }
+
+  if (vm.count ("version")) {
+    std::cout << PACKAGE_NAME << ", version " << PACKAGE_VERSION << std::endl;
+    return K_OPENTREP_EARLY_RETURN_STATUS;
+  }
+
+  if (vm.count ("prefix")) {
+    std::cout << "Installation prefix: " << PREFIXDIR << std::endl;
+    return K_OPENTREP_EARLY_RETURN_STATUS;
+  }
+
+  if (ioNbOfConnections == 0 || ioPipelineDepth == 0) {
+    std::cerr << "Error - The numbers of connections and the pipeline "
+              << "depth must be positive" << std::endl;
+    return -1;
+  }
+
+  oStr << "OpenTREP server: " << ioServerAddress << ":" << ioServerPort
+       << std::endl;
+  oStr << "Number of connections: " << ioNbOfConnections << std::endl;
+  oStr << "Number of requests per connection: " << ioNbOfRequests
+       << std::endl;
+  oStr << "Pipeline depth: " << ioPipelineDepth << std::endl;
+
+  if (vm.count ("targets")) {
+    oStr << "Request target file: " << ioTargetFilename << std::endl;
+  }
+
+  return 0;
+}
+
+
+// ///////// Load generation /////////
+/**
+ * @brief Outcome of the requests sent by all the connections.
+ */
+struct LoadTestReport {
+  /**
+   * Constructor.
+   */
+  LoadTestReport() : _nbOfResponses (0), _nbOfErrorResponses (0),
+                     _nbOfFailedConnections (0) {
+  }
+
+  /**
+   * Add the outcome of a connection. That method may be called by several
+   * threads at once.
+   */
+  void add (const LatencyList_T& iLatencyList,
+            const unsigned int iNbOfErrorResponses,
+            const bool iHasFailed) {
+    boost::lock_guard<boost::mutex> lLock (_mutex);
+    _latencyList.insert (_latencyList.end(), iLatencyList.begin(),
+                         iLatencyList.end());
+    _nbOfResponses += iLatencyList.size();
+    _nbOfErrorResponses += iNbOfErrorResponses;
+    if (iHasFailed == true) {
+      ++_nbOfFailedConnections;
+    }
+  }
+
+  /**
+   * Latency, in microseconds, below which lies the given percentage
+   * of the responses.
+   */
+  long getPercentile (const double iPercentage) {
+    if (_latencyList.empty() == true) {
+      return 0;
+    }
+    std::sort (_latencyList.begin(), _latencyList.end());
+    const std::size_t lIndex =
+      static_cast<std::size_t> (iPercentage / 100.0
+                                * (_latencyList.size() - 1));
+    return _latencyList[lIndex];
+  }
+
+  boost::mutex _mutex;
+  LatencyList_T _latencyList;
+  unsigned long _nbOfResponses;
+  unsigned long _nbOfErrorResponses;
+  unsigned int _nbOfFailedConnections;
+};
+
+// //////////////////////////////////////////////////////////////////////
+void runConnection (const std::string& iServerAddress,
+                    const std::string& iServerPort,
+                    const TargetList_T& iTargetList,
+                    const unsigned int iNbOfRequests,
+                    const unsigned short iPipelineDepth,
+                    const unsigned int iFirstTarget,
+                    LoadTestReport& ioReport) {
+  LatencyList_T lLatencyList;
+  lLatencyList.reserve (iNbOfRequests);
+  unsigned int lNbOfErrorResponses = 0;
+  bool hasFailed = false;
+
+  try {
+    net::io_context lIOContext;
+    tcp::resolver lResolver (lIOContext);
+    beast::tcp_stream lStream (lIOContext);
+    lStream.connect (lResolver.resolve (iServerAddress, iServerPort));
+    lStream.socket().set_option (tcp::no_delay (true));
+
+    const std::string lHost = iServerAddress + ":" + iServerPort;
+    beast::flat_buffer lBuffer;
+
+    // Sending times of the requests still waiting for their responses
+    std::deque<boost::posix_time::ptime> lSendingTimeList;
+
+    unsigned int lNbOfSentRequests = 0;
+    unsigned int lNbOfReceivedResponses = 0;
+    while (lNbOfReceivedResponses != iNbOfRequests) {
+      // Send requests until the pipeline be full
+      while (lNbOfSentRequests != iNbOfRequests
+             && lSendingTimeList.size() < iPipelineDepth) {
+        const std::string& lTarget =
+          iTargetList[(iFirstTarget + lNbOfSentRequests) % iTargetList.size()];
+        HTTPRequest_T lRequest (http::verb::get, lTarget, 11);
+        lRequest.set (http::field::host, lHost);
+        lRequest.keep_alive (true);
+
+        lSendingTimeList.push_back (boost::posix_time::microsec_clock::
+                                    universal_time());
+        http::write (lStream, lRequest);
+        ++lNbOfSentRequests;
+      }
+
+      // Read the oldest pending response
+      HTTPResponse_T lResponse;
+      http::read (lStream, lBuffer, lResponse);
+      const boost::posix_time::time_duration lLatency =
+        boost::posix_time::microsec_clock::universal_time()
+        - lSendingTimeList.front();
+      lSendingTimeList.pop_front();
+      ++lNbOfReceivedResponses;
+
+      lLatencyList.push_back (lLatency.total_microseconds());
+      if (lResponse.result() != http::status::ok) {
+        ++lNbOfErrorResponses;
+      }
+    }
+
+    beast::error_code lErrorCode;
+    lStream.socket().shutdown (tcp::socket::shutdown_both, lErrorCode);
+
+  } catch (const std::exception& lException) {
+    std::cerr << "Error - " << lException.what() << std::endl;
+    hasFailed = true;
+  }
+
+  ioReport.add (lLatencyList, lNbOfErrorResponses, hasFailed);
+}
+
+
+// /////////////// M A I N /////////////////
+int main (int argc, char* argv[]) {
+
+  // Address and port of the OpenTREP server
+  std::string lServerAddress;
+  std::string lServerPort;
+
+  // Number of connections, and of requests per connection
+  unsigned short lNbOfConnections;
+  unsigned int lNbOfRequests;
+
+  // Number of requests sent in a row
+  unsigned short lPipelineDepth;
+
+  // File of request targets
+  std::string lTargetFilename;
+
+  // Log stream for the introduction part
+  std::ostringstream oIntroStr;
+
+  // Call the command-line option parser
+  const int lOptionParserStatus =
+    readConfiguration (argc, argv, lServerAddress, lServerPort,
+                       lNbOfConnections, lNbOfRequests, lPipelineDepth,
+                       lTargetFilename, oIntroStr);
+
+  if (lOptionParserStatus == K_OPENTREP_EARLY_RETURN_STATUS) {
+    return 0;
+  }
+  if (lOptionParserStatus != 0) {
+    return lOptionParserStatus;
+  }
+
+  // Request targets
+  TargetList_T lTargetList;
+  if (lTargetFilename.empty() == true) {
+    const std::size_t lNbOfTargets = sizeof (K_OPENTREP_DEFAULT_TARGETS)
+      / sizeof (K_OPENTREP_DEFAULT_TARGETS[0]);
+    lTargetList.assign (K_OPENTREP_DEFAULT_TARGETS,
+                        K_OPENTREP_DEFAULT_TARGETS + lNbOfTargets);
+
+  } else {
+    std::ifstream lTargetFile (lTargetFilename.c_str());
+    std::string lTarget;
+    while (std::getline (lTargetFile, lTarget)) {
+      if (lTarget.empty() == false) {
+        lTargetList.push_back (lTarget);
+      }
+    }
+  }
+  if (lTargetList.empty() == true) {
+    std::cerr << "Error - No request target could be read from '"
+              << lTargetFilename << "'" << std::endl;
+    return -1;
+  }
+
+  // Report the parameters
+  std::cout << oIntroStr.str();
+
+  // Every connection is handled by its own thread, starting with
+  // a different target, so that the endpoints be mixed at any time
+  LoadTestReport lReport;
+  const boost::posix_time::ptime lStartTime =
+    boost::posix_time::microsec_clock::universal_time();
+
+  boost::thread_group lThreadGroup;
+  for (unsigned short idx = 0; idx != lNbOfConnections; ++idx) {
+    lThreadGroup.create_thread (boost::bind (&runConnection,
+                                             boost::cref (lServerAddress),
+                                             boost::cref (lServerPort),
+                                             boost::cref (lTargetList),
+                                             lNbOfRequests, lPipelineDepth,
+                                             idx, boost::ref (lReport)));
+  }
+  lThreadGroup.join_all();
+
+  const boost::posix_time::time_duration lElapsed =
+    boost::posix_time::microsec_clock::universal_time() - lStartTime;
+  const double lElapsedSeconds = lElapsed.total_microseconds() / 1e6;
+  const double lThroughput = (lElapsedSeconds > 0.0) ?
+    lReport._nbOfResponses / lElapsedSeconds : 0.0;
+
+  std::cout << "Responses: " << lReport._nbOfResponses
+            << " (of which not OK: " << lReport._nbOfErrorResponses
+            << "), failed connections: " << lReport._nbOfFailedConnections
+            << std::endl;
+  std::cout << "Elapsed time: " << lElapsedSeconds << " s, throughput: "
+            << lThroughput << " requests/s" << std::endl;
+  std::cout << "Latency (in micro-seconds): p50=" << lReport.getPercentile (50)
+            << ", p90=" << lReport.getPercentile (90)
+            << ", p99=" << lReport.getPercentile (99)
+            << ", max=" << lReport.getPercentile (100) << std::endl;
+
+  if (lReport._nbOfFailedConnections != 0) {
+    return -1;
+  }
+
+  return 0;
+}
@@ -13,10 +13,15 @@
 // OpenTREP
 #include <opentrep/OPENTREP_Service.hpp>
 #include <opentrep/DBType.hpp>
+#include <opentrep/OutputFormat.hpp>
+#include <opentrep/DSVColumn.hpp>
 #include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
 #include <opentrep/basic/Utilities.hpp>
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
+#include <opentrep/bom/BomJSONExport.hpp>
+#include <opentrep/bom/BomDSVExport.hpp>
+#include <opentrep/bom/LocationExchange.hpp>
 #include <opentrep/config/opentrep-paths.hpp>
 
 
@@ -50,6 +55,16 @@ const unsigned short K_OPENTREP_DEFAULT_SEARCH_TYPE = 0;
  */
 const unsigned short K_OPENTREP_DEFAULT_SPELLING_ERROR_DISTANCE = 3;
 
+/**
+ * Default output format (see OPENTREP::OutputFormat), i.e., full text.
+ */
+const std::string K_OPENTREP_DEFAULT_OUTPUT_FORMAT ("F");
+
+/**
+ * Default columns for the CSV and TSV output formats, i.e., all of them.
+ */
+const std::string K_OPENTREP_DEFAULT_DSV_COLUMNS ("");
+
 
 // //////////////////////////////////////////////////////////////////////
 void tokeniseStringIntoWordList (const std::string& iPhrase,
@@ -111,6 +126,8 @@ int readConfiguration (int argc, char* argv[],
                        unsigned short& ioDeploymentNumber,
                        std::string& ioLogFilename,
                        unsigned short& ioSearchType,
+                       std::string& ioOutputFormatString,
+                       std::string& ioDSVColumnString,
                        std::ostringstream& oStr) {
 
   // Initialise the travel query string, if that one is empty
@@ -155,6 +172,13 @@ int readConfiguration (int argc, char* argv[],
     ("type,y",
      boost::program_options::value<unsigned short>(&ioSearchType)->default_value(K_OPENTREP_DEFAULT_SEARCH_TYPE), 
      "Type of search request (0 = full text, 1 = coordinates)")
+    ("format,f",
+     boost::program_options::value< std::string >(&ioOutputFormatString)->default_value(K_OPENTREP_DEFAULT_OUTPUT_FORMAT),
+     "Output format (F = full text, S = short, J = JSON, P = Protobuf, C = CSV, T = TSV)")
+    ("columns,c",
+     boost::program_options::value< std::string >(&ioDSVColumnString)->default_value(K_OPENTREP_DEFAULT_DSV_COLUMNS),
+     "Comma-separated list of the columns of the CSV and TSV output formats "
+     "(e.g., iata_code,lat,lon,matching_percentage); all of them by default")
     ("query,q",
      boost::program_options::value< WordList_T >(&lWordList)->multitoken(),
      "Travel query word list (e.g. sna francisco rio de janero los angeles reykyavki), "
@@ -258,6 +282,16 @@ int readConfiguration (int argc, char* argv[],
   }
 
   oStr << "The type of search is: " << ioSearchType << std::endl;
+
+  if (vm.count ("format")) {
+    ioOutputFormatString = vm["format"].as< std::string >();
+    oStr << "The output format is: " << ioOutputFormatString << std::endl;
+  }
+
+  if (vm.count ("columns")) {
+    ioDSVColumnString = vm["columns"].as< std::string >();
+    oStr << "The output columns are: " << ioDSVColumnString << std::endl;
+  }
   
   oStr << "The spelling error distance is: " << ioSpellingErrorDistance
             << std::endl;
@@ -272,7 +306,9 @@ int readConfiguration (int argc, char* argv[],
  * Helper function
  */
 std::string parseQuery (OPENTREP::OPENTREP_Service& ioOpentrepService,
-                        const OPENTREP::TravelQuery_T& iTravelQuery) {
+                        const OPENTREP::TravelQuery_T& iTravelQuery,
+                        const OPENTREP::OutputFormat::EN_OutputFormat& iFormat,
+                        const OPENTREP::DSVColumnList_T& iDSVColumnList) {
   std::ostringstream oStr;
 
   // Query the Xapian database (index)
@@ -282,6 +318,51 @@ std::string parseQuery (OPENTREP::OPENTREP_Service& ioOpentrepService,
     ioOpentrepService.interpretTravelRequest (iTravelQuery, lLocationList,
                                               lNonMatchedWordList);
 
+  // Machine-readable output formats
+  switch (iFormat) {
+  case OPENTREP::OutputFormat::SHORT: {
+    OPENTREP::NbOfMatches_T idx = 0;
+    for (OPENTREP::LocationList_T::const_iterator itLocation =
+           lLocationList.begin();
+         itLocation != lLocationList.end(); ++itLocation, ++idx) {
+      const OPENTREP::Location& lLocation = *itLocation;
+      if (idx != 0) {
+        oStr << ",";
+      }
+      oStr << lLocation.getIataCode() << "/" << lLocation.getPercentage();
+    }
+    oStr << std::endl;
+    return oStr.str();
+  }
+
+  case OPENTREP::OutputFormat::JSON: {
+    std::string oJSONString;
+    OPENTREP::BomJSONExport::jsonExportLocationList (oJSONString,
+                                                     lLocationList);
+    return oJSONString;
+  }
+
+  case OPENTREP::OutputFormat::PROTOBUF: {
+    return OPENTREP::LocationExchange::exportLocationList (lLocationList,
+                                                           lNonMatchedWordList);
+  }
+
+  case OPENTREP::OutputFormat::CSV:
+  case OPENTREP::OutputFormat::TSV: {
+    // The lines are written directly into the returned string
+    std::string oDSVString;
+    const char lDelimiter = OPENTREP::BomDSVExport::getDelimiter (iFormat);
+    OPENTREP::BomDSVExport::dsvExportLocationList (oDSVString, lLocationList,
+                                                   iDSVColumnList, lDelimiter,
+                                                   true);
+    return oDSVString;
+  }
+
+  default:
+    break;
+  }
+
+  // Full (human-readable) output format
   oStr << nbOfMatches << " (geographical) location(s) have been found "
        << "matching your query (`" << iTravelQuery << "'). "
        << lNonMatchedWordList.size() << " word(s) was/were left unmatched."
@@ -338,6 +419,10 @@ int main (int argc, char* argv[]) {
 
   // Deployment number/version
   OPENTREP::DeploymentNumber_T lDeploymentNumber;
+
+  // Output format, and columns of the CSV and TSV output formats
+  std::string lOutputFormatStr;
+  std::string lDSVColumnStr;
   
   // Log stream for the introduction part
   std::ostringstream oIntroStr;
@@ -346,11 +431,32 @@ int main (int argc, char* argv[]) {
   const int lOptionParserStatus = 
     readConfiguration (argc, argv, lSpellingErrorDistance, lTravelQuery,
                        lXapianDBNameStr, lSQLDBTypeStr, lSQLDBConnectionStr,
-                       lDeploymentNumber, lLogFilename, lSearchType, oIntroStr);
+                       lDeploymentNumber, lLogFilename, lSearchType,
+                       lOutputFormatStr, lDSVColumnStr, oIntroStr);
 
   if (lOptionParserStatus == K_OPENTREP_EARLY_RETURN_STATUS) {
     return 0;
   }
+
+  // Parse the output format and the columns
+  OPENTREP::OutputFormat::EN_OutputFormat lOutputFormat;
+  OPENTREP::DSVColumnList_T lDSVColumnList;
+  try {
+    const char lOutputFormatChar =
+      (lOutputFormatStr.size() == 1) ? lOutputFormatStr[0] : '\0';
+    lOutputFormat = OPENTREP::OutputFormat::getFormat (lOutputFormatChar);
+    lDSVColumnList = OPENTREP::DSVColumn::parseColumnList (lDSVColumnStr);
+
+  } catch (const OPENTREP::CodeConversionException& lException) {
+    std::cerr << "Error - " << lException.what() << std::endl;
+    return -1;
+  }
+
+  // With the full output format, the results are meant to be read
+  // by a human being: the parameters are reported first. Otherwise,
+  // only the results are written on the standard output.
+  const bool isHumanReadable =
+    (lOutputFormat == OPENTREP::OutputFormat::FULL);
     
   // Set the log parameters
   std::ofstream logOutputFile;
@@ -359,7 +465,9 @@ int main (int argc, char* argv[]) {
   logOutputFile.clear();
 
   // Report the parameters
-  std::cout << oIntroStr.str();
+  if (isHumanReadable == true) {
+    std::cout << oIntroStr.str();
+  }
 
   // DEBUG
   // Get the current time in UTC Timezone
@@ -370,7 +478,7 @@ int main (int argc, char* argv[]) {
                 <<  oIntroStr.str() << std::endl;
 
   //
-  std::ostringstream oStr;
+  std::string lOutput;
   if (lSearchType == 0) {
     // Initialise the context
     const OPENTREP::TravelDBFilePath_T lXapianDBName (lXapianDBNameStr);
@@ -403,21 +511,23 @@ int main (int argc, char* argv[]) {
     }
     
     // Parse the query and retrieve the places from Xapian only
-    const std::string& lOutput = parseQuery (opentrepService, lTravelQuery);
-    oStr << lOutput;
+    lOutput = parseQuery (opentrepService, lTravelQuery, lOutputFormat,
+                          lDSVColumnList);
 
   } else {
+    std::ostringstream oStr;
     oStr << "Finding the airports closest to: " << lTravelQuery << std::endl;
+    lOutput = oStr.str();
   }
   
   //  
-  std::cout << oStr.str();
+  std::cout.write (lOutput.data(), lOutput.size());
 
   // Get the current time in UTC Timezone
   lTimeUTC = boost::posix_time::second_clock::universal_time();
   logOutputFile << "[" << lTimeUTC << "][" << __FILE__ << "#"
                 << __LINE__ << "]:Results:" << std::endl
-                <<  oStr.str() << std::endl;
+                <<  lOutput << std::endl;
 
   // Close the Log outputFile
   logOutputFile.close();
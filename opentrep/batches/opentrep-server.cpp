@@ -0,0 +1,1071 @@
+// STL
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+// Boost (Extended STL)
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/program_options.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/thread/thread.hpp>
+// Boost Asio and Beast (HTTP)
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+// OpenTREP
+#include <opentrep/OPENTREP_exceptions.hpp>
+#include <opentrep/OPENTREP_Service.hpp>
+#include <opentrep/DBType.hpp>
+#include <opentrep/OutputFormat.hpp>
+#include <opentrep/DSVColumn.hpp>
+#include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
+#include <opentrep/basic/Utilities.hpp>
+#include <opentrep/Location.hpp>
+#include <opentrep/CityDetails.hpp>
+#include <opentrep/bom/BomJSONExport.hpp>
+#include <opentrep/bom/BomDSVExport.hpp>
+#include <opentrep/bom/LocationExchange.hpp>
+#include <opentrep/service/Logger.hpp>
+#include <opentrep/config/opentrep-paths.hpp>
+
+namespace beast = boost::beast;
+namespace http = boost::beast::http;
+namespace net = boost::asio;
+
+
+// //////// Type definitions ///////
+typedef net::ip::tcp tcp;
+typedef http::request<http::string_body> HTTPRequest_T;
+typedef http::response<http::string_body> HTTPResponse_T;
+
+/**
+ * Parameters of the query string of a request (e.g., q=nce and format=J).
+ */
+typedef std::map<std::string, std::string> RequestParameterMap_T;
+
+/**
+ * Segments of the path of a request (e.g., code, iata and NCE).
+ */
+typedef std::vector<std::string> RequestPath_T;
+
+
+// //////// Constants //////
+/**
+ * Default name and location for the log file.
+ */
+const std::string K_OPENTREP_DEFAULT_LOG_FILENAME ("opentrep-server.log");
+
+/**
+ * Default address on which the server listens.
+ */
+const std::string K_OPENTREP_DEFAULT_SERVER_ADDRESS ("127.0.0.1");
+
+/**
+ * Default port on which the server listens.
+ */
+const unsigned short K_OPENTREP_DEFAULT_SERVER_PORT = 8080;
+
+/**
+ * Default number of worker threads (0 means the number of hardware threads).
+ */
+const unsigned short K_OPENTREP_DEFAULT_NB_OF_THREADS = 0;
+
+/**
+ * Default output format (see OPENTREP::OutputFormat), i.e., JSON.
+ */
+const std::string K_OPENTREP_DEFAULT_OUTPUT_FORMAT ("J");
+
+/**
+ * Time, in seconds, after which an idle (kept alive) connection is closed.
+ */
+const unsigned int K_OPENTREP_DEFAULT_IDLE_TIMEOUT = 30;
+
+/**
+ * Default and maximal numbers of POR given by the auto-completion.
+ */
+const OPENTREP::NbOfMatches_T K_OPENTREP_DEFAULT_AUTOCOMPLETE_LIMIT = 10;
+const OPENTREP::NbOfMatches_T K_OPENTREP_MAX_AUTOCOMPLETE_LIMIT = 100;
+
+/**
+ * Default and maximal numbers of POR drawn at random.
+ */
+const OPENTREP::NbOfMatches_T K_OPENTREP_DEFAULT_NB_OF_DRAWS = 1;
+const OPENTREP::NbOfMatches_T K_OPENTREP_MAX_NB_OF_DRAWS = 1000;
+
+
+// ///////// Parsing of Options & Configuration /////////
+/** Early return status (so that it can be differentiated from an error). */
+const int K_OPENTREP_EARLY_RETURN_STATUS = 99;
+
+/** Read and parse the command line options. */
+int readConfiguration (int argc, char* argv[],
+                       std::string& ioServerAddress,
+                       unsigned short& ioServerPort,
+                       unsigned short& ioNbOfThreads,
+                       std::string& ioXapianDBFilepath,
+                       std::string& ioSQLDBTypeString,
+                       std::string& ioSQLDBConnectionString,
+                       unsigned short& ioDeploymentNumber,
+                       unsigned int& ioHotSwapPollingPeriod,
+                       std::string& ioLogFilename,
+                       std::string& ioOutputFormatString,
+                       std::ostringstream& oStr) {
+
+  // Declare a group of options that will be allowed only on command line
+  boost::program_options::options_description generic ("Generic options");
+  generic.add_options()
+    ("prefix", "print installation prefix")
+    ("version,v", "print version string")
+    ("help,h", "produce help message");
+
+  // Declare a group of options that will be allowed both on command
+  // line and in config file
+  boost::program_options::options_description config ("Configuration");
+  config.add_options()
+    ("address,a",
+     boost::program_options::value< std::string >(&ioServerAddress)->default_value(K_OPENTREP_DEFAULT_SERVER_ADDRESS),
+     "Address on which the server listens (e.g., 127.0.0.1, or 0.0.0.0 for all the interfaces)")
+    ("port,p",
+     boost::program_options::value< unsigned short >(&ioServerPort)->default_value(K_OPENTREP_DEFAULT_SERVER_PORT),
+     "Port on which the server listens (e.g., 8080)")
+    ("threads,n",
+     boost::program_options::value< unsigned short >(&ioNbOfThreads)->default_value(K_OPENTREP_DEFAULT_NB_OF_THREADS),
+     "Number of worker threads, serving the requests (0 means the number of hardware threads)")
+    ("xapiandb,d",
+     boost::program_options::value< std::string >(&ioXapianDBFilepath)->default_value(OPENTREP::DEFAULT_OPENTREP_XAPIAN_DB_FILEPATH),
+     "Xapian database filepath (e.g., /tmp/opentrep/xapian_traveldb)")
+    ("sqldbtype,t",
+     boost::program_options::value< std::string >(&ioSQLDBTypeString)->default_value(OPENTREP::DEFAULT_OPENTREP_SQL_DB_TYPE),
+     "SQL database type (e.g., nodb for no SQL database, sqlite for SQLite, mysql for MariaDB/MySQL)")
+    ("sqldbconx,s",
+     boost::program_options::value< std::string >(&ioSQLDBConnectionString),
+     "SQL database connection string (e.g., ~/tmp/opentrep/sqlite_travel.db for SQLite, "
+     "\"db=trep_trep user=trep password=trep\" for MariaDB/MySQL)")
+    ("deploymentnb,m",
+     boost::program_options::value<unsigned short>(&ioDeploymentNumber)->default_value(OPENTREP::DEFAULT_OPENTREP_DEPLOYMENT_NUMBER),
+     "Deployment number (from to N, where N=1 normally)")
+    ("hotswap,w",
+     boost::program_options::value<unsigned int>(&ioHotSwapPollingPeriod)->default_value(OPENTREP::DEFAULT_OPENTREP_HOT_SWAP_POLLING_PERIOD),
+     "Period, in milliseconds, with which the other deployment is checked, so as to hot-swap to it once it is ready (0 means never)")
+    ("log,l",
+     boost::program_options::value< std::string >(&ioLogFilename)->default_value(K_OPENTREP_DEFAULT_LOG_FILENAME),
+     "Filepath for the logs")
+    ("format,f",
+     boost::program_options::value< std::string >(&ioOutputFormatString)->default_value(K_OPENTREP_DEFAULT_OUTPUT_FORMAT),
+     "Default output format, when none is given by the requests (F = full text, S = short, J = JSON, P = Protobuf, C = CSV, T = TSV)")
+    ;
+
+  // Hidden options, will be allowed both on command line and
+  // in config file, but will not be shown to the user.
+  boost::program_options::options_description hidden ("Hidden options");
+  hidden.add_options()
+    ("copyright",
+     boost::program_options::value< std::vector<std::string> >(),
+     "Show the copyright (license)");
+
+  boost::program_options::options_description cmdline_options;
+  cmdline_options.add(generic).add(config).add(hidden);
+
+  boost::program_options::options_description config_file_options;
+  config_file_options.add(config).add(hidden);
+
+  boost::program_options::options_description visible ("Allowed options");
+  visible.add(generic).add(config);
+
+  boost::program_options::positional_options_description p;
+  p.add ("copyright", -1);
+
+  boost::program_options::variables_map vm;
+  boost::program_options::
+    store (boost::program_options::command_line_parser (argc, argv).
+           options (cmdline_options).positional(p).run(), vm);
+
+  std::ifstream ifs ("opentrep-server.cfg");
+  boost::program_options::store (parse_config_file (ifs, config_file_options),
+                                 vm);
+  boost::program_options::notify (vm);
+
+  if (vm.count ("help")) {
+    std::cout << visible << std::endl;
+    return K_OPENTREP_EARLY_RETURN_STATUS;
+  }
+
+  if (vm.count ("version")) {
+    std::cout << PACKAGE_NAME << ", version " << PACKAGE_VERSION << std::endl;
+    return K_OPENTREP_EARLY_RETURN_STATUS;
+  }
+
+  if (vm.count ("prefix")) {
+    std::cout << "Installation prefix: " << PREFIXDIR << std::endl;
+    return K_OPENTREP_EARLY_RETURN_STATUS;
+  }
+
+  oStr << "The server listens on: " << ioServerAddress << ":" << ioServerPort
+       << std::endl;
+  oStr << "Number of worker threads: " << ioNbOfThreads << std::endl;
+
+  if (vm.count ("deploymentnb")) {
+    ioDeploymentNumber = vm["deploymentnb"].as< unsigned short >();
+    oStr << "Deployment number: " << ioDeploymentNumber << std::endl;
+  }
+
+  if (vm.count ("xapiandb")) {
+    ioXapianDBFilepath = vm["xapiandb"].as< std::string >();
+    oStr << "Xapian database filepath is: " << ioXapianDBFilepath
+         << ioDeploymentNumber << std::endl;
+  }
+
+  if (vm.count ("sqldbtype")) {
+    ioSQLDBTypeString = vm["sqldbtype"].as< std::string >();
+    oStr << "SQL database type is: " << ioSQLDBTypeString << std::endl;
+  }
+
+  // Derive the detault connection string depending on the SQL database type
+  const OPENTREP::DBType lDBType (ioSQLDBTypeString);
+  if (lDBType == OPENTREP::DBType::NODB) {
+    ioSQLDBConnectionString = "";
+
+  } else if (lDBType == OPENTREP::DBType::SQLITE3) {
+    ioSQLDBConnectionString = OPENTREP::DEFAULT_OPENTREP_SQLITE_DB_FILEPATH;
+
+  } else if (lDBType == OPENTREP::DBType::MYSQL) {
+    ioSQLDBConnectionString = OPENTREP::DEFAULT_OPENTREP_MYSQL_CONN_STRING;
+  }
+
+  // Set the SQL database connection string, if any is given
+  if (vm.count ("sqldbconx")) {
+    ioSQLDBConnectionString = vm["sqldbconx"].as< std::string >();
+  }
+
+  // Reporting of the SQL database connection string
+  if (lDBType == OPENTREP::DBType::SQLITE3
+      || lDBType == OPENTREP::DBType::MYSQL) {
+    const std::string& lSQLDBConnString =
+      OPENTREP::parseAndDisplayConnectionString (lDBType,
+                                                 ioSQLDBConnectionString,
+                                                 ioDeploymentNumber);
+    //
+    oStr << "SQL database connection string is: " << lSQLDBConnString
+         << std::endl;
+  }
+
+  oStr << "Hot-swap polling period (in ms): " << ioHotSwapPollingPeriod
+       << std::endl;
+
+  if (vm.count ("log")) {
+    ioLogFilename = vm["log"].as< std::string >();
+    oStr << "Log filename is: " << ioLogFilename << std::endl;
+  }
+
+  if (vm.count ("format")) {
+    ioOutputFormatString = vm["format"].as< std::string >();
+    oStr << "The default output format is: " << ioOutputFormatString
+         << std::endl;
+  }
+
+  return 0;
+}
+
+
+// ///////// Parsing of the requests /////////
+// //////////////////////////////////////////////////////////////////////
+std::string decodeURLComponent (const beast::string_view& iComponent) {
+  std::string oDecodedString;
+  oDecodedString.reserve (iComponent.size());
+
+  for (std::size_t idx = 0; idx != iComponent.size(); ++idx) {
+    const char lChar = iComponent[idx];
+
+    // Within the query string, the spaces may be given as plus signs
+    if (lChar == '+') {
+      oDecodedString.push_back (' ');
+      continue;
+    }
+
+    // Percent-encoded byte (e.g., %20 for a space). An invalid sequence
+    // is kept as is.
+    if (lChar == '%' && idx + 2 < iComponent.size()
+        && std::isxdigit (static_cast<unsigned char> (iComponent[idx+1]))
+        && std::isxdigit (static_cast<unsigned char> (iComponent[idx+2]))) {
+      const std::string lHexDigits (iComponent.data() + idx + 1, 2);
+      const char lByte =
+        static_cast<char> (std::strtol (lHexDigits.c_str(), NULL, 16));
+      oDecodedString.push_back (lByte);
+      idx += 2;
+      continue;
+    }
+
+    oDecodedString.push_back (lChar);
+  }
+
+  return oDecodedString;
+}
+
+// //////////////////////////////////////////////////////////////////////
+void parseRequestTarget (const beast::string_view& iTarget,
+                         RequestPath_T& ioPath,
+                         RequestParameterMap_T& ioParameterMap) {
+  // For instance, "/code/iata/NCE?format=J" gives the code, iata and NCE
+  // segments, and the format parameter
+  const std::size_t lQueryPos = iTarget.find ('?');
+  const beast::string_view lPath = iTarget.substr (0, lQueryPos);
+  const beast::string_view lQuery =
+    (lQueryPos == beast::string_view::npos) ? beast::string_view()
+    : iTarget.substr (lQueryPos + 1);
+
+  std::size_t lSegmentPos = 0;
+  while (lSegmentPos < lPath.size()) {
+    std::size_t lSlashPos = lPath.find ('/', lSegmentPos);
+    if (lSlashPos == beast::string_view::npos) {
+      lSlashPos = lPath.size();
+    }
+    if (lSlashPos != lSegmentPos) {
+      ioPath.push_back (decodeURLComponent (lPath.substr (lSegmentPos,
+                                                          lSlashPos
+                                                          - lSegmentPos)));
+    }
+    lSegmentPos = lSlashPos + 1;
+  }
+
+  std::size_t lParameterPos = 0;
+  while (lParameterPos < lQuery.size()) {
+    std::size_t lAmpersandPos = lQuery.find ('&', lParameterPos);
+    if (lAmpersandPos == beast::string_view::npos) {
+      lAmpersandPos = lQuery.size();
+    }
+    const beast::string_view lParameter =
+      lQuery.substr (lParameterPos, lAmpersandPos - lParameterPos);
+    const std::size_t lEqualPos = lParameter.find ('=');
+    if (lParameter.empty() == false) {
+      const std::string& lName =
+        decodeURLComponent (lParameter.substr (0, lEqualPos));
+      const std::string& lValue = (lEqualPos == beast::string_view::npos) ?
+        std::string() : decodeURLComponent (lParameter.substr (lEqualPos + 1));
+      ioParameterMap[lName] = lValue;
+    }
+    lParameterPos = lAmpersandPos + 1;
+  }
+}
+
+// //////////////////////////////////////////////////////////////////////
+std::string getParameter (const RequestParameterMap_T& iParameterMap,
+                          const std::string& iName,
+                          const std::string& iDefaultValue) {
+  RequestParameterMap_T::const_iterator itParameter =
+    iParameterMap.find (iName);
+  if (itParameter == iParameterMap.end()) {
+    return iDefaultValue;
+  }
+  return itParameter->second;
+}
+
+/**
+ * @brief Exception thrown when a request is not valid (e.g., unknown
+ *        output format, missing travel query), giving a 400 status.
+ */
+class BadRequestException : public OPENTREP::RootException {
+public:
+  BadRequestException (const std::string& iWhat)
+    : OPENTREP::RootException (iWhat) {}
+};
+
+/**
+ * @brief Exception thrown when a resource does not exist (e.g., unknown
+ *        endpoint, no POR for the given code), giving a 404 status.
+ */
+class NotFoundException : public OPENTREP::RootException {
+public:
+  NotFoundException (const std::string& iWhat)
+    : OPENTREP::RootException (iWhat) {}
+};
+
+// //////////////////////////////////////////////////////////////////////
+OPENTREP::NbOfMatches_T
+getNumberParameter (const RequestParameterMap_T& iParameterMap,
+                    const std::string& iName,
+                    const OPENTREP::NbOfMatches_T& iDefaultValue,
+                    const OPENTREP::NbOfMatches_T& iMaxValue) {
+  RequestParameterMap_T::const_iterator itParameter =
+    iParameterMap.find (iName);
+  if (itParameter == iParameterMap.end()) {
+    return iDefaultValue;
+  }
+
+  const std::string& lValueStr = itParameter->second;
+  unsigned int lValue = 0;
+  try {
+    lValue = boost::lexical_cast<unsigned int> (lValueStr);
+
+  } catch (const boost::bad_lexical_cast&) {
+    throw BadRequestException ("The '" + iName + "' parameter ('" + lValueStr
+                               + "') is not a number");
+  }
+
+  if (lValue == 0 || lValue > iMaxValue) {
+    std::ostringstream oMessage;
+    oMessage << "The '" << iName << "' parameter must be between 1 and "
+             << iMaxValue;
+    throw BadRequestException (oMessage.str());
+  }
+  return static_cast<OPENTREP::NbOfMatches_T> (lValue);
+}
+
+
+// ///////// Handling of the requests /////////
+/**
+ * @brief Handler of the HTTP requests, shared by all the worker threads.
+ *
+ * The endpoints are:
+ * <ul>
+ *   <li>/search?q=<travel query>: full-text search;</li>
+ *   <li>/autocomplete?q=<partial travel query>&limit=<n>: full-text
+ *       search, giving at most the given number of POR;</li>
+ *   <li>/code/<type>/<code>: POR having the given code, the type being
+ *       one of iata, icao, faa, unlocode, uic and geonames;</li>
+ *   <li>/random?n=<n>: POR drawn at random.</li>
+ * </ul>
+ * All of them accept the format (e.g., format=J) and, for the CSV and TSV
+ * output formats, columns (e.g., columns=iata_code,lat,lon) parameters.
+ */
+class RequestHandler {
+public:
+  /**
+   * Constructor.
+   */
+  RequestHandler (OPENTREP::OPENTREP_Service& ioOpentrepService,
+                  const std::string& iDefaultOutputFormat)
+    : _opentrepService (ioOpentrepService),
+      _defaultOutputFormat (iDefaultOutputFormat) {
+  }
+
+  /**
+   * Build the response to the given request. That method may be called
+   * by several threads at once: every search of the shared OpenTREP
+   * service leases its own Xapian database and SQL session (see
+   * OPENTREP_Service::startIndexHotSwap()), and owns the BOM objects it
+   * creates, which are freed once the search is over. Hence, the memory
+   * of the server does not grow with the number of served requests.
+   */
+  void handle (const HTTPRequest_T& iRequest, HTTPResponse_T& ioResponse) {
+    try {
+      if (iRequest.method() != http::verb::get) {
+        ioResponse.result (http::status::method_not_allowed);
+        ioResponse.set (http::field::allow, "GET");
+        setTextBody (ioResponse, "Only the GET method is supported\n");
+        return;
+      }
+
+      RequestPath_T lPath;
+      RequestParameterMap_T lParameterMap;
+      parseRequestTarget (iRequest.target(), lPath, lParameterMap);
+
+      // Output format, and columns of the CSV and TSV output formats
+      const std::string lFormatStr =
+        getParameter (lParameterMap, "format", _defaultOutputFormat);
+      const char lFormatChar = (lFormatStr.size() == 1) ? lFormatStr[0] : '\0';
+      const OPENTREP::OutputFormat::EN_OutputFormat lOutputFormat =
+        OPENTREP::OutputFormat::getFormat (lFormatChar);
+      const OPENTREP::DSVColumnList_T& lDSVColumnList =
+        OPENTREP::DSVColumn::parseColumnList (getParameter (lParameterMap,
+                                                            "columns", ""));
+
+      OPENTREP::LocationList_T lLocationList;
+      OPENTREP::WordList_T lNonMatchedWordList;
+      const std::string lEndpoint = lPath.empty() ? "" : lPath.front();
+      if (lEndpoint == "search" && lPath.size() == 1) {
+        search (lParameterMap, lLocationList, lNonMatchedWordList);
+
+      } else if (lEndpoint == "autocomplete" && lPath.size() == 1) {
+        autocomplete (lParameterMap, lLocationList, lNonMatchedWordList);
+
+      } else if (lEndpoint == "code" && lPath.size() == 3) {
+        listByCode (lPath[1], lPath[2], lLocationList);
+
+      } else if (lEndpoint == "random" && lPath.size() == 1) {
+        drawRandomLocations (lParameterMap, lLocationList);
+
+      } else {
+        throw NotFoundException ("Unknown endpoint. Known endpoints: /search, "
+                                 "/autocomplete, /code/{type}/{code} "
+                                 "and /random");
+      }
+
+      ioResponse.result (http::status::ok);
+      exportLocationList (lOutputFormat, lLocationList, lNonMatchedWordList,
+                          lDSVColumnList, ioResponse);
+
+    } catch (const OPENTREP::CodeConversionException& lException) {
+      // Unknown output format or column
+      ioResponse.result (http::status::bad_request);
+      setTextBody (ioResponse, std::string (lException.what()) + "\n");
+
+    } catch (const BadRequestException& lException) {
+      ioResponse.result (http::status::bad_request);
+      setTextBody (ioResponse, std::string (lException.what()) + "\n");
+
+    } catch (const NotFoundException& lException) {
+      ioResponse.result (http::status::not_found);
+      setTextBody (ioResponse, std::string (lException.what()) + "\n");
+
+    } catch (const OPENTREP::RootException& lException) {
+      OPENTREP_LOG_ERROR ("Error when serving '" << iRequest.target()
+                          << "': " << lException.what());
+      ioResponse.result (http::status::internal_server_error);
+      setTextBody (ioResponse, std::string (lException.what()) + "\n");
+
+    } catch (const std::exception& lException) {
+      OPENTREP_LOG_ERROR ("Error when serving '" << iRequest.target()
+                          << "': " << lException.what());
+      ioResponse.result (http::status::internal_server_error);
+      setTextBody (ioResponse, std::string (lException.what()) + "\n");
+    }
+  }
+
+private:
+  /**
+   * Full-text search of the travel query (q parameter).
+   */
+  void search (const RequestParameterMap_T& iParameterMap,
+               OPENTREP::LocationList_T& ioLocationList,
+               OPENTREP::WordList_T& ioNonMatchedWordList) {
+    const std::string lTravelQuery = getParameter (iParameterMap, "q", "");
+    if (lTravelQuery.empty() == true) {
+      throw BadRequestException ("The travel query (q parameter) is missing");
+    }
+
+    _opentrepService.interpretTravelRequest (lTravelQuery, ioLocationList,
+                                             ioNonMatchedWordList);
+  }
+
+  /**
+   * Auto-completion of the (partial) travel query (q parameter). As the
+   * full-text search tolerates spelling errors, a partially typed name
+   * usually already matches; only the first (limit parameter) POR are
+   * kept.
+   */
+  void autocomplete (const RequestParameterMap_T& iParameterMap,
+                     OPENTREP::LocationList_T& ioLocationList,
+                     OPENTREP::WordList_T& ioNonMatchedWordList) {
+    const OPENTREP::NbOfMatches_T lLimit =
+      getNumberParameter (iParameterMap, "limit",
+                          K_OPENTREP_DEFAULT_AUTOCOMPLETE_LIMIT,
+                          K_OPENTREP_MAX_AUTOCOMPLETE_LIMIT);
+
+    search (iParameterMap, ioLocationList, ioNonMatchedWordList);
+    if (ioLocationList.size() > lLimit) {
+      ioLocationList.resize (lLimit);
+    }
+  }
+
+  /**
+   * POR having the given code (e.g., iata and NCE).
+   */
+  void listByCode (const std::string& iCodeType, const std::string& iCode,
+                   OPENTREP::LocationList_T& ioLocationList) {
+    const std::string& lCode = boost::algorithm::to_upper_copy (iCode);
+    OPENTREP::NbOfMatches_T lNbOfMatches = 0;
+
+    if (iCodeType == "iata") {
+      const OPENTREP::IATACode_T lIataCode (lCode);
+      lNbOfMatches = _opentrepService.listByIataCode (lIataCode,
+                                                      ioLocationList);
+
+    } else if (iCodeType == "icao") {
+      const OPENTREP::ICAOCode_T lIcaoCode (lCode);
+      lNbOfMatches = _opentrepService.listByIcaoCode (lIcaoCode,
+                                                      ioLocationList);
+
+    } else if (iCodeType == "faa") {
+      const OPENTREP::FAACode_T lFaaCode (lCode);
+      lNbOfMatches = _opentrepService.listByFaaCode (lFaaCode,
+                                                     ioLocationList);
+
+    } else if (iCodeType == "unlocode") {
+      const OPENTREP::UNLOCode_T lUNLOCode (lCode);
+      lNbOfMatches = _opentrepService.listByUNLOCode (lUNLOCode,
+                                                      ioLocationList);
+
+    } else if (iCodeType == "uic" || iCodeType == "geonames") {
+      unsigned int lNumericCode = 0;
+      try {
+        lNumericCode = boost::lexical_cast<unsigned int> (iCode);
+
+      } catch (const boost::bad_lexical_cast&) {
+        throw BadRequestException ("The " + iCodeType + " code ('" + iCode
+                                   + "') is not a number");
+      }
+
+      if (iCodeType == "uic") {
+        const OPENTREP::UICCode_T lUICCode (lNumericCode);
+        lNbOfMatches = _opentrepService.listByUICCode (lUICCode,
+                                                       ioLocationList);
+      } else {
+        const OPENTREP::GeonamesID_T lGeonameID (lNumericCode);
+        lNbOfMatches = _opentrepService.listByGeonameID (lGeonameID,
+                                                         ioLocationList);
+      }
+
+    } else {
+      throw NotFoundException ("Unknown code type ('" + iCodeType + "'). "
+                               "Known code types: iata, icao, faa, "
+                               "unlocode, uic and geonames");
+    }
+
+    if (lNbOfMatches == 0) {
+      throw NotFoundException ("No POR has the " + iCodeType + " code '"
+                               + iCode + "'");
+    }
+  }
+
+  /**
+   * POR drawn at random (n parameter).
+   */
+  void drawRandomLocations (const RequestParameterMap_T& iParameterMap,
+                            OPENTREP::LocationList_T& ioLocationList) {
+    const OPENTREP::NbOfMatches_T lNbOfDraws =
+      getNumberParameter (iParameterMap, "n", K_OPENTREP_DEFAULT_NB_OF_DRAWS,
+                          K_OPENTREP_MAX_NB_OF_DRAWS);
+    _opentrepService.drawRandomLocations (lNbOfDraws, ioLocationList);
+  }
+
+  /**
+   * Export the list of Location objects, in the given output format,
+   * as the body of the response.
+   */
+  static void
+  exportLocationList (const OPENTREP::OutputFormat::EN_OutputFormat& iFormat,
+                      const OPENTREP::LocationList_T& iLocationList,
+                      const OPENTREP::WordList_T& iNonMatchedWordList,
+                      const OPENTREP::DSVColumnList_T& iDSVColumnList,
+                      HTTPResponse_T& ioResponse) {
+    std::string& lBody = ioResponse.body();
+
+    switch (iFormat) {
+    case OPENTREP::OutputFormat::SHORT: {
+      std::ostringstream oStr;
+      OPENTREP::NbOfMatches_T idx = 0;
+      for (OPENTREP::LocationList_T::const_iterator itLocation =
+             iLocationList.begin();
+           itLocation != iLocationList.end(); ++itLocation, ++idx) {
+        const OPENTREP::Location& lLocation = *itLocation;
+        if (idx != 0) {
+          oStr << ",";
+        }
+        oStr << lLocation.getIataCode() << "/" << lLocation.getPercentage();
+      }
+      oStr << std::endl;
+      lBody = oStr.str();
+      ioResponse.set (http::field::content_type, "text/plain; charset=utf-8");
+      break;
+    }
+
+    case OPENTREP::OutputFormat::JSON: {
+      OPENTREP::BomJSONExport::jsonExportLocationList (lBody, iLocationList);
+      ioResponse.set (http::field::content_type, "application/json");
+      break;
+    }
+
+    case OPENTREP::OutputFormat::PROTOBUF: {
+      OPENTREP::LocationExchange::exportLocationList (lBody, iLocationList,
+                                                      iNonMatchedWordList);
+      ioResponse.set (http::field::content_type, "application/x-protobuf");
+      break;
+    }
+
+    case OPENTREP::OutputFormat::CSV:
+    case OPENTREP::OutputFormat::TSV: {
+      const char lDelimiter = OPENTREP::BomDSVExport::getDelimiter (iFormat);
+      OPENTREP::BomDSVExport::dsvExportLocationList (lBody, iLocationList,
+                                                     iDSVColumnList,
+                                                     lDelimiter, true);
+      const char* lContentType = (iFormat == OPENTREP::OutputFormat::CSV) ?
+        "text/csv; charset=utf-8" : "text/tab-separated-values; charset=utf-8";
+      ioResponse.set (http::field::content_type, lContentType);
+      break;
+    }
+
+    default: {
+      // Full (human-readable) output format
+      std::ostringstream oStr;
+      OPENTREP::NbOfMatches_T idx = 1;
+      for (OPENTREP::LocationList_T::const_iterator itLocation =
+             iLocationList.begin();
+           itLocation != iLocationList.end(); ++itLocation, ++idx) {
+        const OPENTREP::Location& lLocation = *itLocation;
+        oStr << " [" << idx << "]: " << lLocation << std::endl;
+      }
+
+      if (iNonMatchedWordList.empty() == false) {
+        oStr << "List of unmatched words:" << std::endl;
+
+        OPENTREP::NbOfMatches_T idxWord = 1;
+        for (OPENTREP::WordList_T::const_iterator itWord =
+               iNonMatchedWordList.begin();
+             itWord != iNonMatchedWordList.end(); ++itWord, ++idxWord) {
+          const OPENTREP::Word_T& lWord = *itWord;
+          oStr << " [" << idxWord << "]: " << lWord << std::endl;
+        }
+      }
+      lBody = oStr.str();
+      ioResponse.set (http::field::content_type, "text/plain; charset=utf-8");
+      break;
+    }
+    }
+  }
+
+  /**
+   * Set a plain text body (e.g., an error message).
+   */
+  static void setTextBody (HTTPResponse_T& ioResponse,
+                           const std::string& iText) {
+    ioResponse.set (http::field::content_type, "text/plain; charset=utf-8");
+    ioResponse.body() = iText;
+  }
+
+private:
+  /**
+   * OpenTREP service, shared by all the worker threads.
+   */
+  OPENTREP::OPENTREP_Service& _opentrepService;
+
+  /**
+   * Output format, when none is given by the request.
+   */
+  const std::string _defaultOutputFormat;
+};
+
+
+// ///////// HTTP connections /////////
+/**
+ * @brief HTTP connection with a client.
+ *
+ * The requests of the connection are read, served and answered one after
+ * the other, on the strand of the connection. As the bytes read beyond
+ * a request are kept in the buffer, the requests sent in a row, without
+ * waiting for the responses (pipelining), are answered in order. The
+ * connection is kept alive, unless the client asks otherwise, and closed
+ * after a period of inactivity.
+ */
+class HTTPSession : public boost::enable_shared_from_this<HTTPSession> {
+public:
+  /**
+   * Constructor.
+   */
+  HTTPSession (tcp::socket&& ioSocket, RequestHandler& ioRequestHandler)
+    : _stream (std::move (ioSocket)), _requestHandler (ioRequestHandler) {
+  }
+
+  /**
+   * Start reading the requests.
+   */
+  void start() {
+    net::dispatch (_stream.get_executor(),
+                   boost::bind (&HTTPSession::doRead, shared_from_this()));
+  }
+
+private:
+  /**
+   * Read the next request.
+   */
+  void doRead() {
+    // The request must be empty before being read
+    _request = HTTPRequest_T();
+
+    _stream.expires_after (std::chrono::seconds
+                           (K_OPENTREP_DEFAULT_IDLE_TIMEOUT));
+    http::async_read (_stream, _buffer, _request,
+                      boost::bind (&HTTPSession::onRead, shared_from_this(),
+                                   boost::placeholders::_1,
+                                   boost::placeholders::_2));
+  }
+
+  /**
+   * Serve the request just read, and write the response.
+   */
+  void onRead (const beast::error_code& iErrorCode, std::size_t) {
+    // The client has closed the connection
+    if (iErrorCode == http::error::end_of_stream) {
+      doClose();
+      return;
+    }
+
+    // Time-out, or connection error: the connection is dropped
+    if (iErrorCode) {
+      return;
+    }
+
+    _response = HTTPResponse_T();
+    _response.version (_request.version());
+    _response.set (http::field::server, "opentrep-server/" PACKAGE_VERSION);
+    _requestHandler.handle (_request, _response);
+    _response.keep_alive (_request.keep_alive());
+    _response.prepare_payload();
+
+    http::async_write (_stream, _response,
+                       boost::bind (&HTTPSession::onWrite, shared_from_this(),
+                                    boost::placeholders::_1,
+                                    boost::placeholders::_2));
+  }
+
+  /**
+   * Read the next request, unless the connection should be closed.
+   */
+  void onWrite (const beast::error_code& iErrorCode, std::size_t) {
+    if (iErrorCode) {
+      return;
+    }
+
+    if (_response.need_eof() == true) {
+      doClose();
+      return;
+    }
+
+    doRead();
+  }
+
+  /**
+   * Close the connection gracefully.
+   */
+  void doClose() {
+    beast::error_code lErrorCode;
+    _stream.socket().shutdown (tcp::socket::shutdown_send, lErrorCode);
+  }
+
+private:
+  beast::tcp_stream _stream;
+  beast::flat_buffer _buffer;
+  HTTPRequest_T _request;
+  HTTPResponse_T _response;
+  RequestHandler& _requestHandler;
+};
+
+/**
+ * @brief Acceptor of the HTTP connections.
+ */
+class HTTPListener : public boost::enable_shared_from_this<HTTPListener> {
+public:
+  /**
+   * Constructor, binding the given end-point. An exception
+   * (boost::system::system_error) is thrown when that fails.
+   */
+  HTTPListener (net::io_context& ioIOContext, const tcp::endpoint& iEndpoint,
+                RequestHandler& ioRequestHandler)
+    : _ioContext (ioIOContext), _acceptor (net::make_strand (ioIOContext)),
+      _socket (ioIOContext), _requestHandler (ioRequestHandler) {
+    _acceptor.open (iEndpoint.protocol());
+    _acceptor.set_option (net::socket_base::reuse_address (true));
+    _acceptor.bind (iEndpoint);
+    _acceptor.listen (net::socket_base::max_listen_connections);
+  }
+
+  /**
+   * Start accepting the connections.
+   */
+  void start() {
+    doAccept();
+  }
+
+private:
+  /**
+   * Accept the next connection, on its own strand.
+   */
+  void doAccept() {
+    _socket = tcp::socket (net::make_strand (_ioContext));
+    _acceptor.async_accept (_socket,
+                            boost::bind (&HTTPListener::onAccept,
+                                         shared_from_this(),
+                                         boost::placeholders::_1));
+  }
+
+  /**
+   * Start the session of the just accepted connection.
+   */
+  void onAccept (const beast::error_code& iErrorCode) {
+    if (!iErrorCode) {
+      // The responses are small: they are sent at once
+      beast::error_code lErrorCode;
+      _socket.set_option (tcp::no_delay (true), lErrorCode);
+
+      boost::make_shared<HTTPSession> (std::move (_socket),
+                                       _requestHandler)->start();
+    }
+
+    doAccept();
+  }
+
+private:
+  net::io_context& _ioContext;
+  tcp::acceptor _acceptor;
+  tcp::socket _socket;
+  RequestHandler& _requestHandler;
+};
+
+
+// /////////////// M A I N /////////////////
+int main (int argc, char* argv[]) {
+
+  // Address and port on which the server listens
+  std::string lServerAddress;
+  unsigned short lServerPort;
+
+  // Number of worker threads
+  unsigned short lNbOfThreads;
+
+  // Output log File
+  std::string lLogFilename;
+
+  // Xapian database name (directory of the index)
+  std::string lXapianDBNameStr;
+
+  // SQL database type
+  std::string lSQLDBTypeStr;
+
+  // SQL database connection string
+  std::string lSQLDBConnectionStr;
+
+  // Deployment number/version
+  OPENTREP::DeploymentNumber_T lDeploymentNumber;
+
+  // Hot-swap polling period
+  OPENTREP::PollingPeriod_T lHotSwapPollingPeriod;
+
+  // Default output format
+  std::string lOutputFormatStr;
+
+  // Log stream for the introduction part
+  std::ostringstream oIntroStr;
+
+  // Call the command-line option parser
+  const int lOptionParserStatus =
+    readConfiguration (argc, argv, lServerAddress, lServerPort, lNbOfThreads,
+                       lXapianDBNameStr, lSQLDBTypeStr, lSQLDBConnectionStr,
+                       lDeploymentNumber, lHotSwapPollingPeriod, lLogFilename,
+                       lOutputFormatStr, oIntroStr);
+
+  if (lOptionParserStatus == K_OPENTREP_EARLY_RETURN_STATUS) {
+    return 0;
+  }
+
+  // Check the default output format
+  try {
+    const char lOutputFormatChar =
+      (lOutputFormatStr.size() == 1) ? lOutputFormatStr[0] : '\0';
+    OPENTREP::OutputFormat::getFormat (lOutputFormatChar);
+
+  } catch (const OPENTREP::CodeConversionException& lException) {
+    std::cerr << "Error - " << lException.what() << std::endl;
+    return -1;
+  }
+
+  // Number of worker threads
+  if (lNbOfThreads == 0) {
+    lNbOfThreads = boost::thread::hardware_concurrency();
+  }
+  if (lNbOfThreads == 0) {
+    lNbOfThreads = 1;
+  }
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Report the parameters
+  std::cout << oIntroStr.str();
+
+  // DEBUG
+  // Get the current time in UTC Timezone
+  boost::posix_time::ptime lTimeUTC =
+    boost::posix_time::second_clock::universal_time();
+  logOutputFile << "[" << lTimeUTC << "][" << __FILE__ << "#"
+                << __LINE__ << "]:Parameters:" << std::endl
+                <<  oIntroStr.str() << std::endl;
+
+  // Initialise the context, shared by all the worker threads
+  const OPENTREP::TravelDBFilePath_T lXapianDBName (lXapianDBNameStr);
+  const OPENTREP::DBType lDBType (lSQLDBTypeStr);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (lSQLDBConnectionStr);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lXapianDBName,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber);
+
+  // Check the directory of the Xapian database/index exists and is accessible
+  const OPENTREP::OPENTREP_Service::FilePathSet_T& lFPSet =
+    opentrepService.getFilePaths();
+  const OPENTREP::TravelDBFilePath_T& lActualXapianDBDir= lFPSet.second.first;
+  const bool lExistXapianDBDir =
+    opentrepService.checkXapianDBOnFileSystem (lActualXapianDBDir);
+  if (lExistXapianDBDir == false) {
+    std::cerr << "Error - The file-path to the Xapian database/index ('"
+              << lActualXapianDBDir
+              << "') does not exist or is not a directory." << std::endl;
+    std::cerr << "\tThat usually means that the OpenTREP indexer "
+              << "(opentrep-indexer) has not been launched yet, "
+              << "or that it has operated on a different Xapian "
+              << "database/index file-path." << std::endl;
+    return -1;
+  }
+
+  // The Xapian index and the SQL database are kept open for all the
+  // requests, and hot-swapped when a new deployment is ready
+  opentrepService.startIndexHotSwap (lHotSwapPollingPeriod);
+
+  // Serve the requests until the process be interrupted
+  try {
+    net::io_context lIOContext (lNbOfThreads);
+
+    RequestHandler lRequestHandler (opentrepService, lOutputFormatStr);
+    const net::ip::address& lAddress =
+      net::ip::make_address (lServerAddress);
+    const tcp::endpoint lEndpoint (lAddress, lServerPort);
+    boost::make_shared<HTTPListener> (lIOContext, lEndpoint,
+                                      lRequestHandler)->start();
+
+    net::signal_set lSignalSet (lIOContext, SIGINT, SIGTERM);
+    lSignalSet.async_wait (boost::bind (&net::io_context::stop, &lIOContext));
+
+    std::cout << "Listening on http://" << lServerAddress << ":"
+              << lServerPort << "/ with " << lNbOfThreads
+              << " worker thread(s)" << std::endl;
+    OPENTREP_LOG_NOTIFICATION ("Listening on " << lServerAddress << ":"
+                               << lServerPort << " with " << lNbOfThreads
+                               << " worker thread(s)");
+
+    boost::thread_group lThreadGroup;
+    for (unsigned short idx = 1; idx < lNbOfThreads; ++idx) {
+      lThreadGroup.create_thread (boost::bind (&net::io_context::run,
+                                               &lIOContext));
+    }
+    lIOContext.run();
+    lThreadGroup.join_all();
+
+  } catch (const std::exception& lException) {
+    std::cerr << "Error - " << lException.what() << std::endl;
+    opentrepService.stopIndexHotSwap();
+    return -1;
+  }
+
+  opentrepService.stopIndexHotSwap();
+
+  // DEBUG
+  lTimeUTC = boost::posix_time::second_clock::universal_time();
+  logOutputFile << "[" << lTimeUTC << "][" << __FILE__ << "#"
+                << __LINE__ << "]:The server has been stopped" << std::endl;
+
+  // Close the Log outputFile
+  logOutputFile.close();
+
+  return 0;
+}
@@ -0,0 +1,208 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <cstdio>
+#include <cmath>
+#include <limits>
+#include <ostream>
+// OpenTREP
+#include <opentrep/Location.hpp>
+#include <opentrep/CityDetails.hpp>
+#include <opentrep/bom/BomDSVExport.hpp>
+
+namespace OPENTREP {
+
+  // ////////////////////////////////////////////////////////////////////
+  char BomDSVExport::
+  getDelimiter (const OutputFormat::EN_OutputFormat& iOutputFormat) {
+    assert (iOutputFormat == OutputFormat::CSV
+            || iOutputFormat == OutputFormat::TSV);
+    const char oDelimiter = (iOutputFormat == OutputFormat::TSV) ? '\t' : ',';
+    return oDelimiter;
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomDSVExport::
+  dsvExportLocationList (std::ostream& oStream,
+                         const LocationList_T& iLocationList,
+                         const DSVColumnList_T& iColumnList,
+                         const char iDelimiter, const bool iWithHeader) {
+    std::string lDSVBuffer;
+    dsvExportLocationList (lDSVBuffer, iLocationList, iColumnList,
+                           iDelimiter, iWithHeader);
+
+    // Write the whole DSV string at once
+    oStream.write (lDSVBuffer.data(), lDSVBuffer.size());
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomDSVExport::
+  dsvExportLocationList (std::string& ioDSVBuffer,
+                         const LocationList_T& iLocationList,
+                         const DSVColumnList_T& iColumnList,
+                         const char iDelimiter, const bool iWithHeader) {
+    // Empty the buffer, while keeping its memory. A line takes less than
+    // 32 characters per column, and the buffer is anyway extended when needed.
+    ioDSVBuffer.clear();
+    ioDSVBuffer.reserve (32 * iColumnList.size() * (iLocationList.size() + 1));
+
+    if (iWithHeader == true) {
+      dsvExportHeader (ioDSVBuffer, iColumnList, iDelimiter);
+    }
+
+    for (LocationList_T::const_iterator itLocation = iLocationList.begin();
+         itLocation != iLocationList.end(); ++itLocation) {
+      const Location& lLocation = *itLocation;
+      dsvExportLocation (ioDSVBuffer, lLocation, iColumnList, iDelimiter);
+    }
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomDSVExport::dsvExportHeader (std::string& ioDSVBuffer,
+                                      const DSVColumnList_T& iColumnList,
+                                      const char iDelimiter) {
+    for (DSVColumnList_T::const_iterator itColumn = iColumnList.begin();
+         itColumn != iColumnList.end(); ++itColumn) {
+      if (itColumn != iColumnList.begin()) {
+        ioDSVBuffer.push_back (iDelimiter);
+      }
+      ioDSVBuffer.append (DSVColumn::getLabel (*itColumn));
+    }
+    ioDSVBuffer.push_back ('\n');
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomDSVExport::dsvExportLocation (std::string& ioDSVBuffer,
+                                        const Location& iLocation,
+                                        const DSVColumnList_T& iColumnList,
+                                        const char iDelimiter) {
+    // Same precision as for the JSON export, i.e., one more significant
+    // digit than a double holds
+    const unsigned short lDoublePrecision =
+      std::numeric_limits<double>::digits10 + 1;
+
+    for (DSVColumnList_T::const_iterator itColumn = iColumnList.begin();
+         itColumn != iColumnList.end(); ++itColumn) {
+      if (itColumn != iColumnList.begin()) {
+        ioDSVBuffer.push_back (iDelimiter);
+      }
+
+      const DSVColumn::EN_DSVColumn& lColumn = *itColumn;
+      switch (lColumn) {
+      case DSVColumn::IATA_CODE:
+        dsvExportString (ioDSVBuffer, iLocation.getIataCode(), iDelimiter);
+        break;
+      case DSVColumn::GEONAMES_ID:
+        dsvExportInteger (ioDSVBuffer, iLocation.getGeonamesID());
+        break;
+      case DSVColumn::LATITUDE:
+        dsvExportFloat (ioDSVBuffer, iLocation.getLatitude(),
+                        lDoublePrecision);
+        break;
+      case DSVColumn::LONGITUDE:
+        dsvExportFloat (ioDSVBuffer, iLocation.getLongitude(),
+                        lDoublePrecision);
+        break;
+      case DSVColumn::COUNTRY_CODE:
+        dsvExportString (ioDSVBuffer, iLocation.getCountryCode(), iDelimiter);
+        break;
+      case DSVColumn::PAGE_RANK:
+        dsvExportFloat (ioDSVBuffer, iLocation.getPageRank(),
+                        lDoublePrecision);
+        break;
+      case DSVColumn::MATCHING_PERCENTAGE:
+        dsvExportFloat (ioDSVBuffer, iLocation.getPercentage(),
+                        lDoublePrecision);
+        break;
+      case DSVColumn::CORRECTED_KEYWORDS:
+        dsvExportString (ioDSVBuffer, iLocation.getCorrectedKeywords(),
+                         iDelimiter);
+        break;
+      default:
+        assert (false);
+        break;
+      }
+    }
+    ioDSVBuffer.push_back ('\n');
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomDSVExport::dsvExportString (std::string& ioDSVBuffer,
+                                      const std::string& iString,
+                                      const char iDelimiter) {
+    // Most of the values (e.g., codes) need neither quoting nor cleaning
+    const char lSpecialChars[] = { iDelimiter, '"', '\n', '\r', '\0' };
+    const std::string::size_type lSpecialPos =
+      iString.find_first_of (lSpecialChars);
+    if (lSpecialPos == std::string::npos) {
+      ioDSVBuffer.append (iString);
+      return;
+    }
+
+    // TSV: the tabulations and line breaks are replaced by spaces
+    if (iDelimiter == '\t') {
+      const std::string::size_type lStartSize = ioDSVBuffer.size();
+      ioDSVBuffer.append (iString);
+      for (std::string::size_type idx = lStartSize + lSpecialPos;
+           idx != ioDSVBuffer.size(); ++idx) {
+        char& lChar = ioDSVBuffer[idx];
+        if (lChar == '\t' || lChar == '\n' || lChar == '\r') {
+          lChar = ' ';
+        }
+      }
+      return;
+    }
+
+    // CSV: the value is quoted, and its double quotes are doubled
+    ioDSVBuffer.push_back ('"');
+    std::string::size_type lChunkPos = 0;
+    std::string::size_type lQuotePos = iString.find ('"');
+    while (lQuotePos != std::string::npos) {
+      ioDSVBuffer.append (iString, lChunkPos, lQuotePos - lChunkPos + 1);
+      ioDSVBuffer.push_back ('"');
+      lChunkPos = lQuotePos + 1;
+      lQuotePos = iString.find ('"', lChunkPos);
+    }
+    ioDSVBuffer.append (iString, lChunkPos, std::string::npos);
+    ioDSVBuffer.push_back ('"');
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomDSVExport::dsvExportInteger (std::string& ioDSVBuffer,
+                                       const long long iValue) {
+    // The digits are written from the end of a small local buffer
+    char lNumber[24];
+    char* lNumberEnd = lNumber + sizeof (lNumber);
+    char* lNumberBegin = lNumberEnd;
+    unsigned long long lValue = (iValue < 0) ?
+      0ULL - static_cast<unsigned long long> (iValue) : iValue;
+    do {
+      *--lNumberBegin = static_cast<char> ('0' + lValue % 10);
+      lValue /= 10;
+    } while (lValue != 0);
+    if (iValue < 0) {
+      *--lNumberBegin = '-';
+    }
+    ioDSVBuffer.append (lNumberBegin, lNumberEnd);
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomDSVExport::dsvExportFloat (std::string& ioDSVBuffer,
+                                     const double iValue,
+                                     const unsigned short iPrecision) {
+    // The not available (e.g., NaN) values give empty values
+    if (std::isfinite (iValue) == false) {
+      return;
+    }
+
+    char lNumber[32];
+    const int lNumberSize = std::snprintf (lNumber, sizeof (lNumber), "%.*g",
+                                           static_cast<int> (iPrecision),
+                                           iValue);
+    assert (lNumberSize > 0);
+    ioDSVBuffer.append (lNumber, lNumberSize);
+  }
+
+}
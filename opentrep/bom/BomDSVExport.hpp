@@ -0,0 +1,112 @@
+#ifndef __OPENTREP_BOM_BOMDSVEXPORT_HPP
+#define __OPENTREP_BOM_BOMDSVEXPORT_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <iosfwd>
+#include <string>
+// OpenTrep
+#include <opentrep/OutputFormat.hpp>
+#include <opentrep/DSVColumn.hpp>
+#include <opentrep/LocationList.hpp>
+
+namespace OPENTREP {
+
+  // Forward declarations
+  struct Location;
+
+  /**
+   * @brief Utility class to export Opentrep structures in a
+   *        delimiter-separated values (CSV or TSV) format.
+   *
+   * Every Location object gives one line, made of the selected columns
+   * (see DSVColumn), in the given order; the extra and alternate matching
+   * locations are not exported. The values are written directly into
+   * a string buffer, without any output stream. For instance, with the
+   * "iata_code,lat,lon,matching_percentage" columns and the CSV format:
+   * iata_code,lat,lon,matching_percentage
+   * NCE,43.658411,7.215872,100
+   *
+   * With the CSV format, the values holding a comma, a double quote or
+   * a line break are quoted (RFC 4180). With the TSV format, the tabulations
+   * and line breaks within the values are replaced by spaces. Not available
+   * (NaN) floating point numbers give empty values.
+   */
+  class BomDSVExport {
+  public:
+    // //////////////// Export support methods /////////////////
+
+    /**
+     * Get the delimiter of the given output format, i.e., a comma for CSV
+     * and a tabulation for TSV.
+     */
+    static char getDelimiter (const OutputFormat::EN_OutputFormat&);
+
+    /**
+     * Export (dump in the given output stream and in CSV or TSV format)
+     * a list of Location objects.
+     *
+     * @param std::ostream& Output stream in which the Location objects
+     *                      should be dumped.
+     * @param const LocationList_T& List of Location objects to be exported.
+     * @param const DSVColumnList_T& Columns to be exported.
+     * @param const char Delimiter (e.g., ',' or '\\t').
+     * @param const bool Whether the header line should be exported first.
+     */
+    static void dsvExportLocationList (std::ostream&, const LocationList_T&,
+                                       const DSVColumnList_T&, const char,
+                                       const bool);
+
+    /**
+     * Export (in CSV or TSV format) a list of Location objects into
+     * the given buffer, which is emptied first. As its capacity is kept,
+     * the same buffer may be reused from one export to another, so that
+     * its memory is allocated only once.
+     *
+     * @param std::string& Buffer in which the Location objects should be
+     *                     dumped.
+     * @param const LocationList_T& List of Location objects to be exported.
+     * @param const DSVColumnList_T& Columns to be exported.
+     * @param const char Delimiter (e.g., ',' or '\\t').
+     * @param const bool Whether the header line should be exported first.
+     */
+    static void dsvExportLocationList (std::string&, const LocationList_T&,
+                                       const DSVColumnList_T&, const char,
+                                       const bool);
+
+    /**
+     * Append the header line, i.e., the labels of the given columns.
+     */
+    static void dsvExportHeader (std::string&, const DSVColumnList_T&,
+                                 const char);
+
+    /**
+     * Append the line corresponding to the given Location object.
+     */
+    static void dsvExportLocation (std::string&, const Location&,
+                                   const DSVColumnList_T&, const char);
+
+  private:
+    /**
+     * Append a string value, quoted or cleaned when needed.
+     */
+    static void dsvExportString (std::string&, const std::string&,
+                                 const char iDelimiter);
+
+    /**
+     * Append an integer value.
+     */
+    static void dsvExportInteger (std::string&, const long long);
+
+    /**
+     * Append a floating point value, with the given number of significant
+     * digits.
+     */
+    static void dsvExportFloat (std::string&, const double,
+                                const unsigned short iPrecision);
+  };
+
+}
+#endif // __OPENTREP_BOM_BOMDSVEXPORT_HPP
@@ -3,190 +3,243 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <cassert>
+#include <cstdio>
+#include <cmath>
+#include <limits>
 #include <ostream>
-// Boost ForEach
-//#include <boost/foreach.hpp>
+// Boost
+#include <boost/date_time/gregorian/gregorian.hpp>
 // OpenTREP
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
 #include <opentrep/bom/BomJSONExport.hpp>
 
-namespace OPENTREP { 
+namespace OPENTREP {
 
   // ////////////////////////////////////////////////////////////////////
   void BomJSONExport::
   jsonExportLocationList (std::ostream& oStream,
                           const LocationList_T& iLocationList) {
+    std::string lJSONBuffer;
+    jsonExportLocationList (lJSONBuffer, iLocationList);
 
-    // Create empty Boost.Property_Tree objects
-    bpt::ptree lPT;
-    bpt::ptree lPTLocationList;
+    // Write the whole JSON string at once
+    oStream.write (lJSONBuffer.data(), lJSONBuffer.size());
+  }
 
+  // ////////////////////////////////////////////////////////////////////
+  void BomJSONExport::
+  jsonExportLocationList (std::string& ioJSONBuffer,
+                          const LocationList_T& iLocationList) {
+    // Empty the buffer, while keeping its memory. A Location object takes
+    // around 1.5 kB, and the buffer is anyway extended when needed.
+    ioJSONBuffer.clear();
+    ioJSONBuffer.reserve (1536 * (iLocationList.size() + 1));
+
+    ioJSONBuffer.append ("{\"locations\":[");
+
+    NbOfMatches_T idxLocation = 0;
     for (LocationList_T::const_iterator itLocation = iLocationList.begin();
-         itLocation != iLocationList.end(); ++itLocation) {
+         itLocation != iLocationList.end(); ++itLocation, ++idxLocation) {
       const Location& lLocation = *itLocation;
-      //
-      bpt::ptree lPTLocation;
-      jsonExportLocation (lPTLocation, lLocation);
-
-      // List of extra matching locations (those with the same matching
-      // weight/percentage)
-      const LocationList_T& lExtraLocationList= lLocation.getExtraLocationList();
-      if (lExtraLocationList.empty() == false) {
-        //
-        bpt::ptree lPTExtraLocationList;
-
-        NbOfMatches_T idxExtra = 0;
-        for (LocationList_T::const_iterator itLoc = lExtraLocationList.begin();
-             itLoc != lExtraLocationList.end(); ++itLoc, ++idxExtra) {
-          const Location& lExtraLocation = *itLoc;
-          //
-          bpt::ptree lPTExtraLocation;
-          jsonExportLocation (lPTExtraLocation, lExtraLocation);
-
-          // Put the current location tree in the location list
-          lPTExtraLocationList.push_back (std::make_pair("", lPTExtraLocation));
-        }
-
-        // Add the extra location list to the Boost.Property_Tree representing
-        // the current Location instance.
-        lPTLocation.add_child ("extras", lPTExtraLocationList);
+      if (idxLocation != 0) {
+        ioJSONBuffer.push_back (',');
       }
+      jsonExportLocation (ioJSONBuffer, lLocation);
+    }
 
-      // List of alternate matching locations (those with a lower matching
-      // weight/percentage)
-      const LocationList_T& lAltLocationList =
-        lLocation.getAlternateLocationList();
-      if (lAltLocationList.empty() == false) {
-        //
-        bpt::ptree lPTAltLocationList;
-
-        NbOfMatches_T idxAlter = 0;
-        for (LocationList_T::const_iterator itLoc = lAltLocationList.begin();
-             itLoc != lAltLocationList.end(); ++itLoc, ++idxAlter) {
-          const Location& lAltLocation = *itLoc;
-          //
-          bpt::ptree lPTAltLocation;
-          jsonExportLocation (lPTAltLocation, lAltLocation);
-
-          // Put the current location tree in the location list
-          lPTAltLocationList.push_back (std::make_pair ("", lPTAltLocation));
-        }
+    ioJSONBuffer.append ("]}\n");
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomJSONExport::jsonExportLocation (std::string& ioJSONBuffer,
+                                          const Location& iLocation) {
+    ioJSONBuffer.push_back ('{');
+    jsonExportLocationFields (ioJSONBuffer, iLocation);
+
+    // List of extra matching locations (those with the same matching
+    // weight/percentage)
+    const LocationList_T& lExtraLocationList= iLocation.getExtraLocationList();
+    if (lExtraLocationList.empty() == false) {
+      ioJSONBuffer.append (",\"extras\":[");
 
-        // Add the extra location list to the Boost.Property_Tree representing
-        // the current Location instance.
-        lPTLocation.add_child ("alternates", lPTAltLocationList);
+      NbOfMatches_T idxExtra = 0;
+      for (LocationList_T::const_iterator itLoc = lExtraLocationList.begin();
+           itLoc != lExtraLocationList.end(); ++itLoc, ++idxExtra) {
+        const Location& lExtraLocation = *itLoc;
+        if (idxExtra != 0) {
+          ioJSONBuffer.push_back (',');
+        }
+        ioJSONBuffer.push_back ('{');
+        jsonExportLocationFields (ioJSONBuffer, lExtraLocation);
+        ioJSONBuffer.push_back ('}');
       }
 
-      // Add the current location property tree to the location list
-      lPTLocationList.push_back (std::make_pair ("", lPTLocation));
+      ioJSONBuffer.push_back (']');
     }
 
-    // Add the location list to the root of the Boost.Property_Tree
-    lPT.add_child ("locations", lPTLocationList);
+    // List of alternate matching locations (those with a lower matching
+    // weight/percentage)
+    const LocationList_T& lAltLocationList =
+      iLocation.getAlternateLocationList();
+    if (lAltLocationList.empty() == false) {
+      ioJSONBuffer.append (",\"alternates\":[");
 
-    // Write the property tree into a JSON string
-    write_json (oStream, lPT);
+      NbOfMatches_T idxAlter = 0;
+      for (LocationList_T::const_iterator itLoc = lAltLocationList.begin();
+           itLoc != lAltLocationList.end(); ++itLoc, ++idxAlter) {
+        const Location& lAltLocation = *itLoc;
+        if (idxAlter != 0) {
+          ioJSONBuffer.push_back (',');
+        }
+        ioJSONBuffer.push_back ('{');
+        jsonExportLocationFields (ioJSONBuffer, lAltLocation);
+        ioJSONBuffer.push_back ('}');
+      }
+
+      ioJSONBuffer.push_back (']');
+    }
+
+    ioJSONBuffer.push_back ('}');
   }
 
   // ////////////////////////////////////////////////////////////////////
-  void BomJSONExport::jsonExportLocation (bpt::ptree& ioPTLocation,
-                                          const Location& iLocation) {
-    // Fill all the fields of the JSON instance
-    ioPTLocation.put ("iata_code", iLocation.getIataCode());
-    ioPTLocation.put ("icao_code", iLocation.getIcaoCode());
-    ioPTLocation.put ("geonames_id", iLocation.getGeonamesID());
-    ioPTLocation.put ("feature_class", iLocation.getFeatureClass());
-    ioPTLocation.put ("feature_code", iLocation.getFeatureCode());
-    ioPTLocation.put ("modification_date", iLocation.getModificationDate());
-    ioPTLocation.put ("faa_code", iLocation.getFaaCode());
-    ioPTLocation.put ("env_id", iLocation.getEnvelopeID());
-    ioPTLocation.put ("date_from", iLocation.getDateFrom());
-    ioPTLocation.put ("date_end", iLocation.getDateEnd());
-    ioPTLocation.put ("name_common", iLocation.getCommonName());
-    ioPTLocation.put ("name_ascii", iLocation.getAsciiName());
-    ioPTLocation.put ("state_code", iLocation.getStateCode());
-    ioPTLocation.put ("country_code", iLocation.getCountryCode());
-    ioPTLocation.put ("country_name", iLocation.getCountryName());
-    ioPTLocation.put ("alt_country_code", iLocation.getAltCountryCode());
-    ioPTLocation.put ("continent_code", iLocation.getContinentCode());
-    ioPTLocation.put ("continent_name", iLocation.getContinentName());
-    ioPTLocation.put ("adm1_code", iLocation.getAdmin1Code());
-    ioPTLocation.put ("adm1_name_utf", iLocation.getAdmin1UtfName());
-    ioPTLocation.put ("adm1_name_ascii", iLocation.getAdmin1AsciiName());
-    ioPTLocation.put ("adm2_code", iLocation.getAdmin2Code());
-    ioPTLocation.put ("adm2_name_utf", iLocation.getAdmin2UtfName());
-    ioPTLocation.put ("adm2_name_ascii", iLocation.getAdmin2AsciiName());
-    ioPTLocation.put ("adm3_code", iLocation.getAdmin3Code());
-    ioPTLocation.put ("adm4_code", iLocation.getAdmin4Code());
-    ioPTLocation.put ("tvl_por_list", iLocation.getTvlPORListString());
-    ioPTLocation.put ("time_zone", iLocation.getTimeZone());
-    ioPTLocation.put ("offset_gmt", iLocation.getGMTOffset());
-    ioPTLocation.put ("offset_dst", iLocation.getDSTOffset());
-    ioPTLocation.put ("offset_raw", iLocation.getRawOffset());
-    ioPTLocation.put ("lat", iLocation.getLatitude());
-    ioPTLocation.put ("lon", iLocation.getLongitude());
-    ioPTLocation.put ("geonames_lat", iLocation.getGeonameLatitude());
-    ioPTLocation.put ("geonames_lon", iLocation.getGeonameLongitude());
-    ioPTLocation.put ("population", iLocation.getPopulation());
-    ioPTLocation.put ("elevation", iLocation.getElevation());
-    ioPTLocation.put ("gtopo30", iLocation.getGTopo30());
-    ioPTLocation.put ("page_rank", iLocation.getPageRank());
-    ioPTLocation.put ("wac", iLocation.getWAC());
-    ioPTLocation.put ("wac_name", iLocation.getWACName());
-    ioPTLocation.put ("wiki_link", iLocation.getWikiLink());
-    ioPTLocation.put ("currency_code", iLocation.getCurrencyCode());
-    ioPTLocation.put ("original_keywords", iLocation.getOriginalKeywords());
-    ioPTLocation.put ("corrected_keywords", iLocation.getCorrectedKeywords());
-    ioPTLocation.put ("matching_percentage", iLocation.getPercentage());
-    ioPTLocation.put ("edit_distance", iLocation.getEditDistance());
-    ioPTLocation.put ("allowable_distance",iLocation.getAllowableEditDistance());
+  void BomJSONExport::jsonExportLocationFields (std::string& ioJSONBuffer,
+                                                const Location& iLocation) {
+    // The single- and double-precision floating point numbers are given
+    // with one more significant digit than they hold, as Boost.PropertyTree
+    // (formerly used for that export) did
+    const unsigned short lFloatPrecision =
+      std::numeric_limits<float>::digits10 + 1;
+    const unsigned short lDoublePrecision =
+      std::numeric_limits<double>::digits10 + 1;
+
+    // Fill all the fields of the JSON instance. The first field does not
+    // need any separator.
+    ioJSONBuffer.append ("\"iata_code\":");
+    jsonExportString (ioJSONBuffer, iLocation.getIataCode());
+    jsonExportField (ioJSONBuffer, "icao_code", iLocation.getIcaoCode());
+    jsonExportField (ioJSONBuffer, "geonames_id", iLocation.getGeonamesID());
+    jsonExportField (ioJSONBuffer, "feature_class",
+                     iLocation.getFeatureClass());
+    jsonExportField (ioJSONBuffer, "feature_code", iLocation.getFeatureCode());
+    jsonExportField (ioJSONBuffer, "modification_date",
+                     boost::gregorian::
+                     to_simple_string (iLocation.getModificationDate()));
+    jsonExportField (ioJSONBuffer, "faa_code", iLocation.getFaaCode());
+    jsonExportField (ioJSONBuffer, "env_id", iLocation.getEnvelopeID());
+    jsonExportField (ioJSONBuffer, "date_from",
+                     boost::gregorian::
+                     to_simple_string (iLocation.getDateFrom()));
+    jsonExportField (ioJSONBuffer, "date_end",
+                     boost::gregorian::to_simple_string (iLocation.getDateEnd()));
+    jsonExportField (ioJSONBuffer, "name_common", iLocation.getCommonName());
+    jsonExportField (ioJSONBuffer, "name_ascii", iLocation.getAsciiName());
+    jsonExportField (ioJSONBuffer, "state_code", iLocation.getStateCode());
+    jsonExportField (ioJSONBuffer, "country_code", iLocation.getCountryCode());
+    jsonExportField (ioJSONBuffer, "country_name", iLocation.getCountryName());
+    jsonExportField (ioJSONBuffer, "alt_country_code",
+                     iLocation.getAltCountryCode());
+    jsonExportField (ioJSONBuffer, "continent_code",
+                     iLocation.getContinentCode());
+    jsonExportField (ioJSONBuffer, "continent_name",
+                     iLocation.getContinentName());
+    jsonExportField (ioJSONBuffer, "adm1_code", iLocation.getAdmin1Code());
+    jsonExportField (ioJSONBuffer, "adm1_name_utf",
+                     iLocation.getAdmin1UtfName());
+    jsonExportField (ioJSONBuffer, "adm1_name_ascii",
+                     iLocation.getAdmin1AsciiName());
+    jsonExportField (ioJSONBuffer, "adm2_code", iLocation.getAdmin2Code());
+    jsonExportField (ioJSONBuffer, "adm2_name_utf",
+                     iLocation.getAdmin2UtfName());
+    jsonExportField (ioJSONBuffer, "adm2_name_ascii",
+                     iLocation.getAdmin2AsciiName());
+    jsonExportField (ioJSONBuffer, "adm3_code", iLocation.getAdmin3Code());
+    jsonExportField (ioJSONBuffer, "adm4_code", iLocation.getAdmin4Code());
+    jsonExportField (ioJSONBuffer, "tvl_por_list",
+                     iLocation.getTvlPORListString());
+    jsonExportField (ioJSONBuffer, "time_zone", iLocation.getTimeZone());
+    jsonExportField (ioJSONBuffer, "offset_gmt", iLocation.getGMTOffset(),
+                     lFloatPrecision);
+    jsonExportField (ioJSONBuffer, "offset_dst", iLocation.getDSTOffset(),
+                     lFloatPrecision);
+    jsonExportField (ioJSONBuffer, "offset_raw", iLocation.getRawOffset(),
+                     lFloatPrecision);
+    jsonExportField (ioJSONBuffer, "lat", iLocation.getLatitude(),
+                     lDoublePrecision);
+    jsonExportField (ioJSONBuffer, "lon", iLocation.getLongitude(),
+                     lDoublePrecision);
+    jsonExportField (ioJSONBuffer, "geonames_lat",
+                     iLocation.getGeonameLatitude(), lDoublePrecision);
+    jsonExportField (ioJSONBuffer, "geonames_lon",
+                     iLocation.getGeonameLongitude(), lDoublePrecision);
+    jsonExportField (ioJSONBuffer, "population", iLocation.getPopulation());
+    jsonExportField (ioJSONBuffer, "elevation", iLocation.getElevation());
+    jsonExportField (ioJSONBuffer, "gtopo30", iLocation.getGTopo30());
+    jsonExportField (ioJSONBuffer, "page_rank", iLocation.getPageRank(),
+                     lDoublePrecision);
+    jsonExportField (ioJSONBuffer, "wac", iLocation.getWAC());
+    jsonExportField (ioJSONBuffer, "wac_name", iLocation.getWACName());
+    jsonExportField (ioJSONBuffer, "wiki_link", iLocation.getWikiLink());
+    jsonExportField (ioJSONBuffer, "currency_code",
+                     iLocation.getCurrencyCode());
+    jsonExportField (ioJSONBuffer, "original_keywords",
+                     iLocation.getOriginalKeywords());
+    jsonExportField (ioJSONBuffer, "corrected_keywords",
+                     iLocation.getCorrectedKeywords());
+    jsonExportField (ioJSONBuffer, "matching_percentage",
+                     iLocation.getPercentage(), lDoublePrecision);
+    jsonExportField (ioJSONBuffer, "edit_distance",
+                     iLocation.getEditDistance());
+    jsonExportField (ioJSONBuffer, "allowable_distance",
+                     iLocation.getAllowableEditDistance());
 
     /**
      * List of UN/LOCODE codes
      */
-    bpt::ptree ptUNLOCodeList;
-    // Retrieve the list of UN/LOCODE codes
+    ioJSONBuffer.append (",\"unlocode_codes\":[");
     const UNLOCodeList_T& lUNCodeList = iLocation.getUNLOCodeList();
     for (UNLOCodeList_T::const_iterator itUNLOCode = lUNCodeList.begin();
          itUNLOCode != lUNCodeList.end(); ++itUNLOCode) {
       // Retrieve the UN/LOCODE code
       const UNLOCode_T& lUNLOCode = *itUNLOCode;
-
-      // Add the item into the UN/LOCODE list Boost.Property_Tree      
-      ptUNLOCodeList.put ("unlocode_code", lUNLOCode);
+      if (itUNLOCode != lUNCodeList.begin()) {
+        ioJSONBuffer.push_back (',');
+      }
+      ioJSONBuffer.append ("{\"unlocode_code\":");
+      jsonExportString (ioJSONBuffer, lUNLOCode);
+      ioJSONBuffer.push_back ('}');
     }
-
-    // Add the UN/LOCODE Boost.Property_Tree to the main tree
-    ioPTLocation.add_child ("unlocode_codes", ptUNLOCodeList);
+    ioJSONBuffer.push_back (']');
 
     /**
      * List of served cities
      */
-    bpt::ptree ptCityList;
-    // Retrieve the list of served cities
+    ioJSONBuffer.append (",\"cities\":[");
     const CityDetailsList_T& lCityList = iLocation.getCityList();
     for (CityDetailsList_T::const_iterator itCity = lCityList.begin();
          itCity != lCityList.end(); ++itCity) {
       // Retrieve the details, ie, IATA code, Geonames ID and names
       const CityDetails& lCityDetails = *itCity;
-      bpt::ptree ptCityDetails;
-      ptCityDetails.put ("iata_code", lCityDetails.getIataCode());
-      ptCityDetails.put ("geonames_id", lCityDetails.getGeonamesID());
-      ptCityDetails.put ("name_utf", lCityDetails.getUtfName());
-      ptCityDetails.put ("name_ascii", lCityDetails.getAsciiName());
-
-      // Add the item into the city list Boost.Property_Tree
-      ptCityList.push_back (std::make_pair ("city_details", ptCityDetails));
+      if (itCity != lCityList.begin()) {
+        ioJSONBuffer.push_back (',');
+      }
+      ioJSONBuffer.append ("{\"iata_code\":");
+      jsonExportString (ioJSONBuffer, lCityDetails.getIataCode());
+      jsonExportField (ioJSONBuffer, "geonames_id",
+                       lCityDetails.getGeonamesID());
+      jsonExportField (ioJSONBuffer, "name_utf", lCityDetails.getUtfName());
+      jsonExportField (ioJSONBuffer, "name_ascii",
+                       lCityDetails.getAsciiName());
+      ioJSONBuffer.push_back ('}');
     }
-
-    // Add the city detail list to the location Boost.Property_Tree
-    ioPTLocation.add_child ("cities", ptCityList);
+    ioJSONBuffer.push_back (']');
 
     /**
      * Alternate names
      */
-    bpt::ptree ptLocationNameList;
+    ioJSONBuffer.append (",\"names\":[");
+    bool isFirstName = true;
     // Retrieve the place names in all the available languages
     const NameMatrix& lNameMatrixFull = iLocation.getNameMatrix();
     const NameMatrix_T& lNameMatrix = lNameMatrixFull.getNameMatrix();
@@ -198,21 +251,111 @@ namespace OPENTREP {
 
       // For a given language, retrieve the list of place names
       const NameList_T& lNameList = lNames.getNameList();
-        
+
       for (NameList_T::const_iterator itName = lNameList.begin();
            itName != lNameList.end(); ++itName) {
         const std::string& lName = *itName;
 
         if (lName.empty() == false) {
-          bpt::ptree ptLocationName;
-          ptLocationName.put ("name", lName);
-          ptLocationNameList.push_back (std::make_pair ("", ptLocationName));
+          if (isFirstName == false) {
+            ioJSONBuffer.push_back (',');
+          }
+          isFirstName = false;
+          ioJSONBuffer.append ("{\"name\":");
+          jsonExportString (ioJSONBuffer, lName);
+          ioJSONBuffer.push_back ('}');
         }
       }
     }
+    ioJSONBuffer.push_back (']');
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomJSONExport::jsonExportString (std::string& ioJSONBuffer,
+                                        const std::string& iString) {
+    ioJSONBuffer.push_back ('"');
+
+    // The characters not needing any escaping are copied by chunks
+    std::string::size_type lChunkPos = 0;
+    const std::string::size_type lStringSize = iString.size();
+    for (std::string::size_type idx = 0; idx != lStringSize; ++idx) {
+      const unsigned char lChar = iString[idx];
+      if (lChar >= 0x20 && lChar != '"' && lChar != '\\') {
+        continue;
+      }
+
+      ioJSONBuffer.append (iString, lChunkPos, idx - lChunkPos);
+      lChunkPos = idx + 1;
+
+      switch (lChar) {
+      case '"': ioJSONBuffer.append ("\\\""); break;
+      case '\\': ioJSONBuffer.append ("\\\\"); break;
+      case '\b': ioJSONBuffer.append ("\\b"); break;
+      case '\f': ioJSONBuffer.append ("\\f"); break;
+      case '\n': ioJSONBuffer.append ("\\n"); break;
+      case '\r': ioJSONBuffer.append ("\\r"); break;
+      case '\t': ioJSONBuffer.append ("\\t"); break;
+      default: {
+        // Other control characters
+        char lEscapedChar[8];
+        std::snprintf (lEscapedChar, sizeof (lEscapedChar), "\\u%04x",
+                       static_cast<unsigned int> (lChar));
+        ioJSONBuffer.append (lEscapedChar);
+        break;
+      }
+      }
+    }
+    ioJSONBuffer.append (iString, lChunkPos, lStringSize - lChunkPos);
+
+    ioJSONBuffer.push_back ('"');
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomJSONExport::jsonExportField (std::string& ioJSONBuffer,
+                                       const char* iKey,
+                                       const std::string& iValue) {
+    ioJSONBuffer.append (",\"");
+    ioJSONBuffer.append (iKey);
+    ioJSONBuffer.append ("\":");
+    jsonExportString (ioJSONBuffer, iValue);
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomJSONExport::jsonExportField (std::string& ioJSONBuffer,
+                                       const char* iKey,
+                                       const long long iValue) {
+    ioJSONBuffer.append (",\"");
+    ioJSONBuffer.append (iKey);
+    ioJSONBuffer.append ("\":");
+
+    char lNumber[32];
+    const int lNumberSize = std::snprintf (lNumber, sizeof (lNumber), "%lld",
+                                           iValue);
+    assert (lNumberSize > 0);
+    ioJSONBuffer.append (lNumber, lNumberSize);
+  }
+
+  // ////////////////////////////////////////////////////////////////////
+  void BomJSONExport::jsonExportField (std::string& ioJSONBuffer,
+                                       const char* iKey,
+                                       const double iValue,
+                                       const unsigned short iPrecision) {
+    ioJSONBuffer.append (",\"");
+    ioJSONBuffer.append (iKey);
+    ioJSONBuffer.append ("\":");
+
+    // JSON has no representation for the infinite and NaN values
+    if (std::isfinite (iValue) == false) {
+      ioJSONBuffer.append ("null");
+      return;
+    }
 
-    // Add the name list to the Boost.Property_Tree representing the location
-    ioPTLocation.add_child ("names", ptLocationNameList);
+    char lNumber[32];
+    const int lNumberSize = std::snprintf (lNumber, sizeof (lNumber), "%.*g",
+                                           static_cast<int> (iPrecision),
+                                           iValue);
+    assert (lNumberSize > 0);
+    ioJSONBuffer.append (lNumber, lNumberSize);
   }
 
 }
@@ -6,14 +6,10 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <iosfwd>
-// Boost Property Tree (PT)
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/json_parser.hpp>
+#include <string>
 // OpenTrep
 #include <opentrep/LocationList.hpp>
 
-namespace bpt = boost::property_tree;
-
 namespace OPENTREP {
 
   // Forward declarations
@@ -21,10 +17,19 @@ namespace OPENTREP {
 
   /**
    * @brief Utility class to export Opentrep structures in a JSON format.
+   *
+   * The JSON text is written directly, field after field, into a string
+   * buffer, without any intermediate tree. The numeric fields (e.g.,
+   * coordinates, PageRank, population) are exported as JSON numbers
+   * (or null, when not finite), and the lists (e.g., UN/LOCODE codes,
+   * served cities, names) as JSON arrays. For instance:
+   * {"locations":[{"iata_code":"NCE", ..., "lat":43.658411, ...,
+   *  "unlocode_codes":[{"unlocode_code":"FRNCE"}], "cities":[{"iata_code":
+   *  "NCE", ...}], "names":[{"name":"Nice Côte d'Azur"}, ...]}]}
    */
   class BomJSONExport {
   public:
-    // //////////////// Export support methods /////////////////   
+    // //////////////// Export support methods /////////////////
 
     /**
      * Export (dump in the underlying output log stream and in JSON format)
@@ -37,14 +42,61 @@ namespace OPENTREP {
     static void jsonExportLocationList (std::ostream&, const LocationList_T&);
 
     /**
-     * Export (dump in the underlying output log stream and in JSON format)
-     * a Location object.
+     * Export (in JSON format) a list of Location objects into the given
+     * buffer, which is emptied first. As its capacity is kept, the same
+     * buffer may be reused from one export to another, so that its memory
+     * is allocated only once.
      *
-     * @param bpt::ptree& Property tree in which the Location structure 
-     *                    should be logged/dumped.
+     * @param std::string& Buffer in which the Location objects should be
+     *                     dumped.
+     * @param const LocationList_T& List of Location objects to be exported.
+     */
+    static void jsonExportLocationList (std::string&, const LocationList_T&);
+
+    /**
+     * Export (in JSON format) a Location object, along with its extra and
+     * alternate matching locations, if any.
+     *
+     * @param std::string& Buffer to which the JSON object representing
+     *                     the Location structure should be appended.
      * @param const Location& Location object to be exported.
      */
-    static void jsonExportLocation (bpt::ptree&, const Location&);
+    static void jsonExportLocation (std::string&, const Location&);
+
+  private:
+    /**
+     * Export the fields of a Location object (but its extra and
+     * alternate matching locations).
+     */
+    static void jsonExportLocationFields (std::string&, const Location&);
+
+    /**
+     * Append a JSON string, i.e., the given string, quoted and escaped.
+     */
+    static void jsonExportString (std::string&, const std::string&);
+
+    /**
+     * Append the separator (comma) and the key of the next field
+     * of a JSON object, as well as the given string value.
+     */
+    static void jsonExportField (std::string&, const char* iKey,
+                                 const std::string& iValue);
+
+    /**
+     * Append the separator (comma) and the key of the next field
+     * of a JSON object, as well as the given integer value.
+     */
+    static void jsonExportField (std::string&, const char* iKey,
+                                 const long long iValue);
+
+    /**
+     * Append the separator (comma) and the key of the next field
+     * of a JSON object, as well as the given floating point value,
+     * with the given number of significant digits.
+     */
+    static void jsonExportField (std::string&, const char* iKey,
+                                 const double iValue,
+                                 const unsigned short iPrecision);
   };
 
 }
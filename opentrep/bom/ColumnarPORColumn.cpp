@@ -0,0 +1,82 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+// OpenTREP
+#include <opentrep/bom/ColumnarPORColumn.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string ColumnarPORColumn::_labels[LAST_VALUE] =
+    { "iata_code", "icao_code", "faa_code", "is_geonames", "geoname_id",
+      "envelope_id", "name", "asciiname", "latitude", "longitude",
+      "fclass", "fcode", "page_rank", "date_from", "date_until",
+      "country_code", "country_code2", "country_name", "continent_code",
+      "continent_name", "adm1_code", "adm1_name_utf", "adm1_name_ascii",
+      "adm2_code", "adm2_name_utf", "adm2_name_ascii", "adm3_code",
+      "adm4_code", "population", "elevation", "gtopo30", "timezone",
+      "gmt_offset", "dst_offset", "raw_offset", "moddate", "city_code_list",
+      "tvl_por_list", "state_code", "location_type", "wiki_link",
+      "unlocode_list", "uic_list", "geoname_latitude", "geoname_longitude",
+      "wac", "wac_name", "currency_code" };
+
+  // //////////////////////////////////////////////////////////////////////
+  const ColumnarPORColumn::EN_ValueType
+  ColumnarPORColumn::_valueTypes[LAST_VALUE] =
+    { STRING, STRING, STRING, INTEGER, INTEGER,
+      INTEGER, STRING, STRING, FLOAT, FLOAT,
+      STRING, STRING, FLOAT, INTEGER, INTEGER,
+      STRING, STRING, STRING, STRING,
+      STRING, STRING, STRING, STRING,
+      STRING, STRING, STRING, STRING,
+      STRING, INTEGER, INTEGER, INTEGER, STRING,
+      FLOAT, FLOAT, FLOAT, INTEGER, STRING,
+      STRING, STRING, STRING, STRING,
+      STRING, STRING, FLOAT, FLOAT,
+      INTEGER, STRING, STRING };
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string ColumnarPORColumn::_valueTypeLabels[LAST_VALUE_TYPE] =
+    { "integer", "float", "string" };
+
+  // //////////////////////////////////////////////////////////////////////
+  ColumnarPORColumn::ColumnarPORColumn() {
+    assert (false);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string& ColumnarPORColumn::getLabel (const EN_Column& iColumn) {
+    assert (iColumn < LAST_VALUE);
+    return _labels[iColumn];
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  ColumnarPORColumn::EN_ValueType
+  ColumnarPORColumn::getValueType (const EN_Column& iColumn) {
+    assert (iColumn < LAST_VALUE);
+    return _valueTypes[iColumn];
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const std::string& ColumnarPORColumn::
+  getValueTypeLabel (const EN_ValueType& iValueType) {
+    assert (iValueType < LAST_VALUE_TYPE);
+    return _valueTypeLabels[iValueType];
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string ColumnarPORColumn::describeLabels() {
+    std::ostringstream ostr;
+    for (unsigned short idx = 0; idx != LAST_VALUE; ++idx) {
+      if (idx != 0) {
+        ostr << ", ";
+      }
+      ostr << _labels[idx];
+    }
+    return ostr.str();
+  }
+
+}
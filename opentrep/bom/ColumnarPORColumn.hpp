@@ -0,0 +1,136 @@
+#ifndef __OPENTREP_BOM_COLUMNARPORCOLUMN_HPP
+#define __OPENTREP_BOM_COLUMNARPORCOLUMN_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+
+namespace OPENTREP {
+
+  /**
+   * @brief Enumeration of the columns of the columnar export files
+   *        of the POR (points of reference).
+   *
+   * Every column holds a single field of the Location structures, with
+   * one of the following value types:
+   * <ul>
+   *   <li>INTEGER: 64-bit signed integers (e.g., Geonames ID, population,
+   *       dates as YYYYMMDD numbers, 0 when not available);</li>
+   *   <li>FLOAT: IEEE 754 double precision numbers (e.g., coordinates,
+   *       PageRank);</li>
+   *   <li>STRING: UTF-8 strings (e.g., codes, names). The lists (e.g.,
+   *       UN/LOCODE codes, served cities) are joined with commas.</li>
+   * </ul>
+   *
+   * \see ColumnarPORWriter for the layout of the files.
+   */
+  struct ColumnarPORColumn {
+  public:
+    typedef enum {
+      IATA_CODE = 0,
+      ICAO_CODE,
+      FAA_CODE,
+      IS_GEONAMES,
+      GEONAME_ID,
+      ENVELOPE_ID,
+      NAME,
+      ASCII_NAME,
+      LATITUDE,
+      LONGITUDE,
+      FEATURE_CLASS,
+      FEATURE_CODE,
+      PAGE_RANK,
+      DATE_FROM,
+      DATE_UNTIL,
+      COUNTRY_CODE,
+      ALT_COUNTRY_CODE,
+      COUNTRY_NAME,
+      CONTINENT_CODE,
+      CONTINENT_NAME,
+      ADM1_CODE,
+      ADM1_NAME_UTF,
+      ADM1_NAME_ASCII,
+      ADM2_CODE,
+      ADM2_NAME_UTF,
+      ADM2_NAME_ASCII,
+      ADM3_CODE,
+      ADM4_CODE,
+      POPULATION,
+      ELEVATION,
+      GTOPO30,
+      TIME_ZONE,
+      GMT_OFFSET,
+      DST_OFFSET,
+      RAW_OFFSET,
+      MODIFICATION_DATE,
+      CITY_CODE_LIST,
+      TVL_POR_LIST,
+      STATE_CODE,
+      LOCATION_TYPE,
+      WIKI_LINK,
+      UNLOCODE_LIST,
+      UIC_CODE_LIST,
+      GEONAME_LATITUDE,
+      GEONAME_LONGITUDE,
+      WAC,
+      WAC_NAME,
+      CURRENCY_CODE,
+      LAST_VALUE
+    } EN_Column;
+
+    typedef enum {
+      INTEGER = 0,
+      FLOAT,
+      STRING,
+      LAST_VALUE_TYPE
+    } EN_ValueType;
+
+    /**
+     * Get the name of the column (e.g., "iata_code", "geoname_id").
+     */
+    static const std::string& getLabel (const EN_Column&);
+
+    /**
+     * Get the type of the values of the column.
+     */
+    static EN_ValueType getValueType (const EN_Column&);
+
+    /**
+     * Get the name of the value type (e.g., "integer", "float", "string").
+     */
+    static const std::string& getValueTypeLabel (const EN_ValueType&);
+
+    /**
+     * List the names of the columns.
+     */
+    static std::string describeLabels();
+
+
+  private:
+    /**
+     * Default constructor.
+     */
+    ColumnarPORColumn();
+
+
+  private:
+    /**
+     * Names of the columns.
+     */
+    static const std::string _labels[LAST_VALUE];
+
+    /**
+     * Value types of the columns.
+     */
+    static const EN_ValueType _valueTypes[LAST_VALUE];
+
+    /**
+     * Names of the value types.
+     */
+    static const std::string _valueTypeLabels[LAST_VALUE_TYPE];
+  };
+
+}
+#endif // __OPENTREP_BOM_COLUMNARPORCOLUMN_HPP
@@ -0,0 +1,339 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <cstring>
+#include <sstream>
+// OpenTrep
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/bom/ColumnarPORReader.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * Get the unsigned integer of the given number of bytes, stored
+   * in little-endian order at the given position.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  unsigned long long getLittleEndian (const std::string& iBuffer,
+                                      const std::size_t iPosition,
+                                      const unsigned short iNbOfBytes) {
+    assert (iPosition + iNbOfBytes <= iBuffer.size());
+    unsigned long long oValue = 0;
+    for (unsigned short idx = 0; idx != iNbOfBytes; ++idx) {
+      const unsigned char lByte =
+        static_cast<unsigned char> (iBuffer[iPosition + idx]);
+      oValue |= static_cast<unsigned long long> (lByte) << (8 * idx);
+    }
+    return oValue;
+  }
+
+  /**
+   * Throw an exception, signalling that the columnar export file cannot
+   * be read, for the given reason.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void throwColumnarFileException (const std::string& iReason) {
+    std::ostringstream errorStr;
+    errorStr << "The columnar export file cannot be read: " << iReason;
+    OPENTREP_LOG_ERROR (errorStr.str());
+    throw SerDeException (errorStr.str());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  ColumnarPORReader::ColumnarPORReader (std::istream& ioInputStream)
+    : _inputStream (ioInputStream), _nbOfRows (0), _fileSize (0),
+      _footerOffset (0) {
+    init();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  ColumnarPORReader::~ColumnarPORReader() {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORReader::read (const unsigned long long iOffset,
+                                const unsigned long long iSize) {
+    // The sizes are read from the file, which may be corrupted: nothing
+    // is allocated for bytes beyond the end of the file
+    if (iSize > _fileSize || iOffset > _fileSize - iSize) {
+      std::ostringstream errorStr;
+      errorStr << "the file is truncated (" << iSize << " bytes expected at "
+               << "offset " << iOffset << ", whereas the file is made of "
+               << _fileSize << " bytes)";
+      throwColumnarFileException (errorStr.str());
+    }
+
+    _buffer.resize (iSize);
+    _inputStream.clear();
+    _inputStream.seekg (iOffset);
+    if (iSize != 0) {
+      _inputStream.read (&_buffer[0], iSize);
+    }
+    if (_inputStream.fail() == true) {
+      std::ostringstream errorStr;
+      errorStr << "the file is truncated (" << iSize << " bytes expected at "
+               << "offset " << iOffset << ")";
+      throwColumnarFileException (errorStr.str());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORReader::init() {
+    const std::size_t lMagicSize = K_COLUMNAR_FILE_MAGIC.size();
+
+    // Size of the file, bounding all the reads
+    _inputStream.clear();
+    _inputStream.seekg (0, std::ios::end);
+    const std::streamoff lFileOffset = _inputStream.tellg();
+    if (lFileOffset < 0) {
+      throwColumnarFileException ("the size of the file cannot be known");
+    }
+    _fileSize = lFileOffset;
+    const unsigned long long lFileSize = _fileSize;
+
+    // Header: magic string, version and number of columns
+    read (0, lMagicSize + 8);
+    if (_buffer.compare (0, lMagicSize, K_COLUMNAR_FILE_MAGIC) != 0) {
+      throwColumnarFileException ("the header does not start with '"
+                                  + K_COLUMNAR_FILE_MAGIC + "'");
+    }
+    const unsigned long long lVersion =
+      getLittleEndian (_buffer, lMagicSize, 4);
+    if (lVersion == 0 || lVersion > K_COLUMNAR_FILE_VERSION) {
+      std::ostringstream errorStr;
+      errorStr << "the version of the file (" << lVersion
+               << ") is not supported";
+      throwColumnarFileException (errorStr.str());
+    }
+    const unsigned long long lNbOfColumns =
+      getLittleEndian (_buffer, lMagicSize + 4, 4);
+
+    // Types and names of the columns
+    unsigned long long lOffset = lMagicSize + 8;
+    for (unsigned long long idx = 0; idx != lNbOfColumns; ++idx) {
+      read (lOffset, 3);
+      const unsigned long long lValueType = getLittleEndian (_buffer, 0, 1);
+      const unsigned long long lNameSize = getLittleEndian (_buffer, 1, 2);
+      if (lValueType >= ColumnarPORColumn::LAST_VALUE_TYPE) {
+        std::ostringstream errorStr;
+        errorStr << "the type (" << lValueType << ") of the " << idx
+                 << "-th column is not known";
+        throwColumnarFileException (errorStr.str());
+      }
+      read (lOffset + 3, lNameSize);
+      _columnNameList.push_back (_buffer);
+      _columnValueTypeList.push_back
+        (static_cast<ColumnarPORColumn::EN_ValueType> (lValueType));
+      lOffset += 3 + lNameSize;
+    }
+
+    // Trailer of the footer: size of the footer and magic string
+    const std::size_t lTrailerSize = 4 + lMagicSize;
+    if (lFileSize < lOffset + lTrailerSize) {
+      throwColumnarFileException ("the file has no footer");
+    }
+    read (lFileSize - lTrailerSize, lTrailerSize);
+    if (_buffer.compare (4, lMagicSize, K_COLUMNAR_FILE_MAGIC) != 0) {
+      throwColumnarFileException ("the footer does not end with '"
+                                  + K_COLUMNAR_FILE_MAGIC + "'");
+    }
+    const unsigned long long lFooterSize = getLittleEndian (_buffer, 0, 4);
+    if (lFooterSize < 12 + lTrailerSize
+        || lFooterSize > lFileSize - lOffset
+        || (lFooterSize - 12 - lTrailerSize) % 12 != 0) {
+      throwColumnarFileException ("the size of the footer is not valid");
+    }
+
+    // Footer: offsets and numbers of rows of the row groups, numbers of
+    // row groups and of rows
+    const unsigned long long lFooterOffset = lFileSize - lFooterSize;
+    _footerOffset = lFooterOffset;
+    read (lFooterOffset, lFooterSize - lTrailerSize);
+    const std::size_t lNbOfRowGroupsPosition = _buffer.size() - 12;
+    const unsigned long long lNbOfRowGroups =
+      getLittleEndian (_buffer, lNbOfRowGroupsPosition, 4);
+    const unsigned long long lNbOfRows =
+      getLittleEndian (_buffer, lNbOfRowGroupsPosition + 4, 8);
+    if (lNbOfRowGroups * 12 != lNbOfRowGroupsPosition) {
+      throwColumnarFileException ("the number of row groups does not match "
+                                  "the size of the footer");
+    }
+
+    unsigned long long lNbOfRowsInGroups = 0;
+    for (unsigned long long idx = 0; idx != lNbOfRowGroups; ++idx) {
+      const unsigned long long lRowGroupOffset =
+        getLittleEndian (_buffer, 12 * idx, 8);
+      const NbOfDBEntries_T lNbOfRowsInGroup =
+        getLittleEndian (_buffer, 12 * idx + 8, 4);
+      if (lRowGroupOffset < lOffset || lRowGroupOffset >= lFooterOffset) {
+        std::ostringstream errorStr;
+        errorStr << "the offset of the " << idx << "-th row group ("
+                 << lRowGroupOffset << ") is out of the file";
+        throwColumnarFileException (errorStr.str());
+      }
+      _rowGroupList.push_back (std::make_pair (lRowGroupOffset,
+                                               lNbOfRowsInGroup));
+      lNbOfRowsInGroups += lNbOfRowsInGroup;
+    }
+    if (lNbOfRowsInGroups != lNbOfRows) {
+      throwColumnarFileException ("the number of rows does not match "
+                                  "the row groups");
+    }
+    _nbOfRows = lNbOfRows;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  unsigned short ColumnarPORReader::
+  getColumnIndex (const std::string& iColumnName) const {
+    for (unsigned short idx = 0; idx != _columnNameList.size(); ++idx) {
+      if (_columnNameList[idx] == iColumnName) {
+        return idx;
+      }
+    }
+
+    std::ostringstream errorStr;
+    errorStr << "The column '" << iColumnName << "' cannot be found in the "
+             << "columnar export file";
+    OPENTREP_LOG_ERROR (errorStr.str());
+    throw ObjectNotFoundException (errorStr.str());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORReader::
+  checkChunkBounds (const NbOfDBEntries_T& iRowGroupIdx,
+                    const unsigned short iColumnIdx,
+                    const unsigned long long iOffset,
+                    const unsigned long long iSize) const {
+    if (iSize > _footerOffset || iOffset > _footerOffset - iSize) {
+      std::ostringstream errorStr;
+      errorStr << "the chunk of the " << iColumnIdx << "-th column of the "
+               << iRowGroupIdx << "-th row group (" << iSize
+               << " bytes at offset " << iOffset << ") overlaps the footer "
+               << "(at offset " << _footerOffset << ")";
+      throwColumnarFileException (errorStr.str());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORReader::
+  readColumnChunk (const NbOfDBEntries_T& iRowGroupIdx,
+                   const unsigned short iColumnIdx,
+                   const ColumnarPORColumn::EN_ValueType& iValueType) {
+    const std::pair<unsigned long long, NbOfDBEntries_T>& lRowGroup =
+      _rowGroupList.at (iRowGroupIdx);
+    if (getColumnValueType (iColumnIdx) != iValueType) {
+      std::ostringstream errorStr;
+      errorStr << "The values of the '" << getColumnName (iColumnIdx)
+               << "' column are of the "
+               << ColumnarPORColumn::getValueTypeLabel
+                    (getColumnValueType (iColumnIdx))
+               << " type, not of the "
+               << ColumnarPORColumn::getValueTypeLabel (iValueType) << " one";
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SerDeException (errorStr.str());
+    }
+
+    // Number of rows of the row group
+    unsigned long long lOffset = lRowGroup.first;
+    read (lOffset, 4);
+    if (getLittleEndian (_buffer, 0, 4) != lRowGroup.second) {
+      std::ostringstream errorStr;
+      errorStr << "the number of rows of the " << iRowGroupIdx
+               << "-th row group does not match the footer";
+      throwColumnarFileException (errorStr.str());
+    }
+    lOffset += 4;
+
+    // Skip the chunks of the former columns. Every chunk, made of its size
+    // and its values, must end before the footer.
+    for (unsigned short idx = 0; idx != iColumnIdx; ++idx) {
+      read (lOffset, 8);
+      const unsigned long long lChunkSize = getLittleEndian (_buffer, 0, 8);
+      checkChunkBounds (iRowGroupIdx, idx, lOffset + 8, lChunkSize);
+      lOffset += 8 + lChunkSize;
+    }
+    read (lOffset, 8);
+    const unsigned long long lChunkSize = getLittleEndian (_buffer, 0, 8);
+    checkChunkBounds (iRowGroupIdx, iColumnIdx, lOffset + 8, lChunkSize);
+    read (lOffset + 8, lChunkSize);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORReader::readColumn (const NbOfDBEntries_T& iRowGroupIdx,
+                                      const unsigned short iColumnIdx,
+                                      std::vector<long long>& ioValueList) {
+    readColumnChunk (iRowGroupIdx, iColumnIdx, ColumnarPORColumn::INTEGER);
+    const NbOfDBEntries_T& lNbOfRows = getNbOfRowsInGroup (iRowGroupIdx);
+    if (_buffer.size() != 8ULL * lNbOfRows) {
+      throwColumnarFileException ("the size of the '"
+                                  + getColumnName (iColumnIdx)
+                                  + "' column chunk is not valid");
+    }
+
+    ioValueList.clear();
+    ioValueList.reserve (lNbOfRows);
+    for (NbOfDBEntries_T idx = 0; idx != lNbOfRows; ++idx) {
+      const unsigned long long lValue = getLittleEndian (_buffer, 8 * idx, 8);
+      ioValueList.push_back (static_cast<long long> (lValue));
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORReader::readColumn (const NbOfDBEntries_T& iRowGroupIdx,
+                                      const unsigned short iColumnIdx,
+                                      std::vector<double>& ioValueList) {
+    readColumnChunk (iRowGroupIdx, iColumnIdx, ColumnarPORColumn::FLOAT);
+    const NbOfDBEntries_T& lNbOfRows = getNbOfRowsInGroup (iRowGroupIdx);
+    if (_buffer.size() != 8ULL * lNbOfRows) {
+      throwColumnarFileException ("the size of the '"
+                                  + getColumnName (iColumnIdx)
+                                  + "' column chunk is not valid");
+    }
+
+    ioValueList.clear();
+    ioValueList.reserve (lNbOfRows);
+    for (NbOfDBEntries_T idx = 0; idx != lNbOfRows; ++idx) {
+      const unsigned long long lBits = getLittleEndian (_buffer, 8 * idx, 8);
+      double lValue = 0.0;
+      std::memcpy (&lValue, &lBits, sizeof (lValue));
+      ioValueList.push_back (lValue);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORReader::readColumn (const NbOfDBEntries_T& iRowGroupIdx,
+                                      const unsigned short iColumnIdx,
+                                      std::vector<std::string>& ioValueList) {
+    readColumnChunk (iRowGroupIdx, iColumnIdx, ColumnarPORColumn::STRING);
+    const NbOfDBEntries_T& lNbOfRows = getNbOfRowsInGroup (iRowGroupIdx);
+    const unsigned long long lOffsetListSize = 4ULL * (lNbOfRows + 1);
+    if (_buffer.size() < lOffsetListSize
+        || getLittleEndian (_buffer, 0, 4) != 0
+        || getLittleEndian (_buffer, 4 * lNbOfRows, 4)
+        != _buffer.size() - lOffsetListSize) {
+      throwColumnarFileException ("the size of the '"
+                                  + getColumnName (iColumnIdx)
+                                  + "' column chunk is not valid");
+    }
+
+    ioValueList.clear();
+    ioValueList.reserve (lNbOfRows);
+    unsigned long long lBegin = 0;
+    for (NbOfDBEntries_T idx = 0; idx != lNbOfRows; ++idx) {
+      const unsigned long long lEnd = getLittleEndian (_buffer, 4 * (idx + 1),
+                                                       4);
+      if (lEnd < lBegin) {
+        throwColumnarFileException ("the offsets of the '"
+                                    + getColumnName (iColumnIdx)
+                                    + "' column chunk are not valid");
+      }
+      ioValueList.push_back (_buffer.substr (lOffsetListSize + lBegin,
+                                             lEnd - lBegin));
+      lBegin = lEnd;
+    }
+  }
+
+}
@@ -0,0 +1,227 @@
+#ifndef __OPENTREP_BOM_COLUMNARPORREADER_HPP
+#define __OPENTREP_BOM_COLUMNARPORREADER_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <istream>
+#include <string>
+#include <vector>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/bom/ColumnarPORColumn.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * @brief Reader of the columnar export files of the POR (points of
+   *        reference), as written by ColumnarPORWriter.
+   *
+   * The header and the footer are read by the constructor; the columns
+   * are then read one at a time, for a given row group, without decoding
+   * the other columns of that row group. The columns are known by their
+   * names, as stored in the header, so that files written by later
+   * versions, with more columns, can still be read.
+   *
+   * An exception (SerDeException) is thrown when the file is not
+   * a columnar export file, or when it is truncated or corrupted.
+   *
+   * \note The reader is not thread-safe, as it moves within the input
+   *       stream: several threads should use several readers.
+   */
+  class ColumnarPORReader {
+  public:
+    // ////////////////// Getters ////////////////////
+    /**
+     * Get the number of columns.
+     */
+    unsigned short getNbOfColumns() const {
+      return _columnNameList.size();
+    }
+
+    /**
+     * Get the name of the given column (e.g., "iata_code").
+     */
+    const std::string& getColumnName (const unsigned short iColumnIdx) const {
+      return _columnNameList.at (iColumnIdx);
+    }
+
+    /**
+     * Get the type of the values of the given column.
+     */
+    ColumnarPORColumn::EN_ValueType
+    getColumnValueType (const unsigned short iColumnIdx) const {
+      return _columnValueTypeList.at (iColumnIdx);
+    }
+
+    /**
+     * Get the number of row groups.
+     */
+    NbOfDBEntries_T getNbOfRowGroups() const {
+      return _rowGroupList.size();
+    }
+
+    /**
+     * Get the number of rows of the given row group.
+     */
+    const NbOfDBEntries_T&
+    getNbOfRowsInGroup (const NbOfDBEntries_T& iRowGroupIdx) const {
+      return _rowGroupList.at (iRowGroupIdx).second;
+    }
+
+    /**
+     * Get the total number of rows (POR).
+     */
+    const NbOfDBEntries_T& getNbOfRows() const {
+      return _nbOfRows;
+    }
+
+
+  public:
+    // ////////////////// Business methods ////////////////////
+    /**
+     * Get the index of the column having the given name.
+     *
+     * An exception (ObjectNotFoundException) is thrown when there is no
+     * such column.
+     *
+     * @param const std::string& Name of the column (e.g., "iata_code").
+     * @return unsigned short Index of the column.
+     */
+    unsigned short getColumnIndex (const std::string&) const;
+
+    /**
+     * Read the values of an integer column, for the given row group.
+     *
+     * @param const NbOfDBEntries_T& Index of the row group.
+     * @param const unsigned short Index of the column.
+     * @param std::vector<long long>& Values of the column (emptied first).
+     */
+    void readColumn (const NbOfDBEntries_T&, const unsigned short,
+                     std::vector<long long>&);
+
+    /**
+     * Read the values of a floating point column, for the given row group.
+     *
+     * @param const NbOfDBEntries_T& Index of the row group.
+     * @param const unsigned short Index of the column.
+     * @param std::vector<double>& Values of the column (emptied first).
+     */
+    void readColumn (const NbOfDBEntries_T&, const unsigned short,
+                     std::vector<double>&);
+
+    /**
+     * Read the values of a string column, for the given row group.
+     *
+     * @param const NbOfDBEntries_T& Index of the row group.
+     * @param const unsigned short Index of the column.
+     * @param std::vector<std::string>& Values of the column (emptied first).
+     */
+    void readColumn (const NbOfDBEntries_T&, const unsigned short,
+                     std::vector<std::string>&);
+
+
+  public:
+    // ////////////////// Constructors and Destructors ////////////////////
+    /**
+     * Main constructor. The header and the footer are read at that stage.
+     *
+     * @param std::istream& Input (binary, seekable) stream.
+     */
+    ColumnarPORReader (std::istream&);
+
+    /**
+     * Destructor.
+     */
+    ~ColumnarPORReader();
+
+  private:
+    /**
+     * Default constructor.
+     */
+    ColumnarPORReader();
+
+    /**
+     * Copy constructor.
+     */
+    ColumnarPORReader (const ColumnarPORReader&);
+
+
+  private:
+    /**
+     * Read the header and the footer.
+     */
+    void init();
+
+    /**
+     * Read the given number of bytes, at the given offset, into the buffer.
+     * The bytes must lie within the file: the sizes read from the file
+     * are checked before any memory be allocated for them.
+     */
+    void read (const unsigned long long iOffset,
+               const unsigned long long iSize);
+
+    /**
+     * Check that the given chunk (offset and size, as read from the file)
+     * of the given row group lies before the footer.
+     */
+    void checkChunkBounds (const NbOfDBEntries_T& iRowGroupIdx,
+                           const unsigned short iColumnIdx,
+                           const unsigned long long iOffset,
+                           const unsigned long long iSize) const;
+
+    /**
+     * Read, into the buffer, the chunk of the given column for the given
+     * row group, checking the type of its values.
+     */
+    void readColumnChunk (const NbOfDBEntries_T& iRowGroupIdx,
+                          const unsigned short iColumnIdx,
+                          const ColumnarPORColumn::EN_ValueType&);
+
+
+  private:
+    // /////////////////////// Attributes //////////////////////
+    /**
+     * Input stream.
+     */
+    std::istream& _inputStream;
+
+    /**
+     * Names of the columns.
+     */
+    std::vector<std::string> _columnNameList;
+
+    /**
+     * Value types of the columns.
+     */
+    std::vector<ColumnarPORColumn::EN_ValueType> _columnValueTypeList;
+
+    /**
+     * Offsets and numbers of rows of the row groups.
+     */
+    std::vector<std::pair<unsigned long long, NbOfDBEntries_T> > _rowGroupList;
+
+    /**
+     * Total number of rows.
+     */
+    NbOfDBEntries_T _nbOfRows;
+
+    /**
+     * Size of the file, in bytes.
+     */
+    unsigned long long _fileSize;
+
+    /**
+     * Offset of the footer, i.e., end of the row groups.
+     */
+    unsigned long long _footerOffset;
+
+    /**
+     * Buffer re-used from one read to another.
+     */
+    std::string _buffer;
+  };
+
+}
+#endif // __OPENTREP_BOM_COLUMNARPORREADER_HPP
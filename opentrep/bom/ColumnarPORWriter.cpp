@@ -0,0 +1,358 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+// OpenTrep
+#include <opentrep/Location.hpp>
+#include <opentrep/CityDetails.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/bom/ColumnarPORWriter.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * Append an unsigned integer of the given number of bytes,
+   * in little-endian order.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void appendLittleEndian (std::string& ioBuffer,
+                           const unsigned long long iValue,
+                           const unsigned short iNbOfBytes) {
+    for (unsigned short idx = 0; idx != iNbOfBytes; ++idx) {
+      ioBuffer.push_back (static_cast<char> ((iValue >> (8 * idx)) & 0xFF));
+    }
+  }
+
+  /**
+   * Overwrite, in little-endian order, the unsigned integer of the given
+   * number of bytes located at the given position.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void setLittleEndian (std::string& ioBuffer, const std::size_t iPosition,
+                        const unsigned long long iValue,
+                        const unsigned short iNbOfBytes) {
+    assert (iPosition + iNbOfBytes <= ioBuffer.size());
+    for (unsigned short idx = 0; idx != iNbOfBytes; ++idx) {
+      ioBuffer[iPosition + idx] =
+        static_cast<char> ((iValue >> (8 * idx)) & 0xFF);
+    }
+  }
+
+  /**
+   * Get a date as a YYYYMMDD number (e.g., 20140301), 0 when not available.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  long long getDateAsNumber (const Date_T& iDate) {
+    if (iDate.is_special() == true) {
+      return 0;
+    }
+    const long long oDate = iDate.year() * 10000LL + iDate.month() * 100LL
+      + iDate.day();
+    return oDate;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  ColumnarPORWriter::ColumnarPORWriter (std::ostream& ioOutputStream)
+    : _outputStream (ioOutputStream), _offset (0), _nbOfRows (0),
+      _isClosed (false) {
+
+    // Header: magic string, version, and names and types of the columns
+    std::string lHeader (K_COLUMNAR_FILE_MAGIC);
+    appendLittleEndian (lHeader, K_COLUMNAR_FILE_VERSION, 4);
+    appendLittleEndian (lHeader, ColumnarPORColumn::LAST_VALUE, 4);
+    for (unsigned short idx = 0; idx != ColumnarPORColumn::LAST_VALUE; ++idx) {
+      const ColumnarPORColumn::EN_Column lColumn =
+        static_cast<ColumnarPORColumn::EN_Column> (idx);
+      const std::string& lName = ColumnarPORColumn::getLabel (lColumn);
+      appendLittleEndian (lHeader, ColumnarPORColumn::getValueType (lColumn),
+                          1);
+      appendLittleEndian (lHeader, lName.size(), 2);
+      lHeader.append (lName);
+    }
+    write (lHeader);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  ColumnarPORWriter::~ColumnarPORWriter() {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORWriter::write (const std::string& iBytes) {
+    _outputStream.write (iBytes.data(), iBytes.size());
+    if (_outputStream.fail() == true) {
+      std::ostringstream errorStr;
+      errorStr << "Error when writing " << iBytes.size() << " bytes at "
+               << "offset " << _offset << " of the columnar export file";
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw FileException (errorStr.str());
+    }
+    _offset += iBytes.size();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  long long ColumnarPORWriter::
+  getIntegerValue (const Location& iLocation,
+                   const ColumnarPORColumn::EN_Column& iColumn) {
+    long long oValue = 0;
+    switch (iColumn) {
+    case ColumnarPORColumn::IS_GEONAMES:
+      oValue = (iLocation.isGeonames() == true)?1:0; break;
+    case ColumnarPORColumn::GEONAME_ID:
+      oValue = iLocation.getGeonamesID(); break;
+    case ColumnarPORColumn::ENVELOPE_ID:
+      oValue = iLocation.getEnvelopeID(); break;
+    case ColumnarPORColumn::DATE_FROM:
+      oValue = getDateAsNumber (iLocation.getDateFrom()); break;
+    case ColumnarPORColumn::DATE_UNTIL:
+      oValue = getDateAsNumber (iLocation.getDateEnd()); break;
+    case ColumnarPORColumn::POPULATION:
+      oValue = iLocation.getPopulation(); break;
+    case ColumnarPORColumn::ELEVATION:
+      oValue = iLocation.getElevation(); break;
+    case ColumnarPORColumn::GTOPO30:
+      oValue = iLocation.getGTopo30(); break;
+    case ColumnarPORColumn::MODIFICATION_DATE:
+      oValue = getDateAsNumber (iLocation.getModificationDate()); break;
+    case ColumnarPORColumn::WAC:
+      oValue = iLocation.getWAC(); break;
+    default: assert (false); break;
+    }
+    return oValue;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  double ColumnarPORWriter::
+  getFloatValue (const Location& iLocation,
+                 const ColumnarPORColumn::EN_Column& iColumn) {
+    double oValue = 0.0;
+    switch (iColumn) {
+    case ColumnarPORColumn::LATITUDE:
+      oValue = iLocation.getLatitude(); break;
+    case ColumnarPORColumn::LONGITUDE:
+      oValue = iLocation.getLongitude(); break;
+    case ColumnarPORColumn::PAGE_RANK:
+      oValue = iLocation.getPageRank(); break;
+    case ColumnarPORColumn::GMT_OFFSET:
+      oValue = iLocation.getGMTOffset(); break;
+    case ColumnarPORColumn::DST_OFFSET:
+      oValue = iLocation.getDSTOffset(); break;
+    case ColumnarPORColumn::RAW_OFFSET:
+      oValue = iLocation.getRawOffset(); break;
+    case ColumnarPORColumn::GEONAME_LATITUDE:
+      oValue = iLocation.getGeonameLatitude(); break;
+    case ColumnarPORColumn::GEONAME_LONGITUDE:
+      oValue = iLocation.getGeonameLongitude(); break;
+    default: assert (false); break;
+    }
+    return oValue;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORWriter::
+  appendStringValue (std::string& ioBytes, const Location& iLocation,
+                     const ColumnarPORColumn::EN_Column& iColumn) {
+    switch (iColumn) {
+    case ColumnarPORColumn::IATA_CODE:
+      ioBytes.append (iLocation.getIataCode()); break;
+    case ColumnarPORColumn::ICAO_CODE:
+      ioBytes.append (iLocation.getIcaoCode()); break;
+    case ColumnarPORColumn::FAA_CODE:
+      ioBytes.append (iLocation.getFaaCode()); break;
+    case ColumnarPORColumn::NAME:
+      ioBytes.append (iLocation.getCommonName()); break;
+    case ColumnarPORColumn::ASCII_NAME:
+      ioBytes.append (iLocation.getAsciiName()); break;
+    case ColumnarPORColumn::FEATURE_CLASS:
+      ioBytes.append (iLocation.getFeatureClass()); break;
+    case ColumnarPORColumn::FEATURE_CODE:
+      ioBytes.append (iLocation.getFeatureCode()); break;
+    case ColumnarPORColumn::COUNTRY_CODE:
+      ioBytes.append (iLocation.getCountryCode()); break;
+    case ColumnarPORColumn::ALT_COUNTRY_CODE:
+      ioBytes.append (iLocation.getAltCountryCode()); break;
+    case ColumnarPORColumn::COUNTRY_NAME:
+      ioBytes.append (iLocation.getCountryName()); break;
+    case ColumnarPORColumn::CONTINENT_CODE:
+      ioBytes.append (iLocation.getContinentCode()); break;
+    case ColumnarPORColumn::CONTINENT_NAME:
+      ioBytes.append (iLocation.getContinentName()); break;
+    case ColumnarPORColumn::ADM1_CODE:
+      ioBytes.append (iLocation.getAdmin1Code()); break;
+    case ColumnarPORColumn::ADM1_NAME_UTF:
+      ioBytes.append (iLocation.getAdmin1UtfName()); break;
+    case ColumnarPORColumn::ADM1_NAME_ASCII:
+      ioBytes.append (iLocation.getAdmin1AsciiName()); break;
+    case ColumnarPORColumn::ADM2_CODE:
+      ioBytes.append (iLocation.getAdmin2Code()); break;
+    case ColumnarPORColumn::ADM2_NAME_UTF:
+      ioBytes.append (iLocation.getAdmin2UtfName()); break;
+    case ColumnarPORColumn::ADM2_NAME_ASCII:
+      ioBytes.append (iLocation.getAdmin2AsciiName()); break;
+    case ColumnarPORColumn::ADM3_CODE:
+      ioBytes.append (iLocation.getAdmin3Code()); break;
+    case ColumnarPORColumn::ADM4_CODE:
+      ioBytes.append (iLocation.getAdmin4Code()); break;
+    case ColumnarPORColumn::TIME_ZONE:
+      ioBytes.append (iLocation.getTimeZone()); break;
+    case ColumnarPORColumn::TVL_POR_LIST:
+      ioBytes.append (iLocation.getTvlPORListString()); break;
+    case ColumnarPORColumn::STATE_CODE:
+      ioBytes.append (iLocation.getStateCode()); break;
+    case ColumnarPORColumn::LOCATION_TYPE:
+      ioBytes.append (iLocation.getIataType().getTypeAsString()); break;
+    case ColumnarPORColumn::WIKI_LINK:
+      ioBytes.append (iLocation.getWikiLink()); break;
+    case ColumnarPORColumn::WAC_NAME:
+      ioBytes.append (iLocation.getWACName()); break;
+    case ColumnarPORColumn::CURRENCY_CODE:
+      ioBytes.append (iLocation.getCurrencyCode()); break;
+
+    case ColumnarPORColumn::CITY_CODE_LIST: {
+      const CityDetailsList_T& lCityList = iLocation.getCityList();
+      for (CityDetailsList_T::const_iterator itCity = lCityList.begin();
+           itCity != lCityList.end(); ++itCity) {
+        if (itCity != lCityList.begin()) {
+          ioBytes.push_back (',');
+        }
+        ioBytes.append (itCity->getIataCode());
+      }
+      break;
+    }
+
+    case ColumnarPORColumn::UNLOCODE_LIST: {
+      const UNLOCodeList_T& lUNLOCodeList = iLocation.getUNLOCodeList();
+      for (UNLOCodeList_T::const_iterator itCode = lUNLOCodeList.begin();
+           itCode != lUNLOCodeList.end(); ++itCode) {
+        if (itCode != lUNLOCodeList.begin()) {
+          ioBytes.push_back (',');
+        }
+        ioBytes.append (*itCode);
+      }
+      break;
+    }
+
+    case ColumnarPORColumn::UIC_CODE_LIST: {
+      const UICCodeList_T& lUICCodeList = iLocation.getUICCodeList();
+      for (UICCodeList_T::const_iterator itCode = lUICCodeList.begin();
+           itCode != lUICCodeList.end(); ++itCode) {
+        if (itCode != lUICCodeList.begin()) {
+          ioBytes.push_back (',');
+        }
+        char lCodeStr[16];
+        const int lCodeLength = snprintf (lCodeStr, sizeof (lCodeStr), "%u",
+                                          *itCode);
+        ioBytes.append (lCodeStr, lCodeLength);
+      }
+      break;
+    }
+
+    default: assert (false); break;
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORWriter::encodeRowGroup (const LocationList_T& iLocationList,
+                                          std::string& ioRowGroup) {
+    ioRowGroup.clear();
+    appendLittleEndian (ioRowGroup, iLocationList.size(), 4);
+
+    // The bytes of the string columns are gathered aside, and appended
+    // after the offsets
+    std::string lBytes;
+    for (unsigned short idx = 0; idx != ColumnarPORColumn::LAST_VALUE; ++idx) {
+      const ColumnarPORColumn::EN_Column lColumn =
+        static_cast<ColumnarPORColumn::EN_Column> (idx);
+
+      // The size of the column chunk is known only once it is encoded
+      const std::size_t lSizePosition = ioRowGroup.size();
+      appendLittleEndian (ioRowGroup, 0, 8);
+
+      switch (ColumnarPORColumn::getValueType (lColumn)) {
+      case ColumnarPORColumn::INTEGER: {
+        for (LocationList_T::const_iterator itLocation = iLocationList.begin();
+             itLocation != iLocationList.end(); ++itLocation) {
+          const long long lValue = getIntegerValue (*itLocation, lColumn);
+          appendLittleEndian (ioRowGroup,
+                              static_cast<unsigned long long> (lValue), 8);
+        }
+        break;
+      }
+
+      case ColumnarPORColumn::FLOAT: {
+        for (LocationList_T::const_iterator itLocation = iLocationList.begin();
+             itLocation != iLocationList.end(); ++itLocation) {
+          const double lValue = getFloatValue (*itLocation, lColumn);
+          unsigned long long lBits = 0;
+          std::memcpy (&lBits, &lValue, sizeof (lBits));
+          appendLittleEndian (ioRowGroup, lBits, 8);
+        }
+        break;
+      }
+
+      case ColumnarPORColumn::STRING: {
+        lBytes.clear();
+        appendLittleEndian (ioRowGroup, 0, 4);
+        for (LocationList_T::const_iterator itLocation = iLocationList.begin();
+             itLocation != iLocationList.end(); ++itLocation) {
+          appendStringValue (lBytes, *itLocation, lColumn);
+          appendLittleEndian (ioRowGroup, lBytes.size(), 4);
+        }
+        ioRowGroup.append (lBytes);
+        break;
+      }
+
+      default: assert (false); break;
+      }
+
+      const std::size_t lColumnSize = ioRowGroup.size() - lSizePosition - 8;
+      setLittleEndian (ioRowGroup, lSizePosition, lColumnSize, 8);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORWriter::writeRowGroup (const std::string& iRowGroup,
+                                         const NbOfDBEntries_T& iNbOfRows) {
+    assert (_isClosed == false);
+    _rowGroupList.push_back (std::make_pair (_offset, iNbOfRows));
+    write (iRowGroup);
+    _nbOfRows += iNbOfRows;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORWriter::writeRowGroup (const LocationList_T& iLocationList) {
+    encodeRowGroup (iLocationList, _buffer);
+    writeRowGroup (_buffer, iLocationList.size());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarPORWriter::close() {
+    assert (_isClosed == false);
+
+    // Footer: offsets and sizes of the row groups, numbers of row groups
+    // and of rows, size of the footer, and magic string
+    std::string lFooter;
+    for (std::vector<std::pair<unsigned long long,
+           NbOfDBEntries_T> >::const_iterator itRowGroup =
+           _rowGroupList.begin();
+         itRowGroup != _rowGroupList.end(); ++itRowGroup) {
+      appendLittleEndian (lFooter, itRowGroup->first, 8);
+      appendLittleEndian (lFooter, itRowGroup->second, 4);
+    }
+    appendLittleEndian (lFooter, _rowGroupList.size(), 4);
+    appendLittleEndian (lFooter, _nbOfRows, 8);
+    const std::size_t lFooterSize =
+      lFooter.size() + 4 + K_COLUMNAR_FILE_MAGIC.size();
+    appendLittleEndian (lFooter, lFooterSize, 4);
+    lFooter.append (K_COLUMNAR_FILE_MAGIC);
+    write (lFooter);
+
+    _outputStream.flush();
+    _isClosed = true;
+  }
+
+}
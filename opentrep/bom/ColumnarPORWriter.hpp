@@ -0,0 +1,190 @@
+#ifndef __OPENTREP_BOM_COLUMNARPORWRITER_HPP
+#define __OPENTREP_BOM_COLUMNARPORWRITER_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <ostream>
+#include <string>
+#include <vector>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/LocationList.hpp>
+#include <opentrep/bom/ColumnarPORColumn.hpp>
+
+namespace OPENTREP {
+
+  // Forward declarations
+  struct Location;
+
+  /**
+   * @brief Writer of the columnar export files of the POR (points of
+   *        reference).
+   *
+   * The POR are stored by row groups (of a few thousands of POR each),
+   * and, within every row group, column after column (see
+   * ColumnarPORColumn), so that a reader may retrieve a few columns
+   * without decoding the others. All the numbers are little-endian:
+   * <ul>
+   *   <li>header: magic string ("OTREPCOL", 8 bytes), version (uint32),
+   *       number of columns (uint32) and, for every column, value type
+   *       (uint8), length (uint16) and bytes of its name;</li>
+   *   <li>row groups: number of rows (uint32) and, for every column,
+   *       size in bytes (uint64) of the column chunk, followed by the
+   *       values. The integers are stored as int64, the floating point
+   *       numbers as IEEE 754 binary64, and the strings as (number of
+   *       rows + 1) uint32 offsets followed by the concatenated bytes;</li>
+   *   <li>footer: for every row group, offset in the file (uint64) and
+   *       number of rows (uint32), followed by the number of row groups
+   *       (uint32), the total number of rows (uint64), the size of the
+   *       footer (uint32) and the magic string again.</li>
+   * </ul>
+   *
+   * The row groups may be encoded by several threads at once
+   * (see encodeRowGroup()), but must be written by a single one.
+   *
+   * \see ColumnarPORReader for the reading of those files.
+   */
+  class ColumnarPORWriter {
+  public:
+    // ////////////////// Getters ////////////////////
+    /**
+     * Get the number of rows (POR) written so far.
+     */
+    const NbOfDBEntries_T& getNbOfRows() const {
+      return _nbOfRows;
+    }
+
+    /**
+     * Get the number of row groups written so far.
+     */
+    NbOfDBEntries_T getNbOfRowGroups() const {
+      return _rowGroupList.size();
+    }
+
+
+  public:
+    // ////////////////// Business methods ////////////////////
+    /**
+     * Encode a list of Location structures as a row group, into the
+     * given buffer, which is emptied first.
+     *
+     * The method does not depend on any writer, and may be called by
+     * several threads at once.
+     *
+     * @param const LocationList_T& List of the Location structures.
+     * @param std::string& Buffer receiving the encoded row group.
+     */
+    static void encodeRowGroup (const LocationList_T&, std::string&);
+
+    /**
+     * Write a row group, as encoded by encodeRowGroup().
+     *
+     * @param const std::string& Encoded row group.
+     * @param const NbOfDBEntries_T& Number of rows of the row group.
+     */
+    void writeRowGroup (const std::string&, const NbOfDBEntries_T&);
+
+    /**
+     * Encode and write a list of Location structures as a row group.
+     *
+     * @param const LocationList_T& List of the Location structures.
+     */
+    void writeRowGroup (const LocationList_T&);
+
+    /**
+     * Write the footer, and flush the output stream. No row group can be
+     * written afterwards.
+     */
+    void close();
+
+
+  public:
+    // ////////////////// Constructors and Destructors ////////////////////
+    /**
+     * Main constructor. The header is written at that stage.
+     *
+     * @param std::ostream& Output (binary) stream.
+     */
+    ColumnarPORWriter (std::ostream&);
+
+    /**
+     * Destructor. The writer must have been closed beforehand, for the
+     * file to be readable.
+     */
+    ~ColumnarPORWriter();
+
+  private:
+    /**
+     * Default constructor.
+     */
+    ColumnarPORWriter();
+
+    /**
+     * Copy constructor.
+     */
+    ColumnarPORWriter (const ColumnarPORWriter&);
+
+
+  private:
+    /**
+     * Get the value of an integer column for the given Location structure.
+     */
+    static long long getIntegerValue (const Location&,
+                                      const ColumnarPORColumn::EN_Column&);
+
+    /**
+     * Get the value of a floating point column for the given Location
+     * structure.
+     */
+    static double getFloatValue (const Location&,
+                                 const ColumnarPORColumn::EN_Column&);
+
+    /**
+     * Append the value of a string column for the given Location structure.
+     */
+    static void appendStringValue (std::string&, const Location&,
+                                   const ColumnarPORColumn::EN_Column&);
+
+    /**
+     * Write the given bytes to the output stream.
+     */
+    void write (const std::string&);
+
+
+  private:
+    // /////////////////////// Attributes //////////////////////
+    /**
+     * Output stream.
+     */
+    std::ostream& _outputStream;
+
+    /**
+     * Number of bytes written so far, i.e., offset of the next row group.
+     */
+    unsigned long long _offset;
+
+    /**
+     * Offsets and numbers of rows of the row groups written so far.
+     */
+    std::vector<std::pair<unsigned long long, NbOfDBEntries_T> > _rowGroupList;
+
+    /**
+     * Number of rows written so far.
+     */
+    NbOfDBEntries_T _nbOfRows;
+
+    /**
+     * Whether the footer has been written.
+     */
+    bool _isClosed;
+
+    /**
+     * Buffer re-used from one encoded row group to another.
+     */
+    std::string _buffer;
+  };
+
+}
+#endif // __OPENTREP_BOM_COLUMNARPORWRITER_HPP
@@ -3,10 +3,20 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <cassert>
+#include <cstdio>
 #include <sstream>
 #include <string>
+#include <vector>
+// Boost
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/tss.hpp>
+// Protobuf
+#include <google/protobuf/arena.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream.h>
 // OpenTrep Protobuf
 #include <opentrep/Travel.pb.h>
+#include <opentrep/PlaceRecord.pb.h>
 // OpenTrep
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
@@ -14,14 +24,103 @@
 
 namespace OPENTREP {
   
+  /**
+   * Protobuf structure, in which the lists of Location objects are exported,
+   * kept by every thread from one export to another.
+   *
+   * Clearing a (proto3) Protobuf structure allocated on an arena does not
+   * re-use its sub-structures, but leaves them within the arena. Hence,
+   * the Protobuf structure is rather built again, for every export, on the
+   * (reset) arena. As the memory block given to the arena is extended up
+   * to the size needed by the largest export, the Protobuf structures end
+   * up being built without any memory allocation, but for their strings.
+   */
+  struct ThreadQueryAnswer {
+    /**
+     * Constructor.
+     */
+    ThreadQueryAnswer()
+      : _arenaBlock (K_INITIAL_ARENA_BLOCK_SIZE), _queryAnswer (NULL) {
+    }
+
+    /**
+     * Build an empty Protobuf structure, on the arena, once reset.
+     */
+    treppb::QueryAnswer& reset() {
+      if (_arena.get() != NULL) {
+        const std::size_t lSpaceAllocated = _arena->SpaceAllocated();
+        if (lSpaceAllocated > _arenaBlock.size()) {
+          // The arena had to allocate other memory blocks: its own block
+          // is extended, so that it is enough for the next exports
+          _arena.reset();
+          std::vector<char> (lSpaceAllocated).swap (_arenaBlock);
+
+        } else {
+          _arena->Reset();
+        }
+      }
+
+      if (_arena.get() == NULL) {
+        google::protobuf::ArenaOptions lArenaOptions;
+        lArenaOptions.initial_block = &_arenaBlock[0];
+        lArenaOptions.initial_block_size = _arenaBlock.size();
+        _arena.reset (new google::protobuf::Arena (lArenaOptions));
+      }
+      assert (_arena.get() != NULL);
+
+      _queryAnswer = google::protobuf::Arena::
+        CreateMessage<treppb::QueryAnswer> (_arena.get());
+      assert (_queryAnswer != NULL);
+      return *_queryAnswer;
+    }
+
+    /**
+     * Size of the memory block first given to the arena.
+     */
+    static const std::size_t K_INITIAL_ARENA_BLOCK_SIZE = 64 * 1024;
+
+    /**
+     * Memory block of the arena (released after the arena).
+     */
+    std::vector<char> _arenaBlock;
+
+    /**
+     * Arena, in which the Protobuf structure is allocated.
+     */
+    boost::scoped_ptr<google::protobuf::Arena> _arena;
+
+    /**
+     * Protobuf structure of the last export (NULL before the first one).
+     */
+    treppb::QueryAnswer* _queryAnswer;
+  };
+
+  /**
+   * Protobuf structures of the threads exporting lists of Location objects.
+   */
+  static boost::thread_specific_ptr<ThreadQueryAnswer> _threadQueryAnswer;
+
+  /**
+   * Helper function retrieving the Protobuf structure of the current thread.
+   */
   // //////////////////////////////////////////////////////////////////////
-  std::string LocationExchange::
-  exportLocationList (const LocationList_T& iLocationList,
-                      const WordList_T& iNonMatchedWordList) {
-    std::string oStr ("");
-    
-    // Protobuf structure
-    treppb::QueryAnswer lQueryAnswer;
+  ThreadQueryAnswer& getThreadQueryAnswer() {
+    ThreadQueryAnswer* lThreadQueryAnswer_ptr = _threadQueryAnswer.get();
+    if (lThreadQueryAnswer_ptr == NULL) {
+      lThreadQueryAnswer_ptr = new ThreadQueryAnswer();
+      _threadQueryAnswer.reset (lThreadQueryAnswer_ptr);
+    }
+    assert (lThreadQueryAnswer_ptr != NULL);
+    return *lThreadQueryAnswer_ptr;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  treppb::QueryAnswer& LocationExchange::
+  buildQueryAnswer (const LocationList_T& iLocationList,
+                    const WordList_T& iNonMatchedWordList) {
+    // Protobuf structure, built on the arena of the current thread
+    ThreadQueryAnswer& lThreadQueryAnswer = getThreadQueryAnswer();
+    treppb::QueryAnswer& lQueryAnswer = lThreadQueryAnswer.reset();
     
     // //// 1. Status ////
     const bool kOKStatus = true;
@@ -66,18 +165,160 @@ namespace OPENTREP {
       lUnknownKeywordListPtr->add_word (lWord);
     }
 
+    return lQueryAnswer;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::size_t LocationExchange::
+  prepareLocationList (const LocationList_T& iLocationList,
+                       const WordList_T& iNonMatchedWordList) {
+    const treppb::QueryAnswer& lQueryAnswer =
+      buildQueryAnswer (iLocationList, iNonMatchedWordList);
+
+    // Compute (and cache within the Protobuf structure) the size
+    // of the serialisation
+    const std::size_t oPBSize = lQueryAnswer.ByteSizeLong();
+    return oPBSize;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void LocationExchange::
+  serialisePreparedLocationList (char* oPBBuffer, const std::size_t iPBSize) {
+    const treppb::QueryAnswer* lQueryAnswer_ptr =
+      getThreadQueryAnswer()._queryAnswer;
+    if (lQueryAnswer_ptr == NULL) {
+      std::ostringstream errStr;
+      errStr << "Error - No OPTD Travel protocol buffer object has been "
+             << "prepared for serialization";
+      throw SerDeException (errStr.str());
+    }
+    const treppb::QueryAnswer& lQueryAnswer = *lQueryAnswer_ptr;
+
+    // Serialize the Protobuf, relying on the sizes cached by
+    // prepareLocationList()
+    const std::size_t lCachedSize = lQueryAnswer.GetCachedSize();
+    if (oPBBuffer == NULL || lCachedSize > iPBSize) {
+      std::ostringstream errStr;
+      errStr << "Error - The OPTD Travel protocol buffer object ("
+             << lCachedSize << " bytes) cannot be serialized into a buffer of "
+             << iPBSize << " bytes";
+      throw SerDeException (errStr.str());
+    }
+
+    google::protobuf::uint8* lPBBuffer =
+      reinterpret_cast<google::protobuf::uint8*> (oPBBuffer);
+    lQueryAnswer.SerializeWithCachedSizesToArray (lPBBuffer);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void LocationExchange::
+  exportLocationList (std::string& ioPBBuffer,
+                      const LocationList_T& iLocationList,
+                      const WordList_T& iNonMatchedWordList) {
+    const std::size_t lPBSize = prepareLocationList (iLocationList,
+                                                     iNonMatchedWordList);
+
+    // The capacity of the buffer is kept when it is resized
+    ioPBBuffer.resize (lPBSize);
+    if (lPBSize != 0) {
+      serialisePreparedLocationList (&ioPBBuffer[0], lPBSize);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void LocationExchange::exportError (std::string& ioPBBuffer,
+                                      const std::string& iErrorMessage) {
+    // Protobuf structure, built on the arena of the current thread
+    ThreadQueryAnswer& lThreadQueryAnswer = getThreadQueryAnswer();
+    treppb::QueryAnswer& lQueryAnswer = lThreadQueryAnswer.reset();
+
+    // //// 1. Status ////
+    const bool kKOStatus = false;
+    lQueryAnswer.set_ok_status (kKOStatus);
+
+    // //// 2. Error message ////
+    treppb::ErrorMessage* lErrorMessagePtr = lQueryAnswer.mutable_error_msg();
+    assert (lErrorMessagePtr != NULL);
+    lErrorMessagePtr->set_msg (iErrorMessage);
+
+    // The capacity of the buffer is kept when it is resized
+    const std::size_t lPBSize = lQueryAnswer.ByteSizeLong();
+    ioPBBuffer.resize (lPBSize);
+    if (lPBSize != 0) {
+      serialisePreparedLocationList (&ioPBBuffer[0], lPBSize);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void LocationExchange::appendQueryAnswer (std::string& ioPBBatchBuffer,
+                                            const std::string& iPBAnswer) {
+    // Key of the query_answer field (number 1) of QueryAnswerList,
+    // that field being length-delimited (wire type 2)
+    const google::protobuf::uint32 lQueryAnswerTag = (1 << 3) | 2;
+
+    // The key and the size of the answer are encoded as varints
+    google::protobuf::uint8 lPrefix[16];
+    google::protobuf::uint8* lPrefixEnd =
+      google::protobuf::io::CodedOutputStream::WriteTagToArray (lQueryAnswerTag,
+                                                                lPrefix);
+    lPrefixEnd = google::protobuf::io::CodedOutputStream::
+      WriteVarint32ToArray (static_cast<google::protobuf::uint32>
+                            (iPBAnswer.size()), lPrefixEnd);
+
+    ioPBBatchBuffer.append (reinterpret_cast<const char*> (lPrefix),
+                            lPrefixEnd - lPrefix);
+    ioPBBatchBuffer.append (iPBAnswer);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void LocationExchange::
+  exportLocationList (google::protobuf::io::ZeroCopyOutputStream& ioPBStream,
+                      const LocationList_T& iLocationList,
+                      const WordList_T& iNonMatchedWordList) {
+    const treppb::QueryAnswer& lQueryAnswer =
+      buildQueryAnswer (iLocationList, iNonMatchedWordList);
+
     // Serialize the Protobuf
-    const bool pbSerialStatus = lQueryAnswer.SerializeToString (&oStr);
+    const bool pbSerialStatus =
+      lQueryAnswer.SerializeToZeroCopyStream (&ioPBStream);
     if (pbSerialStatus == false) {
       std::ostringstream errStr;
       errStr << "Error - The OPTD Travel protocol buffer object cannot be "
-             << "serialized into a C++ string";
+             << "serialized into the given output stream";
       throw SerDeException (errStr.str());
     }
-    
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string LocationExchange::
+  exportLocationList (const LocationList_T& iLocationList,
+                      const WordList_T& iNonMatchedWordList) {
+    std::string oStr ("");
+    exportLocationList (oStr, iLocationList, iNonMatchedWordList);
     return oStr;
   }
 
+  /**
+   * Helper function setting a Protobuf date in the ISO 8601 extended format
+   * (e.g., 2012-01-01). The string of the Protobuf structure is re-used,
+   * rather than being replaced by a temporary string.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void setISODate (treppb::Date& ioPBDate, const Date_T& iDate) {
+    if (iDate.is_special() == true) {
+      ioPBDate.set_date (boost::gregorian::to_iso_extended_string (iDate));
+      return;
+    }
+
+    const Date_T::ymd_type lYMD = iDate.year_month_day();
+    char lDateStr[16];
+    std::snprintf (lDateStr, sizeof (lDateStr), "%04u-%02u-%02u",
+                   static_cast<unsigned int> (lYMD.year),
+                   static_cast<unsigned int> (lYMD.month),
+                   static_cast<unsigned int> (lYMD.day));
+    ioPBDate.set_date (lDateStr);
+  }
+
   // //////////////////////////////////////////////////////////////////////
   void LocationExchange::exportLocation (treppb::Place& ioPlace,
                                          const Location& iLocation) {
@@ -171,9 +412,7 @@ namespace OPENTREP {
     const Date_T& lGeonameModDate = iLocation.getModificationDate();
     treppb::Date* lGeonameModDatePtr = ioPlace.mutable_mod_date();
     assert (lGeonameModDatePtr != NULL);
-    const std::string& lGeonameModDateStr =
-      boost::gregorian::to_iso_extended_string(lGeonameModDate);
-    lGeonameModDatePtr->set_date (lGeonameModDateStr);
+    setISODate (*lGeonameModDatePtr, lGeonameModDate);
 
     // Retrieve and set the envelope ID
     const EnvelopeID_T& lEnvID = iLocation.getEnvelopeID();
@@ -185,17 +424,13 @@ namespace OPENTREP {
     const Date_T& lDateFrom = iLocation.getDateFrom();
     treppb::Date* lDateFromPtr = ioPlace.mutable_date_from();
     assert (lDateFromPtr != NULL);
-    const std::string& lDateFromStr =
-      boost::gregorian::to_iso_extended_string(lDateFrom);
-    lDateFromPtr->set_date (lDateFromStr);
+    setISODate (*lDateFromPtr, lDateFrom);
 
     // Retrieve and set the end date of the validity period
     const Date_T& lDateEnd = iLocation.getDateEnd();
     treppb::Date* lDateEndPtr = ioPlace.mutable_date_end();
     assert (lDateEndPtr != NULL);
-    const std::string& lDateEndStr =
-      boost::gregorian::to_iso_extended_string(lDateEnd);
-    lDateEndPtr->set_date (lDateEndStr);
+    setISODate (*lDateEndPtr, lDateEnd);
 
     // Retrieve and set the location type
     const IATAType& lLocationType = lLocationKey.getIataType();
@@ -220,7 +455,7 @@ namespace OPENTREP {
     treppb::AltNameList* lAltNameListPtr = ioPlace.mutable_alt_name_list();
     assert (lAltNameListPtr != NULL);
     //
-    const NameMatrix_T lNameMatrix = lNameMatrixRef.getNameMatrix();
+    const NameMatrix_T& lNameMatrix = lNameMatrixRef.getNameMatrix();
     for (NameMatrix_T::const_iterator itNameList = lNameMatrix.begin();
          itNameList != lNameMatrix.end(); ++itNameList) {
       const Names& lNameListRef = itNameList->second;
@@ -549,5 +784,398 @@ namespace OPENTREP {
     }
   }
 
-}
+  /**
+   * Helper function encoding a date as a YYYYMMDD number (e.g., 20120101),
+   * 0 standing for "not a date".
+   */
+  // //////////////////////////////////////////////////////////////////////
+  google::protobuf::uint32 encodeDate (const Date_T& iDate) {
+    if (iDate.is_special() == true) {
+      return 0;
+    }
+    const Date_T::ymd_type lYMD = iDate.year_month_day();
+    return lYMD.year * 10000 + lYMD.month * 100 + lYMD.day;
+  }
+
+  /**
+   * Helper function decoding a date encoded by encodeDate().
+   */
+  // //////////////////////////////////////////////////////////////////////
+  Date_T decodeDate (const google::protobuf::uint32 iDate) {
+    if (iDate == 0) {
+      return Date_T (boost::gregorian::not_a_date_time);
+    }
+    const unsigned short lYear = iDate / 10000;
+    const unsigned short lMonth = (iDate / 100) % 100;
+    const unsigned short lDay = iDate % 100;
+    return Date_T (lYear, lMonth, lDay);
+  }
+
+  /**
+   * Helper function packing the alternate names into a single string,
+   * language after language, e.g., "en|Nice=it|Nizza|Nizza Marittima".
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void packNameMatrix (const NameMatrix_T& iNameMatrix, std::string& ioStr) {
+    for (NameMatrix_T::const_iterator itNameList = iNameMatrix.begin();
+         itNameList != iNameMatrix.end(); ++itNameList) {
+      const Names& lNameListRef = itNameList->second;
+      if (itNameList != iNameMatrix.begin()) {
+        ioStr += '=';
+      }
+      ioStr += lNameListRef.getLanguageCode();
+
+      const NameList_T& lNameList = lNameListRef.getNameList();
+      for (NameList_T::const_iterator itName = lNameList.begin();
+           itName != lNameList.end(); ++itName) {
+        const std::string& lName = *itName;
+        ioStr += '|';
+        ioStr += lName;
+      }
+    }
+  }
+
+  /**
+   * Helper function adding to the location the alternate names packed
+   * by packNameMatrix().
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void unpackNameMatrix (const std::string& iStr, Location& ioLocation) {
+    std::string::size_type lLangPos = 0;
+    while (lLangPos < iStr.size()) {
+      std::string::size_type lLangEndPos = iStr.find ('=', lLangPos);
+      if (lLangEndPos == std::string::npos) {
+        lLangEndPos = iStr.size();
+      }
+
+      std::string::size_type lNamePos = iStr.find ('|', lLangPos);
+      if (lNamePos == std::string::npos || lNamePos > lLangEndPos) {
+        lNamePos = lLangEndPos;
+      }
+      const LanguageCode_T lLangCode (iStr.substr (lLangPos,
+                                                   lNamePos - lLangPos));
+      while (lNamePos < lLangEndPos) {
+        ++lNamePos;
+        std::string::size_type lNameEndPos = iStr.find ('|', lNamePos);
+        if (lNameEndPos == std::string::npos || lNameEndPos > lLangEndPos) {
+          lNameEndPos = lLangEndPos;
+        }
+        ioLocation.addName (lLangCode,
+                            iStr.substr (lNamePos, lNameEndPos - lNamePos));
+        lNamePos = lNameEndPos;
+      }
+
+      lLangPos = lLangEndPos + 1;
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string LocationExchange::serialiseLocation (const Location& iLocation) {
+    std::string oStr ("");
+
+    // Protobuf structure
+    treppb::PlaceRecord lPlaceRecord;
+
+    /**
+     * Section 1 - Primary key and codes (IATA, ICAO, FAA, UN/LOCODE, UIC)
+     */
+    const LocationKey& lLocationKey = iLocation.getKey();
+    lPlaceRecord.set_iata_code (lLocationKey.getIataCode());
+    lPlaceRecord.set_loc_type (lLocationKey.getIataType().getType());
+    lPlaceRecord.set_geonames_id (lLocationKey.getGeonamesID());
+    lPlaceRecord.set_is_geonames (lLocationKey.isGeonames());
+    lPlaceRecord.set_icao_code (iLocation.getIcaoCode());
+    lPlaceRecord.set_faa_code (iLocation.getFaaCode());
+
+    const UNLOCodeList_T& lUNLOCodeList = iLocation.getUNLOCodeList();
+    for (UNLOCodeList_T::const_iterator itUNLOCode = lUNLOCodeList.begin();
+         itUNLOCode != lUNLOCodeList.end(); ++itUNLOCode) {
+      const UNLOCode_T& lUNLOCode = *itUNLOCode;
+      lPlaceRecord.add_unlocode (lUNLOCode);
+    }
+
+    const UICCodeList_T& lUICCodeList = iLocation.getUICCodeList();
+    for (UICCodeList_T::const_iterator itUICCode = lUICCodeList.begin();
+         itUICCode != lUICCodeList.end(); ++itUICCode) {
+      const UICCode_T& lUICCode = *itUICCode;
+      lPlaceRecord.add_uic_code (lUICCode);
+    }
+
+    /**
+     * Section 2 - Identification / reference
+     */
+    lPlaceRecord.set_env_id (iLocation.getEnvelopeID());
+    lPlaceRecord.set_date_from (encodeDate (iLocation.getDateFrom()));
+    lPlaceRecord.set_date_end (encodeDate (iLocation.getDateEnd()));
+    lPlaceRecord.set_mod_date (encodeDate (iLocation.getModificationDate()));
+    lPlaceRecord.set_feat_class (iLocation.getFeatureClass());
+    lPlaceRecord.set_feat_code (iLocation.getFeatureCode());
+    lPlaceRecord.set_comment (iLocation.getComment());
+
+    /**
+     * Section 3 - Names
+     */
+    // The ASCII names which are the same as the UTF-8 ones are not stored
+    // (see the ascii_as_utf bit mask)
+    google::protobuf::uint32 lAsciiAsUtfMask = 0;
+    const CommonName_T& lCommonName = iLocation.getCommonName();
+    const ASCIIName_T& lAsciiName = iLocation.getAsciiName();
+    lPlaceRecord.set_name_utf (lCommonName);
+    if (lAsciiName == lCommonName) {
+      lAsciiAsUtfMask |= 1;
+    } else {
+      lPlaceRecord.set_name_ascii (lAsciiName);
+    }
+    const AltNameShortListString_T& lAltNameShortList =
+      iLocation.getAltNameShortListString();
+    lPlaceRecord.set_alt_name_short_list (lAltNameShortList);
+
+    const NameMatrix_T& lNameMatrix = iLocation.getNameMatrix().getNameMatrix();
+    packNameMatrix (lNameMatrix, *lPlaceRecord.mutable_name_list());
+
+    /**
+     * Section 4 - Geographical data (coordinates, elevation, topology reference)
+     */
+    lPlaceRecord.set_latitude (iLocation.getLatitude());
+    lPlaceRecord.set_longitude (iLocation.getLongitude());
+    const Latitude_T& lGeonamesLatitude = iLocation.getGeonameLatitude();
+    const Longitude_T& lGeonamesLongitude = iLocation.getGeonameLongitude();
+    if (lGeonamesLatitude != iLocation.getLatitude()
+        || lGeonamesLongitude != iLocation.getLongitude()) {
+      lPlaceRecord.set_has_geonames_coord (true);
+      lPlaceRecord.set_geonames_latitude (lGeonamesLatitude);
+      lPlaceRecord.set_geonames_longitude (lGeonamesLongitude);
+    }
+    lPlaceRecord.set_elevation (iLocation.getElevation());
+    lPlaceRecord.set_gtopo30 (iLocation.getGTopo30());
+
+    /**
+     * Section 5 - Administrative levels
+     */
+    lPlaceRecord.set_country_code (iLocation.getCountryCode());
+    lPlaceRecord.set_alt_country_code (iLocation.getAltCountryCode());
+    lPlaceRecord.set_country_name (iLocation.getCountryName());
+    lPlaceRecord.set_continent_code (iLocation.getContinentCode());
+    lPlaceRecord.set_continent_name (iLocation.getContinentName());
+    lPlaceRecord.set_adm1_code (iLocation.getAdmin1Code());
+    const Admin1UTFName_T& lAdm1UtfName = iLocation.getAdmin1UtfName();
+    const Admin1ASCIIName_T& lAdm1AsciiName = iLocation.getAdmin1AsciiName();
+    lPlaceRecord.set_adm1_name_utf (lAdm1UtfName);
+    if (lAdm1AsciiName == lAdm1UtfName) {
+      lAsciiAsUtfMask |= 2;
+    } else {
+      lPlaceRecord.set_adm1_name_ascii (lAdm1AsciiName);
+    }
+    lPlaceRecord.set_adm2_code (iLocation.getAdmin2Code());
+    const Admin2UTFName_T& lAdm2UtfName = iLocation.getAdmin2UtfName();
+    const Admin2ASCIIName_T& lAdm2AsciiName = iLocation.getAdmin2AsciiName();
+    lPlaceRecord.set_adm2_name_utf (lAdm2UtfName);
+    if (lAdm2AsciiName == lAdm2UtfName) {
+      lAsciiAsUtfMask |= 4;
+    } else {
+      lPlaceRecord.set_adm2_name_ascii (lAdm2AsciiName);
+    }
+    lPlaceRecord.set_ascii_as_utf (lAsciiAsUtfMask);
+    lPlaceRecord.set_adm3_code (iLocation.getAdmin3Code());
+    lPlaceRecord.set_adm4_code (iLocation.getAdmin4Code());
+    lPlaceRecord.set_state_code (iLocation.getStateCode());
+    lPlaceRecord.set_wac_code (iLocation.getWAC());
+    lPlaceRecord.set_wac_name (iLocation.getWACName());
+
+    /**
+     * Section 6 - General characteristics (PageRank (PR) value, population)
+     */
+    lPlaceRecord.set_page_rank (iLocation.getPageRank());
+    lPlaceRecord.set_population (iLocation.getPopulation());
+    lPlaceRecord.set_currency_code (iLocation.getCurrencyCode());
+    lPlaceRecord.set_wiki_link (iLocation.getWikiLink());
+
+    /**
+     * Section 7 - Time-zone details
+     */
+    lPlaceRecord.set_tz (iLocation.getTimeZone());
+    lPlaceRecord.set_gmt_offset (iLocation.getGMTOffset());
+    lPlaceRecord.set_dst_offset (iLocation.getDSTOffset());
+    lPlaceRecord.set_raw_offset (iLocation.getRawOffset());
+
+    /**
+     * Section 8 - Served cities (for a travel-/transport-related POR)
+     */
+    const CityDetailsList_T& lCityList = iLocation.getCityList();
+    for (CityDetailsList_T::const_iterator itCity = lCityList.begin();
+         itCity != lCityList.end(); ++itCity) {
+      const CityDetails& lCity = *itCity;
+      treppb::PlaceRecordCity* lCityPtr = lPlaceRecord.add_city();
+      assert (lCityPtr != NULL);
+      lCityPtr->set_iata_code (lCity.getIataCode());
+      lCityPtr->set_geonames_id (lCity.getGeonamesID());
+      const CityUTFName_T& lCityUtfName = lCity.getUtfName();
+      const CityASCIIName_T& lCityAsciiName = lCity.getAsciiName();
+      lCityPtr->set_name_utf (lCityUtfName);
+      if (lCityAsciiName == lCityUtfName) {
+        lCityPtr->set_ascii_as_utf (true);
+      } else {
+        lCityPtr->set_name_ascii (lCityAsciiName);
+      }
+      lCityPtr->set_country_code (lCity.getCountryCode());
+      lCityPtr->set_state_code (lCity.getStateCode());
+    }
 
+    /**
+     * Section 9 - Serving travel-/transport-related POR (for a city)
+     */
+    lPlaceRecord.set_tvl_por_list (iLocation.getTvlPORListString());
+
+    // Serialize the Protobuf
+    const bool pbSerialStatus = lPlaceRecord.SerializeToString (&oStr);
+    if (pbSerialStatus == false) {
+      std::ostringstream errStr;
+      errStr << "Error - The OPTD place record protocol buffer object cannot "
+             << "be serialized into a C++ string";
+      throw SerDeException (errStr.str());
+    }
+
+    return oStr;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  Location LocationExchange::
+  deserialiseLocation (const std::string& iSerialisedLocation) {
+    Location oLocation;
+
+    // Parse the Protobuf
+    treppb::PlaceRecord lPlaceRecord;
+    const bool pbParseStatus =
+      lPlaceRecord.ParseFromString (iSerialisedLocation);
+    if (pbParseStatus == false) {
+      std::ostringstream errStr;
+      errStr << "Error - The OPTD place record protocol buffer object cannot "
+             << "be de-serialized from a C++ string";
+      throw SerDeException (errStr.str());
+    }
+
+    /**
+     * Section 1 - Primary key and codes (IATA, ICAO, FAA, UN/LOCODE, UIC)
+     */
+    const IATAType::EN_IATAType lIataType =
+      static_cast<IATAType::EN_IATAType> (lPlaceRecord.loc_type());
+    LocationKey lLocationKey (IATACode_T (lPlaceRecord.iata_code()),
+                              IATAType (lIataType),
+                              lPlaceRecord.geonames_id());
+    lLocationKey.setIsGeonames (lPlaceRecord.is_geonames());
+    oLocation.setKey (lLocationKey);
+    oLocation.setIcaoCode (lPlaceRecord.icao_code());
+    oLocation.setFaaCode (lPlaceRecord.faa_code());
+
+    for (int idx = 0; idx != lPlaceRecord.unlocode_size(); ++idx) {
+      oLocation.addUNLOCode (UNLOCode_T (lPlaceRecord.unlocode (idx)));
+    }
+    for (int idx = 0; idx != lPlaceRecord.uic_code_size(); ++idx) {
+      oLocation.addUICCode (lPlaceRecord.uic_code (idx));
+    }
+
+    /**
+     * Section 2 - Identification / reference
+     */
+    oLocation.setEnvelopeID (lPlaceRecord.env_id());
+    oLocation.setDateFrom (decodeDate (lPlaceRecord.date_from()));
+    oLocation.setDateEnd (decodeDate (lPlaceRecord.date_end()));
+    oLocation.setModificationDate (decodeDate (lPlaceRecord.mod_date()));
+    oLocation.setFeatureClass (lPlaceRecord.feat_class());
+    oLocation.setFeatureCode (lPlaceRecord.feat_code());
+    oLocation.setComment (lPlaceRecord.comment());
+
+    /**
+     * Section 3 - Names
+     */
+    const google::protobuf::uint32 lAsciiAsUtfMask =
+      lPlaceRecord.ascii_as_utf();
+    oLocation.setCommonName (lPlaceRecord.name_utf());
+    oLocation.setAsciiName ((lAsciiAsUtfMask & 1)?
+                            lPlaceRecord.name_utf():lPlaceRecord.name_ascii());
+    oLocation.setAltNameShortListString (lPlaceRecord.alt_name_short_list());
+
+    unpackNameMatrix (lPlaceRecord.name_list(), oLocation);
+
+    /**
+     * Section 4 - Geographical data (coordinates, elevation, topology reference)
+     */
+    oLocation.setLatitude (lPlaceRecord.latitude());
+    oLocation.setLongitude (lPlaceRecord.longitude());
+    if (lPlaceRecord.has_geonames_coord() == true) {
+      oLocation.setGeonameLatitude (lPlaceRecord.geonames_latitude());
+      oLocation.setGeonameLongitude (lPlaceRecord.geonames_longitude());
+    } else {
+      oLocation.setGeonameLatitude (lPlaceRecord.latitude());
+      oLocation.setGeonameLongitude (lPlaceRecord.longitude());
+    }
+    oLocation.setElevation (lPlaceRecord.elevation());
+    oLocation.setGTopo30 (lPlaceRecord.gtopo30());
+
+    /**
+     * Section 5 - Administrative levels
+     */
+    oLocation.setCountryCode (lPlaceRecord.country_code());
+    oLocation.setAltCountryCode (lPlaceRecord.alt_country_code());
+    oLocation.setCountryName (lPlaceRecord.country_name());
+    oLocation.setContinentCode (lPlaceRecord.continent_code());
+    oLocation.setContinentName (lPlaceRecord.continent_name());
+    oLocation.setAdmin1Code (lPlaceRecord.adm1_code());
+    oLocation.setAdmin1UtfName (lPlaceRecord.adm1_name_utf());
+    oLocation.setAdmin1AsciiName ((lAsciiAsUtfMask & 2)?
+                                  lPlaceRecord.adm1_name_utf():
+                                  lPlaceRecord.adm1_name_ascii());
+    oLocation.setAdmin2Code (lPlaceRecord.adm2_code());
+    oLocation.setAdmin2UtfName (lPlaceRecord.adm2_name_utf());
+    oLocation.setAdmin2AsciiName ((lAsciiAsUtfMask & 4)?
+                                  lPlaceRecord.adm2_name_utf():
+                                  lPlaceRecord.adm2_name_ascii());
+    oLocation.setAdmin3Code (lPlaceRecord.adm3_code());
+    oLocation.setAdmin4Code (lPlaceRecord.adm4_code());
+    oLocation.setStateCode (lPlaceRecord.state_code());
+    oLocation.setWAC (lPlaceRecord.wac_code());
+    oLocation.setWACName (lPlaceRecord.wac_name());
+
+    /**
+     * Section 6 - General characteristics (PageRank (PR) value, population)
+     */
+    oLocation.setPageRank (lPlaceRecord.page_rank());
+    oLocation.setPopulation (lPlaceRecord.population());
+    oLocation.setCurrencyCode (lPlaceRecord.currency_code());
+    oLocation.setWikiLink (lPlaceRecord.wiki_link());
+
+    /**
+     * Section 7 - Time-zone details
+     */
+    oLocation.setTimeZone (lPlaceRecord.tz());
+    oLocation.setGMTOffset (lPlaceRecord.gmt_offset());
+    oLocation.setDSTOffset (lPlaceRecord.dst_offset());
+    oLocation.setRawOffset (lPlaceRecord.raw_offset());
+
+    /**
+     * Section 8 - Served cities (for a travel-/transport-related POR)
+     */
+    CityDetailsList_T lCityList;
+    for (int idx = 0; idx != lPlaceRecord.city_size(); ++idx) {
+      const treppb::PlaceRecordCity& lCity = lPlaceRecord.city (idx);
+      const CityDetails lCityDetails (IATACode_T (lCity.iata_code()),
+                                      lCity.geonames_id(),
+                                      CityUTFName_T (lCity.name_utf()),
+                                      CityASCIIName_T (lCity.ascii_as_utf()?
+                                                       lCity.name_utf():
+                                                       lCity.name_ascii()),
+                                      CountryCode_T (lCity.country_code()),
+                                      StateCode_T (lCity.state_code()));
+      lCityList.push_back (lCityDetails);
+    }
+    oLocation.setCityList (lCityList);
+
+    /**
+     * Section 9 - Serving travel-/transport-related POR (for a city)
+     */
+    oLocation.setTvlPORListString (lPlaceRecord.tvl_por_list());
+
+    return oLocation;
+  }
+
+}
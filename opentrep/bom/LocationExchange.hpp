@@ -5,14 +5,23 @@
 // Import section
 // //////////////////////////////////////////////////////////////////////
 // STL
+#include <cstddef>
 #include <string>
 // OpenTrep
 #include <opentrep/OPENTREP_Types.hpp>
 #include <opentrep/LocationList.hpp>
 
 // Forward declarations for the Protobuf structures
+namespace google {
+  namespace protobuf {
+    namespace io {
+      class ZeroCopyOutputStream;
+    }
+  }
+}
 namespace treppb {
   class Place;
+  class QueryAnswer;
 }
 
 namespace OPENTREP {
@@ -22,6 +31,13 @@ namespace OPENTREP {
 
   /**
    * @brief Utility class to export Opentrep structures in a Protobuf format.
+   *
+   * The Protobuf structure (treppb::QueryAnswer) in which the lists of
+   * Location objects are exported is built on a Protobuf arena, kept by
+   * every thread from one export to another. Once the largest list has
+   * been exported, the memory block of the arena is large enough for
+   * all the exports, which then allocate memory only for the (long enough)
+   * strings of the Protobuf structure.
    */
   class LocationExchange {
   public:
@@ -38,6 +54,82 @@ namespace OPENTREP {
     static std::string exportLocationList(const LocationList_T&,
                                           const WordList_T& iNonMatchedWordList);
 
+    /**
+     * Export (in Protobuf format) a list of Location objects into the given
+     * buffer, the former content of which is replaced. As its capacity is
+     * kept, the same buffer may be reused from one export to another.
+     *
+     * @param std::string& Buffer in which the Location objects should be
+     *                     serialised.
+     * @param const LocationList_T& List of Location objects to be exported.
+     * @param const WordList_T& The list of non-matching keywords.
+     */
+    static void exportLocationList (std::string& ioPBBuffer,
+                                    const LocationList_T&,
+                                    const WordList_T& iNonMatchedWordList);
+
+    /**
+     * Export (in Protobuf format) a list of Location objects into the given
+     * Protobuf output stream.
+     *
+     * @param google::protobuf::io::ZeroCopyOutputStream& Output stream.
+     * @param const LocationList_T& List of Location objects to be exported.
+     * @param const WordList_T& The list of non-matching keywords.
+     */
+    static void exportLocationList (google::protobuf::io::ZeroCopyOutputStream&,
+                                    const LocationList_T&,
+                                    const WordList_T& iNonMatchedWordList);
+
+    /**
+     * Prepare the export (in Protobuf format) of a list of Location objects,
+     * so that the caller may allocate the output buffer with the right size,
+     * before calling serialisePreparedLocationList(), within the same thread.
+     * That allows, for instance, to serialise the Location objects directly
+     * into a Python bytes object.
+     *
+     * @param const LocationList_T& List of Location objects to be exported.
+     * @param const WordList_T& The list of non-matching keywords.
+     * @return std::size_t Size of the serialisation, in bytes.
+     */
+    static std::size_t
+    prepareLocationList (const LocationList_T&,
+                         const WordList_T& iNonMatchedWordList);
+
+    /**
+     * Serialise the list of Location objects prepared by the last call
+     * to prepareLocationList() within the current thread.
+     *
+     * @param char* Output buffer, of (at least) the given size.
+     * @param const std::size_t Size given by prepareLocationList().
+     */
+    static void serialisePreparedLocationList (char* oPBBuffer,
+                                               const std::size_t iPBSize);
+
+    /**
+     * Export (in Protobuf format) the answer to a failed travel query, i.e.,
+     * with a false status and the given error message, into the given
+     * buffer, the former content of which is replaced.
+     *
+     * @param std::string& Buffer in which the answer should be serialised.
+     * @param const std::string& Error message.
+     */
+    static void exportError (std::string& ioPBBuffer,
+                             const std::string& iErrorMessage);
+
+    /**
+     * Append the Protobuf serialisation of a query answer (as given by
+     * exportLocationList()) to the serialisation of a batch of query
+     * answers (treppb::QueryAnswerList). As a batch is only the sequence
+     * of its (size-prefixed) answers, the answers may be serialised
+     * separately (e.g., by several threads), and then gathered without
+     * being parsed again.
+     *
+     * @param std::string& Serialisation of the batch, extended in place.
+     * @param const std::string& Serialisation of the query answer.
+     */
+    static void appendQueryAnswer (std::string& ioPBBatchBuffer,
+                                   const std::string& iPBAnswer);
+
     /**
      * Export (dump in the underlying output log stream and in Protobuf format)
      * a Location object.
@@ -47,6 +139,40 @@ namespace OPENTREP {
      * @param const Location& Location object to be exported.
      */
     static void exportLocation (treppb::Place&, const Location&);
+
+    /**
+     * Serialise a Location object in the storage Protobuf format
+     * (see PlaceRecord.proto), i.e., the format in which the POR are
+     * stored within the SQL database.
+     *
+     * Contrary to exportLocation(), all the fields parsed from the POR
+     * file are kept, while the search-related ones (e.g., matching
+     * percentage, keywords, extra and alternate locations) are not.
+     *
+     * @param const Location& Location object to be serialised.
+     * @return std::string Protobuf (binary) serialisation.
+     */
+    static std::string serialiseLocation (const Location&);
+
+    /**
+     * Re-build a Location object from its serialisation in the storage
+     * Protobuf format (see serialiseLocation()). That is much cheaper
+     * than parsing again the POR raw data string. Note that the raw data
+     * string is not part of the serialisation.
+     *
+     * @param const std::string& Protobuf (binary) serialisation.
+     * @return Location The re-built Location object.
+     */
+    static Location deserialiseLocation (const std::string&);
+
+  private:
+    /**
+     * Build the Protobuf structure of the current thread, filled with
+     * the given list of Location objects.
+     */
+    static treppb::QueryAnswer&
+    buildQueryAnswer (const LocationList_T&,
+                      const WordList_T& iNonMatchedWordList);
   };
   
 }
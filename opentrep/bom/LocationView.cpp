@@ -0,0 +1,171 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+// OpenTrep
+#include <opentrep/OPENTREP_exceptions.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/BasParserTypes.hpp>
+#include <opentrep/bom/PORParserHelper.hpp>
+#include <opentrep/bom/LocationView.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  LocationView::LocationView (const std::string& iRawDataString)
+    : _rawDataString (iRawDataString) {
+    init();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  LocationView::~LocationView() {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void LocationView::init() {
+    // Locate all the separators at once, and split the raw data string
+    // into its fields
+    PorFastParserHelper::indexSeparators (_rawDataString.c_str(),
+                                          _rawDataString.size(),
+                                          _separatorIndex);
+
+    _fieldList.reserve (PorFastParserHelper::K_NB_OF_POR_FIELDS);
+    if (PorFastParserHelper::splitRecord (_rawDataString.c_str(),
+                                          _rawDataString.size(),
+                                          _separatorIndex._caretList,
+                                          _fieldList) == false) {
+      std::ostringstream oStr;
+      oStr << _separatorIndex._caretList.size() + 1 << " fields, whereas "
+           << PorFastParserHelper::K_NB_OF_POR_FIELDS << " are expected";
+      throwDecodingError (oStr.str());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void LocationView::throwDecodingError (const std::string& iReason) const {
+    std::ostringstream oStr;
+    oStr << "Decoding of POR raw data: '" << _rawDataString << "' failed ("
+         << iReason << ")";
+    OPENTREP_LOG_ERROR (oStr.str());
+    throw PorFileParsingException (oStr.str());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  IATACode_T LocationView::getIataCode() const {
+    const PorFastParserHelper::Field& lField =
+      _fieldList[PorFastParserHelper::K_IATA_CODE];
+    return IATACode_T (PorFastParserHelper::compact (lField));
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  IATAType LocationView::getIataType() const {
+    const PorFastParserHelper::Field& lField =
+      _fieldList[PorFastParserHelper::K_POR_TYPE];
+    const std::string& lPORTypeStr = PorFastParserHelper::compact (lField);
+    if (lPORTypeStr.empty() == true) {
+      throwDecodingError ("POR type");
+    }
+    return IATAType (lPORTypeStr);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  GeonamesID_T LocationView::getGeonamesID() const {
+    const PorFastParserHelper::Field& lField =
+      _fieldList[PorFastParserHelper::K_GEONAME_ID];
+    int lGeonamesID = 0;
+    OPENTREP::uint1_9_p_t lUInt1To9Parser;
+    if (PorFastParserHelper::getNumber (lField, lUInt1To9Parser,
+                                        lGeonamesID) == false) {
+      throwDecodingError ("Geonames ID");
+    }
+    return lGeonamesID;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  LocationKey LocationView::getKey() const {
+    return LocationKey (getIataCode(), getIataType(), getGeonamesID());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  EnvelopeID_T LocationView::getEnvelopeID() const {
+    const PorFastParserHelper::Field& lField =
+      _fieldList[PorFastParserHelper::K_ENVELOPE_ID];
+    int lEnvelopeID = 0;
+    if (PorFastParserHelper::trim (lField).empty() == true) {
+      return lEnvelopeID;
+    }
+
+    OPENTREP::uint1_4_p_t lUInt1To4Parser;
+    if (PorFastParserHelper::getNumber (lField, lUInt1To4Parser,
+                                        lEnvelopeID) == false) {
+      throwDecodingError ("envelope ID");
+    }
+    return lEnvelopeID;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PageRank_T LocationView::getPageRank() const {
+    const PorFastParserHelper::Field& lField =
+      _fieldList[PorFastParserHelper::K_PAGE_RANK];
+    if (PorFastParserHelper::trim (lField).empty() == true) {
+      return K_DEFAULT_PAGE_RANK;
+    }
+
+    double lPageRank = 0.0;
+    if (PorFastParserHelper::getNumber (lField, boost::spirit::qi::double_,
+                                        lPageRank) == false) {
+      throwDecodingError ("PageRank");
+    }
+    return 100.0 * lPageRank;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  Latitude_T LocationView::getLatitude() const {
+    const PorFastParserHelper::Field& lField =
+      _fieldList[PorFastParserHelper::K_LATITUDE];
+    double lLatitude = 0.0;
+    if (PorFastParserHelper::trim (lField).empty() == false
+        && PorFastParserHelper::getNumber (lField,
+                                           boost::spirit::qi::double_,
+                                           lLatitude) == false) {
+      throwDecodingError ("latitude");
+    }
+    return lLatitude;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  Longitude_T LocationView::getLongitude() const {
+    const PorFastParserHelper::Field& lField =
+      _fieldList[PorFastParserHelper::K_LONGITUDE];
+    double lLongitude = 0.0;
+    if (PorFastParserHelper::trim (lField).empty() == false
+        && PorFastParserHelper::getNumber (lField,
+                                           boost::spirit::qi::double_,
+                                           lLongitude) == false) {
+      throwDecodingError ("longitude");
+    }
+    return lLongitude;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  FeatureCode_T LocationView::getFeatureCode() const {
+    const PorFastParserHelper::Field& lField =
+      _fieldList[PorFastParserHelper::K_FEAT_CODE];
+    const std::string& lFeatureCodeStr = PorFastParserHelper::compact (lField);
+    if (lFeatureCodeStr.empty() == true) {
+      throwDecodingError ("feature code");
+    }
+    return FeatureCode_T (lFeatureCodeStr);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  Location LocationView::toLocation() const {
+    PORStringParser lStringParser (_rawDataString);
+    const Location& oLocation = lStringParser.generateLocation();
+    return oLocation;
+  }
+
+}
@@ -0,0 +1,155 @@
+#ifndef __OPENTREP_BOM_LOCATIONVIEW_HPP
+#define __OPENTREP_BOM_LOCATIONVIEW_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/IATAType.hpp>
+#include <opentrep/LocationKey.hpp>
+#include <opentrep/Location.hpp>
+#include <opentrep/bom/PORFastParser.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * @brief Read-only view over the raw data of a POR (point of reference),
+   *        as held by the Xapian documents and by the SQL database.
+   *
+   * The view points into the raw data string, which must therefore outlive
+   * it. The fields are located once, when the view is built (see
+   * PorFastParserHelper::indexSeparators()), and each of them is decoded
+   * only when requested, with the same rules as the POR parsers.
+   *
+   * Most of the steps of a search need only one or two fields of a POR
+   * (e.g., the key, the PageRank or the envelope ID), whereas the Location
+   * structure holds dozens of strings, the lists of names, of cities,
+   * of UN/LOCODE and UIC codes, etc. The whole Location structure (see
+   * toLocation()) is therefore built only for the results given back to
+   * the callers.
+   *
+   * A PorFileParsingException is thrown when the raw data does not comply
+   * with the format of the OPTD POR file.
+   */
+  class LocationView {
+  public:
+    // /////////// Getters ////////////
+    /**
+     * Get the raw data string, into which the view points.
+     */
+    const std::string& getRawDataString() const {
+      return _rawDataString;
+    }
+
+    /**
+     * Get the IATA code.
+     */
+    IATACode_T getIataCode() const;
+
+    /**
+     * Get the IATA location type (e.g., A for airport).
+     */
+    IATAType getIataType() const;
+
+    /**
+     * Get the Geonames ID.
+     */
+    GeonamesID_T getGeonamesID() const;
+
+    /**
+     * Get the primary key (IATA code and location type, Geonames ID).
+     */
+    LocationKey getKey() const;
+
+    /**
+     * Get the envelope ID (0 for the POR still valid).
+     */
+    EnvelopeID_T getEnvelopeID() const;
+
+    /**
+     * Get the PageRank (as a percentage, as in the Location structure).
+     */
+    PageRank_T getPageRank() const;
+
+    /**
+     * Get the latitude.
+     */
+    Latitude_T getLatitude() const;
+
+    /**
+     * Get the longitude.
+     */
+    Longitude_T getLongitude() const;
+
+    /**
+     * Get the Geonames feature code (e.g., AIRP for airport).
+     */
+    FeatureCode_T getFeatureCode() const;
+
+  public:
+    // /////////// Business methods ////////////
+    /**
+     * Build the whole Location structure, by parsing the raw data string
+     * (see PORStringParser).
+     */
+    Location toLocation() const;
+
+  public:
+    // /////////// Constructors and destructors ////////////
+    /**
+     * Constructor.
+     *
+     * @param const std::string& Raw data string, holding all the details
+     *        of the POR. It must outlive the view.
+     */
+    LocationView (const std::string& iRawDataString);
+
+    /**
+     * Destructor.
+     */
+    ~LocationView();
+
+  private:
+    /**
+     * Default constructor.
+     */
+    LocationView();
+
+    /**
+     * Default copy constructor.
+     */
+    LocationView (const LocationView&);
+
+    /**
+     * Locate the fields of the raw data string.
+     */
+    void init();
+
+    /**
+     * Throw a PorFileParsingException, after having logged the reason.
+     */
+    void throwDecodingError (const std::string& iReason) const;
+
+  private:
+    // //////////////// Attributes //////////////////
+    /**
+     * Raw data string (owned by the caller).
+     */
+    const std::string& _rawDataString;
+
+    /**
+     * Offsets of the separators of the raw data string.
+     */
+    PorFastParserHelper::SeparatorIndex _separatorIndex;
+
+    /**
+     * Fields of the raw data string.
+     */
+    PorFastParserHelper::FieldList_T _fieldList;
+  };
+
+}
+#endif // __OPENTREP_BOM_LOCATIONVIEW_HPP
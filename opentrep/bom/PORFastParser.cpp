@@ -0,0 +1,917 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+#include <algorithm>
+// Boost
+#include <boost/spirit/include/qi.hpp>
+// SIMD intrinsics. The AVX2 code is compiled whatever the target
+// architecture given to the compiler, and used only when the CPU
+// supports it (which is checked at run-time)
+#if defined(__SSE2__) || defined(_M_X64) \
+  || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OPENTREP_POR_SEPARATOR_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define OPENTREP_POR_SEPARATOR_AVX2
+#include <immintrin.h>
+#endif // __GNUC__
+#endif // __SSE2__
+// OpenTREP
+#include <opentrep/basic/BasParserTypes.hpp>
+#include <opentrep/bom/PORFastParser.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  /** Namespaces */
+  namespace bsq = boost::spirit::qi;
+
+  namespace PorFastParserHelper {
+
+    // //////////////////////////////////////////////////////////////////
+    void SeparatorIndex::clear() {
+      _caretList.clear();
+      _pipeList.clear();
+      _equalList.clear();
+      _commaList.clear();
+    }
+
+    // //////////////////////////////////////////////////////////////////
+    /**
+     * Append to the list the offsets corresponding to the bits set
+     * within the mask.
+     */
+    inline void appendOffsets (const unsigned int iMask,
+                               const unsigned int iOffset,
+                               SeparatorOffsetList_T& ioOffsetList) {
+      unsigned int lMask = iMask;
+      while (lMask != 0) {
+#if defined(__GNUC__)
+        const unsigned int lBit = __builtin_ctz (lMask);
+#else // __GNUC__
+        unsigned int lBit = 0;
+        while ((lMask & (1u << lBit)) == 0) {
+          ++lBit;
+        }
+#endif // __GNUC__
+        ioOffsetList.push_back (iOffset + lBit);
+
+        // Clear the lowest bit set
+        lMask &= lMask - 1;
+      }
+    }
+
+    // //////////////////////////////////////////////////////////////////
+    /**
+     * Locate the separators byte after byte, from the given offset
+     * up to the end of the string.
+     */
+    void indexSeparatorsScalar (const char* iString,
+                                const unsigned int iOffset,
+                                const unsigned int iLength,
+                                SeparatorIndex& ioIndex) {
+      for (unsigned int idx = iOffset; idx < iLength; ++idx) {
+        switch (iString[idx]) {
+        case '^': ioIndex._caretList.push_back (idx); break;
+        case '|': ioIndex._pipeList.push_back (idx); break;
+        case '=': ioIndex._equalList.push_back (idx); break;
+        case ',': ioIndex._commaList.push_back (idx); break;
+        default: break;
+        }
+      }
+    }
+
+#if defined(OPENTREP_POR_SEPARATOR_SSE2)
+    // //////////////////////////////////////////////////////////////////
+    /**
+     * Locate the separators by blocks of 16 bytes, from the given offset.
+     *
+     * @return unsigned int Offset of the remaining bytes (less than 16).
+     */
+    unsigned int indexSeparatorsSSE2 (const char* iString,
+                                      const unsigned int iOffset,
+                                      const unsigned int iLength,
+                                      SeparatorIndex& ioIndex) {
+      const __m128i lCaret = _mm_set1_epi8 ('^');
+      const __m128i lPipe = _mm_set1_epi8 ('|');
+      const __m128i lEqual = _mm_set1_epi8 ('=');
+      const __m128i lComma = _mm_set1_epi8 (',');
+
+      unsigned int lOffset = iOffset;
+      for ( ; lOffset + 16 <= iLength; lOffset += 16) {
+        const __m128i lBlock =
+          _mm_loadu_si128 (reinterpret_cast<const __m128i*> (iString
+                                                             + lOffset));
+        const unsigned int lCaretMask =
+          _mm_movemask_epi8 (_mm_cmpeq_epi8 (lBlock, lCaret));
+        const unsigned int lPipeMask =
+          _mm_movemask_epi8 (_mm_cmpeq_epi8 (lBlock, lPipe));
+        const unsigned int lEqualMask =
+          _mm_movemask_epi8 (_mm_cmpeq_epi8 (lBlock, lEqual));
+        const unsigned int lCommaMask =
+          _mm_movemask_epi8 (_mm_cmpeq_epi8 (lBlock, lComma));
+
+        // Most of the blocks (e.g., within the names) hold no separator
+        if ((lCaretMask | lPipeMask | lEqualMask | lCommaMask) == 0) {
+          continue;
+        }
+
+        appendOffsets (lCaretMask, lOffset, ioIndex._caretList);
+        appendOffsets (lPipeMask, lOffset, ioIndex._pipeList);
+        appendOffsets (lEqualMask, lOffset, ioIndex._equalList);
+        appendOffsets (lCommaMask, lOffset, ioIndex._commaList);
+      }
+
+      return lOffset;
+    }
+#endif // OPENTREP_POR_SEPARATOR_SSE2
+
+#if defined(OPENTREP_POR_SEPARATOR_AVX2)
+    // //////////////////////////////////////////////////////////////////
+    /**
+     * Whether the CPU supports the AVX2 instructions.
+     */
+    bool hasAVX2() {
+      static const bool lHasAVX2 = (__builtin_cpu_supports ("avx2") != 0);
+      return lHasAVX2;
+    }
+
+    // //////////////////////////////////////////////////////////////////
+    /**
+     * Locate the separators by blocks of 32 bytes, from the given offset.
+     *
+     * @return unsigned int Offset of the remaining bytes (less than 32).
+     */
+    __attribute__ ((target ("avx2")))
+    unsigned int indexSeparatorsAVX2 (const char* iString,
+                                      const unsigned int iOffset,
+                                      const unsigned int iLength,
+                                      SeparatorIndex& ioIndex) {
+      const __m256i lCaret = _mm256_set1_epi8 ('^');
+      const __m256i lPipe = _mm256_set1_epi8 ('|');
+      const __m256i lEqual = _mm256_set1_epi8 ('=');
+      const __m256i lComma = _mm256_set1_epi8 (',');
+
+      unsigned int lOffset = iOffset;
+      for ( ; lOffset + 32 <= iLength; lOffset += 32) {
+        const __m256i lBlock =
+          _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (iString
+                                                                + lOffset));
+        const unsigned int lCaretMask =
+          _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (lBlock, lCaret));
+        const unsigned int lPipeMask =
+          _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (lBlock, lPipe));
+        const unsigned int lEqualMask =
+          _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (lBlock, lEqual));
+        const unsigned int lCommaMask =
+          _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (lBlock, lComma));
+
+        // Most of the blocks (e.g., within the names) hold no separator
+        if ((lCaretMask | lPipeMask | lEqualMask | lCommaMask) == 0) {
+          continue;
+        }
+
+        appendOffsets (lCaretMask, lOffset, ioIndex._caretList);
+        appendOffsets (lPipeMask, lOffset, ioIndex._pipeList);
+        appendOffsets (lEqualMask, lOffset, ioIndex._equalList);
+        appendOffsets (lCommaMask, lOffset, ioIndex._commaList);
+      }
+
+      return lOffset;
+    }
+#endif // OPENTREP_POR_SEPARATOR_AVX2
+
+    // //////////////////////////////////////////////////////////////////
+    void indexSeparators (const char* iString, const unsigned int iLength,
+                          SeparatorIndex& ioIndex) {
+      ioIndex.clear();
+
+      unsigned int lOffset = 0;
+#if defined(OPENTREP_POR_SEPARATOR_AVX2)
+      if (hasAVX2() == true) {
+        lOffset = indexSeparatorsAVX2 (iString, lOffset, iLength, ioIndex);
+      }
+#endif // OPENTREP_POR_SEPARATOR_AVX2
+
+#if defined(OPENTREP_POR_SEPARATOR_SSE2)
+      lOffset = indexSeparatorsSSE2 (iString, lOffset, iLength, ioIndex);
+#endif // OPENTREP_POR_SEPARATOR_SSE2
+
+      indexSeparatorsScalar (iString, lOffset, iLength, ioIndex);
+    }
+
+    // //////////////////////////////////////////////////////////////////
+    const std::string& getInstructionSetName() {
+#if defined(OPENTREP_POR_SEPARATOR_AVX2)
+      static const std::string lAVX2Name ("AVX2");
+      if (hasAVX2() == true) {
+        return lAVX2Name;
+      }
+#endif // OPENTREP_POR_SEPARATOR_AVX2
+
+#if defined(OPENTREP_POR_SEPARATOR_SSE2)
+      static const std::string lSSE2Name ("SSE2");
+      return lSSE2Name;
+#else // OPENTREP_POR_SEPARATOR_SSE2
+      static const std::string lScalarName ("scalar");
+      return lScalarName;
+#endif // OPENTREP_POR_SEPARATOR_SSE2
+    }
+
+    // //////////////////////////////////////////////////////////////////
+    Field trim (const Field& iField) {
+      const char* lBegin = iField._begin;
+      const char* lEnd = iField._end;
+      while (lBegin != lEnd && isSpace (*lBegin) == true) {
+        ++lBegin;
+      }
+      while (lEnd != lBegin && isSpace (*(lEnd - 1)) == true) {
+        --lEnd;
+      }
+      return Field (lBegin, lEnd);
+    }
+
+    // //////////////////////////////////////////////////////////////////
+    Field skipSpaces (const Field& iField) {
+      const char* lBegin = iField._begin;
+      while (lBegin != iField._end && isSpace (*lBegin) == true) {
+        ++lBegin;
+      }
+      return Field (lBegin, iField._end);
+    }
+
+    // //////////////////////////////////////////////////////////////////
+    std::string compact (const Field& iField) {
+      std::string oCode;
+      for (const char* itChar = iField._begin; itChar != iField._end;
+           ++itChar) {
+        if (isSpace (*itChar) == false) {
+          oCode.push_back (*itChar);
+        }
+      }
+      return oCode;
+    }
+
+    // //////////////////////////////////////////////////////////////////
+    bool splitRecord (const char* iString, const unsigned int iLength,
+                      const SeparatorOffsetList_T& iCaretList,
+                      FieldList_T& ioFieldList) {
+      ioFieldList.clear();
+
+      const unsigned int lNbOfCarets = iCaretList.size();
+      if (lNbOfCarets + 1 < K_NB_OF_POR_FIELDS) {
+        return false;
+      }
+      const unsigned int lNbOfAltNameCarets =
+        lNbOfCarets + 1 - K_NB_OF_POR_FIELDS;
+
+      const char* lFieldBegin = iString;
+      for (unsigned int idx = 0; idx != lNbOfCarets; ++idx) {
+        if (idx >= K_ALT_NAME_SECTION
+            && idx < K_ALT_NAME_SECTION + lNbOfAltNameCarets) {
+          continue;
+        }
+        const char* lCaret = iString + iCaretList[idx];
+        ioFieldList.push_back (skipSpaces (Field (lFieldBegin, lCaret)));
+        lFieldBegin = lCaret + 1;
+      }
+      ioFieldList.push_back (skipSpaces (Field (lFieldBegin,
+                                                iString + iLength)));
+      assert (ioFieldList.size() == K_NB_OF_POR_FIELDS);
+      return true;
+    }
+
+  }
+
+  namespace {
+
+    using namespace PorFastParserHelper;
+
+    /** Character sets of the codes. */
+    const std::string K_UPPER_CHARS ("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    const std::string K_UPPER_DIGIT_CHARS (K_UPPER_CHARS + "0123456789");
+    const std::string K_FEAT_CODE_CHARS (K_UPPER_CHARS + "12345");
+    const std::string K_POR_TYPE_CHARS ("ABCGHOPRZ");
+    const std::string K_LOCODE_QUALIFIER_CHARS ("hp");
+    const std::string K_ALT_NAME_QUALIFIER_CHARS ("shpc");
+
+    // ////////////////////////////////////////////////////////////////////
+    /**
+     * Whether the field holds nothing but spaces.
+     */
+    inline bool isBlank (const Field& iField) {
+      return trim (iField).empty();
+    }
+
+    // ////////////////////////////////////////////////////////////////////
+    /**
+     * Whether the field holds the given character.
+     */
+    inline bool contains (const Field& iField, const char iChar) {
+      return (std::find (iField._begin, iField._end, iChar) != iField._end);
+    }
+
+    // ////////////////////////////////////////////////////////////////////
+    /**
+     * Extract a code (see compact()), and check its length and characters.
+     *
+     * @return bool False when the code does not comply. An empty code
+     *         complies, whatever the minimal length.
+     */
+    bool getCode (const Field& iField, const unsigned short iMinLength,
+                  const unsigned short iMaxLength,
+                  const std::string& iCharSet, std::string& oCode) {
+      oCode = compact (iField);
+      if (oCode.empty() == true) {
+        return true;
+      }
+      if (oCode.size() < iMinLength || oCode.size() > iMaxLength) {
+        return false;
+      }
+      return (oCode.find_first_not_of (iCharSet) == std::string::npos);
+    }
+
+    // ////////////////////////////////////////////////////////////////////
+    /**
+     * Convert a field formatted as YYYY-MM-DD into the staging date of the
+     * Location structure.
+     *
+     * @return bool False when the field is not formatted as expected.
+     */
+    bool getDate (const Field& iField, Location& ioLocation) {
+      const Field lField = trim (iField);
+      if (lField._end - lField._begin != 10
+          || lField._begin[4] != '-' || lField._begin[7] != '-') {
+        return false;
+      }
+
+      int lYear = 0;
+      int lMonth = 0;
+      int lDay = 0;
+      OPENTREP::uint4_p_t lYearParser;
+      OPENTREP::uint2_p_t lMonthDayParser;
+      if (getNumber (Field (lField._begin, lField._begin + 4),
+                     lYearParser, lYear) == false
+          || getNumber (Field (lField._begin + 5, lField._begin + 7),
+                        lMonthDayParser, lMonth) == false
+          || getNumber (Field (lField._begin + 8, lField._end),
+                        lMonthDayParser, lDay) == false) {
+        return false;
+      }
+
+      ioLocation._itYear = year_t (lYear);
+      ioLocation._itMonth = month_t (lMonth);
+      ioLocation._itDay = day_t (lDay);
+      return true;
+    }
+
+    // ////////////////////////////////////////////////////////////////////
+    /**
+     * Split a field into pieces, at the given separators. As with the
+     * Spirit grammar, the leading spaces of every piece are skipped.
+     *
+     * @param const Field& Field to be split.
+     * @param const char* Beginning of the POR record, to which the offsets
+     *        of the separators are relative.
+     * @param const SeparatorOffsetList_T& Sorted offsets of the separators
+     *        within the whole POR record.
+     * @param FieldList_T& List of pieces, filled by the function.
+     */
+    void splitField (const Field& iField, const char* iString,
+                     const PorFastParserHelper::SeparatorOffsetList_T& iList,
+                     FieldList_T& ioPieceList) {
+      ioPieceList.clear();
+
+      const unsigned int lEndOffset = iField._end - iString;
+      PorFastParserHelper::SeparatorOffsetList_T::const_iterator itOffset =
+        std::lower_bound (iList.begin(), iList.end(),
+                          static_cast<unsigned int> (iField._begin
+                                                     - iString));
+      const char* lPieceBegin = iField._begin;
+      for ( ; itOffset != iList.end() && *itOffset < lEndOffset; ++itOffset) {
+        const char* lSeparator = iString + *itOffset;
+        ioPieceList.push_back (skipSpaces (Field (lPieceBegin, lSeparator)));
+        lPieceBegin = lSeparator + 1;
+      }
+      ioPieceList.push_back (skipSpaces (Field (lPieceBegin, iField._end)));
+    }
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////
+  //
+  //  Entry class for the SIMD string parser
+  //
+  /////////////////////////////////////////////////////////////////////////
+
+  // //////////////////////////////////////////////////////////////////////
+  PORFastStringParser::PORFastStringParser (const std::string& iString,
+                                            Location& ioLocation)
+    : _string (iString), _location (ioLocation) {
+    init();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PORFastStringParser::init() {
+    // Store the raw data string
+    _location.setRawDataString (_string);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORFastStringParser::~PORFastStringParser() {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PORFastStringParser::
+  throwParsingError (const std::string& iReason) const {
+    std::ostringstream oStr;
+    oStr << "Parsing of POR input string: '" << _string << "' failed ("
+         << iReason << ")";
+    OPENTREP_LOG_ERROR (oStr.str());
+    throw PorFileParsingException (oStr.str());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const Location& PORFastStringParser::generateLocation() {
+    const char* lString = _string.c_str();
+    const Field lRecord (lString, lString + _string.size());
+
+    // Neither the empty strings nor the header line hold any POR
+    const Field lTrimmedRecord = trim (lRecord);
+    const std::string lHeaderPrefix ("iata_code");
+    if (lTrimmedRecord.empty() == true
+        || _string.compare (lTrimmedRecord._begin - lString,
+                            lHeaderPrefix.size(), lHeaderPrefix) == 0) {
+      return _location;
+    }
+
+    // Locate all the separators at once
+    PorFastParserHelper::indexSeparators (lString, _string.size(),
+                                          _separatorIndex);
+
+    // Split the record into its fields
+    FieldList_T lFieldList;
+    lFieldList.reserve (K_NB_OF_POR_FIELDS);
+    if (PorFastParserHelper::splitRecord (lString, _string.size(),
+                                          _separatorIndex._caretList,
+                                          lFieldList) == false) {
+      std::ostringstream oStr;
+      oStr << _separatorIndex._caretList.size() + 1 << " fields, whereas "
+           << K_NB_OF_POR_FIELDS << " are expected";
+      throwParsingError (oStr.str());
+    }
+
+    FieldList_T lPieceList;
+    FieldList_T lDetailList;
+    std::string lCode;
+
+    // //////// POR key ////////
+    if (getCode (lFieldList[K_IATA_CODE], 3, 3, K_UPPER_CHARS,
+                 lCode) == false) {
+      throwParsingError ("IATA code");
+    }
+    if (lCode.empty() == false) {
+      _location.setIataCode (lCode);
+    }
+
+    if (getCode (lFieldList[K_ICAO_CODE], 4, 4, K_UPPER_DIGIT_CHARS,
+                 lCode) == false) {
+      throwParsingError ("ICAO code");
+    }
+    if (lCode.empty() == false) {
+      _location.setIcaoCode (lCode);
+    }
+
+    if (getCode (lFieldList[K_FAA_CODE], 1, 4, K_UPPER_DIGIT_CHARS,
+                 lCode) == false) {
+      throwParsingError ("FAA code");
+    }
+    if (lCode.empty() == false) {
+      _location.setFaaCode (lCode);
+    }
+
+    bool lIsGeonames = false;
+    OPENTREP::boolean_p_t lBooleanParser;
+    if (getNumber (lFieldList[K_IS_GEONAMES], lBooleanParser,
+                   lIsGeonames) == false) {
+      throwParsingError ("Geonames flag");
+    }
+
+    int lGeonamesID = 0;
+    OPENTREP::uint1_9_p_t lUInt1To9Parser;
+    if (getNumber (lFieldList[K_GEONAME_ID], lUInt1To9Parser,
+                   lGeonamesID) == false) {
+      throwParsingError ("Geonames ID");
+    }
+    _location.setGeonamesID (lGeonamesID);
+
+    OPENTREP::uint1_4_p_t lUInt1To4Parser;
+    if (isBlank (lFieldList[K_ENVELOPE_ID]) == false) {
+      int lEnvelopeID = 0;
+      if (getNumber (lFieldList[K_ENVELOPE_ID], lUInt1To4Parser,
+                     lEnvelopeID) == false) {
+        throwParsingError ("envelope ID");
+      }
+      _location.setEnvelopeID (lEnvelopeID);
+    }
+
+    // //////// POR details ////////
+    // The names are kept as they are, but for the leading spaces
+    if (lFieldList[K_COMMON_NAME].empty() == true) {
+      throwParsingError ("common name");
+    }
+    _location.setCommonName (lFieldList[K_COMMON_NAME].str());
+
+    if (lFieldList[K_ASCII_NAME].empty() == true) {
+      throwParsingError ("ASCII name");
+    }
+    _location.setAsciiName (lFieldList[K_ASCII_NAME].str());
+
+    if (isBlank (lFieldList[K_LATITUDE]) == false) {
+      double lLatitude = 0.0;
+      if (getNumber (lFieldList[K_LATITUDE], bsq::double_,
+                     lLatitude) == false) {
+        throwParsingError ("latitude");
+      }
+      _location.setLatitude (lLatitude);
+    }
+
+    if (isBlank (lFieldList[K_LONGITUDE]) == false) {
+      double lLongitude = 0.0;
+      if (getNumber (lFieldList[K_LONGITUDE], bsq::double_,
+                     lLongitude) == false) {
+        throwParsingError ("longitude");
+      }
+      _location.setLongitude (lLongitude);
+    }
+
+    if (getCode (lFieldList[K_FEAT_CLASS], 1, 1, K_UPPER_CHARS,
+                 lCode) == false || lCode.empty() == true) {
+      throwParsingError ("feature class");
+    }
+    _location.setFeatureClass (lCode);
+
+    if (getCode (lFieldList[K_FEAT_CODE], 2, 5, K_FEAT_CODE_CHARS,
+                 lCode) == false || lCode.empty() == true) {
+      throwParsingError ("feature code");
+    }
+    _location.setFeatureCode (lCode);
+
+    if (isBlank (lFieldList[K_PAGE_RANK]) == false) {
+      double lPageRank = 0.0;
+      if (getNumber (lFieldList[K_PAGE_RANK], bsq::double_,
+                     lPageRank) == false) {
+        throwParsingError ("PageRank");
+      }
+      _location.setPageRank (100.0 * lPageRank);
+    }
+
+    if (isBlank (lFieldList[K_DATE_FROM]) == false) {
+      if (getDate (lFieldList[K_DATE_FROM], _location) == false) {
+        throwParsingError ("beginning date");
+      }
+      const Date_T& lDateFrom = _location.calculateDate();
+      _location.setDateFrom (lDateFrom);
+    }
+
+    if (isBlank (lFieldList[K_DATE_END]) == false) {
+      if (getDate (lFieldList[K_DATE_END], _location) == false) {
+        throwParsingError ("end date");
+      }
+      const Date_T& lDateEnd = _location.calculateDate();
+      _location.setDateEnd (lDateEnd);
+    }
+
+    // The comments (K_COMMENT) are not stored
+
+    if (getCode (lFieldList[K_COUNTRY_CODE], 2, 3, K_UPPER_CHARS,
+                 lCode) == false || lCode.empty() == true) {
+      throwParsingError ("country code");
+    }
+    _location.setCountryCode (lCode);
+
+    if (lFieldList[K_COUNTRY_CODE2].empty() == false) {
+      _location.setAltCountryCode (lFieldList[K_COUNTRY_CODE2].str());
+    }
+
+    if (lFieldList[K_COUNTRY_NAME].empty() == true) {
+      throwParsingError ("country name");
+    }
+    _location.setCountryName (lFieldList[K_COUNTRY_NAME].str());
+
+    if (lFieldList[K_CONTINENT_NAME].empty() == false) {
+      _location.setContinentName (lFieldList[K_CONTINENT_NAME].str());
+    }
+
+    if (lFieldList[K_ADM1_CODE].empty() == false) {
+      _location.setAdmin1Code (lFieldList[K_ADM1_CODE].str());
+    }
+    if (lFieldList[K_ADM1_NAME_UTF].empty() == false) {
+      _location.setAdmin1UtfName (lFieldList[K_ADM1_NAME_UTF].str());
+    }
+    if (lFieldList[K_ADM1_NAME_ASCII].empty() == false) {
+      _location.setAdmin1AsciiName (lFieldList[K_ADM1_NAME_ASCII].str());
+    }
+    if (lFieldList[K_ADM2_CODE].empty() == false) {
+      _location.setAdmin2Code (lFieldList[K_ADM2_CODE].str());
+    }
+    if (lFieldList[K_ADM2_NAME_UTF].empty() == false) {
+      _location.setAdmin2UtfName (lFieldList[K_ADM2_NAME_UTF].str());
+    }
+    if (lFieldList[K_ADM2_NAME_ASCII].empty() == false) {
+      _location.setAdmin2AsciiName (lFieldList[K_ADM2_NAME_ASCII].str());
+    }
+    if (lFieldList[K_ADM3_CODE].empty() == false) {
+      _location.setAdmin3Code (lFieldList[K_ADM3_CODE].str());
+    }
+    if (lFieldList[K_ADM4_CODE].empty() == false) {
+      _location.setAdmin4Code (lFieldList[K_ADM4_CODE].str());
+    }
+
+    if (isBlank (lFieldList[K_POPULATION]) == false) {
+      int lPopulation = 0;
+      if (getNumber (lFieldList[K_POPULATION], lUInt1To9Parser,
+                     lPopulation) == false) {
+        throwParsingError ("population");
+      }
+      _location.setPopulation (lPopulation);
+    }
+
+    OPENTREP::int1_5_p_t lInt1To5Parser;
+    if (isBlank (lFieldList[K_ELEVATION]) == false) {
+      int lElevation = 0;
+      if (getNumber (lFieldList[K_ELEVATION], lInt1To5Parser,
+                     lElevation) == false) {
+        throwParsingError ("elevation");
+      }
+      _location.setElevation (lElevation);
+    }
+
+    if (isBlank (lFieldList[K_GTOPO30]) == false) {
+      int lGTopo30 = 0;
+      if (getNumber (lFieldList[K_GTOPO30], lInt1To5Parser,
+                     lGTopo30) == false) {
+        throwParsingError ("GTopo30");
+      }
+      _location.setGTopo30 (lGTopo30);
+    }
+
+    if (lFieldList[K_TIME_ZONE].empty() == false) {
+      _location.setTimeZone (lFieldList[K_TIME_ZONE].str());
+    }
+
+    if (isBlank (lFieldList[K_GMT_OFFSET]) == false) {
+      float lOffset = 0.0;
+      if (getNumber (lFieldList[K_GMT_OFFSET], bsq::float_,
+                     lOffset) == false) {
+        throwParsingError ("GMT offset");
+      }
+      _location.setGMTOffset (lOffset);
+    }
+
+    if (isBlank (lFieldList[K_DST_OFFSET]) == false) {
+      float lOffset = 0.0;
+      if (getNumber (lFieldList[K_DST_OFFSET], bsq::float_,
+                     lOffset) == false) {
+        throwParsingError ("DST offset");
+      }
+      _location.setDSTOffset (lOffset);
+    }
+
+    if (isBlank (lFieldList[K_RAW_OFFSET]) == false) {
+      float lOffset = 0.0;
+      if (getNumber (lFieldList[K_RAW_OFFSET], bsq::float_,
+                     lOffset) == false) {
+        throwParsingError ("raw offset");
+      }
+      _location.setRawOffset (lOffset);
+    }
+
+    // The modification date is either a date or -1
+    if (trim (lFieldList[K_MOD_DATE]).str() != "-1") {
+      if (getDate (lFieldList[K_MOD_DATE], _location) == false) {
+        throwParsingError ("modification date");
+      }
+      const Date_T& lModDate = _location.calculateDate();
+      _location.setModificationDate (lModDate);
+    }
+
+    // List of the IATA codes of the served cities, separated by commas
+    if (isBlank (lFieldList[K_CITY_CODE_LIST]) == false) {
+      splitField (lFieldList[K_CITY_CODE_LIST], lString,
+                  _separatorIndex._commaList, lPieceList);
+      for (FieldList_T::const_iterator itPiece = lPieceList.begin();
+           itPiece != lPieceList.end(); ++itPiece) {
+        if (getCode (*itPiece, 3, 3, K_UPPER_CHARS, lCode) == false
+            || lCode.empty() == true) {
+          throwParsingError ("list of city codes");
+        }
+        _location._itCityIataCode = lCode;
+      }
+    }
+
+    // List of the names of the served cities, separated by equal signs
+    if (lFieldList[K_CITY_NAME_LIST].empty() == false) {
+      splitField (lFieldList[K_CITY_NAME_LIST], lString,
+                  _separatorIndex._equalList, lPieceList);
+      for (FieldList_T::const_iterator itPiece = lPieceList.begin();
+           itPiece != lPieceList.end(); ++itPiece) {
+        if (itPiece->empty() == true || contains (*itPiece, '|') == true) {
+          throwParsingError ("list of city names");
+        }
+        _location._itCityUtfName = itPiece->str();
+      }
+    }
+
+    // Details of the served city, i.e., code|geoid|utf|ascii|cc|state.
+    // As with the Spirit grammar, the state code extends up to the end
+    // of the field, so that there is never more than one city detail
+    if (lFieldList[K_CITY_DETAIL_LIST].empty() == false) {
+      splitField (lFieldList[K_CITY_DETAIL_LIST], lString,
+                  _separatorIndex._pipeList, lPieceList);
+      if (lPieceList.size() < 6) {
+        throwParsingError ("city details");
+      }
+
+      if (getCode (lPieceList[0], 3, 3, K_UPPER_CHARS, lCode) == false
+          || lCode.empty() == true) {
+        throwParsingError ("city code");
+      }
+      _location._itCityIataCode = lCode;
+
+      int lCityGeonamesID = 0;
+      if (getNumber (lPieceList[1], lUInt1To9Parser,
+                     lCityGeonamesID) == false) {
+        throwParsingError ("city Geonames ID");
+      }
+      _location._itCityGeonamesID = lCityGeonamesID;
+
+      if (lPieceList[2].empty() == true || contains (lPieceList[2], '=')) {
+        throwParsingError ("city UTF8 name");
+      }
+      _location._itCityUtfName = lPieceList[2].str();
+
+      if (lPieceList[3].empty() == true || contains (lPieceList[3], '=')) {
+        throwParsingError ("city ASCII name");
+      }
+      _location._itCityAsciiName = lPieceList[3].str();
+
+      if (getCode (lPieceList[4], 2, 3, K_UPPER_CHARS, lCode) == false) {
+        throwParsingError ("city country code");
+      }
+      if (lCode.empty() == false) {
+        _location._itCityCountryCode = lCode;
+      }
+
+      const Field lStateCode (lPieceList[5]._begin,
+                              lFieldList[K_CITY_DETAIL_LIST]._end);
+      if (lStateCode.empty() == false) {
+        _location._itCityStateCode = lStateCode.str();
+      }
+
+      _location.consolidateCityDetailsList();
+    }
+
+    // List of the travel-related POR, separated by commas
+    if (lFieldList[K_TVL_POR_LIST].empty() == false) {
+      splitField (lFieldList[K_TVL_POR_LIST], lString,
+                  _separatorIndex._commaList, lPieceList);
+      for (FieldList_T::const_iterator itPiece = lPieceList.begin();
+           itPiece != lPieceList.end(); ++itPiece) {
+        if (itPiece->empty() == true) {
+          throwParsingError ("list of travel-related POR");
+        }
+        _location._itTvlPORList.push_back (IATACode_T (itPiece->str()));
+      }
+      _location.consolidateTvlPORListString();
+    }
+
+    if (lFieldList[K_STATE_CODE].empty() == false) {
+      _location.setStateCode (lFieldList[K_STATE_CODE].str());
+    }
+
+    if (getCode (lFieldList[K_POR_TYPE], 1, 3, K_POR_TYPE_CHARS,
+                 lCode) == false || lCode.empty() == true) {
+      throwParsingError ("POR type");
+    }
+    _location.setIataType (IATAType (lCode));
+
+    if (lFieldList[K_WIKI_LINK].empty() == false) {
+      _location.setWikiLink (lFieldList[K_WIKI_LINK].str());
+    }
+
+    // //////// Alternate names ////////
+    // List of lang|name|qualifiers, separated by equal signs
+    if (isBlank (lFieldList[K_ALT_NAME_SECTION]) == false) {
+      splitField (lFieldList[K_ALT_NAME_SECTION], lString,
+                  _separatorIndex._equalList, lPieceList);
+      for (FieldList_T::const_iterator itPiece = lPieceList.begin();
+           itPiece != lPieceList.end(); ++itPiece) {
+        splitField (*itPiece, lString, _separatorIndex._pipeList,
+                    lDetailList);
+        if (lDetailList.size() != 3 || contains (lDetailList[0], '^') == true
+            || lDetailList[1].empty() == true) {
+          throwParsingError ("alternate names");
+        }
+
+        lCode = compact (lDetailList[0]);
+        if (lCode.empty() == false) {
+          _location._itLanguageCode = LanguageCode_T (lCode);
+        }
+
+        _location.addName (_location._itLanguageCode, lDetailList[1].str());
+        _location._itLanguageCode = LanguageCode_T ("");
+
+        if (getCode (lDetailList[2], 1, 4, K_ALT_NAME_QUALIFIER_CHARS,
+                     lCode) == false) {
+          throwParsingError ("qualifiers of alternate names");
+        }
+      }
+    }
+
+    // //////// Additional POR details ////////
+    int lWAC = 0;
+    if (getNumber (lFieldList[K_WAC], lUInt1To4Parser, lWAC) == false) {
+      throwParsingError ("WAC");
+    }
+    _location.setWAC (lWAC);
+
+    if (lFieldList[K_WAC_NAME].empty() == true) {
+      throwParsingError ("WAC name");
+    }
+    _location.setWACName (lFieldList[K_WAC_NAME].str());
+
+    if (lFieldList[K_CCY_CODE].empty() == false) {
+      _location.setCurrencyCode (lFieldList[K_CCY_CODE].str());
+    }
+
+    // List of code|qualifiers, separated by equal signs
+    if (isBlank (lFieldList[K_UNLC_LIST]) == false) {
+      splitField (lFieldList[K_UNLC_LIST], lString,
+                  _separatorIndex._equalList, lPieceList);
+      for (FieldList_T::const_iterator itPiece = lPieceList.begin();
+           itPiece != lPieceList.end(); ++itPiece) {
+        splitField (*itPiece, lString, _separatorIndex._pipeList,
+                    lDetailList);
+        if (lDetailList.size() != 2
+            || getCode (lDetailList[0], 5, 5, K_UPPER_DIGIT_CHARS,
+                        lCode) == false || lCode.empty() == true) {
+          throwParsingError ("UN/LOCODE codes");
+        }
+        _location.addUNLOCode (UNLOCode_T (lCode));
+
+        if (getCode (lDetailList[1], 1, 2, K_LOCODE_QUALIFIER_CHARS,
+                     lCode) == false) {
+          throwParsingError ("qualifiers of UN/LOCODE codes");
+        }
+      }
+    }
+
+    // List of code|qualifiers, separated by equal signs
+    if (isBlank (lFieldList[K_UIC_LIST]) == false) {
+      splitField (lFieldList[K_UIC_LIST], lString,
+                  _separatorIndex._equalList, lPieceList);
+      for (FieldList_T::const_iterator itPiece = lPieceList.begin();
+           itPiece != lPieceList.end(); ++itPiece) {
+        splitField (*itPiece, lString, _separatorIndex._pipeList,
+                    lDetailList);
+        int lUICCode = 0;
+        if (lDetailList.size() != 2
+            || getNumber (lDetailList[0], lUInt1To9Parser,
+                          lUICCode) == false) {
+          throwParsingError ("UIC codes");
+        }
+        _location.addUICCode (lUICCode);
+
+        if (getCode (lDetailList[1], 1, 2, K_LOCODE_QUALIFIER_CHARS,
+                     lCode) == false) {
+          throwParsingError ("qualifiers of UIC codes");
+        }
+      }
+    }
+
+    if (isBlank (lFieldList[K_GEONAME_LAT]) == false) {
+      double lLatitude = 0.0;
+      if (getNumber (lFieldList[K_GEONAME_LAT], bsq::double_,
+                     lLatitude) == false) {
+        throwParsingError ("Geonames latitude");
+      }
+      _location.setGeonameLatitude (lLatitude);
+    }
+
+    if (isBlank (lFieldList[K_GEONAME_LON]) == false) {
+      double lLongitude = 0.0;
+      if (getNumber (lFieldList[K_GEONAME_LON], bsq::double_,
+                     lLongitude) == false) {
+        throwParsingError ("Geonames longitude");
+      }
+      _location.setGeonameLongitude (lLongitude);
+    }
+
+    return _location;
+  }
+
+}
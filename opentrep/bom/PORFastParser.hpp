@@ -0,0 +1,238 @@
+#ifndef __OPENTREP_BOM_PORFASTPARSER_HPP
+#define __OPENTREP_BOM_PORFASTPARSER_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+#include <vector>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/Location.hpp>
+#include <opentrep/CityDetails.hpp>
+#include <opentrep/basic/BasParserTypes.hpp>
+
+namespace OPENTREP {
+
+  namespace PorFastParserHelper {
+
+    /** List of offsets, within a POR record, of a given separator. */
+    typedef std::vector<unsigned int> SeparatorOffsetList_T;
+
+    /**
+     * @brief Offsets of the separators of a POR record, sorted by kind
+     *        of separator.
+     *
+     * The fields of a POR record are separated by carets ('^'); within
+     * some fields, the items of the lists are separated by equal signs
+     * ('='), the details of those items by pipes ('|'), and the codes of
+     * the lists of cities and of travel-related POR by commas (',').
+     */
+    struct SeparatorIndex {
+      SeparatorOffsetList_T _caretList;
+      SeparatorOffsetList_T _pipeList;
+      SeparatorOffsetList_T _equalList;
+      SeparatorOffsetList_T _commaList;
+
+      /** Empty all the lists, keeping the memory already allocated. */
+      void clear();
+    };
+
+    /**
+     * Locate, in a single pass, all the separators of the given POR
+     * record. The record is scanned by blocks of 32 bytes with AVX2
+     * instructions when the CPU supports them (that is checked at run-time),
+     * by blocks of 16 bytes with SSE2 instructions otherwise, and byte
+     * after byte on the architectures lacking both.
+     *
+     * @param const char* Beginning of the POR record.
+     * @param const unsigned int Length of the POR record.
+     * @param SeparatorIndex& Lists of offsets, filled by the method.
+     */
+    void indexSeparators (const char*, const unsigned int, SeparatorIndex&);
+
+    /**
+     * Get the name of the instruction set used by indexSeparators(),
+     * i.e., "AVX2", "SSE2" or "scalar".
+     */
+    const std::string& getInstructionSetName();
+
+    /**
+     * Rank of the fields within a POR record.
+     */
+    enum EN_PORField {
+      K_IATA_CODE = 0, K_ICAO_CODE, K_FAA_CODE, K_IS_GEONAMES,
+      K_GEONAME_ID, K_ENVELOPE_ID,
+      K_COMMON_NAME, K_ASCII_NAME, K_LATITUDE, K_LONGITUDE,
+      K_FEAT_CLASS, K_FEAT_CODE, K_PAGE_RANK, K_DATE_FROM, K_DATE_END,
+      K_COMMENT, K_COUNTRY_CODE, K_COUNTRY_CODE2, K_COUNTRY_NAME,
+      K_CONTINENT_NAME,
+      K_ADM1_CODE, K_ADM1_NAME_UTF, K_ADM1_NAME_ASCII,
+      K_ADM2_CODE, K_ADM2_NAME_UTF, K_ADM2_NAME_ASCII,
+      K_ADM3_CODE, K_ADM4_CODE,
+      K_POPULATION, K_ELEVATION, K_GTOPO30,
+      K_TIME_ZONE, K_GMT_OFFSET, K_DST_OFFSET, K_RAW_OFFSET, K_MOD_DATE,
+      K_CITY_CODE_LIST, K_CITY_NAME_LIST, K_CITY_DETAIL_LIST,
+      K_TVL_POR_LIST, K_STATE_CODE, K_POR_TYPE, K_WIKI_LINK,
+      K_ALT_NAME_SECTION,
+      K_WAC, K_WAC_NAME, K_CCY_CODE, K_UNLC_LIST, K_UIC_LIST,
+      K_GEONAME_LAT, K_GEONAME_LON,
+      K_NB_OF_POR_FIELDS
+    };
+
+    /**
+     * Slice of a POR record, between two separators.
+     */
+    struct Field {
+      Field (const char* iBegin, const char* iEnd)
+        : _begin (iBegin), _end (iEnd) {
+      }
+      bool empty() const {
+        return (_begin == _end);
+      }
+      std::string str() const {
+        return std::string (_begin, _end);
+      }
+      const char* _begin;
+      const char* _end;
+    };
+    typedef std::vector<Field> FieldList_T;
+
+    /**
+     * Whether the character is skipped by the Spirit grammar, the skipper
+     * of which is boost::spirit::ascii::space.
+     */
+    inline bool isSpace (const char iChar) {
+      return (iChar == ' ' || (iChar >= '\t' && iChar <= '\r'));
+    }
+
+    /**
+     * Remove the leading and trailing spaces, skipped by the Spirit
+     * grammar around the numbers and dates.
+     */
+    Field trim (const Field&);
+
+    /**
+     * Remove the leading spaces. The Spirit grammar skips them before every
+     * field, the names included (bsq::no_skip[] does not prevent that
+     * pre-skip), so that a field made of spaces only is seen as empty.
+     */
+    Field skipSpaces (const Field&);
+
+    /**
+     * Extract the field without any space, as the Spirit grammar skips
+     * the spaces within the codes as well.
+     */
+    std::string compact (const Field&);
+
+    /**
+     * Convert the field into a number, with the given Spirit primitive
+     * parser (the very same as the one of the grammar).
+     *
+     * @return bool False when the whole field is not a number.
+     */
+    template <typename PARSER, typename VALUE>
+    bool getNumber (const Field& iField, const PARSER& iParser,
+                    VALUE& oValue) {
+      const Field lField = trim (iField);
+      const char* itChar = lField._begin;
+      const bool hasBeenParsed =
+        boost::spirit::qi::parse (itChar, lField._end, iParser, oValue);
+      return (hasBeenParsed == true && itChar == lField._end);
+    }
+
+    /**
+     * Split a POR record into its K_NB_OF_POR_FIELDS fields, the leading
+     * spaces of which are skipped. As with the Spirit grammar, the
+     * alternate names may hold carets: the fields before the alternate
+     * names are delimited by the first carets, and the fields after them
+     * by the last ones.
+     *
+     * @param const char* Beginning of the POR record.
+     * @param const unsigned int Length of the POR record.
+     * @param const SeparatorOffsetList_T& Offsets of the carets of the
+     *        POR record (see indexSeparators()).
+     * @param FieldList_T& List of fields, filled by the function.
+     * @return bool False when the POR record has too few fields.
+     */
+    bool splitRecord (const char*, const unsigned int,
+                      const SeparatorOffsetList_T&, FieldList_T&);
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////
+  //
+  //  Entry class for the SIMD string parser
+  //
+  /////////////////////////////////////////////////////////////////////////
+  /**
+   * @brief Hand-written parser of a POR record, alternative to the Boost
+   *        Spirit grammar of PORStringParser.
+   *
+   * The separators of the record are located with SIMD instructions (see
+   * PorFastParserHelper::indexSeparators()), and the fields of the Location
+   * structure are filled directly from the slices between those separators.
+   * The numbers are converted with the same Spirit primitive parsers as
+   * the ones of the grammar, and the text fields follow the same rules
+   * (e.g., the names are kept as is, whereas the spaces are ignored within
+   * the codes), so that both parsers give the same Location structures.
+   * That may be cross-checked at run-time (see PORParserType::CROSS_CHECK).
+   *
+   * A PorFileParsingException is thrown when the record does not comply
+   * with the format of the OPTD POR file.
+   *
+   * The Location structure is owned by the caller (e.g., PORStringParser),
+   * so that it does not need to be copied.
+   */
+  class PORFastStringParser {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param const std::string& String to be parsed.
+     * @param Location& Location structure to be filled by the parser.
+     */
+    PORFastStringParser (const std::string& iString, Location& ioLocation);
+
+    /**
+     * Destructor.
+     */
+    ~PORFastStringParser();
+
+    /**
+     * Parse the input string and generate the Location structures.
+     */
+    const Location& generateLocation();
+
+  private:
+    /**
+     * Initialise.
+     */
+    void init();
+
+    /**
+     * Throw a PorFileParsingException, after having logged the reason.
+     */
+    void throwParsingError (const std::string& iReason) const;
+
+  private:
+    // Attributes
+    /**
+     * String to be parsed (owned by the caller).
+     */
+    const std::string& _string;
+
+    /**
+     * POR Structure.
+     */
+    Location& _location;
+
+    /**
+     * Offsets of the separators of the string.
+     */
+    PorFastParserHelper::SeparatorIndex _separatorIndex;
+  };
+
+}
+#endif // __OPENTREP_BOM_PORFASTPARSER_HPP
@@ -12,6 +12,7 @@
 // OpenTREP
 #include <opentrep/basic/BasParserTypes.hpp>
 #include <opentrep/bom/PORParserHelper.hpp>
+#include <opentrep/bom/PORFastParser.hpp>
 #include <opentrep/service/Logger.hpp>
 
 namespace OPENTREP {
@@ -1555,7 +1556,7 @@ namespace OPENTREP {
           ;
 
         alt_lang_code =
-          (+~bsa::char_("|=")
+          (+~bsa::char_("^|=")
            - (bsq::eoi|bsq::eol))[storeAltLangCodeFull(_location)]
           ;
 
@@ -1711,10 +1712,38 @@ namespace OPENTREP {
   //  Entry class for the string parser
   //
   /////////////////////////////////////////////////////////////////////////
-    
+
+  // //////////////////////////////////////////////////////////////////////
+  boost::atomic<PORParserType::EN_PORParserType>
+  PORStringParser::_defaultParserType (PORParserType::SPIRIT);
+
+  // //////////////////////////////////////////////////////////////////////
+  void PORStringParser::setParserType (const PORParserType& iParserType) {
+    _defaultParserType.store (iParserType.getType());
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("The POR records are parsed by the "
+                        << iParserType.describe() << " parser (the SIMD "
+                        << "parser relying on the "
+                        << PorFastParserHelper::getInstructionSetName()
+                        << " instruction set)");
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORParserType PORStringParser::getParserType() {
+    return PORParserType (_defaultParserType.load());
+  }
+
   // //////////////////////////////////////////////////////////////////////
   PORStringParser::PORStringParser (const std::string& iString)
-    : _string (iString) {
+    : _string (iString), _parserType (_defaultParserType.load()) {
+    init();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORStringParser::PORStringParser (const std::string& iString,
+                                    const PORParserType& iParserType)
+    : _string (iString), _parserType (iParserType.getType()) {
     init();
   }
 
@@ -1730,6 +1759,63 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   const Location& PORStringParser::generateLocation() {
+    switch (_parserType) {
+    case PORParserType::SIMD: {
+      PORFastStringParser lFastParser (_string, _location);
+      return lFastParser.generateLocation();
+    }
+    case PORParserType::CROSS_CHECK:
+      return parseAndCrossCheck();
+    default:
+      return parseWithSpirit();
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const Location& PORStringParser::parseAndCrossCheck() {
+    // Parse with the Spirit grammar
+    bool hasSpiritSucceeded = true;
+    std::string lSpiritResult;
+    try {
+      lSpiritResult = parseWithSpirit().toString();
+    } catch (const RootException& lException) {
+      hasSpiritSucceeded = false;
+      lSpiritResult = lException.what();
+    }
+
+    // Parse with the SIMD parser. The numbers are converted by the same
+    // Spirit primitive parsers, so that the descriptions of the Location
+    // structures can be compared as they are
+    bool hasSIMDSucceeded = true;
+    std::string lSIMDResult;
+    try {
+      Location lSIMDLocation;
+      PORFastStringParser lFastParser (_string, lSIMDLocation);
+      lSIMDResult = lFastParser.generateLocation().toString();
+    } catch (const RootException& lException) {
+      hasSIMDSucceeded = false;
+      lSIMDResult = lException.what();
+    }
+
+    if (hasSpiritSucceeded != hasSIMDSucceeded
+        || (hasSpiritSucceeded == true && lSpiritResult != lSIMDResult)) {
+      std::ostringstream oStr;
+      oStr << "The Spirit and SIMD parsers differ on POR string '" << _string
+           << "'. Spirit: " << lSpiritResult << std::endl
+           << "SIMD: " << lSIMDResult;
+      OPENTREP_LOG_ERROR (oStr.str());
+      throw PorFileParsingException (oStr.str());
+    }
+
+    if (hasSpiritSucceeded == false) {
+      throw PorFileParsingException (lSpiritResult);
+    }
+
+    return _location;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const Location& PORStringParser::parseWithSpirit() {
     // DEBUG
     // OPENTREP_LOG_DEBUG ("Parsing POR string: '" << _string << "'");
 
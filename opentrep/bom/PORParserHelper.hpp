@@ -7,9 +7,11 @@
 // STL
 #include <string>
 // Boost
+#include <boost/atomic.hpp>
 #include <boost/spirit/include/qi.hpp>
 // Opentrep
 #include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/PORParserType.hpp>
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
 
@@ -674,14 +676,28 @@ namespace OPENTREP {
    * The seemingly redundancy is used to force the instantiation of
    * the actual parser, which is a templatised Boost Spirit grammar.
    * Hence, the actual parser is instantiated within that class object code.
+   *
+   * The string may rather be parsed by the SIMD field splitter (see
+   * PORFastStringParser), or by both parsers, cross-checked; that is
+   * selected at run-time, either for every parser object (as given by the
+   * service context), or for the whole process (see setParserType()).
    */
   class PORStringParser {
   public:
     /**
-     * Constructor.
+     * Constructor, with the parser type of the process (see
+     * setParserType()).
      */
     PORStringParser (const std::string& iString);
 
+    /**
+     * Constructor.
+     *
+     * @param const std::string& String to be parsed.
+     * @param const PORParserType& Type of the parser.
+     */
+    PORStringParser (const std::string& iString, const PORParserType&);
+
     /**
      * Destructor.
      */
@@ -691,13 +707,50 @@ namespace OPENTREP {
      * Parse the input string and generate the Location structures.
      */
     const Location& generateLocation();
+
+  public:
+    /**
+     * Select the parser used by the PORStringParser objects of the
+     * process which are not given any parser type (e.g., when decoding
+     * the raw data strings of the search results). The objects already
+     * created keep the parser type they were created with.
+     *
+     * @param const PORParserType& Type of the parser.
+     */
+    static void setParserType (const PORParserType&);
+
+    /**
+     * Get the type of the parser used by default by the PORStringParser
+     * objects.
+     */
+    static PORParserType getParserType();
       
   private:
     /**
      * Initialise.
      */
     void init();
-      
+
+    /**
+     * Parse the input string with the Boost Spirit grammar.
+     */
+    const Location& parseWithSpirit();
+
+    /**
+     * Parse the input string with both the Boost Spirit grammar and
+     * the SIMD parser, and check that both give the same Location
+     * structure, or reject the string altogether. A PorFileParsingException
+     * is thrown when they do not agree.
+     */
+    const Location& parseAndCrossCheck();
+
+  private:
+    /**
+     * Type of the parser used by default by the PORStringParser objects.
+     * It may be changed while other threads create parser objects.
+     */
+    static boost::atomic<PORParserType::EN_PORParserType> _defaultParserType;
+
   private:
     // Attributes
     /**
@@ -705,6 +758,11 @@ namespace OPENTREP {
      */
     std::string _string;
 
+    /**
+     * Type of the parser.
+     */
+    PORParserType::EN_PORParserType _parserType;
+
     /**
      * POR Structure.
      */
@@ -0,0 +1,241 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+#include <queue>
+// OpenTrep
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/GeoDistance.hpp>
+#include <opentrep/bom/PORSpatialIndex.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * Squared chord distance, on the unit sphere, corresponding to the given
+   * great circle distance (in kilometers).
+   */
+  // //////////////////////////////////////////////////////////////////////
+  static double getSquaredChordFromDistance (const Distance_T& iDistance) {
+    const double lAngle = iDistance / K_DEFAULT_EARTH_RADIUS;
+    if (lAngle >= M_PI) {
+      return 4.0;
+    }
+    const double lChord = 2.0 * std::sin (0.5 * lAngle);
+    return lChord * lChord;
+  }
+
+  /**
+   * Great circle distance (in kilometers) corresponding to the given
+   * squared chord distance on the unit sphere.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  static Distance_T getDistanceFromSquaredChord (const double iSquaredChord) {
+    double lHalfChord = 0.5 * std::sqrt (iSquaredChord);
+    if (lHalfChord > 1.0) {
+      lHalfChord = 1.0;
+    }
+    const Distance_T oDistance =
+      2.0 * K_DEFAULT_EARTH_RADIUS * std::asin (lHalfChord);
+    return oDistance;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORSpatialIndex::PORSpatialIndex()
+    : _travelDBFilePath (""), _isBuilt (false) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PORSpatialIndex::~PORSpatialIndex() {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PORSpatialIndex::reset() {
+    _travelDBFilePath = TravelDBFilePath_T ("");
+    _isBuilt = false;
+    _pointList.clear();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PORSpatialIndex::addPoint (const Latitude_T& iLatitude,
+                                  const Longitude_T& iLongitude,
+                                  const FeatureCode_T& iFeatureCode,
+                                  const XapianDocID_T& iDocID) {
+    Point lPoint;
+    projectOntoUnitSphere (iLatitude, iLongitude, lPoint._coord);
+    lPoint._featCode = iFeatureCode;
+    lPoint._docID = iDocID;
+    _pointList.push_back (lPoint);
+
+    // The k-d tree has to be re-built
+    _isBuilt = false;
+  }
+
+  /**
+   * Comparison of two points along a given axis.
+   */
+  struct AxisComparator {
+    AxisComparator (const unsigned short iAxis) : _axis (iAxis) {}
+    template <typename POINT>
+    bool operator() (const POINT& iLHS, const POINT& iRHS) const {
+      return iLHS._coord[_axis] < iRHS._coord[_axis];
+    }
+    unsigned short _axis;
+  };
+
+  // //////////////////////////////////////////////////////////////////////
+  void PORSpatialIndex::buildSubTree (const size_t iBegin, const size_t iEnd,
+                                      const unsigned short iDepth) {
+    if (iEnd - iBegin <= 1) {
+      return;
+    }
+
+    // The median element becomes the node of the sub-range, splitting
+    // that latter along the axis corresponding to the depth
+    const size_t lMid = iBegin + (iEnd - iBegin) / 2;
+    const AxisComparator lComparator (iDepth % 3);
+    std::nth_element (_pointList.begin() + iBegin, _pointList.begin() + lMid,
+                      _pointList.begin() + iEnd, lComparator);
+
+    buildSubTree (iBegin, lMid, iDepth + 1);
+    buildSubTree (lMid + 1, iEnd, iDepth + 1);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PORSpatialIndex::build (const TravelDBFilePath_T& iTravelDBFilePath) {
+    buildSubTree (0, _pointList.size(), 0);
+    _travelDBFilePath = iTravelDBFilePath;
+    _isBuilt = true;
+  }
+
+  /**
+   * Sub-range of the implicit k-d tree still to be explored, along with
+   * the (squared) lower bound of the distance between the searched point
+   * and the points of that sub-range.
+   */
+  struct SubTreeToExplore {
+    size_t _begin;
+    size_t _end;
+    unsigned short _depth;
+    double _minSquaredDistance;
+  };
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T PORSpatialIndex::
+  findNearest (const Latitude_T& iLatitude, const Longitude_T& iLongitude,
+               const Distance_T& iRadius, const NbOfMatches_T& iK,
+               const std::string& iFeatureFilter,
+               SpatialHitList_T& ioHitList) const {
+    assert (_isBuilt == true);
+
+    double lQuery[3];
+    projectOntoUnitSphere (iLatitude, iLongitude, lQuery);
+
+    // Squared chord distance corresponding to the search radius. The
+    // chord between two points of the unit sphere can not exceed 2.
+    const double lSquaredRadius =
+      (iRadius > 0.0) ? getSquaredChordFromDistance (iRadius) : 4.0;
+
+    // Max-heap of the best candidates found so far, sorted by their
+    // squared chord distance
+    typedef std::pair<double, XapianDocID_T> Candidate_T;
+    std::priority_queue<Candidate_T> lCandidateHeap;
+
+    // Depth-first exploration of the k-d tree, the nearest sub-tree first
+    std::vector<SubTreeToExplore> lStack;
+    const SubTreeToExplore lRoot = { 0, _pointList.size(), 0, 0.0 };
+    lStack.push_back (lRoot);
+
+    while (lStack.empty() == false) {
+      const SubTreeToExplore lSubTree = lStack.back();
+      lStack.pop_back();
+
+      // Current bound: the radius, or the k-th best candidate when
+      // enough candidates have already been found
+      double lBound = lSquaredRadius;
+      if (iK != 0 && lCandidateHeap.size() == iK
+          && lCandidateHeap.top().first < lBound) {
+        lBound = lCandidateHeap.top().first;
+      }
+      if (lSubTree._begin >= lSubTree._end
+          || lSubTree._minSquaredDistance > lBound) {
+        continue;
+      }
+
+      const size_t lMid =
+        lSubTree._begin + (lSubTree._end - lSubTree._begin) / 2;
+      const Point& lPoint = _pointList[lMid];
+
+      // Check the node itself
+      const double dx = lPoint._coord[0] - lQuery[0];
+      const double dy = lPoint._coord[1] - lQuery[1];
+      const double dz = lPoint._coord[2] - lQuery[2];
+      const double lSquaredDistance = dx*dx + dy*dy + dz*dz;
+      if (lSquaredDistance <= lBound
+          && (iFeatureFilter.empty() == true
+              || lPoint._featCode == iFeatureFilter)) {
+        lCandidateHeap.push (Candidate_T (lSquaredDistance, lPoint._docID));
+        if (iK != 0 && lCandidateHeap.size() > iK) {
+          lCandidateHeap.pop();
+        }
+      }
+
+      // Explore the far sub-tree only when the splitting plane is closer
+      // than the current bound. As the stack is LIFO, the far sub-tree
+      // is pushed first.
+      const unsigned short lAxis = lSubTree._depth % 3;
+      const double lDiff = lQuery[lAxis] - lPoint._coord[lAxis];
+      const double lPlaneSquaredDistance =
+        std::max (lDiff * lDiff, lSubTree._minSquaredDistance);
+      const unsigned short lChildDepth = lSubTree._depth + 1;
+      const SubTreeToExplore lLowerSubTree =
+        { lSubTree._begin, lMid, lChildDepth, lSubTree._minSquaredDistance };
+      const SubTreeToExplore lUpperSubTree =
+        { lMid + 1, lSubTree._end, lChildDepth, lSubTree._minSquaredDistance };
+      if (lDiff < 0.0) {
+        SubTreeToExplore lFarSubTree = lUpperSubTree;
+        lFarSubTree._minSquaredDistance = lPlaneSquaredDistance;
+        lStack.push_back (lFarSubTree);
+        lStack.push_back (lLowerSubTree);
+
+      } else {
+        SubTreeToExplore lFarSubTree = lLowerSubTree;
+        lFarSubTree._minSquaredDistance = lPlaneSquaredDistance;
+        lStack.push_back (lFarSubTree);
+        lStack.push_back (lUpperSubTree);
+      }
+    }
+
+    // Unwind the heap, from the farthest to the nearest candidate
+    const size_t lNbOfHits = lCandidateHeap.size();
+    const size_t lOffset = ioHitList.size();
+    ioHitList.resize (lOffset + lNbOfHits);
+    for (size_t idx = lNbOfHits; idx != 0; --idx) {
+      const Candidate_T& lCandidate = lCandidateHeap.top();
+      const Distance_T lDistance =
+        getDistanceFromSquaredChord (lCandidate.first);
+      ioHitList[lOffset + idx - 1] = SpatialHit_T (lDistance,
+                                                   lCandidate.second);
+      lCandidateHeap.pop();
+    }
+
+    const NbOfMatches_T oNbOfMatches = static_cast<NbOfMatches_T> (lNbOfHits);
+    return oNbOfMatches;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string PORSpatialIndex::describe() const {
+    std::ostringstream oStr;
+    oStr << "Spatial index of " << _pointList.size() << " POR";
+    if (_isBuilt == true) {
+      oStr << ", built from '" << _travelDBFilePath << "'";
+    } else {
+      oStr << ", not built";
+    }
+    return oStr.str();
+  }
+
+}
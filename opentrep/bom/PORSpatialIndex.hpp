@@ -0,0 +1,183 @@
+#ifndef __OPENTREP_BOM_PORSPATIALINDEX_HPP
+#define __OPENTREP_BOM_PORSPATIALINDEX_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+#include <vector>
+#include <utility>
+// Boost
+#include <boost/shared_ptr.hpp>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * Pair made of a distance (in kilometers) and of the Xapian document ID
+   * of the corresponding POR (point of reference).
+   */
+  typedef std::pair<Distance_T, XapianDocID_T> SpatialHit_T;
+
+  /**
+   * List of spatial hits, sorted by increasing distance.
+   */
+  typedef std::vector<SpatialHit_T> SpatialHitList_T;
+
+
+  /**
+   * @brief In-memory spatial index of the POR (points of reference).
+   *
+   * The POR are stored within a static 3-dimensional k-d tree, the
+   * geographical coordinates being projected onto the unit sphere.
+   * The Euclidean (chord) distance between two such projections is
+   * a monotonic function of the great circle distance, so that the
+   * nearest neighbour searches are exact, including around the poles
+   * and the anti-meridian.
+   *
+   * The k-d tree is implicit: the POR are re-ordered within a single
+   * vector, the node of any sub-range being its median element.
+   *
+   * Once built, the spatial index is not altered anymore, and may be
+   * searched by several threads at once (see PORSpatialIndexPtr_T).
+   */
+  class PORSpatialIndex {
+  public:
+    // ////////////// Getters /////////////
+    /**
+     * Get the file-path of the Xapian database/index the spatial index
+     * has been built from (empty when the spatial index is not built).
+     */
+    const TravelDBFilePath_T& getTravelDBFilePath() const {
+      return _travelDBFilePath;
+    }
+
+    /**
+     * State whether the spatial index has been built.
+     */
+    bool isBuilt() const {
+      return _isBuilt;
+    }
+
+    /**
+     * Get the number of POR stored within the spatial index.
+     */
+    NbOfDBEntries_T size() const {
+      return _pointList.size();
+    }
+
+  public:
+    // ////////////// Business methods /////////////
+    /**
+     * Empty the spatial index.
+     */
+    void reset();
+
+    /**
+     * Add a POR (point of reference) to the spatial index. The index
+     * has to be (re-)built, with the build() method, before being
+     * searched.
+     *
+     * @param const Latitude_T& Latitude of the POR, in degrees.
+     * @param const Longitude_T& Longitude of the POR, in degrees.
+     * @param const FeatureCode_T& Geonames feature code (e.g., AIRP, RSTN).
+     * @param const XapianDocID_T& Xapian document ID of the POR.
+     */
+    void addPoint (const Latitude_T&, const Longitude_T&,
+                   const FeatureCode_T&, const XapianDocID_T&);
+
+    /**
+     * Arrange the POR into the k-d tree.
+     *
+     * @param const TravelDBFilePath_T& File-path of the Xapian database/index
+     *        the POR have been extracted from.
+     */
+    void build (const TravelDBFilePath_T&);
+
+    /**
+     * Find the POR nearest to the given geographical point.
+     *
+     * @param const Latitude_T& Latitude of the point, in degrees.
+     * @param const Longitude_T& Longitude of the point, in degrees.
+     * @param const Distance_T& Search radius, in kilometers. A null or
+     *        negative radius means that the distance is not bounded.
+     * @param const NbOfMatches_T& Maximum number of POR to be returned.
+     *        Zero means that all the POR within the radius are returned.
+     * @param const std::string& Geonames feature code the POR should have
+     *        (e.g., AIRP for airports, RSTN for railway stations). An empty
+     *        string means that no filter is applied.
+     * @param SpatialHitList_T& List of hits, sorted by increasing distance.
+     * @return NbOfMatches_T Number of hits.
+     */
+    NbOfMatches_T findNearest (const Latitude_T&, const Longitude_T&,
+                               const Distance_T& iRadius,
+                               const NbOfMatches_T& iK,
+                               const std::string& iFeatureFilter,
+                               SpatialHitList_T&) const;
+
+  public:
+    // ////////////// Display methods /////////////
+    /**
+     * Display a short description of the spatial index.
+     */
+    std::string describe() const;
+
+  public:
+    // ////////////// Constructors and destructors /////////////
+    /**
+     * Default constructor.
+     */
+    PORSpatialIndex();
+
+    /**
+     * Destructor.
+     */
+    ~PORSpatialIndex();
+
+  private:
+    /**
+     * Projection of a POR onto the unit sphere, along with the details
+     * needed to filter and to retrieve it.
+     */
+    struct Point {
+      double _coord[3];
+      std::string _featCode;
+      XapianDocID_T _docID;
+    };
+    typedef std::vector<Point> PointList_T;
+
+    /**
+     * Recursively arrange the [iBegin, iEnd[ sub-range into a k-d tree.
+     */
+    void buildSubTree (const size_t iBegin, const size_t iEnd,
+                       const unsigned short iDepth);
+
+  private:
+    // ////////////// Attributes /////////////
+    /**
+     * File-path of the Xapian database/index the POR have been extracted from.
+     */
+    TravelDBFilePath_T _travelDBFilePath;
+
+    /**
+     * Whether the k-d tree has been built.
+     */
+    bool _isBuilt;
+
+    /**
+     * POR, arranged as an implicit k-d tree once built.
+     */
+    PointList_T _pointList;
+  };
+
+  /**
+   * Shared pointer on a spatial index, already built. A new spatial index
+   * is built, and published, rather than re-building the one in use,
+   * so that the searches in progress may go on with the former one.
+   */
+  typedef boost::shared_ptr<const PORSpatialIndex> PORSpatialIndexPtr_T;
+
+}
+#endif // __OPENTREP_BOM_PORSPATIALINDEX_HPP
@@ -122,6 +122,12 @@ namespace OPENTREP {
     return oStr.str();
   }   
 
+  // //////////////////////////////////////////////////////////////////////
+  std::string Place::describeUniqueID() const {
+    const LocationKey& lLocationKey = getKey();
+    return buildPORUniqueID (lLocationKey.toString(), getEnvelopeID());
+  }
+
   // //////////////////////////////////////////////////////////////////////
   std::string Place::toShortString() const {
     /**
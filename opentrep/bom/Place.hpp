@@ -1054,6 +1054,13 @@ namespace OPENTREP {
       return _location.describeKey();
     }
 
+    /**
+     * Get the unique ID of the POR record, i.e., its key along with its
+     * envelope ID (e.g., NCE-CA-6299418-0), as the historical records
+     * of a POR share the same key.
+     */
+    std::string describeUniqueID() const;
+
     /**
      * Get a string describing the whole key (IATA and ICAO codes, Geonames ID).
      */
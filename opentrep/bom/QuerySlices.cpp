@@ -290,6 +290,11 @@ namespace OPENTREP {
                           << "the spelling correction.");
       assert (false);
       
+    } catch (const Xapian::DatabaseModifiedError&) {
+      // The Xapian database is reopened by the caller (see
+      // RequestInterpreter::interpretTravelRequest())
+      throw;
+
     } catch (const Xapian::Error& error) {
       // Error
       OPENTREP_LOG_ERROR ("Exception: "  << error.get_msg());
@@ -5,11 +5,14 @@
 #include <cassert>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 // Boost
 #include <boost/tokenizer.hpp>
 // OpenTREP
 #include <opentrep/LocationKey.hpp>
+#include <opentrep/OriginHint.hpp>
 #include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/Utilities.hpp>
 #include <opentrep/bom/Filter.hpp>
 #include <opentrep/bom/WordHolder.hpp>
 #include <opentrep/bom/StringPartition.hpp>
@@ -17,6 +20,7 @@
 #include <opentrep/bom/Place.hpp>
 #include <opentrep/bom/Result.hpp>
 #include <opentrep/bom/PORParserHelper.hpp>
+#include <opentrep/bom/LocationView.hpp>
 #include <opentrep/service/Logger.hpp>
 
 namespace OPENTREP {
@@ -282,22 +286,24 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   LocationKey Result::getPrimaryKey (const Xapian::Document& iDocument) {
-    // Parse the POR (point of reference) details held by the Xapian document
-    const Location& lLocation = retrieveLocation (iDocument);
+    // Locate the POR (point of reference) details held by the Xapian document
+    const std::string& lDocumentDataStr = iDocument.get_data();
+    const LocationView lLocationView (lDocumentDataStr);
 
-    // Get the key (IATA and ICAO codes, GeonamesID)
-    const LocationKey& oLocationKey = lLocation.getKey();
+    // Get the key (IATA code and location type, GeonamesID)
+    const LocationKey& oLocationKey = lLocationView.getKey();
 
     return oLocationKey;
   }
   
   // //////////////////////////////////////////////////////////////////////
   Score_T Result::getEnvelopeID (const Xapian::Document& iDocument) {
-    // Parse the POR (point of reference) details held by the Xapian document
-    const Location& lLocation = retrieveLocation (iDocument);
+    // Locate the POR (point of reference) details held by the Xapian document
+    const std::string& lDocumentDataStr = iDocument.get_data();
+    const LocationView lLocationView (lDocumentDataStr);
 
     // Get the envelope ID (it is an integer value in the Location structure)
-    const EnvelopeID_T& lEnvelopeIDInt = lLocation.getEnvelopeID();
+    const EnvelopeID_T& lEnvelopeIDInt = lLocationView.getEnvelopeID();
 
     // Convert the envelope ID value, from an integer to a floating point one
     const Score_T oEnvelopeID = static_cast<const Score_T> (lEnvelopeIDInt);
@@ -307,11 +313,12 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   PageRank_T Result::getPageRank (const Xapian::Document& iDocument) {
-    // Parse the POR (point of reference) details held by the Xapian document
-    const Location& lLocation = retrieveLocation (iDocument);
+    // Locate the POR (point of reference) details held by the Xapian document
+    const std::string& lDocumentDataStr = iDocument.get_data();
+    const LocationView lLocationView (lDocumentDataStr);
 
     // Get the PageRank value
-    const PageRank_T& oPageRank = lLocation.getPageRank();
+    const PageRank_T& oPageRank = lLocationView.getPageRank();
 
     return oPageRank;
   }
@@ -506,6 +513,11 @@ namespace OPENTREP {
                           << "the spelling correction.");
       assert (false);
       
+    } catch (const Xapian::DatabaseModifiedError&) {
+      // The Xapian database is reopened by the caller (see
+      // RequestInterpreter::interpretTravelRequest())
+      throw;
+
     } catch (const Xapian::Error& error) {
       OPENTREP_LOG_ERROR ("Exception: "  << error.get_msg());
       throw XapianException (error.get_msg());
@@ -550,6 +562,11 @@ namespace OPENTREP {
       OPENTREP_LOG_DEBUG ("      ==> " << toString());
       OPENTREP_LOG_DEBUG ("      ----------------");
 
+    } catch (const Xapian::DatabaseModifiedError&) {
+      // The Xapian database is reopened by the caller (see
+      // RequestInterpreter::interpretTravelRequest())
+      throw;
+
     } catch (const Xapian::Error& error) {
       OPENTREP_LOG_ERROR ("Xapian-related error: "  << error.get_msg());
       throw XapianException (error.get_msg());
@@ -623,11 +640,16 @@ namespace OPENTREP {
       // Extract the Xapian document ID
       const Xapian::docid& lDocID = lXapianDoc.get_docid();
 
-      // Extract the envelope ID from the document data
-      const LocationKey& lLocationKey = getPrimaryKey (lXapianDoc);
+      // Locate the POR details held by the document data, once for both
+      // the key and the envelope ID
+      const std::string& lDocDataStr = lXapianDoc.get_data();
+      const LocationView lLocationView (lDocDataStr);
+
+      // Extract the primary key from the document data
+      const LocationKey& lLocationKey = lLocationView.getKey();
 
       // Extract the envelope ID from the document data
-      const EnvelopeID_T& lEnvelopeIDInt = getEnvelopeID (lXapianDoc);
+      const EnvelopeID_T& lEnvelopeIDInt = lLocationView.getEnvelopeID();
 
       // DEBUG
       if (lEnvelopeIDInt != 0) {
@@ -755,11 +777,16 @@ namespace OPENTREP {
       // Extract the Xapian document ID
       const Xapian::docid& lDocID = lXapianDoc.get_docid();
 
-      // Extract the envelope ID from the document data
-      const LocationKey& lLocationKey = getPrimaryKey (lXapianDoc);
+      // Locate the POR details held by the document data, once for both
+      // the key and the PageRank
+      const std::string& lDocDataStr = lXapianDoc.get_data();
+      const LocationView lLocationView (lDocDataStr);
+
+      // Extract the primary key from the document data
+      const LocationKey& lLocationKey = lLocationView.getKey();
 
       // Extract the PageRank from the document data
-      const Score_T& lPageRank = getPageRank (lXapianDoc);
+      const Score_T& lPageRank = lLocationView.getPageRank();
 
       // DEBUG
       OPENTREP_LOG_NOTIFICATION ("        [pr][" << describeShortKey()
@@ -777,12 +804,85 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  void Result::calculateHeuristicWeights() {
+  void Result::calculateHeuristicWeights (const OriginHint& iOriginHint) {
     /**
-     * Nothing for now. The heuristic weight, by construction,
-     * should come from the caller of the API, not from the document.
-     * So, parameters would be needed along the call to that method.
+     * The heuristic weight, by construction, comes from the caller of
+     * the API: when no origin is given, no heuristic weight is set, so that
+     * it does not take part in the combined weight.
      */
+    if (iOriginHint.isEmpty() == true) {
+      return;
+    }
+
+    // Browse the list of Xapian documents
+    for (DocumentList_T::iterator itDoc = _documentList.begin();
+         itDoc != _documentList.end(); ++itDoc) {
+      XapianDocumentPair_T& lDocumentPair = *itDoc;
+
+      // Retrieve the Xapian document
+      const Xapian::Document& lXapianDoc = lDocumentPair.first;
+
+      // Extract the Xapian document ID
+      const Xapian::docid& lDocID = lXapianDoc.get_docid();
+
+      /**
+       * Extract the geographical coordinates and the country code from
+       * the Xapian values, rather than by parsing the document data.
+       * The Xapian databases built by former versions of OpenTREP have
+       * no such values; the heuristic weight is then just not set.
+       */
+      const std::string& lLatitudeStr =
+        lXapianDoc.get_value (K_XAPIAN_VALUE_SLOT_LATITUDE);
+      const std::string& lLongitudeStr =
+        lXapianDoc.get_value (K_XAPIAN_VALUE_SLOT_LONGITUDE);
+      const std::string& lCountryCode =
+        lXapianDoc.get_value (K_XAPIAN_VALUE_SLOT_COUNTRY_CODE);
+      if (lLatitudeStr.empty() == true || lLongitudeStr.empty() == true) {
+        continue;
+      }
+
+      Percentage_T lHeuristicPct = 100.0;
+
+      /**
+       * The weight decays exponentially with the distance to the origin,
+       * from 100% down to K_DEFAULT_HEURISTIC_MIN_PCT (normally, 10%).
+       * The POR far away from the origin are therefore weighed down,
+       * but never disqualified.
+       */
+      if (iOriginHint.hasCoordinates() == true) {
+        const Latitude_T lLatitude =
+          Xapian::sortable_unserialise (lLatitudeStr);
+        const Longitude_T lLongitude =
+          Xapian::sortable_unserialise (lLongitudeStr);
+        const Distance_T lDistance =
+          calculateGreatCircleDistance (iOriginHint.getLatitude(),
+                                        iOriginHint.getLongitude(),
+                                        lLatitude, lLongitude);
+        lHeuristicPct = K_DEFAULT_HEURISTIC_MIN_PCT
+          + (100.0 - K_DEFAULT_HEURISTIC_MIN_PCT)
+          * std::exp (-lDistance / K_DEFAULT_HEURISTIC_DISTANCE_DECAY);
+      }
+
+      // The POR outside of the country of the origin are weighed down
+      if (iOriginHint.hasCountryCode() == true
+          && lCountryCode != iOriginHint.getCountryCode()) {
+        lHeuristicPct *= K_DEFAULT_HEURISTIC_OTHER_COUNTRY_PCT / 100.0;
+      }
+
+      // DEBUG
+      OPENTREP_LOG_NOTIFICATION ("        [heur][" << describeShortKey()
+                                 << "] (" << getPrimaryKey (lXapianDoc)
+                                 << ", doc ID = " << lDocID << ") is weighed "
+                                 << lHeuristicPct << "% with respect to the "
+                                 << "origin: " << iOriginHint);
+
+      // Retrieve the score board for that Xapian document
+      ScoreBoard& lScoreBoard = lDocumentPair.second;
+
+      // Store the heuristic weight
+      lScoreBoard.setScore (ScoreType::HEURISTIC, lHeuristicPct);
+      setScoreOnDocMap (lDocID, ScoreType::HEURISTIC, lHeuristicPct);
+    }
   }
 
   // //////////////////////////////////////////////////////////////////////
@@ -20,6 +20,7 @@ namespace OPENTREP {
   class ResultHolder;
   struct LocationKey;
   struct Location;
+  struct OriginHint;
   class Place;
 
 
@@ -278,9 +279,9 @@ namespace OPENTREP {
     /**
      * Extract the primary key from the data of the given Xapian document.
      *
-     * The primary key is made of the IATA and ICAO codes, as well as of
-     * the Geonames ID. The retrieveLocation() is used to parse the Xapian
-     * document raw data.
+     * The primary key is made of the IATA code and location type, as well
+     * as of the Geonames ID. Only those fields are decoded from the Xapian
+     * document raw data (see LocationView).
      *
      * @param Xapian::Document& The Xapian document.
      * @return LocationKey& The primary key of the place/POR (point of
@@ -291,7 +292,8 @@ namespace OPENTREP {
     /**
      * Extract the Envelope ID from the data of the given Xapian document.
      *
-     * The retrieveLocation() is used to parse the Xapian document raw data.
+     * Only that field is decoded from the Xapian document raw data
+     * (see LocationView).
      *
      * @param Xapian::Document& The Xapian document.
      * @return Score_T& The Envelope ID of the place/POR (point of reference),
@@ -302,7 +304,8 @@ namespace OPENTREP {
     /**
      * Extract the PageRank from the data of the given Xapian document.
      *
-     * The retrieveLocation() is used to parse the Xapian document raw data.
+     * Only that field is decoded from the Xapian document raw data
+     * (see LocationView).
      *
      * @param Xapian::Document& The Xapian document.
      * @return PageRank_T& The PageRank of the place/POR (point of reference).
@@ -351,8 +354,11 @@ namespace OPENTREP {
 
     /**
      * Calculate/set the heuristic weights for all the matching documents
+     *
+     * @param const OriginHint& Origin of the travel request, as given by
+     *        the caller (when empty, no heuristic weight is set).
      */
-    void calculateHeuristicWeights();
+    void calculateHeuristicWeights (const OriginHint&);
 
     /**
      * Calculate/set the combined weights for all the matching documents.
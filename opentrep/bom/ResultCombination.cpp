@@ -164,7 +164,8 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  void ResultCombination::calculateHeuristicWeights() const {
+  void ResultCombination::
+  calculateHeuristicWeights (const OriginHint& iOriginHint) const {
     // Browse the ResultHolder objects
     for (ResultHolderList_T::const_iterator itResultHolder =
            _resultHolderList.begin();
@@ -173,7 +174,7 @@ namespace OPENTREP {
       assert (lResultHolder_ptr != NULL);
 
       //
-      lResultHolder_ptr->calculateHeuristicWeights();
+      lResultHolder_ptr->calculateHeuristicWeights (iOriginHint);
     }
   }
 
@@ -192,7 +193,7 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  void ResultCombination::calculateAllWeights() {
+  void ResultCombination::calculateAllWeights (const OriginHint& iOriginHint) {
     /**
      * 1. Display a summary of the Xapian matching results.
      */
@@ -217,7 +218,7 @@ namespace OPENTREP {
     /**
      * 5. Calculate/set the heuristic weights for all the matching documents
      */
-    calculateHeuristicWeights();
+    calculateHeuristicWeights (iOriginHint);
 
     /**
      * 6. Calculate/set the combined weights for all the matching documents
@@ -18,6 +18,7 @@ namespace OPENTREP {
 
   // Forward declarations
   struct StringSet;
+  struct OriginHint;
 
   /**
    * @brief Class wrapping functions on a list of ResultHolder objects.
@@ -95,8 +96,11 @@ namespace OPENTREP {
 
     /**
      * Calculate/set the heuristic weights for all the matching documents
+     *
+     * @param const OriginHint& Origin of the travel request, as given by
+     *        the caller (when empty, no heuristic weight is set).
      */
-    void calculateHeuristicWeights() const;
+    void calculateHeuristicWeights (const OriginHint&) const;
 
     /**
      * Calculate/set the combined weights for all the matching documents
@@ -105,8 +109,11 @@ namespace OPENTREP {
 
     /**
      * Combine all of the above methods
+     *
+     * @param const OriginHint& Origin of the travel request, as given by
+     *        the caller (it may be empty).
      */
-    void calculateAllWeights();
+    void calculateAllWeights (const OriginHint&);
 
     /**
      * Choose the best matching ResultHolder object from the underlying list.
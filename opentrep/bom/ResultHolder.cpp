@@ -145,7 +145,8 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  void ResultHolder::calculateHeuristicWeights() const {
+  void ResultHolder::
+  calculateHeuristicWeights (const OriginHint& iOriginHint) const {
     // Browse the Result objects
     for (ResultList_T::const_iterator itResult = _resultList.begin();
          itResult != _resultList.end(); ++itResult) {
@@ -153,7 +154,7 @@ namespace OPENTREP {
       assert (lResult_ptr != NULL);
 
       //
-      lResult_ptr->calculateHeuristicWeights();
+      lResult_ptr->calculateHeuristicWeights (iOriginHint);
     }
   }
 
@@ -19,6 +19,7 @@ namespace OPENTREP {
   // Forward declarations
   class ResultCombination;
   struct StringSet;
+  struct OriginHint;
 
   /**
    * @brief Class wrapping functions on a list of Result objects.
@@ -90,8 +91,11 @@ namespace OPENTREP {
 
     /**
      * Calculate/set the heuristic weights for all the matching documents
+     *
+     * @param const OriginHint& Origin of the travel request, as given by
+     *        the caller (when empty, no heuristic weight is set).
      */
-    void calculateHeuristicWeights() const;
+    void calculateHeuristicWeights (const OriginHint&) const;
 
     /**
      * Calculate/set the combined weights for all the matching documents
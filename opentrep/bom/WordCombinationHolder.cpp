@@ -4,11 +4,12 @@
 // STL
 #include <cassert>
 #include <sstream>
-#include <set>
+#include <vector>
+#include <algorithm>
 // OpenTrep
+#include <opentrep/basic/BasConst_General.hpp>
 #include <opentrep/basic/Utilities.hpp>
-#include <opentrep/bom/Filter.hpp>
-#include <opentrep/bom/StringPartition.hpp>
+#include <opentrep/bom/StringSet.hpp>
 #include <opentrep/bom/WordCombinationHolder.hpp>
 #include <opentrep/service/Logger.hpp>
 
@@ -85,55 +86,66 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   void WordCombinationHolder::init (const std::string& iPhrase) {
-    // Set of unique strings
-    typedef std::set<std::string> StringSet_T;
-    StringSet_T lStringSet;
-
-    // 1. Derive all the partitions of the initial (full) string
-    const StringPartition lStringPartitionHolder (iPhrase);
-    const StringPartition::StringPartition_T& lStringPartition =
-      lStringPartitionHolder._partition;
-
-    // 2.1. For every word combination, add it if not already in the
-    //      list (STL set) of strings.
-    for (StringPartition::StringPartition_T::const_iterator itSet =
-           lStringPartition.begin(); itSet != lStringPartition.end(); ++itSet) {
-      const StringSet& itStringList = *itSet;
-      
-      const StringList_T& lStringList = itStringList._set;
-      for (StringList_T::const_iterator itWordCombination = lStringList.begin();
-           itWordCombination != lStringList.end(); ++itWordCombination) {
-        const std::string& lWordCombination = *itWordCombination;
-
-        // Check whether the (remaining) word combination should be filtered out
-        //const bool isToBeAdded= Filter::shouldKeep (iPhrase, lWordCombination);
-        const bool isToBeAdded = true;
-        if (isToBeAdded == true) {
-          lStringSet.insert (lWordCombination);
-        }
+    // 0. Initialisation
+    // 0.1. Tokenise the given string
+    WordList_T lWordList;
+    tokeniseStringIntoWordList (iPhrase, lWordList);
+    const NbOfWords_T nbOfWords = lWordList.size();
+
+    // 0.2. Re-create the phrase, the words being separated by a single
+    //      space, while keeping track of the position of every word within
+    //      it: every word combination is then a mere sub-string of it
+    std::string lPhrase;
+    lPhrase.reserve (iPhrase.size());
+    std::vector<size_t> lWordBeginList;
+    std::vector<size_t> lWordEndList;
+    lWordBeginList.reserve (nbOfWords);
+    lWordEndList.reserve (nbOfWords);
+    for (WordList_T::const_iterator itWord = lWordList.begin();
+         itWord != lWordList.end(); ++itWord) {
+      if (lPhrase.empty() == false) {
+        lPhrase.push_back (' ');
       }
-    }    
-
-    // 2.2. Convert the STL set into a STL list
-    for (StringSet_T::const_iterator itWordCombination = lStringSet.begin();
-         itWordCombination != lStringSet.end(); ++itWordCombination) {
-      const std::string& lWordCombination = *itWordCombination;
+      lWordBeginList.push_back (lPhrase.size());
+      lPhrase.append (*itWord);
+      lWordEndList.push_back (lPhrase.size());
+    }
 
-      // Add that word combination in the list for indexation by Xapian.
-      // Note that if that word combination is already present in the list,
-      // it will not be added a second time (thanks to the STL list design).
-      _list.push_back (lWordCombination);
+    // 1. Derive all the contiguous word combinations (i.e., all the
+    //    sub-strings made of the words from the i-th to the j-th one).
+    //    That is the set of the word combinations of all the partitions
+    //    of the string (see StringPartition), which would be, however,
+    //    exponential with the number of words. As with the partitions,
+    //    only the first K_DEFAULT_MAXIMUM_NUMBER_OF_WORDS_IN_STRING words
+    //    are considered.
+    const NbOfWords_T nbOfCappedWords =
+      std::min (nbOfWords, K_DEFAULT_MAXIMUM_NUMBER_OF_WORDS_IN_STRING);
+    std::vector<std::string> lSpanList;
+    lSpanList.reserve (nbOfCappedWords * (nbOfCappedWords + 1) / 2);
+    for (NbOfWords_T idx_begin = 0; idx_begin != nbOfCappedWords;
+         ++idx_begin) {
+      const size_t lBeginPos = lWordBeginList[idx_begin];
+      for (NbOfWords_T idx_end = idx_begin; idx_end != nbOfCappedWords;
+           ++idx_end) {
+        lSpanList.push_back (lPhrase.substr (lBeginPos,
+                                             lWordEndList[idx_end]
+                                             - lBeginPos));
+      }
     }
 
+    // 2. Add the unique word combinations into the list for indexation
+    //    by Xapian, in alphabetical order
+    std::sort (lSpanList.begin(), lSpanList.end());
+    const std::vector<std::string>::const_iterator itSpanListEnd =
+      std::unique (lSpanList.begin(), lSpanList.end());
+    _list.insert (_list.end(),
+                  std::vector<std::string>::const_iterator (lSpanList.begin()),
+                  itSpanListEnd);
+
     // 3. Add the word combinations, made by removing all the possible groups
     //    of continuous words inbetween the two extreme words (from left- and
-    //    right-hand sides).
-    // 3.0. Initialisation of the list of words, made of all the words of the
-    //      given string.
-    WordList_T lWordList;
-    tokeniseStringIntoWordList (iPhrase, lWordList);
-    const short nbOfWords = lWordList.size();
-
+    //    right-hand sides). Contrary to the above, all the words of the
+    //    string are considered.
     // 3.1. If the string contains no more than two words, the job is finished.
     if (nbOfWords <= 2) {
       return;
@@ -141,34 +153,28 @@ namespace OPENTREP {
 
     // 3.2. Iteration on the number of words to remove in the middle of the
     //      string, from 1 to (nbOfWords - 2)
-    for (short mdl_string_len = 1; mdl_string_len != nbOfWords-1;
+    for (NbOfWords_T mdl_string_len = 1; mdl_string_len != nbOfWords-1;
          ++mdl_string_len) {
 
-      // 3.2. Iteration on all the middle words of the given string,
+      // 3.3. Iteration on all the middle words of the given string,
       //      from 1 to (nbOfWords - mdl_string_len)
-      for (short idx_word=1; idx_word != nbOfWords-mdl_string_len; ++idx_word) {
-        // 3.2.1. Copy the first idx_word word(s)
-        const std::string& lLeftHandString =
-          createStringFromWordList (lWordList, idx_word);
-
-        // 3.2.2. Copy the last (nbOfWords - (idx_word + mdl_string_len)) words
-        const std::string& lRightHandString =
-          createStringFromWordList (lWordList,
-                                    idx_word + mdl_string_len,
-                                    false);
-
-        // 3.2.3. Concatenate both sub-strings
-        std::ostringstream lConcatenatedStr;
-        lConcatenatedStr << lLeftHandString << " " << lRightHandString;
-        const std::string& lConcatenatedString = lConcatenatedStr.str();
-
-        // 3.2.4. Add the concatenated string into the list, if not filtered out
-        // const bool isToBeAdded =
-        //   Filter::shouldKeep (iPhrase, lConcatenatedString);
-        const bool isToBeAdded = true;
-        if (isToBeAdded == true) {
-          _list.push_back (lConcatenatedString);
-        }
+      for (NbOfWords_T idx_word = 1; idx_word != nbOfWords - mdl_string_len;
+           ++idx_word) {
+        // 3.3.1. The first idx_word word(s), and the last
+        //        (nbOfWords - (idx_word + mdl_string_len)) words
+        const size_t lLeftHandSize = lWordEndList[idx_word - 1];
+        const size_t lRightHandPos = lWordBeginList[idx_word + mdl_string_len];
+
+        // 3.3.2. Concatenate both sub-strings, and add the result
+        //        into the list
+        std::string lConcatenatedString;
+        lConcatenatedString.reserve (lLeftHandSize + 1
+                                     + lPhrase.size() - lRightHandPos);
+        lConcatenatedString.append (lPhrase, 0, lLeftHandSize);
+        lConcatenatedString.push_back (' ');
+        lConcatenatedString.append (lPhrase, lRightHandPos,
+                                    std::string::npos);
+        _list.push_back (lConcatenatedString);
       }
     }
   }
@@ -22,11 +22,15 @@ namespace OPENTREP {
    * \note The 2- and 3-letter words (such as 'de' and 'san') are usually not
    *       to be indexed by Xapian. Idem with the 'airport' word.
    *
-   * A way to derive that list is simply by:
+   * That list is derived by:
    * <ol>
-   *   <li>Calculating all the partitions of the initial (full) string</li>
-   *   <li>Extract from those partitions all the unique word combinations</li>
-   *   <li>Add all the word combinations, obtained from removing any group
+   *   <li>Extracting all the unique contiguous word combinations of
+   *       the initial (full) string, i.e., all the word combinations of
+   *       the partitions of that string (see StringPartition). They are
+   *       derived directly, with a number of operations quadratic with
+   *       the number of words, rather than exponential as with
+   *       the partitions</li>
+   *   <li>Adding all the word combinations, obtained from removing any group
    *       of words in the middle of the initial (full) string</li>
    * </ol>
    *
@@ -0,0 +1,483 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+#include <fstream>
+#include <locale>
+// Boost
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+// SOCI
+#include <soci/soci.h>
+// OpenTrep
+#include <opentrep/Location.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/BasChronometer.hpp>
+#include <opentrep/basic/Utilities.hpp>
+#include <opentrep/bom/ColumnarPORWriter.hpp>
+#include <opentrep/bom/PORFileHelper.hpp>
+#include <opentrep/bom/PORParserHelper.hpp>
+#include <opentrep/command/DBManager.hpp>
+#include <opentrep/command/ColumnarExporter.hpp>
+#include <opentrep/command/IndexingPipeline.hpp>
+#include <opentrep/command/SerialisedPlaceBinding.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  ColumnarExporter::ColumnarExporter (ColumnarPORWriter& ioWriter,
+                                      const shouldIndexNonIATAPOR_T& iIncludeNonIATAPOR,
+                                      const PORParserType& iPORParserType,
+                                      const NbOfThreads_T& iNbOfThreads,
+                                      const NbOfDBEntries_T& iRowGroupSize,
+                                      const NbOfDBEntries_T& iQueueSize)
+    : _writer (ioWriter), _includeNonIATAPOR (iIncludeNonIATAPOR),
+      _porParserType (iPORParserType), _nbOfWorkers (iNbOfThreads),
+      _rowGroupSize (iRowGroupSize),
+      _porFileStream_ptr (NULL), _selectStatement_ptr (NULL),
+      _serialisedPlace_ptr (NULL), _schemaVersion (0),
+      _nbOfReadRowGroups (0), _nextRowGroupToWrite (0),
+      _isReadingOver (false), _isAborted (false),
+      _nbOfReadRecords (0), _nbOfWrittenPOR (0),
+      _readingTime (0.0), _decodingTime (0.0), _encodingTime (0.0),
+      _writingTime (0.0), _elapsedTime (0.0) {
+
+    if (_nbOfWorkers == 0) {
+      _nbOfWorkers = boost::thread::hardware_concurrency();
+    }
+    if (_nbOfWorkers == 0) {
+      _nbOfWorkers = 1;
+    }
+
+    // The memory of the slots (records and encoded row groups) is
+    // re-used from one row group to another
+    assert (iRowGroupSize != 0 && iQueueSize != 0);
+    _slotList.resize (iQueueSize);
+    for (std::vector<Slot>::iterator itSlot = _slotList.begin();
+         itSlot != _slotList.end(); ++itSlot) {
+      Slot& lSlot = *itSlot;
+      lSlot._nbOfRecords = 0;
+      lSlot._nbOfRows = 0;
+      lSlot._state = FREE;
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  ColumnarExporter::~ColumnarExporter() {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T ColumnarExporter::
+  exportPOR (const FilePath_T& iColumnarFilePath,
+             const PORFilePath_T& iPORFilePath,
+             const DBType& iSQLDBType,
+             const SQLDBConnectionString_T& iSQLDBConnStr,
+             const shouldIndexNonIATAPOR_T& iIncludeNonIATAPOR,
+             const PORParserType& iPORParserType,
+             const NbOfThreads_T& iNbOfThreads) {
+    NbOfDBEntries_T oNbOfEntries = 0;
+
+    // (Re-)create the columnar file
+    std::ofstream lColumnarFile (iColumnarFilePath.c_str(),
+                                 std::ios::out | std::ios::binary
+                                 | std::ios::trunc);
+    if (lColumnarFile.is_open() == false) {
+      std::ostringstream errorStr;
+      errorStr << "The columnar export file ('" << iColumnarFilePath
+               << "') cannot be created";
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw FileException (errorStr.str());
+    }
+    ColumnarPORWriter lWriter (lColumnarFile);
+    ColumnarExporter lColumnarExporter (lWriter, iIncludeNonIATAPOR,
+                                        iPORParserType, iNbOfThreads,
+                                        K_DEFAULT_COLUMNAR_ROW_GROUP_SIZE,
+                                        K_DEFAULT_COLUMNAR_QUEUE_SIZE);
+
+    if (!(iSQLDBType == DBType::NODB)) {
+      // Export the POR of the SQL database
+      soci::session* lSociSession_ptr =
+        DBManager::initSQLDBSession (iSQLDBType, iSQLDBConnStr);
+      if (lSociSession_ptr == NULL) {
+        std::ostringstream errorStr;
+        errorStr << "Error when trying to connect to the SQL database ('"
+                 << iSQLDBConnStr << "')";
+        OPENTREP_LOG_ERROR (errorStr.str());
+        throw SQLDatabaseImpossibleConnectionException (errorStr.str());
+      }
+      assert (lSociSession_ptr != NULL);
+
+      try {
+        oNbOfEntries = lColumnarExporter.run (*lSociSession_ptr);
+
+      } catch (...) {
+        DBManager::terminateSQLDBSession (iSQLDBType, iSQLDBConnStr,
+                                          *lSociSession_ptr);
+        throw;
+      }
+      DBManager::terminateSQLDBSession (iSQLDBType, iSQLDBConnStr,
+                                        *lSociSession_ptr);
+
+    } else {
+      // Without SQL database, export the POR of the POR data file
+      const PORFileHelper lPORFileHelper (iPORFilePath);
+      std::istream& lPORFileStream = lPORFileHelper.getFileStreamRef();
+      oNbOfEntries = lColumnarExporter.run (lPORFileStream);
+    }
+
+    // Write the footer
+    lWriter.close();
+    lColumnarFile.close();
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG (oNbOfEntries << " POR have been exported, in "
+                        << lWriter.getNbOfRowGroups() << " row groups, into '"
+                        << iColumnarFilePath << "'");
+
+    return oNbOfEntries;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarExporter::abort() {
+    if (_isAborted == false) {
+      _isAborted = true;
+      _exception = std::current_exception();
+    }
+    _slotReleased.notify_all();
+    _rowGroupRead.notify_all();
+    _rowGroupEncoded.notify_all();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T ColumnarExporter::run (std::istream& iPORFileStream) {
+    _porFileStream_ptr = &iPORFileStream;
+    _selectStatement_ptr = NULL;
+    const NbOfDBEntries_T oNbOfEntries = run();
+    _porFileStream_ptr = NULL;
+    return oNbOfEntries;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T ColumnarExporter::run (soci::session& ioSociSession) {
+    // The column of the serialised places depends on the version
+    // of the schema
+    _schemaVersion = DBManager::getSQLDBSchemaVersion (ioSociSession);
+    SerialisedPlaceBinding lSerialisedPlace (ioSociSession, _schemaVersion);
+    soci::statement lSelectStatement (ioSociSession);
+    DBManager::prepareSelectAllSerialisedPlaceStatement (ioSociSession,
+                                                         lSelectStatement,
+                                                         lSerialisedPlace);
+    _porFileStream_ptr = NULL;
+    _selectStatement_ptr = &lSelectStatement;
+    _serialisedPlace_ptr = &lSerialisedPlace;
+    NbOfDBEntries_T oNbOfEntries = 0;
+    try {
+      oNbOfEntries = run();
+
+    } catch (...) {
+      _selectStatement_ptr = NULL;
+      _serialisedPlace_ptr = NULL;
+      throw;
+    }
+    _selectStatement_ptr = NULL;
+    _serialisedPlace_ptr = NULL;
+    return oNbOfEntries;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  bool ColumnarExporter::readRecord (std::string& ioRecord) {
+    if (_porFileStream_ptr != NULL) {
+      while (std::getline (*_porFileStream_ptr, ioRecord)) {
+        /* When only the IATA-referenced POR must be exported, the line
+         * must start with a non empty IATA code of three letters, i.e.,
+         * the first separator (the hat symbol) must be at position 3
+         * (as with the indexing of the POR).
+         */
+        if (!_includeNonIATAPOR) {
+          const size_t lFirstSeparatorPos = ioRecord.find_first_of ("^");
+          if (lFirstSeparatorPos != 3) {
+            continue;
+          }
+        }
+        return true;
+      }
+      return false;
+    }
+
+    assert (_selectStatement_ptr != NULL && _serialisedPlace_ptr != NULL);
+    const bool hasStillData =
+      DBManager::iterateOnStatement (*_selectStatement_ptr,
+                                     *_serialisedPlace_ptr);
+    if (hasStillData == true) {
+      ioRecord.assign (_serialisedPlace_ptr->getSerialisedPlace());
+    }
+    return hasStillData;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T ColumnarExporter::run() {
+    BasChronometer lElapsedChronometer;
+    lElapsedChronometer.start();
+
+    // Launch the worker threads and the writer thread
+    boost::thread_group lThreadGroup;
+    for (NbOfThreads_T idx = 0; idx != _nbOfWorkers; ++idx) {
+      lThreadGroup.create_thread (boost::bind (&ColumnarExporter::work, this));
+    }
+    lThreadGroup.create_thread (boost::bind (&ColumnarExporter::write, this));
+
+    // Read the records, and gather them into row groups
+    const NbOfDBEntries_T lNbOfSlots = _slotList.size();
+    bool hasStillRecords = true;
+    while (hasStillRecords == true) {
+      Slot* lSlot_ptr = NULL;
+      {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+
+        // Wait for the slot to be released by the writer
+        while (_isAborted == false
+               && _nbOfReadRowGroups - _nextRowGroupToWrite >= lNbOfSlots) {
+          _slotReleased.wait (lLock);
+        }
+        if (_isAborted == true) {
+          break;
+        }
+        lSlot_ptr = &_slotList[_nbOfReadRowGroups % lNbOfSlots];
+      }
+
+      // The slot belongs to the current thread, until it is marked as read
+      assert (lSlot_ptr != NULL);
+      Slot& lSlot = *lSlot_ptr;
+      assert (lSlot._state == FREE);
+      lSlot._nbOfRecords = 0;
+      BasChronometer lReadingChronometer;
+      lReadingChronometer.start();
+      try {
+        while (lSlot._nbOfRecords != _rowGroupSize) {
+          if (lSlot._nbOfRecords == lSlot._recordList.size()) {
+            lSlot._recordList.push_back ("");
+          }
+          std::string& lRecord = lSlot._recordList[lSlot._nbOfRecords];
+          hasStillRecords = readRecord (lRecord);
+          if (hasStillRecords == false) {
+            break;
+          }
+          ++lSlot._nbOfRecords;
+        }
+
+      } catch (...) {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        abort();
+        break;
+      }
+      _readingTime += lReadingChronometer.elapsed();
+      _nbOfReadRecords += lSlot._nbOfRecords;
+      if (lSlot._nbOfRecords == 0) {
+        break;
+      }
+
+      // Hand the row group over to the worker threads
+      boost::unique_lock<boost::mutex> lLock (_mutex);
+      lSlot._state = READ;
+      _workQueue.push_back (_nbOfReadRowGroups);
+      ++_nbOfReadRowGroups;
+      _rowGroupRead.notify_one();
+    }
+
+    // Signal the end of the records, and wait for the other threads
+    {
+      boost::unique_lock<boost::mutex> lLock (_mutex);
+      _isReadingOver = true;
+      _rowGroupRead.notify_all();
+      _rowGroupEncoded.notify_all();
+    }
+    lThreadGroup.join_all();
+
+    _elapsedTime = lElapsedChronometer.elapsed();
+
+    // Propagate the failure of any stage
+    if (_isAborted == true) {
+      std::rethrow_exception (_exception);
+    }
+
+    // Report the throughputs
+    const std::string& lThroughputs = describeThroughputs();
+    OPENTREP_LOG_NOTIFICATION (lThroughputs);
+
+    return _nbOfWrittenPOR;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarExporter::work() {
+    const NbOfDBEntries_T lNbOfSlots = _slotList.size();
+    double lDecodingTime = 0.0;
+    double lEncodingTime = 0.0;
+
+    while (true) {
+      // Wait for a row group to be decoded
+      NbOfDBEntries_T lRowGroupNumber = 0;
+      {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        while (_isAborted == false && _workQueue.empty() == true
+               && _isReadingOver == false) {
+          _rowGroupRead.wait (lLock);
+        }
+        if (_isAborted == true || _workQueue.empty() == true) {
+          _decodingTime += lDecodingTime;
+          _encodingTime += lEncodingTime;
+          return;
+        }
+        lRowGroupNumber = _workQueue.front();
+        _workQueue.pop_front();
+      }
+
+      // The slot belongs to the current thread, until it is marked
+      // as encoded
+      Slot& lSlot = _slotList[lRowGroupNumber % lNbOfSlots];
+      assert (lSlot._state == READ);
+      LocationList_T& lLocationList = lSlot._locationList;
+
+      try {
+        // Decode the records, i.e., either parse the lines of the POR
+        // data file, or decode the serialised places
+        BasChronometer lDecodingChronometer;
+        lDecodingChronometer.start();
+        lLocationList.clear();
+        for (NbOfDBEntries_T idx = 0; idx != lSlot._nbOfRecords; ++idx) {
+          const std::string& lRecord = lSlot._recordList[idx];
+          if (_porFileStream_ptr != NULL) {
+            PORStringParser lStringParser (lRecord, _porParserType);
+            const Location& lLocation = lStringParser.generateLocation();
+
+            // The irrelevant lines (e.g., header) are skipped
+            const std::string& lCommonName = lLocation.getCommonName();
+            if (lCommonName != "NotAvailable") {
+              lLocationList.push_back (lLocation);
+            }
+
+          } else {
+            lLocationList.push_back (DBManager::retrieveLocation (_schemaVersion,
+                                                                  lRecord));
+          }
+        }
+        lDecodingTime += lDecodingChronometer.elapsed();
+
+        // Encode the row group, column after column
+        BasChronometer lEncodingChronometer;
+        lEncodingChronometer.start();
+        ColumnarPORWriter::encodeRowGroup (lLocationList, lSlot._rowGroup);
+        lSlot._nbOfRows = lLocationList.size();
+        lLocationList.clear();
+        lEncodingTime += lEncodingChronometer.elapsed();
+
+      } catch (...) {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        abort();
+        _decodingTime += lDecodingTime;
+        _encodingTime += lEncodingTime;
+        return;
+      }
+
+      // Hand the row group over to the writer thread
+      boost::unique_lock<boost::mutex> lLock (_mutex);
+      lSlot._state = ENCODED;
+      if (lRowGroupNumber == _nextRowGroupToWrite) {
+        _rowGroupEncoded.notify_all();
+      }
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void ColumnarExporter::write() {
+    const NbOfDBEntries_T lNbOfSlots = _slotList.size();
+    double lWritingTime = 0.0;
+    NbOfDBEntries_T lNbOfWrittenPOR = 0;
+
+    while (true) {
+      // Wait for the next row group, in the order of the reading
+      Slot* lSlot_ptr = NULL;
+      {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        while (true) {
+          if (_isAborted == true) {
+            break;
+          }
+          if (_nextRowGroupToWrite < _nbOfReadRowGroups) {
+            lSlot_ptr = &_slotList[_nextRowGroupToWrite % lNbOfSlots];
+            if (lSlot_ptr->_state == ENCODED) {
+              break;
+            }
+          } else if (_isReadingOver == true) {
+            break;
+          }
+          lSlot_ptr = NULL;
+          _rowGroupEncoded.wait (lLock);
+        }
+        if (_isAborted == true || lSlot_ptr == NULL) {
+          _writingTime += lWritingTime;
+          _nbOfWrittenPOR = lNbOfWrittenPOR;
+          return;
+        }
+      }
+
+      assert (lSlot_ptr != NULL);
+      Slot& lSlot = *lSlot_ptr;
+
+      try {
+        // A row group may be empty, when all its records have been skipped
+        if (lSlot._nbOfRows != 0) {
+          BasChronometer lWritingChronometer;
+          lWritingChronometer.start();
+          _writer.writeRowGroup (lSlot._rowGroup, lSlot._nbOfRows);
+          lWritingTime += lWritingChronometer.elapsed();
+          lNbOfWrittenPOR += lSlot._nbOfRows;
+
+          // Progress status
+          std::ostringstream oStr;
+          oStr.imbue (std::locale (std::locale::classic(), new NumSep));
+          oStr << "Number of exported POR: " << lNbOfWrittenPOR
+               << ", in " << _writer.getNbOfRowGroups() << " row groups so far";
+          OPENTREP_LOG_NOTIFICATION (oStr.str());
+        }
+
+      } catch (...) {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        abort();
+        _writingTime += lWritingTime;
+        _nbOfWrittenPOR = lNbOfWrittenPOR;
+        return;
+      }
+
+      // Release the slot, for the reader
+      boost::unique_lock<boost::mutex> lLock (_mutex);
+      lSlot._state = FREE;
+      ++_nextRowGroupToWrite;
+      _slotReleased.notify_one();
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string ColumnarExporter::describeThroughputs() const {
+    std::ostringstream oStr;
+    oStr << "Columnar export pipeline with " << _nbOfWorkers
+         << " worker thread(s): " << _nbOfWrittenPOR << " POR out of "
+         << _nbOfReadRecords << " read records, in " << _nbOfReadRowGroups
+         << " row groups; ";
+    describeStageThroughput (oStr, "overall", _nbOfWrittenPOR, _elapsedTime);
+    oStr << "; ";
+    describeStageThroughput (oStr, "reading", _nbOfReadRecords, _readingTime);
+    oStr << "; ";
+    describeStageThroughput (oStr, "decoding (cumulated over the workers)",
+                             _nbOfReadRecords, _decodingTime);
+    oStr << "; ";
+    describeStageThroughput (oStr, "encoding (cumulated over the workers)",
+                             _nbOfWrittenPOR, _encodingTime);
+    oStr << "; ";
+    describeStageThroughput (oStr, "writing", _nbOfWrittenPOR, _writingTime);
+    return oStr.str();
+  }
+
+}
@@ -0,0 +1,326 @@
+#ifndef __OPENTREP_CMD_COLUMNAREXPORTER_HPP
+#define __OPENTREP_CMD_COLUMNAREXPORTER_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <istream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <exception>
+// Boost
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/DBType.hpp>
+#include <opentrep/PORParserType.hpp>
+#include <opentrep/LocationList.hpp>
+
+/**
+ * Forward declarations
+ */
+// SOCI (for SQL database)
+namespace soci {
+  class session;
+  class statement;
+}
+
+namespace OPENTREP {
+
+  // Forward declarations
+  class ColumnarPORWriter;
+  class SerialisedPlaceBinding;
+
+  /**
+   * @brief Pipeline exporting all the POR (points of reference) into
+   *        a columnar file (see ColumnarPORWriter), with several threads.
+   *
+   * The POR are read either from the SQL database (serialised places)
+   * or, when there is no SQL database, from the POR data file. The
+   * pipeline is made of three stages:
+   * <ol>
+   *   <li>the calling thread reads the records (serialised places or lines
+   *       of the POR data file), and gathers them into row groups;</li>
+   *   <li>several worker threads decode the records of a row group into
+   *       Location structures (decoding of the Protobuf records, or parsing
+   *       of the lines), and encode them, column after column;</li>
+   *   <li>a single writer thread writes the encoded row groups, strictly
+   *       in the order in which they have been read.</li>
+   * </ol>
+   *
+   * The row groups travel through a ring of slots, which bounds the
+   * memory used by the export, whatever the number of POR: a row group
+   * is read only when the writer has released the slot of the row group
+   * read that many row groups before.
+   *
+   * The time spent by every stage is measured, and the corresponding
+   * throughputs (in rows per second) are reported at the end.
+   */
+  class ColumnarExporter {
+  public:
+    /**
+     * Export all the POR into the given columnar file.
+     *
+     * @param const FilePath_T& File-path of the columnar file to be
+     *        (re-)created.
+     * @param const PORFilePath_T& File-path of the POR data file, read
+     *        when there is no SQL database.
+     * @param const DBType& SQL database type (can be no database at all).
+     * @param const SQLDBConnectionString_T& SQL DB connection string.
+     * @param const shouldIndexNonIATAPOR_T& Whether all the POR of the data
+     *        file should be exported.
+     * @param const PORParserType& Type of the parser of the POR records.
+     * @param const NbOfThreads_T& Number of worker threads (0 means the
+     *        number of hardware threads).
+     * @return NbOfDBEntries_T Number of exported POR.
+     */
+    static NbOfDBEntries_T exportPOR (const FilePath_T&, const PORFilePath_T&,
+                                      const DBType&,
+                                      const SQLDBConnectionString_T&,
+                                      const shouldIndexNonIATAPOR_T&,
+                                      const PORParserType&,
+                                      const NbOfThreads_T&);
+
+  public:
+    /**
+     * Constructor.
+     *
+     * @param ColumnarPORWriter& Writer of the columnar file.
+     * @param const shouldIndexNonIATAPOR_T& Whether all the POR of the data
+     *        file should be exported.
+     * @param const PORParserType& Type of the parser of the POR records.
+     * @param const NbOfThreads_T& Number of worker threads (0 means the
+     *        number of hardware threads).
+     * @param const NbOfDBEntries_T& Number of POR of a row group.
+     * @param const NbOfDBEntries_T& Maximal number of row groups being
+     *        processed at once.
+     */
+    ColumnarExporter (ColumnarPORWriter&, const shouldIndexNonIATAPOR_T&,
+                      const PORParserType&, const NbOfThreads_T&,
+                      const NbOfDBEntries_T&, const NbOfDBEntries_T&);
+
+    /**
+     * Destructor.
+     */
+    ~ColumnarExporter();
+
+    /**
+     * Read, parse and export all the POR of the given POR data file stream.
+     *
+     * When any stage fails (e.g., parsing error), the whole pipeline
+     * is stopped, and the exception is re-thrown in the calling thread.
+     *
+     * @param std::istream& Stream of the POR data file.
+     * @return NbOfDBEntries_T Number of exported POR.
+     */
+    NbOfDBEntries_T run (std::istream&);
+
+    /**
+     * Retrieve, decode and export all the POR of the SQL database.
+     *
+     * When any stage fails (e.g., decoding error), the whole pipeline
+     * is stopped, and the exception is re-thrown in the calling thread.
+     *
+     * @param soci::session& SOCI session handler.
+     * @return NbOfDBEntries_T Number of exported POR.
+     */
+    NbOfDBEntries_T run (soci::session&);
+
+    /**
+     * Get a string describing the throughputs of every stage.
+     */
+    std::string describeThroughputs() const;
+
+
+  private:
+    /**
+     * State of a slot of the ring.
+     */
+    typedef enum {
+      FREE = 0,
+      READ,
+      ENCODED,
+      LAST_VALUE
+    } EN_SlotState;
+
+    /**
+     * Slot of the ring, holding a row group from the reading of its
+     * records until the writing of its encoded columns.
+     */
+    struct Slot {
+      /**
+       * Records (serialised places or lines of the POR data file).
+       * The strings are kept from one row group to another, so that
+       * their memory is allocated only once.
+       */
+      std::vector<std::string> _recordList;
+
+      /**
+       * Number of records of the row group (the first ones of the list).
+       */
+      NbOfDBEntries_T _nbOfRecords;
+
+      /**
+       * Decoded POR, i.e., rows of the row group.
+       */
+      LocationList_T _locationList;
+
+      /**
+       * Encoded row group.
+       */
+      std::string _rowGroup;
+
+      /**
+       * Number of rows of the encoded row group.
+       */
+      NbOfDBEntries_T _nbOfRows;
+
+      /**
+       * State of the slot.
+       */
+      EN_SlotState _state;
+    };
+
+    /**
+     * Read the next record, either from the POR data file, or from the
+     * SQL database.
+     *
+     * @param std::string& Record.
+     * @return bool Whether a record has been read.
+     */
+    bool readRecord (std::string&);
+
+    /**
+     * Read all the records, gather them into row groups, and wait for
+     * the worker and writer threads.
+     */
+    NbOfDBEntries_T run();
+
+    /**
+     * Body of the worker threads: decode and encode the row groups.
+     */
+    void work();
+
+    /**
+     * Body of the writer thread: write the encoded row groups, in the
+     * order of the reading.
+     */
+    void write();
+
+    /**
+     * Stop the whole pipeline, after a failure of a stage. The exception
+     * currently handled is kept, so as to be re-thrown by run().
+     *
+     * \note The mutex must be locked by the caller.
+     */
+    void abort();
+
+
+  private:
+    // //////////////// Attributes ///////////////
+    /**
+     * Writer of the columnar file.
+     */
+    ColumnarPORWriter& _writer;
+
+    /**
+     * Whether all the POR of the data file should be exported.
+     */
+    const shouldIndexNonIATAPOR_T _includeNonIATAPOR;
+
+    /**
+     * Type of the parser of the POR records.
+     */
+    const PORParserType _porParserType;
+
+    /**
+     * Number of worker threads.
+     */
+    NbOfThreads_T _nbOfWorkers;
+
+    /**
+     * Number of POR of a row group.
+     */
+    const NbOfDBEntries_T _rowGroupSize;
+
+    /**
+     * Stream of the POR data file (NULL when reading the SQL database).
+     */
+    std::istream* _porFileStream_ptr;
+
+    /**
+     * SQL statement retrieving the serialised places (NULL when reading
+     * the POR data file), and the current serialised place.
+     */
+    soci::statement* _selectStatement_ptr;
+    SerialisedPlaceBinding* _serialisedPlace_ptr;
+
+    /**
+     * Version of the schema of the SQL database.
+     */
+    SQLDBSchemaVersion_T _schemaVersion;
+
+    /**
+     * Ring of slots.
+     */
+    std::vector<Slot> _slotList;
+
+    /**
+     * Sequence numbers of the read row groups, waiting for a worker thread.
+     */
+    std::deque<NbOfDBEntries_T> _workQueue;
+
+    /**
+     * Number of read row groups (i.e., sequence number of the next one).
+     */
+    NbOfDBEntries_T _nbOfReadRowGroups;
+
+    /**
+     * Sequence number of the next row group to be written.
+     */
+    NbOfDBEntries_T _nextRowGroupToWrite;
+
+    /**
+     * Whether all the records have been read.
+     */
+    bool _isReadingOver;
+
+    /**
+     * Whether the pipeline has been stopped after a failure.
+     */
+    bool _isAborted;
+
+    /**
+     * Exception raised by the failing stage, if any.
+     */
+    std::exception_ptr _exception;
+
+    /**
+     * Mutex protecting the state of the pipeline, and the associated
+     * conditions, respectively signalled when a slot is released by the
+     * writer, when a row group is read, and when a row group is encoded.
+     */
+    boost::mutex _mutex;
+    boost::condition_variable _slotReleased;
+    boost::condition_variable _rowGroupRead;
+    boost::condition_variable _rowGroupEncoded;
+
+    /**
+     * Statistics: number of read records, and of written POR; time
+     * (in seconds) spent by every stage, cumulated over the threads
+     * of that stage.
+     */
+    NbOfDBEntries_T _nbOfReadRecords;
+    NbOfDBEntries_T _nbOfWrittenPOR;
+    double _readingTime;
+    double _decodingTime;
+    double _encodingTime;
+    double _writingTime;
+    double _elapsedTime;
+  };
+
+}
+#endif // __OPENTREP_CMD_COLUMNAREXPORTER_HPP
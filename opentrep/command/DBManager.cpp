@@ -4,6 +4,8 @@
 // STL
 #include <cassert>
 #include <sstream>
+#include <algorithm>
+#include <set>
 // Boost
 #include <boost/lexical_cast.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
@@ -15,17 +17,22 @@
 #include <soci/mysql/soci-mysql.h>
 // OpenTrep
 #include <opentrep/Location.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
 #include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
 #include <opentrep/basic/Utilities.hpp>
 #include <opentrep/bom/World.hpp>
 #include <opentrep/bom/Place.hpp>
 #include <opentrep/bom/Result.hpp>
+#include <opentrep/bom/LocationExchange.hpp>
 #include <opentrep/bom/PORFileHelper.hpp>
 #include <opentrep/bom/PORParserHelper.hpp>
 #include <opentrep/factory/FacPlace.hpp>
 #include <opentrep/dbadaptor/DbaPlace.hpp>
 #include <opentrep/command/DBManager.hpp>
 #include <opentrep/command/FileManager.hpp>
+#include <opentrep/command/PlaceBulkLoader.hpp>
+#include <opentrep/command/SelectStatementCache.hpp>
+#include <opentrep/command/SerialisedPlaceBinding.hpp>
 #include <opentrep/service/Logger.hpp>
 
 namespace OPENTREP {
@@ -491,7 +498,10 @@ namespace OPENTREP {
            envelope_id int(11) default NULL,
            date_from date default NULL,
            date_until date default NULL,
-           serialised_place varchar(12000) default NULL);
+           serialised_place_pb blob default NULL);
+           drop table if exists optd_por_schema;
+           create table optd_por_schema (version int(11) NOT NULL);
+           insert into optd_por_schema values (2);
         */
 
         ioSociSession << "drop table if exists optd_por;";
@@ -509,9 +519,16 @@ namespace OPENTREP {
         lSQLTableCreationStr << "envelope_id int(11) default NULL, ";
         lSQLTableCreationStr << "date_from date default NULL, ";
         lSQLTableCreationStr << "date_until date default NULL, ";
-        lSQLTableCreationStr << "serialised_place varchar(12000) default NULL);";
+        lSQLTableCreationStr << "serialised_place_pb blob default NULL);";
         ioSociSession << lSQLTableCreationStr.str();
 
+        // Version of the schema
+        ioSociSession << "drop table if exists optd_por_schema;";
+        ioSociSession << "create table optd_por_schema "
+                      << "(version int(11) NOT NULL);";
+        ioSociSession << "insert into optd_por_schema values ("
+                      << K_SQL_DB_SCHEMA_VERSION << ");";
+
       } catch (std::exception const& lException) {
         std::ostringstream errorStr;
         errorStr << "Error when trying to create SQLite3 tables: "
@@ -547,7 +564,10 @@ namespace OPENTREP {
            envelope_id int(11) default NULL,
            date_from date default NULL,
            date_until date default NULL,
-           serialised_place varchar(12000) default NULL);
+           serialised_place_pb blob default NULL);
+           drop table if exists optd_por_schema;
+           create table optd_por_schema (version int(11) NOT NULL);
+           insert into optd_por_schema values (2);
         */
 
         ioSociSession << "drop table if exists optd_por;";
@@ -565,9 +585,16 @@ namespace OPENTREP {
         lSQLTableCreationStr << "envelope_id int(11) default NULL, ";
         lSQLTableCreationStr << "date_from date default NULL, ";
         lSQLTableCreationStr << "date_until date default NULL, ";
-        lSQLTableCreationStr << "serialised_place varchar(12000) default NULL); ";
+        lSQLTableCreationStr << "serialised_place_pb blob default NULL); ";
         ioSociSession << lSQLTableCreationStr.str();
 
+        // Version of the schema
+        ioSociSession << "drop table if exists optd_por_schema;";
+        ioSociSession << "create table optd_por_schema "
+                      << "(version int(11) NOT NULL);";
+        ioSociSession << "insert into optd_por_schema values ("
+                      << K_SQL_DB_SCHEMA_VERSION << ");";
+
       } catch (std::exception const& lException) {
         std::ostringstream errorStr;
         errorStr << "Error when trying to create MySQL/MariaDB tables: "
@@ -591,6 +618,53 @@ namespace OPENTREP {
     }
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  SQLDBSchemaVersion_T DBManager::
+  getSQLDBSchemaVersion (soci::session& ioSociSession) {
+    SQLDBSchemaVersion_T oSchemaVersion = 1;
+
+    try {
+
+      /**
+         select max(version) from optd_por_schema;
+      */
+      int lSchemaVersion = 0;
+      soci::indicator lSchemaVersionIndicator;
+      ioSociSession << "select max(version) from optd_por_schema",
+        soci::into (lSchemaVersion, lSchemaVersionIndicator);
+      if (lSchemaVersionIndicator == soci::i_ok && lSchemaVersion > 1) {
+        oSchemaVersion = static_cast<SQLDBSchemaVersion_T> (lSchemaVersion);
+      }
+
+    } catch (std::exception const& lException) {
+      // The optd_por_schema table does not exist, i.e., the SQL database
+      // has been created by a former version of OpenTREP
+      OPENTREP_LOG_DEBUG ("The version of the schema of the SQL database "
+                          << "cannot be retrieved (" << lException.what()
+                          << "); it is assumed to be 1");
+    }
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Version of the schema of the SQL database: "
+                        << oSchemaVersion);
+
+    return oSchemaVersion;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  Location DBManager::
+  retrieveLocation (const SQLDBSchemaVersion_T& iSchemaVersion,
+                    const std::string& iSerialisedPlace) {
+    if (iSchemaVersion >= 2) {
+      // Decode the Protobuf record
+      return LocationExchange::deserialiseLocation (iSerialisedPlace);
+    }
+
+    // Parse the raw data string
+    const RawDataString_T lPlaceRawData (iSerialisedPlace);
+    return Result::retrieveLocation (lPlaceRawData);
+  }
+
   // //////////////////////////////////////////////////////////////////////
   void DBManager::createSQLDBIndexes (soci::session& ioSociSession) {
     const std::string& lDBName = ioSociSession.get_backend_name();
@@ -705,21 +779,22 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  std::string DBManager::
-  prepareSelectAllBlobStatement (soci::session& ioSociSession,
-                                 soci::statement& ioSelectStatement) {
-    std::string oSerialisedPlaceStr;
+  void DBManager::
+  prepareSelectAllSerialisedPlaceStatement (soci::session& ioSociSession,
+                                            soci::statement& ioSelectStatement,
+                                            SerialisedPlaceBinding& ioBinding) {
   
     try {
     
       // Instanciate a SQL statement (no request is performed at that stage)
       /**
-         select serialised_place from optd_por;
+         select serialised_place_pb from optd_por;
       */
-
       ioSelectStatement = (ioSociSession.prepare
-                           << "select serialised_place from optd_por",
-                           soci::into (oSerialisedPlaceStr));
+                           << "select "
+                           << ioBinding.getColumnName()
+                           << " from optd_por",
+                           ioBinding.into());
 
       // Execute the SQL query
       ioSelectStatement.execute();
@@ -732,9 +807,6 @@ namespace OPENTREP {
       OPENTREP_LOG_ERROR (errorStr.str());
       throw SQLDatabaseException (errorStr.str());
     }
-
-    //
-    return oSerialisedPlaceStr;
   }
 
   // //////////////////////////////////////////////////////////////////////
@@ -742,7 +814,7 @@ namespace OPENTREP {
   prepareSelectBlobOnIataCodeStatement (soci::session& ioSociSession,
                                         soci::statement& ioSelectStatement,
                                         const std::string& iIataCode,
-                                        std::string& ioSerialisedPlaceStr) {
+                                        SerialisedPlaceBinding& ioBinding) {
   
     try {
     
@@ -751,10 +823,12 @@ namespace OPENTREP {
          select serialised_place from optd_por where iata_code = iIataCode;
       */
       ioSelectStatement = (ioSociSession.prepare
-                           << "select serialised_place from optd_por "
+                           << "select "
+                           << ioBinding.getColumnName()
+                           << " from optd_por "
                            << "where iata_code = :place_iata_code",
                            soci::use (iIataCode),
-                           soci::into (ioSerialisedPlaceStr));
+                           ioBinding.into());
 
       // Execute the SQL query
       ioSelectStatement.execute();
@@ -774,7 +848,7 @@ namespace OPENTREP {
   prepareSelectBlobOnIcaoCodeStatement (soci::session& ioSociSession,
                                         soci::statement& ioSelectStatement,
                                         const std::string& iIcaoCode,
-                                        std::string& ioSerialisedPlaceStr) {
+                                        SerialisedPlaceBinding& ioBinding) {
   
     try {
     
@@ -783,10 +857,12 @@ namespace OPENTREP {
          select serialised_place from optd_por where icao_code = iIcaoCode;
       */
       ioSelectStatement = (ioSociSession.prepare
-                           << "select serialised_place from optd_por "
+                           << "select "
+                           << ioBinding.getColumnName()
+                           << " from optd_por "
                            << "where icao_code = :place_icao_code",
                            soci::use (iIcaoCode),
-                           soci::into (ioSerialisedPlaceStr));
+                           ioBinding.into());
 
       // Execute the SQL query
       ioSelectStatement.execute();
@@ -806,7 +882,7 @@ namespace OPENTREP {
   prepareSelectBlobOnFaaCodeStatement (soci::session& ioSociSession,
                                        soci::statement& ioSelectStatement,
                                        const std::string& iFaaCode,
-                                       std::string& ioSerialisedPlaceStr) {
+                                       SerialisedPlaceBinding& ioBinding) {
   
     try {
     
@@ -815,10 +891,12 @@ namespace OPENTREP {
          select serialised_place from optd_por where faa_code = iFaaCode;
       */
       ioSelectStatement = (ioSociSession.prepare
-                           << "select serialised_place from optd_por "
+                           << "select "
+                           << ioBinding.getColumnName()
+                           << " from optd_por "
                            << "where faa_code = :place_faa_code",
                            soci::use (iFaaCode),
-                           soci::into (ioSerialisedPlaceStr));
+                           ioBinding.into());
 
       // Execute the SQL query
       ioSelectStatement.execute();
@@ -838,7 +916,7 @@ namespace OPENTREP {
   prepareSelectBlobOnUNLOCodeStatement (soci::session& ioSociSession,
                                         soci::statement& ioSelectStatement,
                                         const std::string& iUNLOCode,
-                                        std::string& ioSerialisedPlaceStr) {
+                                        SerialisedPlaceBinding& ioBinding) {
   
     try {
     
@@ -847,10 +925,12 @@ namespace OPENTREP {
          select serialised_place from optd_por where unlocode_code = iUNLOCode;
       */
       ioSelectStatement = (ioSociSession.prepare
-                           << "select serialised_place from optd_por "
+                           << "select "
+                           << ioBinding.getColumnName()
+                           << " from optd_por "
                            << "where unlocode_code = :place_unlocode_code",
                            soci::use (iUNLOCode),
-                           soci::into (ioSerialisedPlaceStr));
+                           ioBinding.into());
 
       // Execute the SQL query
       ioSelectStatement.execute();
@@ -870,7 +950,7 @@ namespace OPENTREP {
   prepareSelectBlobOnUICCodeStatement (soci::session& ioSociSession,
                                        soci::statement& ioSelectStatement,
                                        const UICCode_T& iUICCode,
-                                       std::string& ioSerialisedPlaceStr) {
+                                       SerialisedPlaceBinding& ioBinding) {
   
     try {
     
@@ -879,10 +959,12 @@ namespace OPENTREP {
          select serialised_place from optd_por where uic_code = iUICCode;
       */
       ioSelectStatement = (ioSociSession.prepare
-                           << "select serialised_place from optd_por "
+                           << "select "
+                           << ioBinding.getColumnName()
+                           << " from optd_por "
                            << "where uic_code = :place_uic_code",
                            soci::use (iUICCode),
-                           soci::into (ioSerialisedPlaceStr));
+                           ioBinding.into());
 
       // Execute the SQL query
       ioSelectStatement.execute();
@@ -902,7 +984,7 @@ namespace OPENTREP {
   prepareSelectBlobOnPlaceGeoIDStatement (soci::session& ioSociSession,
                                           soci::statement& ioSelectStatement,
                                           const GeonamesID_T& iGeonameID,
-                                          std::string& ioSerialisedPlaceStr) {
+                                          SerialisedPlaceBinding& ioBinding) {
   
     try {
     
@@ -911,10 +993,12 @@ namespace OPENTREP {
          select serialised_place from optd_por where iata_code = iIataCode;
       */
       ioSelectStatement = (ioSociSession.prepare
-                           << "select serialised_place from optd_por "
+                           << "select "
+                           << ioBinding.getColumnName()
+                           << " from optd_por "
                            << "where geoname_id = :place_geoname_id",
                            soci::use (iGeonameID),
-                           soci::into (ioSerialisedPlaceStr));
+                           ioBinding.into());
 
       // Execute the SQL query
       ioSelectStatement.execute();
@@ -929,6 +1013,116 @@ namespace OPENTREP {
     }
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  void DBManager::
+  selectBlobOnCodeList (soci::session& ioSociSession,
+                        const SQLDBSchemaVersion_T& iSchemaVersion,
+                        const SelectStatementCache::EN_LookupKind& iLookupKind,
+                        const std::vector<std::string>& iCodeList,
+                        SerialisedPlaceMap_T& ioSerialisedPlaceMap) {
+    // Name of the column holding the codes
+    std::string lColumnName;
+    switch (iLookupKind) {
+    case SelectStatementCache::IATA_CODE: lColumnName = "iata_code"; break;
+    case SelectStatementCache::ICAO_CODE: lColumnName = "icao_code"; break;
+    case SelectStatementCache::FAA_CODE: lColumnName = "faa_code"; break;
+    case SelectStatementCache::UNLOCODE: lColumnName = "unlocode_code"; break;
+    case SelectStatementCache::UIC_CODE: lColumnName = "uic_code"; break;
+    case SelectStatementCache::GEONAME_ID: lColumnName = "geoname_id"; break;
+    default: assert (false); break;
+    }
+
+    // The numerical codes (UIC codes and Geonames IDs) are bound as numbers
+    const bool isNumerical =
+      (iLookupKind == SelectStatementCache::UIC_CODE
+       || iLookupKind == SelectStatementCache::GEONAME_ID);
+    std::vector<GeonamesID_T> lNumericalCodeList;
+
+    // Serialised place, bound to the statements
+    SerialisedPlaceBinding lSerialisedPlace (ioSociSession, iSchemaVersion);
+
+    try {
+
+      if (isNumerical == true) {
+        for (std::vector<std::string>::const_iterator itCode =
+               iCodeList.begin(); itCode != iCodeList.end(); ++itCode) {
+          const std::string& lCode = *itCode;
+          const GeonamesID_T lNumericalCode =
+            boost::lexical_cast<GeonamesID_T> (lCode);
+          lNumericalCodeList.push_back (lNumericalCode);
+        }
+      }
+
+      // Split the list of codes, so as not to exceed the maximal number
+      // of parameters of a SQL query
+      const std::size_t lNbOfCodes = iCodeList.size();
+      for (std::size_t idxStart = 0; idxStart < lNbOfCodes;
+           idxStart += K_DEFAULT_SQL_CODE_LIST_SIZE) {
+        const std::size_t idxEnd =
+          std::min (idxStart + K_DEFAULT_SQL_CODE_LIST_SIZE, lNbOfCodes);
+
+        /**
+           select iata_code, serialised_place from optd_por
+           where iata_code in (:code_0, :code_1, ...);
+        */
+        std::ostringstream lSQLQueryStr;
+        lSQLQueryStr << "select " << lColumnName << ", "
+                     << lSerialisedPlace.getColumnName()
+                     << " from optd_por where " << lColumnName << " in (";
+        for (std::size_t idx = idxStart; idx != idxEnd; ++idx) {
+          if (idx != idxStart) {
+            lSQLQueryStr << ", ";
+          }
+          lSQLQueryStr << ":code_" << idx - idxStart;
+        }
+        lSQLQueryStr << ")";
+
+        // Instanciate the SQL statement, and bind the codes as well as
+        // the columns of the retrieved rows
+        std::string lCode;
+        GeonamesID_T lNumericalCode = 0;
+        soci::statement lSelectStatement (ioSociSession);
+        lSelectStatement.alloc();
+        lSelectStatement.prepare (lSQLQueryStr.str());
+        for (std::size_t idx = idxStart; idx != idxEnd; ++idx) {
+          if (isNumerical == true) {
+            lSelectStatement.exchange (soci::use (lNumericalCodeList[idx]));
+          } else {
+            lSelectStatement.exchange (soci::use (iCodeList[idx]));
+          }
+        }
+        if (isNumerical == true) {
+          lSelectStatement.exchange (soci::into (lNumericalCode));
+        } else {
+          lSelectStatement.exchange (soci::into (lCode));
+        }
+        lSelectStatement.exchange (lSerialisedPlace.into());
+        lSelectStatement.define_and_bind();
+
+        // Execute the SQL query, and store the serialised places by code
+        lSelectStatement.execute();
+        while (iterateOnStatement (lSelectStatement,
+                                   lSerialisedPlace) == true) {
+          if (isNumerical == true) {
+            lCode = boost::lexical_cast<std::string> (lNumericalCode);
+          }
+          const std::string& lSerialisedPlaceStr =
+            lSerialisedPlace.getSerialisedPlace();
+          ioSerialisedPlaceMap.insert (SerialisedPlaceMap_T::
+                                       value_type (lCode, lSerialisedPlaceStr));
+        }
+      }
+
+    } catch (std::exception const& lException) {
+      std::ostringstream errorStr;
+      errorStr << "Error in the 'select serialised_place from optd_por "
+               << "where " << lColumnName << " in (...)' SQL request: "
+               << lException.what();
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SQLDatabaseException (errorStr.str());
+    }
+  }
+
   // //////////////////////////////////////////////////////////////////////
   bool DBManager::iterateOnStatement (soci::statement& ioStatement,
                                       const std::string& iSerialisedPlaceStr) {
@@ -950,6 +1144,17 @@ namespace OPENTREP {
     return hasStillData;
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  bool DBManager::iterateOnStatement (soci::statement& ioStatement,
+                                      SerialisedPlaceBinding& ioBinding) {
+    const bool hasStillData =
+      iterateOnStatement (ioStatement, ioBinding.getSerialisedPlace());
+    if (hasStillData == true) {
+      ioBinding.retrieve();
+    }
+    return hasStillData;
+  }
+
   // //////////////////////////////////////////////////////////////////////
   void DBManager::insertPlaceInDB (soci::session& ioSociSession,
                                    const Place& iPlace) {
@@ -959,94 +1164,8 @@ namespace OPENTREP {
       // Begin a transaction on the database
       ioSociSession.begin();
 
-      // Instanciate a SQL statement (no request is performed at that stage)
-      const LocationKey& lLocationKey = iPlace.getKey();
-      const std::string lPK (lLocationKey.toString());
-      const IATAType& lIataType = iPlace.getIataType();
-      const std::string lLocationType (lIataType.getTypeAsString());
-      const std::string lIataCode (iPlace.getIataCode());
-      const std::string lIcaoCode (iPlace.getIcaoCode());
-      const std::string lFaaCode (iPlace.getFaaCode());
-      const std::string lIsGeonames ((iPlace.isGeonames())?"Y":"N");
-      const std::string lGeonameID =
-        boost::lexical_cast<std::string> (iPlace.getGeonamesID());
-      const std::string lEnvID =
-        boost::lexical_cast<std::string> (iPlace.getEnvelopeID());
-      const std::string lDateFrom =
-        boost::gregorian::to_iso_extended_string (iPlace.getDateFrom());
-      const std::string lDateEnd =
-        boost::gregorian::to_iso_extended_string (iPlace.getDateEnd());
-      const std::string lRawDataString (iPlace.getRawDataString());
-
-      /**
-       * Sometimes, there are several UN/LOCODE codes for a single POR,
-       * for instance USACX/USAIY for
-       * [Atlantic City](http://www.geonames.org/4500546),
-       * New Jersey (NJ), United States (US).
-       *
-       * Take the first of those codes, when existing.
-       *
-       * That may not be optimal, but there is no easy way to solve this.
-       * Indeed, we should either have a related table (with the IATA code
-       * and Geonames ID as foreign key)
-       * or de-normalize the tables, ie having one record per UN/LOCODE,
-       * which would therefore inhibit the unicity in the current primary key.
-       *
-       * Nevertheless, adding that UN/LOCODE in the database allows a fast
-       * retrieval from the database by searching on that code.
-       * But that use case corresponds to a rare usage from the command-line.
-       * Indeed, the UI (eg, http://search-travel.org) uses the full-text
-       * search API, not the direct retrieval from the database.
-       * The only cases when the UI uses the direct database retrieval
-       * is for IATA codes. The condition to trigger that API usage is
-       * to have only a sequence of 3-letter codes. As UN/LOCODE are
-       * 5-letter, the normal full-text serach API is used for UN/LOCODE codes.
-       */
-      const UNLOCodeList_T& lUNLOCodeList = iPlace.getUNLOCodeList();
-      std::string lUNLOCodeStr ("");
-      if (lUNLOCodeList.empty() == false) {
-        const UNLOCode_T& lUNLOCode = lUNLOCodeList.front();
-        lUNLOCodeStr = static_cast<const std::string> (lUNLOCode);
-      }
-
-      /**
-       * Same remark as for UN/LOCODE above. The only difference is that
-       * UIC codes are integers rather than character strings.
-       */
-      const UICCodeList_T& lUICCodeList = iPlace.getUICCodeList();
-      UICCode_T lUICCodeInt = 0;
-      if (lUICCodeList.empty() == false) {
-        const UICCode_T& lUICCode = lUICCodeList.front();
-        lUICCodeInt = static_cast<const UICCode_T> (lUICCode);
-      }
-
-      
-      // DEBUG
-      /*
-      std::ostringstream oStr;
-      oStr << "insert into optd_por values (" << lPK << ", ";
-      oStr << lLocationType << ", ";
-      oStr << lIataCode << ", " << lIcaoCode << ", " << lFaaCode << ", ";
-      oStr << lUNLOCode << ", ";
-      oStr << lUICCode << ", ";
-      oStr << lIsGeonames << ", " << lGeonameID << ", ";
-      oStr << lEnvID << ", " << lDateFrom << ", " << lDateEnd << ", ";
-      oStr << lRawDataString << ")";
-      OPENTREP_LOG_DEBUG ("Full SQL statement: '" << oStr.str() << "'");
-      */
-
-      ioSociSession << "insert into optd_por values (:pk, "
-                    << ":location_type, :iata_code, :icao_code, :faa_code, "
-                    << ":unlocode_code, :uic_code, "
-                    << ":is_geonames, :geoname_id, "
-                    << ":envelope_id, :date_from, :date_until, "
-                    << ":serialised_place)",
-        soci::use (lPK), soci::use (lLocationType), soci::use (lIataCode),
-        soci::use (lIcaoCode), soci::use (lFaaCode),
-        soci::use (lUNLOCodeStr), soci::use (lUICCodeInt),
-        soci::use (lIsGeonames), soci::use (lGeonameID),
-        soci::use (lEnvID), soci::use (lDateFrom), soci::use (lDateEnd),
-        soci::use (lRawDataString);
+      // Insert the row
+      insertPlaceRowInDB (ioSociSession, iPlace);
       
       // Commit the transaction on the database
       ioSociSession.commit();
@@ -1063,6 +1182,158 @@ namespace OPENTREP {
     }
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  void DBManager::insertPlaceRowInDB (soci::session& ioSociSession,
+                                      const Place& iPlace) {
+    // The SQL databases created by a former version of OpenTREP hold
+    // the raw data strings, rather than the Protobuf records, of the POR
+    const SQLDBSchemaVersion_T lSchemaVersion =
+      getSQLDBSchemaVersion (ioSociSession);
+
+    // Values of the columns of the row
+    const PlaceRow lPlaceRow (iPlace, lSchemaVersion);
+    SerialisedPlaceBinding lSerialisedPlace (ioSociSession, lSchemaVersion);
+    lSerialisedPlace.setSerialisedPlace (lPlaceRow._serialisedPlace);
+
+    // DEBUG
+    /*
+    std::ostringstream oStr;
+    oStr << "insert into optd_por values (" << lPlaceRow._pk << ", ";
+    oStr << lPlaceRow._locationType << ", ";
+    oStr << lPlaceRow._iataCode << ", " << lPlaceRow._icaoCode << ", "
+         << lPlaceRow._faaCode << ", ";
+    oStr << lPlaceRow._unlocodeCode << ", ";
+    oStr << lPlaceRow._uicCode << ", ";
+    oStr << lPlaceRow._isGeonames << ", " << lPlaceRow._geonameID << ", ";
+    oStr << lPlaceRow._envelopeID << ", " << lPlaceRow._dateFrom << ", "
+         << lPlaceRow._dateEnd << ", ";
+    oStr << lPlaceRow._serialisedPlace << ")";
+    OPENTREP_LOG_DEBUG ("Full SQL statement: '" << oStr.str() << "'");
+    */
+
+    ioSociSession << "insert into optd_por values (:pk, "
+                  << ":location_type, :iata_code, :icao_code, :faa_code, "
+                  << ":unlocode_code, :uic_code, "
+                  << ":is_geonames, :geoname_id, "
+                  << ":envelope_id, :date_from, :date_until, "
+                  << ":" << lSerialisedPlace.getColumnName() << ")",
+      soci::use (lPlaceRow._pk), soci::use (lPlaceRow._locationType),
+      soci::use (lPlaceRow._iataCode), soci::use (lPlaceRow._icaoCode),
+      soci::use (lPlaceRow._faaCode), soci::use (lPlaceRow._unlocodeCode),
+      soci::use (lPlaceRow._uicCode), soci::use (lPlaceRow._isGeonames),
+      soci::use (lPlaceRow._geonameID), soci::use (lPlaceRow._envelopeID),
+      soci::use (lPlaceRow._dateFrom), soci::use (lPlaceRow._dateEnd),
+      lSerialisedPlace.use();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void DBManager::upsertPlaceInDB (soci::session& ioSociSession,
+                                   const Place& iPlace) {
+  
+    try {
+
+      // Delete the former version of the row, if any
+      const LocationKey& lLocationKey = iPlace.getKey();
+      const std::string lPK (lLocationKey.toString());
+      const EnvelopeID_T& lEnvelopeID = iPlace.getEnvelopeID();
+      deletePlaceFromDB (ioSociSession, lPK, lEnvelopeID);
+
+      // Insert the new version of the row
+      insertPlaceRowInDB (ioSociSession, iPlace);
+
+    } catch (std::exception const& lException) {
+      std::ostringstream errorStr;
+      errorStr << "Error when upserting " << iPlace.toString() << ": "
+               << lException.what();
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SQLDatabaseException (errorStr.str());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void DBManager::deletePlaceFromDB (soci::session& ioSociSession,
+                                     const std::string& iPK,
+                                     const EnvelopeID_T& iEnvelopeID) {
+  
+    try {
+
+      /**
+         delete from optd_por where pk = :pk and envelope_id = :envelope_id;
+      */
+      const std::string lEnvID =
+        boost::lexical_cast<std::string> (iEnvelopeID);
+      ioSociSession << "delete from optd_por "
+                    << "where pk = :pk and envelope_id = :envelope_id",
+        soci::use (iPK), soci::use (lEnvID);
+
+    } catch (std::exception const& lException) {
+      std::ostringstream errorStr;
+      errorStr << "Error when deleting the " << iPK << " POR (envelope "
+               << iEnvelopeID << "): " << lException.what();
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SQLDatabaseException (errorStr.str());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T
+  DBManager::getContentHashes (soci::session& ioSociSession,
+                               ContentHashMap_T& ioContentHashMap) {
+    NbOfDBEntries_T oNbOfEntries = 0;
+
+    try {
+
+      /**
+         select pk, envelope_id, serialised_place_pb from optd_por;
+      */
+      const SQLDBSchemaVersion_T& lSchemaVersion =
+        getSQLDBSchemaVersion (ioSociSession);
+      SerialisedPlaceBinding lSerialisedPlace (ioSociSession, lSchemaVersion);
+      std::string lPK;
+      int lEnvelopeID = 0;
+      soci::statement lSelectStatement =
+        (ioSociSession.prepare
+         << "select pk, envelope_id, " << lSerialisedPlace.getColumnName()
+         << " from optd_por",
+         soci::into (lPK), soci::into (lEnvelopeID),
+         lSerialisedPlace.into());
+      lSelectStatement.execute();
+
+      // The serialised place is the Protobuf record of the POR (from
+      // the version 2 of the schema onwards) or its raw data string
+      // (see calculatePlaceContentHash())
+      while (iterateOnStatement (lSelectStatement, lSerialisedPlace) == true) {
+        const std::string& lUniqueID = buildPORUniqueID (lPK, lEnvelopeID);
+        ioContentHashMap[lUniqueID] =
+          calculateContentHash (lSerialisedPlace.getSerialisedPlace());
+        ++oNbOfEntries;
+      }
+
+    } catch (std::exception const& lException) {
+      std::ostringstream errorStr;
+      errorStr
+        << "Error when retrieving the content of the optd_por table: "
+        << lException.what();
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SQLDatabaseException (errorStr.str());
+    }
+
+    return oNbOfEntries;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  ContentHash_T DBManager::
+  calculatePlaceContentHash (const SQLDBSchemaVersion_T& iSchemaVersion,
+                             const Place& iPlace) {
+    // Same serialisation as for the insertion of the POR (see PlaceRow)
+    if (iSchemaVersion >= 2) {
+      const std::string& lPlaceRecord =
+        LocationExchange::serialiseLocation (iPlace.getLocation());
+      return calculateContentHash (lPlaceRecord);
+    }
+    return calculateContentHash (iPlace.getRawDataString());
+  }
+
   // //////////////////////////////////////////////////////////////////////
   void DBManager::updatePlaceInDB (soci::session& ioSociSession,
                                    const Place& iPlace) {
@@ -1135,10 +1406,13 @@ namespace OPENTREP {
     try {
 
       // Prepare the SQL request corresponding to the select statement
+      const SQLDBSchemaVersion_T& lSchemaVersion =
+        getSQLDBSchemaVersion (ioSociSession);
+      SerialisedPlaceBinding lSerialisedPlace (ioSociSession, lSchemaVersion);
       soci::statement lSelectStatement (ioSociSession);
-      std::string lPlace =
-        DBManager::prepareSelectAllBlobStatement (ioSociSession,
-                                                  lSelectStatement);
+      DBManager::prepareSelectAllSerialisedPlaceStatement (ioSociSession,
+                                                           lSelectStatement,
+                                                           lSerialisedPlace);
 
       /**
        * Retrieve the details of the place, as well as the alternate
@@ -1146,14 +1420,17 @@ namespace OPENTREP {
        */
       bool hasStillData = true;
       while (hasStillData == true) {
-        hasStillData = iterateOnStatement (lSelectStatement, lPlace);
+        hasStillData = iterateOnStatement (lSelectStatement, lSerialisedPlace);
 
         // It is enough to have (at least) one database retrieved row
         if (hasStillData == true) {
           ++oNbOfEntries;
 
           // Debug
-          OPENTREP_LOG_DEBUG ("[" << oNbOfEntries << "] " << lPlace);
+          const Location& lLocation =
+            retrieveLocation (lSchemaVersion,
+                              lSerialisedPlace.getSerialisedPlace());
+          OPENTREP_LOG_DEBUG ("[" << oNbOfEntries << "] " << lLocation);
         }
       }
       
@@ -1169,10 +1446,11 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  NbOfDBEntries_T DBManager::getPORByIATACode (soci::session& ioSociSession,
-                                               const IATACode_T& iIataCode,
-                                               LocationList_T& ioLocationList,
-                                               const bool iUniqueEntry) {
+  NbOfDBEntries_T DBManager::
+  getPORByIATACode (SelectStatementCache& ioStatementCache,
+                    const IATACode_T& iIataCode,
+                    LocationList_T& ioLocationList,
+                    const bool iUniqueEntry) {
     NbOfDBEntries_T oNbOfEntries = 0;
     LocationList_T lLocationList;
 
@@ -1184,13 +1462,13 @@ namespace OPENTREP {
       const std::string& lCode = static_cast<const std::string&> (iIataCode);
       const std::string lCodeUpper = boost::algorithm::to_upper_copy (lCode);
       
-      // Prepare the SQL request corresponding to the select statement
-      soci::statement lSelectStatement (ioSociSession);
-      std::string lPlaceRawDataString;
-      DBManager::prepareSelectBlobOnIataCodeStatement (ioSociSession,
-                                                       lSelectStatement,
-                                                       lCodeUpper,
-                                                       lPlaceRawDataString);
+      // Execute the prepared statement, kept along with the session
+      // (see SelectStatementCache)
+      soci::statement& lSelectStatement =
+        ioStatementCache.selectOnCode (SelectStatementCache::IATA_CODE,
+                                       lCodeUpper);
+      SerialisedPlaceBinding& lSerialisedPlace =
+        ioStatementCache.getSerialisedPlace();
 
       /**
        * Retrieve the details of the place, as well as the alternate
@@ -1199,7 +1477,7 @@ namespace OPENTREP {
       bool hasStillData = true;
       while (hasStillData == true) {
         hasStillData = iterateOnStatement (lSelectStatement,
-                                           lPlaceRawDataString);
+                                           lSerialisedPlace);
 
         // DEBUG
         const std::string lFoundStr = hasStillData?"more; see below":"no more";
@@ -1211,10 +1489,11 @@ namespace OPENTREP {
           //
           ++oNbOfEntries;
 
-          // Parse the POR details and create the corresponding
+          // Decode the POR details and create the corresponding
           // Location structure
-          const RawDataString_T lPlaceRawData (lPlaceRawDataString);
-          Location lLocation = Result::retrieveLocation (lPlaceRawData);
+          Location lLocation =
+            retrieveLocation (lSerialisedPlace.getSchemaVersion(),
+                              lSerialisedPlace.getSerialisedPlace());
           lLocation.setCorrectedKeywords (iIataCode);
 
           // Add the new found location to the list
@@ -1283,9 +1562,10 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  NbOfDBEntries_T DBManager::getPORByICAOCode (soci::session& ioSociSession,
-                                               const ICAOCode_T& iIcaoCode,
-                                               LocationList_T& ioLocationList) {
+  NbOfDBEntries_T DBManager::
+  getPORByICAOCode (SelectStatementCache& ioStatementCache,
+                    const ICAOCode_T& iIcaoCode,
+                    LocationList_T& ioLocationList) {
     NbOfDBEntries_T oNbOfEntries = 0;
 
     try {
@@ -1296,13 +1576,13 @@ namespace OPENTREP {
       const std::string& lCode = static_cast<const std::string&> (iIcaoCode);
       const std::string lCodeUpper = boost::algorithm::to_upper_copy (lCode);
       
-      // Prepare the SQL request corresponding to the select statement
-      soci::statement lSelectStatement (ioSociSession);
-      std::string lPlaceRawDataString;
-      DBManager::prepareSelectBlobOnIcaoCodeStatement (ioSociSession,
-                                                       lSelectStatement,
-                                                       lCodeUpper,
-                                                       lPlaceRawDataString);
+      // Execute the prepared statement, kept along with the session
+      // (see SelectStatementCache)
+      soci::statement& lSelectStatement =
+        ioStatementCache.selectOnCode (SelectStatementCache::ICAO_CODE,
+                                       lCodeUpper);
+      SerialisedPlaceBinding& lSerialisedPlace =
+        ioStatementCache.getSerialisedPlace();
 
       /**
        * Retrieve the details of the place, as well as the alternate
@@ -1311,7 +1591,7 @@ namespace OPENTREP {
       bool hasStillData = true;
       while (hasStillData == true) {
         hasStillData = iterateOnStatement (lSelectStatement,
-                                           lPlaceRawDataString);
+                                           lSerialisedPlace);
 
         // DEBUG
         const std::string lFoundStr = hasStillData?"Yes":"No";
@@ -1322,10 +1602,11 @@ namespace OPENTREP {
           //
           ++oNbOfEntries;
 
-          // Parse the POR details and create the corresponding
+          // Decode the POR details and create the corresponding
           // Location structure
-          const RawDataString_T lPlaceRawData (lPlaceRawDataString);
-          Location lLocation = Result::retrieveLocation (lPlaceRawData);
+          Location lLocation =
+            retrieveLocation (lSerialisedPlace.getSchemaVersion(),
+                              lSerialisedPlace.getSerialisedPlace());
           lLocation.setCorrectedKeywords (iIcaoCode);
 
           // Add the new found location to the list
@@ -1349,9 +1630,10 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  NbOfDBEntries_T DBManager::getPORByFAACode (soci::session& ioSociSession,
-                                              const FAACode_T& iFaaCode,
-                                              LocationList_T& ioLocationList) {
+  NbOfDBEntries_T DBManager::
+  getPORByFAACode (SelectStatementCache& ioStatementCache,
+                   const FAACode_T& iFaaCode,
+                   LocationList_T& ioLocationList) {
     NbOfDBEntries_T oNbOfEntries = 0;
 
     try {
@@ -1362,13 +1644,13 @@ namespace OPENTREP {
       const std::string& lCode = static_cast<const std::string&> (iFaaCode);
       const std::string lCodeUpper = boost::algorithm::to_upper_copy (lCode);
       
-      // Prepare the SQL request corresponding to the select statement
-      soci::statement lSelectStatement (ioSociSession);
-      std::string lPlaceRawDataString;
-      DBManager::prepareSelectBlobOnFaaCodeStatement (ioSociSession,
-                                                      lSelectStatement,
-                                                      lCodeUpper,
-                                                      lPlaceRawDataString);
+      // Execute the prepared statement, kept along with the session
+      // (see SelectStatementCache)
+      soci::statement& lSelectStatement =
+        ioStatementCache.selectOnCode (SelectStatementCache::FAA_CODE,
+                                       lCodeUpper);
+      SerialisedPlaceBinding& lSerialisedPlace =
+        ioStatementCache.getSerialisedPlace();
 
       /**
        * Retrieve the details of the place, as well as the alternate
@@ -1377,7 +1659,7 @@ namespace OPENTREP {
       bool hasStillData = true;
       while (hasStillData == true) {
         hasStillData = iterateOnStatement (lSelectStatement,
-                                           lPlaceRawDataString);
+                                           lSerialisedPlace);
 
         // DEBUG
         const std::string lFoundStr = hasStillData?"Yes":"No";
@@ -1388,10 +1670,11 @@ namespace OPENTREP {
           //
           ++oNbOfEntries;
 
-          // Parse the POR details and create the corresponding
+          // Decode the POR details and create the corresponding
           // Location structure
-          const RawDataString_T lPlaceRawData (lPlaceRawDataString);
-          Location lLocation = Result::retrieveLocation (lPlaceRawData);
+          Location lLocation =
+            retrieveLocation (lSerialisedPlace.getSchemaVersion(),
+                              lSerialisedPlace.getSerialisedPlace());
           lLocation.setCorrectedKeywords (iFaaCode);
 
           // Add the new found location to the list
@@ -1415,10 +1698,11 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  NbOfDBEntries_T DBManager::getPORByUNLOCode (soci::session& ioSociSession,
-                                               const UNLOCode_T& iUNLOCode,
-                                               LocationList_T& ioLocationList,
-                                               const bool iUniqueEntry) {
+  NbOfDBEntries_T DBManager::
+  getPORByUNLOCode (SelectStatementCache& ioStatementCache,
+                    const UNLOCode_T& iUNLOCode,
+                    LocationList_T& ioLocationList,
+                    const bool iUniqueEntry) {
     NbOfDBEntries_T oNbOfEntries = 0;
     LocationList_T lLocationList;
 
@@ -1430,13 +1714,13 @@ namespace OPENTREP {
       const std::string& lCode = static_cast<const std::string&> (iUNLOCode);
       const std::string lCodeUpper = boost::algorithm::to_upper_copy (lCode);
       
-      // Prepare the SQL request corresponding to the select statement
-      soci::statement lSelectStatement (ioSociSession);
-      std::string lPlaceRawDataString;
-      DBManager::prepareSelectBlobOnUNLOCodeStatement (ioSociSession,
-                                                       lSelectStatement,
-                                                       lCodeUpper,
-                                                       lPlaceRawDataString);
+      // Execute the prepared statement, kept along with the session
+      // (see SelectStatementCache)
+      soci::statement& lSelectStatement =
+        ioStatementCache.selectOnCode (SelectStatementCache::UNLOCODE,
+                                       lCodeUpper);
+      SerialisedPlaceBinding& lSerialisedPlace =
+        ioStatementCache.getSerialisedPlace();
 
       /**
        * Retrieve the details of the place, as well as the alternate
@@ -1445,7 +1729,7 @@ namespace OPENTREP {
       bool hasStillData = true;
       while (hasStillData == true) {
         hasStillData = iterateOnStatement (lSelectStatement,
-                                           lPlaceRawDataString);
+                                           lSerialisedPlace);
 
         // DEBUG
         const std::string lFoundStr = hasStillData?"Yes":"No";
@@ -1457,10 +1741,11 @@ namespace OPENTREP {
           //
           ++oNbOfEntries;
 
-          // Parse the POR details and create the corresponding
+          // Decode the POR details and create the corresponding
           // Location structure
-          const RawDataString_T lPlaceRawData (lPlaceRawDataString);
-          Location lLocation = Result::retrieveLocation (lPlaceRawData);
+          Location lLocation =
+            retrieveLocation (lSerialisedPlace.getSchemaVersion(),
+                              lSerialisedPlace.getSerialisedPlace());
           lLocation.setCorrectedKeywords (iUNLOCode);
 
           // Add the new found location to the list
@@ -1522,20 +1807,20 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  NbOfDBEntries_T DBManager::getPORByUICCode (soci::session& ioSociSession,
-                                              const UICCode_T& iUICCode,
-                                              LocationList_T& ioLocationList) {
+  NbOfDBEntries_T DBManager::
+  getPORByUICCode (SelectStatementCache& ioStatementCache,
+                   const UICCode_T& iUICCode,
+                   LocationList_T& ioLocationList) {
     NbOfDBEntries_T oNbOfEntries = 0;
 
     try {
 
-      // Prepare the SQL request corresponding to the select statement
-      soci::statement lSelectStatement (ioSociSession);
-      std::string lPlaceRawDataString;
-      DBManager::prepareSelectBlobOnUICCodeStatement (ioSociSession,
-                                                      lSelectStatement,
-                                                      iUICCode,
-                                                      lPlaceRawDataString);
+      // Execute the prepared statement, kept along with the session
+      // (see SelectStatementCache)
+      soci::statement& lSelectStatement =
+        ioStatementCache.selectOnUICCode (iUICCode);
+      SerialisedPlaceBinding& lSerialisedPlace =
+        ioStatementCache.getSerialisedPlace();
 
       /**
        * Retrieve the details of the place, as well as the alternate
@@ -1544,7 +1829,7 @@ namespace OPENTREP {
       bool hasStillData = true;
       while (hasStillData == true) {
         hasStillData = iterateOnStatement (lSelectStatement,
-                                           lPlaceRawDataString);
+                                           lSerialisedPlace);
 
         // DEBUG
         const std::string lFoundStr = hasStillData?"Yes":"No";
@@ -1556,10 +1841,11 @@ namespace OPENTREP {
           //
           ++oNbOfEntries;
 
-          // Parse the POR details and create the corresponding
+          // Decode the POR details and create the corresponding
           // Location structure
-          const RawDataString_T lPlaceRawData (lPlaceRawDataString);
-          Location lLocation = Result::retrieveLocation (lPlaceRawData);
+          Location lLocation =
+            retrieveLocation (lSerialisedPlace.getSchemaVersion(),
+                              lSerialisedPlace.getSerialisedPlace());
           const std::string lUICCodeStr =
             boost::lexical_cast<std::string> (iUICCode);
           lLocation.setCorrectedKeywords (lUICCodeStr);
@@ -1585,20 +1871,20 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  NbOfDBEntries_T DBManager::getPORByGeonameID (soci::session& ioSociSession,
-                                                const GeonamesID_T& iGeonameID,
-                                                LocationList_T& ioLocationList) {
+  NbOfDBEntries_T DBManager::
+  getPORByGeonameID (SelectStatementCache& ioStatementCache,
+                     const GeonamesID_T& iGeonameID,
+                     LocationList_T& ioLocationList) {
     NbOfDBEntries_T oNbOfEntries = 0;
 
     try {
 
-      // Prepare the SQL request corresponding to the select statement
-      soci::statement lSelectStatement (ioSociSession);
-      std::string lPlaceRawDataString;
-      DBManager::prepareSelectBlobOnPlaceGeoIDStatement (ioSociSession,
-                                                         lSelectStatement,
-                                                         iGeonameID,
-                                                         lPlaceRawDataString);
+      // Execute the prepared statement, kept along with the session
+      // (see SelectStatementCache)
+      soci::statement& lSelectStatement =
+        ioStatementCache.selectOnGeonameID (iGeonameID);
+      SerialisedPlaceBinding& lSerialisedPlace =
+        ioStatementCache.getSerialisedPlace();
 
       /**
        * Retrieve the details of the place, as well as the alternate
@@ -1607,7 +1893,7 @@ namespace OPENTREP {
       bool hasStillData = true;
       while (hasStillData == true) {
         hasStillData = iterateOnStatement (lSelectStatement,
-                                           lPlaceRawDataString);
+                                           lSerialisedPlace);
 
         // DEBUG
         const std::string lFoundStr = hasStillData?"Yes":"No";
@@ -1618,10 +1904,11 @@ namespace OPENTREP {
           //
           ++oNbOfEntries;
 
-          // Parse the POR details and create the corresponding
+          // Decode the POR details and create the corresponding
           // Location structure
-          const RawDataString_T lPlaceRawData (lPlaceRawDataString);
-          Location lLocation = Result::retrieveLocation (lPlaceRawData);
+          Location lLocation =
+            retrieveLocation (lSerialisedPlace.getSchemaVersion(),
+                              lSerialisedPlace.getSerialisedPlace());
           const std::string lGeonamesIDStr =
             boost::lexical_cast<std::string> (iGeonameID);
           lLocation.setCorrectedKeywords (lGeonamesIDStr);
@@ -1646,4 +1933,133 @@ namespace OPENTREP {
     return oNbOfEntries;
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T DBManager::
+  getPORByCodeList (SelectStatementCache& ioStatementCache,
+                    const TypedCodeList_T& iCodeList,
+                    LocationList_T& ioLocationList) {
+    NbOfDBEntries_T oNbOfEntries = 0;
+
+    // Group the (distinct) codes by kind. The codes are converted into
+    // uppercase, as they are stored in the database
+    typedef std::set<std::string> CodeSet_T;
+    CodeSet_T lCodeSetList[SelectStatementCache::LAST_VALUE];
+    for (TypedCodeList_T::const_iterator itCode = iCodeList.begin();
+         itCode != iCodeList.end(); ++itCode) {
+      const TypedCode_T& lTypedCode = *itCode;
+      const std::string lCodeUpper =
+        boost::algorithm::to_upper_copy (lTypedCode.second);
+      lCodeSetList[lTypedCode.first].insert (lCodeUpper);
+    }
+
+    // Retrieve the serialised places, with a single SQL query per kind
+    soci::session& lSociSession = ioStatementCache.getSociSession();
+    const SQLDBSchemaVersion_T& lSchemaVersion =
+      ioStatementCache.getSchemaVersion();
+    SerialisedPlaceMap_T lSerialisedPlaceMapList[SelectStatementCache::
+                                                 LAST_VALUE];
+    for (unsigned short idx = 0; idx != SelectStatementCache::LAST_VALUE;
+         ++idx) {
+      const CodeSet_T& lCodeSet = lCodeSetList[idx];
+      if (lCodeSet.empty() == true) {
+        continue;
+      }
+      const std::vector<std::string> lCodeList (lCodeSet.begin(),
+                                                lCodeSet.end());
+      const SelectStatementCache::EN_LookupKind lLookupKind =
+        static_cast<SelectStatementCache::EN_LookupKind> (idx);
+      selectBlobOnCodeList (lSociSession, lSchemaVersion, lLookupKind,
+                            lCodeList, lSerialisedPlaceMapList[idx]);
+    }
+
+    // Map the retrieved places back onto the codes, in the order of those
+    // latter
+    for (TypedCodeList_T::const_iterator itCode = iCodeList.begin();
+         itCode != iCodeList.end(); ++itCode) {
+      const TypedCode_T& lTypedCode = *itCode;
+      const SelectStatementCache::EN_LookupKind& lLookupKind = lTypedCode.first;
+      const std::string& lCode = lTypedCode.second;
+      const std::string lCodeUpper = boost::algorithm::to_upper_copy (lCode);
+
+      // Decode the POR details and create the corresponding
+      // Location structures
+      LocationList_T lLocationList;
+      const SerialisedPlaceMap_T& lSerialisedPlaceMap =
+        lSerialisedPlaceMapList[lLookupKind];
+      std::pair<SerialisedPlaceMap_T::const_iterator,
+                SerialisedPlaceMap_T::const_iterator> lPlaceRange =
+        lSerialisedPlaceMap.equal_range (lCodeUpper);
+      for (SerialisedPlaceMap_T::const_iterator itPlace = lPlaceRange.first;
+           itPlace != lPlaceRange.second; ++itPlace) {
+        Location lLocation = retrieveLocation (lSchemaVersion,
+                                               itPlace->second);
+        lLocation.setCorrectedKeywords (lCode);
+        lLocationList.push_back (lLocation);
+      }
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("Retrieved " << lLocationList.size()
+                          << " location(s) corresponding to '" << lCode
+                          << "' code");
+
+      // Several entries may correspond to a IATA or UN/LOCODE code (e.g.,
+      // SFO gives both the airport and the city): only the one having
+      // the greatest Page Rank is then kept, as with getPORByIATACode()
+      // and getPORByUNLOCode()
+      const bool isIATACode = (lLookupKind == SelectStatementCache::IATA_CODE);
+      const bool lUniqueEntry =
+        (isIATACode == true || lLookupKind == SelectStatementCache::UNLOCODE);
+      if (lUniqueEntry == false) {
+        ioLocationList.insert (ioLocationList.end(),
+                               lLocationList.begin(), lLocationList.end());
+        oNbOfEntries += lLocationList.size();
+        continue;
+      }
+
+      // For a IATA code, a POR having a zero PageRank value may be kept
+      // (see getPORByIATACode())
+      const Location* lHighestPRLocation_ptr =
+        getHighestPRLocation (lLocationList, isIATACode);
+      if (lHighestPRLocation_ptr != NULL) {
+        ioLocationList.push_back (*lHighestPRLocation_ptr);
+
+        // DEBUG
+        OPENTREP_LOG_DEBUG ("Kept the location with the highest PageRank "
+                            << "value ("
+                            << lHighestPRLocation_ptr->getPageRank()
+                            << ") for '" << lCode << "' code: "
+                            << lHighestPRLocation_ptr->getKey());
+      }
+
+      if (lLocationList.empty() == false) {
+        ++oNbOfEntries;
+      }
+    }
+
+    //
+    return oNbOfEntries;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const Location* DBManager::
+  getHighestPRLocation (const LocationList_T& iLocationList,
+                        const bool iKeepZeroPR) {
+    const Location* oHighestPRLocation_ptr = NULL;
+    PageRank_T lHighestPRValue = 0.0;
+    for (LocationList_T::const_iterator itLoc = iLocationList.begin();
+         itLoc != iLocationList.end(); ++itLoc) {
+      const Location& lLocation = *itLoc;
+      const PageRank_T& lPRValue = lLocation.getPageRank();
+
+      const bool isHigherPR = (iKeepZeroPR == true)?
+        (lPRValue >= lHighestPRValue):(lPRValue > lHighestPRValue);
+      if (isHigherPR == true) {
+        oHighestPRLocation_ptr = &lLocation;
+        lHighestPRValue = lPRValue;
+      }
+    }
+
+    return oHighestPRLocation_ptr;
+  }
+
 }
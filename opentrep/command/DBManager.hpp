@@ -4,11 +4,18 @@
 // //////////////////////////////////////////////////////////////////////
 // Import section
 // //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <utility>
 // OpenTrep
 #include <opentrep/OPENTREP_Types.hpp>
 #include <opentrep/Location.hpp>
 #include <opentrep/DBType.hpp>
 #include <opentrep/bom/PlaceList.hpp>
+#include <opentrep/command/SelectStatementCache.hpp>
 
 // Forward declarations
 namespace soci {
@@ -20,6 +27,7 @@ namespace OPENTREP {
 
   // Forward declarations
   struct PlaceKey;
+  class SerialisedPlaceBinding;
 
 
   /**
@@ -40,6 +48,8 @@ namespace OPENTREP {
    * </ol>
    */
   class DBManager {
+    friend class SelectStatementCache;
+    friend class ColumnarExporter;
   public:
     /**
      * Destroy and re-create the database.
@@ -116,6 +126,16 @@ namespace OPENTREP {
      */
     static void createSQLDBTables (soci::session&);
 
+    /**
+     * Retrieve the version of the schema of the SQL database (see
+     * K_SQL_DB_SCHEMA_VERSION). The databases created before the
+     * optd_por_schema table (which holds that version) are of version 1.
+     *
+     * @param soci::session& A reference on the SQL database session.
+     * @return SQLDBSchemaVersion_T Version of the schema.
+     */
+    static SQLDBSchemaVersion_T getSQLDBSchemaVersion (soci::session&);
+
     /**
      * Create the database indexes.
      *
@@ -146,48 +166,53 @@ namespace OPENTREP {
      * the city. If so required (by setting the corresponding parameter),
      * the entry having the greatest Page Rank will be returned.
      *
-     * @param const SQLDBConnectionString_T& Connection string to the SQL DB.
+     * @param SelectStatementCache& Prepared statements of the SQL database
+     *        session (see SelectStatementCache).
      * @param const IATACode_T& The IATA code (key) of the POR to be retrieved.
      * @param LocationList_T& List of (geographical) locations, if any,
      *                        matching the given key.
      * @param const bool States whether a unique entry should be returned.
      * @return NbOfDBEntries_T Number of documents of the SQL database.
      */
-    static NbOfDBEntries_T getPORByIATACode (soci::session&, const IATACode_T&,
-                                             LocationList_T&,
+    static NbOfDBEntries_T getPORByIATACode (SelectStatementCache&,
+                                             const IATACode_T&, LocationList_T&,
                                              const bool iUniqueEntry);
 
     /**
      * Get the POR (point of reference), from the SQL database, corresponding
      * to the given ICAO code.
      *
-     * @param const SQLDBConnectionString_T& Connection string to the SQL DB.
+     * @param SelectStatementCache& Prepared statements of the SQL database
+     *        session (see SelectStatementCache).
      * @param const ICAOCode_T& The ICAO code (key) of the POR to be retrieved.
      * @param LocationList_T& List of (geographical) locations, if any,
      *                        matching the given key.
      * @return NbOfDBEntries_T Number of documents of the SQL database.
      */
-    static NbOfDBEntries_T getPORByICAOCode (soci::session&, const ICAOCode_T&,
+    static NbOfDBEntries_T getPORByICAOCode (SelectStatementCache&,
+                                             const ICAOCode_T&,
                                              LocationList_T&);
 
     /**
      * Get the POR (point of reference), from the SQL database, corresponding
      * to the given FAA code.
      *
-     * @param const SQLDBConnectionString_T& Connection string to the SQL DB.
+     * @param SelectStatementCache& Prepared statements of the SQL database
+     *        session (see SelectStatementCache).
      * @param const FAACode_T& The FAA code (key) of the POR to be retrieved.
      * @param LocationList_T& List of (geographical) locations, if any,
      *                        matching the given key.
      * @return NbOfDBEntries_T Number of documents of the SQL database.
      */
-    static NbOfDBEntries_T getPORByFAACode (soci::session&, const FAACode_T&,
-                                            LocationList_T&);
+    static NbOfDBEntries_T getPORByFAACode (SelectStatementCache&,
+                                            const FAACode_T&, LocationList_T&);
 
     /**
      * Get the POR (point of reference), from the SQL database, corresponding
      * to the given UN/LOCODE code.
      *
-     * @param const SQLDBConnectionString_T& Connection string to the SQL DB.
+     * @param SelectStatementCache& Prepared statements of the SQL database
+     *        session (see SelectStatementCache).
      * @param const UNLOCode_T& The UN/LOCODE code (key) of the POR to be
                                 retrieved.
      * @param LocationList_T& List of (geographical) locations, if any,
@@ -195,37 +220,85 @@ namespace OPENTREP {
      * @param const bool States whether a unique entry should be returned.
      * @return NbOfDBEntries_T Number of documents of the SQL database.
      */
-    static NbOfDBEntries_T getPORByUNLOCode (soci::session&, const UNLOCode_T&,
-                                             LocationList_T&,
+    static NbOfDBEntries_T getPORByUNLOCode (SelectStatementCache&,
+                                             const UNLOCode_T&, LocationList_T&,
                                              const bool iUniqueEntry);
 
     /**
      * Get the POR (point of reference), from the SQL database, corresponding
      * to the given UIC code.
      *
-     * @param const SQLDBConnectionString_T& Connection string to the SQL DB.
+     * @param SelectStatementCache& Prepared statements of the SQL database
+     *        session (see SelectStatementCache).
      * @param const UICCode_T& The UIC code (key) of the POR to be retrieved.
      * @param LocationList_T& List of (geographical) locations, if any,
      *                        matching the given key.
      * @return NbOfDBEntries_T Number of documents of the SQL database.
      */
-    static NbOfDBEntries_T getPORByUICCode (soci::session&, const UICCode_T&,
-                                            LocationList_T&);
+    static NbOfDBEntries_T getPORByUICCode (SelectStatementCache&,
+                                            const UICCode_T&, LocationList_T&);
 
     /**
      * Get the POR (point of reference), from the SQL database, corresponding
      * to the given IATA code.
      *
-     * @param const SQLDBConnectionString_T& Connection string to the SQL DB.
+     * @param SelectStatementCache& Prepared statements of the SQL database
+     *        session (see SelectStatementCache).
      * @param const GeonamesID_T& The GeonameID (key) of the POR to be retrieved.
      * @param LocationList_T& List of (geographical) locations, if any,
      *                        matching the given key.
      * @return NbOfDBEntries_T Number of documents of the SQL database.
      */
-    static NbOfDBEntries_T getPORByGeonameID (soci::session&,
+    static NbOfDBEntries_T getPORByGeonameID (SelectStatementCache&,
                                               const GeonamesID_T&,
                                               LocationList_T&);
 
+    /**
+     * Code (e.g., "NCE", "LFMN", "FRNCE", "6299418"), along with its kind.
+     */
+    typedef std::pair<SelectStatementCache::EN_LookupKind,
+                      std::string> TypedCode_T;
+    typedef std::list<TypedCode_T> TypedCodeList_T;
+
+    /**
+     * Get the POR (points of reference), from the SQL database, corresponding
+     * to the given list of codes.
+     *
+     * Rather than one SQL query per code, the codes are grouped by kind,
+     * and a single query (e.g., "where iata_code in (...)") is performed
+     * for every kind. The retrieved locations are then added to the list
+     * in the order of the given codes. As with getPORByIATACode() and
+     * getPORByUNLOCode(), only the entry having the greatest Page Rank
+     * is kept for a given IATA or UN/LOCODE code.
+     *
+     * @param SelectStatementCache& Prepared statements of the SQL database
+     *        session (see SelectStatementCache).
+     * @param const TypedCodeList_T& List of IATA/ICAO/UNLOCODE codes and
+     *        Geonames ID (the kinds of the other codes are not supported).
+     * @param LocationList_T& List of (geographical) locations, if any,
+     *                        matching the given codes.
+     * @return NbOfDBEntries_T Number of retrieved locations.
+     */
+    static NbOfDBEntries_T getPORByCodeList (SelectStatementCache&,
+                                             const TypedCodeList_T&,
+                                             LocationList_T&);
+
+    /**
+     * Get the location having the greatest Page Rank among the given ones.
+     *
+     * Some POR may have a zero Page Rank value (e.g., when OPTD is buggy).
+     * When so specified, such a POR may still be kept, as with
+     * getPORByIATACode(); otherwise, as with getPORByUNLOCode(), only
+     * a POR having a non-zero Page Rank value may be kept.
+     *
+     * @param const LocationList_T& List of (geographical) locations.
+     * @param const bool Whether a POR having a zero Page Rank may be kept.
+     * @return const Location* The location having the greatest Page Rank,
+     *         if any (NULL otherwise).
+     */
+    static const Location* getHighestPRLocation (const LocationList_T&,
+                                                 const bool iKeepZeroPR);
+
     /**
      * Insert into the SQL database the document
      * corresponding to the given Place object.
@@ -244,18 +317,60 @@ namespace OPENTREP {
      */
     static void updatePlaceInDB (soci::session&, const Place&);
 
-    
-  public:
     /**
-     * Prepare (parse and put in cache) the SQL statement.
+     * Insert into the SQL database the document corresponding to the given
+     * Place object, replacing the former version of that document (same
+     * primary key and envelope ID), if any.
+     *
+     * Contrary to insertPlaceInDB(), no transaction is begun: the caller
+     * is expected to manage it (e.g., when updating the SQL database
+     * incrementally, see IndexUpdater).
      *
      * @param soci::session& SOCI session handler.
-     * @param soci::statement& SOCI SQL statement handler.
-     * @return std::string The serialised place to be retrieved.
+     * @param const Place& The place to be inserted or replaced.
+     */
+    static void upsertPlaceInDB (soci::session&, const Place&);
+
+    /**
+     * Delete from the SQL database the document corresponding to the given
+     * primary key and envelope ID, if any.
+     *
+     * As for upsertPlaceInDB(), no transaction is begun.
+     *
+     * @param soci::session& SOCI session handler.
+     * @param const std::string& Primary key (see LocationKey::toString()).
+     * @param const EnvelopeID_T& Envelope ID.
+     */
+    static void deletePlaceFromDB (soci::session&, const std::string&,
+                                   const EnvelopeID_T&);
+
+    /**
+     * Retrieve the hashes of the content of all the documents of the
+     * SQL database, indexed by the unique IDs of those documents
+     * (see Place::describeUniqueID()).
+     *
+     * @param soci::session& SOCI session handler.
+     * @param ContentHashMap_T& Map of the content hashes, to be filled.
+     * @return NbOfDBEntries_T Number of documents of the SQL database.
+     */
+    static NbOfDBEntries_T getContentHashes (soci::session&,
+                                             ContentHashMap_T&);
+
+    /**
+     * Calculate the hash of the content of the given POR, as stored within
+     * the SQL database (see getContentHashes()), i.e., the hash of its
+     * Protobuf record from the version 2 of the schema onwards, and of its
+     * raw data string before.
+     *
+     * @param const SQLDBSchemaVersion_T& Version of the schema.
+     * @param const Place& The POR.
+     * @return ContentHash_T The hash of the content of the POR.
      */
-    static std::string prepareSelectAllBlobStatement (soci::session&,
-                                                      soci::statement&);
+    static ContentHash_T
+    calculatePlaceContentHash (const SQLDBSchemaVersion_T&, const Place&);
 
+    
+  public:
     /**
      * Prepare (parse and put in cache) the SQL statement.
      *
@@ -281,6 +396,20 @@ namespace OPENTREP {
      */
     static bool iterateOnStatement (soci::statement&, const std::string&);
 
+    /**
+     * Iterate on the SQL statement, retrieving the serialised place
+     * of every fetched row.
+     *
+     * The SQL has to be already prepared.
+     *
+     * @param soci::statement& SOCI SQL statement handler.
+     * @param SerialisedPlaceBinding& The serialised place, bound to the
+     *        statement.
+     * @return bool Whether or not there are more rows to be fetched.
+     */
+    static bool iterateOnStatement (soci::statement&,
+                                    SerialisedPlaceBinding&);
+
     
   private:
     /**
@@ -289,73 +418,138 @@ namespace OPENTREP {
      * @param soci::session& SOCI session handler.
      * @param soci::statement& SOCI SQL statement handler.
      * @param const std::string& The IATA code of the place to be retrieved.
-     * @param std::string& The serialised place to be retrieved.
+     * @param SerialisedPlaceBinding& The serialised place to be retrieved,
+     *        which also gives its column.
      */
     static void
     prepareSelectBlobOnIataCodeStatement (soci::session&, soci::statement&,
                                           const std::string& iIataCode,
-                                          std::string& ioSerialisedPlaceStr);
+                                          SerialisedPlaceBinding&);
     /**
      * Prepare (parse and put in cache) the SQL statement.
      *
      * @param soci::session& SOCI session handler.
      * @param soci::statement& SOCI SQL statement handler.
      * @param const std::string& The ICAO code of the place to be retrieved.
-     * @param std::string& The serialised place to be retrieved.
+     * @param SerialisedPlaceBinding& The serialised place to be retrieved,
+     *        which also gives its column.
      */
     static void
     prepareSelectBlobOnIcaoCodeStatement (soci::session&, soci::statement&,
                                           const std::string& iIcaoCode,
-                                          std::string& ioSerialisedPlaceStr);
+                                          SerialisedPlaceBinding&);
     /**
      * Prepare (parse and put in cache) the SQL statement.
      *
      * @param soci::session& SOCI session handler.
      * @param soci::statement& SOCI SQL statement handler.
      * @param const std::string& The FAA code of the place to be retrieved.
-     * @param std::string& The serialised place to be retrieved.
+     * @param SerialisedPlaceBinding& The serialised place to be retrieved,
+     *        which also gives its column.
      */
     static void
     prepareSelectBlobOnFaaCodeStatement (soci::session&, soci::statement&,
                                          const std::string& iFaaCode,
-                                         std::string& ioSerialisedPlaceStr);
+                                         SerialisedPlaceBinding&);
     /**
      * Prepare (parse and put in cache) the SQL statement.
      *
      * @param soci::session& SOCI session handler.
      * @param soci::statement& SOCI SQL statement handler.
      * @param const std::string& The UN/LOCODE code of the place to be retrieved.
-     * @param std::string& The serialised place to be retrieved.
+     * @param SerialisedPlaceBinding& The serialised place to be retrieved,
+     *        which also gives its column.
      */
     static void
     prepareSelectBlobOnUNLOCodeStatement (soci::session&, soci::statement&,
                                           const std::string& iUNLOCode,
-                                          std::string& ioSerialisedPlaceStr);
+                                          SerialisedPlaceBinding&);
     /**
      * Prepare (parse and put in cache) the SQL statement.
      *
      * @param soci::session& SOCI session handler.
      * @param soci::statement& SOCI SQL statement handler.
      * @param const UICCode_T& The UIC code of the place to be retrieved.
-     * @param std::string& The serialised place to be retrieved.
+     * @param SerialisedPlaceBinding& The serialised place to be retrieved,
+     *        which also gives its column.
      */
     static void
     prepareSelectBlobOnUICCodeStatement (soci::session&, soci::statement&,
                                          const UICCode_T&,
-                                         std::string& ioSerialisedPlaceStr);
+                                         SerialisedPlaceBinding&);
     /**
      * Prepare (parse and put in cache) the SQL statement.
      *
      * @param soci::session& SOCI session handler.
      * @param soci::statement& SOCI SQL statement handler.
      * @param const GeonamesID_T& The Geoname ID of the place to be retrieved.
-     * @param std::string& The serialised place to be retrieved.
+     * @param SerialisedPlaceBinding& The serialised place to be retrieved,
+     *        which also gives its column.
      */
     static void
     prepareSelectBlobOnPlaceGeoIDStatement (soci::session&, soci::statement&,
                                             const GeonamesID_T&,
-                                            std::string& ioSerialisedPlaceStr);
+                                            SerialisedPlaceBinding&);
 
+    /**
+     * Prepare (parse and put in cache) the SQL statement retrieving
+     * all the serialised places.
+     *
+     * @param soci::session& SOCI session handler.
+     * @param soci::statement& SOCI SQL statement handler.
+     * @param SerialisedPlaceBinding& The serialised place to be retrieved,
+     *        which also gives its column.
+     */
+    static void
+    prepareSelectAllSerialisedPlaceStatement (soci::session&, soci::statement&,
+                                              SerialisedPlaceBinding&);
+
+    /**
+     * Serialised places, stored by code (in the order of the rows).
+     */
+    typedef std::multimap<std::string, std::string> SerialisedPlaceMap_T;
+
+    /**
+     * Retrieve, within a single SQL query, the serialised places
+     * corresponding to the given codes, all of the same kind.
+     *
+     * @param soci::session& SOCI session handler.
+     * @param const SQLDBSchemaVersion_T& Version of the schema.
+     * @param const SelectStatementCache::EN_LookupKind& Kind of the codes.
+     * @param const std::vector<std::string>& The codes (uppercase, or
+     *        decimal representation of the Geonames IDs).
+     * @param SerialisedPlaceMap_T& The retrieved serialised places, stored
+     *        by code.
+     */
+    static void
+    selectBlobOnCodeList (soci::session&, const SQLDBSchemaVersion_T&,
+                          const SelectStatementCache::EN_LookupKind&,
+                          const std::vector<std::string>&,
+                          SerialisedPlaceMap_T&);
+
+    /**
+     * Create the Location structure corresponding to the serialised place
+     * retrieved from the SQL database, i.e., either decode the Protobuf
+     * record (version 2 of the schema onwards), or parse the raw data
+     * string (version 1).
+     *
+     * @param const SQLDBSchemaVersion_T& Version of the schema.
+     * @param const std::string& The serialised place.
+     * @return Location The corresponding Location structure.
+     */
+    static Location retrieveLocation (const SQLDBSchemaVersion_T&,
+                                      const std::string&);
+
+
+  private:
+    /**
+     * Insert into the SQL database the document corresponding to the
+     * given Place object, without managing any transaction.
+     *
+     * @param soci::session& SOCI session handler.
+     * @param const Place& The place to be inserted.
+     */
+    static void insertPlaceRowInDB (soci::session&, const Place&);
 
   private:
     /**
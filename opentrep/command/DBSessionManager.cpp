@@ -5,71 +5,320 @@
 #include <cassert>
 #include <string>
 #include <sstream>
+// Boost
+#include <boost/thread/mutex.hpp>
 // SOCI
 #include <soci/soci.h>
+#include <soci/version.h>
 #include <soci/sqlite3/soci-sqlite3.h>
 // OpenTrep
-#include <opentrep/DBParams.hpp>
+#include <opentrep/Location.hpp>
+#include <opentrep/CityDetails.hpp>
+#include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
+#include <opentrep/command/DBManager.hpp>
 #include <opentrep/command/DBSessionManager.hpp>
 #include <opentrep/service/Logger.hpp>
 
 namespace OPENTREP {
 
+  /**
+   * Number of the in-memory databases created so far by the process,
+   * and mutex protecting it. The names of the in-memory databases are
+   * shared by the whole process, and must therefore be unique.
+   */
+  static unsigned int _memoryDBCounter = 0;
+  static boost::mutex _memoryDBCounterMutex;
+
   // //////////////////////////////////////////////////////////////////////
-  DBSessionManager::DBSessionManager() : _dbSession (NULL) {
+  /**
+   * Build a name for a new in-memory database. Since SQLite 3.36, the
+   * "memdb" VFS shares the in-memory databases, the name of which starts
+   * with a slash, among all the connections of the process.
+   */
+  static std::string buildMemoryDBName() {
+    unsigned int lMemoryDBNumber = 0;
+    {
+      boost::mutex::scoped_lock lLock (_memoryDBCounterMutex);
+      lMemoryDBNumber = ++_memoryDBCounter;
+    }
+
+    std::ostringstream oStr;
+    oStr << "/opentrep-memdb-" << lMemoryDBNumber;
+    return oStr.str();
   }
 
   // //////////////////////////////////////////////////////////////////////
-  DBSessionManager::DBSessionManager (const DBParams& iDBParams)
-    : _dbSession (NULL) {
-    init (iDBParams);
+  /**
+   * Build the SOCI connection string opening the given SQLite database
+   * with the given SOCI options (e.g., 'db="/tmp/opentrep/sqlite_travel.db0"
+   * readonly=true'). The database name is quoted, so that it may contain
+   * spaces.
+   */
+  static std::string
+  buildSociConnectionString (const std::string& iDBName,
+                             const std::string& iSociOptions) {
+    std::ostringstream oStr;
+    oStr << "db=\"" << iDBName << "\"";
+    if (iSociOptions.empty() == false) {
+      oStr << " " << iSociOptions;
+    }
+    return oStr.str();
   }
 
   // //////////////////////////////////////////////////////////////////////
-  DBSessionManager::~DBSessionManager() {
-    // Properly close the (SOCI) database session, only when one has been created
-    if (_dbSession != NULL) {
-      _dbSession->close();
-    }
-    // Reset the underlying (SOCI) database connection
-    delete _dbSession; _dbSession = NULL;
+  DBSessionManager::DBSessionManager()
+    : _sqlDBType (DBType::NODB), _sqlDBConnectionString (""),
+      _sqlDBLoadMode (SQLDBLoadMode::ON_DISK), _memoryDB_ptr (NULL) {
+    assert (false);
   }
 
   // //////////////////////////////////////////////////////////////////////
-  soci::session& DBSessionManager::getDBSessionRef() const {
-    assert (_dbSession != NULL);
-    return *_dbSession;
+  DBSessionManager::DBSessionManager (const DBSessionManager& iManager)
+    : _sqlDBType (iManager._sqlDBType),
+      _sqlDBConnectionString (iManager._sqlDBConnectionString),
+      _sqlDBLoadMode (iManager._sqlDBLoadMode), _memoryDB_ptr (NULL) {
+    assert (false);
   }
 
   // //////////////////////////////////////////////////////////////////////
-  void DBSessionManager::init (const DBParams& iDBParams) {
-    
-    // Check that the parameters for the SQL database are not empty
-    if (iDBParams.checkSQLite() == false) {
+  DBSessionManager::
+  DBSessionManager (const DBType& iSQLDBType,
+                    const SQLDBConnectionString_T& iSQLDBConnStr,
+                    const SQLDBLoadMode& iSQLDBLoadMode)
+    : _sqlDBType (iSQLDBType), _sqlDBConnectionString (iSQLDBConnStr),
+      _sqlDBLoadMode (iSQLDBLoadMode), _memoryDB_ptr (NULL) {
+    if (!(_sqlDBType == DBType::SQLITE3)
+        || _sqlDBLoadMode == SQLDBLoadMode::ON_DISK) {
+      return;
+    }
+
+    // The VFS and read-only options of the SOCI connection string are
+    // available from SOCI 4.0 on, and the "memdb" VFS from SQLite 3.36 on
+    std::string lMissingDependency;
+#if SOCI_VERSION < 400000
+    lMissingDependency = "SOCI 4.0";
+#endif // SOCI_VERSION
+#if SQLITE_VERSION_NUMBER < 3036000
+    if (_sqlDBLoadMode == SQLDBLoadMode::IN_MEMORY) {
+      lMissingDependency += (lMissingDependency.empty() ? "" : " and ");
+      lMissingDependency += "SQLite 3.36";
+    }
+#endif // SQLITE_VERSION_NUMBER
+    if (lMissingDependency.empty() == false) {
       std::ostringstream errorStr;
-      errorStr << "At least one of the parameters for the SQL "
-               << "database is empty: " << iDBParams;
+      errorStr << "The '" << _sqlDBConnectionString << "' SQLite3 database "
+               << "cannot be opened with the '" << _sqlDBLoadMode.describe()
+               << "' mode, which needs " << lMissingDependency
+               << " or later";
       OPENTREP_LOG_ERROR (errorStr.str());
-      throw XapianTravelDatabaseEmptyException (errorStr.str());
+      throw SQLDatabaseImpossibleConnectionException (errorStr.str());
+    }
+
+    if (_sqlDBLoadMode == SQLDBLoadMode::IN_MEMORY) {
+      init();
     }
+  }
 
+  // //////////////////////////////////////////////////////////////////////
+  DBSessionManager::~DBSessionManager() {
+    // Close the master (SQLite) connection, only when one has been
+    // created. That releases the in-memory database.
+    if (_memoryDB_ptr != NULL) {
+      soci::sqlite_api::sqlite3_close (_memoryDB_ptr);
+      _memoryDB_ptr = NULL;
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string DBSessionManager::describe() const {
+    std::ostringstream oStr;
+    oStr << _sqlDBType.describe() << " database: '"
+         << _sqlDBConnectionString << "'";
+    if (_sqlDBType == DBType::SQLITE3
+        && !(_sqlDBLoadMode == SQLDBLoadMode::ON_DISK)) {
+      oStr << " (" << _sqlDBLoadMode.describe() << ")";
+    }
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  soci::session* DBSessionManager::
+  openSQLiteSession (const std::string& iSociConnectionString) const {
     // Instanciate a (SOCI) database session: nothing is performed at
     // that stage, else than creating a SOCI session object
-    _dbSession = new soci::session();
-    
+    soci::session* oSociSession_ptr = new soci::session();
+    assert (oSociSession_ptr != NULL);
+
     try {
+      oSociSession_ptr->open (soci::sqlite3, iSociConnectionString);
 
-      // Open the connection to the database
-      _dbSession->open (soci::sqlite3, iDBParams.toSQLiteConnectionString());
-      
     } catch (std::exception const& lException) {
+      delete oSociSession_ptr; oSociSession_ptr = NULL;
+
+      std::ostringstream errorStr;
+      errorStr << "Error when trying to open the '" << _sqlDBConnectionString
+               << "' SQLite3 database (" << iSociConnectionString << "): "
+               << lException.what();
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SQLDatabaseImpossibleConnectionException (errorStr.str());
+    }
+
+    assert (oSociSession_ptr != NULL);
+    return oSociSession_ptr;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void DBSessionManager::init() {
+    assert (_memoryDB_ptr == NULL);
+    _memoryDBName = buildMemoryDBName();
+
+    // Create the in-memory database, which lives as long as the master
+    // (native SQLite) connection is open. That connection is owned by
+    // the manager, and is not a SOCI session.
+    int lStatus =
+      soci::sqlite_api::sqlite3_open_v2 (_memoryDBName.c_str(), &_memoryDB_ptr,
+                                         (SQLITE_OPEN_READWRITE
+                                          | SQLITE_OPEN_CREATE), "memdb");
+    std::string lErrorMessage;
+    if (lStatus != SQLITE_OK) {
+      lErrorMessage = (_memoryDB_ptr != NULL
+                       ? soci::sqlite_api::sqlite3_errmsg (_memoryDB_ptr)
+                       : soci::sqlite_api::sqlite3_errstr (lStatus));
+    }
+
+    // Copy the whole database file, in a single step. While the file is
+    // busy or locked (e.g., by a writer), the step is attempted again,
+    // a bounded number of times
+    soci::sqlite_api::sqlite3* lFileDB_ptr = NULL;
+    if (lStatus == SQLITE_OK) {
+      lStatus =
+        soci::sqlite_api::sqlite3_open_v2 (_sqlDBConnectionString.c_str(),
+                                           &lFileDB_ptr, SQLITE_OPEN_READONLY,
+                                           NULL);
+      if (lStatus != SQLITE_OK) {
+        lErrorMessage = (lFileDB_ptr != NULL
+                         ? soci::sqlite_api::sqlite3_errmsg (lFileDB_ptr)
+                         : soci::sqlite_api::sqlite3_errstr (lStatus));
+      }
+    }
+
+    if (lStatus == SQLITE_OK) {
+      soci::sqlite_api::sqlite3_backup* lBackup_ptr =
+        soci::sqlite_api::sqlite3_backup_init (_memoryDB_ptr, "main",
+                                               lFileDB_ptr, "main");
+      if (lBackup_ptr != NULL) {
+        int lStepStatus = SQLITE_OK;
+        for (unsigned short idx = 0;
+             idx != DEFAULT_OPENTREP_SQLITE_BACKUP_MAX_ATTEMPTS; ++idx) {
+          lStepStatus = soci::sqlite_api::sqlite3_backup_step (lBackup_ptr,
+                                                                -1);
+          if (lStepStatus != SQLITE_BUSY && lStepStatus != SQLITE_LOCKED) {
+            break;
+          }
+          soci::sqlite_api::
+            sqlite3_sleep (DEFAULT_OPENTREP_SQLITE_BACKUP_RETRY_DELAY);
+        }
+
+        // The status of the copy is given by the last step, and then by
+        // the release of the backup object
+        const int lFinishStatus =
+          soci::sqlite_api::sqlite3_backup_finish (lBackup_ptr);
+        if (lStepStatus != SQLITE_DONE) {
+          lStatus = (lStepStatus == SQLITE_OK) ? SQLITE_ERROR : lStepStatus;
+          lErrorMessage = soci::sqlite_api::sqlite3_errstr (lStepStatus);
+          if (lStepStatus == SQLITE_BUSY || lStepStatus == SQLITE_LOCKED) {
+            lErrorMessage += " (still, after all the attempts)";
+          }
+
+        } else if (lFinishStatus != SQLITE_OK) {
+          lStatus = lFinishStatus;
+          lErrorMessage = soci::sqlite_api::sqlite3_errmsg (_memoryDB_ptr);
+        }
+
+      } else {
+        lStatus = soci::sqlite_api::sqlite3_errcode (_memoryDB_ptr);
+        if (lStatus == SQLITE_OK) {
+          lStatus = SQLITE_ERROR;
+        }
+        lErrorMessage = soci::sqlite_api::sqlite3_errmsg (_memoryDB_ptr);
+      }
+    }
+    soci::sqlite_api::sqlite3_close (lFileDB_ptr);
+
+    if (lStatus != SQLITE_OK) {
+      soci::sqlite_api::sqlite3_close (_memoryDB_ptr);
+      _memoryDB_ptr = NULL;
+
       std::ostringstream errorStr;
-      errorStr << "Error while opening a connection to database: "
-               << lException.what() << std::endl;
-      errorStr << "Database parameters used: " << iDBParams.toString();
+      errorStr << "Error when trying to copy the '" << _sqlDBConnectionString
+               << "' SQLite3 database in memory: " << lErrorMessage;
       OPENTREP_LOG_ERROR (errorStr.str());
       throw SQLDatabaseImpossibleConnectionException (errorStr.str());
     }
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("The '" << _sqlDBConnectionString
+                        << "' SQLite3 database has been copied in memory ('"
+                        << _memoryDBName << "')");
   }
-  
+
+  // //////////////////////////////////////////////////////////////////////
+  soci::session* DBSessionManager::openSession() const {
+    soci::session* oSociSession_ptr = NULL;
+
+    if (_sqlDBType == DBType::SQLITE3
+        && _sqlDBLoadMode == SQLDBLoadMode::IN_MEMORY) {
+      // Share the in-memory database of the master connection
+      assert (_memoryDB_ptr != NULL);
+      const std::string& lSociConnStr =
+        buildSociConnectionString (_memoryDBName, "vfs=memdb readonly=true");
+      oSociSession_ptr = openSQLiteSession (lSociConnStr);
+
+    } else if (_sqlDBType == DBType::SQLITE3
+               && _sqlDBLoadMode == SQLDBLoadMode::MMAP) {
+      // Open the database file as read-only, and map it in memory
+      const std::string& lSociConnStr =
+        buildSociConnectionString (_sqlDBConnectionString, "readonly=true");
+      oSociSession_ptr = openSQLiteSession (lSociConnStr);
+      assert (oSociSession_ptr != NULL);
+
+      long long lMMapSize = 0;
+      try {
+        *oSociSession_ptr << "PRAGMA mmap_size = "
+                          << DEFAULT_OPENTREP_SQLITE_MMAP_SIZE,
+          soci::into (lMMapSize);
+
+      } catch (std::exception const& lException) {
+        // The database remains readable, through the file-system
+        OPENTREP_LOG_ERROR ("The '" << _sqlDBConnectionString
+                            << "' SQLite3 database cannot be mapped in "
+                            << "memory: " << lException.what());
+      }
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("The '" << _sqlDBConnectionString
+                          << "' SQLite3 database has been opened as "
+                          << "read-only; up to " << lMMapSize
+                          << " bytes are mapped in memory");
+
+    } else {
+      oSociSession_ptr =
+        DBManager::initSQLDBSession (_sqlDBType, _sqlDBConnectionString);
+    }
+
+    return oSociSession_ptr;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void DBSessionManager::
+  closeSession (soci::session*& ioSociSession_ptr) const {
+    if (ioSociSession_ptr == NULL) {
+      return;
+    }
+
+    DBManager::terminateSQLDBSession (_sqlDBType, _sqlDBConnectionString,
+                                      *ioSociSession_ptr);
+    delete ioSociSession_ptr; ioSociSession_ptr = NULL;
+  }
+
 }
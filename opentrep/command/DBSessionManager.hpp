@@ -4,44 +4,127 @@
 // //////////////////////////////////////////////////////////////////////
 // Import section
 // //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/DBType.hpp>
+#include <opentrep/SQLDBLoadMode.hpp>
 
 // Forward declarations
 namespace soci {
   class session;
+  namespace sqlite_api {
+    struct sqlite3;
+  }
 }
 
 namespace OPENTREP {
-  
-  // Forward declarations
-  struct DBParams;
 
   /**
-   * @brief Class handling the SOCI session.
+   * @brief Class handling the SOCI sessions on the SQL database
+   *        of a given deployment.
+   *
+   * With a SQLite database, the sessions may be opened in several ways
+   * (see SQLDBLoadMode):
+   * <ul>
+   *   <li>ON_DISK: every session reads the database file, as with
+   *       DBManager::initSQLDBSession().</li>
+   *   <li>IN_MEMORY: the database file is copied, with the SQLite backup
+   *       API, into an in-memory database when the manager is constructed.
+   *       That in-memory database is named, within the "memdb" VFS of
+   *       SQLite, so that all the (read-only) sessions opened by the
+   *       manager share the same copy, rather than having a copy each.
+   *       It is kept alive by a master SQLite connection, closed by the
+   *       destructor of the manager.</li>
+   *   <li>MMAP: the sessions open the database file as read-only, and
+   *       map it in memory.</li>
+   * </ul>
+   *
+   * The sessions are opened by SOCI, the VFS and the read-only flag being
+   * given by the options of the SOCI connection string (available from
+   * SOCI 4.0 on). A MySQL/MariaDB database is always accessed as with
+   * DBManager::initSQLDBSession().
+   *
+   * The manager is owned by a SearchIndexHandle, so that the SQL database
+   * is loaded again every time the services hot-swap to the other
+   * deployment; the former copy is released with the former handle.
+   * Without hot-swap, it is owned by the SQLSessionPool of the services.
    */
   class DBSessionManager {
-    friend class OPENTREP_ServiceContext;
-  private:
+  public:
     // ////////////////// Getters ////////////////////
     /**
-     * Get the SOCI Session.
+     * Get the SQL database type.
+     */
+    const DBType& getSQLDBType() const {
+      return _sqlDBType;
+    }
+
+    /**
+     * Get the SQL database connection string.
      */
-    soci::session* getDBSession() const {
-      return _dbSession;
+    const SQLDBConnectionString_T& getSQLDBConnectionString() const {
+      return _sqlDBConnectionString;
     }
 
     /**
-     * Get the SOCI Session.
+     * Get the way of opening the SQLite database.
      */
-    soci::session& getDBSessionRef() const;
+    const SQLDBLoadMode& getSQLDBLoadMode() const {
+      return _sqlDBLoadMode;
+    }
 
 
-  private:
+  public:
+    // ////////////////// Business methods ////////////////////
+    /**
+     * Open a new session on the SQL database. The session may be used by
+     * a single thread at once.
+     *
+     * An exception is thrown when the SQL database cannot be opened.
+     *
+     * @return soci::session* The new session (NULL when there is
+     *         no SQL database), to be closed with closeSession().
+     */
+    soci::session* openSession() const;
+
+    /**
+     * Close the given session, and release it.
+     *
+     * @param soci::session*& Session (set to NULL).
+     */
+    void closeSession (soci::session*&) const;
+
+    /**
+     * Get a string describing the manager.
+     */
+    std::string describe() const;
+
+
+  public:
     // ////////////////// Constructors and Destructors ////////////////////
     /**
-     * Main constructor.
+     * Main constructor. With the IN_MEMORY mode, the SQLite database is
+     * copied in memory at that stage.
+     *
+     * An exception is thrown when the load mode is not supported by
+     * the versions of SOCI and SQLite, or when the copy fails.
+     *
+     * @param const DBType& SQL database type (can be no database at all).
+     * @param const SQLDBConnectionString_T& SQL DB connection string.
+     * @param const SQLDBLoadMode& Way of opening the SQLite database.
      */
-    DBSessionManager (const DBParams&);
+    DBSessionManager (const DBType&, const SQLDBConnectionString_T&,
+                      const SQLDBLoadMode&);
 
+    /**
+     * Destructor. The sessions opened by the manager must have been
+     * closed before.
+     */
+    ~DBSessionManager();
+
+  private:
     /**
      * Default constructor.
      */
@@ -52,24 +135,49 @@ namespace OPENTREP {
      */
     DBSessionManager (const DBSessionManager&);
 
+  private:
     /**
-     * Destructor.
+     * Copy the SQLite database file into the in-memory database,
+     * held by the master connection.
      */
-    ~DBSessionManager();
+    void init();
 
-  private:
     /**
-     * Initialise (SQLite3) database connection.
+     * Open a SOCI session on a SQLite database, with the given SOCI
+     * connection string (e.g., 'db="/opentrep-memdb-1" vfs=memdb
+     * readonly=true').
      */
-    void init (const DBParams&);
+    soci::session*
+    openSQLiteSession (const std::string& iSociConnectionString) const;
 
 
   private:
     // /////////////////////// Attributes //////////////////////
     /**
-     * Database session.
+     * Type of the SQL database.
+     */
+    const DBType _sqlDBType;
+
+    /**
+     * Connection string for the SQL database.
+     */
+    const SQLDBConnectionString_T _sqlDBConnectionString;
+
+    /**
+     * Way of opening the SQLite database.
+     */
+    const SQLDBLoadMode _sqlDBLoadMode;
+
+    /**
+     * Name of the in-memory database (IN_MEMORY mode only).
+     */
+    std::string _memoryDBName;
+
+    /**
+     * Master (native SQLite) connection, holding the in-memory database
+     * (NULL but with the IN_MEMORY mode).
      */
-    soci::session* _dbSession;
+    soci::sqlite_api::sqlite3* _memoryDB_ptr;
   };
 
 }
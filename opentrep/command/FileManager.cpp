@@ -4,9 +4,12 @@
 // STL
 #include <cassert>
 #include <sstream>
+#include <fstream>
 // Boost
 #include <boost/filesystem.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 // OpenTrep
+#include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
 #include <opentrep/command/FileManager.hpp>
 #include <opentrep/service/Logger.hpp>
 
@@ -72,6 +75,59 @@ namespace OPENTREP {
       throw FileNotFoundException (oStr.str());
     }
   }
+
+  // //////////////////////////////////////////////////////////////////////
+  void FileManager::
+  writeReadyMarker (const TravelDBFilePath_T& iTravelDBFilePath) {
+    boost::filesystem::path lMarkerFilePath (iTravelDBFilePath.begin(),
+                                             iTravelDBFilePath.end());
+    lMarkerFilePath /= DEFAULT_OPENTREP_READY_MARKER_FILENAME;
+
+    // Current date-time, e.g., 20181027T184502.123456
+    const boost::posix_time::ptime lNowDateTime =
+      boost::posix_time::microsec_clock::universal_time();
+    const std::string& lNowStr =
+      boost::posix_time::to_iso_string (lNowDateTime);
+
+    // Write the marker into a temporary file, and then rename it, so that
+    // the readers never see a partially written marker
+    boost::filesystem::path lTmpFilePath (lMarkerFilePath);
+    lTmpFilePath += ".tmp";
+    {
+      std::ofstream lMarkerFile (lTmpFilePath.string().c_str());
+      lMarkerFile << lNowStr << std::endl;
+      if (lMarkerFile.good() == false) {
+        std::ostringstream oStr;
+        oStr << "The ready marker ('" << lMarkerFilePath
+             << "') cannot be written; check file-system permissions "
+             << "and whether the file-system is writable";
+        OPENTREP_LOG_ERROR (oStr.str());
+        throw FileNotFoundException (oStr.str());
+      }
+    }
+    boost::filesystem::rename (lTmpFilePath, lMarkerFilePath);
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("The Xapian database ('" << iTravelDBFilePath
+                        << "') is ready since " << lNowStr);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string FileManager::
+  readReadyMarker (const TravelDBFilePath_T& iTravelDBFilePath) {
+    std::string oReadyStamp;
+
+    boost::filesystem::path lMarkerFilePath (iTravelDBFilePath.begin(),
+                                             iTravelDBFilePath.end());
+    lMarkerFilePath /= DEFAULT_OPENTREP_READY_MARKER_FILENAME;
+
+    std::ifstream lMarkerFile (lMarkerFilePath.string().c_str());
+    if (lMarkerFile.is_open() == true) {
+      std::getline (lMarkerFile, oReadyStamp);
+    }
+
+    return oReadyStamp;
+  }
   
 }
 
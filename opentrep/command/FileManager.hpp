@@ -30,6 +30,25 @@ namespace OPENTREP {
      * Delete and re-create the directory hosting the Xapian index (aka database)
      */
     static void recreateXapianDirectory (const std::string& iTravelDBFilePath);
+
+    /**
+     * Write, within the directory hosting the Xapian index, the marker
+     * stating that the index (and the corresponding SQL database) is ready
+     * to be used. The marker holds the current (UTC) date-time.
+     *
+     * @param const TravelDBFilePath_T& File-path of the Xapian database.
+     */
+    static void writeReadyMarker (const TravelDBFilePath_T&);
+
+    /**
+     * Read the marker stating that the Xapian index is ready to be used.
+     *
+     * @param const TravelDBFilePath_T& File-path of the Xapian database.
+     * @return std::string The date-time held by the marker (in the ISO
+     *         format, so that the date-times can be compared as strings),
+     *         or an empty string when there is no such marker.
+     */
+    static std::string readReadyMarker (const TravelDBFilePath_T&);
     
   private:
     /**
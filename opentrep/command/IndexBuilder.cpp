@@ -5,8 +5,12 @@
 #include <cassert>
 #include <string>
 #include <vector>
+#include <sstream>
 #include <exception>
 // Boost
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/tokenizer.hpp>
@@ -19,6 +23,7 @@
 // Xapian
 #include <xapian.h>
 // OpenTrep
+#include <opentrep/basic/BasConst_General.hpp>
 #include <opentrep/basic/OTransliterator.hpp>
 #include <opentrep/basic/Utilities.hpp>
 #include <opentrep/bom/StringPartition.hpp>
@@ -32,6 +37,7 @@
 #include <opentrep/command/FileManager.hpp>
 #include <opentrep/command/DBManager.hpp>
 #include <opentrep/command/IndexBuilder.hpp>
+#include <opentrep/command/IndexingPipeline.hpp>
 #include <opentrep/service/Logger.hpp>
 
 namespace OPENTREP {
@@ -87,28 +93,48 @@ namespace OPENTREP {
   }
 
   // //////////////////////////////////////////////////////////////////////
-  void IndexBuilder::addDocumentToIndex(Xapian::WritableDatabase& ioDatabase,
-                                        Place& ioPlace,
-                                        const OTransliterator& iTransliterator) {
-
-    // Create an empty Xapian document
-    Xapian::Document lDocument;
-    
+  void IndexBuilder::buildDocument (Xapian::WritableDatabase& ioDatabase,
+                                    const Place& iPlace,
+                                    Xapian::Document& ioDocument) {
     // Retrieve the raw data string, to be stored as is within
     // the Xapian document
-    const RawDataString_T& lRawDataString = ioPlace.getRawDataString();
+    const RawDataString_T& lRawDataString = iPlace.getRawDataString();
 
     // The Xapian document data is indeed the same as the one of the
     // OPTD-maintained list of POR (points of reference), allowing the search
     // process to use exactly the same parser as the indexation process
-    lDocument.set_data (lRawDataString);
-      
-    // Build the (STL) sets of terms to be added to the Xapian index and
-    // spelling dictionary
-    ioPlace.buildIndexSets (iTransliterator);
+    ioDocument.set_data (lRawDataString);
+
+    // Store the geographical coordinates and the country code as Xapian
+    // values, so that the search process may weigh the matching documents
+    // (e.g., according to their distance to a given origin) without having
+    // to parse the document data
+    ioDocument.add_value (K_XAPIAN_VALUE_SLOT_LATITUDE,
+                         Xapian::sortable_serialise (iPlace.getLatitude()));
+    ioDocument.add_value (K_XAPIAN_VALUE_SLOT_LONGITUDE,
+                         Xapian::sortable_serialise (iPlace.getLongitude()));
+    ioDocument.add_value (K_XAPIAN_VALUE_SLOT_COUNTRY_CODE,
+                         iPlace.getCountryCode());
+
+    // Identify the POR record by a unique (boolean) term, and keep track
+    // of its content, so that the index may be updated incrementally
+    // (see IndexUpdater)
+    const std::string& lUniqueID = iPlace.describeUniqueID();
+    ioDocument.add_boolean_term (K_XAPIAN_UNIQUE_ID_TERM_PREFIX + lUniqueID);
+    ioDocument.add_value (K_XAPIAN_VALUE_SLOT_CONTENT_HASH,
+                         calculateContentHash (lRawDataString));
 
     // Add the (STL) sets of terms to the Xapian index and spelling dictionary
-    addToXapian (ioPlace, lDocument, ioDatabase);
+    addToXapian (iPlace, ioDocument, ioDatabase);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexBuilder::addDocumentToIndex(Xapian::WritableDatabase& ioDatabase,
+                                        Place& ioPlace) {
+
+    // Create the Xapian document
+    Xapian::Document lDocument;
+    buildDocument (ioDatabase, ioPlace, lDocument);
 
     // Add the document to the database
     const Xapian::docid& lDocID = ioDatabase.add_document (lDocument);
@@ -118,105 +144,256 @@ namespace OPENTREP {
     ioPlace.setDocID (lDocID);
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  void IndexBuilder::
+  replaceDocumentInIndex (Xapian::WritableDatabase& ioDatabase,
+                          Place& ioPlace) {
+
+    // Create the Xapian document
+    Xapian::Document lDocument;
+    buildDocument (ioDatabase, ioPlace, lDocument);
+
+    // Replace the document having the same unique ID, if any, or add it
+    // to the database otherwise
+    const std::string& lUniqueIDTerm =
+      K_XAPIAN_UNIQUE_ID_TERM_PREFIX + ioPlace.describeUniqueID();
+    const Xapian::docid& lDocID =
+      ioDatabase.replace_document (lUniqueIDTerm, lDocument);
+
+    // Assign back the Xapian document ID to the Place object
+    ioPlace.setDocID (lDocID);
+  }
+
   // //////////////////////////////////////////////////////////////////////
   NbOfDBEntries_T IndexBuilder::
   buildSearchIndex (Xapian::WritableDatabase* ioXapianDB_ptr,
                     const DBType& iSQLDBType, soci::session* ioSociSessionPtr,
                     std::istream& iPORFileStream,
                     const shouldIndexNonIATAPOR_T& iIncludeNonIATAPOR,
-                    const OTransliterator& iTransliterator) {
-    NbOfDBEntries_T oNbOfEntries = 0;
-    NbOfDBEntries_T oNbOfEntriesInPORFile = 0;
-
-    // Open the file to be parsed
-    Place& lPlace = FacPlace::instance().create();
-    std::string itReadLine;
-    while (std::getline (iPORFileStream, itReadLine)) {
-
-      /* First, if only the IATA-refernced POR must be indexed
-       * (ie, when iIncludeNonIATAPOR is set to false), the line
-       * must start with a non empty IATA code of three letters;
-       * in other words, the separator (the hat symbol) is first seen
-       * at position 3 (remember that strings in C++ start at position 0).
-       * Otherwise, the line is skipped.
-       */
-      if (!iIncludeNonIATAPOR) {
-        const unsigned short lFirstSeparatorPos = itReadLine.find_first_of ("^");
-        if (lFirstSeparatorPos != 3) {
-          // DEBUG
-          /*
-            OPENTREP_LOG_ERROR ("[" << oNbOfEntries << "] pos of sep: "
-                                << lFirstSeparatorPos << ", full line: "
-                                << itReadLine);
-          */
-
-          //
-          ++oNbOfEntriesInPORFile;
-
-          //
-          continue;
-        }
+                    const OTransliterator& iTransliterator,
+                    const PORParserType& iPORParserType,
+                    const NbOfThreads_T& iNbOfThreads) {
+    // Browse the input POR (point of reference) data file: the lines are
+    // parsed, and the sets of terms built, by several threads, while the
+    // Xapian documents are added (and the SQL rows inserted) by a single
+    // one, in the order of the file
+    IndexingPipeline lIndexingPipeline (ioXapianDB_ptr, ioSociSessionPtr,
+                                        iIncludeNonIATAPOR, iTransliterator,
+                                        iPORParserType, iNbOfThreads,
+                                        K_DEFAULT_INDEXING_QUEUE_SIZE);
+    const NbOfDBEntries_T oNbOfEntries =
+      lIndexingPipeline.run (iPORFileStream);
+
+    return oNbOfEntries;
+  }
+
+  /**
+   * Run the given indexing pipeline, keeping the exception (if any), so
+   * that it may be re-thrown by the thread having launched the pipeline.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void runIndexingPipeline (IndexingPipeline& ioIndexingPipeline,
+                            std::istream& ioPORStream,
+                            NbOfDBEntries_T& oNbOfEntries,
+                            std::exception_ptr& oException) {
+    try {
+      oNbOfEntries = ioIndexingPipeline.run (ioPORStream);
+
+    } catch (...) {
+      oException = std::current_exception();
+    }
+  }
+
+  /**
+   * Split the given content into the given number of chunks of whole lines,
+   * of (roughly) the same size, keeping the order of the lines.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  std::vector<std::string> splitIntoChunks (const std::string& iContent,
+                                            const NbOfShards_T& iNbOfChunks) {
+    std::vector<std::string> oChunkList;
+    assert (iNbOfChunks != 0);
+    const size_t lContentSize = iContent.size();
+
+    size_t lChunkBegin = 0;
+    for (NbOfShards_T idx = 0; idx != iNbOfChunks; ++idx) {
+      // Every chunk goes up to the end of the line reached by its nominal
+      // end, i.e., its share of the content
+      const size_t lNominalEnd = (lContentSize * (idx + 1)) / iNbOfChunks;
+      size_t lChunkEnd = lContentSize;
+      if (lNominalEnd > lChunkBegin && lNominalEnd < lContentSize) {
+        lChunkEnd = iContent.find ('\n', lNominalEnd - 1);
+        lChunkEnd = (lChunkEnd == std::string::npos) ?
+          lContentSize : lChunkEnd + 1;
+
+      } else if (lNominalEnd <= lChunkBegin) {
+        lChunkEnd = lChunkBegin;
       }
-      
-      // Initialise the parser
-      PORStringParser lStringParser (itReadLine);
 
-      // Parse the string
-      const Location& lLocation = lStringParser.generateLocation();
+      oChunkList.push_back (iContent.substr (lChunkBegin,
+                                             lChunkEnd - lChunkBegin));
+      lChunkBegin = lChunkEnd;
+    }
+
+    return oChunkList;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T IndexBuilder::
+  buildShardedSearchIndex (const TravelDBFilePath_T& iTravelIndexFilePath,
+                           soci::session* ioSociSessionPtr,
+                           std::istream& iPORFileStream,
+                           const shouldIndexNonIATAPOR_T& iIncludeNonIATAPOR,
+                           const OTransliterator& iTransliterator,
+                           const PORParserType& iPORParserType,
+                           const NbOfThreads_T& iNbOfThreads,
+                           const NbOfShards_T& iNbOfShards,
+                           const shouldMergeIndexShards_T& iShouldMergeShards) {
+    NbOfDBEntries_T oNbOfEntries = 0;
+    assert (iNbOfShards > 1);
+
+    // Read the whole POR data file, and split it into contiguous chunks,
+    // one per shard
+    std::ostringstream lPORFileContent;
+    lPORFileContent << iPORFileStream.rdbuf();
+    const std::vector<std::string>& lChunkList =
+      splitIntoChunks (lPORFileContent.str(), iNbOfShards);
+
+    // Spread the worker threads across the shards
+    NbOfThreads_T lNbOfThreads = iNbOfThreads;
+    if (lNbOfThreads == 0) {
+      lNbOfThreads = boost::thread::hardware_concurrency();
+    }
+    NbOfThreads_T lNbOfThreadsPerShard = lNbOfThreads / iNbOfShards;
+    if (lNbOfThreadsPerShard == 0) {
+      lNbOfThreadsPerShard = 1;
+    }
+
+    // The shards are built within a temporary directory when they have to
+    // be merged, and within the Xapian database directory otherwise
+    const boost::filesystem::path lTravelIndexPath (iTravelIndexFilePath);
+    boost::filesystem::path lShardsPath (lTravelIndexPath);
+    if (iShouldMergeShards == true) {
+      lShardsPath = iTravelIndexFilePath + K_XAPIAN_SHARDS_DIR_SUFFIX;
+      FileManager::recreateXapianDirectory (lShardsPath.string());
+    }
+
+    // Create the shards, along with their indexing pipelines
+    std::vector<std::string> lShardNameList;
+    std::vector<Xapian::WritableDatabase*> lShardDBList;
+    boost::ptr_vector<std::istringstream> lStreamList;
+    boost::ptr_vector<IndexingPipeline> lPipelineList;
+    for (NbOfShards_T idx = 0; idx != iNbOfShards; ++idx) {
+      std::ostringstream lShardName;
+      lShardName << K_XAPIAN_SHARD_DIRNAME_PREFIX << idx;
+      lShardNameList.push_back (lShardName.str());
+
+      const TravelDBFilePath_T lShardFilePath ((lShardsPath
+                                                / lShardName.str()).string());
+      Xapian::WritableDatabase* lShardDB_ptr =
+        FacXapianDB::instance().create (lShardFilePath, Xapian::DB_CREATE);
+      assert (lShardDB_ptr != NULL);
+      lShardDB_ptr->begin_transaction();
+      lShardDBList.push_back (lShardDB_ptr);
+
+      std::ostringstream lPipelineName;
+      lPipelineName << "[" << lShardName.str() << "] ";
+      lStreamList.push_back (new std::istringstream (lChunkList[idx]));
+      lPipelineList.push_back (new IndexingPipeline (lShardDB_ptr, NULL,
+                                                     iIncludeNonIATAPOR,
+                                                     iTransliterator,
+                                                     iPORParserType,
+                                                     lNbOfThreadsPerShard,
+                                                     K_DEFAULT_INDEXING_QUEUE_SIZE,
+                                                     lPipelineName.str()));
 
       // DEBUG
-      /*
-        const LocationKey& lLocationKey = lLocation.getKey();
-        OPENTREP_LOG_DEBUG ("[BEF-ADD] " << lLocationKey);
-      */
+      OPENTREP_LOG_DEBUG ("The Xapian index shard ('" << lShardFilePath
+                          << "') has been created");
+    }
 
-      /* When the line/string is relevant, create a BOM instance from
-       * the Location structure.
-       * Otherwise, the line is skipped.
-       */
-      const std::string& lCommonName = lLocation.getCommonName();
-      if (lCommonName == "NotAvailable") {
-        continue;
-      }
-      
-      // Fill the Place object with the Location structure.
-      lPlace.setLocation (lLocation);
-
-      // Add the document, associated to the Place object, to the Xapian index,
-      // if required
-      if (ioXapianDB_ptr != NULL) {
-        IndexBuilder::addDocumentToIndex (*ioXapianDB_ptr, lPlace,
-                                          iTransliterator);
+    // The SQL database, if any, is filled from the whole file
+    if (ioSociSessionPtr != NULL) {
+      lStreamList.push_back (new std::istringstream (lPORFileContent.str()));
+      lPipelineList.push_back (new IndexingPipeline (NULL, ioSociSessionPtr,
+                                                     iIncludeNonIATAPOR,
+                                                     iTransliterator,
+                                                     iPORParserType, 1,
+                                                     K_DEFAULT_INDEXING_QUEUE_SIZE,
+                                                     "[SQL] "));
+    }
+
+    // Run all the pipelines at once
+    const size_t lNbOfPipelines = lPipelineList.size();
+    std::vector<NbOfDBEntries_T> lNbOfEntriesList (lNbOfPipelines, 0);
+    std::vector<std::exception_ptr> lExceptionList (lNbOfPipelines);
+    boost::thread_group lThreadGroup;
+    for (size_t idx = 0; idx != lNbOfPipelines; ++idx) {
+      lThreadGroup.create_thread (boost::bind (runIndexingPipeline,
+                                               boost::ref (lPipelineList[idx]),
+                                               boost::ref (lStreamList[idx]),
+                                               boost::ref (lNbOfEntriesList[idx]),
+                                               boost::ref (lExceptionList[idx])));
+    }
+    lThreadGroup.join_all();
+
+    for (size_t idx = 0; idx != lNbOfPipelines; ++idx) {
+      if (lExceptionList[idx]) {
+        std::rethrow_exception (lExceptionList[idx]);
       }
+    }
+
+    // Commit and close the shards
+    for (NbOfShards_T idx = 0; idx != iNbOfShards; ++idx) {
+      Xapian::WritableDatabase* lShardDB_ptr = lShardDBList[idx];
+      assert (lShardDB_ptr != NULL);
+      lShardDB_ptr->commit_transaction();
+      lShardDB_ptr->close();
+      oNbOfEntries += lNbOfEntriesList[idx];
+    }
 
-      // Add the document to the SQL database, if required
-      if (ioSociSessionPtr != NULL) {
-        DBManager::insertPlaceInDB (*ioSociSessionPtr, lPlace);
+    if (iShouldMergeShards == true) {
+      /**
+       * Merge the shards, in the order of the file, into the Xapian
+       * database. The document IDs of every shard are offset by the number
+       * of documents of the previous shards, and are therefore the same
+       * as with a non-sharded build.
+       */
+      Xapian::Database lShardDatabases;
+      for (NbOfShards_T idx = 0; idx != iNbOfShards; ++idx) {
+        const std::string& lShardFilePath =
+          (lShardsPath / lShardNameList[idx]).string();
+        lShardDatabases.add_database (Xapian::Database (lShardFilePath));
       }
 
+      boost::filesystem::remove_all (lTravelIndexPath);
+      lShardDatabases.compact (iTravelIndexFilePath);
+      lShardDatabases.close();
+      boost::filesystem::remove_all (lShardsPath);
+
       // DEBUG
-      /*
-        OPENTREP_LOG_DEBUG ("[AFT-ADD] " << lLocationKey
-        << ", Place: " << lPlace);
-      */
+      OPENTREP_LOG_DEBUG ("The " << iNbOfShards << " shards have been merged "
+                          << "into the Xapian index ('" << iTravelIndexFilePath
+                          << "')");
 
-      // Iteration
-      ++oNbOfEntries; ++oNbOfEntriesInPORFile;
-      
-      // Progress status
-      if (oNbOfEntries % 1000 == 0) {
-        std::cout.imbue( std::locale (std::locale::classic(), new NumSep));
-        std::cout << "Number of actually parsed records: " << oNbOfEntries
-                  << ", out of " << oNbOfEntriesInPORFile
-                  << " records in the POR data file so far" << std::endl;
+    } else {
+      /**
+       * Reference the shards by a stub database file, within the Xapian
+       * database directory. The relative paths are resolved from that
+       * directory.
+       */
+      const boost::filesystem::path lStubFilePath =
+        lTravelIndexPath / K_XAPIAN_STUB_DB_FILENAME;
+      boost::filesystem::ofstream lStubFile (lStubFilePath);
+      for (NbOfShards_T idx = 0; idx != iNbOfShards; ++idx) {
+        lStubFile << "auto " << lShardNameList[idx] << std::endl;
       }
+      lStubFile.close();
 
       // DEBUG
-      OPENTREP_LOG_DEBUG ("[" << oNbOfEntries << "] " << lPlace);
-
-      // Reset for next turn
-      lPlace.resetMatrix();
-      lPlace.resetIndexSets();
+      OPENTREP_LOG_DEBUG ("The " << iNbOfShards << " shards are referenced "
+                          << "by the Xapian stub database ('"
+                          << lStubFilePath.string() << "')");
     }
 
     return oNbOfEntries;
@@ -231,10 +408,15 @@ namespace OPENTREP {
                     const shouldIndexNonIATAPOR_T& iIncludeNonIATAPOR,
                     const shouldIndexPORInXapian_T& iShouldIndexPORInXapian,
                     const shouldAddPORInSQLDB_T& iShouldAddPORInSQLDB,
-                    const OTransliterator& iTransliterator) {
+                    const OTransliterator& iTransliterator,
+                    const PORParserType& iPORParserType,
+                    const NbOfThreads_T& iNbOfThreads,
+                    const NbOfShards_T& iNbOfShards,
+                    const shouldMergeIndexShards_T& iShouldMergeShards) {
     NbOfDBEntries_T oNbOfEntries = 0;
     soci::session* lSociSession_ptr = NULL;
     Xapian::WritableDatabase* lXapianDatabase_ptr = NULL;
+    const bool isSharded = (iShouldIndexPORInXapian && iNbOfShards > 1);
     
     /**
      *            1. Xapian database (index) initialisation
@@ -243,11 +425,17 @@ namespace OPENTREP {
      * b. Create the Xapian database (index). As the directory has been fully
      * cleaned, deleted and re-created, that Xapian database (index) is empty
      * c. Start a transaction for Xapian
+     *
+     * When the index is sharded, the shards are created later on, by
+     * buildShardedSearchIndex().
      */
     if (iShouldIndexPORInXapian) {
       // Delete and recreate the directory, and its full content,
       // hosting the Xapian index / database
       FileManager::recreateXapianDirectory (iTravelIndexFilePath);
+    }
+
+    if (iShouldIndexPORInXapian && isSharded == false) {
 
       // Recreate the Xapian index / database
       lXapianDatabase_ptr =
@@ -328,15 +516,27 @@ namespace OPENTREP {
     // Browse the input POR (point of reference) data file,
     // parse every of its rows, and put the result in the Xapian database/index
     // and, if needed, within the SQL database.
-    oNbOfEntries = buildSearchIndex (lXapianDatabase_ptr, iSQLDBType,
-                                     lSociSession_ptr, lPORFileStream,
-                                     iIncludeNonIATAPOR, iTransliterator);
+    if (isSharded == true) {
+      oNbOfEntries = buildShardedSearchIndex (iTravelIndexFilePath,
+                                              lSociSession_ptr, lPORFileStream,
+                                              iIncludeNonIATAPOR,
+                                              iTransliterator, iPORParserType,
+                                              iNbOfThreads, iNbOfShards,
+                                              iShouldMergeShards);
+
+    } else {
+      oNbOfEntries = buildSearchIndex (lXapianDatabase_ptr, iSQLDBType,
+                                       lSociSession_ptr, lPORFileStream,
+                                       iIncludeNonIATAPOR, iTransliterator,
+                                       iPORParserType, iNbOfThreads);
+    }
 
     /**
      *            5. Commit the transactions of the Xapian database (index).
      *
+     * The shards, if any, have already been committed and closed.
      */
-    if (iShouldIndexPORInXapian) {
+    if (iShouldIndexPORInXapian && isSharded == false) {
       assert (lXapianDatabase_ptr != NULL);
       lXapianDatabase_ptr->commit_transaction();
 
@@ -351,7 +551,7 @@ namespace OPENTREP {
      *       the Boost Unit Test framework, that latter kills the process.
      *       When called from within GDB, all is fine.
      */
-    if (iShouldIndexPORInXapian) {
+    if (iShouldIndexPORInXapian && isSharded == false) {
       assert (lXapianDatabase_ptr != NULL);
       lXapianDatabase_ptr->close();
     }
@@ -375,6 +575,14 @@ namespace OPENTREP {
                                           *lSociSession_ptr);
       }
     }
+
+    /**
+     *            9. Mark the Xapian database (index) as ready, so that the
+     *               services can hot-swap to it (see SearchIndexHandle).
+     */
+    if (iShouldIndexPORInXapian) {
+      FileManager::writeReadyMarker (iTravelIndexFilePath);
+    }
     
     return oNbOfEntries;
   }
@@ -12,6 +12,7 @@
  */
 // Xapian
 namespace Xapian {
+  class Document;
   class WritableDatabase;
 }
 
@@ -26,23 +27,55 @@ namespace OPENTREP {
   // Forward declarations
   class Place;
   class OTransliterator;
+  class PORParserType;
 
   /**
    * @brief Command wrapping the travel request process.
    */
   class IndexBuilder {
     friend class OPENTREP_Service;
+    friend class IndexingPipeline;
+    friend class IndexUpdater;
   private:
 
+    /**
+     * Fill a Xapian document from a Place object: data (raw data string),
+     * values (e.g., geographical coordinates, content hash), unique ID term
+     * and sets of terms. The spelling dictionary is fed as well.
+     *
+     * The sets of terms of the Place object must have been built
+     * beforehand (see Place::buildIndexSets()).
+     *
+     * @param Xapian::WritableDatabase& Xapian database.
+     * @param const Place& Place object instance.
+     * @param Xapian::Document& Xapian document to be filled.
+     */
+    static void buildDocument (Xapian::WritableDatabase&, const Place&,
+                               Xapian::Document&);
+
     /**
      * Add a document, corresponding to a Place object, to the Xapian index.
      *
+     * The sets of terms of the Place object must have been built
+     * beforehand (see Place::buildIndexSets()).
+     *
+     * @param Xapian::WritableDatabase& Xapian database.
+     * @param Place& Place object instance.
+     */
+    static void addDocumentToIndex (Xapian::WritableDatabase&, Place&);
+
+    /**
+     * Replace the document having the same unique ID as the given Place
+     * object (see Place::describeUniqueID()) within the Xapian index,
+     * or add it when there is no such document.
+     *
+     * The sets of terms of the Place object must have been built
+     * beforehand (see Place::buildIndexSets()).
+     *
      * @param Xapian::WritableDatabase& Xapian database.
      * @param Place& Place object instance.
-     * @param const OTransliterator& Unicode transliterator.
      */
-    static void addDocumentToIndex (Xapian::WritableDatabase&,
-                                    Place&, const OTransliterator&);
+    static void replaceDocumentInIndex (Xapian::WritableDatabase&, Place&);
 
     /**
      * Build Xapian database.
@@ -55,12 +88,18 @@ namespace OPENTREP {
      * @param std::ifstream& File stream for the POR data file.
      * @param const shouldIndexNonIATAPOR_T& Whether all POR should be indexed.
      * @param const OTransliterator& Unicode transliterator.
+     * @param const PORParserType& Type of the parser of the POR records.
+     * @param const NbOfThreads_T& Number of threads parsing the POR and
+     *        building their sets of terms (0 means the number of hardware
+     *        threads). See IndexingPipeline for more details.
      */
     static NbOfDBEntries_T buildSearchIndex (Xapian::WritableDatabase*,
                                              const DBType&, soci::session*,
                                              std::istream& iPORFileStream,
                                              const shouldIndexNonIATAPOR_T&,
-                                             const OTransliterator&);
+                                             const OTransliterator&,
+                                             const PORParserType&,
+                                             const NbOfThreads_T&);
 
     /**
      * Build Xapian database.
@@ -73,6 +112,15 @@ namespace OPENTREP {
      * @param const shouldIndexPORInXapian_T& Whether Xapian should be used.
      * @param const shouldAddPORInSQLDB_T& Whether the SQL DB should be used.
      * @param const OTransliterator& Unicode transliterator.
+     * @param const PORParserType& Type of the parser of the POR records.
+     * @param const NbOfThreads_T& Number of threads parsing the POR and
+     *        building their sets of terms (0 means the number of hardware
+     *        threads).
+     * @param const NbOfShards_T& Number of shards of the Xapian index
+     *        (1 means no sharding).
+     * @param const shouldMergeIndexShards_T& Whether the shards should be
+     *        merged into a single Xapian database, or referenced by a stub
+     *        database.
      */
     static NbOfDBEntries_T buildSearchIndex (const PORFilePath_T&,
                                              const TravelDBFilePath_T&,
@@ -81,7 +129,52 @@ namespace OPENTREP {
                                              const shouldIndexNonIATAPOR_T&,
                                              const shouldIndexPORInXapian_T&,
                                              const shouldAddPORInSQLDB_T&,
-                                             const OTransliterator&);
+                                             const OTransliterator&,
+                                             const PORParserType&,
+                                             const NbOfThreads_T&,
+                                             const NbOfShards_T&,
+                                             const shouldMergeIndexShards_T&);
+
+    /**
+     * Build the Xapian database as several shards, in parallel.
+     *
+     * The POR data file is split into as many contiguous chunks as shards,
+     * and every chunk is indexed, by its own IndexingPipeline, into its own
+     * Xapian database. When required, the SQL database is filled by yet
+     * another pipeline, running alongside, from the whole file.
+     *
+     * The shards are then either:
+     * <ul>
+     *   <li>merged, in the order of the file, into the Xapian database
+     *       (with compaction). The document IDs are then the same as
+     *       with a non-sharded build;</li>
+     *   <li>or kept as sub-directories of the Xapian database directory,
+     *       referenced by a stub database file, which the search process
+     *       transparently opens as a combined database.</li>
+     * </ul>
+     *
+     * @param const TravelDBFilePath_T& File-path of the Xapian database.
+     * @param soci::session* SOCI session handler. It can be NULL when there
+     *                       is no use of SQL DB.
+     * @param std::istream& File stream for the POR data file.
+     * @param const shouldIndexNonIATAPOR_T& Whether all POR should be indexed.
+     * @param const OTransliterator& Unicode transliterator.
+     * @param const PORParserType& Type of the parser of the POR records.
+     * @param const NbOfThreads_T& Overall number of threads parsing the POR
+     *        and building their sets of terms (0 means the number of
+     *        hardware threads), spread across the shards.
+     * @param const NbOfShards_T& Number of shards.
+     * @param const shouldMergeIndexShards_T& Whether the shards should be
+     *        merged.
+     * @return NbOfDBEntries_T Number of POR indexed by Xapian.
+     */
+    static NbOfDBEntries_T
+    buildShardedSearchIndex (const TravelDBFilePath_T&, soci::session*,
+                             std::istream& iPORFileStream,
+                             const shouldIndexNonIATAPOR_T&,
+                             const OTransliterator&, const PORParserType&,
+                             const NbOfThreads_T&, const NbOfShards_T&,
+                             const shouldMergeIndexShards_T&);
 
   private:
     /**
@@ -0,0 +1,375 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+#include <map>
+// Boost
+#include <boost/filesystem.hpp>
+// SOCI
+#include <soci/soci.h>
+// Xapian
+#include <xapian.h>
+// OpenTrep
+#include <opentrep/Location.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/OTransliterator.hpp>
+#include <opentrep/basic/Utilities.hpp>
+#include <opentrep/bom/Place.hpp>
+#include <opentrep/bom/PORFileHelper.hpp>
+#include <opentrep/bom/PORParserHelper.hpp>
+#include <opentrep/factory/FacPlace.hpp>
+#include <opentrep/factory/FacXapianDB.hpp>
+#include <opentrep/command/DBManager.hpp>
+#include <opentrep/command/FileManager.hpp>
+#include <opentrep/command/IndexBuilder.hpp>
+#include <opentrep/command/IndexUpdater.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T IndexUpdater::
+  getContentHashes (const Xapian::Database& iDatabase,
+                    ContentHashMap_T& ioContentHashMap) {
+    NbOfDBEntries_T oNbOfEntries = 0;
+
+    // Retrieve the content hashes, by document ID, from the value stream
+    typedef std::map<Xapian::docid, ContentHash_T> ContentHashByDocID_T;
+    ContentHashByDocID_T lContentHashByDocID;
+    for (Xapian::ValueIterator itValue =
+           iDatabase.valuestream_begin (K_XAPIAN_VALUE_SLOT_CONTENT_HASH);
+         itValue != iDatabase.valuestream_end (K_XAPIAN_VALUE_SLOT_CONTENT_HASH);
+         ++itValue) {
+      lContentHashByDocID[itValue.get_docid()] = *itValue;
+    }
+
+    // Browse the unique ID terms, each of which indexes a single document
+    const std::string& lPrefix = K_XAPIAN_UNIQUE_ID_TERM_PREFIX;
+    for (Xapian::TermIterator itTerm = iDatabase.allterms_begin (lPrefix);
+         itTerm != iDatabase.allterms_end (lPrefix); ++itTerm) {
+      const std::string lUniqueIDTerm = *itTerm;
+      Xapian::PostingIterator itPosting = iDatabase.postlist_begin (lUniqueIDTerm);
+      if (itPosting == iDatabase.postlist_end (lUniqueIDTerm)) {
+        continue;
+      }
+
+      const Xapian::docid lDocID = *itPosting;
+      const std::string lUniqueID = lUniqueIDTerm.substr (lPrefix.size());
+      ioContentHashMap[lUniqueID] = lContentHashByDocID[lDocID];
+      ++oNbOfEntries;
+    }
+
+    // All the documents must carry a unique ID
+    const Xapian::doccount lNbOfDocs = iDatabase.get_doccount();
+    if (oNbOfEntries != lNbOfDocs) {
+      std::ostringstream errorStr;
+      errorStr << "Only " << oNbOfEntries << " out of the " << lNbOfDocs
+               << " documents of the Xapian index have a unique ID. The "
+               << "index may have been built by a former version of OpenTREP,"
+               << " and cannot be updated incrementally: it has to be rebuilt";
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw XapianDatabaseFailureException (errorStr.str());
+    }
+
+    return oNbOfEntries;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexUpdater::removeSpellings (Xapian::WritableDatabase& ioDatabase,
+                                      const std::string& iUniqueID,
+                                      const OTransliterator& iTransliterator,
+                                      const PORParserType& iPORParserType,
+                                      Place& ioPlace) {
+    // Retrieve the document data, i.e., the former raw data string
+    const std::string& lUniqueIDTerm = K_XAPIAN_UNIQUE_ID_TERM_PREFIX + iUniqueID;
+    Xapian::PostingIterator itPosting = ioDatabase.postlist_begin (lUniqueIDTerm);
+    if (itPosting == ioDatabase.postlist_end (lUniqueIDTerm)) {
+      return;
+    }
+    const Xapian::Document& lDocument = ioDatabase.get_document (*itPosting);
+    const std::string& lDocData = lDocument.get_data();
+
+    // Re-build the former sets of terms
+    PORStringParser lStringParser (lDocData, iPORParserType);
+    const Location& lLocation = lStringParser.generateLocation();
+    ioPlace.setLocation (lLocation);
+    ioPlace.buildIndexSets (iTransliterator);
+
+    // Remove the former spelling terms
+    const Place::StringSet_T& lSpellingSet = ioPlace.getSpellingSet();
+    for (Place::StringSet_T::const_iterator itTerm = lSpellingSet.begin();
+         itTerm != lSpellingSet.end(); ++itTerm) {
+      const std::string& lTerm = *itTerm;
+      ioDatabase.remove_spelling (lTerm);
+    }
+
+    // Reset for next turn
+    ioPlace.resetMatrix();
+    ioPlace.resetIndexSets();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexUpdater::applyChanges (Xapian::WritableDatabase* ioXapianDB_ptr,
+                                   soci::session* ioSociSessionPtr,
+                                   std::istream& iPORFileStream,
+                                   const shouldIndexNonIATAPOR_T& iIncludeNonIATAPOR,
+                                   const OTransliterator& iTransliterator,
+                                   const PORParserType& iPORParserType,
+                                   const SQLDBSchemaVersion_T& iHashedVersion,
+                                   ContentHashMap_T& ioIndexedHashMap,
+                                   IndexUpdateReport& ioReport) {
+    // Place objects, for the new and the former versions of the POR records
+    Place& lPlace = FacPlace::instance().create();
+    Place& lFormerPlace = FacPlace::instance().create();
+
+    // Browse the POR data file
+    std::string lReadLine;
+    while (std::getline (iPORFileStream, lReadLine)) {
+
+      // Same filter as for the building of the whole index
+      // (see IndexingPipeline)
+      if (!iIncludeNonIATAPOR) {
+        const size_t lFirstSeparatorPos = lReadLine.find_first_of ("^");
+        if (lFirstSeparatorPos != 3) {
+          continue;
+        }
+      }
+
+      // Parse the line
+      PORStringParser lStringParser (lReadLine, iPORParserType);
+      const Location& lLocation = lStringParser.generateLocation();
+      const std::string& lCommonName = lLocation.getCommonName();
+      if (lCommonName == "NotAvailable") {
+        continue;
+      }
+      lPlace.setLocation (lLocation);
+
+      // Compare the content of the POR record with the indexed one, if any
+      const std::string& lUniqueID = lPlace.describeUniqueID();
+      const ContentHash_T& lContentHash =
+        DBManager::calculatePlaceContentHash (iHashedVersion, lPlace);
+      ContentHashMap_T::iterator itIndexedHash =
+        ioIndexedHashMap.find (lUniqueID);
+      const bool isNew = (itIndexedHash == ioIndexedHashMap.end());
+      if (isNew == false) {
+        const ContentHash_T lIndexedHash = itIndexedHash->second;
+        ioIndexedHashMap.erase (itIndexedHash);
+
+        if (lIndexedHash == lContentHash) {
+          ioReport.incrementNbOfUnchangedPOR();
+          lPlace.resetMatrix();
+          continue;
+        }
+      }
+
+      // Replace (or add) the Xapian document
+      if (ioXapianDB_ptr != NULL) {
+        if (isNew == false) {
+          removeSpellings (*ioXapianDB_ptr, lUniqueID, iTransliterator,
+                           iPORParserType, lFormerPlace);
+        }
+        lPlace.buildIndexSets (iTransliterator);
+        IndexBuilder::replaceDocumentInIndex (*ioXapianDB_ptr, lPlace);
+      }
+
+      // Replace (or add) the SQL row
+      if (ioSociSessionPtr != NULL) {
+        DBManager::upsertPlaceInDB (*ioSociSessionPtr, lPlace);
+      }
+
+      if (isNew == true) {
+        ioReport.incrementNbOfAddedPOR();
+      } else {
+        ioReport.incrementNbOfChangedPOR();
+      }
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("The " << lUniqueID << " POR record has been "
+                          << (isNew == true ? "added" : "changed"));
+
+      // Reset for next turn
+      lPlace.resetMatrix();
+      lPlace.resetIndexSets();
+    }
+
+    // The remaining indexed POR records are no longer in the POR data file
+    for (ContentHashMap_T::const_iterator itIndexedHash =
+           ioIndexedHashMap.begin();
+         itIndexedHash != ioIndexedHashMap.end(); ++itIndexedHash) {
+      const std::string& lUniqueID = itIndexedHash->first;
+
+      // Delete the Xapian document
+      if (ioXapianDB_ptr != NULL) {
+        removeSpellings (*ioXapianDB_ptr, lUniqueID, iTransliterator,
+                         iPORParserType, lFormerPlace);
+        ioXapianDB_ptr->delete_document (K_XAPIAN_UNIQUE_ID_TERM_PREFIX
+                                         + lUniqueID);
+      }
+
+      // Delete the SQL row
+      if (ioSociSessionPtr != NULL) {
+        std::string lPK;
+        EnvelopeID_T lEnvelopeID;
+        splitPORUniqueID (lUniqueID, lPK, lEnvelopeID);
+        DBManager::deletePlaceFromDB (*ioSociSessionPtr, lPK, lEnvelopeID);
+      }
+
+      ioReport.incrementNbOfRemovedPOR();
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("The " << lUniqueID << " POR record has been removed");
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  IndexUpdateReport IndexUpdater::
+  updateSearchIndex (const PORFilePath_T& iPORFilePath,
+                     const TravelDBFilePath_T& iTravelIndexFilePath,
+                     const DBType& iSQLDBType,
+                     const SQLDBConnectionString_T& iSQLDBConnStr,
+                     const shouldIndexNonIATAPOR_T& iIncludeNonIATAPOR,
+                     const shouldIndexPORInXapian_T& iShouldIndexPORInXapian,
+                     const shouldAddPORInSQLDB_T& iShouldAddPORInSQLDB,
+                     const OTransliterator& iTransliterator,
+                     const PORParserType& iPORParserType) {
+    IndexUpdateReport oReport;
+    soci::session* lSociSession_ptr = NULL;
+    Xapian::WritableDatabase* lXapianDatabase_ptr = NULL;
+
+    /**
+     *            1. Open the Xapian database (index)
+     *
+     * The shards referenced by a stub database cannot be updated, as the
+     * POR records are spread across them.
+     */
+    if (iShouldIndexPORInXapian) {
+      const boost::filesystem::path lStubFilePath =
+        boost::filesystem::path (iTravelIndexFilePath)
+        / K_XAPIAN_STUB_DB_FILENAME;
+      if (boost::filesystem::exists (lStubFilePath) == true) {
+        std::ostringstream errorStr;
+        errorStr << "The Xapian index ('" << iTravelIndexFilePath
+                 << "') is made of shards referenced by a stub database, "
+                 << "and cannot be updated incrementally: it has to be rebuilt";
+        OPENTREP_LOG_ERROR (errorStr.str());
+        throw XapianDatabaseFailureException (errorStr.str());
+      }
+
+      lXapianDatabase_ptr =
+        FacXapianDB::instance().create (iTravelIndexFilePath,
+                                        Xapian::DB_CREATE_OR_OPEN);
+      assert (lXapianDatabase_ptr != NULL);
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("The Xapian index / database ('"
+                          << iTravelIndexFilePath << "') has been opened");
+    }
+
+    /**
+     *            2. Connection to the SQL Database
+     */
+    if (iShouldAddPORInSQLDB && !(iSQLDBType == DBType::NODB)) {
+      lSociSession_ptr =
+        DBManager::initSQLDBSession (iSQLDBType, iSQLDBConnStr);
+
+      if (lSociSession_ptr == NULL) {
+        std::ostringstream errorStr;
+        errorStr << "Error when trying to connect to the SQL database ('"
+                 << iSQLDBConnStr << "')";
+        OPENTREP_LOG_ERROR (errorStr.str());
+        throw SQLDatabaseImpossibleConnectionException (errorStr.str());
+      }
+      assert (lSociSession_ptr != NULL);
+    }
+
+    /**
+     *            3. Retrieve the content hashes of the indexed POR records
+     *
+     * The Xapian index is the reference, when used. The SQL database is
+     * then expected to be in sync with it, as both are filled by the
+     * same indexer.
+     */
+    ContentHashMap_T lIndexedHashMap;
+    NbOfDBEntries_T lNbOfIndexedPOR = 0;
+    SQLDBSchemaVersion_T lHashedSchemaVersion = 0;
+    if (lXapianDatabase_ptr != NULL) {
+      lNbOfIndexedPOR = getContentHashes (*lXapianDatabase_ptr,
+                                          lIndexedHashMap);
+    } else if (lSociSession_ptr != NULL) {
+      // The hashes are those of the serialised places (e.g., Protobuf
+      // records), which depend on the version of the schema
+      lHashedSchemaVersion =
+        DBManager::getSQLDBSchemaVersion (*lSociSession_ptr);
+      lNbOfIndexedPOR = DBManager::getContentHashes (*lSociSession_ptr,
+                                                     lIndexedHashMap);
+    }
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG (lNbOfIndexedPOR << " POR records are indexed");
+
+    /**
+     *            4. Parse the POR data file, and apply the changes
+     *
+     * All the changes are applied within a single transaction, for the
+     * Xapian index as well as for the SQL database, so that a failure
+     * leaves them as they were.
+     */
+    const PORFileHelper lPORFileHelper (iPORFilePath);
+    std::istream& lPORFileStream = lPORFileHelper.getFileStreamRef();
+
+    if (lXapianDatabase_ptr != NULL) {
+      lXapianDatabase_ptr->begin_transaction();
+    }
+    if (lSociSession_ptr != NULL) {
+      lSociSession_ptr->begin();
+    }
+
+    try {
+      applyChanges (lXapianDatabase_ptr, lSociSession_ptr, lPORFileStream,
+                    iIncludeNonIATAPOR, iTransliterator, iPORParserType,
+                    lHashedSchemaVersion, lIndexedHashMap, oReport);
+
+    } catch (...) {
+      if (lXapianDatabase_ptr != NULL) {
+        lXapianDatabase_ptr->cancel_transaction();
+        lXapianDatabase_ptr->close();
+      }
+      if (lSociSession_ptr != NULL) {
+        lSociSession_ptr->rollback();
+        DBManager::terminateSQLDBSession (iSQLDBType, iSQLDBConnStr,
+                                          *lSociSession_ptr);
+      }
+      throw;
+    }
+
+    /**
+     *            5. Commit the transactions, and close the databases
+     */
+    if (lXapianDatabase_ptr != NULL) {
+      lXapianDatabase_ptr->commit_transaction();
+      lXapianDatabase_ptr->close();
+    }
+    if (lSociSession_ptr != NULL) {
+      lSociSession_ptr->commit();
+      DBManager::terminateSQLDBSession (iSQLDBType, iSQLDBConnStr,
+                                        *lSociSession_ptr);
+    }
+
+    /**
+     *            6. Mark the Xapian database (index) as ready, so that the
+     *               services can hot-swap to it (see SearchIndexHandle).
+     */
+    if (lXapianDatabase_ptr != NULL) {
+      FileManager::writeReadyMarker (iTravelIndexFilePath);
+    }
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("The Xapian index and/or SQL database have been "
+                        << "updated: " << oReport.describe());
+
+    return oReport;
+  }
+
+}
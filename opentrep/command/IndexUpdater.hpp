@@ -0,0 +1,162 @@
+#ifndef __OPENTREP_CMD_INDEXUPDATER_HPP
+#define __OPENTREP_CMD_INDEXUPDATER_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <istream>
+#include <string>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/IndexUpdateReport.hpp>
+
+/**
+ * Forward declarations
+ */
+// Xapian
+namespace Xapian {
+  class Database;
+  class WritableDatabase;
+}
+
+// SOCI (for SQL database)
+namespace soci {
+  class session;
+}
+
+namespace OPENTREP {
+
+  // Forward declarations
+  class Place;
+  class OTransliterator;
+  class PORParserType;
+  struct DBType;
+
+  /**
+   * @brief Command updating incrementally the Xapian index and/or the SQL
+   *        database from a new version of the POR (points of reference)
+   *        data file.
+   *
+   * Every Xapian document carries the unique ID of its POR record (primary
+   * key and envelope ID, see Place::describeUniqueID()), as a boolean term,
+   * and the hash of the content of that record, as a value. The SQL
+   * database stores the raw content of the POR records, from which the
+   * hashes are calculated.
+   *
+   * The POR records of the new file are compared with the indexed ones
+   * (the Xapian index being the reference when used, and the SQL database
+   * otherwise), and only the added, changed and removed POR records are
+   * written, within a single transaction for each database. The
+   * (unchanged) POR records are therefore neither transliterated nor
+   * re-indexed.
+   *
+   * \note The Xapian index must have been built by a version of OpenTREP
+   *       storing the unique IDs and content hashes, and must not be made
+   *       of shards referenced by a stub database. Otherwise, it has to be
+   *       rebuilt from scratch (see IndexBuilder).
+   */
+  class IndexUpdater {
+    friend class OPENTREP_Service;
+  private:
+
+    /**
+     * Update the Xapian index and/or the SQL database.
+     *
+     * @param const PORFilePath_T& File-path of the (new) POR file.
+     * @param const TravelDBFilePath_T& File-path of the Xapian database.
+     * @param const DBType& SQL database type (can be no database at all).
+     * @param const SQLDBConnectionString_T& SQL DB connection string.
+     * @param const shouldIndexNonIATAPOR_T& Whether all POR should be indexed.
+     * @param const shouldIndexPORInXapian_T& Whether Xapian should be used.
+     * @param const shouldAddPORInSQLDB_T& Whether the SQL DB should be used.
+     * @param const OTransliterator& Unicode transliterator.
+     * @param const PORParserType& Type of the parser of the POR records.
+     * @return IndexUpdateReport Numbers of added, changed, removed and
+     *         unchanged POR records.
+     */
+    static IndexUpdateReport updateSearchIndex (const PORFilePath_T&,
+                                                const TravelDBFilePath_T&,
+                                                const DBType&,
+                                                const SQLDBConnectionString_T&,
+                                                const shouldIndexNonIATAPOR_T&,
+                                                const shouldIndexPORInXapian_T&,
+                                                const shouldAddPORInSQLDB_T&,
+                                                const OTransliterator&,
+                                                const PORParserType&);
+
+    /**
+     * Apply the changes of the POR data file to the Xapian index and/or
+     * the SQL database, the transactions of which must have been begun
+     * by the caller.
+     *
+     * @param Xapian::WritableDatabase* Handle on the Xapian database/index
+     *                                  It is NULL when no use of Xapian.
+     * @param soci::session* SOCI session handler. It can be NULL when there
+     *                       is no use of SQL DB.
+     * @param std::istream& File stream for the POR data file.
+     * @param const shouldIndexNonIATAPOR_T& Whether all POR should be indexed.
+     * @param const OTransliterator& Unicode transliterator.
+     * @param const PORParserType& Type of the parser of the POR records.
+     * @param const SQLDBSchemaVersion_T& Version of the schema of the SQL
+     *        database, when the content hashes are those of that latter
+     *        (see DBManager::calculatePlaceContentHash()); 0 when they are
+     *        those of the Xapian index, i.e., of the raw data strings.
+     * @param ContentHashMap_T& Content hashes of the indexed POR records.
+     *        The entries of the POR records of the file are removed from it.
+     * @param IndexUpdateReport& Report of the update.
+     */
+    static void applyChanges (Xapian::WritableDatabase*, soci::session*,
+                              std::istream& iPORFileStream,
+                              const shouldIndexNonIATAPOR_T&,
+                              const OTransliterator&, const PORParserType&,
+                              const SQLDBSchemaVersion_T&,
+                              ContentHashMap_T&, IndexUpdateReport&);
+
+    /**
+     * Retrieve the hashes of the content of all the documents of the
+     * Xapian index, indexed by the unique IDs of those documents.
+     *
+     * @param const Xapian::Database& Xapian database.
+     * @param ContentHashMap_T& Map of the content hashes, to be filled.
+     * @return NbOfDBEntries_T Number of documents of the Xapian index.
+     */
+    static NbOfDBEntries_T getContentHashes (const Xapian::Database&,
+                                             ContentHashMap_T&);
+
+    /**
+     * Remove, from the Xapian spelling dictionary, the terms added by the
+     * document of the given unique ID, so that the dictionary does not
+     * keep track of the former versions of the POR records. The document
+     * data is parsed again, and the sets of terms re-built, for that
+     * purpose.
+     *
+     * @param Xapian::WritableDatabase& Xapian database.
+     * @param const std::string& Unique ID of the POR record.
+     * @param const OTransliterator& Unicode transliterator.
+     * @param const PORParserType& Type of the parser of the POR records.
+     * @param Place& Place object instance, used as a placeholder.
+     */
+    static void removeSpellings (Xapian::WritableDatabase&, const std::string&,
+                                 const OTransliterator&, const PORParserType&,
+                                 Place&);
+
+  private:
+    /**
+     * Default constructor.
+     */
+    IndexUpdater() {}
+
+    /**
+     * Copy constructor.
+     */
+    IndexUpdater (const IndexUpdater&) {}
+
+    /**
+     * Destructor.
+     */
+    ~IndexUpdater() {}
+  };
+
+}
+#endif // __OPENTREP_CMD_INDEXUPDATER_HPP
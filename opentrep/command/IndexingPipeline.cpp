@@ -0,0 +1,427 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+#include <locale>
+// Boost
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+// Xapian
+#include <xapian.h>
+// OpenTrep
+#include <opentrep/Location.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/BasChronometer.hpp>
+#include <opentrep/basic/Utilities.hpp>
+#include <opentrep/bom/Place.hpp>
+#include <opentrep/bom/PORParserHelper.hpp>
+#include <opentrep/factory/FacPlace.hpp>
+#include <opentrep/command/IndexBuilder.hpp>
+#include <opentrep/command/IndexingPipeline.hpp>
+#include <opentrep/command/PlaceBulkLoader.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  IndexingPipeline::
+  IndexingPipeline (Xapian::WritableDatabase* ioXapianDB_ptr,
+                    soci::session* ioSociSessionPtr,
+                    const shouldIndexNonIATAPOR_T& iIncludeNonIATAPOR,
+                    const OTransliterator& iTransliterator,
+                    const PORParserType& iPORParserType,
+                    const NbOfThreads_T& iNbOfThreads,
+                    const NbOfDBEntries_T& iQueueSize,
+                    const std::string& iName)
+    : _name (iName), _xapianDB_ptr (ioXapianDB_ptr), _sociSession_ptr (ioSociSessionPtr),
+      _bulkLoader_ptr (NULL),
+      _includeNonIATAPOR (iIncludeNonIATAPOR),
+      _transliterator (iTransliterator), _porParserType (iPORParserType),
+      _nbOfWorkers (iNbOfThreads),
+      _nbOfReadLines (0), _nextLineToWrite (0),
+      _isReadingOver (false), _isAborted (false),
+      _nbOfSkippedLines (0), _nbOfWrittenPOR (0),
+      _readingTime (0.0), _parsingTime (0.0), _termBuildingTime (0.0),
+      _xapianWritingTime (0.0), _sqlWritingTime (0.0), _elapsedTime (0.0) {
+
+    if (_nbOfWorkers == 0) {
+      _nbOfWorkers = boost::thread::hardware_concurrency();
+    }
+    if (_nbOfWorkers == 0) {
+      _nbOfWorkers = 1;
+    }
+
+    // The Place objects are created once for all, and re-used from
+    // one line to another
+    assert (iQueueSize != 0);
+    _slotList.resize (iQueueSize);
+    for (std::vector<Slot>::iterator itSlot = _slotList.begin();
+         itSlot != _slotList.end(); ++itSlot) {
+      Slot& lSlot = *itSlot;
+      lSlot._place = &FacPlace::instance().create();
+      lSlot._nbOfSkippedLines = 0;
+      lSlot._state = FREE;
+    }
+
+    // The POR are inserted into the SQL database by batches
+    if (_sociSession_ptr != NULL) {
+      _bulkLoader_ptr =
+        new PlaceBulkLoader (*_sociSession_ptr,
+                             K_DEFAULT_SQL_BULK_LOAD_BATCH_SIZE);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  IndexingPipeline::~IndexingPipeline() {
+    // The Place objects are deleted by the Place factory
+    delete _bulkLoader_ptr; _bulkLoader_ptr = NULL;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexingPipeline::abort() {
+    if (_isAborted == false) {
+      _isAborted = true;
+      _exception = std::current_exception();
+    }
+    _slotReleased.notify_all();
+    _lineRead.notify_all();
+    _placeBuilt.notify_all();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T IndexingPipeline::run (std::istream& iPORFileStream) {
+    BasChronometer lElapsedChronometer;
+    lElapsedChronometer.start();
+
+    // Launch the worker threads and the writer thread
+    boost::thread_group lThreadGroup;
+    for (NbOfThreads_T idx = 0; idx != _nbOfWorkers; ++idx) {
+      lThreadGroup.create_thread (boost::bind (&IndexingPipeline::work, this));
+    }
+    lThreadGroup.create_thread (boost::bind (&IndexingPipeline::write, this));
+
+    // Read the lines of the POR data file
+    const NbOfDBEntries_T lNbOfSlots = _slotList.size();
+    BasChronometer lReadingChronometer;
+    lReadingChronometer.start();
+    std::string lReadLine;
+    while (std::getline (iPORFileStream, lReadLine)) {
+
+      /* First, if only the IATA-refernced POR must be indexed
+       * (ie, when _includeNonIATAPOR is set to false), the line
+       * must start with a non empty IATA code of three letters;
+       * in other words, the separator (the hat symbol) is first seen
+       * at position 3 (remember that strings in C++ start at position 0).
+       * Otherwise, the line is skipped.
+       */
+      if (!_includeNonIATAPOR) {
+        const size_t lFirstSeparatorPos = lReadLine.find_first_of ("^");
+        if (lFirstSeparatorPos != 3) {
+          ++_nbOfSkippedLines;
+          continue;
+        }
+      }
+
+      boost::unique_lock<boost::mutex> lLock (_mutex);
+      _readingTime += lReadingChronometer.elapsed();
+
+      // Wait for the slot to be released by the writer
+      while (_isAborted == false
+             && _nbOfReadLines - _nextLineToWrite >= lNbOfSlots) {
+        _slotReleased.wait (lLock);
+      }
+      if (_isAborted == true) {
+        break;
+      }
+
+      // Hand the line over to the worker threads
+      Slot& lSlot = _slotList[_nbOfReadLines % lNbOfSlots];
+      assert (lSlot._state == FREE);
+      lSlot._line.swap (lReadLine);
+      lSlot._nbOfSkippedLines = _nbOfSkippedLines;
+      lSlot._state = READ;
+      _workQueue.push_back (_nbOfReadLines);
+      ++_nbOfReadLines;
+      _lineRead.notify_one();
+
+      lReadingChronometer.start();
+    }
+
+    // Signal the end of the file, and wait for the other threads
+    {
+      boost::unique_lock<boost::mutex> lLock (_mutex);
+      _isReadingOver = true;
+      _lineRead.notify_all();
+      _placeBuilt.notify_all();
+    }
+    lThreadGroup.join_all();
+
+    _elapsedTime = lElapsedChronometer.elapsed();
+
+    // Propagate the failure of any stage
+    if (_isAborted == true) {
+      std::rethrow_exception (_exception);
+    }
+
+    // Report the throughputs
+    const std::string& lThroughputs = describeThroughputs();
+    OPENTREP_LOG_NOTIFICATION (lThroughputs);
+
+    return _nbOfWrittenPOR;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexingPipeline::work() {
+    const NbOfDBEntries_T lNbOfSlots = _slotList.size();
+    double lParsingTime = 0.0;
+    double lTermBuildingTime = 0.0;
+
+    while (true) {
+      // Wait for a line to be parsed
+      NbOfDBEntries_T lLineNumber = 0;
+      {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        while (_isAborted == false && _workQueue.empty() == true
+               && _isReadingOver == false) {
+          _lineRead.wait (lLock);
+        }
+        if (_isAborted == true || _workQueue.empty() == true) {
+          _parsingTime += lParsingTime;
+          _termBuildingTime += lTermBuildingTime;
+          return;
+        }
+        lLineNumber = _workQueue.front();
+        _workQueue.pop_front();
+      }
+
+      // The slot belongs to the current thread, until it is marked
+      // as built (or skipped)
+      Slot& lSlot = _slotList[lLineNumber % lNbOfSlots];
+      assert (lSlot._state == READ && lSlot._place != NULL);
+      Place& lPlace = *lSlot._place;
+      EN_SlotState lState = BUILT;
+
+      try {
+        // Parse the line
+        BasChronometer lParsingChronometer;
+        lParsingChronometer.start();
+        PORStringParser lStringParser (lSlot._line, _porParserType);
+        const Location& lLocation = lStringParser.generateLocation();
+
+        /* When the line/string is relevant, fill the Place object
+         * with the Location structure. Otherwise, the line is skipped.
+         */
+        const std::string& lCommonName = lLocation.getCommonName();
+        if (lCommonName == "NotAvailable") {
+          lState = SKIPPED;
+        } else {
+          lPlace.setLocation (lLocation);
+        }
+        lParsingTime += lParsingChronometer.elapsed();
+
+        // Build the (STL) sets of terms to be added to the Xapian index
+        // and spelling dictionary
+        if (lState == BUILT && _xapianDB_ptr != NULL) {
+          BasChronometer lTermBuildingChronometer;
+          lTermBuildingChronometer.start();
+          lPlace.buildIndexSets (_transliterator);
+          lTermBuildingTime += lTermBuildingChronometer.elapsed();
+        }
+
+      } catch (...) {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        abort();
+        _parsingTime += lParsingTime;
+        _termBuildingTime += lTermBuildingTime;
+        return;
+      }
+
+      // Hand the Place object over to the writer thread
+      boost::unique_lock<boost::mutex> lLock (_mutex);
+      lSlot._state = lState;
+      if (lLineNumber == _nextLineToWrite) {
+        _placeBuilt.notify_all();
+      }
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexingPipeline::write() {
+    const NbOfDBEntries_T lNbOfSlots = _slotList.size();
+    double lXapianWritingTime = 0.0;
+    double lSQLWritingTime = 0.0;
+    NbOfDBEntries_T lNbOfWrittenPOR = 0;
+
+    // Prepare the SQL database for the bulk load, if required
+    if (_bulkLoader_ptr != NULL) {
+      try {
+        BasChronometer lSQLWritingChronometer;
+        lSQLWritingChronometer.start();
+        _bulkLoader_ptr->start();
+        lSQLWritingTime += lSQLWritingChronometer.elapsed();
+
+      } catch (...) {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        abort();
+        return;
+      }
+    }
+
+    while (true) {
+      // Wait for the next Place object, in the order of the file
+      Slot* lSlot_ptr = NULL;
+      {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        while (true) {
+          if (_isAborted == true) {
+            break;
+          }
+          if (_nextLineToWrite < _nbOfReadLines) {
+            lSlot_ptr = &_slotList[_nextLineToWrite % lNbOfSlots];
+            if (lSlot_ptr->_state == BUILT || lSlot_ptr->_state == SKIPPED) {
+              break;
+            }
+          } else if (_isReadingOver == true) {
+            break;
+          }
+          lSlot_ptr = NULL;
+          _placeBuilt.wait (lLock);
+        }
+        if (_isAborted == true) {
+          _xapianWritingTime += lXapianWritingTime;
+          _sqlWritingTime += lSQLWritingTime;
+          _nbOfWrittenPOR = lNbOfWrittenPOR;
+          return;
+        }
+        if (lSlot_ptr == NULL) {
+          break;
+        }
+      }
+
+      assert (lSlot_ptr != NULL && lSlot_ptr->_place != NULL);
+      Slot& lSlot = *lSlot_ptr;
+      Place& lPlace = *lSlot._place;
+
+      try {
+        if (lSlot._state == BUILT) {
+          // Add the document, associated to the Place object, to the Xapian
+          // index, if required
+          if (_xapianDB_ptr != NULL) {
+            BasChronometer lXapianWritingChronometer;
+            lXapianWritingChronometer.start();
+            IndexBuilder::addDocumentToIndex (*_xapianDB_ptr, lPlace);
+            lXapianWritingTime += lXapianWritingChronometer.elapsed();
+          }
+
+          // Add the document to the SQL database, if required
+          if (_bulkLoader_ptr != NULL) {
+            BasChronometer lSQLWritingChronometer;
+            lSQLWritingChronometer.start();
+            _bulkLoader_ptr->add (lPlace);
+            lSQLWritingTime += lSQLWritingChronometer.elapsed();
+          }
+
+          // Iteration
+          ++lNbOfWrittenPOR;
+
+          // Progress status
+          if (lNbOfWrittenPOR % 1000 == 0) {
+            const NbOfDBEntries_T lNbOfEntriesInPORFile =
+              lNbOfWrittenPOR + lSlot._nbOfSkippedLines;
+            std::ostringstream oStr;
+            oStr.imbue (std::locale (std::locale::classic(), new NumSep));
+            oStr << _name << "Number of actually parsed records: "
+                 << lNbOfWrittenPOR << ", out of " << lNbOfEntriesInPORFile
+                 << " records in the POR data file so far";
+            OPENTREP_LOG_NOTIFICATION (oStr.str());
+          }
+
+          // DEBUG
+          OPENTREP_LOG_DEBUG ("[" << lNbOfWrittenPOR << "] " << lPlace);
+        }
+
+        // Reset for next turn
+        lPlace.resetMatrix();
+        lPlace.resetIndexSets();
+
+      } catch (...) {
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        abort();
+        _xapianWritingTime += lXapianWritingTime;
+        _sqlWritingTime += lSQLWritingTime;
+        _nbOfWrittenPOR = lNbOfWrittenPOR;
+        return;
+      }
+
+      // Release the slot, for the reader
+      boost::unique_lock<boost::mutex> lLock (_mutex);
+      lSlot._line.clear();
+      lSlot._state = FREE;
+      ++_nextLineToWrite;
+      _slotReleased.notify_one();
+    }
+
+    // Insert the remaining POR into the SQL database, if required
+    if (_bulkLoader_ptr != NULL) {
+      try {
+        BasChronometer lSQLWritingChronometer;
+        lSQLWritingChronometer.start();
+        _bulkLoader_ptr->finish();
+        lSQLWritingTime += lSQLWritingChronometer.elapsed();
+
+      } catch (...) {
+        // The exception must be kept while it is being handled
+        boost::unique_lock<boost::mutex> lLock (_mutex);
+        abort();
+        _xapianWritingTime += lXapianWritingTime;
+        _sqlWritingTime += lSQLWritingTime;
+        _nbOfWrittenPOR = lNbOfWrittenPOR;
+        return;
+      }
+    }
+
+    boost::unique_lock<boost::mutex> lLock (_mutex);
+    _xapianWritingTime += lXapianWritingTime;
+    _sqlWritingTime += lSQLWritingTime;
+    _nbOfWrittenPOR = lNbOfWrittenPOR;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void describeStageThroughput (std::ostream& ioOut,
+                                const std::string& iStageName,
+                                const NbOfDBEntries_T& iNbOfRows,
+                                const double iStageTime) {
+    ioOut << iStageName << ": " << iStageTime << "s";
+    if (iStageTime > 0.0) {
+      ioOut << " (" << static_cast<NbOfDBEntries_T> (iNbOfRows / iStageTime)
+            << " rows/s)";
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string IndexingPipeline::describeThroughputs() const {
+    std::ostringstream oStr;
+    oStr << _name << "Indexing pipeline with " << _nbOfWorkers << " worker thread(s): "
+         << _nbOfWrittenPOR << " POR out of " << _nbOfReadLines
+         << " parsed lines; ";
+    describeStageThroughput (oStr, "overall", _nbOfWrittenPOR, _elapsedTime);
+    oStr << "; ";
+    describeStageThroughput (oStr, "reading", _nbOfReadLines, _readingTime);
+    oStr << "; ";
+    describeStageThroughput (oStr, "parsing (cumulated over the workers)",
+                             _nbOfReadLines, _parsingTime);
+    oStr << "; ";
+    describeStageThroughput (oStr, "term sets (cumulated over the workers)",
+                             _nbOfWrittenPOR, _termBuildingTime);
+    oStr << "; ";
+    describeStageThroughput (oStr, "Xapian writing", _nbOfWrittenPOR,
+                             _xapianWritingTime);
+    oStr << "; ";
+    describeStageThroughput (oStr, "SQL writing", _nbOfWrittenPOR,
+                             _sqlWritingTime);
+    return oStr.str();
+  }
+
+}
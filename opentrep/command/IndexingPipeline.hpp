@@ -0,0 +1,287 @@
+#ifndef __OPENTREP_CMD_INDEXINGPIPELINE_HPP
+#define __OPENTREP_CMD_INDEXINGPIPELINE_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <istream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <exception>
+// Boost
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/PORParserType.hpp>
+
+/**
+ * Forward declarations
+ */
+// Xapian
+namespace Xapian {
+  class WritableDatabase;
+}
+
+// SOCI (for SQL database)
+namespace soci {
+  class session;
+}
+
+namespace OPENTREP {
+
+  // Forward declarations
+  class Place;
+  class OTransliterator;
+  class PlaceBulkLoader;
+
+  /**
+   * @brief Pipeline indexing the POR (points of reference) of a data file
+   *        with several threads.
+   *
+   * The pipeline is made of three stages:
+   * <ol>
+   *   <li>the calling thread reads the lines of the POR data file, and
+   *       numbers them in the order of the file;</li>
+   *   <li>several worker threads parse those lines and build the sets of
+   *       terms of the corresponding Place objects (transliteration and
+   *       word combinations), which is where most of the time is spent;</li>
+   *   <li>a single writer thread adds the documents to the Xapian index
+   *       and, if required, the POR to the SQL database, strictly in the
+   *       order of the file. Hence, the Xapian document IDs are the same
+   *       whatever the number of worker threads. The POR are loaded into
+   *       the SQL database in bulk (see PlaceBulkLoader).</li>
+   * </ol>
+   *
+   * The POR travel through a ring of slots, which bounds the number of
+   * POR being processed at once: a line is read only when the writer has
+   * released the slot of the line read that many lines before.
+   *
+   * The time spent by every stage is measured, and the corresponding
+   * throughputs (in rows per second) are reported at the end.
+   */
+  class IndexingPipeline {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param Xapian::WritableDatabase* Handle on the Xapian database/index
+     *                                  It is NULL when no use of Xapian.
+     * @param soci::session* SOCI session handler. It can be NULL when there
+     *                       is no use of SQL DB.
+     * @param const shouldIndexNonIATAPOR_T& Whether all POR should be indexed.
+     * @param const OTransliterator& Unicode transliterator, shared by the
+     *        worker threads.
+     * @param const PORParserType& Type of the parser of the POR records.
+     * @param const NbOfThreads_T& Number of worker threads (0 means the
+     *        number of hardware threads).
+     * @param const NbOfDBEntries_T& Maximal number of POR being processed
+     *        at once.
+     * @param const std::string& Prefix of the progress and throughput
+     *        messages (e.g., "[shard 2] "), when several pipelines run
+     *        at once.
+     */
+    IndexingPipeline (Xapian::WritableDatabase*, soci::session*,
+                      const shouldIndexNonIATAPOR_T&, const OTransliterator&,
+                      const PORParserType&, const NbOfThreads_T&,
+                      const NbOfDBEntries_T&,
+                      const std::string& iName = "");
+
+    /**
+     * Destructor.
+     */
+    ~IndexingPipeline();
+
+    /**
+     * Read, parse and index all the POR of the given stream.
+     *
+     * When any stage fails (e.g., parsing error), the whole pipeline
+     * is stopped, and the exception is re-thrown in the calling thread.
+     *
+     * @param std::istream& Stream of the POR data file.
+     * @return NbOfDBEntries_T Number of indexed POR.
+     */
+    NbOfDBEntries_T run (std::istream&);
+
+    /**
+     * Get a string describing the throughputs of every stage.
+     */
+    std::string describeThroughputs() const;
+
+
+  private:
+    /**
+     * State of a slot of the ring.
+     */
+    typedef enum {
+      FREE = 0,
+      READ,
+      BUILT,
+      SKIPPED,
+      LAST_VALUE
+    } EN_SlotState;
+
+    /**
+     * Slot of the ring, holding a POR from the reading of its line until
+     * the writing of its document.
+     */
+    struct Slot {
+      /**
+       * Place object, created once for all by the Place factory, and
+       * reset after every use.
+       */
+      Place* _place;
+
+      /**
+       * Line of the POR data file.
+       */
+      std::string _line;
+
+      /**
+       * Number of the lines skipped (POR not referenced by IATA) before
+       * that line.
+       */
+      NbOfDBEntries_T _nbOfSkippedLines;
+
+      /**
+       * State of the slot.
+       */
+      EN_SlotState _state;
+    };
+
+    /**
+     * Body of the worker threads: parse the lines, and build the sets of
+     * terms of the corresponding Place objects.
+     */
+    void work();
+
+    /**
+     * Body of the writer thread: add the Place objects to the Xapian
+     * index and/or to the SQL database, in the order of the file.
+     */
+    void write();
+
+    /**
+     * Stop the whole pipeline, after a failure of a stage. The exception
+     * currently handled is kept, so as to be re-thrown by run().
+     *
+     * \note The mutex must be locked by the caller, within the handler
+     *       of the exception (i.e., within the catch block).
+     */
+    void abort();
+
+
+  private:
+    // //////////////// Attributes ///////////////
+    /**
+     * Prefix of the progress and throughput messages.
+     */
+    const std::string _name;
+
+    /**
+     * Handle on the Xapian database/index (NULL when no use of Xapian).
+     */
+    Xapian::WritableDatabase* _xapianDB_ptr;
+
+    /**
+     * SOCI session handler (NULL when no use of SQL DB).
+     */
+    soci::session* _sociSession_ptr;
+
+    /**
+     * Bulk loader of the SQL database (NULL when no use of SQL DB).
+     */
+    PlaceBulkLoader* _bulkLoader_ptr;
+
+    /**
+     * Whether all the POR should be indexed.
+     */
+    const shouldIndexNonIATAPOR_T _includeNonIATAPOR;
+
+    /**
+     * Unicode transliterator.
+     */
+    const OTransliterator& _transliterator;
+
+    /**
+     * Type of the parser of the POR records.
+     */
+    const PORParserType _porParserType;
+
+    /**
+     * Number of worker threads.
+     */
+    NbOfThreads_T _nbOfWorkers;
+
+    /**
+     * Ring of slots.
+     */
+    std::vector<Slot> _slotList;
+
+    /**
+     * Sequence numbers of the read lines, waiting for a worker thread.
+     */
+    std::deque<NbOfDBEntries_T> _workQueue;
+
+    /**
+     * Number of read lines (i.e., sequence number of the next one).
+     */
+    NbOfDBEntries_T _nbOfReadLines;
+
+    /**
+     * Sequence number of the next line to be written.
+     */
+    NbOfDBEntries_T _nextLineToWrite;
+
+    /**
+     * Whether the whole POR data file has been read.
+     */
+    bool _isReadingOver;
+
+    /**
+     * Whether the pipeline has been stopped after a failure.
+     */
+    bool _isAborted;
+
+    /**
+     * Exception raised by the failing stage, if any.
+     */
+    std::exception_ptr _exception;
+
+    /**
+     * Mutex protecting the state of the pipeline, and the associated
+     * conditions, respectively signalled when a slot is released by the
+     * writer, when a line is read, and when a Place object is built.
+     */
+    boost::mutex _mutex;
+    boost::condition_variable _slotReleased;
+    boost::condition_variable _lineRead;
+    boost::condition_variable _placeBuilt;
+
+    /**
+     * Statistics: number of read lines, of skipped ones, and of written
+     * POR; time (in seconds) spent by every stage, cumulated over the
+     * threads of that stage.
+     */
+    NbOfDBEntries_T _nbOfSkippedLines;
+    NbOfDBEntries_T _nbOfWrittenPOR;
+    double _readingTime;
+    double _parsingTime;
+    double _termBuildingTime;
+    double _xapianWritingTime;
+    double _sqlWritingTime;
+    double _elapsedTime;
+  };
+
+  /**
+   * Describe the throughput of a stage of a pipeline (e.g., "parsing:
+   * 2.1s (57142 rows/s)").
+   */
+  void describeStageThroughput (std::ostream&, const std::string& iStageName,
+                                const NbOfDBEntries_T& iNbOfRows,
+                                const double iStageTime);
+
+}
+#endif // __OPENTREP_CMD_INDEXINGPIPELINE_HPP
@@ -0,0 +1,539 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <algorithm>
+#include <sstream>
+// Boost
+#include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/filesystem.hpp>
+// SOCI
+#include <soci/soci.h>
+#include <soci/sqlite3/soci-sqlite3.h>
+#include <soci/mysql/soci-mysql.h>
+// OpenTrep
+#include <opentrep/OPENTREP_exceptions.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/bom/Place.hpp>
+#include <opentrep/bom/LocationExchange.hpp>
+#include <opentrep/command/DBManager.hpp>
+#include <opentrep/command/PlaceBulkLoader.hpp>
+#include <opentrep/command/SerialisedPlaceBinding.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  PlaceRow::PlaceRow() : _uicCode (0) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PlaceRow::PlaceRow (const Place& iPlace,
+                      const SQLDBSchemaVersion_T& iSchemaVersion)
+    : _pk (iPlace.getKey().toString()),
+      _locationType (iPlace.getIataType().getTypeAsString()),
+      _iataCode (iPlace.getIataCode()), _icaoCode (iPlace.getIcaoCode()),
+      _faaCode (iPlace.getFaaCode()), _uicCode (0),
+      _isGeonames ((iPlace.isGeonames())?"Y":"N"),
+      _geonameID (boost::lexical_cast<std::string> (iPlace.getGeonamesID())),
+      _envelopeID (boost::lexical_cast<std::string> (iPlace.getEnvelopeID())),
+      _dateFrom (boost::gregorian::to_iso_extended_string (iPlace.
+                                                           getDateFrom())),
+      _dateEnd (boost::gregorian::to_iso_extended_string (iPlace.
+                                                          getDateEnd())) {
+
+    // The SQL databases created by a former version of OpenTREP hold
+    // the raw data strings of the POR
+    if (iSchemaVersion >= 2) {
+      _serialisedPlace =
+        LocationExchange::serialiseLocation (iPlace.getLocation());
+    } else {
+      _serialisedPlace = iPlace.getRawDataString();
+    }
+
+    /**
+     * Sometimes, there are several UN/LOCODE codes for a single POR,
+     * for instance USACX/USAIY for
+     * [Atlantic City](http://www.geonames.org/4500546),
+     * New Jersey (NJ), United States (US).
+     *
+     * Take the first of those codes, when existing.
+     *
+     * That may not be optimal, but there is no easy way to solve this.
+     * Indeed, we should either have a related table (with the IATA code
+     * and Geonames ID as foreign key)
+     * or de-normalize the tables, ie having one record per UN/LOCODE,
+     * which would therefore inhibit the unicity in the current primary key.
+     *
+     * Nevertheless, adding that UN/LOCODE in the database allows a fast
+     * retrieval from the database by searching on that code.
+     * But that use case corresponds to a rare usage from the command-line.
+     * Indeed, the UI (eg, http://search-travel.org) uses the full-text
+     * search API, not the direct retrieval from the database.
+     * The only cases when the UI uses the direct database retrieval
+     * is for IATA codes. The condition to trigger that API usage is
+     * to have only a sequence of 3-letter codes. As UN/LOCODE are
+     * 5-letter, the normal full-text serach API is used for UN/LOCODE codes.
+     */
+    const UNLOCodeList_T& lUNLOCodeList = iPlace.getUNLOCodeList();
+    if (lUNLOCodeList.empty() == false) {
+      const UNLOCode_T& lUNLOCode = lUNLOCodeList.front();
+      _unlocodeCode = static_cast<const std::string> (lUNLOCode);
+    }
+
+    /**
+     * Same remark as for UN/LOCODE above. The only difference is that
+     * UIC codes are integers rather than character strings.
+     */
+    const UICCodeList_T& lUICCodeList = iPlace.getUICCodeList();
+    if (lUICCodeList.empty() == false) {
+      const UICCode_T& lUICCode = lUICCodeList.front();
+      _uicCode = static_cast<const UICCode_T> (lUICCode);
+    }
+  }
+
+  /**
+   * Escape the given field for the default format of the MySQL
+   * LOAD DATA statement, i.e., fields separated by tabulations, lines
+   * by new lines, and special characters (including the NUL bytes of
+   * the Protobuf records) escaped by backslashes.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void writeEscapedField (std::ostream& ioStream, const std::string& iField) {
+    for (std::string::const_iterator itChar = iField.begin();
+         itChar != iField.end(); ++itChar) {
+      const char lChar = *itChar;
+      switch (lChar) {
+      case '\\': ioStream << "\\\\"; break;
+      case '\t': ioStream << "\\t"; break;
+      case '\n': ioStream << "\\n"; break;
+      case '\r': ioStream << "\\r"; break;
+      case '\0': ioStream << "\\0"; break;
+      default: ioStream << lChar; break;
+      }
+    }
+  }
+
+  /**
+   * Split a line of the temporary file into its (un-escaped) fields.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  std::vector<std::string> splitEscapedLine (const std::string& iLine) {
+    std::vector<std::string> oFieldList (1);
+    for (std::string::const_iterator itChar = iLine.begin();
+         itChar != iLine.end(); ++itChar) {
+      const char lChar = *itChar;
+      if (lChar == '\t') {
+        oFieldList.push_back ("");
+
+      } else if (lChar == '\\' && itChar + 1 != iLine.end()) {
+        ++itChar;
+        switch (*itChar) {
+        case 't': oFieldList.back() += '\t'; break;
+        case 'n': oFieldList.back() += '\n'; break;
+        case 'r': oFieldList.back() += '\r'; break;
+        case '0': oFieldList.back() += '\0'; break;
+        default: oFieldList.back() += *itChar; break;
+        }
+
+      } else {
+        oFieldList.back() += lChar;
+      }
+    }
+    return oFieldList;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PlaceBulkLoader::PlaceBulkLoader (soci::session& ioSociSession,
+                                    const NbOfDBEntries_T& iBatchSize)
+    : _sociSession (ioSociSession),
+      _dbType (ioSociSession.get_backend_name()),
+      _batchSize (iBatchSize), _isStarted (false), _nbOfRows (0),
+      _schemaVersion (K_SQL_DB_SCHEMA_VERSION), _formerSynchronous (2),
+      _insertStatement_ptr (NULL),
+      _boundPlaceRowList (K_DEFAULT_SQL_BULK_INSERT_NB_OF_ROWS) {
+    assert (_batchSize != 0 && _boundPlaceRowList.empty() == false);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PlaceBulkLoader::~PlaceBulkLoader() {
+    // The load has not been finished (e.g., because of a parsing error)
+    if (_isStarted == true) {
+      try {
+        cleanUp();
+
+      } catch (std::exception const& lException) {
+        OPENTREP_LOG_ERROR ("Error when cleaning up after the bulk load "
+                            << "of the SQL database: " << lException.what());
+      }
+    }
+
+    // The statement must be released before the bindings it uses
+    delete _insertStatement_ptr; _insertStatement_ptr = NULL;
+    for (std::vector<SerialisedPlaceBinding*>::iterator itSerialisedPlace =
+           _serialisedPlaceList.begin();
+         itSerialisedPlace != _serialisedPlaceList.end(); ++itSerialisedPlace) {
+      delete *itSerialisedPlace;
+    }
+    _serialisedPlaceList.clear();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PlaceBulkLoader::start() {
+    assert (_isStarted == false);
+    _isStarted = true;
+    _nbOfRows = 0;
+
+    try {
+
+      // The tables have normally just been created, with the current
+      // version of the schema
+      _schemaVersion = DBManager::getSQLDBSchemaVersion (_sociSession);
+
+      if (_dbType == DBType::SQLITE3) {
+        /**
+         * Keep the journal in memory, and do not synchronise the file
+         * with the disk, for the time of the load.
+           PRAGMA journal_mode = MEMORY;
+           PRAGMA synchronous = OFF;
+        */
+        _sociSession << "PRAGMA journal_mode", soci::into (_formerJournalMode);
+        _sociSession << "PRAGMA synchronous", soci::into (_formerSynchronous);
+        std::string lJournalMode;
+        _sociSession << "PRAGMA journal_mode = MEMORY",
+          soci::into (lJournalMode);
+        _sociSession << "PRAGMA synchronous = OFF";
+
+        // DEBUG
+        OPENTREP_LOG_DEBUG ("SQLite3 journal mode: " << _formerJournalMode
+                            << " => " << lJournalMode << "; synchronous: "
+                            << _formerSynchronous << " => 0 (OFF)");
+
+      } else if (_dbType == DBType::MYSQL) {
+        // The rows are written into a temporary file, loaded at the end
+        const boost::filesystem::path lDataFilePath =
+          boost::filesystem::temp_directory_path()
+          / boost::filesystem::unique_path ("opentrep-por-%%%%-%%%%-%%%%.tsv");
+        _dataFilePath = lDataFilePath.string();
+        _dataFile.open (_dataFilePath.c_str(),
+                        std::ios::out | std::ios::trunc | std::ios::binary);
+        if (_dataFile.is_open() == false) {
+          std::ostringstream errorStr;
+          errorStr << "The '" << _dataFilePath << "' temporary file cannot "
+                   << "be created";
+          throw SQLDatabaseException (errorStr.str());
+        }
+
+        // DEBUG
+        OPENTREP_LOG_DEBUG ("The POR are written into the '" << _dataFilePath
+                            << "' temporary file, before being loaded into "
+                            << "the MySQL/MariaDB database");
+      }
+
+    } catch (std::exception const& lException) {
+      std::ostringstream errorStr;
+      errorStr << "Error when preparing the " << _dbType.describe()
+               << " database for the bulk load: " << lException.what();
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SQLDatabaseException (errorStr.str());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PlaceBulkLoader::add (const Place& iPlace) {
+    assert (_isStarted == true);
+    const PlaceRow lPlaceRow (iPlace, _schemaVersion);
+
+    if (_dbType == DBType::MYSQL) {
+      // Write the row into the temporary file, with the columns in the
+      // order of the optd_por table
+      writeEscapedField (_dataFile, lPlaceRow._pk); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._locationType); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._iataCode); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._icaoCode); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._faaCode); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._unlocodeCode); _dataFile << '\t';
+      _dataFile << lPlaceRow._uicCode << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._isGeonames); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._geonameID); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._envelopeID); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._dateFrom); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._dateEnd); _dataFile << '\t';
+      writeEscapedField (_dataFile, lPlaceRow._serialisedPlace);
+      _dataFile << '\n';
+
+      if (_dataFile.good() == false) {
+        std::ostringstream errorStr;
+        errorStr << "Error when writing " << iPlace.toString() << " into the '"
+                 << _dataFilePath << "' temporary file";
+        OPENTREP_LOG_ERROR (errorStr.str());
+        throw SQLDatabaseException (errorStr.str());
+      }
+      ++_nbOfRows;
+
+    } else {
+      addToBatch (lPlaceRow);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PlaceBulkLoader::addToBatch (const PlaceRow& iPlaceRow) {
+    _placeRowList.push_back (iPlaceRow);
+
+    if (_placeRowList.size() >= _batchSize) {
+      flushBatch();
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  soci::statement* PlaceBulkLoader::
+  createInsertStatement (const NbOfDBEntries_T& iNbOfRows) {
+    assert (iNbOfRows != 0 && iNbOfRows <= _boundPlaceRowList.size()
+            && iNbOfRows <= _serialisedPlaceList.size());
+
+    /**
+       insert into optd_por values (:pk_0, :location_type_0, ...,
+                                    :serialised_place_pb_0),
+                                   (:pk_1, :location_type_1, ...,
+                                    :serialised_place_pb_1), ...;
+    */
+    const std::string& lSerialisedPlaceColumnName =
+      _serialisedPlaceList.front()->getColumnName();
+    std::ostringstream lSQLQueryStr;
+    lSQLQueryStr << "insert into optd_por values ";
+    for (NbOfDBEntries_T idx = 0; idx != iNbOfRows; ++idx) {
+      if (idx != 0) {
+        lSQLQueryStr << ", ";
+      }
+      lSQLQueryStr << "(:pk_" << idx << ", :location_type_" << idx
+                   << ", :iata_code_" << idx << ", :icao_code_" << idx
+                   << ", :faa_code_" << idx << ", :unlocode_code_" << idx
+                   << ", :uic_code_" << idx << ", :is_geonames_" << idx
+                   << ", :geoname_id_" << idx << ", :envelope_id_" << idx
+                   << ", :date_from_" << idx << ", :date_until_" << idx
+                   << ", :" << lSerialisedPlaceColumnName << "_" << idx
+                   << ")";
+    }
+
+    // The columns of the first rows are bound by reference, and read
+    // at every execution
+    soci::statement* oInsertStatement_ptr = new soci::statement (_sociSession);
+    try {
+      oInsertStatement_ptr->alloc();
+      oInsertStatement_ptr->prepare (lSQLQueryStr.str());
+      for (NbOfDBEntries_T idx = 0; idx != iNbOfRows; ++idx) {
+        PlaceRow& lBoundPlaceRow = _boundPlaceRowList[idx];
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow._pk));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow.
+                                                   _locationType));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow._iataCode));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow._icaoCode));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow._faaCode));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow.
+                                                   _unlocodeCode));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow._uicCode));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow.
+                                                   _isGeonames));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow._geonameID));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow.
+                                                   _envelopeID));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow._dateFrom));
+        oInsertStatement_ptr->exchange (soci::use (lBoundPlaceRow._dateEnd));
+        oInsertStatement_ptr->exchange (_serialisedPlaceList[idx]->use());
+      }
+      oInsertStatement_ptr->define_and_bind();
+
+    } catch (...) {
+      delete oInsertStatement_ptr;
+      throw;
+    }
+
+    return oInsertStatement_ptr;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PlaceBulkLoader::flushBatch() {
+    const NbOfDBEntries_T lNbOfRows = _placeRowList.size();
+    if (lNbOfRows == 0) {
+      return;
+    }
+
+    try {
+
+      // Create the bindings of the serialised places once for all, now
+      // that the version of the schema is known
+      const NbOfDBEntries_T lNbOfRowsPerInsert = _boundPlaceRowList.size();
+      while (_serialisedPlaceList.size() < lNbOfRowsPerInsert) {
+        _serialisedPlaceList.push_back (new SerialisedPlaceBinding
+                                        (_sociSession, _schemaVersion));
+      }
+
+      // Insert the whole batch within a single transaction, with as many
+      // rows as possible per execution of the insert statement
+      _sociSession.begin();
+      try {
+        for (NbOfDBEntries_T idxStart = 0; idxStart < lNbOfRows;
+             idxStart += lNbOfRowsPerInsert) {
+          const NbOfDBEntries_T lNbOfInsertedRows =
+            std::min (lNbOfRowsPerInsert, lNbOfRows - idxStart);
+
+          // Copy the rows into the bound columns
+          for (NbOfDBEntries_T idx = 0; idx != lNbOfInsertedRows; ++idx) {
+            PlaceRow& lBoundPlaceRow = _boundPlaceRowList[idx];
+            lBoundPlaceRow = _placeRowList[idxStart + idx];
+            _serialisedPlaceList[idx]->setSerialisedPlace (lBoundPlaceRow.
+                                                           _serialisedPlace);
+          }
+
+          if (lNbOfInsertedRows == lNbOfRowsPerInsert) {
+            // Prepare the insert statement of full size once for all
+            if (_insertStatement_ptr == NULL) {
+              _insertStatement_ptr = createInsertStatement (lNbOfRowsPerInsert);
+            }
+            assert (_insertStatement_ptr != NULL);
+            _insertStatement_ptr->execute (true);
+
+          } else {
+            // Remaining rows (normally, at the end of the load only)
+            boost::scoped_ptr<soci::statement>
+              lInsertStatement_ptr (createInsertStatement (lNbOfInsertedRows));
+            lInsertStatement_ptr->execute (true);
+          }
+        }
+
+      } catch (...) {
+        _sociSession.rollback();
+        throw;
+      }
+      _sociSession.commit();
+
+    } catch (std::exception const& lException) {
+      std::ostringstream errorStr;
+      errorStr << "Error when inserting a batch of " << lNbOfRows
+               << " POR (from " << _placeRowList.front()._pk << " to "
+               << _placeRowList.back()._pk << ") into the "
+               << _dbType.describe() << " database: " << lException.what();
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SQLDatabaseException (errorStr.str());
+    }
+
+    _nbOfRows += lNbOfRows;
+
+    // Empty the batch, keeping the memory already allocated
+    _placeRowList.clear();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PlaceBulkLoader::loadDataFile() {
+    _dataFile.close();
+
+    try {
+      /**
+         load data local infile '/tmp/opentrep-por-xxxx.tsv'
+         into table optd_por;
+      */
+      _sociSession.begin();
+      try {
+        _sociSession << "load data local infile '" << _dataFilePath
+                     << "' into table optd_por";
+
+      } catch (...) {
+        _sociSession.rollback();
+        throw;
+      }
+      _sociSession.commit();
+
+    } catch (std::exception const& lException) {
+      // The LOAD DATA LOCAL INFILE statement may not be allowed
+      OPENTREP_LOG_NOTIFICATION ("The '" << _dataFilePath
+                                 << "' temporary file cannot be loaded in "
+                                 << "one go (" << lException.what()
+                                 << "); its rows are therefore inserted "
+                                 << "by batches");
+      insertDataFile();
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PlaceBulkLoader::insertDataFile() {
+    std::ifstream lDataFile (_dataFilePath.c_str(), std::ios::binary);
+    if (lDataFile.is_open() == false) {
+      std::ostringstream errorStr;
+      errorStr << "The '" << _dataFilePath << "' temporary file cannot be read";
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SQLDatabaseException (errorStr.str());
+    }
+
+    _nbOfRows = 0;
+    std::string lLine;
+    while (std::getline (lDataFile, lLine)) {
+      const std::vector<std::string>& lFieldList = splitEscapedLine (lLine);
+      assert (lFieldList.size() == 13);
+
+      PlaceRow lPlaceRow;
+      lPlaceRow._pk = lFieldList[0];
+      lPlaceRow._locationType = lFieldList[1];
+      lPlaceRow._iataCode = lFieldList[2];
+      lPlaceRow._icaoCode = lFieldList[3];
+      lPlaceRow._faaCode = lFieldList[4];
+      lPlaceRow._unlocodeCode = lFieldList[5];
+      lPlaceRow._uicCode = boost::lexical_cast<UICCode_T> (lFieldList[6]);
+      lPlaceRow._isGeonames = lFieldList[7];
+      lPlaceRow._geonameID = lFieldList[8];
+      lPlaceRow._envelopeID = lFieldList[9];
+      lPlaceRow._dateFrom = lFieldList[10];
+      lPlaceRow._dateEnd = lFieldList[11];
+      lPlaceRow._serialisedPlace = lFieldList[12];
+      addToBatch (lPlaceRow);
+    }
+    flushBatch();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T PlaceBulkLoader::finish() {
+    assert (_isStarted == true);
+
+    if (_dbType == DBType::MYSQL) {
+      loadDataFile();
+
+    } else {
+      flushBatch();
+    }
+
+    _isStarted = false;
+    cleanUp();
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG (_nbOfRows << " POR have been loaded into the "
+                        << _dbType.describe() << " database");
+
+    return _nbOfRows;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void PlaceBulkLoader::cleanUp() {
+    _isStarted = false;
+
+    if (_dbType == DBType::SQLITE3 && _formerJournalMode.empty() == false) {
+      // Restore the former settings
+      std::string lJournalMode;
+      _sociSession << "PRAGMA journal_mode = " << _formerJournalMode,
+        soci::into (lJournalMode);
+      _sociSession << "PRAGMA synchronous = " << _formerSynchronous;
+      _formerJournalMode.clear();
+
+    } else if (_dbType == DBType::MYSQL && _dataFilePath.empty() == false) {
+      // Remove the temporary file
+      if (_dataFile.is_open() == true) {
+        _dataFile.close();
+      }
+      boost::system::error_code lErrorCode;
+      boost::filesystem::remove (_dataFilePath, lErrorCode);
+      _dataFilePath.clear();
+    }
+  }
+
+}
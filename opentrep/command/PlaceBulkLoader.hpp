@@ -0,0 +1,260 @@
+#ifndef __OPENTREP_CMD_PLACEBULKLOADER_HPP
+#define __OPENTREP_CMD_PLACEBULKLOADER_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+#include <vector>
+#include <fstream>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/DBType.hpp>
+
+/**
+ * Forward declarations
+ */
+// SOCI (for SQL database)
+namespace soci {
+  class session;
+  class statement;
+}
+
+namespace OPENTREP {
+
+  // Forward declarations
+  class Place;
+  class SerialisedPlaceBinding;
+
+  /**
+   * @brief Values of the columns of the optd_por table for a given POR
+   *        (point of reference).
+   */
+  struct PlaceRow {
+    /**
+     * Default constructor (all the columns being empty).
+     */
+    PlaceRow();
+
+    /**
+     * Constructor.
+     *
+     * @param const Place& The place to be inserted into the SQL database.
+     * @param const SQLDBSchemaVersion_T& Version of the schema of the SQL
+     *        database, which tells how the place is to be serialised.
+     */
+    PlaceRow (const Place&, const SQLDBSchemaVersion_T&);
+
+    // //////////////// Attributes ///////////////
+    std::string _pk;
+    std::string _locationType;
+    std::string _iataCode;
+    std::string _icaoCode;
+    std::string _faaCode;
+    std::string _unlocodeCode;
+    UICCode_T _uicCode;
+    std::string _isGeonames;
+    std::string _geonameID;
+    std::string _envelopeID;
+    std::string _dateFrom;
+    std::string _dateEnd;
+
+    /**
+     * Serialised place, i.e., the Protobuf record of the POR (see
+     * LocationExchange::serialiseLocation()) from the version 2 of
+     * the schema onwards, and its raw data string before.
+     */
+    std::string _serialisedPlace;
+  };
+
+
+  /**
+   * @brief Command loading, in bulk, the POR (points of reference) into
+   *        an empty SQL database.
+   *
+   * Inserting the POR one by one, each within its own transaction, is
+   * bound by the number of round trips to the SQL database and, with
+   * SQLite, by the number of synchronisations of the file with the disk.
+   * Hence, the POR are rather loaded:
+   * <ul>
+   *   <li>with SQLite, by batches of rows, each batch being inserted
+   *       within a single transaction, by a multi-row insert statement
+   *       (of K_DEFAULT_SQL_BULK_INSERT_NB_OF_ROWS rows), prepared once
+   *       and executed as many times as needed. The serialised places
+   *       being bound as BLOB (see SerialisedPlaceBinding), which SOCI
+   *       cannot bind as vectors, every row of the statement has its
+   *       own bound columns, rather than vectors. The journal is kept in
+   *       memory, and the file is not synchronised with the disk, during
+   *       the load; the former settings are restored at the end of the
+   *       load. Should the process crash in the meantime, the SQL database
+   *       would have to be rebuilt anyway;</li>
+   *   <li>with MySQL/MariaDB, from a temporary tab-separated file, written
+   *       along the way, and loaded in one go with the LOAD DATA LOCAL
+   *       INFILE statement. When that statement is not allowed (the
+   *       local_infile option is disabled on the server or on the client
+   *       side), the rows of the temporary file are inserted by batches,
+   *       as with SQLite.</li>
+   * </ul>
+   *
+   * The loader must be used by one thread only: start(), then add()
+   * for every POR, and finish(). When the loader is deleted before
+   * the end of the load (e.g., because of a parsing error), the former
+   * settings of the SQL database are restored, and the temporary file
+   * is removed, but the rows already loaded are kept.
+   */
+  class PlaceBulkLoader {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param soci::session& SOCI session handler.
+     * @param const NbOfDBEntries_T& Number of rows of every batch.
+     */
+    PlaceBulkLoader (soci::session&, const NbOfDBEntries_T& iBatchSize);
+
+    /**
+     * Destructor.
+     */
+    ~PlaceBulkLoader();
+
+    /**
+     * Prepare the SQL database for the load.
+     */
+    void start();
+
+    /**
+     * Add the given place to the load. The rows are actually inserted
+     * into the SQL database only once a batch is complete (or, with
+     * MySQL/MariaDB, at the end of the load).
+     *
+     * @param const Place& The place to be inserted.
+     */
+    void add (const Place&);
+
+    /**
+     * Insert the remaining rows, and restore the former settings of
+     * the SQL database.
+     *
+     * @return NbOfDBEntries_T Number of rows loaded into the SQL database.
+     */
+    NbOfDBEntries_T finish();
+
+  private:
+    /**
+     * Add the given row to the current batch, and insert that latter
+     * when it is complete.
+     */
+    void addToBatch (const PlaceRow&);
+
+    /**
+     * Create and prepare an insert statement of the given number of rows,
+     * the columns of which are bound to the first elements of
+     * _boundPlaceRowList and _serialisedPlaceList.
+     *
+     * @param const NbOfDBEntries_T& Number of rows inserted at once.
+     * @return soci::statement* The insert statement, to be deleted by
+     *         the caller.
+     */
+    soci::statement* createInsertStatement (const NbOfDBEntries_T& iNbOfRows);
+
+    /**
+     * Insert the current batch, within a single transaction.
+     */
+    void flushBatch();
+
+    /**
+     * Load the temporary file into the MySQL/MariaDB database.
+     */
+    void loadDataFile();
+
+    /**
+     * Insert, by batches, the rows of the temporary file, when that latter
+     * cannot be loaded in one go.
+     */
+    void insertDataFile();
+
+    /**
+     * Restore the former settings of the SQL database, and remove the
+     * temporary file, if any.
+     */
+    void cleanUp();
+
+  private:
+    /**
+     * Default constructor.
+     */
+    PlaceBulkLoader();
+
+    /**
+     * Default copy constructor.
+     */
+    PlaceBulkLoader (const PlaceBulkLoader&);
+
+  private:
+    // //////////////// Attributes ///////////////
+    /**
+     * SOCI session handler.
+     */
+    soci::session& _sociSession;
+
+    /**
+     * Type of the SQL database (SQLite3 or MySQL/MariaDB).
+     */
+    const DBType _dbType;
+
+    /**
+     * Number of rows of every batch.
+     */
+    const NbOfDBEntries_T _batchSize;
+
+    /**
+     * Whether the load has been started, and not finished yet.
+     */
+    bool _isStarted;
+
+    /**
+     * Number of rows loaded (or written into the temporary file) so far.
+     */
+    NbOfDBEntries_T _nbOfRows;
+
+    /**
+     * Version of the schema of the SQL database, retrieved when the load
+     * is started.
+     */
+    SQLDBSchemaVersion_T _schemaVersion;
+
+    /**
+     * Former journal mode and synchronisation level of SQLite.
+     */
+    std::string _formerJournalMode;
+    int _formerSynchronous;
+
+    /**
+     * Temporary file (for MySQL/MariaDB), and its path.
+     */
+    std::string _dataFilePath;
+    std::ofstream _dataFile;
+
+    /**
+     * Prepared insert statement of K_DEFAULT_SQL_BULK_INSERT_NB_OF_ROWS
+     * rows, re-used from one execution (and batch) to another.
+     */
+    soci::statement* _insertStatement_ptr;
+
+    /**
+     * Columns of the rows to be inserted at once, bound to the insert
+     * statements. The lists are never resized once the statements are
+     * prepared, as the columns are bound by reference.
+     */
+    std::vector<PlaceRow> _boundPlaceRowList;
+    std::vector<SerialisedPlaceBinding*> _serialisedPlaceList;
+
+    /**
+     * Rows of the current batch.
+     */
+    std::vector<PlaceRow> _placeRowList;
+  };
+
+}
+#endif // __OPENTREP_CMD_PLACEBULKLOADER_HPP
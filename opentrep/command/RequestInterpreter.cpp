@@ -6,14 +6,25 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <iterator>
 #include <exception>
 // Boost
 #include <boost/filesystem.hpp>
 #include <boost/regex.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+// Xapian
+#include <xapian.h>
 // SOCI
 #include <soci/soci.h>
 // OpenTrep
 #include <opentrep/DBType.hpp>
+#include <opentrep/OriginHint.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/Utilities.hpp>
 #include <opentrep/basic/OTransliterator.hpp>
 #include <opentrep/bom/Filter.hpp>
 #include <opentrep/bom/WordHolder.hpp>
@@ -24,6 +35,7 @@
 #include <opentrep/bom/PlaceHolder.hpp>
 #include <opentrep/bom/QuerySlices.hpp>
 #include <opentrep/bom/StringPartition.hpp>
+#include <opentrep/factory/FacBomScope.hpp>
 #include <opentrep/factory/FacPlaceHolder.hpp>
 #include <opentrep/factory/FacPlace.hpp>
 #include <opentrep/factory/FacResultCombination.hpp>
@@ -199,6 +211,11 @@ namespace OPENTREP {
       // DEBUG
       OPENTREP_LOG_DEBUG ("*********************");
 
+    } catch (const Xapian::DatabaseModifiedError&) {
+      // The Xapian database is reopened by the caller (see
+      // RequestInterpreter::interpretTravelRequest())
+      throw;
+
     } catch (const Xapian::Error& error) {
       // Error
       OPENTREP_LOG_ERROR ("Exception: "  << error.get_msg());
@@ -320,25 +337,98 @@ namespace OPENTREP {
   }
   
   /**
-   * Return the list of locations/places corresponding
-   * to the given IATA/ICAO/UNLOCODE codes or Geonames IDs.
+   * Classify the given word as a IATA/ICAO/UNLOCODE code or a Geonames ID,
+   * according to its form.
    *
+   * @param const std::string& The word (e.g., "nce", "lfmn", "6299418").
+   * @param DBManager::TypedCode_T& The code, along with its kind. A Geonames
+   *        ID is given in its canonical form (e.g., without leading zeros).
+   * @return bool Whether the word is a code or a Geonames ID.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  bool getTypedCode (const std::string& iWord,
+                     DBManager::TypedCode_T& ioTypedCode) {
+    // Check for IATA code: alpha{3}
+    const boost::regex lIATACodeExp ("^[[:alpha:]]{3}$");
+    const bool lMatchesWithIATACode = regex_match (iWord, lIATACodeExp);
+    if (lMatchesWithIATACode == true) {
+      ioTypedCode = DBManager::TypedCode_T (SelectStatementCache::IATA_CODE,
+                                            iWord);
+      return true;
+    }
+
+    // Check for ICAO code: (alpha|digit){4}
+    const boost::regex lICAOCodeExp ("^([[:alpha:]]|[[:digit:]]){4}$");
+    const bool lMatchesWithICAOCode = regex_match (iWord, lICAOCodeExp);
+    if (lMatchesWithICAOCode == true) {
+      ioTypedCode = DBManager::TypedCode_T (SelectStatementCache::ICAO_CODE,
+                                            iWord);
+      return true;
+    }
+
+    // Check for UN/LOCODE code: alpha{2}(alpha|digit){3}
+    const boost::regex
+      lUNLOCodeExp ("^[[:alpha:]]{2}([[:alpha:]]|[[:digit:]]){3}$");
+    const bool lMatchesWithUNLOCode = regex_match (iWord, lUNLOCodeExp);
+    if (lMatchesWithUNLOCode == true) {
+      ioTypedCode = DBManager::TypedCode_T (SelectStatementCache::UNLOCODE,
+                                            iWord);
+      return true;
+    }
+
+    // Check for Geonames ID: digit{1,12}
+    const boost::regex lGeoIDCodeExp ("^[[:digit:]]{1,12}$");
+    const bool lMatchesWithGeoID = regex_match (iWord, lGeoIDCodeExp);
+    if (lMatchesWithGeoID == true) {
+      try {
+        // Convert the character string into a number, and back, so
+        // that the Geonames ID be in its canonical form (e.g., without
+        // leading zeros)
+        const GeonamesID_T lGeonamesID =
+          boost::lexical_cast<GeonamesID_T> (iWord);
+        const std::string lGeonamesIDStr =
+          boost::lexical_cast<std::string> (lGeonamesID);
+        ioTypedCode = DBManager::TypedCode_T (SelectStatementCache::GEONAME_ID,
+                                              lGeonamesIDStr);
+        return true;
+
+      } catch (boost::bad_lexical_cast& eCast) {
+        OPENTREP_LOG_ERROR ("The Geoname ID ('" << iWord
+                            << "') cannot be understood.");
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * Return the list of locations/places corresponding to the given
+   * IATA/ICAO/UNLOCODE codes or Geonames IDs.
+   *
+   * @param SelectStatementCache* Statements prepared on the SQL database
+   *        session. When it is NULL, a session is opened with the given
+   *        SQL database type and connection string.
    * @param const DBType& SQL database type (can be no database at all).
    * @param const SQLDBConnectionString_T& SQL DB connection string.
-   * @param const WordList_T& List of IATA/ICAO/UNLOCODE codes or Geonames ID
-   *        (e.g., "sna 5391989 6299418 los chi cnshg lso rek lfmn iev mow").
+   * @param const DBManager::TypedCodeList_T& List of codes, along with
+   *        their kinds.
    * @param LocationList_T& The matching (geographical) locations, if any,
    *                        are added to that list.
-   * @param WordList_T& List of non-matched words of the query string.
    * @return NbOfMatches_T Number of matches.
    */
   // //////////////////////////////////////////////////////////////////////
-  NbOfMatches_T getLocationList (const DBType& iSQLDBType,
+  NbOfMatches_T getLocationList (SelectStatementCache* ioStatementCache_ptr,
+                                 const DBType& iSQLDBType,
                                  const SQLDBConnectionString_T& iSQLDBConnStr,
-                                 const WordList_T& iCodeList,
-                                 LocationList_T& ioLocationList,
-                                 WordList_T& ioWordList) {
-    NbOfMatches_T oNbOfMatches = 0;
+                                 const DBManager::TypedCodeList_T& iCodeList,
+                                 LocationList_T& ioLocationList) {
+    // Use the SQL database session of the caller, if any. The select
+    // statements are performed on the underlying SQL database, a single
+    // one for all the codes of a given kind
+    if (ioStatementCache_ptr != NULL) {
+      return DBManager::getPORByCodeList (*ioStatementCache_ptr, iCodeList,
+                                          ioLocationList);
+    }
 
     // Connect to the SQL database/file
     soci::session* lSociSession_ptr =
@@ -355,72 +445,271 @@ namespace OPENTREP {
     }
     assert (lSociSession_ptr != NULL);
 
-    // Browse the list of words/items
+    NbOfMatches_T oNbOfMatches = 0;
+    {
+      SelectStatementCache lStatementCache (*lSociSession_ptr);
+      oNbOfMatches = DBManager::getPORByCodeList (lStatementCache, iCodeList,
+                                                  ioLocationList);
+    }
+
+    // Release the SQL database connection, once its prepared statements
+    // have been released
+    DBManager::terminateSQLDBSession (iSQLDBType, iSQLDBConnStr,
+                                      *lSociSession_ptr);
+    delete lSociSession_ptr; lSociSession_ptr = NULL;
+
+    return oNbOfMatches;
+  }
+
+  /**
+   * Return the list of locations/places corresponding
+   * to the given IATA/ICAO/UNLOCODE codes or Geonames IDs.
+   *
+   * @param SelectStatementCache* Statements prepared on the SQL database
+   *        session. When it is NULL, a session is opened with the given
+   *        SQL database type and connection string.
+   * @param const DBType& SQL database type (can be no database at all).
+   * @param const SQLDBConnectionString_T& SQL DB connection string.
+   * @param const WordList_T& List of IATA/ICAO/UNLOCODE codes or Geonames ID
+   *        (e.g., "sna 5391989 6299418 los chi cnshg lso rek lfmn iev mow").
+   * @param LocationList_T& The matching (geographical) locations, if any,
+   *                        are added to that list.
+   * @param WordList_T& List of non-matched words of the query string.
+   * @return NbOfMatches_T Number of matches.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T getLocationList (SelectStatementCache* ioStatementCache_ptr,
+                                 const DBType& iSQLDBType,
+                                 const SQLDBConnectionString_T& iSQLDBConnStr,
+                                 const WordList_T& iCodeList,
+                                 LocationList_T& ioLocationList,
+                                 WordList_T& ioWordList) {
+    // Browse the list of words/items, so as to classify the codes
+    DBManager::TypedCodeList_T lTypedCodeList;
     for (WordList_T::const_iterator itWord = iCodeList.begin();
          itWord != iCodeList.end(); ++itWord) {
       const std::string& lWord = *itWord;
+      DBManager::TypedCode_T lTypedCode;
+      if (getTypedCode (lWord, lTypedCode) == true) {
+        lTypedCodeList.push_back (lTypedCode);
+      }
+    }
 
-      // Check for IATA code: alpha{3}
-      const boost::regex lIATACodeExp ("^[[:alpha:]]{3}$");
-      const bool lMatchesWithIATACode = regex_match (lWord, lIATACodeExp);
-      if (lMatchesWithIATACode == true) {
-        // Perform the select statement on the underlying SQL database
-        const IATACode_T lIATACode (lWord);
-        const bool lUniqueEntry = true;
-        const NbOfDBEntries_T& lNbOfEntries =
-          DBManager::getPORByIATACode (*lSociSession_ptr, lIATACode,
-                                       ioLocationList, lUniqueEntry);
-        oNbOfMatches += lNbOfEntries;
-        continue;
+    return getLocationList (ioStatementCache_ptr, iSQLDBType, iSQLDBConnStr,
+                            lTypedCodeList, ioLocationList);
+  }
+
+  /**
+   * Return the list of locations/places corresponding exactly to the given
+   * IATA/ICAO/UNLOCODE codes or Geonames IDs, from the Xapian index, when
+   * there is no SQL database.
+   *
+   * The IATA code and the Geonames ID of a POR are both part of the unique
+   * ID term of its document (e.g., "QNCE-CA-6299418-1", see IndexBuilder),
+   * so that the unique ID terms are browsed once for all those codes.
+   * The ICAO and UN/LOCODE codes are (lower-case) terms of the documents,
+   * the POR of which are then checked to actually bear those codes.
+   *
+   * As with DBManager::getPORByCodeList(), all the locations corresponding
+   * to a given code are added to the list, with that code as corrected
+   * keywords.
+   *
+   * @param const Xapian::Database& The Xapian index/database.
+   * @param const DBManager::TypedCodeList_T& List of codes, along with
+   *        their kinds.
+   * @param LocationList_T& The matching (geographical) locations, if any,
+   *                        are added to that list.
+   * @return NbOfMatches_T Number of matches.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T getLocationList (const Xapian::Database& iXapianDatabase,
+                                 const DBManager::TypedCodeList_T& iCodeList,
+                                 LocationList_T& ioLocationList) {
+    NbOfMatches_T oNbOfMatches = 0;
+
+    // Group the (upper-case) codes by kind
+    typedef std::set<std::string> CodeSet_T;
+    CodeSet_T lCodeSetList[SelectStatementCache::LAST_VALUE];
+    for (DBManager::TypedCodeList_T::const_iterator itCode =
+           iCodeList.begin(); itCode != iCodeList.end(); ++itCode) {
+      const DBManager::TypedCode_T& lTypedCode = *itCode;
+      const std::string lCodeUpper =
+        boost::algorithm::to_upper_copy (lTypedCode.second);
+      lCodeSetList[lTypedCode.first].insert (lCodeUpper);
+    }
+    const CodeSet_T& lIATACodeSet =
+      lCodeSetList[SelectStatementCache::IATA_CODE];
+    const CodeSet_T& lGeoIDSet = lCodeSetList[SelectStatementCache::GEONAME_ID];
+
+    // Documents corresponding to every code, for every kind
+    typedef std::multimap<std::string, Xapian::docid> DocIDMap_T;
+    DocIDMap_T lDocIDMapList[SelectStatementCache::LAST_VALUE];
+
+    // Browse the unique ID terms, for the IATA codes and Geonames IDs
+    if (lIATACodeSet.empty() == false || lGeoIDSet.empty() == false) {
+      const std::string& lPrefix = K_XAPIAN_UNIQUE_ID_TERM_PREFIX;
+      for (Xapian::TermIterator itTerm =
+             iXapianDatabase.allterms_begin (lPrefix);
+           itTerm != iXapianDatabase.allterms_end (lPrefix); ++itTerm) {
+        const std::string lUniqueIDTerm = *itTerm;
+        std::string lPK;
+        EnvelopeID_T lEnvelopeID = 0;
+        splitPORUniqueID (lUniqueIDTerm.substr (lPrefix.size()), lPK,
+                          lEnvelopeID);
+
+        // The primary key is made of the IATA code, the IATA location type
+        // and the Geonames ID (e.g., NCE-CA-6299418)
+        const std::string lIataCode = lPK.substr (0, lPK.find ('-'));
+        const std::string lGeonamesID = lPK.substr (lPK.rfind ('-') + 1);
+        const bool hasIATACode =
+          (lIATACodeSet.find (lIataCode) != lIATACodeSet.end());
+        const bool hasGeoID = (lGeoIDSet.find (lGeonamesID) != lGeoIDSet.end());
+        if (hasIATACode == false && hasGeoID == false) {
+          continue;
+        }
+
+        for (Xapian::PostingIterator itDocID =
+               iXapianDatabase.postlist_begin (lUniqueIDTerm);
+             itDocID != iXapianDatabase.postlist_end (lUniqueIDTerm);
+             ++itDocID) {
+          const Xapian::docid& lDocID = *itDocID;
+          if (hasIATACode == true) {
+            lDocIDMapList[SelectStatementCache::IATA_CODE].
+              insert (DocIDMap_T::value_type (lIataCode, lDocID));
+          }
+          if (hasGeoID == true) {
+            lDocIDMapList[SelectStatementCache::GEONAME_ID].
+              insert (DocIDMap_T::value_type (lGeonamesID, lDocID));
+          }
+        }
       }
+    }
 
-      // Check for ICAO code: (alpha|digit){4}
-      const boost::regex lICAOCodeExp ("^([[:alpha:]]|[[:digit:]]){4}$");
-      const bool lMatchesWithICAOCode = regex_match (lWord, lICAOCodeExp);
-      if (lMatchesWithICAOCode == true) {
-        // Perform the select statement on the underlying SQL database
-        const ICAOCode_T lICAOCode (lWord);
-        const NbOfDBEntries_T& lNbOfEntries =
-          DBManager::getPORByICAOCode (*lSociSession_ptr, lICAOCode,
-                                       ioLocationList);
-        oNbOfMatches += lNbOfEntries;
+    // Map the documents back onto the codes, in the order of those latter
+    for (DBManager::TypedCodeList_T::const_iterator itCode =
+           iCodeList.begin(); itCode != iCodeList.end(); ++itCode) {
+      const DBManager::TypedCode_T& lTypedCode = *itCode;
+      const SelectStatementCache::EN_LookupKind& lLookupKind = lTypedCode.first;
+      const std::string& lCode = lTypedCode.second;
+      const std::string lCodeUpper = boost::algorithm::to_upper_copy (lCode);
+
+      const bool isUniqueIDCode =
+        (lLookupKind == SelectStatementCache::IATA_CODE
+         || lLookupKind == SelectStatementCache::GEONAME_ID);
+      if (isUniqueIDCode == true) {
+        const DocIDMap_T& lDocIDMap = lDocIDMapList[lLookupKind];
+        std::pair<DocIDMap_T::const_iterator,
+                  DocIDMap_T::const_iterator> lDocIDRange =
+          lDocIDMap.equal_range (lCodeUpper);
+        for (DocIDMap_T::const_iterator itDocID = lDocIDRange.first;
+             itDocID != lDocIDRange.second; ++itDocID) {
+          const Xapian::Document lDoc =
+            iXapianDatabase.get_document (itDocID->second);
+          Location lLocation = Result::retrieveLocation (lDoc);
+          lLocation.setCorrectedKeywords (lCode);
+          ioLocationList.push_back (lLocation);
+          ++oNbOfMatches;
+        }
         continue;
       }
 
-      // Check for UN/LOCODE code: alpha{2}(alpha|digit){3}
-      const boost::regex
-        lUNLOCodeExp ("^[[:alpha:]]{2}([[:alpha:]]|[[:digit:]]){3}$");
-      const bool lMatchesWithUNLOCode = regex_match (lWord, lUNLOCodeExp);
-      if (lMatchesWithUNLOCode == true) {
-        // Perform the select statement on the underlying SQL database
-        const UNLOCode_T lUNLOCode (lWord);
-        const bool lUniqueEntry = true;
-        const NbOfDBEntries_T& lNbOfEntries =
-          DBManager::getPORByUNLOCode (*lSociSession_ptr, lUNLOCode,
-                                       ioLocationList, lUniqueEntry);
-        oNbOfMatches += lNbOfEntries;
+      // The ICAO and UN/LOCODE codes are indexed as (lower-case) terms,
+      // which may also be part of the names of other POR
+      const std::string lCodeTerm = boost::algorithm::to_lower_copy (lCode);
+      for (Xapian::PostingIterator itDocID =
+             iXapianDatabase.postlist_begin (lCodeTerm);
+           itDocID != iXapianDatabase.postlist_end (lCodeTerm); ++itDocID) {
+        const Xapian::Document lDoc = iXapianDatabase.get_document (*itDocID);
+        Location lLocation = Result::retrieveLocation (lDoc);
+
+        bool hasCode = false;
+        if (lLookupKind == SelectStatementCache::ICAO_CODE) {
+          hasCode = (lLocation.getIcaoCode() == lCodeUpper);
+        } else if (lLookupKind == SelectStatementCache::UNLOCODE) {
+          const UNLOCodeList_T& lUNLOCodeList = lLocation.getUNLOCodeList();
+          hasCode = (std::find (lUNLOCodeList.begin(), lUNLOCodeList.end(),
+                                lCodeUpper) != lUNLOCodeList.end());
+        }
+        if (hasCode == true) {
+          lLocation.setCorrectedKeywords (lCode);
+          ioLocationList.push_back (lLocation);
+          ++oNbOfMatches;
+        }
+      }
+    }
+
+    return oNbOfMatches;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T RequestInterpreter::
+  resolveCodeList (const Xapian::Database* iXapianDatabase_ptr,
+                   SelectStatementCache* ioStatementCache_ptr,
+                   const DBType& iSQLDBType,
+                   const SQLDBConnectionString_T& iSQLDBConnStr,
+                   const WordList_T& iCodeList,
+                   CodeLocationMap_T& ioLocationMap) {
+    NbOfMatches_T oNbOfMatches = 0;
+
+    // Classify the distinct codes
+    typedef std::map<std::string, DBManager::TypedCode_T> TypedCodeMap_T;
+    TypedCodeMap_T lTypedCodeMap;
+    DBManager::TypedCodeList_T lTypedCodeList;
+    for (WordList_T::const_iterator itWord = iCodeList.begin();
+         itWord != iCodeList.end(); ++itWord) {
+      const std::string& lWord = *itWord;
+      if (lTypedCodeMap.find (lWord) != lTypedCodeMap.end()) {
         continue;
-      }      
+      }
+      DBManager::TypedCode_T lTypedCode;
+      if (getTypedCode (lWord, lTypedCode) == true) {
+        lTypedCodeMap.insert (TypedCodeMap_T::value_type (lWord, lTypedCode));
+        lTypedCodeList.push_back (lTypedCode);
+      }
+    }
 
-      // Check for Geonames ID: digit{1,12}
-      const boost::regex lGeoIDCodeExp ("^[[:digit:]]{1,12}$");
-      const bool lMatchesWithGeoID = regex_match (lWord, lGeoIDCodeExp);
-      if (lMatchesWithGeoID == true) {
-        try {
-          // Convert the character string into a number
-          const GeonamesID_T lGeonamesID =
-            boost::lexical_cast<GeonamesID_T> (lWord);
-          
-          // Perform the select statement on the underlying SQL database
-          const NbOfDBEntries_T& lNbOfEntries =
-            DBManager::getPORByGeonameID (*lSociSession_ptr, lGeonamesID,
-                                          ioLocationList);
-          oNbOfMatches += lNbOfEntries;
+    // Retrieve the locations corresponding to those codes, from the SQL
+    // database if any, or else from the Xapian index
+    LocationList_T lLocationList;
+    if (!(iSQLDBType == DBType::NODB)) {
+      getLocationList (ioStatementCache_ptr, iSQLDBType, iSQLDBConnStr,
+                       lTypedCodeList, lLocationList);
 
-        } catch (boost::bad_lexical_cast& eCast) {
-          OPENTREP_LOG_ERROR ("The Geoname ID ('" << lWord
-                              << "') cannot be understood.");
-        }
+    } else if (iXapianDatabase_ptr != NULL) {
+      getLocationList (*iXapianDatabase_ptr, lTypedCodeList, lLocationList);
+    }
+
+    // Gather the locations by code, those latter being the corrected
+    // keywords of the locations
+    typedef std::map<std::string, LocationList_T> LocationListMap_T;
+    LocationListMap_T lLocationListMap;
+    for (LocationList_T::const_iterator itLocation = lLocationList.begin();
+         itLocation != lLocationList.end(); ++itLocation) {
+      const Location& lLocation = *itLocation;
+      lLocationListMap[lLocation.getCorrectedKeywords()].push_back (lLocation);
+    }
+
+    // Keep a single location for every code
+    for (TypedCodeMap_T::const_iterator itCode = lTypedCodeMap.begin();
+         itCode != lTypedCodeMap.end(); ++itCode) {
+      const std::string& lWord = itCode->first;
+      const DBManager::TypedCode_T& lTypedCode = itCode->second;
+      const LocationListMap_T::const_iterator itLocationList =
+        lLocationListMap.find (lTypedCode.second);
+      if (itLocationList == lLocationListMap.end()) {
+        continue;
+      }
+
+      // Only a UN/LOCODE code requires a POR with a non-zero Page Rank
+      // (see DBManager::getPORByCodeList())
+      const bool lKeepZeroPR =
+        !(lTypedCode.first == SelectStatementCache::UNLOCODE);
+      const Location* lLocation_ptr =
+        DBManager::getHighestPRLocation (itLocationList->second, lKeepZeroPR);
+      if (lLocation_ptr != NULL) {
+        ioLocationMap.insert (CodeLocationMap_T::value_type (lWord,
+                                                             *lLocation_ptr));
+        ++oNbOfMatches;
       }
     }
 
@@ -435,7 +724,8 @@ namespace OPENTREP {
                           const TravelQuery_T& iTravelQuery,
                           LocationList_T& ioLocationList,
                           WordList_T& ioWordList,
-                          const OTransliterator& iTransliterator) {
+                          const OTransliterator& iTransliterator,
+                          const OriginHint& iOriginHint) {
     NbOfMatches_T oNbOfMatches = 0;
 
     // Sanity check
@@ -460,13 +750,97 @@ namespace OPENTREP {
     // Open the Xapian database
     Xapian::Database lXapianDatabase (iTravelDBFilePath);
 
+    // Delegate the interpretation, the SQL database session being opened
+    // only when needed
+    oNbOfMatches = interpretTravelRequest (lXapianDatabase, NULL, iSQLDBType,
+                                           iSQLDBConnStr, iTravelQuery,
+                                           ioLocationList, ioWordList,
+                                           iTransliterator, iOriginHint);
+    return oNbOfMatches;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T RequestInterpreter::
+  interpretTravelRequest (Xapian::Database& ioXapianDatabase,
+                          SelectStatementCache* ioStatementCache_ptr,
+                          const DBType& iSQLDBType,
+                          const SQLDBConnectionString_T& iSQLDBConnStr,
+                          const TravelQuery_T& iTravelQuery,
+                          LocationList_T& ioLocationList,
+                          WordList_T& ioWordList,
+                          const OTransliterator& iTransliterator,
+                          const OriginHint& iOriginHint) {
+    const LocationList_T::size_type lNbOfLocations = ioLocationList.size();
+    const WordList_T::size_type lNbOfWords = ioWordList.size();
+
+    try {
+      return interpretTravelRequestOnce (ioXapianDatabase, ioStatementCache_ptr,
+                                         iSQLDBType, iSQLDBConnStr,
+                                         iTravelQuery, ioLocationList,
+                                         ioWordList, iTransliterator,
+                                         iOriginHint);
+
+    } catch (const Xapian::DatabaseModifiedError& error) {
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("The Xapian database has been modified during the "
+                          << "interpretation of '" << iTravelQuery << "' ("
+                          << error.get_msg() << "). It is reopened, and the "
+                          << "travel query is interpreted again");
+    }
+
+    // Forget about what the first attempt has found
+    LocationList_T::iterator itLocation = ioLocationList.begin();
+    std::advance (itLocation, lNbOfLocations);
+    ioLocationList.erase (itLocation, ioLocationList.end());
+    WordList_T::iterator itWord = ioWordList.begin();
+    std::advance (itWord, lNbOfWords);
+    ioWordList.erase (itWord, ioWordList.end());
+
+    try {
+      ioXapianDatabase.reopen();
+      return interpretTravelRequestOnce (ioXapianDatabase, ioStatementCache_ptr,
+                                         iSQLDBType, iSQLDBConnStr,
+                                         iTravelQuery, ioLocationList,
+                                         ioWordList, iTransliterator,
+                                         iOriginHint);
+
+    } catch (const Xapian::DatabaseModifiedError& error) {
+      // The Xapian index is being modified too often to be searched
+      OPENTREP_LOG_ERROR ("Exception: "  << error.get_msg());
+      throw XapianException (error.get_msg());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T RequestInterpreter::
+  interpretTravelRequestOnce (const Xapian::Database& iXapianDatabase,
+                              SelectStatementCache* ioStatementCache_ptr,
+                              const DBType& iSQLDBType,
+                              const SQLDBConnectionString_T& iSQLDBConnStr,
+                              const TravelQuery_T& iTravelQuery,
+                              LocationList_T& ioLocationList,
+                              WordList_T& ioWordList,
+                              const OTransliterator& iTransliterator,
+                              const OriginHint& iOriginHint) {
+    NbOfMatches_T oNbOfMatches = 0;
+
+    // Sanity check
+    assert (iTravelQuery.empty() == false);
+
+    // The BOM objects (e.g., Result, Place) created for the interpretation
+    // of the travel query belong to it, and are deleted when it is over.
+    // Only the Location structures, which are copies, are handed over to
+    // the caller. Hence, several threads may search at once, and the
+    // memory does not grow from one search to another.
+    FacBomScope lBomScope;
+
     // DEBUG
     OPENTREP_LOG_DEBUG (std::endl
                         << "=========================================");
       
     // First, cut the travel query in slices and calculate all the partitions
     // for each of those query slices
-    QuerySlices lQuerySlices (lXapianDatabase, iTravelQuery, iTransliterator);
+    QuerySlices lQuerySlices (iXapianDatabase, iTravelQuery, iTransliterator);
 
     // DEBUG
     OPENTREP_LOG_DEBUG ("+=+=+=+=+=+=+=+=+=+=+=+=+=+=+");
@@ -477,6 +851,9 @@ namespace OPENTREP {
                           << "'");
     }
     OPENTREP_LOG_DEBUG ("Query slices: `" << lQuerySlices << "'");
+    if (iOriginHint.isEmpty() == false) {
+      OPENTREP_LOG_DEBUG ("Origin hint: " << iOriginHint);
+    }
 
     // Browse the travel query slices
     const StringPartitionList_T& lStringPartitionList =
@@ -525,7 +902,8 @@ namespace OPENTREP {
                             << ") will be used. "
                             << "The Xapian database/index will not be used");
 
-        lNbOfMatches = getLocationList (iSQLDBType, iSQLDBConnStr, lCodeList,
+        lNbOfMatches = getLocationList (ioStatementCache_ptr, iSQLDBType,
+                                        iSQLDBConnStr, lCodeList,
                                         ioLocationList, ioWordList);
       }
 
@@ -555,13 +933,13 @@ namespace OPENTREP {
          * 1.1. Perform all the full-text matches, and fill accordingly the
          *      list of Result instances.
          */
-        OPENTREP::searchString (lTravelQuerySlice, lXapianDatabase,
+        OPENTREP::searchString (lTravelQuerySlice, iXapianDatabase,
                                 lResultCombination, ioWordList);
 
         /**
          * 1.2. Calculate/set all the weights for all the matching documents
          */
-        lResultCombination.calculateAllWeights();
+        lResultCombination.calculateAllWeights (iOriginHint);
 
         /**
          * 2. Calculate the best matching scores / weighting percentages.
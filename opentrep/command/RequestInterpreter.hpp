@@ -4,14 +4,33 @@
 // //////////////////////////////////////////////////////////////////////
 // Import section
 // //////////////////////////////////////////////////////////////////////
+// STL
+#include <map>
+#include <string>
 // OpenTrep
 #include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/Location.hpp>
 #include <opentrep/LocationList.hpp>
 
+/**
+ * Forward declarations
+ */
+// Xapian
+namespace Xapian {
+  class Database;
+}
+
+// SOCI (for SQL database)
+namespace soci {
+  class session;
+}
+
 namespace OPENTREP {
 
   // Forward declarations
   class OTransliterator;
+  class SelectStatementCache;
+  struct OriginHint;
 
   /**
    * @brief Command wrapping the travel request process.
@@ -32,6 +51,42 @@ namespace OPENTREP {
      */
     static bool areAllCodeOrGeoID (const TravelQuery_T&, WordList_T&);
 
+    /**
+     * Location, for every code (e.g., "nce", "LFMN", "6299418").
+     */
+    typedef std::map<std::string, Location> CodeLocationMap_T;
+
+    /**
+     * Resolve exactly every given IATA/ICAO/UNLOCODE code or Geonames ID
+     * into a single location, rather than interpreting them as a (fuzzy)
+     * travel query.
+     *
+     * The codes are looked up in the SQL database (see
+     * DBManager::getPORByCodeList()). Only when there is no SQL database
+     * are they looked up in the Xapian index. When several POR correspond
+     * to a given code (e.g., SFO gives both the airport and the city),
+     * the one having the greatest Page Rank is kept (see
+     * DBManager::getHighestPRLocation()).
+     *
+     * @param const Xapian::Database* The Xapian index/database, used only
+     *        when there is no SQL database.
+     * @param SelectStatementCache* Statements prepared on the SQL database
+     *        session. When it is NULL, a session is opened with the given
+     *        SQL database type and connection string, if needed.
+     * @param const DBType& SQL database type (can be no database at all).
+     * @param const SQLDBConnectionString_T& SQL DB connection string.
+     * @param const WordList_T& List of codes. The words, which are not
+     *        codes, or for which no POR exists, are not resolved.
+     * @param CodeLocationMap_T& The location of every resolved code.
+     * @return NbOfMatches_T Number of (distinct) resolved codes.
+     */
+    static NbOfMatches_T resolveCodeList (const Xapian::Database*,
+                                          SelectStatementCache*,
+                                          const DBType&,
+                                          const SQLDBConnectionString_T&,
+                                          const WordList_T&,
+                                          CodeLocationMap_T&);
+
     /**
      * Interpret the given string, thanks to various pieces of algorithm,
      * including a full-text search on the underlying Xapian index (named
@@ -46,6 +101,9 @@ namespace OPENTREP {
      *        matching the given query string.
      * @param WordList_T& List of non-matched words of the query string.
      * @param const OTransliterator& Unicode transliterator.
+     * @param const OriginHint& Origin of the travel request, as given by
+     *        the caller (it may be empty), biasing the ranking of the
+     *        matching POR (points of reference).
      * @return NbOfMatches_T Number of matches.
      */
     static NbOfMatches_T interpretTravelRequest (const TravelDBFilePath_T&,
@@ -53,7 +111,55 @@ namespace OPENTREP {
                                                  const SQLDBConnectionString_T&,
                                                  const TravelQuery_T&,
                                                  LocationList_T&, WordList_T&,
-                                                 const OTransliterator&);
+                                                 const OTransliterator&,
+                                                 const OriginHint&);
+
+    /**
+     * Interpret the given string, on an already opened Xapian database
+     * and, if any, SQL database session (e.g., kept open by the services
+     * for the successive searches, see SearchIndexHandle).
+     *
+     * When the Xapian index has been modified in the meantime (e.g., by
+     * IndexUpdater), so that the revision of the Xapian database is no
+     * longer available (Xapian::DatabaseModifiedError), the Xapian database
+     * is reopened on its latest revision, and the string is interpreted
+     * again, once. The locations and words found by the first attempt are
+     * then discarded.
+     *
+     * @param Xapian::Database& The Xapian index/database.
+     * @param SelectStatementCache* Statements prepared on the SQL database
+     *        session. When it is NULL, a session is opened with the given
+     *        SQL database type and connection string, if needed.
+     * @param const DBType& SQL database type (can be no database at all).
+     * @param const SQLDBConnectionString_T& SQL DB connection string.
+     * @param const std::string& (Travel-related) query string.
+     * @param LocationList_T& List of (geographical) locations, if any,
+     *        matching the given query string.
+     * @param WordList_T& List of non-matched words of the query string.
+     * @param const OTransliterator& Unicode transliterator.
+     * @param const OriginHint& Origin of the travel request (may be empty).
+     * @return NbOfMatches_T Number of matches.
+     */
+    static NbOfMatches_T interpretTravelRequest (Xapian::Database&,
+                                                 SelectStatementCache*,
+                                                 const DBType&,
+                                                 const SQLDBConnectionString_T&,
+                                                 const TravelQuery_T&,
+                                                 LocationList_T&, WordList_T&,
+                                                 const OTransliterator&,
+                                                 const OriginHint&);
+
+    /**
+     * Interpret the given string on the current revision of the given
+     * Xapian database (see above for the parameters).
+     */
+    static NbOfMatches_T
+    interpretTravelRequestOnce (const Xapian::Database&,
+                                SelectStatementCache*,
+                                const DBType&, const SQLDBConnectionString_T&,
+                                const TravelQuery_T&,
+                                LocationList_T&, WordList_T&,
+                                const OTransliterator&, const OriginHint&);
 
   private:
     /**
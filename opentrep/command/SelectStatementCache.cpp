@@ -0,0 +1,155 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+// SOCI
+#include <soci/soci.h>
+// OpenTrep
+#include <opentrep/OPENTREP_exceptions.hpp>
+#include <opentrep/Location.hpp>
+#include <opentrep/CityDetails.hpp>
+#include <opentrep/command/DBManager.hpp>
+#include <opentrep/command/SelectStatementCache.hpp>
+#include <opentrep/command/SerialisedPlaceBinding.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  SelectStatementCache::SelectStatementCache (soci::session& ioSociSession)
+    : _sociSession (ioSociSession), _schemaVersion (0),
+      _uicCode (0), _geonameID (0), _serialisedPlace_ptr (NULL) {
+    for (unsigned short idx = 0; idx != LAST_VALUE; ++idx) {
+      _statementList[idx] = NULL;
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SelectStatementCache::~SelectStatementCache() {
+    for (unsigned short idx = 0; idx != LAST_VALUE; ++idx) {
+      delete _statementList[idx]; _statementList[idx] = NULL;
+    }
+    delete _serialisedPlace_ptr; _serialisedPlace_ptr = NULL;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const SQLDBSchemaVersion_T& SelectStatementCache::getSchemaVersion() {
+    if (_schemaVersion == 0) {
+      _schemaVersion = DBManager::getSQLDBSchemaVersion (_sociSession);
+    }
+    return _schemaVersion;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SerialisedPlaceBinding& SelectStatementCache::getSerialisedPlace() {
+    if (_serialisedPlace_ptr == NULL) {
+      _serialisedPlace_ptr = new SerialisedPlaceBinding (_sociSession,
+                                                         getSchemaVersion());
+    }
+    return *_serialisedPlace_ptr;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  soci::statement& SelectStatementCache::
+  selectOnCode (const EN_LookupKind& iLookupKind, const std::string& iCode) {
+    assert (iLookupKind != UIC_CODE && iLookupKind != GEONAME_ID);
+    _code = iCode;
+    return select (iLookupKind);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  soci::statement& SelectStatementCache::
+  selectOnUICCode (const UICCode_T& iUICCode) {
+    _uicCode = iUICCode;
+    return select (UIC_CODE);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  soci::statement& SelectStatementCache::
+  selectOnGeonameID (const GeonamesID_T& iGeonameID) {
+    _geonameID = iGeonameID;
+    return select (GEONAME_ID);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  soci::statement& SelectStatementCache::
+  select (const EN_LookupKind& iLookupKind) {
+    soci::statement*& lStatement_ptr = _statementList[iLookupKind];
+
+    // Re-execute the already prepared statement, with the new value
+    // of the parameter
+    if (lStatement_ptr != NULL) {
+      try {
+        lStatement_ptr->execute();
+        return *lStatement_ptr;
+
+      } catch (std::exception const& lException) {
+        // The statement is prepared again below (e.g., after the loss
+        // of the connection)
+        OPENTREP_LOG_DEBUG ("The prepared statement #" << iLookupKind
+                            << " could not be re-executed ("
+                            << lException.what() << "); it is prepared "
+                            << "again");
+        delete lStatement_ptr; lStatement_ptr = NULL;
+      }
+    }
+
+    // Prepare (and execute) the statement, the parameters being bound
+    // to the attributes of the cache
+    SerialisedPlaceBinding& lSerialisedPlace = getSerialisedPlace();
+    lStatement_ptr = new soci::statement (_sociSession);
+    try {
+      switch (iLookupKind) {
+      case IATA_CODE:
+        DBManager::prepareSelectBlobOnIataCodeStatement (_sociSession,
+                                                         *lStatement_ptr,
+                                                         _code,
+                                                         lSerialisedPlace);
+        break;
+      case ICAO_CODE:
+        DBManager::prepareSelectBlobOnIcaoCodeStatement (_sociSession,
+                                                         *lStatement_ptr,
+                                                         _code,
+                                                         lSerialisedPlace);
+        break;
+      case FAA_CODE:
+        DBManager::prepareSelectBlobOnFaaCodeStatement (_sociSession,
+                                                        *lStatement_ptr,
+                                                        _code,
+                                                        lSerialisedPlace);
+        break;
+      case UNLOCODE:
+        DBManager::prepareSelectBlobOnUNLOCodeStatement (_sociSession,
+                                                         *lStatement_ptr,
+                                                         _code,
+                                                         lSerialisedPlace);
+        break;
+      case UIC_CODE:
+        DBManager::prepareSelectBlobOnUICCodeStatement (_sociSession,
+                                                        *lStatement_ptr,
+                                                        _uicCode,
+                                                        lSerialisedPlace);
+        break;
+      case GEONAME_ID:
+        DBManager::
+          prepareSelectBlobOnPlaceGeoIDStatement (_sociSession,
+                                                  *lStatement_ptr, _geonameID,
+                                                  lSerialisedPlace);
+        break;
+      default:
+        assert (false);
+        break;
+      }
+
+    } catch (...) {
+      delete lStatement_ptr; lStatement_ptr = NULL;
+      throw;
+    }
+
+    assert (lStatement_ptr != NULL);
+    return *lStatement_ptr;
+  }
+
+}
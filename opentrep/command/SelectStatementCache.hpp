@@ -0,0 +1,170 @@
+#ifndef __OPENTREP_CMD_SELECTSTATEMENTCACHE_HPP
+#define __OPENTREP_CMD_SELECTSTATEMENTCACHE_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+
+// Forward declarations
+namespace soci {
+  class session;
+  class statement;
+}
+
+namespace OPENTREP {
+
+  // Forward declarations
+  class SerialisedPlaceBinding;
+
+  /**
+   * @brief Prepared statements, looking up the POR by code, of a given
+   *        SQL database session.
+   *
+   * Each kind of look-up (by IATA code, ICAO code, etc) has its own
+   * statement, prepared on the first look-up of that kind, and then
+   * re-executed for every later look-up of that kind: the parameters
+   * are bound by reference to the attributes of the cache, and only
+   * their values change from one look-up to another. With SQLite, that
+   * spares the compilation of the SQL query on every look-up.
+   *
+   * As the SQL session itself, the cache may be used by a single thread
+   * at once; and a statement must be fully fetched (see
+   * DBManager::iterateOnStatement()) before the next look-up of the
+   * same kind. The cache is held by the owner of the session (e.g.,
+   * the connections of SearchIndexHandle), and must be deleted before
+   * that latter session is closed.
+   */
+  class SelectStatementCache {
+  public:
+    /**
+     * Kind of look-up.
+     */
+    typedef enum {
+      IATA_CODE = 0,
+      ICAO_CODE,
+      FAA_CODE,
+      UNLOCODE,
+      UIC_CODE,
+      GEONAME_ID,
+      LAST_VALUE
+    } EN_LookupKind;
+
+  public:
+    // /////////// Getters ////////////
+    /**
+     * Get the SQL database session, on which the statements are prepared.
+     */
+    soci::session& getSociSession() const {
+      return _sociSession;
+    }
+
+    /**
+     * Get the serialised place, bound to the statements. It holds the
+     * serialised place of the current row, once retrieved (see
+     * DBManager::iterateOnStatement()).
+     */
+    SerialisedPlaceBinding& getSerialisedPlace();
+
+    /**
+     * Get the version of the schema of the SQL database, which tells
+     * how the serialised places are to be decoded (see
+     * DBManager::getSQLDBSchemaVersion()). It is retrieved from the SQL
+     * database on the first call only.
+     */
+    const SQLDBSchemaVersion_T& getSchemaVersion();
+
+  public:
+    // /////////// Business methods ////////////
+    /**
+     * Execute the statement looking up the POR by the given (string) code.
+     *
+     * @param const EN_LookupKind& Kind of code (all but UIC_CODE and
+     *        GEONAME_ID).
+     * @param const std::string& The code (e.g., "NCE", "LFMN").
+     * @return soci::statement& The executed statement, the rows of which
+     *         are to be fetched.
+     */
+    soci::statement& selectOnCode (const EN_LookupKind&, const std::string&);
+
+    /**
+     * Execute the statement looking up the POR by UIC code.
+     */
+    soci::statement& selectOnUICCode (const UICCode_T&);
+
+    /**
+     * Execute the statement looking up the POR by Geonames ID.
+     */
+    soci::statement& selectOnGeonameID (const GeonamesID_T&);
+
+  public:
+    // /////////// Constructors and destructors ////////////
+    /**
+     * Constructor.
+     *
+     * @param soci::session& SOCI session handler, which must outlive
+     *        the cache.
+     */
+    SelectStatementCache (soci::session&);
+
+    /**
+     * Destructor.
+     */
+    ~SelectStatementCache();
+
+  private:
+    /**
+     * Default constructor.
+     */
+    SelectStatementCache();
+
+    /**
+     * Default copy constructor.
+     */
+    SelectStatementCache (const SelectStatementCache&);
+
+    /**
+     * Execute the statement of the given kind, after having prepared it,
+     * if needed.
+     */
+    soci::statement& select (const EN_LookupKind&);
+
+  private:
+    // //////////////// Attributes //////////////////
+    /**
+     * SOCI session handler.
+     */
+    soci::session& _sociSession;
+
+    /**
+     * Version of the schema of the SQL database, retrieved when the first
+     * statement is prepared (zero until then), so that the creation of
+     * the cache does not cost any SQL query.
+     */
+    SQLDBSchemaVersion_T _schemaVersion;
+
+    /**
+     * Prepared statements (NULL when not prepared yet), one per kind
+     * of look-up.
+     */
+    soci::statement* _statementList[LAST_VALUE];
+
+    /**
+     * Parameters, bound to the statements.
+     */
+    std::string _code;
+    UICCode_T _uicCode;
+    GeonamesID_T _geonameID;
+
+    /**
+     * Serialised place, bound to the statements (NULL until the first
+     * statement is prepared).
+     */
+    SerialisedPlaceBinding* _serialisedPlace_ptr;
+  };
+
+}
+#endif // __OPENTREP_CMD_SELECTSTATEMENTCACHE_HPP
@@ -0,0 +1,80 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+// SOCI
+#include <soci/soci.h>
+// OpenTrep
+#include <opentrep/DBType.hpp>
+#include <opentrep/command/SerialisedPlaceBinding.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  SerialisedPlaceBinding::
+  SerialisedPlaceBinding (soci::session& ioSociSession,
+                          const SQLDBSchemaVersion_T& iSchemaVersion)
+    : _schemaVersion (iSchemaVersion), _blob_ptr (NULL) {
+    const DBType lDBType (ioSociSession.get_backend_name());
+    if (_schemaVersion >= 2 && lDBType == DBType::SQLITE3) {
+      _blob_ptr = new soci::blob (ioSociSession);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SerialisedPlaceBinding::~SerialisedPlaceBinding() {
+    delete _blob_ptr; _blob_ptr = NULL;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string SerialisedPlaceBinding::getColumnName() const {
+    const std::string oColumnName = (_schemaVersion >= 2)?
+      "serialised_place_pb":"serialised_place";
+    return oColumnName;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void SerialisedPlaceBinding::
+  setSerialisedPlace (const std::string& iSerialisedPlace) {
+    _serialisedPlace = iSerialisedPlace;
+
+    if (_blob_ptr != NULL) {
+      // Writing into the BLOB does not shrink it: it is emptied first
+      _blob_ptr->trim (0);
+      if (_serialisedPlace.empty() == false) {
+        _blob_ptr->write (0, _serialisedPlace.data(), _serialisedPlace.size());
+      }
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  soci::details::into_type_ptr SerialisedPlaceBinding::into() {
+    if (_blob_ptr != NULL) {
+      return soci::into (*_blob_ptr);
+    }
+    return soci::into (_serialisedPlace);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  soci::details::use_type_ptr SerialisedPlaceBinding::use() {
+    if (_blob_ptr != NULL) {
+      return soci::use (*_blob_ptr);
+    }
+    return soci::use (_serialisedPlace);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void SerialisedPlaceBinding::retrieve() {
+    if (_blob_ptr == NULL) {
+      return;
+    }
+
+    const std::size_t lLength = _blob_ptr->get_len();
+    _serialisedPlace.resize (lLength);
+    if (lLength != 0) {
+      _blob_ptr->read (0, &_serialisedPlace[0], lLength);
+    }
+  }
+
+}
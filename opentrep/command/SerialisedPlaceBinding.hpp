@@ -0,0 +1,138 @@
+#ifndef __OPENTREP_CMD_SERIALISEDPLACEBINDING_HPP
+#define __OPENTREP_CMD_SERIALISEDPLACEBINDING_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+// SOCI
+#include <soci/soci.h>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * @brief Serialised place (i.e., the details of a POR, as stored within
+   *        the optd_por table), bound to SQL statements.
+   *
+   * From the version 2 of the schema of the SQL database onwards, the
+   * serialised place is the Protobuf record of the POR (see
+   * LocationExchange::serialiseLocation()), i.e., binary data, which may
+   * contain NUL bytes:
+   * <ul>
+   *   <li>with SQLite, it is bound as a BLOB (soci::blob), as the strings
+   *       are retrieved by SOCI as NUL-terminated ones;</li>
+   *   <li>with MySQL/MariaDB, which SOCI does not support BLOB for, it is
+   *       bound as a string, as those latter are exchanged by SOCI along
+   *       with their lengths.</li>
+   * </ul>
+   * With the version 1 of the schema, the serialised place is the raw
+   * data string of the POR, bound as a string.
+   *
+   * The binding, as the SQL session it is created on, may be used by
+   * a single thread at once.
+   */
+  class SerialisedPlaceBinding {
+  public:
+    // /////////// Getters ////////////
+    /**
+     * Get the version of the schema of the SQL database, which tells
+     * how the serialised place is to be decoded (see
+     * DBManager::retrieveLocation()).
+     */
+    const SQLDBSchemaVersion_T& getSchemaVersion() const {
+      return _schemaVersion;
+    }
+
+    /**
+     * Get the name of the column holding the serialised places:
+     * serialised_place_pb (Protobuf records) from the version 2 of
+     * the schema onwards, serialised_place (raw data strings) before.
+     */
+    std::string getColumnName() const;
+
+    /**
+     * Get the serialised place, i.e., either the one retrieved by
+     * the last fetch (see retrieve()), or the one set by
+     * setSerialisedPlace().
+     */
+    const std::string& getSerialisedPlace() const {
+      return _serialisedPlace;
+    }
+
+  public:
+    // /////////// Setters ////////////
+    /**
+     * Set the serialised place, to be used by the next execution of
+     * the statements it is bound to.
+     */
+    void setSerialisedPlace (const std::string&);
+
+  public:
+    // /////////// Business methods ////////////
+    /**
+     * Bind the serialised place as an output of a SQL statement.
+     */
+    soci::details::into_type_ptr into();
+
+    /**
+     * Bind the serialised place as an input of a SQL statement.
+     */
+    soci::details::use_type_ptr use();
+
+    /**
+     * Retrieve the serialised place, once a row has been fetched.
+     */
+    void retrieve();
+
+  public:
+    // /////////// Constructors and destructors ////////////
+    /**
+     * Constructor.
+     *
+     * @param soci::session& SOCI session handler, which must outlive
+     *        the binding.
+     * @param const SQLDBSchemaVersion_T& Version of the schema of the SQL
+     *        database.
+     */
+    SerialisedPlaceBinding (soci::session&, const SQLDBSchemaVersion_T&);
+
+    /**
+     * Destructor.
+     */
+    ~SerialisedPlaceBinding();
+
+  private:
+    /**
+     * Default constructor.
+     */
+    SerialisedPlaceBinding();
+
+    /**
+     * Default copy constructor.
+     */
+    SerialisedPlaceBinding (const SerialisedPlaceBinding&);
+
+  private:
+    // //////////////// Attributes //////////////////
+    /**
+     * Version of the schema of the SQL database.
+     */
+    const SQLDBSchemaVersion_T _schemaVersion;
+
+    /**
+     * BLOB bound to the statements (NULL when the serialised place is
+     * bound as a string).
+     */
+    soci::blob* _blob_ptr;
+
+    /**
+     * Serialised place (bound to the statements when there is no BLOB).
+     */
+    std::string _serialisedPlace;
+  };
+
+}
+#endif // __OPENTREP_CMD_SERIALISEDPLACEBINDING_HPP
@@ -17,6 +17,8 @@
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
 #include <opentrep/bom/Result.hpp>
+#include <opentrep/bom/LocationView.hpp>
+#include <opentrep/bom/PORSpatialIndex.hpp>
 #include <opentrep/command/XapianIndexManager.hpp>
 #include <opentrep/service/Logger.hpp>
 
@@ -65,17 +67,27 @@ namespace OPENTREP {
   drawRandomLocations (const TravelDBFilePath_T& iTravelDBFilePath,
                        const NbOfMatches_T& iNbOfDraws,
                        LocationList_T& ioLocationList) {
-    NbOfMatches_T oNbOfMatches = 0;
-
     // Check whether the file-path to the Xapian database/index exists
     // and is a directory.
     checkTravelDBFilePath (iTravelDBFilePath);
 
     // Open the Xapian database
-    Xapian::Database lXapianDatabase (iTravelDBFilePath);
+    const Xapian::Database lXapianDatabase (iTravelDBFilePath);
+
+    // Delegate the draws to the method working on the opened database
+    return drawRandomLocations (lXapianDatabase, iNbOfDraws, ioLocationList);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T XapianIndexManager::
+  drawRandomLocations (const Xapian::Database& iXapianDatabase,
+                       const NbOfMatches_T& iNbOfDraws,
+                       LocationList_T& ioLocationList) {
+    NbOfMatches_T oNbOfMatches = 0;
 
     // Retrieve the number of documents indexed by the database
-    const NbOfDBEntries_T& lTotalNbOfDocs = getSize (iTravelDBFilePath);
+    const NbOfDBEntries_T lTotalNbOfDocs =
+      static_cast<const NbOfDBEntries_T> (iXapianDatabase.get_doccount());
 
     // No need to go further when the Xapian database (index) is empty
     if (lTotalNbOfDocs == 0) {
@@ -96,7 +108,7 @@ namespace OPENTREP {
       Xapian::docid lDocID = static_cast<Xapian::docid> (lRandomNbInt);
 
       // Retrieve the document from the Xapian database/index
-      Xapian::termcount lDocLength = lXapianDatabase.get_doclength (lDocID);
+      Xapian::termcount lDocLength = iXapianDatabase.get_doclength (lDocID);
 
       unsigned short currentNbOfIterations = 0;
       while (lDocLength == 0 && currentNbOfIterations <= 100) {
@@ -110,7 +122,7 @@ namespace OPENTREP {
         lDocID = static_cast<Xapian::docid> (lRandomNbInt);
 
         // Retrieve the document from the Xapian database/index
-        lDocLength = lXapianDatabase.get_doclength (lDocID);
+        lDocLength = iXapianDatabase.get_doclength (lDocID);
       }
 
       // Bad luck: no document ID can be generated so that it corresponds to
@@ -123,7 +135,7 @@ namespace OPENTREP {
 
       } else {
         // Retrieve the actual document.
-	const Xapian::Document lDoc = lXapianDatabase.get_document (lDocID);
+	const Xapian::Document lDoc = iXapianDatabase.get_document (lDocID);
         const std::string& lDocDataStr = lDoc.get_data();
         const RawDataString_T& lDocData = RawDataString_T (lDocDataStr);
 
@@ -148,4 +160,73 @@ namespace OPENTREP {
     return oNbOfMatches;
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T XapianIndexManager::
+  buildSpatialIndex (const Xapian::Database& iXapianDatabase,
+                     const TravelDBFilePath_T& iTravelDBFilePath,
+                     PORSpatialIndex& ioSpatialIndex) {
+    // Empty the spatial index, in case it was built from another
+    // Xapian database/index (e.g., another deployment number)
+    ioSpatialIndex.reset();
+
+    // Browse all the documents of the Xapian database/index
+    for (Xapian::PostingIterator itDocID = iXapianDatabase.postlist_begin ("");
+         itDocID != iXapianDatabase.postlist_end (""); ++itDocID) {
+      const Xapian::docid& lDocID = *itDocID;
+      const Xapian::Document lDoc = iXapianDatabase.get_document (lDocID);
+
+      // Locate the POR details, only the coordinates and the feature code
+      // of which are decoded
+      const std::string& lDocDataStr = lDoc.get_data();
+      const LocationView lLocationView (lDocDataStr);
+
+      // Add the POR to the spatial index
+      ioSpatialIndex.addPoint (lLocationView.getLatitude(),
+                               lLocationView.getLongitude(),
+                               lLocationView.getFeatureCode(),
+                               static_cast<const XapianDocID_T> (lDocID));
+    }
+
+    // Arrange the POR into the k-d tree
+    ioSpatialIndex.build (iTravelDBFilePath);
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG (ioSpatialIndex.describe());
+
+    const NbOfDBEntries_T oNbOfDBEntries = ioSpatialIndex.size();
+    return oNbOfDBEntries;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T XapianIndexManager::
+  findNearby (const Xapian::Database& iXapianDatabase,
+              const PORSpatialIndex& iSpatialIndex,
+              const Latitude_T& iLatitude, const Longitude_T& iLongitude,
+              const Distance_T& iRadius, const NbOfMatches_T& iK,
+              const std::string& iFeatureFilter,
+              LocationList_T& ioLocationList) {
+    NbOfMatches_T oNbOfMatches = 0;
+
+    // Search the spatial index
+    SpatialHitList_T lHitList;
+    iSpatialIndex.findNearest (iLatitude, iLongitude, iRadius, iK,
+                               iFeatureFilter, lHitList);
+
+    // Retrieve the details of the POR, from the nearest to the farthest
+    for (SpatialHitList_T::const_iterator itHit = lHitList.begin();
+         itHit != lHitList.end(); ++itHit) {
+      const XapianDocID_T& lDocID = itHit->second;
+      const Xapian::Document lDoc = iXapianDatabase.get_document (lDocID);
+
+      // Parse the POR details and create the corresponding Location structure
+      const Location& lLocation = Result::retrieveLocation (lDoc);
+
+      // Add the Location structure to the dedicated list
+      ioLocationList.push_back (lLocation);
+      ++oNbOfMatches;
+    }
+
+    return oNbOfMatches;
+  }
+
 }
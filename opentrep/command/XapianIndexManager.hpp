@@ -8,14 +8,23 @@
 #include <opentrep/OPENTREP_Types.hpp>
 #include <opentrep/LocationList.hpp>
 
+// Forward declarations
+namespace Xapian {
+  class Database;
+}
+
 namespace OPENTREP {
 
+  // Forward declarations
+  class PORSpatialIndex;
+
   /**
    * @brief Command wrapping utilities for the management
    *        of the Xapian (database) index.
    */
   class XapianIndexManager {
     friend class OPENTREP_Service;
+    friend class SearchIndexHandle;
   private:
     /**
      * Give the number of documents indexed by the Xapian index
@@ -38,6 +47,58 @@ namespace OPENTREP {
                                               const NbOfMatches_T& iNbOfDraws,
                                               LocationList_T&);
 
+    /**
+     * Randomly draw a given number of documents from the given, already
+     * opened, Xapian index (named "database").
+     *
+     * @param const Xapian::Database& The Xapian index/database.
+     * @param LocationList_T& List of Location structures randomly picked-up.
+     * @return const NbOfMatches_T& Number of locations to randomly pick-up.
+     */
+    static NbOfMatches_T drawRandomLocations (const Xapian::Database&,
+                                              const NbOfMatches_T& iNbOfDraws,
+                                              LocationList_T&);
+
+    /**
+     * Build the in-memory spatial index from the geographical coordinates
+     * of all the documents of the given, already opened, Xapian index.
+     *
+     * @param const Xapian::Database& The Xapian index/database.
+     * @param const TravelDBFilePath_T& Filepath to the Xapian database.
+     * @param PORSpatialIndex& Spatial index to be (re-)built.
+     * @return NbOfDBEntries_T Number of POR stored within the spatial index.
+     */
+    static NbOfDBEntries_T buildSpatialIndex (const Xapian::Database&,
+                                              const TravelDBFilePath_T&,
+                                              PORSpatialIndex&);
+
+    /**
+     * Find the POR (points of reference) nearest to a given geographical
+     * point, thanks to the in-memory spatial index. The corresponding
+     * documents are then retrieved from the given, already opened, Xapian
+     * index (e.g., kept open by the services, see SearchIndexHandle).
+     * The spatial index must have been built from that very Xapian index.
+     *
+     * @param const Xapian::Database& The Xapian index/database.
+     * @param const PORSpatialIndex& Spatial index, already built.
+     * @param const Latitude_T& Latitude of the point, in degrees.
+     * @param const Longitude_T& Longitude of the point, in degrees.
+     * @param const Distance_T& Search radius, in kilometers (0 for no bound).
+     * @param const NbOfMatches_T& Maximum number of POR (0 for no limit).
+     * @param const std::string& Geonames feature code (e.g., AIRP, RSTN),
+     *        or empty string for no filter.
+     * @param LocationList_T& List of Location structures, sorted by
+     *        increasing distance.
+     * @return NbOfMatches_T Number of POR found.
+     */
+    static NbOfMatches_T findNearby (const Xapian::Database&,
+                                     const PORSpatialIndex&,
+                                     const Latitude_T&, const Longitude_T&,
+                                     const Distance_T& iRadius,
+                                     const NbOfMatches_T& iK,
+                                     const std::string& iFeatureFilter,
+                                     LocationList_T&);
+
   private:
     /**
      * Constructors.
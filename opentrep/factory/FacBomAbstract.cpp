@@ -10,6 +10,7 @@
 // OpenTrep
 #include <opentrep/bom/BomAbstract.hpp>
 #include <opentrep/factory/FacBomAbstract.hpp>
+#include <opentrep/factory/FacBomScope.hpp>
 
 namespace OPENTREP {
   
@@ -20,6 +21,7 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   void FacBomAbstract::clean() {
+    boost::lock_guard<boost::mutex> lLock (_poolMutex);
     for (BomPool_T::iterator itBom = _pool.begin();
 	 itBom != _pool.end(); itBom++) {
       BomAbstract* currentBom_ptr = *itBom;
@@ -32,6 +34,21 @@ namespace OPENTREP {
     _pool.clear();
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  void FacBomAbstract::addToPool (BomAbstract* ioBom_ptr) {
+    assert (ioBom_ptr != NULL);
+
+    // The objects created within a scope are owned by that latter
+    FacBomScope* lScope_ptr = FacBomScope::getCurrentScope();
+    if (lScope_ptr != NULL) {
+      lScope_ptr->add (ioBom_ptr);
+      return;
+    }
+
+    boost::lock_guard<boost::mutex> lLock (_poolMutex);
+    _pool.push_back (ioBom_ptr);
+  }
+
   // //////////////////////////////////////////////////////////////////////
   std::size_t FacBomAbstract::getID (const BomAbstract* iBomAbstract_ptr) {
     const void* lPtr = iBomAbstract_ptr;
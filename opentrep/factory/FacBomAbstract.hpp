@@ -7,6 +7,9 @@
 // STL
 #include <string>
 #include <vector>
+// Boost
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 
 namespace OPENTREP {
 
@@ -48,9 +51,19 @@ namespace OPENTREP {
     /** Destroyed all the object instantiated by this factory. */
     void clean();
 
+  protected:
+    /** Add a newly instantiated object to the pool of the factory or,
+        when the current thread has opened a scope (see FacBomScope),
+        to that latter, which then owns the object.
+        <br>It may be called by several threads at once. */
+    void addToPool (BomAbstract*);
+
   protected:
     /** List of instantiated Business Objects*/
     BomPool_T _pool;
+
+    /** Mutex protecting the list of instantiated Business Objects. */
+    boost::mutex _poolMutex;
   };
 }
 #endif // __OPENTREP_FAC_FACBOMABSTRACT_HPP
@@ -0,0 +1,63 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+// Boost
+#include <boost/thread/tss.hpp>
+// OpenTrep
+#include <opentrep/bom/BomAbstract.hpp>
+#include <opentrep/factory/FacBomScope.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * The scopes live on the stack of their threads: the thread-specific
+   * pointer must not delete them.
+   */
+  // //////////////////////////////////////////////////////////////////////
+  void keepBomScope (FacBomScope*) {
+  }
+
+  /**
+   * Current scope of every thread.
+   */
+  static boost::thread_specific_ptr<FacBomScope> _currentScope (keepBomScope);
+
+  // //////////////////////////////////////////////////////////////////////
+  FacBomScope::FacBomScope() : _previousScope (_currentScope.get()) {
+    _currentScope.reset (this);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  FacBomScope::FacBomScope (const FacBomScope&) : _previousScope (NULL) {
+    assert (false);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  FacBomScope::~FacBomScope() {
+    assert (_currentScope.get() == this);
+    _currentScope.reset (_previousScope);
+
+    // The objects are deleted in the reverse order of their creation
+    for (FacBomAbstract::BomPool_T::reverse_iterator itBom = _pool.rbegin();
+         itBom != _pool.rend(); ++itBom) {
+      BomAbstract* lBom_ptr = *itBom;
+      assert (lBom_ptr != NULL);
+      delete lBom_ptr; lBom_ptr = NULL;
+    }
+    _pool.clear();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  FacBomScope* FacBomScope::getCurrentScope() {
+    return _currentScope.get();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void FacBomScope::add (BomAbstract* ioBom_ptr) {
+    assert (ioBom_ptr != NULL);
+    _pool.push_back (ioBom_ptr);
+  }
+
+}
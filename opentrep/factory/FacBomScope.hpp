@@ -0,0 +1,67 @@
+#ifndef __OPENTREP_FAC_FACBOMSCOPE_HPP
+#define __OPENTREP_FAC_FACBOMSCOPE_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// OpenTrep
+#include <opentrep/factory/FacBomAbstract.hpp>
+
+namespace OPENTREP {
+
+  /**
+   * Scope of the BOM objects created by the current thread, e.g., for
+   * the interpretation of a single travel request.
+   *
+   * While a scope is alive, the objects created, by the current thread,
+   * through the BOM factories (e.g., FacPlace, FacResult) are owned by
+   * that scope, rather than by the factories, and are deleted along with
+   * it. Hence, the threads searching at once do not share any pool of
+   * objects, and the objects of a search do not outlive it.
+   *
+   * The scopes may be nested; the objects are then owned by the innermost
+   * one.
+   */
+  class FacBomScope {
+  public:
+    /**
+     * Constructor. The scope becomes the current one of the thread.
+     */
+    FacBomScope();
+
+    /**
+     * Destructor. All the objects of the scope are deleted, and the
+     * former scope, if any, becomes again the current one of the thread.
+     */
+    ~FacBomScope();
+
+    /**
+     * Get the current scope of the calling thread (NULL when there is none).
+     */
+    static FacBomScope* getCurrentScope();
+
+    /**
+     * Add the given object to the scope, which takes ownership of it.
+     */
+    void add (BomAbstract*);
+
+  private:
+    /**
+     * Copy constructor.
+     */
+    FacBomScope (const FacBomScope&);
+
+  private:
+    /**
+     * Objects created within the scope.
+     */
+    FacBomAbstract::BomPool_T _pool;
+
+    /**
+     * Enclosing scope (NULL when there is none).
+     */
+    FacBomScope* _previousScope;
+  };
+
+}
+#endif // __OPENTREP_FAC_FACBOMSCOPE_HPP
@@ -20,7 +20,9 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   FacOpenTrepServiceContext& FacOpenTrepServiceContext::instance() {
-
+    // Several threads may use the factory at once
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     if (_instance == NULL) {
       _instance = new FacOpenTrepServiceContext();
       assert (_instance != NULL);
@@ -42,7 +44,10 @@ namespace OPENTREP {
                                    iDeploymentNumber);
     assert (aOPENTREP_ServiceContext_ptr != NULL);
 
-    // The new object is added to the Bom pool
+    // The new object is added to the Service pool (several services
+    // may be initialised at once)
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     _pool.push_back (aOPENTREP_ServiceContext_ptr);
 
     return *aOPENTREP_ServiceContext_ptr;
@@ -67,7 +72,10 @@ namespace OPENTREP {
                                    iShouldAddPORInSQLDB);
     assert (aOPENTREP_ServiceContext_ptr != NULL);
 
-    // The new object is added to the Service pool
+    // The new object is added to the Service pool (several services
+    // may be initialised at once)
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     _pool.push_back (aOPENTREP_ServiceContext_ptr);
 
     return *aOPENTREP_ServiceContext_ptr;
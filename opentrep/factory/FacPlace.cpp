@@ -27,7 +27,9 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   FacPlace& FacPlace::instance() {
-
+    // Several threads may use the factory at once
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     if (_instance == NULL) {
       _instance = new FacPlace();
       assert (_instance != NULL);
@@ -45,7 +47,7 @@ namespace OPENTREP {
     assert (oPlace_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oPlace_ptr);
+    addToPool (oPlace_ptr);
 
     return *oPlace_ptr;
   }
@@ -58,7 +60,7 @@ namespace OPENTREP {
     assert (oPlace_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oPlace_ptr);
+    addToPool (oPlace_ptr);
 
     return *oPlace_ptr;
   }
@@ -71,7 +73,7 @@ namespace OPENTREP {
     assert (oPlace_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oPlace_ptr);
+    addToPool (oPlace_ptr);
 
     return *oPlace_ptr;
   }
@@ -84,7 +86,7 @@ namespace OPENTREP {
     assert (oPlace_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oPlace_ptr);
+    addToPool (oPlace_ptr);
 
     return *oPlace_ptr;
   }
@@ -29,7 +29,9 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   FacPlaceHolder& FacPlaceHolder::instance () {
-
+    // Several threads may use the factory at once
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     if (_instance == NULL) {
       _instance = new FacPlaceHolder();
       assert (_instance != NULL);
@@ -47,7 +49,7 @@ namespace OPENTREP {
     assert (oPlaceHolder_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oPlaceHolder_ptr);
+    addToPool (oPlaceHolder_ptr);
 
     return *oPlaceHolder_ptr;
   }
@@ -27,7 +27,9 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   FacResult& FacResult::instance () {
-
+    // Several threads may use the factory at once
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     if (_instance == NULL) {
       _instance = new FacResult();
       assert (_instance != NULL);
@@ -46,7 +48,7 @@ namespace OPENTREP {
     assert (oResult_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oResult_ptr);
+    addToPool (oResult_ptr);
 
     return *oResult_ptr;
   }
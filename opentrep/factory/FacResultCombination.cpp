@@ -29,7 +29,9 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   FacResultCombination& FacResultCombination::instance() {
-
+    // Several threads may use the factory at once
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     if (_instance == NULL) {
       _instance = new FacResultCombination();
       assert (_instance != NULL);
@@ -48,7 +50,7 @@ namespace OPENTREP {
     assert (oResultCombination_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oResultCombination_ptr);
+    addToPool (oResultCombination_ptr);
 
     return *oResultCombination_ptr;
   }
@@ -29,7 +29,9 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   FacResultHolder& FacResultHolder::instance () {
-
+    // Several threads may use the factory at once
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     if (_instance == NULL) {
       _instance = new FacResultHolder();
       assert (_instance != NULL);
@@ -48,7 +50,7 @@ namespace OPENTREP {
     assert (oResultHolder_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oResultHolder_ptr);
+    addToPool (oResultHolder_ptr);
 
     return *oResultHolder_ptr;
   }
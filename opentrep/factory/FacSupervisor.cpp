@@ -17,8 +17,15 @@ namespace OPENTREP {
     _facXapianDB (NULL), _logger (NULL) {
   }
     
+  // //////////////////////////////////////////////////////////////////////
+  boost::recursive_mutex& FacSupervisor::getFactoryMutex() {
+    static boost::recursive_mutex lFactoryMutex;
+    return lFactoryMutex;
+  }
+
   // //////////////////////////////////////////////////////////////////////
   FacSupervisor& FacSupervisor::instance() {
+    boost::lock_guard<boost::recursive_mutex> lLock (getFactoryMutex());
     if (_instance == NULL) {
       _instance = new FacSupervisor();
     }
@@ -29,22 +36,26 @@ namespace OPENTREP {
   // //////////////////////////////////////////////////////////////////////
   void FacSupervisor::
   registerBomFactory (FacBomAbstract* ioFacBomAbstract_ptr) {
+    boost::lock_guard<boost::recursive_mutex> lLock (getFactoryMutex());
     _bomPool.push_back (ioFacBomAbstract_ptr);
   }
 
   // //////////////////////////////////////////////////////////////////////
   void FacSupervisor::
   registerServiceFactory (FacServiceAbstract* ioFacServiceAbstract_ptr) {
+    boost::lock_guard<boost::recursive_mutex> lLock (getFactoryMutex());
     _svcPool.push_back (ioFacServiceAbstract_ptr);
   }
 
   // //////////////////////////////////////////////////////////////////////
   void FacSupervisor::registerXapianDBFactory (FacXapianDB* ioFacXapianDB_ptr) {
+    boost::lock_guard<boost::recursive_mutex> lLock (getFactoryMutex());
     _facXapianDB = ioFacXapianDB_ptr;
   }
 
   // //////////////////////////////////////////////////////////////////////
   void FacSupervisor::registerLoggerService (Logger* ioLogger_ptr) {
+    boost::lock_guard<boost::recursive_mutex> lLock (getFactoryMutex());
     _logger = ioLogger_ptr;
   }
 
@@ -62,6 +73,7 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   void FacSupervisor::cleanBomLayer() {
+    boost::lock_guard<boost::recursive_mutex> lLock (getFactoryMutex());
     for (BomFactoryPool_T::const_iterator itFactory = _bomPool.begin();
          itFactory != _bomPool.end(); itFactory++) {
       const FacBomAbstract* currentFactory_ptr = *itFactory;
@@ -76,6 +88,7 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   void FacSupervisor::cleanServiceLayer() {
+    boost::lock_guard<boost::recursive_mutex> lLock (getFactoryMutex());
     for (ServiceFactoryPool_T::const_iterator itFactory = _svcPool.begin();
          itFactory != _svcPool.end(); itFactory++) {
       const FacServiceAbstract* currentFactory_ptr = *itFactory;
@@ -100,6 +113,7 @@ namespace OPENTREP {
   
   // //////////////////////////////////////////////////////////////////////
   void FacSupervisor::cleanFactory () {
+    boost::lock_guard<boost::recursive_mutex> lLock (getFactoryMutex());
 	if (_instance != NULL) {
 		_instance->cleanBomLayer();
 		_instance->cleanServiceLayer();
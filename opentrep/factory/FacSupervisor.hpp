@@ -6,6 +6,9 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <vector>
+// Boost
+#include <boost/thread/locks.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 
 namespace OPENTREP {
 
@@ -34,6 +37,15 @@ namespace OPENTREP {
      */
     static FacSupervisor& instance();
 
+    /**
+     * Get the mutex serialising the instantiations of the factories
+     * (including that of the FacSupervisor itself) and their registrations,
+     * as the factories may be used by several threads at once (e.g.,
+     * searching on the same OPENTREP_Service). It is recursive, as the
+     * factories register themselves while being instantiated.
+     */
+    static boost::recursive_mutex& getFactoryMutex();
+
     /**
      * Register a newly instantiated concrete factory for the Bom layer.
      * When a concrete Factory is firstly instantiated,
@@ -24,7 +24,9 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   FacWorld& FacWorld::instance () {
-
+    // Several threads may use the factory at once
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     if (_instance == NULL) {
       _instance = new FacWorld();
       assert (_instance != NULL);
@@ -42,7 +44,7 @@ namespace OPENTREP {
     assert (oWorld_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oWorld_ptr);
+    addToPool (oWorld_ptr);
 
     return *oWorld_ptr;
   }
@@ -94,7 +96,7 @@ namespace OPENTREP {
     assert (oWorld_ptr != NULL);
 
     // The new object is added to the Bom pool
-    _pool.push_back (oWorld_ptr);
+    addToPool (oWorld_ptr);
 
     return *oWorld_ptr;
   }
@@ -37,6 +37,9 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   FacXapianDB& FacXapianDB::instance() {
+    // Several threads may use the factory at once
+    boost::lock_guard<boost::recursive_mutex>
+      lLock (FacSupervisor::getFactoryMutex());
     if (_instance == NULL) {
       _instance = new FacXapianDB();
       FacSupervisor::instance().registerXapianDBFactory (_instance);
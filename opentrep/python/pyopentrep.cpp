@@ -2,27 +2,757 @@
 #include <boost/python.hpp>
 // STL
 #include <cassert>
+#include <cmath>
 #include <stdexcept>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <list>
 #include <vector>
+#include <deque>
 // Boost Python
 #include <boost/filesystem.hpp>
+// Boost Thread
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/reverse_lock.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind/bind.hpp>
 // OpenTREP
 #include <opentrep/OPENTREP_Service.hpp>
 #include <opentrep/OutputFormat.hpp>
+#include <opentrep/DSVColumn.hpp>
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
+#include <opentrep/OriginHint.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/Utilities.hpp>
 #include <opentrep/bom/BomJSONExport.hpp>
+#include <opentrep/bom/BomDSVExport.hpp>
 #include <opentrep/bom/LocationExchange.hpp>
+#include <opentrep/service/Logger.hpp>
 
 //
 namespace bp = boost::python;
 
 namespace OPENTREP {
 
+  // //////////////////////////////////////////////////////////////////////
+  void exportShortResult (std::ostream& oStr,
+                          const LocationList_T& iLocationList,
+                          const WordList_T& iNonMatchedWordList) {
+    // For instance, "NCE/100,SFO:OAK/100-SJC/90;wrd" for the Nice main
+    // location, the San Francisco main and extra locations, the San Jose
+    // alternate location, and a non-matched word
+    NbOfMatches_T idx = 0;
+    for (LocationList_T::const_iterator itLocation = iLocationList.begin();
+         itLocation != iLocationList.end(); ++itLocation, ++idx) {
+      const Location& lLocation = *itLocation;
+
+      if (idx != 0) {
+        oStr << ",";
+      }
+      oStr << lLocation.getIataCode();
+
+      // List of extra matching locations (those with the same
+      // matching weight/percentage)
+      const LocationList_T& lExtraLocationList =
+        lLocation.getExtraLocationList();
+      for (LocationList_T::const_iterator itLoc = lExtraLocationList.begin();
+           itLoc != lExtraLocationList.end(); ++itLoc) {
+        const Location& lExtraLocation = *itLoc;
+        oStr << ":" << lExtraLocation.getIataCode();
+      }
+
+      // The matching weight/percentage is the same for the main
+      // and the extra matching locations
+      oStr << "/" << lLocation.getPercentage();
+
+      // List of alternate matching locations (those with a lower
+      // matching weight/percentage)
+      const LocationList_T& lAlternateLocationList =
+        lLocation.getAlternateLocationList();
+      for (LocationList_T::const_iterator itLoc =
+             lAlternateLocationList.begin();
+           itLoc != lAlternateLocationList.end(); ++itLoc) {
+        const Location& lAlternateLocation = *itLoc;
+        oStr << "-" << lAlternateLocation.getIataCode()
+             << "/" << lAlternateLocation.getPercentage();
+      }
+    }
+
+    if (iNonMatchedWordList.empty() == false) {
+      oStr << ";";
+      NbOfMatches_T idxWord = 0;
+      for (WordList_T::const_iterator itWord = iNonMatchedWordList.begin();
+           itWord != iNonMatchedWordList.end(); ++itWord, ++idxWord) {
+        const Word_T& lWord = *itWord;
+        if (idxWord != 0) {
+          oStr << ",";
+        }
+        oStr << lWord;
+      }
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void exportFullResult (std::ostream& oStr,
+                         const LocationList_T& iLocationList,
+                         const WordList_T& iNonMatchedWordList) {
+    NbOfMatches_T idx = 0;
+    for (LocationList_T::const_iterator itLocation = iLocationList.begin();
+         itLocation != iLocationList.end(); ++itLocation, ++idx) {
+      const Location& lLocation = *itLocation;
+      oStr << idx+1 << ". " << lLocation.toSingleLocationString()
+           << std::endl;
+
+      // List of extra matching locations (those with the same
+      // matching weight/percentage)
+      const LocationList_T& lExtraLocationList =
+        lLocation.getExtraLocationList();
+      if (lExtraLocationList.empty() == false) {
+        oStr << "  Extra matches: " << std::endl;
+
+        NbOfMatches_T idxExtra = 0;
+        for (LocationList_T::const_iterator itLoc = lExtraLocationList.begin();
+             itLoc != lExtraLocationList.end(); ++itLoc, ++idxExtra) {
+          const Location& lExtraLocation = *itLoc;
+          oStr << "    " << idx+1 << "." << idxExtra+1 << ". "
+               << lExtraLocation << std::endl;
+        }
+      }
+
+      // List of alternate matching locations (those with a lower
+      // matching weight/percentage)
+      const LocationList_T& lAlternateLocationList =
+        lLocation.getAlternateLocationList();
+      if (lAlternateLocationList.empty() == false) {
+        oStr << "  Alternate matches: " << std::endl;
+
+        NbOfMatches_T idxAlter = 0;
+        for (LocationList_T::const_iterator itLoc =
+               lAlternateLocationList.begin();
+             itLoc != lAlternateLocationList.end(); ++itLoc, ++idxAlter) {
+          const Location& lAlternateLocation = *itLoc;
+          oStr << "    " << idx+1 << "." << idxAlter+1 << ". "
+               << lAlternateLocation << std::endl;
+        }
+      }
+    }
+
+    if (iNonMatchedWordList.empty() == false) {
+      oStr << "Not recognised words:" << std::endl;
+      NbOfMatches_T idxWord = 0;
+      for (WordList_T::const_iterator itWord = iNonMatchedWordList.begin();
+           itWord != iNonMatchedWordList.end(); ++itWord, ++idxWord) {
+        const Word_T& lWord = *itWord;
+        if (idxWord != 0) {
+          oStr << idxWord+1 << "." << std::endl;
+        }
+        oStr << lWord;
+      }
+    }
+  }
+
+  /**
+   * List of travel queries, for the batch search.
+   */
+  typedef std::vector<std::string> TravelQueryList_T;
+
+  /**
+   * @brief Result of a travel query of the batch search.
+   */
+  struct QueryResult {
+    /**
+     * Constructor.
+     */
+    QueryResult() : _isOK (true) {
+    }
+
+    /**
+     * Result, in the requested output format or, when the search has failed,
+     * the error message (for Protobuf, the answer holding that message).
+     */
+    std::string _result;
+
+    /**
+     * Whether the search has succeeded.
+     */
+    bool _isOK;
+  };
+
+  /**
+   * List of the results of the batch search, in the order of the queries.
+   */
+  typedef std::vector<QueryResult> QueryResultList_T;
+
+  // //////////////////////////////////////////////////////////////////////
+  void searchTravelQuery (OPENTREP_Service& ioOpentrepService,
+                          const std::string& iTravelQuery,
+                          const OutputFormat::EN_OutputFormat& iOutputFormat,
+                          std::string& ioResult) {
+    // That function may be called by several threads at once. No Python
+    // object may be handled here.
+    WordList_T lNonMatchedWordList;
+    LocationList_T lLocationList;
+    ioOpentrepService.interpretTravelRequest (iTravelQuery, lLocationList,
+                                              lNonMatchedWordList);
+
+    // Only the requested output format is built
+    switch (iOutputFormat) {
+    case OutputFormat::SHORT: {
+      std::ostringstream oStr;
+      exportShortResult (oStr, lLocationList, lNonMatchedWordList);
+      ioResult = oStr.str();
+      break;
+    }
+    case OutputFormat::FULL: {
+      std::ostringstream oStr;
+      exportFullResult (oStr, lLocationList, lNonMatchedWordList);
+      ioResult = oStr.str();
+      break;
+    }
+    case OutputFormat::JSON: {
+      std::ostringstream oStr;
+      BomJSONExport::jsonExportLocationList (oStr, lLocationList);
+      ioResult = oStr.str();
+      break;
+    }
+    case OutputFormat::PROTOBUF: {
+      LocationExchange::exportLocationList (ioResult, lLocationList,
+                                            lNonMatchedWordList);
+      break;
+    }
+    case OutputFormat::CSV:
+    case OutputFormat::TSV: {
+      const char lDelimiter = BomDSVExport::getDelimiter (iOutputFormat);
+      BomDSVExport::dsvExportLocationList (ioResult, lLocationList,
+                                           DSVColumn::getAllColumns(),
+                                           lDelimiter, true);
+      break;
+    }
+    default: {
+      assert (false);
+      break;
+    }
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void setQueryError (const std::string& iErrorMessage,
+                      const OutputFormat::EN_OutputFormat& iOutputFormat,
+                      QueryResult& ioQueryResult) {
+    ioQueryResult._isOK = false;
+    if (iOutputFormat == OutputFormat::PROTOBUF) {
+      LocationExchange::exportError (ioQueryResult._result, iErrorMessage);
+    } else {
+      ioQueryResult._result = iErrorMessage;
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void searchTravelQueries (OPENTREP_Service& ioOpentrepService,
+                            const TravelQueryList_T& iQueryList,
+                            const OutputFormat::EN_OutputFormat& iOutputFormat,
+                            QueryResultList_T& ioResultList,
+                            const size_t iFirstQuery, const size_t iQueryStep) {
+    // That function may be called by several threads at once, each one
+    // searching for every iQueryStep-th query, and writing only into
+    // the corresponding results. A failed query is reported in its own
+    // result, without stopping the others.
+    const size_t lNbOfQueries = iQueryList.size();
+    for (size_t idx = iFirstQuery; idx < lNbOfQueries; idx += iQueryStep) {
+      const std::string& lTravelQuery = iQueryList[idx];
+      QueryResult& lQueryResult = ioResultList[idx];
+
+      try {
+        searchTravelQuery (ioOpentrepService, lTravelQuery, iOutputFormat,
+                           lQueryResult._result);
+
+      } catch (const RootException& eOpenTrepError) {
+        OPENTREP_LOG_ERROR ("Error when searching for '" << lTravelQuery
+                            << "': " << eOpenTrepError.what());
+        setQueryError (eOpenTrepError.what(), iOutputFormat, lQueryResult);
+
+      } catch (const std::exception& eStdError) {
+        OPENTREP_LOG_ERROR ("Error when searching for '" << lTravelQuery
+                            << "': " << eStdError.what());
+        setQueryError (eStdError.what(), iOutputFormat, lQueryResult);
+
+      } catch (...) {
+        OPENTREP_LOG_ERROR ("Unknown error when searching for '"
+                            << lTravelQuery << "'");
+        setQueryError ("Unknown error", iOutputFormat, lQueryResult);
+      }
+    }
+  }
+
+  /**
+   * Lock on the log stream, shared by the Python wrapper (which writes
+   * directly into it) and the OpenTREP library (which logs through
+   * the Logger).
+   */
+  typedef boost::unique_lock<boost::recursive_mutex> LogLock_T;
+
+  /**
+   * Unlocking of the log stream, for the time of a call into the library.
+   */
+  typedef boost::reverse_lock<LogLock_T> LogUnlock_T;
+
+  /**
+   * @brief Release of the Python GIL (global interpreter lock), for the
+   *        time of a call into the OpenTREP library.
+   *
+   * The other Python threads may then run, and in particular search
+   * at the same time on the same OpenTREP service: the searches share
+   * only read-only or locked structures, the BOM objects (e.g., Place,
+   * Result) of a search belonging to that latter (see FacBomScope).
+   * The GIL is taken back when the object is destroyed. No Python object
+   * may be handled while the GIL is released.
+   */
+  class ScopedGILRelease {
+  public:
+    ScopedGILRelease() : _threadState (PyEval_SaveThread()) {
+    }
+    ~ScopedGILRelease() {
+      PyEval_RestoreThread (_threadState);
+    }
+
+  private:
+    ScopedGILRelease (const ScopedGILRelease&);
+    ScopedGILRelease& operator= (const ScopedGILRelease&);
+
+  private:
+    /**
+     * State of the Python thread, saved when releasing the GIL.
+     */
+    PyThreadState* _threadState;
+  };
+
+  // //////////////////////////////////////////////////////////////////////
+  void setFutureOutcome (bp::object ioFuture, const bool iIsOK,
+                         bp::object iOutcome) {
+    // The future may have been cancelled in the meantime (e.g., on timeout)
+    const bool isCancelled = bp::extract<bool> (ioFuture.attr ("cancelled")());
+    if (isCancelled == true) {
+      return;
+    }
+
+    if (iIsOK == true) {
+      ioFuture.attr ("set_result") (iOutcome);
+    } else {
+      ioFuture.attr ("set_exception") (iOutcome);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  const bp::object& getSetFutureOutcome() {
+    // Created once, the GIL being held, and never destroyed, as the Python
+    // interpreter may well be finalised before the static objects
+    static const bp::object* lSetFutureOutcome_ptr =
+      new bp::object (bp::make_function (setFutureOutcome));
+    return *lSetFutureOutcome_ptr;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  PyObject* getAsyncSearchQueueFullType() {
+    // Created once, the GIL being held (when the module is imported), and
+    // never destroyed, as for the other static Python objects
+    static PyObject* lAsyncSearchQueueFull_ptr =
+      PyErr_NewException ("pyopentrep.AsyncSearchQueueFull",
+                          PyExc_RuntimeError, NULL);
+    return lAsyncSearchQueueFull_ptr;
+  }
+
+  /**
+   * @brief Travel query submitted to the asynchronous search.
+   *
+   * The asyncio future and its event loop are owned references, which are
+   * handled only while the GIL is held.
+   */
+  struct AsyncSearch {
+    std::string _travelQuery;
+    OutputFormat::EN_OutputFormat _outputFormat;
+    PyObject* _future;
+    PyObject* _loop;
+  };
+
+  /**
+   * @brief Wait for a free slot in the submission queue of the asynchronous
+   *        search.
+   *
+   * As for AsyncSearch, the asyncio future and its event loop are owned
+   * references, which are handled only while the GIL is held.
+   */
+  struct AsyncSlotWaiter {
+    PyObject* _future;
+    PyObject* _loop;
+  };
+
+  /**
+   * @brief Pool of threads searching for travel queries on behalf of
+   *        asyncio event loops.
+   *
+   * Every travel query is submitted together with an asyncio future.
+   * Once the query searched, the future is completed through the
+   * call_soon_threadsafe() method of its event loop, so that the event
+   * loop never waits for the search, and thousands of travel queries may
+   * be in flight at once.
+   *
+   * The submission queue is bounded. When it is full, the travel query is
+   * refused at once, rather than blocking the event loop. The producers may
+   * then await a future, completed (through the event loop as well) when
+   * a thread of the pool takes a travel query, which slows them down to
+   * the pace of the searches.
+   *
+   * The threads of the pool share the OpenTREP service. Every search
+   * holds its own Xapian and SQL connections (leased from the service),
+   * and owns the BOM objects (e.g., Place, Result) it creates, which are
+   * deleted once the travel query has been searched (see FacBomScope).
+   * Hence, the memory does not grow with the number of searched queries.
+   */
+  class AsyncSearchPool {
+  public:
+    /**
+     * Status of the submission of a travel query.
+     */
+    typedef enum {
+      SUBMITTED = 0,
+      QUEUE_FULL,
+      STOPPED
+    } EN_SubmissionStatus;
+
+
+    /**
+     * Constructor, starting the threads.
+     *
+     * @param OPENTREP_Service& OpenTREP service, shared by the threads.
+     * @param const NbOfThreads_T& Number of threads (0 means the number
+     *        of hardware threads).
+     * @param const NbOfDBEntries_T& Maximal number of travel queries
+     *        waiting for a thread.
+     */
+    AsyncSearchPool (OPENTREP_Service& ioOpentrepService,
+                     const NbOfThreads_T& iNbOfThreads,
+                     const NbOfDBEntries_T& iQueueSize)
+      : _opentrepService (ioOpentrepService), _nbOfThreads (iNbOfThreads),
+        _queueSize (iQueueSize), _isStopping (false) {
+      if (_nbOfThreads == 0) {
+        _nbOfThreads = boost::thread::hardware_concurrency();
+      }
+      if (_nbOfThreads == 0) {
+        _nbOfThreads = 1;
+      }
+      if (_queueSize == 0) {
+        _queueSize = 1;
+      }
+
+      for (NbOfThreads_T idx = 0; idx != _nbOfThreads; ++idx) {
+        _threadGroup.create_thread (boost::bind (&AsyncSearchPool::work,
+                                                 this));
+      }
+    }
+
+    /**
+     * Destructor. The pool must have been stopped.
+     */
+    ~AsyncSearchPool() {
+      assert (_isStopping == true);
+    }
+
+    /**
+     * Get the number of threads.
+     */
+    const NbOfThreads_T& getNbOfThreads() const {
+      return _nbOfThreads;
+    }
+
+    /**
+     * Get the maximal number of travel queries waiting for a thread.
+     */
+    const NbOfDBEntries_T& getQueueSize() const {
+      return _queueSize;
+    }
+
+    /**
+     * Submit a travel query, the GIL being held. That method never waits:
+     * when the submission queue is full, the travel query is refused. The
+     * references on the future and on the event loop are taken over only
+     * when the travel query has been submitted.
+     *
+     * @return EN_SubmissionStatus Whether the travel query has been
+     *         submitted, or why it has not.
+     */
+    EN_SubmissionStatus submit (const AsyncSearch& iSearch) {
+      boost::unique_lock<boost::mutex> lLock (_mutex);
+
+      if (_isStopping == true) {
+        return STOPPED;
+      }
+      if (_searchQueue.size() >= _queueSize) {
+        return QUEUE_FULL;
+      }
+
+      _searchQueue.push_back (iSearch);
+      lLock.unlock();
+      _searchSubmitted.notify_one();
+      return SUBMITTED;
+    }
+
+    /**
+     * Complete the given future, bound to the running event loop, once the
+     * submission queue has a free slot, the GIL being held. When there is
+     * already a free slot, the future is completed at once; when the pool
+     * has been stopped, it is given an exception.
+     */
+    void waitForSlot (const bp::object& ioFuture, const bp::object& iLoop) {
+      bool isStopping = false;
+      {
+        boost::lock_guard<boost::mutex> lLock (_mutex);
+        isStopping = _isStopping;
+
+        if (isStopping == false && _searchQueue.size() >= _queueSize) {
+          // The references on the future and on the event loop are taken
+          // over, and released by the thread completing the future
+          AsyncSlotWaiter lSlotWaiter;
+          lSlotWaiter._future = ioFuture.ptr();
+          lSlotWaiter._loop = iLoop.ptr();
+          Py_INCREF (lSlotWaiter._future);
+          Py_INCREF (lSlotWaiter._loop);
+          _slotWaiterQueue.push_back (lSlotWaiter);
+          return;
+        }
+      }
+
+      if (isStopping == true) {
+        const bp::object lRuntimeError ((bp::handle<>
+                                         (bp::borrowed (PyExc_RuntimeError))));
+        setFutureOutcome (ioFuture, false,
+                          lRuntimeError ("The asynchronous search has been "
+                                         "stopped"));
+        return;
+      }
+
+      setFutureOutcome (ioFuture, true, bp::object());
+    }
+
+    /**
+     * Stop the threads, the GIL being held. The futures of the travel
+     * queries, which have not been searched yet, are given an exception.
+     */
+    void stop() {
+      {
+        boost::lock_guard<boost::mutex> lLock (_mutex);
+        _isStopping = true;
+      }
+      _searchSubmitted.notify_all();
+
+      // The threads may need the GIL to complete their last future
+      {
+        ScopedGILRelease lGILRelease;
+        _threadGroup.join_all();
+      }
+
+      std::deque<AsyncSearch> lSearchQueue;
+      std::deque<AsyncSlotWaiter> lSlotWaiterQueue;
+      {
+        boost::lock_guard<boost::mutex> lLock (_mutex);
+        lSearchQueue.swap (_searchQueue);
+        lSlotWaiterQueue.swap (_slotWaiterQueue);
+      }
+      for (std::deque<AsyncSearch>::const_iterator itSearch =
+             lSearchQueue.begin(); itSearch != lSearchQueue.end(); ++itSearch) {
+        const AsyncSearch& lSearch = *itSearch;
+        completeSearch (lSearch, false,
+                        "The asynchronous search has been stopped");
+      }
+      for (std::deque<AsyncSlotWaiter>::const_iterator itSlotWaiter =
+             lSlotWaiterQueue.begin();
+           itSlotWaiter != lSlotWaiterQueue.end(); ++itSlotWaiter) {
+        const AsyncSlotWaiter& lSlotWaiter = *itSlotWaiter;
+        completeSlotWaiter (lSlotWaiter, false);
+      }
+    }
+
+  private:
+    /**
+     * Copy constructor (not implemented).
+     */
+    AsyncSearchPool (const AsyncSearchPool&);
+
+    /**
+     * Loop of every thread of the pool, searching for the submitted travel
+     * queries, until the pool be stopped. Only the outcome (a string) of
+     * a search outlives it.
+     */
+    void work() {
+      while (true) {
+        AsyncSearch lSearch;
+        bool hasSlotWaiter = false;
+        AsyncSlotWaiter lSlotWaiter;
+        {
+          boost::unique_lock<boost::mutex> lLock (_mutex);
+          while (_searchQueue.empty() == true && _isStopping == false) {
+            _searchSubmitted.wait (lLock);
+          }
+          if (_isStopping == true) {
+            return;
+          }
+          lSearch = _searchQueue.front();
+          _searchQueue.pop_front();
+
+          // A slot has just been released: a waiting producer is woken up
+          if (_slotWaiterQueue.empty() == false) {
+            hasSlotWaiter = true;
+            lSlotWaiter = _slotWaiterQueue.front();
+            _slotWaiterQueue.pop_front();
+          }
+        }
+        if (hasSlotWaiter == true) {
+          completeSlotWaiter (lSlotWaiter, true);
+        }
+
+        bool isOK = true;
+        std::string lOutcome;
+        try {
+          searchTravelQuery (_opentrepService, lSearch._travelQuery,
+                             lSearch._outputFormat, lOutcome);
+
+        } catch (const RootException& eOpenTrepError) {
+          isOK = false;
+          lOutcome = eOpenTrepError.what();
+
+        } catch (const std::exception& eStdError) {
+          isOK = false;
+          lOutcome = eStdError.what();
+
+        } catch (...) {
+          isOK = false;
+          lOutcome = "Unknown error";
+        }
+
+        completeSearch (lSearch, isOK, lOutcome);
+      }
+    }
+
+    /**
+     * Complete the future of a travel query, through its event loop, with
+     * either the result or an exception (RuntimeError) holding the given
+     * error message. The GIL is taken for that purpose, and the references
+     * on the future and on the event loop are released.
+     */
+    static void completeSearch (const AsyncSearch& iSearch, const bool iIsOK,
+                                const std::string& iOutcome) {
+      const PyGILState_STATE lGILState = PyGILState_Ensure();
+
+      try {
+        const bp::object lFuture ((bp::handle<> (iSearch._future)));
+        const bp::object lLoop ((bp::handle<> (iSearch._loop)));
+
+        bp::object lOutcome;
+        if (iIsOK == false) {
+          const bp::object lRuntimeError ((bp::handle<>
+                                           (bp::borrowed (PyExc_RuntimeError))));
+          lOutcome = lRuntimeError (iOutcome);
+
+        } else if (iSearch._outputFormat == OutputFormat::PROTOBUF) {
+          lOutcome =
+            bp::object (bp::handle<> (PyBytes_FromStringAndSize
+                                      (iOutcome.data(), iOutcome.size())));
+
+        } else {
+          lOutcome = bp::str (iOutcome);
+        }
+
+        lLoop.attr ("call_soon_threadsafe") (getSetFutureOutcome(), lFuture,
+                                             iIsOK, lOutcome);
+
+      } catch (const bp::error_already_set&) {
+        // For instance, the event loop has been closed in the meantime
+        PyErr_Clear();
+      }
+
+      PyGILState_Release (lGILState);
+    }
+
+    /**
+     * Complete the future of a slot waiter, through its event loop, with
+     * either None or an exception (RuntimeError), when the pool has been
+     * stopped. The GIL is taken for that purpose, and the references on
+     * the future and on the event loop are released.
+     */
+    static void completeSlotWaiter (const AsyncSlotWaiter& iSlotWaiter,
+                                    const bool iIsOK) {
+      const PyGILState_STATE lGILState = PyGILState_Ensure();
+
+      try {
+        const bp::object lFuture ((bp::handle<> (iSlotWaiter._future)));
+        const bp::object lLoop ((bp::handle<> (iSlotWaiter._loop)));
+
+        bp::object lOutcome;
+        if (iIsOK == false) {
+          const bp::object lRuntimeError ((bp::handle<>
+                                           (bp::borrowed (PyExc_RuntimeError))));
+          lOutcome = lRuntimeError ("The asynchronous search has been stopped");
+        }
+
+        lLoop.attr ("call_soon_threadsafe") (getSetFutureOutcome(), lFuture,
+                                             iIsOK, lOutcome);
+
+      } catch (const bp::error_already_set&) {
+        // For instance, the event loop has been closed in the meantime
+        PyErr_Clear();
+      }
+
+      PyGILState_Release (lGILState);
+    }
+
+  private:
+    /**
+     * OpenTREP service, shared by the threads.
+     */
+    OPENTREP_Service& _opentrepService;
+
+    /**
+     * Number of threads.
+     */
+    NbOfThreads_T _nbOfThreads;
+
+    /**
+     * Maximal number of travel queries waiting for a thread.
+     */
+    NbOfDBEntries_T _queueSize;
+
+    /**
+     * Travel queries waiting for a thread.
+     */
+    std::deque<AsyncSearch> _searchQueue;
+
+    /**
+     * Producers waiting for a free slot in the submission queue.
+     */
+    std::deque<AsyncSlotWaiter> _slotWaiterQueue;
+
+    /**
+     * Whether the pool is being stopped.
+     */
+    bool _isStopping;
+
+    /**
+     * Threads of the pool.
+     */
+    boost::thread_group _threadGroup;
+
+    /**
+     * Mutex protecting the queues, and the associated condition, signalled
+     * when a travel query is submitted.
+     */
+    boost::mutex _mutex;
+    boost::condition_variable _searchSubmitted;
+  };
+
   /** 
    * @brief API wrapper around the OpenTREP C++ API, so that Python scripts
    *        can use it seamlessly.
@@ -68,17 +798,16 @@ namespace OPENTREP {
       const OutputFormat::EN_OutputFormat lOutputFormatEnum =
         OutputFormat::PROTOBUF;
       //
-      const std::string& oPBStr = generateImpl (iNbOfDraws, lOutputFormatEnum);
-
-      const ssize_t lPBSize = oPBStr.size();
-      
-      // Convert to a byte array; otherwise Python considers it as a str
-      // (Unicode string in Python 3), and the decoding fails
-      const bp::object& oPBObj =
-        bp::object (bp::handle<> (PyBytes_FromStringAndSize (oPBStr.c_str(),
-                                                             lPBSize)));
+      // The Location objects are serialised directly into a Python bytes
+      // object; the string is returned only when that cannot be done
+      bp::object oPBObj;
+      const std::string& oPBStr = generateImpl (iNbOfDraws, lOutputFormatEnum,
+                                                &oPBObj);
+      if (oPBObj.is_none() == false) {
+        return oPBObj;
+      }
 
-      return oPBObj;
+      return toPBBytes (oPBStr);
     }
 
     /** 
@@ -89,7 +818,248 @@ namespace OPENTREP {
       const OutputFormat lOutputFormat (iOutputFormatString);
       const OutputFormat::EN_OutputFormat& lOutputFormatEnum =
         lOutputFormat.getFormat();
-      return searchImpl (iTravelQuery, lOutputFormatEnum);
+      const OriginHint lOriginHint;
+      return searchImpl (iTravelQuery, lOutputFormatEnum, lOriginHint);
+    }
+
+    /** 
+     * Public wrapper around the search use case, biased towards a given
+     * origin (e.g., the position of the user). A NaN (not a number)
+     * latitude or longitude means that no coordinates are given, and an
+     * empty country code that no country is given.
+     */
+    std::string searchWithOrigin (const std::string& iOutputFormatString,
+                                  const std::string& iTravelQuery,
+                                  const double iLatitude,
+                                  const double iLongitude,
+                                  const std::string& iCountryCode) {
+      const OutputFormat lOutputFormat (iOutputFormatString);
+      const OutputFormat::EN_OutputFormat& lOutputFormatEnum =
+        lOutputFormat.getFormat();
+
+      const bool hasCoordinates = (std::isnan (iLatitude) == false
+                                   && std::isnan (iLongitude) == false);
+      const CountryCode_T lCountryCode (iCountryCode);
+      OriginHint lOriginHint;
+      if (hasCoordinates == true && lCountryCode.empty() == false) {
+        lOriginHint = OriginHint (iLatitude, iLongitude, lCountryCode);
+      } else if (hasCoordinates == true) {
+        lOriginHint = OriginHint (iLatitude, iLongitude);
+      } else if (lCountryCode.empty() == false) {
+        lOriginHint = OriginHint (lCountryCode);
+      }
+      return searchImpl (iTravelQuery, lOutputFormatEnum, lOriginHint);
+    }
+
+    /** 
+     * Public wrapper around the search use case for the delimiter-separated
+     * formats (CSV or TSV), with a selection of columns, given as
+     * a comma-separated list of labels (e.g., "iata_code,lat,lon"; an empty
+     * list means all the columns). See DSVColumn for the known labels.
+     */
+    std::string searchToDSV (const std::string& iOutputFormatString,
+                             const std::string& iTravelQuery,
+                             const std::string& iColumnListString,
+                             const bool iWithHeader) {
+      const OutputFormat lOutputFormat (iOutputFormatString);
+      const OutputFormat::EN_OutputFormat& lOutputFormatEnum =
+        lOutputFormat.getFormat();
+      if (lOutputFormatEnum != OutputFormat::CSV
+          && lOutputFormatEnum != OutputFormat::TSV) {
+        throw CodeConversionException ("The output format must be either "
+                                       "CSV (C) or TSV (T)");
+      }
+      const DSVColumnList_T& lColumnList =
+        DSVColumn::parseColumnList (iColumnListString);
+      const OriginHint lOriginHint;
+      return searchImpl (iTravelQuery, lOutputFormatEnum, lOriginHint,
+                         lColumnList, iWithHeader);
+    }
+
+    /** 
+     * Public wrapper around the search use case, for a batch of queries,
+     * given as a Python list (or any iterable) of strings.
+     *
+     * The queries are searched within a single call into the OpenTREP
+     * library, spread across the given number of threads (0 meaning the
+     * number of hardware threads), while the GIL is released. The result
+     * of every query is built only in the requested output format, with
+     * all the columns (and a header line) for the CSV and TSV formats.
+     *
+     * @return A Python list of strings, one per query and in the order
+     *         of the queries or, for Protobuf, a single Python bytes object,
+     *         i.e., the serialisation of a treppb::QueryAnswerList.
+     *         A failed query gives, in the list, an exception object
+     *         (RuntimeError) holding the error message, rather than
+     *         a string, and, in the Protobuf batch, an answer with a false
+     *         ok_status and that error message (error_msg).
+     */
+    bp::object searchMany (const std::string& iOutputFormatString,
+                           const bp::object& iTravelQueryList,
+                           const NbOfThreads_T& iNbOfThreads) {
+      const OutputFormat lOutputFormat (iOutputFormatString);
+      const OutputFormat::EN_OutputFormat& lOutputFormatEnum =
+        lOutputFormat.getFormat();
+
+      // The queries are copied while the GIL is held
+      const bp::stl_input_iterator<std::string> itQueryBegin (iTravelQueryList);
+      const bp::stl_input_iterator<std::string> itQueryEnd;
+      const TravelQueryList_T lQueryList (itQueryBegin, itQueryEnd);
+
+      QueryResultList_T lResultList;
+      std::string lPBBatch;
+      searchManyImpl (lQueryList, lOutputFormatEnum, iNbOfThreads,
+                      lResultList, lPBBatch);
+
+      if (lOutputFormatEnum == OutputFormat::PROTOBUF) {
+        return toPBBytes (lPBBatch);
+      }
+
+      const bp::object lRuntimeError ((bp::handle<>
+                                       (bp::borrowed (PyExc_RuntimeError))));
+      bp::list oResultList;
+      for (QueryResultList_T::const_iterator itResult = lResultList.begin();
+           itResult != lResultList.end(); ++itResult) {
+        const QueryResult& lQueryResult = *itResult;
+        if (lQueryResult._isOK == true) {
+          oResultList.append (lQueryResult._result);
+        } else {
+          oResultList.append (lRuntimeError (lQueryResult._result));
+        }
+      }
+      return oResultList;
+    }
+
+    /** 
+     * Public wrapper around the search use case, for asyncio: the travel
+     * query is searched by a pool of threads (see AsyncSearchPool), and
+     * an asyncio future, bound to the running event loop, is returned
+     * at once, e.g.:
+     *   result = await openTrepLibrary.searchAsync ("S", "nce sfo")
+     *
+     * The result is a string or, for Protobuf, a bytes object. A failed
+     * search gives an exception (RuntimeError). When the pool has not been
+     * started (see startAsyncSearch()), it is started with the default
+     * parameters.
+     *
+     * That method never blocks the event loop. When the submission queue
+     * is full, an AsyncSearchQueueFull exception (derived from RuntimeError)
+     * is raised at once, and the caller may await waitAsyncSearchSlot()
+     * before trying again, e.g.:
+     *   while True:
+     *     try:
+     *       future = openTrepLibrary.searchAsync ("S", "nce sfo")
+     *       break
+     *     except pyopentrep.AsyncSearchQueueFull:
+     *       await openTrepLibrary.waitAsyncSearchSlot()
+     */
+    bp::object searchAsync (const std::string& iOutputFormatString,
+                            const std::string& iTravelQuery) {
+      const OutputFormat lOutputFormat (iOutputFormatString);
+      const OutputFormat::EN_OutputFormat& lOutputFormatEnum =
+        lOutputFormat.getFormat();
+
+      const bp::object lAsyncIOModule = bp::import ("asyncio");
+      const bp::object lLoop = lAsyncIOModule.attr ("get_running_loop")();
+      const bp::object oFuture = lLoop.attr ("create_future")();
+
+      if (_asyncSearchPool == NULL) {
+        startAsyncSearchImpl (K_DEFAULT_NB_OF_ASYNC_SEARCH_THREADS,
+                              K_DEFAULT_ASYNC_SEARCH_QUEUE_SIZE);
+      }
+
+      if (_asyncSearchPool == NULL) {
+        setFutureError (oFuture, "The OpenTREP service has not been "
+                        "initialized, i.e., the init() method has not been "
+                        "called correctly on the OpenTrepSearcher object");
+        return oFuture;
+      }
+      assert (_asyncSearchPool != NULL);
+
+      // The references on the future and on the event loop are handed
+      // over to the pool
+      AsyncSearch lSearch;
+      lSearch._travelQuery = iTravelQuery;
+      lSearch._outputFormat = lOutputFormatEnum;
+      lSearch._future = oFuture.ptr();
+      lSearch._loop = lLoop.ptr();
+      Py_INCREF (lSearch._future);
+      Py_INCREF (lSearch._loop);
+
+      const AsyncSearchPool::EN_SubmissionStatus lSubmissionStatus =
+        _asyncSearchPool->submit (lSearch);
+      if (lSubmissionStatus != AsyncSearchPool::SUBMITTED) {
+        Py_DECREF (lSearch._future);
+        Py_DECREF (lSearch._loop);
+      }
+
+      if (lSubmissionStatus == AsyncSearchPool::QUEUE_FULL) {
+        PyErr_SetString (getAsyncSearchQueueFullType(),
+                         "The submission queue of the asynchronous search "
+                         "is full");
+        bp::throw_error_already_set();
+      }
+
+      if (lSubmissionStatus == AsyncSearchPool::STOPPED) {
+        setFutureError (oFuture, "The asynchronous search has been stopped");
+      }
+
+      return oFuture;
+    }
+
+    /** 
+     * Return an asyncio future, bound to the running event loop, which is
+     * completed (with None) once the submission queue of the asynchronous
+     * search has a free slot, e.g.:
+     *   await openTrepLibrary.waitAsyncSearchSlot()
+     *
+     * The event loop keeps running in the meantime. When the pool has been
+     * stopped, the future gives an exception (RuntimeError).
+     */
+    bp::object waitAsyncSearchSlot() {
+      const bp::object lAsyncIOModule = bp::import ("asyncio");
+      const bp::object lLoop = lAsyncIOModule.attr ("get_running_loop")();
+      const bp::object oFuture = lLoop.attr ("create_future")();
+
+      if (_asyncSearchPool == NULL) {
+        setFutureError (oFuture, "The asynchronous search has not been "
+                        "started");
+        return oFuture;
+      }
+      assert (_asyncSearchPool != NULL);
+
+      _asyncSearchPool->waitForSlot (oFuture, lLoop);
+      return oFuture;
+    }
+
+    /** 
+     * Start (or re-start) the pool of threads of the asynchronous search.
+     *
+     * @param const NbOfThreads_T& Number of threads (0 means the number
+     *        of hardware threads).
+     * @param const NbOfDBEntries_T& Maximal number of travel queries
+     *        waiting for a thread; beyond that, searchAsync() raises an
+     *        AsyncSearchQueueFull exception.
+     * @return bool Whether the pool has been started.
+     */
+    bool startAsyncSearch (const NbOfThreads_T& iNbOfThreads,
+                           const NbOfDBEntries_T& iQueueSize) {
+      stopAsyncSearch();
+      startAsyncSearchImpl (iNbOfThreads, iQueueSize);
+      return (_asyncSearchPool != NULL);
+    }
+
+    /** 
+     * Stop the pool of threads of the asynchronous search, if any. The
+     * futures of the travel queries not searched yet are given
+     * an exception.
+     */
+    void stopAsyncSearch() {
+      if (_asyncSearchPool == NULL) {
+        return;
+      }
+      _asyncSearchPool->stop();
+      delete _asyncSearchPool; _asyncSearchPool = NULL;
     }
 
     /** 
@@ -99,16 +1069,86 @@ namespace OPENTREP {
       const OutputFormat::EN_OutputFormat lOutputFormatEnum =
         OutputFormat::PROTOBUF;
       //
-      const std::string& oPBStr = searchImpl (iTravelQuery, lOutputFormatEnum);
-      const ssize_t lPBSize = oPBStr.size();
-      
-      // Convert to a byte array; otherwise Python considers it as a str
-      // (Unicode string in Python 3), and the decoding fails
-      const bp::object& oPBObj =
-        bp::object (bp::handle<> (PyBytes_FromStringAndSize (oPBStr.c_str(),
-                                                             lPBSize)));
-      
-      return oPBObj;
+      const OriginHint lOriginHint;
+
+      // The Location objects are serialised directly into a Python bytes
+      // object; the string is returned only when that cannot be done
+      bp::object oPBObj;
+      const std::string& oPBStr = searchImpl (iTravelQuery, lOutputFormatEnum,
+                                              lOriginHint,
+                                              DSVColumn::getAllColumns(), true,
+                                              &oPBObj);
+      if (oPBObj.is_none() == false) {
+        return oPBObj;
+      }
+
+      return toPBBytes (oPBStr);
+    }
+
+    /** 
+     * Public wrapper around the nearby (geographical) search use case.
+     */
+    std::string findNearby (const std::string& iOutputFormatString,
+                            const double iLatitude, const double iLongitude,
+                            const double iRadius, const NbOfMatches_T& iK,
+                            const std::string& iFeatureFilter) {
+      const OutputFormat lOutputFormat (iOutputFormatString);
+      const OutputFormat::EN_OutputFormat& lOutputFormatEnum =
+        lOutputFormat.getFormat();
+      return findNearbyImpl (iLatitude, iLongitude, iRadius, iK,
+                             iFeatureFilter, lOutputFormatEnum);
+    }
+
+    /** 
+     * Public wrapper around the distance matrix use case. The POR are
+     * given as two Python lists, the items of which are either all codes
+     * (strings, e.g., "nce"), or all (latitude, longitude) pairs, in degrees.
+     * The great circle distances (in kilometers) are returned as a list
+     * of lists of floats, NaN standing for the codes which could not be
+     * resolved.
+     */
+    bp::list distanceMatrix (const bp::list& iRowList,
+                             const bp::list& iColList) {
+      WordList_T lRowCodeList;
+      LocationList_T lRowLocationList;
+      const bool areRowCodes =
+        extractDistanceMatrixItems (iRowList, lRowCodeList, lRowLocationList);
+
+      WordList_T lColCodeList;
+      LocationList_T lColLocationList;
+      const bool areColCodes =
+        extractDistanceMatrixItems (iColList, lColCodeList, lColLocationList);
+
+      // Codes and coordinates may not be mixed, but an empty list goes
+      // along with any other one
+      if (areRowCodes != areColCodes
+          && bp::len (iRowList) != 0 && bp::len (iColList) != 0) {
+        PyErr_SetString (PyExc_TypeError, "The rows and the columns of the "
+                         "distance matrix must be either both codes or both "
+                         "(latitude, longitude) pairs");
+        bp::throw_error_already_set();
+      }
+
+      DistanceMatrix_T lDistanceMatrix;
+      if (areRowCodes == true && areColCodes == true) {
+        distanceMatrixImpl (lRowCodeList, lColCodeList, lDistanceMatrix);
+      } else {
+        distanceMatrixImpl (lRowLocationList, lColLocationList,
+                            lDistanceMatrix);
+      }
+
+      bp::list oDistanceMatrix;
+      for (DistanceMatrix_T::const_iterator itRow = lDistanceMatrix.begin();
+           itRow != lDistanceMatrix.end(); ++itRow) {
+        const DistanceList_T& lDistanceRow = *itRow;
+        bp::list lPyDistanceRow;
+        for (DistanceList_T::const_iterator itDistance = lDistanceRow.begin();
+             itDistance != lDistanceRow.end(); ++itDistance) {
+          lPyDistanceRow.append (*itDistance);
+        }
+        oDistanceMatrix.append (lPyDistanceRow);
+      }
+      return oDistanceMatrix;
     }
 
   private:
@@ -190,6 +1230,9 @@ namespace OPENTREP {
       }
       assert (_logOutputStream != NULL);
 
+      // The log stream is shared with the threads of the library
+      LogLock_T lLogLock (Logger::instance().getStreamMutex());
+
       try {
 
         // DEBUG
@@ -223,8 +1266,14 @@ namespace OPENTREP {
         *_logOutputStream << "SQL database connection string: '"
                           << lSQLDBConnStr << "'" << std::endl;
 
-        // Launch the indexation by Xapian of the OPTD-maintained list of POR
-        const NbOfDBEntries_T lNbOfEntries= _opentrepService->insertIntoDBAndXapian();
+        // Launch the indexation by Xapian of the OPTD-maintained list of POR.
+        // The other Python threads may run in the meantime.
+        NbOfDBEntries_T lNbOfEntries = 0;
+        {
+          LogUnlock_T lLogUnlock (lLogLock);
+          ScopedGILRelease lGILRelease;
+          lNbOfEntries = _opentrepService->insertIntoDBAndXapian();
+        }
 
         // Dump the results into the output string
         oPythonLogStr << lNbOfEntries;
@@ -248,16 +1297,65 @@ namespace OPENTREP {
       return oPythonLogStr.str();
     }
 
+    /**
+     * Export a list of Location objects in Protobuf format. When a Python
+     * object is given, the Location objects are serialised directly into
+     * a new Python bytes object, without any intermediate string;
+     * otherwise, they are serialised into the given string.
+     */
+    void exportLocationListToPB (const LocationList_T& iLocationList,
+                                 const WordList_T& iNonMatchedWordList,
+                                 std::string& ioPBString,
+                                 bp::object* ioPBObj_ptr) {
+      if (ioPBObj_ptr == NULL) {
+        LocationExchange::exportLocationList (ioPBString, iLocationList,
+                                              iNonMatchedWordList);
+        return;
+      }
+
+      const std::size_t lPBSize =
+        LocationExchange::prepareLocationList (iLocationList,
+                                               iNonMatchedWordList);
+      PyObject* lPBBytes_ptr = PyBytes_FromStringAndSize (NULL, lPBSize);
+      if (lPBBytes_ptr == NULL) {
+        bp::throw_error_already_set();
+      }
+      const bp::object lPBObj ((bp::handle<> (lPBBytes_ptr)));
+      LocationExchange::serialisePreparedLocationList (PyBytes_AS_STRING
+                                                       (lPBBytes_ptr),
+                                                       lPBSize);
+      *ioPBObj_ptr = lPBObj;
+    }
+
+    /**
+     * Convert a string into a Python bytes object; otherwise Python
+     * considers it as a str (Unicode string in Python 3), and the decoding
+     * of the Protobuf fails.
+     */
+    static bp::object toPBBytes (const std::string& iPBString) {
+      const ssize_t lPBSize = iPBString.size();
+      const bp::object oPBObj =
+        bp::object (bp::handle<> (PyBytes_FromStringAndSize (iPBString.c_str(),
+                                                             lPBSize)));
+      return oPBObj;
+    }
+
     /**
      * Private wrapper around the search use case. 
      */
     std::string searchImpl (const std::string& iTravelQuery,
-                            const OutputFormat::EN_OutputFormat& iOutputFormat) {
+                            const OutputFormat::EN_OutputFormat& iOutputFormat,
+                            const OriginHint& iOriginHint,
+                            const DSVColumnList_T& iDSVColumnList =
+                            DSVColumn::getAllColumns(),
+                            const bool iWithDSVHeader = true,
+                            bp::object* ioPBObj_ptr = NULL) {
       const std::string oEmptyStr ("");
       std::ostringstream oNoDetailedStr;
       std::ostringstream oDetailedStr;
       std::ostringstream oJSONStr;
-      std::ostringstream oProtobufStr;
+      std::string oProtobufString;
+      std::string oDSVString;
 
       // Sanity check
       if (_logOutputStream == NULL) {
@@ -266,6 +1364,9 @@ namespace OPENTREP {
       }
       assert (_logOutputStream != NULL);
 
+      // The log stream is shared with the threads of the library
+      LogLock_T lLogLock (Logger::instance().getStreamMutex());
+
       try {
 
         // DEBUG
@@ -323,94 +1424,31 @@ namespace OPENTREP {
                           << "' - OPTD-maintained list of POR: '"
                           << lPORFilePath << "'" << std::endl;
 
-        // Query the Xapian database (index)
+        // Query the Xapian database (index). The other Python threads
+        // may run (and search) in the meantime.
         WordList_T lNonMatchedWordList;
         LocationList_T lLocationList;
-        const NbOfMatches_T nbOfMatches =
-          _opentrepService->interpretTravelRequest (iTravelQuery, lLocationList,
-                                                    lNonMatchedWordList);
+        NbOfMatches_T nbOfMatches = 0;
+        {
+          LogUnlock_T lLogUnlock (lLogLock);
+          ScopedGILRelease lGILRelease;
+          nbOfMatches =
+            _opentrepService->interpretTravelRequest (iTravelQuery,
+                                                      lLocationList,
+                                                      lNonMatchedWordList,
+                                                      iOriginHint);
+        }
 
         // DEBUG
         *_logOutputStream << "Python search for '" << iTravelQuery << "' gave "
                           << nbOfMatches << " matches." << std::endl;
 
-	if (nbOfMatches != 0) {
-          NbOfMatches_T idx = 0;
-
-          for(LocationList_T::const_iterator itLocation = lLocationList.begin();
-               itLocation != lLocationList.end(); ++itLocation, ++idx) {
-            const Location& lLocation = *itLocation;
-
-            if (idx != 0) {
-              oNoDetailedStr << ",";
-            }
-
-            //
-            oNoDetailedStr << lLocation.getIataCode();
-            oDetailedStr << idx+1 << ". " << lLocation.toSingleLocationString()
-			 << std::endl;
-
-            // List of extra matching locations (those with the same
-            // matching weight/percentage)
-            const LocationList_T& lExtraLocationList =
-              lLocation.getExtraLocationList();
-            if (lExtraLocationList.empty() == false) {
-              oDetailedStr << "  Extra matches: " << std::endl;
-
-              NbOfMatches_T idxExtra = 0;
-              for (LocationList_T::const_iterator itLoc =
-                     lExtraLocationList.begin();
-                   itLoc != lExtraLocationList.end(); ++itLoc, ++idxExtra) {
-                oNoDetailedStr << ":";
-                oDetailedStr << "    " << idx+1 << "." << idxExtra+1 << ". ";
-
-                const Location& lExtraLocation = *itLoc;
-                oNoDetailedStr << lExtraLocation.getIataCode();
-                oDetailedStr << lExtraLocation << std::endl;
-              }
-            }
-
-            // The matching weight/percentage is the same for the main
-            // and the extra matching locations
-            oNoDetailedStr << "/" << lLocation.getPercentage();
-            
-            // List of alternate matching locations (those with a lower
-            // matching weight/percentage)
-            const LocationList_T& lAlternateLocationList =
-              lLocation.getAlternateLocationList();
-            if (lAlternateLocationList.empty() == false) {
-              oDetailedStr << "  Alternate matches: " << std::endl;
-
-              NbOfMatches_T idxAlter = 0;
-              for (LocationList_T::const_iterator itLoc =
-                     lAlternateLocationList.begin();
-                   itLoc != lAlternateLocationList.end(); ++itLoc, ++idxAlter) {
-                oNoDetailedStr << "-";
-                oDetailedStr << "    " << idx+1 << "." << idxAlter+1 << ". ";
-
-                const Location& lAlternateLocation = *itLoc;
-                oNoDetailedStr << lAlternateLocation.getIataCode()
-                               << "/" << lAlternateLocation.getPercentage();
-                oDetailedStr << lAlternateLocation << std::endl;
-              }
-            }
-          }
-        }
-
-        if (lNonMatchedWordList.empty() == false) {
-          oNoDetailedStr << ";";
-          oDetailedStr << "Not recognised words:" << std::endl;
-          NbOfMatches_T idx = 0;
-          for (WordList_T::const_iterator itWord = lNonMatchedWordList.begin();
-               itWord != lNonMatchedWordList.end(); ++itWord, ++idx) {
-            const Word_T& lWord = *itWord;
-            if (idx != 0) {
-              oNoDetailedStr << ",";
-              oDetailedStr << idx+1 << "." << std::endl;
-            }
-            oNoDetailedStr << lWord;
-            oDetailedStr << lWord;
-          }
+        // Only the requested (short or full) version is built
+        if (iOutputFormat == OutputFormat::SHORT) {
+          exportShortResult (oNoDetailedStr, lLocationList,
+                             lNonMatchedWordList);
+        } else if (iOutputFormat == OutputFormat::FULL) {
+          exportFullResult (oDetailedStr, lLocationList, lNonMatchedWordList);
         }
 
         // DEBUG
@@ -418,12 +1456,25 @@ namespace OPENTREP {
                           << "' yielded:" << std::endl;
 
         // Export the list of Location objects into a JSON-formatted string
-        BomJSONExport::jsonExportLocationList (oJSONStr, lLocationList);
+        if (iOutputFormat == OutputFormat::JSON) {
+          BomJSONExport::jsonExportLocationList (oJSONStr, lLocationList);
+        }
 
-        // Export the list of Location objects into a Protobuf-formatted string
-        oProtobufStr << LocationExchange::exportLocationList(lLocationList,
-                                                             lNonMatchedWordList)
-                     << std::flush;
+        // Export the list of Location objects in Protobuf format, directly
+        // into a Python bytes object when one is expected
+        if (iOutputFormat == OutputFormat::PROTOBUF) {
+          exportLocationListToPB (lLocationList, lNonMatchedWordList,
+                                  oProtobufString, ioPBObj_ptr);
+        }
+
+        // Export the list of Location objects in CSV or TSV format
+        if (iOutputFormat == OutputFormat::CSV
+            || iOutputFormat == OutputFormat::TSV) {
+          const char lDelimiter = BomDSVExport::getDelimiter (iOutputFormat);
+          BomDSVExport::dsvExportLocationList (oDSVString, lLocationList,
+                                               iDSVColumnList, lDelimiter,
+                                               iWithDSVHeader);
+        }
 
       } catch (const RootException& eOpenTrepError) {
         *_logOutputStream << "OpenTrep error: "  << eOpenTrepError.what()
@@ -468,13 +1519,27 @@ namespace OPENTREP {
 
       case OutputFormat::PROTOBUF: {
         // DEBUG
-        const std::string& oProtobufString = oProtobufStr.str();
+        if (ioPBObj_ptr != NULL && ioPBObj_ptr->is_none() == false) {
+          *_logOutputStream << "Protobuf version ("
+                            << bp::len (*ioPBObj_ptr) << " bytes)"
+                            << std::endl;
+          return oEmptyStr;
+        }
         *_logOutputStream << "Protobuf version ("
                           << oProtobufString.size() << " char): "
                           << oProtobufString << std::endl;
         return oProtobufString;
       }
 
+      case OutputFormat::CSV:
+      case OutputFormat::TSV: {
+        // DEBUG
+        *_logOutputStream << OutputFormat::getLabel (iOutputFormat)
+                          << " version (" << oDSVString.size() << " char): "
+                          << oDSVString << std::endl;
+        return oDSVString;
+      }
+
       default: {
         // If the output format is not known, an exception is thrown by
         // the call to the OutputFormat() constructor above.
@@ -486,16 +1551,206 @@ namespace OPENTREP {
       return oEmptyStr;
     }
 
+    /**
+     * Set an exception (RuntimeError) on an asyncio future, from the
+     * thread of its event loop.
+     */
+    static void setFutureError (const bp::object& ioFuture,
+                                const std::string& iErrorMessage) {
+      const bp::object lRuntimeError ((bp::handle<>
+                                       (bp::borrowed (PyExc_RuntimeError))));
+      ioFuture.attr ("set_exception") (lRuntimeError (iErrorMessage));
+    }
+
+    /**
+     * Private wrapper around the start of the asynchronous search.
+     */
+    void startAsyncSearchImpl (const NbOfThreads_T& iNbOfThreads,
+                               const NbOfDBEntries_T& iQueueSize) {
+      if (_logOutputStream == NULL || _opentrepService == NULL) {
+        return;
+      }
+      assert (_asyncSearchPool == NULL);
+
+      _asyncSearchPool =
+        new AsyncSearchPool (*_opentrepService, iNbOfThreads, iQueueSize);
+      assert (_asyncSearchPool != NULL);
+
+      // DEBUG
+      LogLock_T lLogLock (Logger::instance().getStreamMutex());
+      *_logOutputStream << "Asynchronous search started with "
+                        << _asyncSearchPool->getNbOfThreads()
+                        << " thread(s), and up to "
+                        << _asyncSearchPool->getQueueSize()
+                        << " waiting travel queries" << std::endl;
+    }
+
+    /**
+     * Report the same error for all the queries of a batch, when none of
+     * them can be searched.
+     */
+    static void
+    setBatchError (const std::string& iErrorMessage,
+                   const OutputFormat::EN_OutputFormat& iOutputFormat,
+                   QueryResultList_T& ioResultList, std::string& ioPBBatch) {
+      for (QueryResultList_T::iterator itResult = ioResultList.begin();
+           itResult != ioResultList.end(); ++itResult) {
+        QueryResult& lQueryResult = *itResult;
+        setQueryError (iErrorMessage, iOutputFormat, lQueryResult);
+        if (iOutputFormat == OutputFormat::PROTOBUF) {
+          LocationExchange::appendQueryAnswer (ioPBBatch,
+                                               lQueryResult._result);
+        }
+      }
+    }
+
+    /**
+     * Private wrapper around the search use case, for a batch of queries.
+     * There is a (possibly empty, or failed) result per query; for Protobuf,
+     * those results are also gathered into a single batch.
+     */
+    void searchManyImpl (const TravelQueryList_T& iQueryList,
+                         const OutputFormat::EN_OutputFormat& iOutputFormat,
+                         const NbOfThreads_T& iNbOfThreads,
+                         QueryResultList_T& ioResultList,
+                         std::string& ioPBBatch) {
+      const size_t lNbOfQueries = iQueryList.size();
+      ioResultList.clear();
+      ioResultList.resize (lNbOfQueries);
+      ioPBBatch.clear();
+
+      // Sanity check
+      if (_logOutputStream == NULL) {
+        setBatchError ("The OpenTREP service has not been initialized",
+                       iOutputFormat, ioResultList, ioPBBatch);
+        return;
+      }
+      assert (_logOutputStream != NULL);
+
+      // The log stream is shared with the threads of the library
+      LogLock_T lLogLock (Logger::instance().getStreamMutex());
+
+      try {
+
+        // DEBUG
+        *_logOutputStream << "Batch search of " << lNbOfQueries
+                          << " travel queries" << std::endl;
+
+        if (_opentrepService == NULL) {
+          *_logOutputStream << "The OpenTREP service has not been initialized, "
+                            << "i.e., the init() method has not been called "
+                            << "correctly on the OpenTrepSearcher object. "
+                            << "Please check that all the parameters are not "
+                            << "empty and point to actual files." << std::endl;
+          setBatchError ("The OpenTREP service has not been initialized",
+                         iOutputFormat, ioResultList, ioPBBatch);
+          return;
+        }
+        assert (_opentrepService != NULL);
+
+        // Check, once for all the queries, that the directory of the Xapian
+        // database/index exists and is accessible
+        const OPENTREP_Service::FilePathSet_T& lFilePathSet =
+          _opentrepService->getFilePaths();
+        const OPENTREP_Service::DBFilePathPair_T& lDBFilePathPair =
+          lFilePathSet.second;
+        const TravelDBFilePath_T& lTravelDBFilePath = lDBFilePathPair.first;
+        const bool lExistXapianDBDir =
+          _opentrepService->checkXapianDBOnFileSystem (lTravelDBFilePath);
+        if (lExistXapianDBDir == false) {
+          std::ostringstream oStr;
+          oStr << "The file-path to the Xapian database/index ('"
+               << lTravelDBFilePath << "') does not exist or is not "
+               << "a directory.";
+          *_logOutputStream << "Error - " << oStr.str() << std::endl;
+          setBatchError (oStr.str(), iOutputFormat, ioResultList, ioPBBatch);
+          return;
+        }
+
+        // Number of threads: bounded by the number of queries
+        size_t lNbOfThreads = iNbOfThreads;
+        if (lNbOfThreads == 0) {
+          lNbOfThreads = boost::thread::hardware_concurrency();
+        }
+        if (lNbOfThreads > lNbOfQueries) {
+          lNbOfThreads = lNbOfQueries;
+        }
+
+        // Search for the queries. The other Python threads may run
+        // in the meantime.
+        {
+          LogUnlock_T lLogUnlock (lLogLock);
+          ScopedGILRelease lGILRelease;
+
+          if (lNbOfThreads <= 1) {
+            searchTravelQueries (*_opentrepService, iQueryList, iOutputFormat,
+                                 ioResultList, 0, 1);
+
+          } else {
+            // The queries are interleaved across the threads, so that
+            // the (usually clustered) costly queries be spread
+            boost::thread_group lThreadGroup;
+            for (size_t idxThread = 0; idxThread != lNbOfThreads;
+                 ++idxThread) {
+              lThreadGroup.
+                create_thread (boost::bind (searchTravelQueries,
+                                            boost::ref (*_opentrepService),
+                                            boost::cref (iQueryList),
+                                            iOutputFormat,
+                                            boost::ref (ioResultList),
+                                            idxThread, lNbOfThreads));
+            }
+            lThreadGroup.join_all();
+          }
+
+          // Gather the Protobuf answers into a single batch
+          if (iOutputFormat == OutputFormat::PROTOBUF) {
+            // Every answer is prefixed by its key and size (at most 6 bytes)
+            size_t lPBBatchSize = 0;
+            for (QueryResultList_T::const_iterator itResult =
+                   ioResultList.begin();
+                 itResult != ioResultList.end(); ++itResult) {
+              lPBBatchSize += itResult->_result.size() + 6;
+            }
+            ioPBBatch.reserve (lPBBatchSize);
+            for (QueryResultList_T::const_iterator itResult =
+                   ioResultList.begin();
+                 itResult != ioResultList.end(); ++itResult) {
+              const std::string& lPBAnswer = itResult->_result;
+              LocationExchange::appendQueryAnswer (ioPBBatch, lPBAnswer);
+            }
+          }
+        }
+
+        // DEBUG
+        *_logOutputStream << "Python batch search of " << lNbOfQueries
+                          << " travel queries done with " << lNbOfThreads
+                          << " thread(s)." << std::endl;
+
+      } catch (const RootException& eOpenTrepError) {
+        *_logOutputStream << "OpenTrep error: "  << eOpenTrepError.what()
+                          << std::endl;
+
+      } catch (const std::exception& eStdError) {
+        *_logOutputStream << "Error: "  << eStdError.what() << std::endl;
+
+      } catch (...) {
+        *_logOutputStream << "Unknown error" << std::endl;
+      }
+    }
+
     /**
      * Private wrapper around the random generation use case. 
      */
     std::string generateImpl(const NbOfMatches_T& iNbOfDraws,
-                             const OutputFormat::EN_OutputFormat& iOutputFormat){
+                             const OutputFormat::EN_OutputFormat& iOutputFormat,
+                             bp::object* ioPBObj_ptr = NULL) {
       const std::string oEmptyStr ("");
       std::ostringstream oNoDetailedStr;
       std::ostringstream oDetailedStr;
       std::ostringstream oJSONStr;
-      std::ostringstream oProtobufStr;
+      std::string oProtobufString;
+      std::string oDSVString;
 
       // Sanity check
       if (_logOutputStream == NULL) {
@@ -504,6 +1759,9 @@ namespace OPENTREP {
       }
       assert (_logOutputStream != NULL);
 
+      // The log stream is shared with the threads of the library
+      LogLock_T lLogLock (Logger::instance().getStreamMutex());
+
       try {
 
         // DEBUG
@@ -538,76 +1796,28 @@ namespace OPENTREP {
                           << "' - OPTD-maintained list of POR: '"
                           << lPORFilePath << "'" << std::endl;
 
-        // Query the Xapian database (index)
+        // Query the Xapian database (index). The other Python threads
+        // may run in the meantime.
         LocationList_T lLocationList;
-        const NbOfMatches_T nbOfMatches =
-          _opentrepService->drawRandomLocations (iNbOfDraws, lLocationList);
+        NbOfMatches_T nbOfMatches = 0;
+        {
+          LogUnlock_T lLogUnlock (lLogLock);
+          ScopedGILRelease lGILRelease;
+          nbOfMatches =
+            _opentrepService->drawRandomLocations (iNbOfDraws, lLocationList);
+        }
 
         // DEBUG
         *_logOutputStream << "Python generation of " << iNbOfDraws << " gave "
                           << nbOfMatches << " documents." << std::endl;
 
-	if (nbOfMatches != 0) {
-          NbOfMatches_T idx = 0;
-
-          for(LocationList_T::const_iterator itLocation = lLocationList.begin();
-               itLocation != lLocationList.end(); ++itLocation, ++idx) {
-            const Location& lLocation = *itLocation;
-
-            if (idx != 0) {
-              oNoDetailedStr << ",";
-            }
-
-            //
-            oNoDetailedStr << lLocation.getIataCode();
-            oDetailedStr << idx+1 << ". " << lLocation.toSingleLocationString()
-			 << std::endl;
-
-            // List of extra matching locations (those with the same
-            // matching weight/percentage)
-            const LocationList_T& lExtraLocationList =
-              lLocation.getExtraLocationList();
-            if (lExtraLocationList.empty() == false) {
-              oDetailedStr << "  Extra matches: " << std::endl;
-
-              NbOfMatches_T idxExtra = 0;
-              for (LocationList_T::const_iterator itLoc =
-                     lExtraLocationList.begin();
-                   itLoc != lExtraLocationList.end(); ++itLoc, ++idxExtra) {
-                oNoDetailedStr << ":";
-                oDetailedStr << "    " << idx+1 << "." << idxExtra+1 << ". ";
-
-                const Location& lExtraLocation = *itLoc;
-                oNoDetailedStr << lExtraLocation.getIataCode();
-                oDetailedStr << lExtraLocation << std::endl;
-              }
-            }
-
-            // The matching weight/percentage is the same for the main
-            // and the extra matching locations
-            oNoDetailedStr << "/" << lLocation.getPercentage();
-            
-            // List of alternate matching locations (those with a lower
-            // matching weight/percentage)
-            const LocationList_T& lAlternateLocationList =
-              lLocation.getAlternateLocationList();
-            if (lAlternateLocationList.empty() == false) {
-              oDetailedStr << "  Alternate matches: " << std::endl;
-
-              NbOfMatches_T idxAlter = 0;
-              for (LocationList_T::const_iterator itLoc =
-                     lAlternateLocationList.begin();
-                   itLoc != lAlternateLocationList.end(); ++itLoc, ++idxAlter) {
-                oNoDetailedStr << "-";
-                oDetailedStr << "    " << idx+1 << "." << idxAlter+1 << ". ";
-
-                const Location& lAlternateLocation = *itLoc;
-                oNoDetailedStr << lAlternateLocation.getIataCode()
-                               << "/" << lAlternateLocation.getPercentage();
-                oDetailedStr << lAlternateLocation << std::endl;
-              }
-            }
-          }
+        // Only the requested (short or full) version is built
+        const WordList_T lNonMatchedWordList;
+        if (iOutputFormat == OutputFormat::SHORT) {
+          exportShortResult (oNoDetailedStr, lLocationList,
+                             lNonMatchedWordList);
+        } else if (iOutputFormat == OutputFormat::FULL) {
+          exportFullResult (oDetailedStr, lLocationList, lNonMatchedWordList);
         }
 
         // DEBUG
@@ -615,13 +1825,26 @@ namespace OPENTREP {
                           << " yielded:" << std::endl;
 
         // Export the list of Location objects into a JSON-formatted string
-        BomJSONExport::jsonExportLocationList (oJSONStr, lLocationList);
+        if (iOutputFormat == OutputFormat::JSON) {
+          BomJSONExport::jsonExportLocationList (oJSONStr, lLocationList);
+        }
 
-        // Export the list of Location objects into a Protobuf-formatted string
-        WordList_T lNonMatchedWordList;
-        oProtobufStr << LocationExchange::exportLocationList(lLocationList,
-                                                             lNonMatchedWordList)
-                     << std::flush;
+        // Export the list of Location objects in Protobuf format, directly
+        // into a Python bytes object when one is expected
+        if (iOutputFormat == OutputFormat::PROTOBUF) {
+          exportLocationListToPB (lLocationList, lNonMatchedWordList,
+                                  oProtobufString, ioPBObj_ptr);
+        }
+
+        // Export the list of Location objects in CSV or TSV format,
+        // with all the columns
+        if (iOutputFormat == OutputFormat::CSV
+            || iOutputFormat == OutputFormat::TSV) {
+          const char lDelimiter = BomDSVExport::getDelimiter (iOutputFormat);
+          BomDSVExport::dsvExportLocationList (oDSVString, lLocationList,
+                                               DSVColumn::getAllColumns(),
+                                               lDelimiter, true);
+        }
 
       } catch (const RootException& eOpenTrepError) {
         *_logOutputStream << "OpenTrep error: "  << eOpenTrepError.what()
@@ -666,13 +1889,27 @@ namespace OPENTREP {
 
       case OutputFormat::PROTOBUF: {
         // DEBUG
-        const std::string& oProtobufString = oProtobufStr.str();
+        if (ioPBObj_ptr != NULL && ioPBObj_ptr->is_none() == false) {
+          *_logOutputStream << "Protobuf version ("
+                            << bp::len (*ioPBObj_ptr) << " bytes)"
+                            << std::endl;
+          return oEmptyStr;
+        }
         *_logOutputStream << "Protobuf version ("
                           << oProtobufString.size() << " char): "
                           << oProtobufString << std::endl;
         return oProtobufString;
       }
 
+      case OutputFormat::CSV:
+      case OutputFormat::TSV: {
+        // DEBUG
+        *_logOutputStream << OutputFormat::getLabel (iOutputFormat)
+                          << " version (" << oDSVString.size() << " char): "
+                          << oDSVString << std::endl;
+        return oDSVString;
+      }
+
       default: {
         // If the output format is not known, an exception is thrown by
         // the call to the OutputFormat() constructor above.
@@ -684,11 +1921,299 @@ namespace OPENTREP {
       return oEmptyStr;
     }
 
+    /**
+     * Private wrapper around the nearby (geographical) search use case.
+     */
+    std::string findNearbyImpl (const Latitude_T& iLatitude,
+                                const Longitude_T& iLongitude,
+                                const Distance_T& iRadius,
+                                const NbOfMatches_T& iK,
+                                const std::string& iFeatureFilter,
+                                const OutputFormat::EN_OutputFormat& iOutputFormat) {
+      std::ostringstream oStr;
+
+      // Sanity check
+      if (_logOutputStream == NULL) {
+        oStr << "The log filepath is not valid." << std::endl;
+        return oStr.str();
+      }
+      assert (_logOutputStream != NULL);
+
+      // The log stream is shared with the threads of the library
+      LogLock_T lLogLock (Logger::instance().getStreamMutex());
+
+      try {
+
+        // DEBUG
+        *_logOutputStream << "Nearby search around (" << iLatitude << ", "
+                          << iLongitude << "), within " << iRadius
+                          << " km, for " << iK << " POR of type '"
+                          << iFeatureFilter << "'" << std::endl;
+
+        if (_opentrepService == NULL) {
+          oStr << "The OpenTREP service has not been initialized, "
+               << "i.e., the init() method has not been called "
+               << "correctly on the OpenTrepSearcher object. Please "
+               << "check that all the parameters are not empty and "
+               << "point to actual files.";
+          *_logOutputStream << oStr.str();
+          return oStr.str();
+        }
+        assert (_opentrepService != NULL);
+
+        // Query the spatial index. The other Python threads may run
+        // in the meantime.
+        LocationList_T lLocationList;
+        NbOfMatches_T nbOfMatches = 0;
+        {
+          LogUnlock_T lLogUnlock (lLogLock);
+          ScopedGILRelease lGILRelease;
+          nbOfMatches =
+            _opentrepService->findNearby (iLatitude, iLongitude, iRadius, iK,
+                                          iFeatureFilter, lLocationList);
+        }
+
+        // DEBUG
+        *_logOutputStream << "Python nearby search gave " << nbOfMatches
+                          << " matches." << std::endl;
+
+        // Only the requested output format is built
+        switch (iOutputFormat) {
+        case OutputFormat::SHORT:
+        case OutputFormat::FULL: {
+          NbOfMatches_T idx = 0;
+          for (LocationList_T::const_iterator itLocation =
+                 lLocationList.begin();
+               itLocation != lLocationList.end(); ++itLocation, ++idx) {
+            const Location& lLocation = *itLocation;
+            const Distance_T lDistance =
+              calculateGreatCircleDistance (iLatitude, iLongitude,
+                                            lLocation.getLatitude(),
+                                            lLocation.getLongitude());
+            if (iOutputFormat == OutputFormat::SHORT) {
+              if (idx != 0) {
+                oStr << ",";
+              }
+              oStr << lLocation.getIataCode() << "/" << lDistance;
+
+            } else {
+              oStr << idx+1 << ". " << lLocation.toSingleLocationString()
+                   << " - Distance: " << lDistance << " km" << std::endl;
+            }
+          }
+          break;
+        }
+
+        case OutputFormat::JSON: {
+          // Export the list of Location objects into a JSON-formatted string
+          BomJSONExport::jsonExportLocationList (oStr, lLocationList);
+          break;
+        }
+
+        case OutputFormat::PROTOBUF: {
+          // Export the list of Location objects into a Protobuf-formatted
+          // string
+          WordList_T lNonMatchedWordList;
+          oStr << LocationExchange::exportLocationList (lLocationList,
+                                                        lNonMatchedWordList)
+               << std::flush;
+          break;
+        }
+
+        case OutputFormat::CSV:
+        case OutputFormat::TSV: {
+          // Export the list of Location objects in CSV or TSV format,
+          // with all the columns
+          const char lDelimiter = BomDSVExport::getDelimiter (iOutputFormat);
+          BomDSVExport::dsvExportLocationList (oStr, lLocationList,
+                                               DSVColumn::getAllColumns(),
+                                               lDelimiter, true);
+          break;
+        }
+
+        default: {
+          // If the output format is not known, an exception is thrown by
+          // the call to the OutputFormat() constructor above.
+          assert (false);
+        }
+        }
+
+      } catch (const RootException& eOpenTrepError) {
+        *_logOutputStream << "OpenTrep error: "  << eOpenTrepError.what()
+                          << std::endl;
+
+      } catch (const std::exception& eStdError) {
+        *_logOutputStream << "Error: "  << eStdError.what() << std::endl;
+
+      } catch (...) {
+        *_logOutputStream << "Unknown error" << std::endl;
+      }
+
+      return oStr.str();
+    }
+
+    /**
+     * Convert the given Python list, the items of which are either all
+     * codes (strings) or all (latitude, longitude) pairs, into either
+     * a list of codes or a list of locations.
+     *
+     * @return bool Whether the items are codes (true for an empty list).
+     */
+    static bool extractDistanceMatrixItems (const bp::list& iItemList,
+                                            WordList_T& ioCodeList,
+                                            LocationList_T& ioLocationList) {
+      bool areCodes = true;
+      const ssize_t lNbOfItems = bp::len (iItemList);
+      for (ssize_t idx = 0; idx != lNbOfItems; ++idx) {
+        const bp::object lItem = iItemList[idx];
+        const bp::extract<std::string> lCodeExtractor (lItem);
+        const bool isCode = lCodeExtractor.check();
+        if (idx == 0) {
+          areCodes = isCode;
+        }
+
+        if (isCode == true && areCodes == true) {
+          const std::string lCode = lCodeExtractor();
+          ioCodeList.push_back (lCode);
+          continue;
+        }
+
+        const bool isPair = (isCode == false && areCodes == false
+                             && bp::len (lItem) == 2);
+        if (isPair == false) {
+          PyErr_SetString (PyExc_TypeError, "The items of a list must be "
+                           "either all codes (strings) or all (latitude, "
+                           "longitude) pairs");
+          bp::throw_error_already_set();
+        }
+        Location lLocation;
+        lLocation.setLatitude (bp::extract<double> (lItem[0]));
+        lLocation.setLongitude (bp::extract<double> (lItem[1]));
+        ioLocationList.push_back (lLocation);
+      }
+
+      return areCodes;
+    }
+
+    /**
+     * Private wrapper around the distance matrix use case, for locations.
+     */
+    void distanceMatrixImpl (const LocationList_T& iRowLocationList,
+                             const LocationList_T& iColLocationList,
+                             DistanceMatrix_T& ioDistanceMatrix) {
+      // Sanity check
+      if (_logOutputStream == NULL) {
+        return;
+      }
+      assert (_logOutputStream != NULL);
+
+      // The log stream is shared with the threads of the library
+      LogLock_T lLogLock (Logger::instance().getStreamMutex());
+
+      try {
+
+        // DEBUG
+        *_logOutputStream << "Distance matrix between "
+                          << iRowLocationList.size() << " and "
+                          << iColLocationList.size() << " locations"
+                          << std::endl;
+
+        if (_opentrepService == NULL) {
+          *_logOutputStream << "The OpenTREP service has not been initialized, "
+                            << "i.e., the init() method has not been called "
+                            << "correctly on the OpenTrepSearcher object. "
+                            << "Please check that all the parameters are not "
+                            << "empty and point to actual files." << std::endl;
+          return;
+        }
+        assert (_opentrepService != NULL);
+
+        // The other Python threads may run in the meantime
+        {
+          LogUnlock_T lLogUnlock (lLogLock);
+          ScopedGILRelease lGILRelease;
+          _opentrepService->calculateDistanceMatrix (iRowLocationList,
+                                                     iColLocationList,
+                                                     ioDistanceMatrix);
+        }
+
+      } catch (const RootException& eOpenTrepError) {
+        *_logOutputStream << "OpenTrep error: "  << eOpenTrepError.what()
+                          << std::endl;
+
+      } catch (const std::exception& eStdError) {
+        *_logOutputStream << "Error: "  << eStdError.what() << std::endl;
+
+      } catch (...) {
+        *_logOutputStream << "Unknown error" << std::endl;
+      }
+    }
+
+    /**
+     * Private wrapper around the distance matrix use case, for codes.
+     */
+    void distanceMatrixImpl (const WordList_T& iRowCodeList,
+                             const WordList_T& iColCodeList,
+                             DistanceMatrix_T& ioDistanceMatrix) {
+      // Sanity check
+      if (_logOutputStream == NULL) {
+        return;
+      }
+      assert (_logOutputStream != NULL);
+
+      // The log stream is shared with the threads of the library
+      LogLock_T lLogLock (Logger::instance().getStreamMutex());
+
+      try {
+
+        // DEBUG
+        *_logOutputStream << "Distance matrix between "
+                          << iRowCodeList.size() << " and "
+                          << iColCodeList.size() << " codes" << std::endl;
+
+        if (_opentrepService == NULL) {
+          *_logOutputStream << "The OpenTREP service has not been initialized, "
+                            << "i.e., the init() method has not been called "
+                            << "correctly on the OpenTrepSearcher object. "
+                            << "Please check that all the parameters are not "
+                            << "empty and point to actual files." << std::endl;
+          return;
+        }
+        assert (_opentrepService != NULL);
+
+        // The other Python threads may run in the meantime
+        NbOfMatches_T nbOfMatches = 0;
+        {
+          LogUnlock_T lLogUnlock (lLogLock);
+          ScopedGILRelease lGILRelease;
+          nbOfMatches =
+            _opentrepService->calculateDistanceMatrix (iRowCodeList,
+                                                       iColCodeList,
+                                                       ioDistanceMatrix);
+        }
+
+        // DEBUG
+        *_logOutputStream << "Python distance matrix resolved " << nbOfMatches
+                          << " distinct codes." << std::endl;
+
+      } catch (const RootException& eOpenTrepError) {
+        *_logOutputStream << "OpenTrep error: "  << eOpenTrepError.what()
+                          << std::endl;
+
+      } catch (const std::exception& eStdError) {
+        *_logOutputStream << "Error: "  << eStdError.what() << std::endl;
+
+      } catch (...) {
+        *_logOutputStream << "Unknown error" << std::endl;
+      }
+    }
+
   public:
     /** 
      * Default constructor. 
      */
-    OpenTrepSearcher() : _opentrepService (NULL), _logOutputStream (NULL) {
+    OpenTrepSearcher() : _opentrepService (NULL), _logOutputStream (NULL),
+                         _asyncSearchPool (NULL) {
     }
 
     /**
@@ -696,7 +2221,8 @@ namespace OPENTREP {
      */
     OpenTrepSearcher (const OpenTrepSearcher& iOpenTrepSearcher)
       : _opentrepService (iOpenTrepSearcher._opentrepService),
-        _logOutputStream (iOpenTrepSearcher._logOutputStream) {
+        _logOutputStream (iOpenTrepSearcher._logOutputStream),
+        _asyncSearchPool (iOpenTrepSearcher._asyncSearchPool) {
     }
 
     /** 
@@ -705,6 +2231,7 @@ namespace OPENTREP {
     ~OpenTrepSearcher() {
       _opentrepService = NULL;
       _logOutputStream = NULL;
+      _asyncSearchPool = NULL;
     }
 
     /** 
@@ -804,6 +2331,9 @@ namespace OPENTREP {
 
       try {
         
+        // Stop the asynchronous search, before the service be deleted
+        stopAsyncSearch();
+
         // Finalize the context
         if (_opentrepService != NULL) {
           delete _opentrepService; _opentrepService = NULL;
@@ -829,18 +2359,39 @@ namespace OPENTREP {
      */
     OPENTREP_Service* _opentrepService;
     std::ofstream* _logOutputStream;
+
+    /**
+     * Pool of threads of the asynchronous search, started when needed.
+     */
+    AsyncSearchPool* _asyncSearchPool;
   };
 
 }
 
 // /////////////////////////////////////////////////////////////
 BOOST_PYTHON_MODULE(pyopentrep) {
+  // Raised by searchAsync(), when the submission queue is full
+  boost::python::scope().attr ("AsyncSearchQueueFull") =
+    boost::python::object (boost::python::handle<>
+                           (boost::python::borrowed
+                            (OPENTREP::getAsyncSearchQueueFullType())));
+
   boost::python::class_<OPENTREP::OpenTrepSearcher> ("OpenTrepSearcher")
     .def ("index", &OPENTREP::OpenTrepSearcher::index)
     .def ("search", &OPENTREP::OpenTrepSearcher::search)
     .def ("searchToPB", &OPENTREP::OpenTrepSearcher::searchToPB)
+    .def ("searchWithOrigin", &OPENTREP::OpenTrepSearcher::searchWithOrigin)
+    .def ("searchToDSV", &OPENTREP::OpenTrepSearcher::searchToDSV)
+    .def ("searchMany", &OPENTREP::OpenTrepSearcher::searchMany)
+    .def ("searchAsync", &OPENTREP::OpenTrepSearcher::searchAsync)
+    .def ("waitAsyncSearchSlot",
+          &OPENTREP::OpenTrepSearcher::waitAsyncSearchSlot)
+    .def ("startAsyncSearch", &OPENTREP::OpenTrepSearcher::startAsyncSearch)
+    .def ("stopAsyncSearch", &OPENTREP::OpenTrepSearcher::stopAsyncSearch)
     .def ("generate", &OPENTREP::OpenTrepSearcher::generate)
     .def ("generateToPB", &OPENTREP::OpenTrepSearcher::generateToPB)
+    .def ("findNearby", &OPENTREP::OpenTrepSearcher::findNearby)
+    .def ("distanceMatrix", &OPENTREP::OpenTrepSearcher::distanceMatrix)
     .def ("getPaths", &OPENTREP::OpenTrepSearcher::getPaths)
     .def ("init", &OPENTREP::OpenTrepSearcher::init)
     .def ("finalize", &OPENTREP::OpenTrepSearcher::finalize);
@@ -0,0 +1,207 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+// Boost
+#include <boost/make_shared.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+// OpenTrep
+#include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
+#include <opentrep/command/FileManager.hpp>
+#include <opentrep/service/OPENTREP_ServiceContext.hpp>
+#include <opentrep/service/IndexHotSwapper.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  SearchIndexHandlePtr_T
+  openIndexHandle (const OPENTREP_ServiceContext& iServiceContext,
+                   const DeploymentNumber_T& iDeploymentNumber,
+                   const std::string& iReadyStamp) {
+    const TravelDBFilePath_T& lTravelDBFilePath =
+      iServiceContext.getTravelDBFilePath (iDeploymentNumber);
+    const SQLDBConnectionString_T& lSQLDBConnStr =
+      iServiceContext.getSQLDBConnectionString (iDeploymentNumber);
+
+    SearchIndexHandlePtr_T oIndexHandle_ptr =
+      boost::make_shared<SearchIndexHandle> (iDeploymentNumber,
+                                             lTravelDBFilePath,
+                                             iServiceContext.getSQLDBType(),
+                                             lSQLDBConnStr,
+                                             iServiceContext.getSQLDBLoadMode(),
+                                             iReadyStamp);
+    oIndexHandle_ptr->warm();
+    return oIndexHandle_ptr;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  IndexHotSwapper::IndexHotSwapper (OPENTREP_ServiceContext& ioServiceContext)
+    : _serviceContext (ioServiceContext),
+      _pollingPeriod (DEFAULT_OPENTREP_HOT_SWAP_POLLING_PERIOD),
+      _shouldStop (false) {
+    // Open the current deployment. When it cannot be opened, the searches
+    // go on opening the Xapian index for every query, until the other
+    // deployment becomes ready.
+    const DeploymentNumber_T& lDeploymentNumber =
+      _serviceContext.getDeploymentNumber();
+    const TravelDBFilePath_T& lTravelDBFilePath =
+      _serviceContext.getTravelDBFilePath();
+    const std::string& lReadyStamp =
+      FileManager::readReadyMarker (lTravelDBFilePath);
+    try {
+      const SearchIndexHandlePtr_T& lIndexHandle_ptr =
+        openIndexHandle (_serviceContext, lDeploymentNumber, lReadyStamp);
+      _serviceContext.setActiveIndexHandle (lIndexHandle_ptr);
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("The searches now use "
+                          << lIndexHandle_ptr->describe());
+
+    } catch (const std::exception& lException) {
+      OPENTREP_LOG_ERROR ("The deployment #" << lDeploymentNumber
+                          << " cannot be opened: " << lException.what());
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  IndexHotSwapper::~IndexHotSwapper() {
+    stop();
+
+    // Deactivate the handle; it is destroyed once the last search using
+    // it is over
+    _serviceContext.setActiveIndexHandle (SearchIndexHandlePtr_T());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  bool IndexHotSwapper::checkAndSwap() {
+    boost::mutex::scoped_lock lSwapLock (_swapMutex);
+
+    // Retrieve the deployment currently in use
+    const SearchIndexHandlePtr_T& lActiveHandle_ptr =
+      _serviceContext.getActiveIndexHandle();
+    DeploymentNumber_T lDeploymentNumber =
+      _serviceContext.getDeploymentNumber();
+    std::string lActiveReadyStamp;
+    if (lActiveHandle_ptr != NULL) {
+      lDeploymentNumber = lActiveHandle_ptr->getDeploymentNumber();
+      lActiveReadyStamp = lActiveHandle_ptr->getReadyStamp();
+    }
+
+    // Check whether the deployment currently in use has been marked as
+    // ready again (e.g., updated in place by IndexUpdater), or whether
+    // the other deployment has been marked as ready, more recently than
+    // the handle in use (the ISO date-times compare as strings). The most
+    // recent of them is opened, so that the in-memory copy of the SQL
+    // database, if any, is refreshed as well.
+    const TravelDBFilePath_T& lTravelDBFilePath =
+      _serviceContext.getTravelDBFilePath (lDeploymentNumber);
+    const std::string& lReadyStamp =
+      FileManager::readReadyMarker (lTravelDBFilePath);
+    DeploymentNumber_T lNewDeploymentNumber = lDeploymentNumber;
+    std::string lNewReadyStamp;
+    if (lReadyStamp.empty() == false && lActiveReadyStamp < lReadyStamp) {
+      lNewReadyStamp = lReadyStamp;
+    }
+
+    // The other deployment
+    DeploymentNumber_T lOtherDeploymentNumber = lDeploymentNumber + 1;
+    if (lOtherDeploymentNumber >= DEFAULT_OPENTREP_DEPLOYMENT_NUMBER_SIZE) {
+      lOtherDeploymentNumber = DEFAULT_OPENTREP_DEPLOYMENT_NUMBER;
+    }
+    if (lOtherDeploymentNumber != lDeploymentNumber) {
+      const TravelDBFilePath_T& lOtherTravelDBFilePath =
+        _serviceContext.getTravelDBFilePath (lOtherDeploymentNumber);
+      const std::string& lOtherReadyStamp =
+        FileManager::readReadyMarker (lOtherTravelDBFilePath);
+      if (lOtherReadyStamp.empty() == false
+          && lActiveReadyStamp < lOtherReadyStamp
+          && lNewReadyStamp < lOtherReadyStamp) {
+        lNewDeploymentNumber = lOtherDeploymentNumber;
+        lNewReadyStamp = lOtherReadyStamp;
+      }
+    }
+
+    if (lNewReadyStamp.empty() == true) {
+      return false;
+    }
+
+    // Open and warm up the new version, while the searches go on
+    // with the current one
+    SearchIndexHandlePtr_T lNewHandle_ptr;
+    try {
+      lNewHandle_ptr = openIndexHandle (_serviceContext, lNewDeploymentNumber,
+                                        lNewReadyStamp);
+
+    } catch (const std::exception& lException) {
+      OPENTREP_LOG_ERROR ("The deployment #" << lNewDeploymentNumber
+                          << " is marked as ready, but cannot be opened: "
+                          << lException.what() << ". The searches go on with "
+                          << "the deployment #" << lDeploymentNumber);
+      return false;
+    }
+    assert (lNewHandle_ptr != NULL);
+
+    // Swap
+    _serviceContext.setActiveIndexHandle (lNewHandle_ptr);
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Hot-swapped from the deployment #"
+                        << lDeploymentNumber << ": the searches now use "
+                        << lNewHandle_ptr->describe());
+
+    return true;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexHotSwapper::start (const PollingPeriod_T& iPollingPeriod) {
+    stop();
+
+    _pollingPeriod = iPollingPeriod;
+    _shouldStop = false;
+    _watcherThread = boost::thread (boost::bind (&IndexHotSwapper::watch,
+                                                 this));
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexHotSwapper::stop() {
+    if (_watcherThread.joinable() == false) {
+      return;
+    }
+
+    {
+      boost::mutex::scoped_lock lStopLock (_stopMutex);
+      _shouldStop = true;
+    }
+    _stopRequested.notify_all();
+    _watcherThread.join();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void IndexHotSwapper::watch() {
+    const boost::posix_time::milliseconds lPollingPeriod (_pollingPeriod);
+
+    boost::mutex::scoped_lock lStopLock (_stopMutex);
+    while (_shouldStop == false) {
+      // Wait for the polling period, or for the stop request
+      _stopRequested.timed_wait (lStopLock, lPollingPeriod);
+      if (_shouldStop == true) {
+        break;
+      }
+
+      // Check, without preventing the stop request
+      lStopLock.unlock();
+      try {
+        checkAndSwap();
+      } catch (const std::exception& lException) {
+        OPENTREP_LOG_ERROR ("Error when checking for a new deployment: "
+                            << lException.what());
+      }
+      lStopLock.lock();
+    }
+  }
+
+}
@@ -0,0 +1,124 @@
+#ifndef __OPENTREP_SVC_INDEXHOTSWAPPER_HPP
+#define __OPENTREP_SVC_INDEXHOTSWAPPER_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// Boost
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+
+namespace OPENTREP {
+
+  // Forward declarations
+  class OPENTREP_ServiceContext;
+
+  /**
+   * @brief Watcher hot-swapping, without any downtime, the Xapian index
+   *        and SQL database used by the searches, when a new version of
+   *        the other deployment is ready.
+   *
+   * The indexer (see IndexBuilder and IndexUpdater) writes a ready marker
+   * within the directory of the Xapian index, once that latter has been
+   * successfully built or updated. When the marker of the other deployment
+   * is more recent than the one of the deployment currently in use, the
+   * watcher opens and warms up the Xapian index and SQL database of the
+   * other deployment, and then swaps, atomically, the handle used by the
+   * searches (see SearchIndexHandle). The searches in progress go on with
+   * the former handle, the connections of which are closed once the last
+   * of those searches is over.
+   *
+   * Likewise, when the deployment currently in use is marked as ready
+   * again (e.g., once updated in place by IndexUpdater), a new handle is
+   * opened on that same deployment, so that the searches see the new
+   * version of both the Xapian index and the (possibly in-memory) SQL
+   * database.
+   *
+   * The check may be triggered either synchronously (see checkAndSwap()),
+   * or periodically by a background thread (see start()).
+   */
+  class IndexHotSwapper {
+  public:
+    /**
+     * Constructor. The handle on the current deployment is opened,
+     * warmed up and made active.
+     *
+     * @param OPENTREP_ServiceContext& Context of the services.
+     */
+    IndexHotSwapper (OPENTREP_ServiceContext&);
+
+    /**
+     * Destructor: stop the background thread, if any, and deactivate
+     * the handle (the searches then fall back on opening the Xapian
+     * index and SQL database for every query).
+     */
+    ~IndexHotSwapper();
+
+    /**
+     * Check whether a new version of the current or of the other deployment
+     * is ready and, if so, hot-swap to it. When the new version cannot be
+     * opened, the searches go on with the current one.
+     *
+     * @return bool Whether the deployment has been swapped.
+     */
+    bool checkAndSwap();
+
+    /**
+     * Start the background thread, checking periodically whether a new
+     * version of the other deployment is ready.
+     *
+     * @param const PollingPeriod_T& Period, in milliseconds, of the checks.
+     */
+    void start (const PollingPeriod_T&);
+
+    /**
+     * Stop the background thread, if started.
+     */
+    void stop();
+
+  private:
+    /**
+     * Body of the background thread.
+     */
+    void watch();
+
+    /**
+     * Default constructor (not implemented).
+     */
+    IndexHotSwapper();
+
+    /**
+     * Copy constructor (not implemented).
+     */
+    IndexHotSwapper (const IndexHotSwapper&);
+
+
+  private:
+    // ////////////// Attributes ///////////////
+    /**
+     * Context of the services, holding the active handle.
+     */
+    OPENTREP_ServiceContext& _serviceContext;
+
+    /**
+     * Mutex serialising the checks (the synchronous ones and the ones
+     * of the background thread).
+     */
+    boost::mutex _swapMutex;
+
+    /**
+     * Background thread, its polling period, and the stop flag, protected
+     * by the mutex, the condition being signalled when the flag is set.
+     */
+    boost::thread _watcherThread;
+    PollingPeriod_T _pollingPeriod;
+    bool _shouldStop;
+    boost::mutex _stopMutex;
+    boost::condition_variable _stopRequested;
+  };
+
+}
+#endif // __OPENTREP_SVC_INDEXHOTSWAPPER_HPP
@@ -10,6 +10,9 @@
 #include <string>
 // Boost Date-Time
 #include <boost/date_time.hpp>
+// Boost Thread
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/locks.hpp>
 // OpenTREP
 #include <opentrep/OPENTREP_Types.hpp>
 
@@ -64,6 +67,10 @@ namespace OPENTREP {
 	boost::posix_time::ptime lTimeUTC =
           boost::posix_time::second_clock::universal_time();
 
+        // Several threads (e.g., the ones of the indexing pipeline)
+        // may log at once
+        boost::lock_guard<boost::recursive_mutex> lLock (_mutex);
+
         // Add some context and write down the log element
         *_logStream << "[" << lTimeUTC << "][" << iFileName << "#"
                     << iLineNumber << "]:" << iToBeLogged << std::endl;
@@ -80,6 +87,16 @@ namespace OPENTREP {
      */
     std::ostream& getLogStream();
     
+    /**
+     * Get the mutex serialising the writing into the log stream. The code
+     * writing directly into the log stream (e.g., the Python extension,
+     * while other threads search) must hold it. As it is recursive, the log
+     * macros may still be used by the thread holding it.
+     */
+    boost::recursive_mutex& getStreamMutex() {
+      return _mutex;
+    }
+    
     /**
      * Set the logger parameters (level and stream).
      */
@@ -115,6 +132,11 @@ namespace OPENTREP {
      * Stream dedicated to the logs.
      */
     std::ostream* _logStream;
+
+    /**
+     * Mutex serialising the writing of the log elements.
+     */
+    boost::recursive_mutex _mutex;
     
     /**
      * Singleton/Instance object.
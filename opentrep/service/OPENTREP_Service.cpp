@@ -4,30 +4,113 @@
 // STL
 #include <cassert>
 #include <ostream>
+#include <limits>
+#include <map>
 // Boost
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/posix_time/ptime.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/mutex.hpp>
+// Xapian
+#include <xapian.h>
 // SOCI
 #include <soci/soci.h>
 // OpenTrep
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
+#include <opentrep/OriginHint.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
 #include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
 #include <opentrep/basic/BasChronometer.hpp>
+#include <opentrep/basic/GeoDistance.hpp>
 #include <opentrep/factory/FacWorld.hpp>
+#include <opentrep/bom/PORSpatialIndex.hpp>
+#include <opentrep/bom/PORParserHelper.hpp>
+#include <opentrep/command/ColumnarExporter.hpp>
 #include <opentrep/command/DBManager.hpp>
 #include <opentrep/command/FileManager.hpp>
 #include <opentrep/command/IndexBuilder.hpp>
+#include <opentrep/command/IndexUpdater.hpp>
 #include <opentrep/command/XapianIndexManager.hpp>
 #include <opentrep/command/RequestInterpreter.hpp>
 #include <opentrep/factory/FacOpenTrepServiceContext.hpp>
 #include <opentrep/service/OPENTREP_ServiceContext.hpp>
+#include <opentrep/service/IndexHotSwapper.hpp>
 #include <opentrep/service/ServiceUtilities.hpp>
 #include <opentrep/service/Logger.hpp>
 #include <opentrep/OPENTREP_Service.hpp>
 
 namespace OPENTREP {
 
+  /**
+   * @brief SQL database session used by a look-up by code.
+   *
+   * When the index has been hot-swapped, a session of the active deployment
+   * is borrowed from its pool (see SearchIndexHandle). Otherwise, it is
+   * borrowed from the pool of the current deployment (see SQLSessionPool).
+   * Either way, the statements already prepared on that session (see
+   * SelectStatementCache) are reused from a look-up to the next one.
+   */
+  class CodeLookupSession {
+  public:
+    /**
+     * Constructor: borrow the SQL database session.
+     */
+    CodeLookupSession (OPENTREP_ServiceContext& ioServiceContext)
+      : _indexHandle_ptr (ioServiceContext.getActiveIndexHandle()),
+        _indexHandleLease_ptr (NULL), _sqlSessionPoolLease_ptr (NULL),
+        _selectStatementCache_ptr (NULL) {
+      if (_indexHandle_ptr != NULL) {
+        _indexHandleLease_ptr =
+          new SearchIndexHandle::Lease (*_indexHandle_ptr);
+        _selectStatementCache_ptr =
+          _indexHandleLease_ptr->getSelectStatementCachePtr();
+        if (_selectStatementCache_ptr != NULL) {
+          return;
+        }
+        delete _indexHandleLease_ptr; _indexHandleLease_ptr = NULL;
+      }
+
+      _sqlSessionPool_ptr = ioServiceContext.getSQLSessionPool();
+      if (_sqlSessionPool_ptr == NULL) {
+        std::ostringstream errorStr;
+        errorStr << "No SQL database is used by the services; the POR "
+                 << "cannot be looked up by their codes";
+        OPENTREP_LOG_ERROR (errorStr.str());
+        throw SQLDatabaseImpossibleConnectionException (errorStr.str());
+      }
+      _sqlSessionPoolLease_ptr =
+        new SQLSessionPool::Lease (*_sqlSessionPool_ptr);
+      _selectStatementCache_ptr =
+        &_sqlSessionPoolLease_ptr->getSelectStatementCache();
+      assert (_selectStatementCache_ptr != NULL);
+    }
+
+    /**
+     * Destructor: give the session back to its pool.
+     */
+    ~CodeLookupSession() {
+      _selectStatementCache_ptr = NULL;
+      delete _sqlSessionPoolLease_ptr; _sqlSessionPoolLease_ptr = NULL;
+      delete _indexHandleLease_ptr; _indexHandleLease_ptr = NULL;
+    }
+
+    /**
+     * Get the statements prepared on the SQL database session.
+     */
+    SelectStatementCache& getSelectStatementCache() const {
+      assert (_selectStatementCache_ptr != NULL);
+      return *_selectStatementCache_ptr;
+    }
+
+  private:
+    const SearchIndexHandlePtr_T _indexHandle_ptr;
+    SearchIndexHandle::Lease* _indexHandleLease_ptr;
+    SQLSessionPoolPtr_T _sqlSessionPool_ptr;
+    SQLSessionPool::Lease* _sqlSessionPoolLease_ptr;
+    SelectStatementCache* _selectStatementCache_ptr;
+  };
+
   // //////////////////////////////////////////////////////////////////////
   OPENTREP_Service::
   OPENTREP_Service (std::ostream& ioLogStream, const PORFilePath_T& iPORFilepath,
@@ -38,7 +121,7 @@ namespace OPENTREP {
                     const shouldIndexNonIATAPOR_T& iShouldIndexNonIATAPOR,
                     const shouldIndexPORInXapian_T& iShouldIndexPORInXapian,
                     const shouldAddPORInSQLDB_T& iShouldAddPORInSQLDB)
-    : _opentrepServiceContext (NULL) {
+    : _opentrepServiceContext (NULL), _indexHotSwapper (NULL) {
     init (ioLogStream, iPORFilepath, iTravelDBFilePath, iSQLDBType,
           iSQLDBConnStr, iDeploymentNumber, iShouldIndexNonIATAPOR,
           iShouldIndexPORInXapian, iShouldAddPORInSQLDB);
@@ -51,13 +134,14 @@ namespace OPENTREP {
                     const DBType& iSQLDBType,
                     const SQLDBConnectionString_T& iSQLDBConnStr,
                     const DeploymentNumber_T& iDeploymentNumber)
-    : _opentrepServiceContext (NULL) {
+    : _opentrepServiceContext (NULL), _indexHotSwapper (NULL) {
     init (ioLogStream, iTravelDBFilePath, iSQLDBType, iSQLDBConnStr,
           iDeploymentNumber);
   }
 
   // //////////////////////////////////////////////////////////////////////
-  OPENTREP_Service::OPENTREP_Service() : _opentrepServiceContext (NULL) {
+  OPENTREP_Service::OPENTREP_Service()
+    : _opentrepServiceContext (NULL), _indexHotSwapper (NULL) {
     assert (false);
   }
 
@@ -154,6 +238,8 @@ namespace OPENTREP {
   
   // //////////////////////////////////////////////////////////////////////
   void OPENTREP_Service::finalise() {
+    // Stop the hot-swap, if started
+    delete _indexHotSwapper; _indexHotSwapper = NULL;
   }
 
   // //////////////////////////////////////////////////////////////////////
@@ -247,6 +333,29 @@ namespace OPENTREP {
     assert (_opentrepServiceContext != NULL);
     OPENTREP_ServiceContext& lOPENTREP_ServiceContext= *_opentrepServiceContext;
 
+    // When hot-swapped, the draws are made on the Xapian index of the
+    // deployment currently in use, kept open
+    const SearchIndexHandlePtr_T lIndexHandle_ptr =
+      lOPENTREP_ServiceContext.getActiveIndexHandle();
+    if (lIndexHandle_ptr != NULL) {
+      BasChronometer lRandomGetChronometer; lRandomGetChronometer.start();
+      {
+        SearchIndexHandle::Lease lLease (*lIndexHandle_ptr);
+        oNbOfMatches =
+          XapianIndexManager::drawRandomLocations (lLease.getXapianDatabase(),
+                                                   iNbOfDraws,
+                                                   ioLocationList);
+      }
+      const double lRandomGetMeasure = lRandomGetChronometer.elapsed();
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("Random retrieval of locations (index) of the "
+                          << lIndexHandle_ptr->describe() << ": "
+                          << lRandomGetMeasure);
+
+      return oNbOfMatches;
+    }
+
     // Retrieve the Xapian database name (directorty of the index)
     const TravelDBFilePath_T& lTravelDBFilePath =
       lOPENTREP_ServiceContext.getTravelDBFilePath();
@@ -266,6 +375,313 @@ namespace OPENTREP {
     return oNbOfMatches;
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T OPENTREP_Service::
+  findNearby (const Latitude_T& iLatitude, const Longitude_T& iLongitude,
+              const Distance_T& iRadius, const NbOfMatches_T& iK,
+              const std::string& iFeatureFilter,
+              LocationList_T& ioLocationList) {
+    NbOfMatches_T oNbOfMatches = 0;
+
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+    assert (_opentrepServiceContext != NULL);
+    OPENTREP_ServiceContext& lOPENTREP_ServiceContext= *_opentrepServiceContext;
+
+    // When hot-swapped, the spatial index of the deployment currently in
+    // use, built along with its warm-up, is searched, and the POR are
+    // retrieved from the Xapian index of that very deployment
+    const SearchIndexHandlePtr_T lIndexHandle_ptr =
+      lOPENTREP_ServiceContext.getActiveIndexHandle();
+    if (lIndexHandle_ptr != NULL) {
+      const PORSpatialIndexPtr_T& lSpatialIndex_ptr =
+        lIndexHandle_ptr->getSpatialIndex();
+      assert (lSpatialIndex_ptr != NULL);
+
+      BasChronometer lFindNearbyChronometer; lFindNearbyChronometer.start();
+      {
+        SearchIndexHandle::Lease lLease (*lIndexHandle_ptr);
+        oNbOfMatches =
+          XapianIndexManager::findNearby (lLease.getXapianDatabase(),
+                                          *lSpatialIndex_ptr,
+                                          iLatitude, iLongitude, iRadius, iK,
+                                          iFeatureFilter, ioLocationList);
+      }
+      const double lFindNearbyMeasure = lFindNearbyChronometer.elapsed();
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("Nearby POR retrieval (index) of the "
+                          << lIndexHandle_ptr->describe() << ": "
+                          << lFindNearbyMeasure);
+
+      return oNbOfMatches;
+    }
+
+    // Retrieve the Xapian database name (directorty of the index)
+    const TravelDBFilePath_T& lTravelDBFilePath =
+      lOPENTREP_ServiceContext.getTravelDBFilePath();
+
+    // Otherwise, the Xapian index of the current deployment is kept open,
+    // along with its spatial index, by a dedicated handle. Reopening
+    // a Xapian database on its latest revision is cheap, and tells
+    // whether the Xapian index has changed; only then is the ready marker
+    // read, as it changes whenever that Xapian index is re-indexed, which
+    // changes the document IDs.
+    BasChronometer lFindNearbyChronometer; lFindNearbyChronometer.start();
+    SearchIndexHandlePtr_T lNearbyIndexHandle_ptr =
+      lOPENTREP_ServiceContext.getNearbyIndexHandle();
+    bool isUpToDate = false;
+    if (lNearbyIndexHandle_ptr != NULL
+        && (lNearbyIndexHandle_ptr->getTravelDBFilePath()
+            == lTravelDBFilePath)) {
+      SearchIndexHandle::Lease lLease (*lNearbyIndexHandle_ptr);
+      Xapian::Database& lXapianDatabase = lLease.getXapianDatabase();
+      const bool hasChanged = lXapianDatabase.reopen();
+      isUpToDate = (hasChanged == false
+                    || (FileManager::readReadyMarker (lTravelDBFilePath)
+                        == lNearbyIndexHandle_ptr->getReadyStamp()));
+      if (isUpToDate == true) {
+        const PORSpatialIndexPtr_T& lSpatialIndex_ptr =
+          lNearbyIndexHandle_ptr->getSpatialIndex();
+        assert (lSpatialIndex_ptr != NULL);
+        oNbOfMatches =
+          XapianIndexManager::findNearby (lXapianDatabase, *lSpatialIndex_ptr,
+                                          iLatitude, iLongitude, iRadius, iK,
+                                          iFeatureFilter, ioLocationList);
+      }
+    }
+
+    if (isUpToDate == false) {
+      // (Re-)open the handle, and build its spatial index, if not already
+      // done by another thread in the meantime. A new handle is published,
+      // the one possibly used by the other searches being left untouched.
+      {
+        boost::mutex::scoped_lock
+          lLock (lOPENTREP_ServiceContext.getNearbyIndexHandleMutex());
+
+        const std::string& lReadyStamp =
+          FileManager::readReadyMarker (lTravelDBFilePath);
+        lNearbyIndexHandle_ptr =
+          lOPENTREP_ServiceContext.getNearbyIndexHandle();
+        if (lNearbyIndexHandle_ptr == NULL
+            || (lNearbyIndexHandle_ptr->getTravelDBFilePath()
+                != lTravelDBFilePath)
+            || lNearbyIndexHandle_ptr->getReadyStamp() != lReadyStamp) {
+          if (checkXapianDBOnFileSystem (lTravelDBFilePath) == false) {
+            std::ostringstream errorStr;
+            errorStr << "The file-path to the Xapian database/index ('"
+                     << lTravelDBFilePath << "') does not exist or is not "
+                     << "a directory.";
+            OPENTREP_LOG_ERROR (errorStr.str());
+            throw FileNotFoundException (errorStr.str());
+          }
+
+          BasChronometer lSpatialIndexChronometer;
+          lSpatialIndexChronometer.start();
+          const DBType lNoSQLDBType (DBType::NODB);
+          const SQLDBConnectionString_T lNoSQLDBConnStr ("");
+          const SQLDBLoadMode lSQLDBLoadMode (SQLDBLoadMode::ON_DISK);
+          lNearbyIndexHandle_ptr = boost::make_shared<SearchIndexHandle>
+            (lOPENTREP_ServiceContext.getDeploymentNumber(), lTravelDBFilePath,
+             lNoSQLDBType, lNoSQLDBConnStr, lSQLDBLoadMode, lReadyStamp);
+          lNearbyIndexHandle_ptr->warm();
+          lOPENTREP_ServiceContext.
+            setNearbyIndexHandle (lNearbyIndexHandle_ptr);
+          const double lSpatialIndexMeasure =
+            lSpatialIndexChronometer.elapsed();
+
+          // DEBUG
+          OPENTREP_LOG_DEBUG ("Opened "
+                              << lNearbyIndexHandle_ptr->describe()
+                              << " for the nearby searches, and built its "
+                              << "spatial index: " << lSpatialIndexMeasure);
+        }
+      }
+      assert (lNearbyIndexHandle_ptr != NULL);
+
+      const PORSpatialIndexPtr_T& lSpatialIndex_ptr =
+        lNearbyIndexHandle_ptr->getSpatialIndex();
+      assert (lSpatialIndex_ptr != NULL);
+      SearchIndexHandle::Lease lLease (*lNearbyIndexHandle_ptr);
+      oNbOfMatches =
+        XapianIndexManager::findNearby (lLease.getXapianDatabase(),
+                                        *lSpatialIndex_ptr,
+                                        iLatitude, iLongitude, iRadius, iK,
+                                        iFeatureFilter, ioLocationList);
+    }
+    const double lFindNearbyMeasure = lFindNearbyChronometer.elapsed();
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Nearby POR retrieval (index): " << lFindNearbyMeasure
+                        << " - " << lOPENTREP_ServiceContext.display());
+
+    return oNbOfMatches;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void OPENTREP_Service::
+  calculateDistanceMatrix (const LocationList_T& iRowLocationList,
+                           const LocationList_T& iColLocationList,
+                           DistanceMatrix_T& ioDistanceMatrix) {
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+    assert (_opentrepServiceContext != NULL);
+    OPENTREP_ServiceContext& lOPENTREP_ServiceContext= *_opentrepServiceContext;
+
+    // Gather the coordinates of the locations into structure-of-arrays buffers
+    GeoCoordBuffer lRowBuffer;
+    lRowBuffer.reserve (iRowLocationList.size());
+    for (LocationList_T::const_iterator itLocation = iRowLocationList.begin();
+         itLocation != iRowLocationList.end(); ++itLocation) {
+      const Location& lLocation = *itLocation;
+      lRowBuffer.addPoint (lLocation.getLatitude(), lLocation.getLongitude());
+    }
+
+    GeoCoordBuffer lColBuffer;
+    lColBuffer.reserve (iColLocationList.size());
+    for (LocationList_T::const_iterator itLocation = iColLocationList.begin();
+         itLocation != iColLocationList.end(); ++itLocation) {
+      const Location& lLocation = *itLocation;
+      lColBuffer.addPoint (lLocation.getLatitude(), lLocation.getLongitude());
+    }
+
+    // Delegate the calculation to the dedicated (batch) kernel
+    BasChronometer lDistanceMatrixChronometer;
+    lDistanceMatrixChronometer.start();
+    calculateGreatCircleDistanceMatrix (lRowBuffer, lColBuffer,
+                                        ioDistanceMatrix);
+    const double lDistanceMatrixMeasure = lDistanceMatrixChronometer.elapsed();
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Distance matrix (" << lRowBuffer.size() << "x"
+                        << lColBuffer.size() << "): " << lDistanceMatrixMeasure
+                        << " - " << lOPENTREP_ServiceContext.display());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T OPENTREP_Service::
+  calculateDistanceMatrix (const WordList_T& iRowCodeList,
+                           const WordList_T& iColCodeList,
+                           DistanceMatrix_T& ioDistanceMatrix) {
+    NbOfMatches_T oNbOfMatches = 0;
+
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+    assert (_opentrepServiceContext != NULL);
+    OPENTREP_ServiceContext& lOPENTREP_ServiceContext= *_opentrepServiceContext;
+
+    // Resolve exactly each distinct code, only once
+    WordList_T lCodeList (iRowCodeList);
+    lCodeList.insert (lCodeList.end(), iColCodeList.begin(), iColCodeList.end());
+    RequestInterpreter::CodeLocationMap_T lLocationMap;
+
+    BasChronometer lResolutionChronometer; lResolutionChronometer.start();
+    const SearchIndexHandlePtr_T lIndexHandle_ptr =
+      lOPENTREP_ServiceContext.getActiveIndexHandle();
+    const DBType& lSQLDBType = lOPENTREP_ServiceContext.getSQLDBType();
+    if (lIndexHandle_ptr != NULL) {
+      // When hot-swapped, the SQL database session (or, without SQL
+      // database, the Xapian index) of the active deployment is used
+      SearchIndexHandle::Lease lLease (*lIndexHandle_ptr);
+      oNbOfMatches = RequestInterpreter::
+        resolveCodeList (&lLease.getXapianDatabase(),
+                         lLease.getSelectStatementCachePtr(),
+                         lIndexHandle_ptr->getSQLDBType(),
+                         lIndexHandle_ptr->getSQLDBConnectionString(),
+                         lCodeList, lLocationMap);
+
+    } else if (!(lSQLDBType == DBType::NODB)) {
+      // Borrow a SQL database session, or connect to the SQLite3/MySQL
+      // database
+      const CodeLookupSession lCodeLookupSession (lOPENTREP_ServiceContext);
+      oNbOfMatches = RequestInterpreter::
+        resolveCodeList (NULL, &lCodeLookupSession.getSelectStatementCache(),
+                         lSQLDBType,
+                         lOPENTREP_ServiceContext.getSQLDBConnectionString(),
+                         lCodeList, lLocationMap);
+
+    } else {
+      // Without SQL database, the codes are looked up in the Xapian index
+      const TravelDBFilePath_T& lTravelDBFilePath =
+        lOPENTREP_ServiceContext.getTravelDBFilePath();
+      if (checkXapianDBOnFileSystem (lTravelDBFilePath) == false) {
+        std::ostringstream errorStr;
+        errorStr << "The file-path to the Xapian database/index ('"
+                 << lTravelDBFilePath << "') does not exist or is not a "
+                 << "directory.";
+        OPENTREP_LOG_ERROR (errorStr.str());
+        throw XapianTravelDatabaseWrongPathnameException (errorStr.str());
+      }
+      const Xapian::Database lXapianDatabase (lTravelDBFilePath);
+      oNbOfMatches = RequestInterpreter::
+        resolveCodeList (&lXapianDatabase, NULL, lSQLDBType,
+                         lOPENTREP_ServiceContext.getSQLDBConnectionString(),
+                         lCodeList, lLocationMap);
+    }
+    const double lResolutionMeasure = lResolutionChronometer.elapsed();
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Resolution of " << oNbOfMatches << " code(s) for "
+                        << "the distance matrix: " << lResolutionMeasure
+                        << " - " << lOPENTREP_ServiceContext.display());
+
+    // Build the lists of locations. The codes which could not be resolved
+    // are replaced by a placeholder, and their distances are set to NaN
+    // afterwards.
+    typedef RequestInterpreter::CodeLocationMap_T LocationMap_T;
+    LocationList_T lRowLocationList;
+    for (WordList_T::const_iterator itCode = iRowCodeList.begin();
+         itCode != iRowCodeList.end(); ++itCode) {
+      const LocationMap_T::const_iterator itLocation = lLocationMap.find (*itCode);
+      if (itLocation != lLocationMap.end()) {
+        lRowLocationList.push_back (itLocation->second);
+      } else {
+        lRowLocationList.push_back (Location());
+      }
+    }
+
+    LocationList_T lColLocationList;
+    for (WordList_T::const_iterator itCode = iColCodeList.begin();
+         itCode != iColCodeList.end(); ++itCode) {
+      const LocationMap_T::const_iterator itLocation = lLocationMap.find (*itCode);
+      if (itLocation != lLocationMap.end()) {
+        lColLocationList.push_back (itLocation->second);
+      } else {
+        lColLocationList.push_back (Location());
+      }
+    }
+
+    calculateDistanceMatrix (lRowLocationList, lColLocationList,
+                             ioDistanceMatrix);
+
+    // Invalidate the distances involving the codes, which could not
+    // be resolved
+    const Distance_T lNaN = std::numeric_limits<Distance_T>::quiet_NaN();
+    size_t lRowIdx = 0;
+    for (WordList_T::const_iterator itRowCode = iRowCodeList.begin();
+         itRowCode != iRowCodeList.end(); ++itRowCode, ++lRowIdx) {
+      DistanceList_T& lDistanceRow = ioDistanceMatrix[lRowIdx];
+      const bool isRowResolved = (lLocationMap.find (*itRowCode)
+                                  != lLocationMap.end());
+      size_t lColIdx = 0;
+      for (WordList_T::const_iterator itColCode = iColCodeList.begin();
+           itColCode != iColCodeList.end(); ++itColCode, ++lColIdx) {
+        if (isRowResolved == false
+            || lLocationMap.find (*itColCode) == lLocationMap.end()) {
+          lDistanceRow[lColIdx] = lNaN;
+        }
+      }
+    }
+
+    return oNbOfMatches;
+  }
+
   // //////////////////////////////////////////////////////////////////////
   bool OPENTREP_Service::createSQLDBUser() {
     bool oCreationSuccessful = true;
@@ -308,6 +724,9 @@ namespace OPENTREP {
       DBManager::createSQLDBUser (lSQLDBType, lSQLDBConnectionString,
                                   lDeploymentNumber);
 
+    // The SQL sessions opened so far refer to the former SQL database
+    lOPENTREP_ServiceContext.resetSQLSessionPool();
+
     const double lDBCreationMeasure = lDBCreationChronometer.elapsed();
       
     // DEBUG
@@ -378,6 +797,9 @@ namespace OPENTREP {
     DBManager::terminateSQLDBSession (lSQLDBType, lSQLDBConnectionString,
                                       lSociSession);
 
+    // The SQL sessions opened so far refer to the former tables
+    lOPENTREP_ServiceContext.resetSQLSessionPool();
+
     const double lDBCreationMeasure = lDBCreationChronometer.elapsed();
       
     // DEBUG
@@ -467,6 +889,119 @@ namespace OPENTREP {
     return oDeploymentNumber;
   }
 
+  // //////////////////////////////////////////////////////////////////////
+  DeploymentNumber_T OPENTREP_Service::getActiveDeploymentNumber() const {
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+    assert (_opentrepServiceContext != NULL);
+    OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
+
+    // When hot-swapped, the deployment is the one of the active handle
+    const SearchIndexHandlePtr_T& lIndexHandle_ptr =
+      lOPENTREP_ServiceContext.getActiveIndexHandle();
+    if (lIndexHandle_ptr != NULL) {
+      return lIndexHandle_ptr->getDeploymentNumber();
+    }
+
+    return lOPENTREP_ServiceContext.getDeploymentNumber();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void OPENTREP_Service::
+  startIndexHotSwap (const PollingPeriod_T& iPollingPeriod) {
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+    assert (_opentrepServiceContext != NULL);
+    OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
+
+    // Open (and warm up) the current deployment
+    if (_indexHotSwapper == NULL) {
+      BasChronometer lOpeningChronometer; lOpeningChronometer.start();
+      _indexHotSwapper = new IndexHotSwapper (lOPENTREP_ServiceContext);
+      const double lOpeningMeasure = lOpeningChronometer.elapsed();
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("Opened the current deployment for hot-swap: "
+                          << lOpeningMeasure << " - "
+                          << lOPENTREP_ServiceContext.display());
+    }
+    assert (_indexHotSwapper != NULL);
+
+    // Watch the other deployment in the background, if required
+    if (iPollingPeriod > 0) {
+      _indexHotSwapper->start (iPollingPeriod);
+    } else {
+      _indexHotSwapper->stop();
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  bool OPENTREP_Service::checkIndexHotSwap() {
+    if (_indexHotSwapper == NULL) {
+      const PollingPeriod_T lNoPolling = 0;
+      startIndexHotSwap (lNoPolling);
+    }
+    assert (_indexHotSwapper != NULL);
+
+    BasChronometer lSwapChronometer; lSwapChronometer.start();
+    const bool hasSwapped = _indexHotSwapper->checkAndSwap();
+    const double lSwapMeasure = lSwapChronometer.elapsed();
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Checked the other deployment for hot-swap ("
+                        << (hasSwapped == true ? "swapped" : "not swapped")
+                        << "): " << lSwapMeasure);
+
+    return hasSwapped;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void OPENTREP_Service::stopIndexHotSwap() {
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+
+    delete _indexHotSwapper; _indexHotSwapper = NULL;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void OPENTREP_Service::setPORParserType (const PORParserType& iParserType) {
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+    assert (_opentrepServiceContext != NULL);
+    OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
+
+    // The indexing commands are given the parser type of the context, while
+    // the search results are decoded with the parser type of the process
+    lOPENTREP_ServiceContext.setPORParserType (iParserType);
+    PORStringParser::setParserType (iParserType);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void OPENTREP_Service::setSQLDBLoadMode (const SQLDBLoadMode& iLoadMode) {
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+    assert (_opentrepServiceContext != NULL);
+    OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
+
+    lOPENTREP_ServiceContext.setSQLDBLoadMode (iLoadMode);
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("The SQL database will be opened with the '"
+                        << iLoadMode.describe() << "' mode, by the pool of "
+                        << "sessions of the current deployment and by "
+                        << "the hot-swapped deployments");
+  }
+
   // //////////////////////////////////////////////////////////////////////
   OPENTREP::shouldIndexNonIATAPOR_T OPENTREP_Service::
   toggleShouldIncludeAllPORFlag() {
@@ -616,32 +1151,21 @@ namespace OPENTREP {
     assert (_opentrepServiceContext != NULL);
     OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
 
-    // Retrieve the SQL database type
-    const DBType& lSQLDBType = lOPENTREP_ServiceContext.getSQLDBType();
-      
-    // Retrieve the SQL database connection string
-    const SQLDBConnectionString_T& lSQLDBConnectionString =
-      lOPENTREP_ServiceContext.getSQLDBConnectionString();
-      
     // Delegate the database look up to the dedicated command
     BasChronometer lDBListChronometer;
     lDBListChronometer.start();
 
-    // Connect to the SQLite3/MySQL database
-    soci::session* lSociSession_ptr =
-      DBManager::initSQLDBSession (lSQLDBType, lSQLDBConnectionString);
-    assert (lSociSession_ptr != NULL);
-    soci::session& lSociSession = *lSociSession_ptr;
+    // Borrow a SQL database session of the active deployment, if any,
+    // or connect to the SQLite3/MySQL database
+    const CodeLookupSession lCodeLookupSession (lOPENTREP_ServiceContext);
+    SelectStatementCache& lStatementCache =
+      lCodeLookupSession.getSelectStatementCache();
       
     // Get the list of POR corresponding to the given IATA code
     const bool lUniqueEntry = false;
-    nbOfMatches = DBManager::getPORByIATACode (lSociSession, iIataCode,
+    nbOfMatches = DBManager::getPORByIATACode (lStatementCache, iIataCode,
                                                ioLocationList, lUniqueEntry);
 
-    // Release the SQL database connection
-    DBManager::terminateSQLDBSession (lSQLDBType, lSQLDBConnectionString,
-                                      lSociSession);
-
     const double lDBListMeasure = lDBListChronometer.elapsed();
       
     // DEBUG
@@ -665,30 +1189,19 @@ namespace OPENTREP {
     assert (_opentrepServiceContext != NULL);
     OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
 
-    // Retrieve the SQL database type
-    const DBType& lSQLDBType = lOPENTREP_ServiceContext.getSQLDBType();
-      
-    // Retrieve the SQL database connection string
-    const SQLDBConnectionString_T& lSQLDBConnectionString =
-      lOPENTREP_ServiceContext.getSQLDBConnectionString();
-      
     // Delegate the database look up to the dedicated command
     BasChronometer lDBListChronometer;
     lDBListChronometer.start();
 
-    // Connect to the SQLite3/MySQL database
-    soci::session* lSociSession_ptr =
-      DBManager::initSQLDBSession (lSQLDBType, lSQLDBConnectionString);
-    assert (lSociSession_ptr != NULL);
-    soci::session& lSociSession = *lSociSession_ptr;
+    // Borrow a SQL database session of the active deployment, if any,
+    // or connect to the SQLite3/MySQL database
+    const CodeLookupSession lCodeLookupSession (lOPENTREP_ServiceContext);
+    SelectStatementCache& lStatementCache =
+      lCodeLookupSession.getSelectStatementCache();
       
     // Get the list of POR corresponding to the given ICAO code
     nbOfMatches =
-      DBManager::getPORByICAOCode (lSociSession, iIcaoCode, ioLocationList);
-
-    // Release the SQL database connection
-    DBManager::terminateSQLDBSession (lSQLDBType, lSQLDBConnectionString,
-                                      lSociSession);
+      DBManager::getPORByICAOCode (lStatementCache, iIcaoCode, ioLocationList);
 
     const double lDBListMeasure = lDBListChronometer.elapsed();
       
@@ -713,30 +1226,19 @@ namespace OPENTREP {
     assert (_opentrepServiceContext != NULL);
     OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
 
-    // Retrieve the SQL database type
-    const DBType& lSQLDBType = lOPENTREP_ServiceContext.getSQLDBType();
-      
-    // Retrieve the SQL database connection string
-    const SQLDBConnectionString_T& lSQLDBConnectionString =
-      lOPENTREP_ServiceContext.getSQLDBConnectionString();
-      
     // Delegate the database look up to the dedicated command
     BasChronometer lDBListChronometer;
     lDBListChronometer.start();
 
-    // Connect to the SQLite3/MySQL database
-    soci::session* lSociSession_ptr =
-      DBManager::initSQLDBSession (lSQLDBType, lSQLDBConnectionString);
-    assert (lSociSession_ptr != NULL);
-    soci::session& lSociSession = *lSociSession_ptr;
+    // Borrow a SQL database session of the active deployment, if any,
+    // or connect to the SQLite3/MySQL database
+    const CodeLookupSession lCodeLookupSession (lOPENTREP_ServiceContext);
+    SelectStatementCache& lStatementCache =
+      lCodeLookupSession.getSelectStatementCache();
       
     // Get the list of POR corresponding to the given FAA code
     nbOfMatches =
-      DBManager::getPORByFAACode (lSociSession, iFaaCode, ioLocationList);
-
-    // Release the SQL database connection
-    DBManager::terminateSQLDBSession (lSQLDBType, lSQLDBConnectionString,
-                                      lSociSession);
+      DBManager::getPORByFAACode (lStatementCache, iFaaCode, ioLocationList);
 
     const double lDBListMeasure = lDBListChronometer.elapsed();
       
@@ -761,33 +1263,22 @@ namespace OPENTREP {
     assert (_opentrepServiceContext != NULL);
     OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
 
-    // Retrieve the SQL database type
-    const DBType& lSQLDBType = lOPENTREP_ServiceContext.getSQLDBType();
-      
-    // Retrieve the SQL database connection string
-    const SQLDBConnectionString_T& lSQLDBConnectionString =
-      lOPENTREP_ServiceContext.getSQLDBConnectionString();
-      
     // Delegate the database look up to the dedicated command
     BasChronometer lDBListChronometer;
     lDBListChronometer.start();
 
-    // Connect to the SQLite3/MySQL database
-    soci::session* lSociSession_ptr =
-      DBManager::initSQLDBSession (lSQLDBType, lSQLDBConnectionString);
-    assert (lSociSession_ptr != NULL);
-    soci::session& lSociSession = *lSociSession_ptr;
+    // Borrow a SQL database session of the active deployment, if any,
+    // or connect to the SQLite3/MySQL database
+    const CodeLookupSession lCodeLookupSession (lOPENTREP_ServiceContext);
+    SelectStatementCache& lStatementCache =
+      lCodeLookupSession.getSelectStatementCache();
       
     // Get the list of POR corresponding to the given UN/LOCODE code
     const bool lUniqueEntry = false;
     nbOfMatches =
-      DBManager::getPORByUNLOCode (lSociSession, iUNLOCode, ioLocationList,
+      DBManager::getPORByUNLOCode (lStatementCache, iUNLOCode, ioLocationList,
                                    lUniqueEntry);
 
-    // Release the SQL database connection
-    DBManager::terminateSQLDBSession (lSQLDBType, lSQLDBConnectionString,
-                                      lSociSession);
-
     const double lDBListMeasure = lDBListChronometer.elapsed();
       
     // DEBUG
@@ -810,30 +1301,19 @@ namespace OPENTREP {
     assert (_opentrepServiceContext != NULL);
     OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
 
-    // Retrieve the SQL database type
-    const DBType& lSQLDBType = lOPENTREP_ServiceContext.getSQLDBType();
-      
-    // Retrieve the SQL database connection string
-    const SQLDBConnectionString_T& lSQLDBConnectionString =
-      lOPENTREP_ServiceContext.getSQLDBConnectionString();
-      
     // Delegate the database look up to the dedicated command
     BasChronometer lDBListChronometer;
     lDBListChronometer.start();
 
-    // Connect to the SQLite3/MySQL database
-    soci::session* lSociSession_ptr =
-      DBManager::initSQLDBSession (lSQLDBType, lSQLDBConnectionString);
-    assert (lSociSession_ptr != NULL);
-    soci::session& lSociSession = *lSociSession_ptr;
+    // Borrow a SQL database session of the active deployment, if any,
+    // or connect to the SQLite3/MySQL database
+    const CodeLookupSession lCodeLookupSession (lOPENTREP_ServiceContext);
+    SelectStatementCache& lStatementCache =
+      lCodeLookupSession.getSelectStatementCache();
       
     // Get the list of POR corresponding to the given UIC code
     nbOfMatches =
-      DBManager::getPORByUICCode (lSociSession, iUICCode, ioLocationList);
-
-    // Release the SQL database connection
-    DBManager::terminateSQLDBSession (lSQLDBType, lSQLDBConnectionString,
-                                      lSociSession);
+      DBManager::getPORByUICCode (lStatementCache, iUICCode, ioLocationList);
 
     const double lDBListMeasure = lDBListChronometer.elapsed();
       
@@ -858,30 +1338,20 @@ namespace OPENTREP {
     assert (_opentrepServiceContext != NULL);
     OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
 
-    // Retrieve the SQL database type
-    const DBType& lSQLDBType = lOPENTREP_ServiceContext.getSQLDBType();
-      
-    // Retrieve the SQL database connection string
-    const SQLDBConnectionString_T& lSQLDBConnectionString =
-      lOPENTREP_ServiceContext.getSQLDBConnectionString();
-      
     // Delegate the database look up to the dedicated command
     BasChronometer lDBListChronometer;
     lDBListChronometer.start();
 
-    // Connect to the SQLite3/MySQL database
-    soci::session* lSociSession_ptr =
-      DBManager::initSQLDBSession (lSQLDBType, lSQLDBConnectionString);
-    assert (lSociSession_ptr != NULL);
-    soci::session& lSociSession = *lSociSession_ptr;
+    // Borrow a SQL database session of the active deployment, if any,
+    // or connect to the SQLite3/MySQL database
+    const CodeLookupSession lCodeLookupSession (lOPENTREP_ServiceContext);
+    SelectStatementCache& lStatementCache =
+      lCodeLookupSession.getSelectStatementCache();
       
     // Get the list of POR corresponding to the given Geoname ID
     nbOfMatches =
-      DBManager::getPORByGeonameID (lSociSession, iGeonameID, ioLocationList);
-
-    // Release the SQL database connection
-    DBManager::terminateSQLDBSession (lSQLDBType, lSQLDBConnectionString,
-                                      lSociSession);
+      DBManager::getPORByGeonameID (lStatementCache, iGeonameID,
+                                    ioLocationList);
 
     const double lDBListMeasure = lDBListChronometer.elapsed();
       
@@ -895,6 +1365,22 @@ namespace OPENTREP {
 
   // //////////////////////////////////////////////////////////////////////
   NbOfDBEntries_T OPENTREP_Service::insertIntoDBAndXapian() {
+    return insertIntoDBAndXapian (K_DEFAULT_NB_OF_INDEXING_THREADS);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T OPENTREP_Service::
+  insertIntoDBAndXapian (const NbOfThreads_T& iNbOfThreads) {
+    const shouldMergeIndexShards_T shouldMergeShards = true;
+    return insertIntoDBAndXapian (iNbOfThreads, K_DEFAULT_NB_OF_INDEX_SHARDS,
+                                  shouldMergeShards);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T OPENTREP_Service::
+  insertIntoDBAndXapian (const NbOfThreads_T& iNbOfThreads,
+                         const NbOfShards_T& iNbOfShards,
+                         const shouldMergeIndexShards_T& iShouldMergeShards) {
     NbOfDBEntries_T oNbOfEntries = 0;
     
     if (_opentrepServiceContext == NULL) {
@@ -933,6 +1419,10 @@ namespace OPENTREP {
     // Retrieve the Unicode transliterator
     const OTransliterator& lTransliterator =
       lOPENTREP_ServiceContext.getTransliterator();
+
+    // Retrieve the type of the parser of the POR records
+    const PORParserType& lPORParserType =
+      lOPENTREP_ServiceContext.getPORParserType();
       
     // Delegate the index building to the dedicated command
     BasChronometer lInsertIntoXapianAndSQLDBChronometer;
@@ -944,9 +1434,16 @@ namespace OPENTREP {
                                                    lIncludeNonIATAPOR,
                                                    lShouldIndexPORInXapian,
                                                    lShouldAddPORInSQLDB,
-                                                   lTransliterator);
+                                                   lTransliterator,
+                                                   lPORParserType,
+                                                   iNbOfThreads,
+                                                   iNbOfShards,
+                                                   iShouldMergeShards);
     const double lInsertIntoXapianAndSQLDBMeasure =
       lInsertIntoXapianAndSQLDBChronometer.elapsed();
+
+    // The SQL sessions opened so far do not see the new SQL database
+    lOPENTREP_ServiceContext.resetSQLSessionPool();
       
     // DEBUG
     OPENTREP_LOG_DEBUG ("Built Xapian database/index and filled SQL database: "
@@ -956,11 +1453,138 @@ namespace OPENTREP {
     return oNbOfEntries;
   }
   
+  // //////////////////////////////////////////////////////////////////////
+  IndexUpdateReport OPENTREP_Service::updateDBAndXapian() {
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+    assert (_opentrepServiceContext != NULL);
+    OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
+
+    // Retrieve the file-path of the POR (points of reference) file
+    const PORFilePath_T& lPORFilePath= lOPENTREP_ServiceContext.getPORFilePath();
+      
+    // Retrieve the Xapian database name (directorty of the index)
+    const TravelDBFilePath_T& lTravelDBFilePath =
+      lOPENTREP_ServiceContext.getTravelDBFilePath();
+      
+    // Retrieve the SQL database type
+    const DBType& lSQLDBType = lOPENTREP_ServiceContext.getSQLDBType();
+      
+    // Retrieve the SQL database connection string
+    const SQLDBConnectionString_T& lSQLDBConnectionString =
+      lOPENTREP_ServiceContext.getSQLDBConnectionString();
+
+    // Retrieve whether or not all the POR should be indexed
+    const OPENTREP::shouldIndexNonIATAPOR_T& lIncludeNonIATAPOR =
+      lOPENTREP_ServiceContext.getShouldIncludeAllPORFlag();
+
+    // Retrieve whether or not the POR should be indexed in Xapian
+    const OPENTREP::shouldIndexPORInXapian_T& lShouldIndexPORInXapian =
+      lOPENTREP_ServiceContext.getShouldIndexPORInXapianFlag();
+
+    // Retrieve whether or not the POR should be added in the SQL database
+    const OPENTREP::shouldAddPORInSQLDB_T& lShouldAddPORInSQLDB =
+      lOPENTREP_ServiceContext.getShouldAddPORInSQLDB();
+
+    // Retrieve the Unicode transliterator
+    const OTransliterator& lTransliterator =
+      lOPENTREP_ServiceContext.getTransliterator();
+
+    // Retrieve the type of the parser of the POR records
+    const PORParserType& lPORParserType =
+      lOPENTREP_ServiceContext.getPORParserType();
+      
+    // Delegate the index update to the dedicated command
+    BasChronometer lUpdateChronometer;
+    lUpdateChronometer.start();
+    const IndexUpdateReport& oReport =
+      IndexUpdater::updateSearchIndex (lPORFilePath, lTravelDBFilePath,
+                                       lSQLDBType, lSQLDBConnectionString,
+                                       lIncludeNonIATAPOR,
+                                       lShouldIndexPORInXapian,
+                                       lShouldAddPORInSQLDB, lTransliterator,
+                                       lPORParserType);
+    const double lUpdateMeasure = lUpdateChronometer.elapsed();
+
+    // The SQL sessions opened so far (e.g., on an in-memory copy) may
+    // not see the updated SQL database
+    lOPENTREP_ServiceContext.resetSQLSessionPool();
+      
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Updated Xapian database/index and SQL database ("
+                        << oReport.describe() << "): " << lUpdateMeasure
+                        << " - " << lOPENTREP_ServiceContext.display());
+
+    return oReport;
+  }
+  
+  // //////////////////////////////////////////////////////////////////////
+  NbOfDBEntries_T OPENTREP_Service::
+  exportToColumnarFile (const FilePath_T& iColumnarFilePath,
+                        const NbOfThreads_T& iNbOfThreads) {
+    if (_opentrepServiceContext == NULL) {
+      throw NonInitialisedServiceException ("The OpenTREP service has not been"
+                                            " initialised");
+    }
+    assert (_opentrepServiceContext != NULL);
+    OPENTREP_ServiceContext& lOPENTREP_ServiceContext = *_opentrepServiceContext;
+
+    // Retrieve the file-path of the POR (points of reference) file
+    const PORFilePath_T& lPORFilePath= lOPENTREP_ServiceContext.getPORFilePath();
+      
+    // Retrieve the SQL database type
+    const DBType& lSQLDBType = lOPENTREP_ServiceContext.getSQLDBType();
+      
+    // Retrieve the SQL database connection string
+    const SQLDBConnectionString_T& lSQLDBConnectionString =
+      lOPENTREP_ServiceContext.getSQLDBConnectionString();
+
+    // Retrieve whether or not all the POR should be exported
+    const OPENTREP::shouldIndexNonIATAPOR_T& lIncludeNonIATAPOR =
+      lOPENTREP_ServiceContext.getShouldIncludeAllPORFlag();
+
+    // Retrieve the type of the parser of the POR records
+    const PORParserType& lPORParserType =
+      lOPENTREP_ServiceContext.getPORParserType();
+
+    // Delegate the export to the dedicated command
+    BasChronometer lExportChronometer;
+    lExportChronometer.start();
+    const NbOfDBEntries_T oNbOfEntries =
+      ColumnarExporter::exportPOR (iColumnarFilePath, lPORFilePath,
+                                   lSQLDBType, lSQLDBConnectionString,
+                                   lIncludeNonIATAPOR, lPORParserType,
+                                   iNbOfThreads);
+    const double lExportMeasure = lExportChronometer.elapsed();
+      
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Exported " << oNbOfEntries << " POR into the '"
+                        << iColumnarFilePath << "' columnar file: "
+                        << lExportMeasure << " - "
+                        << lOPENTREP_ServiceContext.display());
+
+    return oNbOfEntries;
+  }
+  
   // //////////////////////////////////////////////////////////////////////
   NbOfMatches_T OPENTREP_Service::
   interpretTravelRequest (const std::string& iTravelQuery,
                           LocationList_T& ioLocationList,
                           WordList_T& ioWordList) {
+    // No origin is given by the caller
+    const OriginHint lOriginHint;
+    return interpretTravelRequest (iTravelQuery, ioLocationList, ioWordList,
+                                   lOriginHint);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  NbOfMatches_T OPENTREP_Service::
+  interpretTravelRequest (const std::string& iTravelQuery,
+                          LocationList_T& ioLocationList,
+                          WordList_T& ioWordList,
+                          const OriginHint& iOriginHint) {
     NbOfMatches_T nbOfMatches = 0;
 
     if (_opentrepServiceContext == NULL) {
@@ -984,7 +1608,8 @@ namespace OPENTREP {
                         << "==================================================="
                         << std::endl
                         << lNowDateTime << " - Match query '" << iTravelQuery
-                        << "' on Xapian database (index)");
+                        << "' on Xapian database (index), with "
+                        << iOriginHint);
     
     // Check that the travel query is not empty
     if (iTravelQuery.empty() == true) {
@@ -993,6 +1618,35 @@ namespace OPENTREP {
       OPENTREP_LOG_ERROR (errorStr.str());
       throw TravelRequestEmptyException (errorStr.str());
     }
+
+    // When hot-swapped, the Xapian index and SQL database are kept open.
+    // The shared pointer keeps the handle alive until the end of the query,
+    // even if another deployment is swapped in the meantime.
+    const SearchIndexHandlePtr_T lIndexHandle_ptr =
+      lOPENTREP_ServiceContext.getActiveIndexHandle();
+    if (lIndexHandle_ptr != NULL) {
+      BasChronometer lRequestInterpreterChronometer;
+      lRequestInterpreterChronometer.start();
+      {
+        SearchIndexHandle::Lease lLease (*lIndexHandle_ptr);
+        nbOfMatches = RequestInterpreter::
+          interpretTravelRequest (lLease.getXapianDatabase(),
+                                  lLease.getSelectStatementCachePtr(),
+                                  lIndexHandle_ptr->getSQLDBType(),
+                                  lIndexHandle_ptr->getSQLDBConnectionString(),
+                                  iTravelQuery, ioLocationList, ioWordList,
+                                  lTransliterator, iOriginHint);
+      }
+      const double lRequestInterpreterMeasure =
+        lRequestInterpreterChronometer.elapsed();
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("Match query on Xapian database (index) of the "
+                          << lIndexHandle_ptr->describe() << ": "
+                          << lRequestInterpreterMeasure);
+
+      return nbOfMatches;
+    }
     
     // Retrieve the Xapian database name (directorty of the index)
     const TravelDBFilePath_T& lTravelDBFilePath =
@@ -1021,16 +1675,35 @@ namespace OPENTREP {
     // Retrieve the SQL database connection string
     const SQLDBConnectionString_T& lSQLDBConnString =
       lOPENTREP_ServiceContext.getSQLDBConnectionString();
+
+    // Borrow a SQL database session, if any, from the pool of the current
+    // deployment, so that the look-up statements prepared by the former
+    // queries are reused
+    const SQLSessionPoolPtr_T lSQLSessionPool_ptr =
+      lOPENTREP_ServiceContext.getSQLSessionPool();
       
     // Delegate the query execution to the dedicated command
     BasChronometer lRequestInterpreterChronometer;
     lRequestInterpreterChronometer.start();
-    nbOfMatches =
-      RequestInterpreter::interpretTravelRequest (lTravelDBFilePath,
-                                                  lSQLDBType, lSQLDBConnString,
-                                                  iTravelQuery,
-                                                  ioLocationList, ioWordList,
-                                                  lTransliterator);
+    {
+      Xapian::Database lXapianDatabase (lTravelDBFilePath);
+      if (lSQLSessionPool_ptr != NULL) {
+        SQLSessionPool::Lease lLease (*lSQLSessionPool_ptr);
+        nbOfMatches = RequestInterpreter::
+          interpretTravelRequest (lXapianDatabase,
+                                  &lLease.getSelectStatementCache(),
+                                  lSQLDBType, lSQLDBConnString, iTravelQuery,
+                                  ioLocationList, ioWordList,
+                                  lTransliterator, iOriginHint);
+
+      } else {
+        nbOfMatches = RequestInterpreter::
+          interpretTravelRequest (lXapianDatabase, NULL,
+                                  lSQLDBType, lSQLDBConnString, iTravelQuery,
+                                  ioLocationList, ioWordList,
+                                  lTransliterator, iOriginHint);
+      }
+    }
     const double lRequestInterpreterMeasure =
       lRequestInterpreterChronometer.elapsed();
 
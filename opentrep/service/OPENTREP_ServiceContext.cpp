@@ -7,11 +7,14 @@
 #include <istream>
 #include <ostream>
 #include <sstream>
+// Boost
+#include <boost/make_shared.hpp>
 // OpenTrep
 #include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
 #include <opentrep/basic/Utilities.hpp>
 #include <opentrep/bom/World.hpp>
 #include <opentrep/service/OPENTREP_ServiceContext.hpp>
+#include <opentrep/service/Logger.hpp>
 
 namespace OPENTREP {
 
@@ -37,6 +40,59 @@ namespace OPENTREP {
   // //////////////////////////////////////////////////////////////////////
   void OPENTREP_ServiceContext::
   updateXapianAndSQLDBConnectionWithDeploymentNumber() {
+    // SQL database specification
+    if (!(_sqlDBType == DBType::NODB)) {
+      _sqlDBConnectionString = getSQLDBConnectionString (_deploymentNumber);
+    }
+
+    // Xapian index/database specification
+    _travelDBFilePath = getTravelDBFilePath (_deploymentNumber);
+
+    // The SQL sessions opened so far are on the former SQL database
+    resetSQLSessionPool();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLSessionPoolPtr_T OPENTREP_ServiceContext::getSQLSessionPool() {
+    SQLSessionPoolPtr_T oSQLSessionPool_ptr =
+      boost::atomic_load (&_sqlSessionPool);
+    if (oSQLSessionPool_ptr != NULL || _sqlDBType == DBType::NODB) {
+      return oSQLSessionPool_ptr;
+    }
+
+    // The creations are serialised, so that concurrent callers create
+    // the pool (and, with the IN_MEMORY mode, copy the SQLite database
+    // in memory) only once
+    boost::mutex::scoped_lock lLock (_sqlSessionPoolMutex);
+    oSQLSessionPool_ptr = boost::atomic_load (&_sqlSessionPool);
+    if (oSQLSessionPool_ptr == NULL) {
+      oSQLSessionPool_ptr =
+        boost::make_shared<SQLSessionPool> (_sqlDBType, _sqlDBConnectionString,
+                                            _sqlDBLoadMode);
+      boost::atomic_store (&_sqlSessionPool, oSQLSessionPool_ptr);
+
+      // DEBUG
+      OPENTREP_LOG_DEBUG ("Created the pool of sessions on the "
+                          << oSQLSessionPool_ptr->describe());
+    }
+
+    return oSQLSessionPool_ptr;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  TravelDBFilePath_T OPENTREP_ServiceContext::
+  getTravelDBFilePath (const DeploymentNumber_T& iDeploymentNumber) const {
+    std::ostringstream oStr;
+    oStr << _travelDBFilePathPrefix;
+    oStr << iDeploymentNumber;
+    return TravelDBFilePath_T (oStr.str());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLDBConnectionString_T OPENTREP_ServiceContext::
+  getSQLDBConnectionString (const DeploymentNumber_T& iDeploymentNumber) const {
+    SQLDBConnectionString_T oSQLDBConnStr (_sqlDBConnectionString);
+
     /**
      * SQL database specification
      */
@@ -46,8 +102,8 @@ namespace OPENTREP {
     } else if (_sqlDBType == DBType::SQLITE3) {
       std::ostringstream oStr;
       oStr << _sqlDBConnectionStringWPfxDBName;
-      oStr << _deploymentNumber;
-      _sqlDBConnectionString = SQLDBConnectionString_T (oStr.str());
+      oStr << iDeploymentNumber;
+      oSQLDBConnStr = SQLDBConnectionString_T (oStr.str());
       
     } else if (_sqlDBType == DBType::MYSQL) {
       /**
@@ -65,20 +121,10 @@ namespace OPENTREP {
        * Recompose the connection string
        * 'db=trep_trep0 user=trep password=trep'
        */
-      const SQLDBConnectionString_T& lSQLDBConnStr =
-        buildMySQLConnectionString (lStrMap, _deploymentNumber);
-
-      // Store the newly formed SQL connection string
-      _sqlDBConnectionString = lSQLDBConnStr;
+      oSQLDBConnStr = buildMySQLConnectionString (lStrMap, iDeploymentNumber);
     }
 
-    /**
-     * Xapian index/database specification
-     */
-    std::ostringstream oStr;
-    oStr << _travelDBFilePathPrefix;
-    oStr << _deploymentNumber;
-    _travelDBFilePath = TravelDBFilePath_T (oStr.str());
+    return oSQLDBConnStr;
   }
   
   // //////////////////////////////////////////////////////////////////////
@@ -91,6 +137,8 @@ namespace OPENTREP {
       _sqlDBType (DEFAULT_OPENTREP_SQL_DB_TYPE),
       _sqlDBConnectionStringWPfxDBName (DEFAULT_OPENTREP_SQLITE_DB_FILEPATH),
       _sqlDBConnectionString (DEFAULT_OPENTREP_SQLITE_DB_FILEPATH),
+      _sqlDBLoadMode (DEFAULT_OPENTREP_SQL_DB_LOAD_MODE),
+      _porParserType (DEFAULT_OPENTREP_POR_PARSER_TYPE),
       _shouldIndexNonIATAPOR (DEFAULT_OPENTREP_INCLUDE_NONIATA_POR),
       _shouldIndexPORInXapian (DEFAULT_OPENTREP_INDEX_IN_XAPIAN),
       _shouldAddPORInSQLDB (DEFAULT_OPENTREP_ADD_IN_DB) {
@@ -110,6 +158,8 @@ namespace OPENTREP {
       _travelDBFilePath (iTravelDBFilePath), _sqlDBType (iSQLDBType),
       _sqlDBConnectionStringWPfxDBName (iSQLDBConnStr),
       _sqlDBConnectionString (iSQLDBConnStr),
+      _sqlDBLoadMode (DEFAULT_OPENTREP_SQL_DB_LOAD_MODE),
+      _porParserType (DEFAULT_OPENTREP_POR_PARSER_TYPE),
       _shouldIndexNonIATAPOR (DEFAULT_OPENTREP_INCLUDE_NONIATA_POR),
       _shouldIndexPORInXapian (DEFAULT_OPENTREP_INDEX_IN_XAPIAN),
       _shouldAddPORInSQLDB (DEFAULT_OPENTREP_ADD_IN_DB) {
@@ -132,6 +182,8 @@ namespace OPENTREP {
       _travelDBFilePath (iTravelDBFilePath), _sqlDBType (iSQLDBType),
       _sqlDBConnectionStringWPfxDBName (iSQLDBConnStr),
       _sqlDBConnectionString (iSQLDBConnStr),
+      _sqlDBLoadMode (DEFAULT_OPENTREP_SQL_DB_LOAD_MODE),
+      _porParserType (DEFAULT_OPENTREP_POR_PARSER_TYPE),
       _shouldIndexNonIATAPOR (iShouldIndexNonIATAPOR),
       _shouldIndexPORInXapian (iShouldIdxPORInXapian),
       _shouldAddPORInSQLDB (iShouldAddPORInSQLDB) {
@@ -162,6 +214,8 @@ namespace OPENTREP {
          << _sqlDBConnectionStringWPfxDBName
          << "); Connection string with actual DB name: "
          << _sqlDBConnectionString
+         << "; SQL database load mode: " << _sqlDBLoadMode.describe()
+         << "; POR parser: " << _porParserType.describe()
          << "; should include non-IATA POR: " << _shouldIndexNonIATAPOR
          << "; should index POR in Xapian: " << _shouldIndexPORInXapian
          << "; should insert POR into the SQL DB: " << _shouldAddPORInSQLDB
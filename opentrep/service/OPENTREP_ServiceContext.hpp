@@ -6,11 +6,17 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <string>
+// Boost
+#include <boost/thread/mutex.hpp>
 // OpenTrep
 #include <opentrep/OPENTREP_Types.hpp>
 #include <opentrep/DBType.hpp>
+#include <opentrep/SQLDBLoadMode.hpp>
+#include <opentrep/PORParserType.hpp>
 #include <opentrep/basic/OTransliterator.hpp>
 #include <opentrep/service/ServiceAbstract.hpp>
+#include <opentrep/service/SearchIndexHandle.hpp>
+#include <opentrep/service/SQLSessionPool.hpp>
 
 // Forward declarations
 namespace soci {
@@ -69,12 +75,44 @@ namespace OPENTREP {
       return _sqlDBConnectionString;
     }
 
+    /**
+     * Get the way of opening the SQLite database of the deployments used
+     * by the searches.
+     */
+    const SQLDBLoadMode& getSQLDBLoadMode() const {
+      return _sqlDBLoadMode;
+    }
+
     /**
      * Get the number/version of the current deployment.
      */
     const DeploymentNumber_T& getDeploymentNumber() const {
       return _deploymentNumber;
     }
+
+    /**
+     * Get the Xapian database name for the given deployment number/version.
+     */
+    TravelDBFilePath_T getTravelDBFilePath (const DeploymentNumber_T&) const;
+
+    /**
+     * Get the SQL database connection string for the given deployment
+     * number/version.
+     */
+    SQLDBConnectionString_T
+    getSQLDBConnectionString (const DeploymentNumber_T&) const;
+
+    /**
+     * Get the handle on the Xapian index and SQL database currently used
+     * by the searches (NULL when the hot-swap has not been started).
+     *
+     * The handle may be replaced at any time by another thread (see
+     * IndexHotSwapper); the returned shared pointer keeps it alive as long
+     * as the caller needs it.
+     */
+    SearchIndexHandlePtr_T getActiveIndexHandle() const {
+      return boost::atomic_load (&_activeIndexHandle);
+    }
     
     /**
      * Get the flag stating whether or not all the POR should be indexed.
@@ -97,6 +135,13 @@ namespace OPENTREP {
       return _shouldAddPORInSQLDB;
     }
     
+    /**
+     * Get the type of the parser of the POR records.
+     */
+    const PORParserType& getPORParserType() const {
+      return _porParserType;
+    }
+
     /**
      * Get the Unicode transliterator.
      */
@@ -104,6 +149,42 @@ namespace OPENTREP {
       return _transliterator;
     }
 
+    /**
+     * Get the handle on the Xapian index of the current deployment, kept
+     * open, along with its spatial index, for the nearby searches when
+     * the index has not been hot-swapped (NULL when it has not been
+     * opened yet).
+     *
+     * The handle may be replaced at any time by another thread (e.g.,
+     * after a re-indexing); the returned shared pointer keeps it alive
+     * as long as the caller needs it.
+     */
+    SearchIndexHandlePtr_T getNearbyIndexHandle() const {
+      return boost::atomic_load (&_nearbyIndexHandle);
+    }
+
+    /**
+     * Get the mutex serialising the openings of the handle used by the
+     * nearby searches, so that its spatial index is built only once for
+     * a given version of the Xapian database/index.
+     */
+    boost::mutex& getNearbyIndexHandleMutex() {
+      return _nearbyIndexHandleMutex;
+    }
+
+    /**
+     * Get the pool of sessions on the SQL database of the current
+     * deployment, used when the index has not been hot-swapped. The pool
+     * is created by the first call, with the current SQL database type,
+     * connection string and load mode, and kept until one of them changes
+     * (see resetSQLSessionPool()). NULL is returned when there is no SQL
+     * database.
+     *
+     * The returned shared pointer keeps the pool alive as long as the
+     * caller needs it.
+     */
+    SQLSessionPoolPtr_T getSQLSessionPool();
+
   public:
     // ////////////////// Setters /////////////////////
     /**
@@ -133,6 +214,16 @@ namespace OPENTREP {
      */
     void setSQLDBType (const DBType& iDBType) {
       _sqlDBType = iDBType;
+      resetSQLSessionPool();
+    }
+
+    /**
+     * Set the way of opening the SQLite database of the deployments used
+     * by the searches.
+     */
+    void setSQLDBLoadMode (const SQLDBLoadMode& iSQLDBLoadMode) {
+      _sqlDBLoadMode = iSQLDBLoadMode;
+      resetSQLSessionPool();
     }
     
     /**
@@ -172,6 +263,13 @@ namespace OPENTREP {
       _shouldAddPORInSQLDB = iShouldAddPORInSQLDB;
     }
     
+    /**
+     * Set the type of the parser of the POR records.
+     */
+    void setPORParserType (const PORParserType& iPORParserType) {
+      _porParserType = iPORParserType;
+    }
+
     /**
      * Set the Unicode transliterator.
      */
@@ -179,6 +277,34 @@ namespace OPENTREP {
       _transliterator = iTransliterator;
     }
 
+    /**
+     * Set (atomically) the handle on the Xapian index and SQL database
+     * used by the searches. The former handle is destroyed, and its
+     * connections closed, once the last search using it is over.
+     */
+    void setActiveIndexHandle (SearchIndexHandlePtr_T ioIndexHandlePtr) {
+      boost::atomic_store (&_activeIndexHandle, ioIndexHandlePtr);
+    }
+
+    /**
+     * Set (atomically) the handle used by the nearby searches, already
+     * warmed up. The former handle is destroyed, and its Xapian databases
+     * closed, once the last search using it is over.
+     */
+    void setNearbyIndexHandle (SearchIndexHandlePtr_T ioIndexHandlePtr) {
+      boost::atomic_store (&_nearbyIndexHandle, ioIndexHandlePtr);
+    }
+
+    /**
+     * Drop (atomically) the pool of sessions on the SQL database, so that
+     * the next look-ups open new sessions, e.g., after the deployment has
+     * been toggled or the SQL database re-created. The sessions of the
+     * former pool are closed once the last look-up using it is over.
+     */
+    void resetSQLSessionPool() {
+      boost::atomic_store (&_sqlSessionPool, SQLSessionPoolPtr_T());
+    }
+
 
   public:
     // ///////// Display Methods //////////
@@ -351,6 +477,20 @@ namespace OPENTREP {
      */
     SQLDBConnectionString_T _sqlDBConnectionString;
 
+    /**
+     * Way of opening the SQLite database of the deployments used by
+     * the searches (see SQLDBLoadMode). It is taken into account when
+     * a deployment is opened by the hot-swap (see IndexHotSwapper), and
+     * otherwise by the pool of SQL sessions (see SQLSessionPool).
+     */
+    SQLDBLoadMode _sqlDBLoadMode;
+
+    /**
+     * Type of the parser of the POR records, given to the indexing
+     * commands, which may parse them from several threads.
+     */
+    PORParserType _porParserType;
+
     /**
      * Whether or not the non-IATA-referenced POR should be included
      * (and indexed).
@@ -393,6 +533,43 @@ namespace OPENTREP {
      * Unicode transliterator.
      */
     OTransliterator _transliterator;
+
+    /**
+     * Handle on the Xapian index of the current deployment, without SQL
+     * database, opened by the first nearby search (NULL before) when the
+     * searches are not hot-swapped. It keeps the Xapian databases open,
+     * along with the spatial index of the POR (points of reference) and
+     * the ready stamp of the Xapian index, which tells when the spatial
+     * index has to be built again. Otherwise, the active handle is used
+     * (see SearchIndexHandle). It is only accessed through
+     * boost::atomic_load() and boost::atomic_store().
+     */
+    SearchIndexHandlePtr_T _nearbyIndexHandle;
+
+    /**
+     * Mutex serialising the openings of the handle of the nearby searches.
+     */
+    boost::mutex _nearbyIndexHandleMutex;
+
+    /**
+     * Handle on the Xapian index and SQL database used by the searches,
+     * when hot-swapped by the services (NULL otherwise). It is only
+     * accessed through boost::atomic_load() and boost::atomic_store().
+     */
+    SearchIndexHandlePtr_T _activeIndexHandle;
+
+    /**
+     * Pool of sessions on the SQL database of the current deployment,
+     * used when the index has not been hot-swapped (NULL until the first
+     * look-up). It is only accessed through boost::atomic_load() and
+     * boost::atomic_store().
+     */
+    SQLSessionPoolPtr_T _sqlSessionPool;
+
+    /**
+     * Mutex serialising the creations of the pool of SQL sessions.
+     */
+    boost::mutex _sqlSessionPoolMutex;
   };
 
 }
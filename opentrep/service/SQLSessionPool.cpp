@@ -0,0 +1,140 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+#include <exception>
+// SOCI
+#include <soci/soci.h>
+// OpenTrep
+#include <opentrep/Location.hpp>
+#include <opentrep/CityDetails.hpp>
+#include <opentrep/command/SelectStatementCache.hpp>
+#include <opentrep/service/SQLSessionPool.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLSessionPool::Lease::Lease (SQLSessionPool& ioPool)
+    : _pool (ioPool), _connection (ioPool.acquire()) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLSessionPool::Lease::~Lease() {
+    if (std::uncaught_exception() == true) {
+      _pool.discard (_connection);
+    } else {
+      _pool.release (_connection);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLSessionPool::
+  SQLSessionPool (const DBType& iSQLDBType,
+                  const SQLDBConnectionString_T& iSQLDBConnStr,
+                  const SQLDBLoadMode& iSQLDBLoadMode)
+    : _dbSessionManager (iSQLDBType, iSQLDBConnStr, iSQLDBLoadMode) {
+    assert (!(iSQLDBType == DBType::NODB));
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLSessionPool::~SQLSessionPool() {
+    // The sessions are all idle, as the searches keep a shared pointer
+    // on the pool as long as they lease a session
+    for (std::vector<Connection>::iterator itConnection =
+           _idleConnectionList.begin();
+         itConnection != _idleConnectionList.end(); ++itConnection) {
+      Connection& lConnection = *itConnection;
+      try {
+        closeConnection (lConnection);
+      } catch (...) {
+        // Destructors must not throw; the error has already been logged
+      }
+    }
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Closed the " << _idleConnectionList.size()
+                        << " session(s) of the pool on the "
+                        << describe());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string SQLSessionPool::describe() const {
+    return _dbSessionManager.describe();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLSessionPool::Connection SQLSessionPool::openConnection() const {
+    Connection oConnection;
+    oConnection._sociSession_ptr = _dbSessionManager.openSession();
+    oConnection._selectStatementCache_ptr = NULL;
+
+    if (oConnection._sociSession_ptr == NULL) {
+      std::ostringstream errorStr;
+      errorStr << "The " << getSQLDBType().describe()
+               << " database is not accessible. Connection string: "
+               << getSQLDBConnectionString();
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw SQLDatabaseImpossibleConnectionException (errorStr.str());
+    }
+
+    try {
+      oConnection._selectStatementCache_ptr =
+        new SelectStatementCache (*oConnection._sociSession_ptr);
+
+    } catch (...) {
+      closeConnection (oConnection);
+      throw;
+    }
+
+    return oConnection;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void SQLSessionPool::closeConnection (Connection& ioConnection) const {
+    // The prepared statements must be released before the session
+    delete ioConnection._selectStatementCache_ptr;
+    ioConnection._selectStatementCache_ptr = NULL;
+
+    _dbSessionManager.closeSession (ioConnection._sociSession_ptr);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SQLSessionPool::Connection SQLSessionPool::acquire() {
+    {
+      boost::mutex::scoped_lock lLock (_mutex);
+      if (_idleConnectionList.empty() == false) {
+        const Connection oConnection = _idleConnectionList.back();
+        _idleConnectionList.pop_back();
+        return oConnection;
+      }
+    }
+
+    // All the sessions are in use: open a new one, out of the lock,
+    // as that may take some time
+    return openConnection();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void SQLSessionPool::release (const Connection& iConnection) {
+    boost::mutex::scoped_lock lLock (_mutex);
+    _idleConnectionList.push_back (iConnection);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void SQLSessionPool::discard (Connection& ioConnection) {
+    try {
+      closeConnection (ioConnection);
+    } catch (...) {
+      // The lease is given back while an exception is in flight: that
+      // latter must not be replaced
+    }
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Closed a failed session of the pool on the "
+                        << describe());
+  }
+
+}
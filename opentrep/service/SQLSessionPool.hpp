@@ -0,0 +1,208 @@
+#ifndef __OPENTREP_SVC_SQLSESSIONPOOL_HPP
+#define __OPENTREP_SVC_SQLSESSIONPOOL_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+#include <vector>
+// Boost
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/DBType.hpp>
+#include <opentrep/SQLDBLoadMode.hpp>
+#include <opentrep/command/DBSessionManager.hpp>
+
+// Forward declarations
+namespace soci {
+  class session;
+}
+
+namespace OPENTREP {
+
+  // Forward declarations
+  class SelectStatementCache;
+
+  /**
+   * @brief Pool of sessions on the SQL database of the current deployment,
+   *        used by the searches when the index has not been hot-swapped.
+   *
+   * It is the SQL counterpart of SearchIndexHandle: a soci::session object
+   * may not be used by several threads at once, so that every session is
+   * lent to a single search at once (see Lease), along with the statements
+   * prepared on it (see SelectStatementCache). The sessions, and their
+   * prepared statements, are therefore kept from a search to the next one.
+   *
+   * The sessions are opened by the DBSessionManager of the pool, according
+   * to the SQLDBLoadMode of the services. The pool is replaced by a new one
+   * whenever the deployment, the SQL database or its load mode changes (see
+   * OPENTREP_ServiceContext::resetSQLSessionPool()); the sessions of the
+   * former pool are closed once the last search using it is over.
+   */
+  class SQLSessionPool {
+  private:
+    /**
+     * Session on the SQL database, along with the statements prepared
+     * on it.
+     */
+    struct Connection {
+      soci::session* _sociSession_ptr;
+      SelectStatementCache* _selectStatementCache_ptr;
+    };
+
+  public:
+    /**
+     * @brief Lease of a session of the pool, given back to the pool
+     *        when the lease goes out of scope.
+     */
+    class Lease {
+    public:
+      /**
+       * Constructor: borrow a session from the given pool, or open a new
+       * one if all of them are in use.
+       */
+      Lease (SQLSessionPool&);
+
+      /**
+       * Destructor: give the session back to the pool. When the lease goes
+       * out of scope because of an exception, the session is closed
+       * instead, as it may be in a bad state.
+       */
+      ~Lease();
+
+      /**
+       * Get the SQL database session.
+       */
+      soci::session& getSociSession() const {
+        return *_connection._sociSession_ptr;
+      }
+
+      /**
+       * Get the statements prepared on the SQL database session.
+       */
+      SelectStatementCache& getSelectStatementCache() const {
+        return *_connection._selectStatementCache_ptr;
+      }
+
+    private:
+      /**
+       * Copy constructor (not implemented).
+       */
+      Lease (const Lease&);
+
+    private:
+      SQLSessionPool& _pool;
+      Connection _connection;
+    };
+
+  public:
+    // /////////////////// Getters //////////////////////
+    /**
+     * Get the SQL database type.
+     */
+    const DBType& getSQLDBType() const {
+      return _dbSessionManager.getSQLDBType();
+    }
+
+    /**
+     * Get the SQL database connection string.
+     */
+    const SQLDBConnectionString_T& getSQLDBConnectionString() const {
+      return _dbSessionManager.getSQLDBConnectionString();
+    }
+
+    /**
+     * Get the way of opening the SQLite database.
+     */
+    const SQLDBLoadMode& getSQLDBLoadMode() const {
+      return _dbSessionManager.getSQLDBLoadMode();
+    }
+
+    /**
+     * Get a string describing the pool.
+     */
+    std::string describe() const;
+
+  public:
+    // /////// Construction / destruction ////////
+    /**
+     * Main constructor. No session is opened at that stage, except,
+     * with the SQLDBLoadMode::IN_MEMORY mode, the one copying the SQLite
+     * database in memory.
+     *
+     * @param const DBType& SQL database type (may not be NODB).
+     * @param const SQLDBConnectionString_T& SQL DB connection string.
+     * @param const SQLDBLoadMode& Way of opening the SQLite database.
+     */
+    SQLSessionPool (const DBType&, const SQLDBConnectionString_T&,
+                    const SQLDBLoadMode&);
+
+    /**
+     * Destructor: close all the sessions.
+     */
+    ~SQLSessionPool();
+
+  private:
+    /**
+     * Default constructor (not implemented).
+     */
+    SQLSessionPool();
+
+    /**
+     * Copy constructor (not implemented).
+     */
+    SQLSessionPool (const SQLSessionPool&);
+
+    /**
+     * Open a new session, and prepare its statement cache.
+     */
+    Connection openConnection() const;
+
+    /**
+     * Close the given session, after having released its statements.
+     */
+    void closeConnection (Connection&) const;
+
+    /**
+     * Borrow a session from the pool, or open a new one.
+     */
+    Connection acquire();
+
+    /**
+     * Give the session back to the pool.
+     */
+    void release (const Connection&);
+
+    /**
+     * Close the session, rather than giving it back to the pool.
+     */
+    void discard (Connection&);
+
+
+  private:
+    // ////////////// Attributes ///////////////
+    /**
+     * Manager of the sessions on the SQL database. As the attributes are
+     * destroyed after the body of the destructor, the in-memory copy of
+     * the SQLite database, if any, is released after all the sessions
+     * have been closed.
+     */
+    DBSessionManager _dbSessionManager;
+
+    /**
+     * Idle sessions, and mutex protecting that pool.
+     */
+    std::vector<Connection> _idleConnectionList;
+    boost::mutex _mutex;
+  };
+
+  /**
+   * Shared pointer on a SQLSessionPool object.
+   */
+  typedef boost::shared_ptr<SQLSessionPool> SQLSessionPoolPtr_T;
+
+}
+#endif // __OPENTREP_SVC_SQLSESSIONPOOL_HPP
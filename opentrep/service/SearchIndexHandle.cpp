@@ -0,0 +1,271 @@
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <cassert>
+#include <sstream>
+#include <queue>
+#include <functional>
+#include <exception>
+// Boost
+#include <boost/make_shared.hpp>
+// SOCI
+#include <soci/soci.h>
+// Xapian
+#include <xapian.h>
+// OpenTrep
+#include <opentrep/Location.hpp>
+#include <opentrep/CityDetails.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
+#include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
+#include <opentrep/basic/BasChronometer.hpp>
+#include <opentrep/command/DBManager.hpp>
+#include <opentrep/command/SelectStatementCache.hpp>
+#include <opentrep/command/XapianIndexManager.hpp>
+#include <opentrep/service/SearchIndexHandle.hpp>
+#include <opentrep/service/Logger.hpp>
+
+namespace OPENTREP {
+
+  // //////////////////////////////////////////////////////////////////////
+  SearchIndexHandle::Lease::Lease (SearchIndexHandle& ioHandle)
+    : _handle (ioHandle), _connection (ioHandle.acquire()) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SearchIndexHandle::Lease::~Lease() {
+    if (std::uncaught_exception() == true) {
+      _handle.discard (_connection);
+    } else {
+      _handle.release (_connection);
+    }
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SearchIndexHandle::
+  SearchIndexHandle (const DeploymentNumber_T& iDeploymentNumber,
+                     const TravelDBFilePath_T& iTravelDBFilePath,
+                     const DBType& iSQLDBType,
+                     const SQLDBConnectionString_T& iSQLDBConnStr,
+                     const SQLDBLoadMode& iSQLDBLoadMode,
+                     const std::string& iReadyStamp)
+    : _deploymentNumber (iDeploymentNumber),
+      _travelDBFilePath (iTravelDBFilePath),
+      _dbSessionManager (iSQLDBType, iSQLDBConnStr, iSQLDBLoadMode),
+      _readyStamp (iReadyStamp) {
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SearchIndexHandle::~SearchIndexHandle() {
+    // The connections are all idle, as the searches keep a shared pointer
+    // on the handle as long as they lease a connection
+    for (std::vector<Connection>::iterator itConnection =
+           _idleConnectionList.begin();
+         itConnection != _idleConnectionList.end(); ++itConnection) {
+      Connection& lConnection = *itConnection;
+      try {
+        closeConnection (lConnection);
+      } catch (...) {
+        // Destructors must not throw; the error has already been logged
+      }
+    }
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Closed the " << _idleConnectionList.size()
+                        << " connection(s) of " << describe());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  std::string SearchIndexHandle::describe() const {
+    std::ostringstream oStr;
+    oStr << "deployment #" << _deploymentNumber << " (Xapian index: '"
+         << _travelDBFilePath << "'";
+    if (!(getSQLDBType() == DBType::NODB)) {
+      oStr << ", " << _dbSessionManager.describe();
+    }
+    if (_readyStamp.empty() == false) {
+      oStr << ", ready since " << _readyStamp;
+    }
+    oStr << ")";
+    return oStr.str();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SearchIndexHandle::Connection SearchIndexHandle::openConnection() const {
+    Connection oConnection;
+    oConnection._xapianDatabase_ptr = NULL;
+    oConnection._sociSession_ptr = NULL;
+    oConnection._selectStatementCache_ptr = NULL;
+
+    try {
+      oConnection._xapianDatabase_ptr =
+        new Xapian::Database (_travelDBFilePath);
+
+    } catch (const Xapian::Error& error) {
+      std::ostringstream errorStr;
+      errorStr << "Error when trying to open the Xapian index ('"
+               << _travelDBFilePath << "'): " << error.get_msg();
+      OPENTREP_LOG_ERROR (errorStr.str());
+      throw XapianDatabaseFailureException (errorStr.str());
+    }
+    assert (oConnection._xapianDatabase_ptr != NULL);
+
+    const DBType& lSQLDBType = getSQLDBType();
+    if (!(lSQLDBType == DBType::NODB)) {
+      try {
+        oConnection._sociSession_ptr = _dbSessionManager.openSession();
+
+      } catch (...) {
+        delete oConnection._xapianDatabase_ptr;
+        throw;
+      }
+      if (oConnection._sociSession_ptr == NULL) {
+        delete oConnection._xapianDatabase_ptr;
+        std::ostringstream errorStr;
+        errorStr << "The " << lSQLDBType.describe()
+                 << " database is not accessible. Connection string: "
+                 << getSQLDBConnectionString();
+        OPENTREP_LOG_ERROR (errorStr.str());
+        throw SQLDatabaseImpossibleConnectionException (errorStr.str());
+      }
+
+      try {
+        oConnection._selectStatementCache_ptr =
+          new SelectStatementCache (*oConnection._sociSession_ptr);
+
+      } catch (...) {
+        closeConnection (oConnection);
+        throw;
+      }
+    }
+
+    return oConnection;
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void SearchIndexHandle::closeConnection (Connection& ioConnection) const {
+    if (ioConnection._xapianDatabase_ptr != NULL) {
+      ioConnection._xapianDatabase_ptr->close();
+      delete ioConnection._xapianDatabase_ptr;
+      ioConnection._xapianDatabase_ptr = NULL;
+    }
+
+    // The prepared statements must be released before the session
+    delete ioConnection._selectStatementCache_ptr;
+    ioConnection._selectStatementCache_ptr = NULL;
+
+    _dbSessionManager.closeSession (ioConnection._sociSession_ptr);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  SearchIndexHandle::Connection SearchIndexHandle::acquire() {
+    {
+      boost::mutex::scoped_lock lLock (_mutex);
+      if (_idleConnectionList.empty() == false) {
+        const Connection oConnection = _idleConnectionList.back();
+        _idleConnectionList.pop_back();
+        return oConnection;
+      }
+    }
+
+    // All the connections are in use: open a new one, out of the lock,
+    // as that may take some time
+    return openConnection();
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void SearchIndexHandle::release (const Connection& iConnection) {
+    boost::mutex::scoped_lock lLock (_mutex);
+    _idleConnectionList.push_back (iConnection);
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void SearchIndexHandle::discard (Connection& ioConnection) {
+    try {
+      closeConnection (ioConnection);
+    } catch (...) {
+      // The lease is given back while an exception is in flight: that
+      // latter must not be replaced
+    }
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Closed a failed connection of " << describe());
+  }
+
+  // //////////////////////////////////////////////////////////////////////
+  void SearchIndexHandle::warm() {
+    BasChronometer lWarmUpChronometer; lWarmUpChronometer.start();
+
+    // Open a first connection, which is given back to the pool afterwards
+    Lease lLease (*this);
+    const Xapian::Database& lXapianDatabase = lLease.getXapianDatabase();
+
+    // 1. Read the value streams, used by the origin hint and nearby searches
+    const XapianValueSlot_T lSlotArray[] = { K_XAPIAN_VALUE_SLOT_LATITUDE,
+                                             K_XAPIAN_VALUE_SLOT_LONGITUDE,
+                                             K_XAPIAN_VALUE_SLOT_COUNTRY_CODE };
+    NbOfDBEntries_T lNbOfValues = 0;
+    for (unsigned short idx = 0; idx != 3; ++idx) {
+      const XapianValueSlot_T& lSlot = lSlotArray[idx];
+      for (Xapian::ValueIterator itValue =
+             lXapianDatabase.valuestream_begin (lSlot);
+           itValue != lXapianDatabase.valuestream_end (lSlot); ++itValue) {
+        ++lNbOfValues;
+      }
+    }
+
+    // 2. Retrieve the most frequent terms (the least frequent one being
+    //    on top of the heap)
+    typedef std::pair<Xapian::doccount, std::string> TermFreq_T;
+    std::priority_queue<TermFreq_T, std::vector<TermFreq_T>,
+                        std::greater<TermFreq_T> > lTermHeap;
+    for (Xapian::TermIterator itTerm = lXapianDatabase.allterms_begin();
+         itTerm != lXapianDatabase.allterms_end(); ++itTerm) {
+      lTermHeap.push (TermFreq_T (itTerm.get_termfreq(), *itTerm));
+      if (lTermHeap.size() > DEFAULT_OPENTREP_WARM_UP_NB_OF_TERMS) {
+        lTermHeap.pop();
+      }
+    }
+
+    // 3. Walk through the posting lists of those terms, and fetch
+    //    the corresponding documents
+    NbOfDBEntries_T lNbOfPostings = 0;
+    for ( ; lTermHeap.empty() == false; lTermHeap.pop()) {
+      const std::string& lTerm = lTermHeap.top().second;
+      for (Xapian::PostingIterator itPosting =
+             lXapianDatabase.postlist_begin (lTerm);
+           itPosting != lXapianDatabase.postlist_end (lTerm); ++itPosting) {
+        const Xapian::Document& lDocument =
+          lXapianDatabase.get_document (*itPosting);
+        lDocument.get_data();
+        ++lNbOfPostings;
+      }
+    }
+
+    // 4. Count the POR of the SQL database, if any
+    NbOfDBEntries_T lNbOfSQLRows = 0;
+    soci::session* lSociSession_ptr = lLease.getSociSessionPtr();
+    if (lSociSession_ptr != NULL) {
+      lNbOfSQLRows = DBManager::displayCount (*lSociSession_ptr);
+    }
+
+    // 5. Build the spatial index of the POR, for the nearby searches
+    boost::shared_ptr<PORSpatialIndex> lSpatialIndex_ptr =
+      boost::make_shared<PORSpatialIndex>();
+    const NbOfDBEntries_T lNbOfSpatialPoints =
+      XapianIndexManager::buildSpatialIndex (lXapianDatabase,
+                                             _travelDBFilePath,
+                                             *lSpatialIndex_ptr);
+    _spatialIndex = lSpatialIndex_ptr;
+
+    const double lWarmUpMeasure = lWarmUpChronometer.elapsed();
+
+    // DEBUG
+    OPENTREP_LOG_DEBUG ("Warmed up " << describe() << " in " << lWarmUpMeasure
+                        << "s: " << lNbOfValues << " values, "
+                        << lNbOfPostings << " postings, "
+                        << lNbOfSQLRows << " SQL rows, "
+                        << lNbOfSpatialPoints << " spatial points");
+  }
+
+}
@@ -0,0 +1,312 @@
+#ifndef __OPENTREP_SVC_SEARCHINDEXHANDLE_HPP
+#define __OPENTREP_SVC_SEARCHINDEXHANDLE_HPP
+
+// //////////////////////////////////////////////////////////////////////
+// Import section
+// //////////////////////////////////////////////////////////////////////
+// STL
+#include <string>
+#include <vector>
+// Boost
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+// OpenTrep
+#include <opentrep/OPENTREP_Types.hpp>
+#include <opentrep/DBType.hpp>
+#include <opentrep/SQLDBLoadMode.hpp>
+#include <opentrep/bom/PORSpatialIndex.hpp>
+#include <opentrep/command/DBSessionManager.hpp>
+
+/**
+ * Forward declarations
+ */
+// Xapian
+namespace Xapian {
+  class Database;
+}
+
+// SOCI (for SQL database)
+namespace soci {
+  class session;
+}
+
+namespace OPENTREP {
+
+  // Forward declarations
+  class SelectStatementCache;
+
+  /**
+   * @brief Handle on the Xapian index and SQL database of a given
+   *        deployment, kept open for the searches.
+   *
+   * Neither Xapian::Database nor soci::session objects may be used by
+   * several threads at once. The handle therefore keeps a pool of
+   * connections (a Xapian database and, if any, a SQL session), each of
+   * them being lent to a single search at once (see Lease). The pool grows
+   * with the number of concurrent searches, and all the connections are
+   * closed when the handle is destroyed, i.e., once the last search using
+   * that handle is over.
+   *
+   * The SQL sessions are opened by the DBSessionManager of the handle,
+   * which may load the SQLite database in memory (see SQLDBLoadMode).
+   * That in-memory copy is released along with the handle. Every SQL
+   * session comes with its prepared look-up statements (see
+   * SelectStatementCache), which are deleted along with the session.
+   *
+   * The handle also holds the spatial index of the POR of its Xapian
+   * index, which is built along with the warm-up, so that the nearby
+   * searches refer to the very documents of that deployment.
+   *
+   * The services hot-swap from a handle to another one when a new version
+   * of the other deployment is ready (see IndexHotSwapper). Without
+   * hot-swap, a handle on the Xapian index of the current deployment,
+   * without SQL database, is kept for the nearby searches (see
+   * OPENTREP_ServiceContext::getNearbyIndexHandle()).
+   */
+  class SearchIndexHandle {
+  private:
+    /**
+     * Connection to the Xapian index and, if any, to the SQL database,
+     * along with the statements prepared on that latter session.
+     */
+    struct Connection {
+      Xapian::Database* _xapianDatabase_ptr;
+      soci::session* _sociSession_ptr;
+      SelectStatementCache* _selectStatementCache_ptr;
+    };
+
+  public:
+    /**
+     * @brief Lease of a connection of the handle, given back to the pool
+     *        when the lease goes out of scope.
+     */
+    class Lease {
+    public:
+      /**
+       * Constructor: borrow a connection from the pool of the given handle,
+       * or open a new one if all of them are in use.
+       */
+      Lease (SearchIndexHandle&);
+
+      /**
+       * Destructor: give the connection back to the pool. When the lease
+       * goes out of scope because of an exception (e.g., the search has
+       * failed), the connection is closed instead, as it may be in a bad
+       * state (e.g., on a revision of the Xapian index no longer available).
+       */
+      ~Lease();
+
+      /**
+       * Get the Xapian database. It may be reopened on its latest revision
+       * (see RequestInterpreter::interpretTravelRequest()).
+       */
+      Xapian::Database& getXapianDatabase() const {
+        return *_connection._xapianDatabase_ptr;
+      }
+
+      /**
+       * Get the SQL database session (NULL when there is no SQL database).
+       */
+      soci::session* getSociSessionPtr() const {
+        return _connection._sociSession_ptr;
+      }
+
+      /**
+       * Get the statements prepared on the SQL database session (NULL
+       * when there is no SQL database).
+       */
+      SelectStatementCache* getSelectStatementCachePtr() const {
+        return _connection._selectStatementCache_ptr;
+      }
+
+    private:
+      /**
+       * Copy constructor (not implemented).
+       */
+      Lease (const Lease&);
+
+    private:
+      SearchIndexHandle& _handle;
+      Connection _connection;
+    };
+
+  public:
+    // /////////////////// Getters //////////////////////
+    /**
+     * Get the number/version of the deployment.
+     */
+    const DeploymentNumber_T& getDeploymentNumber() const {
+      return _deploymentNumber;
+    }
+
+    /**
+     * Get the file-path of the Xapian database/index.
+     */
+    const TravelDBFilePath_T& getTravelDBFilePath() const {
+      return _travelDBFilePath;
+    }
+
+    /**
+     * Get the SQL database type.
+     */
+    const DBType& getSQLDBType() const {
+      return _dbSessionManager.getSQLDBType();
+    }
+
+    /**
+     * Get the SQL database connection string.
+     */
+    const SQLDBConnectionString_T& getSQLDBConnectionString() const {
+      return _dbSessionManager.getSQLDBConnectionString();
+    }
+
+    /**
+     * Get the way of opening the SQLite database.
+     */
+    const SQLDBLoadMode& getSQLDBLoadMode() const {
+      return _dbSessionManager.getSQLDBLoadMode();
+    }
+
+    /**
+     * Get the date-time at which the Xapian index was marked as ready
+     * (empty when there was no such marker).
+     */
+    const std::string& getReadyStamp() const {
+      return _readyStamp;
+    }
+
+    /**
+     * Get the spatial index of the POR of the Xapian index (NULL until
+     * the handle has been warmed up).
+     */
+    const PORSpatialIndexPtr_T& getSpatialIndex() const {
+      return _spatialIndex;
+    }
+
+  public:
+    // /////////////////// Business methods //////////////////////
+    /**
+     * Open a first connection, and warm it up, so that the first searches
+     * do not pay for the loading of the Xapian index and SQL database
+     * pages from the disk: the value streams (coordinates, country codes)
+     * are read, the posting lists of a few frequent terms are walked
+     * through, and the POR of the SQL database are counted. The spatial
+     * index of the POR is built at that stage too. The handle has to be
+     * warmed up before being shared with the searches (see
+     * OPENTREP_ServiceContext::setActiveIndexHandle()).
+     *
+     * An exception is thrown when the Xapian index or the SQL database
+     * cannot be opened.
+     */
+    void warm();
+
+    /**
+     * Get a string describing the handle.
+     */
+    std::string describe() const;
+
+  public:
+    // /////// Construction / destruction ////////
+    /**
+     * Main constructor. No connection is opened at that stage, except,
+     * with the SQLDBLoadMode::IN_MEMORY mode, the one copying the SQLite
+     * database in memory.
+     *
+     * @param const DeploymentNumber_T& Deployment number/version.
+     * @param const TravelDBFilePath_T& File-path of the Xapian index/database.
+     * @param const DBType& SQL database type (can be no database at all).
+     * @param const SQLDBConnectionString_T& SQL DB connection string.
+     * @param const SQLDBLoadMode& Way of opening the SQLite database.
+     * @param const std::string& Date-time held by the ready marker.
+     */
+    SearchIndexHandle (const DeploymentNumber_T&, const TravelDBFilePath_T&,
+                       const DBType&, const SQLDBConnectionString_T&,
+                       const SQLDBLoadMode&, const std::string& iReadyStamp);
+
+    /**
+     * Destructor: close all the connections.
+     */
+    ~SearchIndexHandle();
+
+  private:
+    /**
+     * Default constructor (not implemented).
+     */
+    SearchIndexHandle();
+
+    /**
+     * Copy constructor (not implemented).
+     */
+    SearchIndexHandle (const SearchIndexHandle&);
+
+    /**
+     * Open a new connection.
+     */
+    Connection openConnection() const;
+
+    /**
+     * Close the given connection.
+     */
+    void closeConnection (Connection&) const;
+
+    /**
+     * Borrow a connection from the pool, or open a new one.
+     */
+    Connection acquire();
+
+    /**
+     * Give the connection back to the pool.
+     */
+    void release (const Connection&);
+
+    /**
+     * Close the connection, rather than giving it back to the pool.
+     */
+    void discard (Connection&);
+
+
+  private:
+    // ////////////// Attributes ///////////////
+    /**
+     * Number/version of the deployment.
+     */
+    const DeploymentNumber_T _deploymentNumber;
+
+    /**
+     * File-path of the Xapian index/database.
+     */
+    const TravelDBFilePath_T _travelDBFilePath;
+
+    /**
+     * Manager of the sessions on the SQL database. As the attributes are
+     * destroyed after the body of the destructor, the in-memory copy of
+     * the SQLite database, if any, is released after all the connections
+     * have been closed.
+     */
+    DBSessionManager _dbSessionManager;
+
+    /**
+     * Date-time held by the ready marker of the Xapian index.
+     */
+    const std::string _readyStamp;
+
+    /**
+     * Spatial index of the POR of the Xapian index, built by warm()
+     * and not altered afterwards.
+     */
+    PORSpatialIndexPtr_T _spatialIndex;
+
+    /**
+     * Idle connections, and mutex protecting that pool.
+     */
+    std::vector<Connection> _idleConnectionList;
+    boost::mutex _mutex;
+  };
+
+  /**
+   * Shared pointer on a SearchIndexHandle object.
+   */
+  typedef boost::shared_ptr<SearchIndexHandle> SearchIndexHandlePtr_T;
+
+}
+#endif // __OPENTREP_SVC_SEARCHINDEXHANDLE_HPP
@@ -32,6 +32,11 @@ typedef std::vector<std::string> WordList_T;
  */
 const std::string K_OPENTREP_DEFAULT_LOG_FILENAME ("opentrep-dbmgr.log");
 
+/**
+ * Default name and location for the columnar export of all the POR.
+ */
+const std::string K_OPENTREP_DEFAULT_COLUMNAR_FILENAME ("optd_por.otrepcol");
+
 
 // ///////// Parsing of Options & Configuration /////////
 /** Early return status (so that it can be differentiated from an error). */
@@ -71,6 +76,7 @@ struct Command_T {
     LIST_NB,
     LIST_ALL,
     LIST_CONT,
+    EXPORT_ALL,
     LAST_VALUE
   } Type_T;
 };
@@ -296,6 +302,7 @@ void initReadline (swift::SReadline& ioInputReader) {
   Completers.push_back ("list_nb");
   Completers.push_back ("list_all");
   Completers.push_back ("list_cont");
+  Completers.push_back ("export_all %file");
   Completers.push_back ("quit");
 
   // Now register the completers.
@@ -375,6 +382,9 @@ Command_T::Type_T extractCommand (TokenList_T& ioTokenList) {
     } else if (lCommand == "list_cont") {
       oCommandType = Command_T::LIST_CONT;
 
+    } else if (lCommand == "export_all") {
+      oCommandType = Command_T::EXPORT_ALL;
+
     } else if (lCommand == "quit") {
       oCommandType = Command_T::QUIT;
     }
@@ -734,6 +744,13 @@ int main (int argc, char* argv[]) {
       std::cout << " list_by_geonameid" << "\t\t"
                 << "List all the entries for a given Geoname ID"
                 << std::endl;
+      std::cout << " export_all" << "\t\t\t"
+                << "Export all the entries of the database (or, without SQL "
+                << "database, of the POR file) into a columnar file."
+                << std::endl << "\t\t\t\t"
+                << "The file-path may be given (by default, "
+                << K_OPENTREP_DEFAULT_COLUMNAR_FILENAME << ")"
+                << std::endl;
       std::cout << std::endl;
       break;
     }
@@ -798,6 +815,10 @@ int main (int argc, char* argv[]) {
       std::cout << " list_by_geonameid 6299418" << std::endl;
       std::cout << std::endl;
       std::cout << "    --------    " << std::endl;
+      std::cout << "Export of all the POR, column by column:" << std::endl;
+      std::cout << " export_all /tmp/opentrep/optd_por.otrepcol" << std::endl;
+      std::cout << std::endl;
+      std::cout << "    --------    " << std::endl;
       std::cout << "Management of the database user and database:" << std::endl;
       std::cout <<" reset_connection_string db=mysql user=root password=<passwd>"
                 << std::endl;
@@ -1265,6 +1286,30 @@ int main (int argc, char* argv[]) {
       //
       std::cout << lNbOfEntries << " entries have been processed" << std::endl;
 
+      break;
+    }
+
+      // ///////////////////////// Columnar export /////////////////////////
+    case Command_T::EXPORT_ALL: {
+      // Parse the parameters given by the user, giving default values
+      // in case the user does not specify some (or all) of them
+      std::string lColumnarFilePathStr (K_OPENTREP_DEFAULT_COLUMNAR_FILENAME);
+      parsePlaceKey (lTokenListByReadline, lColumnarFilePathStr);
+
+      //
+      std::cout << "Exporting all the POR into the '" << lColumnarFilePathStr
+                << "' columnar file..." << std::endl;
+
+      // Launch the export, with as many threads as the hardware ones
+      const OPENTREP::FilePath_T lColumnarFilePath (lColumnarFilePathStr);
+      const OPENTREP::NbOfThreads_T lNbOfThreads = 0;
+      const OPENTREP::NbOfDBEntries_T lNbOfEntries =
+        opentrepService.exportToColumnarFile (lColumnarFilePath, lNbOfThreads);
+
+      //
+      std::cout << lNbOfEntries << " POR have been exported into the '"
+                << lColumnarFilePathStr << "' columnar file" << std::endl;
+
       break;
     }
 
@@ -7,23 +7,57 @@
 // //////////////////////////////////////////////////////////////////////
 // STL
 #include <cassert>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <iomanip>
 // Boost Unit Test Framework (UTF)
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_MODULE IndexBuildingTestSuite
 #include <boost/test/unit_test.hpp>
+// Boost Property Tree (PT)
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+// Xapian
+#include <xapian.h>
+// SOCI
+#include <soci/soci.h>
 // OpenTrep
 #include <opentrep/OPENTREP_Service.hpp>
+#include <opentrep/OPENTREP_exceptions.hpp>
+#include <opentrep/PORParserType.hpp>
+#include <opentrep/OutputFormat.hpp>
+#include <opentrep/DSVColumn.hpp>
+#include <opentrep/basic/BasConst_General.hpp>
 #include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
+#include <opentrep/basic/BasChronometer.hpp>
+#include <opentrep/basic/Utilities.hpp>
+#include <opentrep/basic/OTransliterator.hpp>
+#include <opentrep/bom/PORParserHelper.hpp>
+#include <opentrep/bom/LocationView.hpp>
+#include <opentrep/bom/LocationExchange.hpp>
+#include <opentrep/bom/BomJSONExport.hpp>
+#include <opentrep/bom/BomDSVExport.hpp>
+#include <opentrep/bom/ColumnarPORWriter.hpp>
+#include <opentrep/bom/ColumnarPORReader.hpp>
+#include <opentrep/command/ColumnarExporter.hpp>
+#include <opentrep/command/DBManager.hpp>
+#include <opentrep/command/IndexingPipeline.hpp>
+#include <opentrep/command/SelectStatementCache.hpp>
+#include <opentrep/service/Logger.hpp>
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
 #include <opentrep/config/opentrep-paths.hpp>
 
 namespace boost_utf = boost::unit_test;
+namespace bpt = boost::property_tree;
 
 // (Boost) Unit Test XML Report
 std::ofstream utfReportStream ("IndexBuildingTestSuite_utfresults.xml");
@@ -143,6 +177,1387 @@ BOOST_AUTO_TEST_CASE (opentrep_simple_index) {
   logOutputFile.close();
 }
 
+/**
+ * Retrieve the data of all the documents of the given Xapian index,
+ * in the order of their document IDs.
+ */
+std::vector<std::string> getDocumentDataList (const std::string& iXapianDBFP) {
+  std::vector<std::string> oDataList;
+  Xapian::Database lXapianDatabase (iXapianDBFP);
+  const Xapian::docid lLastDocID = lXapianDatabase.get_lastdocid();
+  for (Xapian::docid lDocID = 1; lDocID <= lLastDocID; ++lDocID) {
+    const Xapian::Document& lDocument = lXapianDatabase.get_document (lDocID);
+    oDataList.push_back (lDocument.get_data());
+  }
+  return oDataList;
+}
+
+/**
+ * Test that the indexing with several threads gives the same Xapian
+ * documents, with the same IDs, as the indexing with a single thread
+ */
+BOOST_AUTO_TEST_CASE (opentrep_parallel_index) {
+    
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_parallel.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  const OPENTREP::shouldIndexNonIATAPOR_T lShouldIndexNonIATAPOR (K_ALL_POR);
+  const OPENTREP::shouldIndexPORInXapian_T lShouldIndexPORInXapian(K_XAPIAN_IDX);
+  const OPENTREP::shouldAddPORInSQLDB_T lShouldAddPORInSQLDB (K_SQLDB_ADD);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lPORFilePath,
+                                              lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber,
+                                              lShouldIndexNonIATAPOR,
+                                              lShouldIndexPORInXapian,
+                                              lShouldAddPORInSQLDB);
+
+  // File-path of the Xapian index for that deployment
+  std::ostringstream oXapianDBFP;
+  oXapianDBFP << X_XAPIAN_DB_FP << X_DEPLOYMENT_NUMBER;
+
+  // Indexing with a single thread
+  const OPENTREP::NbOfDBEntries_T nbOfEntriesWithOneThread =
+    opentrepService.insertIntoDBAndXapian (1);
+  const std::vector<std::string>& lDataListWithOneThread =
+    getDocumentDataList (oXapianDBFP.str());
+
+  // Indexing with several threads
+  const OPENTREP::NbOfDBEntries_T nbOfEntriesWithFourThreads =
+    opentrepService.insertIntoDBAndXapian (4);
+  const std::vector<std::string>& lDataListWithFourThreads =
+    getDocumentDataList (oXapianDBFP.str());
+
+  BOOST_CHECK_MESSAGE (nbOfEntriesWithOneThread == 9
+                       && nbOfEntriesWithFourThreads == 9,
+                       "The Xapian index ('" << lTravelDBFilePath
+                       << "') contains " << nbOfEntriesWithOneThread
+                       << " entries with one thread, and "
+                       << nbOfEntriesWithFourThreads
+                       << " with four threads, where as 9 are expected.");
+
+  BOOST_CHECK_MESSAGE (lDataListWithOneThread == lDataListWithFourThreads,
+                       "The Xapian documents differ, when indexed with one "
+                       << "or with four threads.");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test that the indexing into several shards, merged at the end, gives
+ * the same Xapian documents, with the same IDs, as the indexing into a
+ * single Xapian database; and that, when not merged, the shards are
+ * browsed as a single Xapian database through the stub database file
+ */
+BOOST_AUTO_TEST_CASE (opentrep_sharded_index) {
+    
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_sharded.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  const OPENTREP::shouldIndexNonIATAPOR_T lShouldIndexNonIATAPOR (K_ALL_POR);
+  const OPENTREP::shouldIndexPORInXapian_T lShouldIndexPORInXapian(K_XAPIAN_IDX);
+  const OPENTREP::shouldAddPORInSQLDB_T lShouldAddPORInSQLDB (K_SQLDB_ADD);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lPORFilePath,
+                                              lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber,
+                                              lShouldIndexNonIATAPOR,
+                                              lShouldIndexPORInXapian,
+                                              lShouldAddPORInSQLDB);
+
+  // File-path of the Xapian index for that deployment
+  std::ostringstream oXapianDBFP;
+  oXapianDBFP << X_XAPIAN_DB_FP << X_DEPLOYMENT_NUMBER;
+
+  // Indexing into a single Xapian database
+  const OPENTREP::NbOfDBEntries_T nbOfEntriesWithoutShard =
+    opentrepService.insertIntoDBAndXapian (1, 1, true);
+  const std::vector<std::string>& lDataListWithoutShard =
+    getDocumentDataList (oXapianDBFP.str());
+
+  // Indexing into three shards, merged at the end
+  const OPENTREP::NbOfDBEntries_T nbOfEntriesWithMergedShards =
+    opentrepService.insertIntoDBAndXapian (3, 3, true);
+  const std::vector<std::string>& lDataListWithMergedShards =
+    getDocumentDataList (oXapianDBFP.str());
+
+  BOOST_CHECK_MESSAGE (nbOfEntriesWithoutShard == 9
+                       && nbOfEntriesWithMergedShards == 9,
+                       "The Xapian index ('" << lTravelDBFilePath
+                       << "') contains " << nbOfEntriesWithoutShard
+                       << " entries without shard, and "
+                       << nbOfEntriesWithMergedShards
+                       << " with three merged shards, where as 9 are expected.");
+
+  BOOST_CHECK_MESSAGE (lDataListWithoutShard == lDataListWithMergedShards,
+                       "The Xapian documents differ, when indexed without "
+                       << "shard or with three merged shards.");
+
+  // Indexing into three shards, referenced by a stub database. The
+  // document IDs are then interleaved across the shards
+  const OPENTREP::NbOfDBEntries_T nbOfEntriesWithStubDB =
+    opentrepService.insertIntoDBAndXapian (3, 3, false);
+  const Xapian::Database lStubDatabase (oXapianDBFP.str());
+  const Xapian::doccount lNbOfDocsWithStubDB = lStubDatabase.get_doccount();
+
+  BOOST_CHECK_MESSAGE (nbOfEntriesWithStubDB == 9 && lNbOfDocsWithStubDB == 9,
+                       "The Xapian stub database ('" << oXapianDBFP.str()
+                       << "') references " << lNbOfDocsWithStubDB
+                       << " documents, where as 9 are expected.");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test that the incremental update of the Xapian index applies only the
+ * changes of the POR file, and gives the same Xapian documents as a full
+ * indexing
+ */
+BOOST_AUTO_TEST_CASE (opentrep_incremental_index) {
+    
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_incremental.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // New version of the POR file: RIO is removed, and the PageRank
+  // of KEF is changed
+  const std::string lUpdatedPORFilePathStr ("IndexBuildingTestSuite_por.csv");
+  std::ifstream lPORFile (K_POR_FILEPATH.c_str());
+  std::ofstream lUpdatedPORFile (lUpdatedPORFilePathStr.c_str());
+  std::string lPORLine;
+  while (std::getline (lPORFile, lPORLine)) {
+    if (lPORLine.compare (0, 4, "RIO^") == 0) {
+      continue;
+    }
+    if (lPORLine.compare (0, 4, "KEF^") == 0) {
+      const size_t lPageRankPos = lPORLine.find ("^0.052345848");
+      BOOST_REQUIRE (lPageRankPos != std::string::npos);
+      lPORLine.replace (lPageRankPos, 12, "^0.062345848");
+    }
+    lUpdatedPORFile << lPORLine << std::endl;
+  }
+  lUpdatedPORFile.close();
+
+  // Initialise the contexts, for both versions of the POR file
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::PORFilePath_T lUpdatedPORFilePath (lUpdatedPORFilePathStr);
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  const OPENTREP::shouldIndexNonIATAPOR_T lShouldIndexNonIATAPOR (K_ALL_POR);
+  const OPENTREP::shouldIndexPORInXapian_T lShouldIndexPORInXapian(K_XAPIAN_IDX);
+  const OPENTREP::shouldAddPORInSQLDB_T lShouldAddPORInSQLDB (K_SQLDB_ADD);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lPORFilePath,
+                                              lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber,
+                                              lShouldIndexNonIATAPOR,
+                                              lShouldIndexPORInXapian,
+                                              lShouldAddPORInSQLDB);
+  OPENTREP::OPENTREP_Service opentrepUpdatedService (logOutputFile,
+                                                     lUpdatedPORFilePath,
+                                                     lTravelDBFilePath,
+                                                     lDBType, lSQLDBConnStr,
+                                                     lDeploymentNumber,
+                                                     lShouldIndexNonIATAPOR,
+                                                     lShouldIndexPORInXapian,
+                                                     lShouldAddPORInSQLDB);
+
+  // File-path of the Xapian index for that deployment
+  std::ostringstream oXapianDBFP;
+  oXapianDBFP << X_XAPIAN_DB_FP << X_DEPLOYMENT_NUMBER;
+
+  // Full indexing
+  opentrepService.insertIntoDBAndXapian();
+  std::vector<std::string> lFullDataList =
+    getDocumentDataList (oXapianDBFP.str());
+
+  // Update with the same POR file: nothing changes
+  const OPENTREP::IndexUpdateReport& lSameReport =
+    opentrepService.updateDBAndXapian();
+
+  BOOST_CHECK_MESSAGE (lSameReport.getNbOfUnchangedPOR() == 9
+                       && lSameReport.getNbOfAddedPOR() == 0
+                       && lSameReport.getNbOfChangedPOR() == 0
+                       && lSameReport.getNbOfRemovedPOR() == 0,
+                       "The update with the same POR file gives "
+                       << lSameReport.describe()
+                       << ", where as 9 unchanged ones are expected.");
+
+  // Update with the new version of the POR file
+  const OPENTREP::IndexUpdateReport& lUpdateReport =
+    opentrepUpdatedService.updateDBAndXapian();
+  const Xapian::doccount lNbOfUpdatedDocs =
+    Xapian::Database (oXapianDBFP.str()).get_doccount();
+
+  BOOST_CHECK_MESSAGE (lUpdateReport.getNbOfUnchangedPOR() == 7
+                       && lUpdateReport.getNbOfAddedPOR() == 0
+                       && lUpdateReport.getNbOfChangedPOR() == 1
+                       && lUpdateReport.getNbOfRemovedPOR() == 1
+                       && lNbOfUpdatedDocs == 8,
+                       "The update with the new POR file gives "
+                       << lUpdateReport.describe() << " (" << lNbOfUpdatedDocs
+                       << " documents), where as 1 changed and 1 removed ones"
+                       << " are expected (8 documents).");
+
+  // Update back with the former version of the POR file
+  const OPENTREP::IndexUpdateReport& lBackReport =
+    opentrepService.updateDBAndXapian();
+  std::vector<std::string> lUpdatedDataList =
+    getDocumentDataList (oXapianDBFP.str());
+
+  BOOST_CHECK_MESSAGE (lBackReport.getNbOfUnchangedPOR() == 7
+                       && lBackReport.getNbOfAddedPOR() == 1
+                       && lBackReport.getNbOfChangedPOR() == 1
+                       && lBackReport.getNbOfRemovedPOR() == 0,
+                       "The update back with the former POR file gives "
+                       << lBackReport.describe() << ", where as 1 added and"
+                       << " 1 changed ones are expected.");
+
+  // The re-added document has got a new ID
+  std::sort (lFullDataList.begin(), lFullDataList.end());
+  std::sort (lUpdatedDataList.begin(), lUpdatedDataList.end());
+  BOOST_CHECK_MESSAGE (lFullDataList == lUpdatedDataList,
+                       "The Xapian documents differ, when indexed from "
+                       << "scratch or updated incrementally.");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Replace the given field (the fields being separated by carets)
+ * of a POR record.
+ */
+std::string replacePORField (const std::string& iPORLine,
+                             const unsigned short iFieldIdx,
+                             const std::string& iValue) {
+  size_t lBeginPos = 0;
+  for (unsigned short idx = 0; idx != iFieldIdx; ++idx) {
+    lBeginPos = iPORLine.find ('^', lBeginPos) + 1;
+  }
+  const size_t lEndPos = iPORLine.find ('^', lBeginPos);
+  std::string oPORLine (iPORLine);
+  oPORLine.replace (lBeginPos, lEndPos - lBeginPos, iValue);
+  return oPORLine;
+}
+
+/**
+ * Parse the given POR record with the given parser.
+ *
+ * @return std::string Description of the Location structure, or an empty
+ *         string when the record cannot be parsed.
+ */
+std::string parsePOR (const OPENTREP::PORParserType& iPORParserType,
+                      const std::string& iPORLine) {
+  try {
+    OPENTREP::PORStringParser lPORParser (iPORLine, iPORParserType);
+    return lPORParser.generateLocation().toString();
+  } catch (const OPENTREP::PorFileParsingException& lException) {
+    return "";
+  }
+}
+
+/**
+ * Test that the SIMD parser of the POR records gives the same Location
+ * structures as the Spirit grammar, and rejects the same malformed records
+ */
+BOOST_AUTO_TEST_CASE (opentrep_por_parsers) {
+    
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_parsers.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  const OPENTREP::shouldIndexNonIATAPOR_T lShouldIndexNonIATAPOR (K_ALL_POR);
+  const OPENTREP::shouldIndexPORInXapian_T lShouldIndexPORInXapian(K_XAPIAN_IDX);
+  const OPENTREP::shouldAddPORInSQLDB_T lShouldAddPORInSQLDB (K_SQLDB_ADD);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lPORFilePath,
+                                              lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber,
+                                              lShouldIndexNonIATAPOR,
+                                              lShouldIndexPORInXapian,
+                                              lShouldAddPORInSQLDB);
+
+  // The records of the POR file, and some variations of the KEF one:
+  // without alternate names, with spaces before the names, with a caret
+  // within an alternate name, with a missing field, and with a wrong
+  // IATA code
+  std::vector<std::string> lPORLineList;
+  std::ifstream lPORFile (K_POR_FILEPATH.c_str());
+  std::string lPORLine;
+  std::string lKEFLine;
+  while (std::getline (lPORFile, lPORLine)) {
+    lPORLineList.push_back (lPORLine);
+    if (lPORLine.compare (0, 4, "KEF^") == 0) {
+      lKEFLine = lPORLine;
+    }
+  }
+  BOOST_REQUIRE (lKEFLine.empty() == false);
+
+  lPORLineList.push_back (replacePORField (lKEFLine, 43, ""));
+  lPORLineList.push_back (replacePORField (lKEFLine, 6, "  Keflavik"));
+  lPORLineList.push_back (replacePORField (lKEFLine, 18, " Iceland "));
+  lPORLineList.push_back (replacePORField (lKEFLine, 43, "en|Kef^lavik|"));
+  lPORLineList.push_back (replacePORField (lKEFLine, 43, "e^n|Keflavik|"));
+  lPORLineList.push_back (lKEFLine.substr (0, lKEFLine.rfind ('^')));
+  lPORLineList.push_back (replacePORField (lKEFLine, 0, "KEFL"));
+
+  const OPENTREP::PORParserType lSpiritType (OPENTREP::PORParserType::SPIRIT);
+  const OPENTREP::PORParserType lSIMDType (OPENTREP::PORParserType::SIMD);
+  unsigned short lNbOfParsedPOR = 0;
+  for (std::vector<std::string>::const_iterator itLine = lPORLineList.begin();
+       itLine != lPORLineList.end(); ++itLine) {
+    const std::string& lSpiritStr =
+      parsePOR (lSpiritType, *itLine);
+    const std::string& lSIMDStr =
+      parsePOR (lSIMDType, *itLine);
+
+    BOOST_CHECK_MESSAGE (lSpiritStr == lSIMDStr,
+                         "The Spirit and SIMD parsers differ on '" << *itLine
+                         << "'. Spirit: '" << lSpiritStr << "'. SIMD: '"
+                         << lSIMDStr << "'");
+
+    if (lSpiritStr.empty() == false) {
+      ++lNbOfParsedPOR;
+    }
+  }
+
+  // The records with a caret within a language code, with a missing field
+  // and with a wrong IATA code are rejected
+  BOOST_CHECK_MESSAGE (lNbOfParsedPOR == lPORLineList.size() - 3,
+                       lNbOfParsedPOR << " POR records have been parsed,"
+                       << " where as " << lPORLineList.size() - 3
+                       << " are expected.");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test that the read-only views over the raw data of the POR give back,
+ * for every record of the POR file, the same fields and the same Location
+ * structures as the POR parser
+ */
+BOOST_AUTO_TEST_CASE (opentrep_location_view) {
+    
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_view.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  const OPENTREP::shouldIndexNonIATAPOR_T lShouldIndexNonIATAPOR (K_ALL_POR);
+  const OPENTREP::shouldIndexPORInXapian_T lShouldIndexPORInXapian(K_XAPIAN_IDX);
+  const OPENTREP::shouldAddPORInSQLDB_T lShouldAddPORInSQLDB (K_SQLDB_ADD);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lPORFilePath,
+                                              lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber,
+                                              lShouldIndexNonIATAPOR,
+                                              lShouldIndexPORInXapian,
+                                              lShouldAddPORInSQLDB);
+
+  std::ifstream lPORFile (K_POR_FILEPATH.c_str());
+  std::string lPORLine;
+  unsigned short lNbOfComparedPOR = 0;
+  while (std::getline (lPORFile, lPORLine)) {
+    // The header of the POR file is not a POR record
+    if (lPORLine.compare (0, 10, "iata_code^") == 0) {
+      continue;
+    }
+
+    OPENTREP::PORStringParser lPORParser (lPORLine);
+    const OPENTREP::Location& lLocation = lPORParser.generateLocation();
+    const OPENTREP::LocationView lLocationView (lPORLine);
+
+    BOOST_CHECK_MESSAGE (lLocationView.getKey() == lLocation.getKey(),
+                         "The view over '" << lPORLine << "' gives the key '"
+                         << lLocationView.getKey().toString()
+                         << "' instead of '" << lLocation.getKey().toString()
+                         << "'");
+    BOOST_CHECK_MESSAGE (lLocationView.getIataCode()
+                         == lLocation.getIataCode(),
+                         "The view over '" << lPORLine
+                         << "' gives the IATA code '"
+                         << lLocationView.getIataCode() << "' instead of '"
+                         << lLocation.getIataCode() << "'");
+    BOOST_CHECK_MESSAGE (lLocationView.getIataType()
+                         == lLocation.getIataType(),
+                         "The view over '" << lPORLine
+                         << "' gives the IATA type '"
+                         << lLocationView.getIataType().getTypeAsString()
+                         << "' instead of '"
+                         << lLocation.getIataType().getTypeAsString() << "'");
+    BOOST_CHECK_MESSAGE (lLocationView.getGeonamesID()
+                         == lLocation.getGeonamesID(),
+                         "The view over '" << lPORLine
+                         << "' gives the Geonames ID "
+                         << lLocationView.getGeonamesID() << " instead of "
+                         << lLocation.getGeonamesID());
+    BOOST_CHECK_MESSAGE (lLocationView.getPageRank()
+                         == lLocation.getPageRank(),
+                         "The view over '" << lPORLine
+                         << "' gives the PageRank "
+                         << lLocationView.getPageRank() << " instead of "
+                         << lLocation.getPageRank());
+    BOOST_CHECK_MESSAGE (lLocationView.getEnvelopeID()
+                         == lLocation.getEnvelopeID(),
+                         "The view over '" << lPORLine
+                         << "' gives the envelope ID "
+                         << lLocationView.getEnvelopeID() << " instead of "
+                         << lLocation.getEnvelopeID());
+    BOOST_CHECK_MESSAGE (lLocationView.getLatitude()
+                         == lLocation.getLatitude(),
+                         "The view over '" << lPORLine
+                         << "' gives the latitude "
+                         << lLocationView.getLatitude() << " instead of "
+                         << lLocation.getLatitude());
+    BOOST_CHECK_MESSAGE (lLocationView.getLongitude()
+                         == lLocation.getLongitude(),
+                         "The view over '" << lPORLine
+                         << "' gives the longitude "
+                         << lLocationView.getLongitude() << " instead of "
+                         << lLocation.getLongitude());
+    BOOST_CHECK_MESSAGE (lLocationView.getFeatureCode()
+                         == lLocation.getFeatureCode(),
+                         "The view over '" << lPORLine
+                         << "' gives the feature code '"
+                         << lLocationView.getFeatureCode() << "' instead of '"
+                         << lLocation.getFeatureCode() << "'");
+
+    const OPENTREP::Location& lViewLocation = lLocationView.toLocation();
+    BOOST_CHECK_MESSAGE (lViewLocation.toString() == lLocation.toString(),
+                         "The view over '" << lPORLine << "' gives '"
+                         << lViewLocation.toString() << "' instead of '"
+                         << lLocation.toString() << "'");
+
+    ++lNbOfComparedPOR;
+  }
+  BOOST_CHECK_MESSAGE (lNbOfComparedPOR > 0,
+                       "No POR record has been compared");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test that the Protobuf records of the POR, as stored within the SQL
+ * database, give back the Location structures parsed from the POR file.
+ * The decoding time of those records is compared to the parsing time
+ * of the POR records (the figures are only reported, not checked)
+ */
+BOOST_AUTO_TEST_CASE (opentrep_por_protobuf) {
+    
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_protobuf.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  const OPENTREP::shouldIndexNonIATAPOR_T lShouldIndexNonIATAPOR (K_ALL_POR);
+  const OPENTREP::shouldIndexPORInXapian_T lShouldIndexPORInXapian(K_XAPIAN_IDX);
+  const OPENTREP::shouldAddPORInSQLDB_T lShouldAddPORInSQLDB (K_SQLDB_ADD);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lPORFilePath,
+                                              lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber,
+                                              lShouldIndexNonIATAPOR,
+                                              lShouldIndexPORInXapian,
+                                              lShouldAddPORInSQLDB);
+
+  // Parse the records of the POR file, and store them as they would be
+  // within the SQL database
+  const OPENTREP::PORParserType lSpiritType (OPENTREP::PORParserType::SPIRIT);
+  const OPENTREP::PORParserType lSIMDType (OPENTREP::PORParserType::SIMD);
+  std::vector<std::string> lPORLineList;
+  std::vector<std::string> lPlaceRecordList;
+  std::size_t lPORLineSize = 0;
+  std::size_t lPlaceRecordSize = 0;
+  std::ifstream lPORFile (K_POR_FILEPATH.c_str());
+  std::string lPORLine;
+  while (std::getline (lPORFile, lPORLine)) {
+    OPENTREP::Location lLocation;
+    try {
+      OPENTREP::PORStringParser lPORParser (lPORLine, lSpiritType);
+      lLocation = lPORParser.generateLocation();
+    } catch (const OPENTREP::PorFileParsingException& lException) {
+      // The header of the POR file is not a POR record
+      continue;
+    }
+
+    const std::string lPlaceRecord =
+      OPENTREP::LocationExchange::serialiseLocation (lLocation);
+    lPORLineSize += lPORLine.size();
+    lPlaceRecordSize += lPlaceRecord.size();
+
+    // Decode the Protobuf record, and compare with the parsed POR
+    const OPENTREP::Location& lDecodedLocation =
+      OPENTREP::LocationExchange::deserialiseLocation (lPlaceRecord);
+    BOOST_CHECK_MESSAGE (lDecodedLocation.toString() == lLocation.toString(),
+                         "The Protobuf record of '" << lPORLine
+                         << "' gives '" << lDecodedLocation.toString()
+                         << "' instead of '" << lLocation.toString() << "'");
+
+    lPORLineList.push_back (lPORLine);
+    lPlaceRecordList.push_back (lPlaceRecord);
+  }
+  BOOST_REQUIRE (lPORLineList.empty() == false);
+
+  // The Protobuf records are stored instead of the raw data strings:
+  // they must not take more room
+  BOOST_CHECK_MESSAGE (lPlaceRecordSize < lPORLineSize,
+                       "The Protobuf records take " << lPlaceRecordSize
+                       << " bytes, while the raw data strings take "
+                       << lPORLineSize << " bytes");
+
+  // Compare the time needed to retrieve the Location structures from
+  // the raw data strings (with both parsers) and from the Protobuf records
+  const unsigned short lNbOfRuns = 100;
+  std::size_t lNbOfChars = 0;
+  OPENTREP::BasChronometer lSpiritChronometer; lSpiritChronometer.start();
+  for (unsigned short idxRun = 0; idxRun != lNbOfRuns; ++idxRun) {
+    for (std::vector<std::string>::const_iterator itLine =
+           lPORLineList.begin(); itLine != lPORLineList.end(); ++itLine) {
+      OPENTREP::PORStringParser lPORParser (*itLine, lSpiritType);
+      lNbOfChars += lPORParser.generateLocation().getIataCode().size();
+    }
+  }
+  const double lSpiritElapsed = lSpiritChronometer.elapsed();
+
+  // The parser type selected through the service is the one of the
+  // parsers created without any
+  opentrepService.setPORParserType (lSIMDType);
+  BOOST_CHECK (OPENTREP::PORStringParser::getParserType() == lSIMDType);
+
+  OPENTREP::BasChronometer lSIMDChronometer; lSIMDChronometer.start();
+  for (unsigned short idxRun = 0; idxRun != lNbOfRuns; ++idxRun) {
+    for (std::vector<std::string>::const_iterator itLine =
+           lPORLineList.begin(); itLine != lPORLineList.end(); ++itLine) {
+      OPENTREP::PORStringParser lPORParser (*itLine);
+      lNbOfChars += lPORParser.generateLocation().getIataCode().size();
+    }
+  }
+  const double lSIMDElapsed = lSIMDChronometer.elapsed();
+
+  OPENTREP::BasChronometer lPBChronometer; lPBChronometer.start();
+  for (unsigned short idxRun = 0; idxRun != lNbOfRuns; ++idxRun) {
+    for (std::vector<std::string>::const_iterator itRecord =
+           lPlaceRecordList.begin(); itRecord != lPlaceRecordList.end();
+         ++itRecord) {
+      const OPENTREP::Location& lLocation =
+        OPENTREP::LocationExchange::deserialiseLocation (*itRecord);
+      lNbOfChars += lLocation.getIataCode().size();
+    }
+  }
+  const double lPBElapsed = lPBChronometer.elapsed();
+
+  BOOST_TEST_MESSAGE ("Retrieval of " << lPORLineList.size() << " POR, "
+                      << lNbOfRuns << " times (" << lNbOfChars
+                      << " characters of IATA codes): Spirit parser: "
+                      << lSpiritElapsed << "s, SIMD parser: " << lSIMDElapsed
+                      << "s, Protobuf decoder: " << lPBElapsed << "s");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Export the given location into a Boost.PropertyTree, as BomJSONExport
+ * used to do it. That reference export gives the JSON keys expected from
+ * the direct export, and the time it used to take.
+ */
+void jsonExportLocationWithPT (bpt::ptree& ioPTLocation,
+                               const OPENTREP::Location& iLocation) {
+  // Fill all the fields of the JSON instance
+  ioPTLocation.put ("iata_code", iLocation.getIataCode());
+  ioPTLocation.put ("icao_code", iLocation.getIcaoCode());
+  ioPTLocation.put ("geonames_id", iLocation.getGeonamesID());
+  ioPTLocation.put ("feature_class", iLocation.getFeatureClass());
+  ioPTLocation.put ("feature_code", iLocation.getFeatureCode());
+  ioPTLocation.put ("modification_date", iLocation.getModificationDate());
+  ioPTLocation.put ("faa_code", iLocation.getFaaCode());
+  ioPTLocation.put ("env_id", iLocation.getEnvelopeID());
+  ioPTLocation.put ("date_from", iLocation.getDateFrom());
+  ioPTLocation.put ("date_end", iLocation.getDateEnd());
+  ioPTLocation.put ("name_common", iLocation.getCommonName());
+  ioPTLocation.put ("name_ascii", iLocation.getAsciiName());
+  ioPTLocation.put ("state_code", iLocation.getStateCode());
+  ioPTLocation.put ("country_code", iLocation.getCountryCode());
+  ioPTLocation.put ("country_name", iLocation.getCountryName());
+  ioPTLocation.put ("alt_country_code", iLocation.getAltCountryCode());
+  ioPTLocation.put ("continent_code", iLocation.getContinentCode());
+  ioPTLocation.put ("continent_name", iLocation.getContinentName());
+  ioPTLocation.put ("adm1_code", iLocation.getAdmin1Code());
+  ioPTLocation.put ("adm1_name_utf", iLocation.getAdmin1UtfName());
+  ioPTLocation.put ("adm1_name_ascii", iLocation.getAdmin1AsciiName());
+  ioPTLocation.put ("adm2_code", iLocation.getAdmin2Code());
+  ioPTLocation.put ("adm2_name_utf", iLocation.getAdmin2UtfName());
+  ioPTLocation.put ("adm2_name_ascii", iLocation.getAdmin2AsciiName());
+  ioPTLocation.put ("adm3_code", iLocation.getAdmin3Code());
+  ioPTLocation.put ("adm4_code", iLocation.getAdmin4Code());
+  ioPTLocation.put ("tvl_por_list", iLocation.getTvlPORListString());
+  ioPTLocation.put ("time_zone", iLocation.getTimeZone());
+  ioPTLocation.put ("offset_gmt", iLocation.getGMTOffset());
+  ioPTLocation.put ("offset_dst", iLocation.getDSTOffset());
+  ioPTLocation.put ("offset_raw", iLocation.getRawOffset());
+  ioPTLocation.put ("lat", iLocation.getLatitude());
+  ioPTLocation.put ("lon", iLocation.getLongitude());
+  ioPTLocation.put ("geonames_lat", iLocation.getGeonameLatitude());
+  ioPTLocation.put ("geonames_lon", iLocation.getGeonameLongitude());
+  ioPTLocation.put ("population", iLocation.getPopulation());
+  ioPTLocation.put ("elevation", iLocation.getElevation());
+  ioPTLocation.put ("gtopo30", iLocation.getGTopo30());
+  ioPTLocation.put ("page_rank", iLocation.getPageRank());
+  ioPTLocation.put ("wac", iLocation.getWAC());
+  ioPTLocation.put ("wac_name", iLocation.getWACName());
+  ioPTLocation.put ("wiki_link", iLocation.getWikiLink());
+  ioPTLocation.put ("currency_code", iLocation.getCurrencyCode());
+  ioPTLocation.put ("original_keywords", iLocation.getOriginalKeywords());
+  ioPTLocation.put ("corrected_keywords", iLocation.getCorrectedKeywords());
+  ioPTLocation.put ("matching_percentage", iLocation.getPercentage());
+  ioPTLocation.put ("edit_distance", iLocation.getEditDistance());
+  ioPTLocation.put ("allowable_distance", iLocation.getAllowableEditDistance());
+
+  // List of UN/LOCODE codes
+  bpt::ptree ptUNLOCodeList;
+  const OPENTREP::UNLOCodeList_T& lUNCodeList = iLocation.getUNLOCodeList();
+  for (OPENTREP::UNLOCodeList_T::const_iterator itUNLOCode =
+         lUNCodeList.begin(); itUNLOCode != lUNCodeList.end(); ++itUNLOCode) {
+    ptUNLOCodeList.put ("unlocode_code", *itUNLOCode);
+  }
+  ioPTLocation.add_child ("unlocode_codes", ptUNLOCodeList);
+
+  // List of served cities
+  bpt::ptree ptCityList;
+  const OPENTREP::CityDetailsList_T& lCityList = iLocation.getCityList();
+  for (OPENTREP::CityDetailsList_T::const_iterator itCity = lCityList.begin();
+       itCity != lCityList.end(); ++itCity) {
+    const OPENTREP::CityDetails& lCityDetails = *itCity;
+    bpt::ptree ptCityDetails;
+    ptCityDetails.put ("iata_code", lCityDetails.getIataCode());
+    ptCityDetails.put ("geonames_id", lCityDetails.getGeonamesID());
+    ptCityDetails.put ("name_utf", lCityDetails.getUtfName());
+    ptCityDetails.put ("name_ascii", lCityDetails.getAsciiName());
+    ptCityList.push_back (std::make_pair ("city_details", ptCityDetails));
+  }
+  ioPTLocation.add_child ("cities", ptCityList);
+
+  // Alternate names, in all the available languages
+  bpt::ptree ptLocationNameList;
+  const OPENTREP::NameMatrix_T& lNameMatrix =
+    iLocation.getNameMatrix().getNameMatrix();
+  for (OPENTREP::NameMatrix_T::const_iterator itNameList = lNameMatrix.begin();
+       itNameList != lNameMatrix.end(); ++itNameList) {
+    const OPENTREP::NameList_T& lNameList = itNameList->second.getNameList();
+    for (OPENTREP::NameList_T::const_iterator itName = lNameList.begin();
+         itName != lNameList.end(); ++itName) {
+      const std::string& lName = *itName;
+      if (lName.empty() == false) {
+        bpt::ptree ptLocationName;
+        ptLocationName.put ("name", lName);
+        ptLocationNameList.push_back (std::make_pair ("", ptLocationName));
+      }
+    }
+  }
+  ioPTLocation.add_child ("names", ptLocationNameList);
+}
+
+/**
+ * Export the given list of locations in JSON, with Boost.PropertyTree, as
+ * BomJSONExport used to do it (see jsonExportLocationWithPT())
+ */
+void jsonExportLocationListWithPT (std::ostream& oStream,
+                                   const OPENTREP::LocationList_T& iLocList) {
+  bpt::ptree lPT;
+  bpt::ptree lPTLocationList;
+
+  for (OPENTREP::LocationList_T::const_iterator itLocation =
+         iLocList.begin(); itLocation != iLocList.end(); ++itLocation) {
+    const OPENTREP::Location& lLocation = *itLocation;
+    bpt::ptree lPTLocation;
+    jsonExportLocationWithPT (lPTLocation, lLocation);
+
+    // Extra matching locations (with the same matching percentage)
+    const OPENTREP::LocationList_T& lExtraLocationList =
+      lLocation.getExtraLocationList();
+    if (lExtraLocationList.empty() == false) {
+      bpt::ptree lPTExtraLocationList;
+      for (OPENTREP::LocationList_T::const_iterator itLoc =
+             lExtraLocationList.begin(); itLoc != lExtraLocationList.end();
+           ++itLoc) {
+        bpt::ptree lPTExtraLocation;
+        jsonExportLocationWithPT (lPTExtraLocation, *itLoc);
+        lPTExtraLocationList.push_back (std::make_pair ("", lPTExtraLocation));
+      }
+      lPTLocation.add_child ("extras", lPTExtraLocationList);
+    }
+
+    // Alternate matching locations (with a lower matching percentage)
+    const OPENTREP::LocationList_T& lAltLocationList =
+      lLocation.getAlternateLocationList();
+    if (lAltLocationList.empty() == false) {
+      bpt::ptree lPTAltLocationList;
+      for (OPENTREP::LocationList_T::const_iterator itLoc =
+             lAltLocationList.begin(); itLoc != lAltLocationList.end();
+           ++itLoc) {
+        bpt::ptree lPTAltLocation;
+        jsonExportLocationWithPT (lPTAltLocation, *itLoc);
+        lPTAltLocationList.push_back (std::make_pair ("", lPTAltLocation));
+      }
+      lPTLocation.add_child ("alternates", lPTAltLocationList);
+    }
+
+    lPTLocationList.push_back (std::make_pair ("", lPTLocation));
+  }
+
+  lPT.add_child ("locations", lPTLocationList);
+  bpt::write_json (oStream, lPT);
+}
+
+/**
+ * Retrieve the set of the keys of the given (parsed JSON) tree
+ */
+std::set<std::string> getPTKeySet (const bpt::ptree& iPT) {
+  std::set<std::string> oKeySet;
+  for (bpt::ptree::const_iterator itChild = iPT.begin();
+       itChild != iPT.end(); ++itChild) {
+    oKeySet.insert (itChild->first);
+  }
+  return oKeySet;
+}
+
+/**
+ * Check that the given (parsed JSON) location has the same keys as the
+ * reference one, and so have its extra and alternate locations.
+ * @return the number of checked locations.
+ */
+unsigned int checkJSONLocationKeys (const bpt::ptree& iPTLocation,
+                                    const bpt::ptree& iRefPTLocation) {
+  unsigned int oNbOfLocations = 1;
+  BOOST_CHECK (getPTKeySet (iPTLocation) == getPTKeySet (iRefPTLocation));
+
+  const char* lSubListNames[] = { "extras", "alternates" };
+  for (unsigned short idx = 0; idx != 2; ++idx) {
+    const char* lSubListName = lSubListNames[idx];
+    const boost::optional<const bpt::ptree&> lRefPTSubList =
+      iRefPTLocation.get_child_optional (lSubListName);
+    const boost::optional<const bpt::ptree&> lPTSubList =
+      iPTLocation.get_child_optional (lSubListName);
+    if (!lRefPTSubList || !lPTSubList) {
+      continue;
+    }
+    BOOST_REQUIRE_EQUAL (lPTSubList->size(), lRefPTSubList->size());
+
+    bpt::ptree::const_iterator itRef = lRefPTSubList->begin();
+    for (bpt::ptree::const_iterator itLoc = lPTSubList->begin();
+         itLoc != lPTSubList->end(); ++itLoc, ++itRef) {
+      oNbOfLocations += checkJSONLocationKeys (itLoc->second, itRef->second);
+    }
+  }
+  return oNbOfLocations;
+}
+
+/**
+ * Test the export, in JSON, of a large list of Location structures, and
+ * compare with a JSON export made with Boost.PropertyTree, as it used to be
+ */
+BOOST_AUTO_TEST_CASE (opentrep_json_export) {
+    
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_json.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  const OPENTREP::shouldIndexNonIATAPOR_T lShouldIndexNonIATAPOR (K_ALL_POR);
+  const OPENTREP::shouldIndexPORInXapian_T lShouldIndexPORInXapian(K_XAPIAN_IDX);
+  const OPENTREP::shouldAddPORInSQLDB_T lShouldAddPORInSQLDB (K_SQLDB_ADD);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lPORFilePath,
+                                              lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber,
+                                              lShouldIndexNonIATAPOR,
+                                              lShouldIndexPORInXapian,
+                                              lShouldAddPORInSQLDB);
+
+  // Parse the records of the POR file. Every location is given the former
+  // one as extra and the two former ones as alternate matching locations,
+  // so as to get a large output
+  OPENTREP::LocationList_T lLocationList;
+  std::ifstream lPORFile (K_POR_FILEPATH.c_str());
+  std::string lPORLine;
+  OPENTREP::LocationList_T lFormerLocationList;
+  while (std::getline (lPORFile, lPORLine)) {
+    OPENTREP::Location lLocation;
+    try {
+      OPENTREP::PORStringParser lPORParser (lPORLine);
+      lLocation = lPORParser.generateLocation();
+    } catch (const OPENTREP::PorFileParsingException& lException) {
+      // The header of the POR file is not a POR record
+      continue;
+    }
+
+    OPENTREP::Location lMatchingLocation (lLocation);
+    for (OPENTREP::LocationList_T::const_iterator itLocation =
+           lFormerLocationList.begin();
+         itLocation != lFormerLocationList.end(); ++itLocation) {
+      lMatchingLocation.addAlternateLocation (*itLocation);
+    }
+    if (lFormerLocationList.empty() == false) {
+      lMatchingLocation.addExtraLocation (lFormerLocationList.back());
+    }
+    lLocationList.push_back (lMatchingLocation);
+
+    lFormerLocationList.push_back (lLocation);
+    if (lFormerLocationList.size() > 2) {
+      lFormerLocationList.pop_front();
+    }
+  }
+  BOOST_REQUIRE (lLocationList.empty() == false);
+
+  // Export the list in JSON, several times within the same buffer
+  const unsigned short lNbOfRuns = 10;
+  std::string lJSONBuffer;
+  OPENTREP::BasChronometer lJSONChronometer; lJSONChronometer.start();
+  for (unsigned short idxRun = 0; idxRun != lNbOfRuns; ++idxRun) {
+    OPENTREP::BomJSONExport::jsonExportLocationList (lJSONBuffer,
+                                                     lLocationList);
+  }
+  const double lJSONElapsed = lJSONChronometer.elapsed();
+
+  // The stream-based export must give the same JSON string
+  std::ostringstream lJSONStream;
+  OPENTREP::BomJSONExport::jsonExportLocationList (lJSONStream, lLocationList);
+  BOOST_CHECK (lJSONStream.str() == lJSONBuffer);
+
+  // Check that the JSON string is valid, and holds all the locations
+  bpt::ptree lPT;
+  std::istringstream lJSONInput (lJSONBuffer);
+  BOOST_REQUIRE_NO_THROW (bpt::read_json (lJSONInput, lPT));
+  const bpt::ptree& lPTLocationList = lPT.get_child ("locations");
+  BOOST_CHECK_EQUAL (lPTLocationList.size(), lLocationList.size());
+
+  const OPENTREP::Location& lFirstLocation = lLocationList.front();
+  const bpt::ptree& lPTFirstLocation = lPTLocationList.begin()->second;
+  BOOST_CHECK_EQUAL (lPTFirstLocation.get<std::string> ("iata_code"),
+                     lFirstLocation.getIataCode());
+  BOOST_CHECK_CLOSE (lPTFirstLocation.get<double> ("lat"),
+                     lFirstLocation.getLatitude(), 1e-9);
+  BOOST_CHECK_EQUAL (lPTFirstLocation.get<unsigned int> ("geonames_id"),
+                     lFirstLocation.getGeonamesID());
+
+  const OPENTREP::Location& lLastLocation = lLocationList.back();
+  const bpt::ptree& lPTLastLocation = lPTLocationList.rbegin()->second;
+  BOOST_CHECK_EQUAL (lPTLastLocation.get_child ("extras").size(),
+                     lLastLocation.getExtraLocationList().size());
+  BOOST_CHECK_EQUAL (lPTLastLocation.get_child ("alternates").size(),
+                     lLastLocation.getAlternateLocationList().size());
+  BOOST_CHECK_EQUAL (lPTLastLocation.get_child ("unlocode_codes").size(),
+                     lLastLocation.getUNLOCodeList().size());
+  BOOST_CHECK_EQUAL (lPTLastLocation.get_child ("cities").size(),
+                     lLastLocation.getCityList().size());
+
+  // Compare with the time needed to build the JSON tree with
+  // Boost.PropertyTree and to write it, as the export used to do
+  std::string lRefJSONString;
+  OPENTREP::BasChronometer lPTChronometer; lPTChronometer.start();
+  for (unsigned short idxRun = 0; idxRun != lNbOfRuns; ++idxRun) {
+    std::ostringstream lPTStream;
+    jsonExportLocationListWithPT (lPTStream, lLocationList);
+    lRefJSONString = lPTStream.str();
+  }
+  const double lPTElapsed = lPTChronometer.elapsed();
+
+  // Every location, extra and alternate locations included, must have
+  // the same keys as with the reference export
+  bpt::ptree lRefPT;
+  std::istringstream lRefJSONInput (lRefJSONString);
+  BOOST_REQUIRE_NO_THROW (bpt::read_json (lRefJSONInput, lRefPT));
+  const bpt::ptree& lRefPTLocationList = lRefPT.get_child ("locations");
+  BOOST_REQUIRE_EQUAL (lPTLocationList.size(), lRefPTLocationList.size());
+  unsigned int lNbOfCheckedLocations = 0;
+  bpt::ptree::const_iterator itRefLocation = lRefPTLocationList.begin();
+  for (bpt::ptree::const_iterator itLocation = lPTLocationList.begin();
+       itLocation != lPTLocationList.end(); ++itLocation, ++itRefLocation) {
+    lNbOfCheckedLocations += checkJSONLocationKeys (itLocation->second,
+                                                    itRefLocation->second);
+  }
+  BOOST_CHECK_GT (lNbOfCheckedLocations, lLocationList.size());
+
+  BOOST_TEST_MESSAGE ("JSON export of " << lLocationList.size() << " POR ("
+                      << lJSONBuffer.size() << " characters), "
+                      << lNbOfRuns << " times: direct export: "
+                      << lJSONElapsed << "s, Boost.PropertyTree (tree build"
+                      << " and write): " << lPTElapsed << "s");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test the export of all the POR into a columnar file, and the reading
+ * back of some of its columns
+ */
+BOOST_AUTO_TEST_CASE (opentrep_columnar_export) {
+    
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_columnar.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  const OPENTREP::shouldIndexNonIATAPOR_T lShouldIndexNonIATAPOR (K_ALL_POR);
+  const OPENTREP::shouldIndexPORInXapian_T lShouldIndexPORInXapian(K_XAPIAN_IDX);
+  const OPENTREP::shouldAddPORInSQLDB_T lShouldAddPORInSQLDB (K_SQLDB_ADD);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lPORFilePath,
+                                              lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber,
+                                              lShouldIndexNonIATAPOR,
+                                              lShouldIndexPORInXapian,
+                                              lShouldAddPORInSQLDB);
+
+  // Parse the IATA-referenced records of the POR file
+  OPENTREP::LocationList_T lLocationList;
+  std::ifstream lPORFile (K_POR_FILEPATH.c_str());
+  std::string lPORLine;
+  while (std::getline (lPORFile, lPORLine)) {
+    if (lPORLine.find_first_of ("^") != 3) {
+      continue;
+    }
+    OPENTREP::PORStringParser lPORParser (lPORLine);
+    lLocationList.push_back (lPORParser.generateLocation());
+  }
+  BOOST_REQUIRE (lLocationList.empty() == false);
+
+  // Export the POR through the service
+  const OPENTREP::FilePath_T lServiceFilePath ("IndexBuildingTestSuite.otrepcol");
+  OPENTREP::NbOfDBEntries_T lNbOfExportedPOR = 0;
+  BOOST_CHECK_NO_THROW (lNbOfExportedPOR =
+                        opentrepService.exportToColumnarFile (lServiceFilePath,
+                                                              2));
+  BOOST_CHECK_EQUAL (lNbOfExportedPOR, lLocationList.size());
+
+  // Export the POR again, with tiny row groups and a tiny ring of slots,
+  // so as to go through several row groups
+  const std::string lFilePath ("IndexBuildingTestSuite_rowgroups.otrepcol");
+  {
+    std::ofstream lColumnarFile (lFilePath.c_str(),
+                                 std::ios::binary | std::ios::trunc);
+    OPENTREP::ColumnarPORWriter lWriter (lColumnarFile);
+    const OPENTREP::PORParserType lSIMDType (OPENTREP::PORParserType::SIMD);
+    OPENTREP::ColumnarExporter lExporter (lWriter, lShouldIndexNonIATAPOR,
+                                          lSIMDType, 2, 2, 2);
+    std::ifstream lPORFileStream (K_POR_FILEPATH.c_str());
+    lNbOfExportedPOR = lExporter.run (lPORFileStream);
+    lWriter.close();
+    BOOST_TEST_MESSAGE (lExporter.describeThroughputs());
+  }
+  BOOST_CHECK_EQUAL (lNbOfExportedPOR, lLocationList.size());
+
+  // Read back the columnar file
+  std::ifstream lColumnarFile (lFilePath.c_str(), std::ios::binary);
+  OPENTREP::ColumnarPORReader lReader (lColumnarFile);
+  BOOST_CHECK_EQUAL (lReader.getNbOfRows(), lLocationList.size());
+  BOOST_CHECK_EQUAL (lReader.getNbOfRowGroups(),
+                     (lLocationList.size() + 1) / 2);
+  BOOST_CHECK_EQUAL (lReader.getNbOfColumns(),
+                     OPENTREP::ColumnarPORColumn::LAST_VALUE);
+
+  const unsigned short lIataCodeIdx = lReader.getColumnIndex ("iata_code");
+  const unsigned short lGeonameIDIdx = lReader.getColumnIndex ("geoname_id");
+  const unsigned short lLatitudeIdx = lReader.getColumnIndex ("latitude");
+  OPENTREP::LocationList_T::const_iterator itLocation = lLocationList.begin();
+  for (OPENTREP::NbOfDBEntries_T idxGroup = 0;
+       idxGroup != lReader.getNbOfRowGroups(); ++idxGroup) {
+    std::vector<std::string> lIataCodeList;
+    std::vector<long long> lGeonameIDList;
+    std::vector<double> lLatitudeList;
+    lReader.readColumn (idxGroup, lIataCodeIdx, lIataCodeList);
+    lReader.readColumn (idxGroup, lGeonameIDIdx, lGeonameIDList);
+    lReader.readColumn (idxGroup, lLatitudeIdx, lLatitudeList);
+    BOOST_REQUIRE_EQUAL (lIataCodeList.size(),
+                         lReader.getNbOfRowsInGroup (idxGroup));
+    BOOST_REQUIRE_EQUAL (lGeonameIDList.size(), lIataCodeList.size());
+    BOOST_REQUIRE_EQUAL (lLatitudeList.size(), lIataCodeList.size());
+
+    for (std::size_t idxRow = 0; idxRow != lIataCodeList.size();
+         ++idxRow, ++itLocation) {
+      BOOST_REQUIRE (itLocation != lLocationList.end());
+      const OPENTREP::Location& lLocation = *itLocation;
+      BOOST_CHECK_EQUAL (lIataCodeList[idxRow],
+                         static_cast<const std::string&>
+                         (lLocation.getIataCode()));
+      BOOST_CHECK_EQUAL (lGeonameIDList[idxRow], lLocation.getGeonamesID());
+      BOOST_CHECK_CLOSE (lLatitudeList[idxRow], lLocation.getLatitude(),
+                         1e-9);
+    }
+  }
+  BOOST_CHECK (itLocation == lLocationList.end());
+
+  // The columns are typed, and known by their names
+  std::vector<double> lIataCodeAsFloatList;
+  BOOST_CHECK_THROW (lReader.readColumn (0, lIataCodeIdx,
+                                         lIataCodeAsFloatList),
+                     OPENTREP::SerDeException);
+  BOOST_CHECK_THROW (lReader.getColumnIndex ("unknown_column"),
+                     OPENTREP::ObjectNotFoundException);
+
+  // A truncated file is rejected
+  std::ifstream lTruncatedFile (lFilePath.c_str(), std::ios::binary);
+  std::string lContent ((std::istreambuf_iterator<char> (lTruncatedFile)),
+                        std::istreambuf_iterator<char>());
+  std::istringstream lTruncatedStream (lContent.substr (0,
+                                                        lContent.size() - 8));
+  BOOST_CHECK_THROW (OPENTREP::ColumnarPORReader lTruncatedReader
+                     (lTruncatedStream),
+                     OPENTREP::SerDeException);
+
+  // A corrupted chunk size, pointing far beyond the end of the file, is
+  // rejected before anything be allocated for that chunk. The first row
+  // group follows the header, made of the magic string, the version,
+  // the number of columns, and the types and names of the columns.
+  std::size_t lRowGroupOffset = OPENTREP::K_COLUMNAR_FILE_MAGIC.size() + 8;
+  for (unsigned short idx = 0; idx != lReader.getNbOfColumns(); ++idx) {
+    const unsigned char lNameSizeLow = lContent[lRowGroupOffset + 1];
+    const unsigned char lNameSizeHigh = lContent[lRowGroupOffset + 2];
+    lRowGroupOffset += 3 + lNameSizeLow + 256 * lNameSizeHigh;
+  }
+  std::string lCorruptedContent (lContent);
+  lCorruptedContent.replace (lRowGroupOffset + 4, 8, 8, '\x7f');
+  std::istringstream lCorruptedStream (lCorruptedContent);
+  OPENTREP::ColumnarPORReader lCorruptedReader (lCorruptedStream);
+  std::vector<std::string> lCorruptedList;
+  BOOST_CHECK_THROW (lCorruptedReader.readColumn (0, lIataCodeIdx,
+                                                  lCorruptedList),
+                     OPENTREP::SerDeException);
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test the export, in CSV and TSV, of a list of Location structures,
+ * with a selection of columns
+ */
+BOOST_AUTO_TEST_CASE (opentrep_dsv_export) {
+
+  // Parse the IATA-referenced records of the POR file
+  OPENTREP::LocationList_T lLocationList;
+  std::ifstream lPORFile (K_POR_FILEPATH.c_str());
+  std::string lPORLine;
+  while (std::getline (lPORFile, lPORLine)) {
+    if (lPORLine.find_first_of ("^") != 3) {
+      continue;
+    }
+    OPENTREP::PORStringParser lPORParser (lPORLine);
+    lLocationList.push_back (lPORParser.generateLocation());
+  }
+  BOOST_REQUIRE (lLocationList.empty() == false);
+
+  // The values holding the delimiter, a double quote or a line break
+  // must be quoted (CSV) or cleaned (TSV)
+  OPENTREP::Location& lFirstLocation = lLocationList.front();
+  lFirstLocation.setCorrectedKeywords ("a,b\t\"c\"");
+  lFirstLocation.setPercentage (87.5);
+
+  // Unknown columns are rejected
+  BOOST_CHECK_THROW (OPENTREP::DSVColumn::parseColumnList ("iata_code,foo"),
+                     OPENTREP::CodeConversionException);
+  BOOST_CHECK_EQUAL (OPENTREP::DSVColumn::parseColumnList ("").size(),
+                     OPENTREP::DSVColumn::LAST_VALUE);
+
+  // CSV export, with a header line
+  const OPENTREP::DSVColumnList_T& lColumnList =
+    OPENTREP::DSVColumn::parseColumnList ("iata_code, geonames_id,lat,"
+                                          "matching_percentage,"
+                                          "corrected_keywords");
+  BOOST_REQUIRE_EQUAL (lColumnList.size(), 5);
+  std::string lCSVBuffer;
+  const char lCSVDelimiter =
+    OPENTREP::BomDSVExport::getDelimiter (OPENTREP::OutputFormat::CSV);
+  OPENTREP::BomDSVExport::dsvExportLocationList (lCSVBuffer, lLocationList,
+                                                 lColumnList, lCSVDelimiter,
+                                                 true);
+
+  std::istringstream lCSVStream (lCSVBuffer);
+  std::string lCSVLine;
+  std::getline (lCSVStream, lCSVLine);
+  BOOST_CHECK_EQUAL (lCSVLine, "iata_code,geonames_id,lat,matching_percentage,"
+                     "corrected_keywords");
+  std::getline (lCSVStream, lCSVLine);
+  std::ostringstream lExpectedLine;
+  lExpectedLine << static_cast<const std::string&>(lFirstLocation.getIataCode())
+                << "," << lFirstLocation.getGeonamesID() << ","
+                << std::setprecision (16) << lFirstLocation.getLatitude()
+                << ",87.5,\"a,b\t\"\"c\"\"\"";
+  BOOST_CHECK_EQUAL (lCSVLine, lExpectedLine.str());
+  OPENTREP::NbOfMatches_T lNbOfCSVLines = 2;
+  while (std::getline (lCSVStream, lCSVLine)) {
+    ++lNbOfCSVLines;
+  }
+  BOOST_CHECK_EQUAL (lNbOfCSVLines, lLocationList.size() + 1);
+
+  // TSV export, without any header line
+  std::string lTSVBuffer;
+  const char lTSVDelimiter =
+    OPENTREP::BomDSVExport::getDelimiter (OPENTREP::OutputFormat::TSV);
+  OPENTREP::BomDSVExport::dsvExportLocationList (lTSVBuffer, lLocationList,
+                                                 lColumnList, lTSVDelimiter,
+                                                 false);
+  BOOST_CHECK_EQUAL (std::count (lTSVBuffer.begin(), lTSVBuffer.end(), '\n'),
+                     lLocationList.size());
+  BOOST_CHECK_EQUAL (std::count (lTSVBuffer.begin(), lTSVBuffer.end(), '\t'),
+                     4 * lLocationList.size());
+  const std::string lTSVFirstLine (lTSVBuffer, 0, lTSVBuffer.find ('\n'));
+  BOOST_CHECK (lTSVFirstLine.find ("\t87.5\ta,b \"c\"") != std::string::npos);
+}
+
+/**
+ * Test that, when the final insertion of the POR into the SQL database
+ * fails (here, because the optd_por table does not exist), the error is
+ * reported by the indexing pipeline, rather than crashing it
+ */
+BOOST_AUTO_TEST_CASE (opentrep_failed_bulk_load) {
+
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_failed_bulk_load.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+  OPENTREP::Logger::instance().setLogParameters (OPENTREP::LOG::DEBUG,
+                                                 logOutputFile);
+
+  // SQLite database without any table. As the test POR file is smaller
+  // than a batch, all the POR are inserted when the load is finished
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::SQLITE3);
+  const OPENTREP::SQLDBConnectionString_T
+    lSQLDBConnStr ("/tmp/opentrep_test_failed_bulk_load.db");
+  std::remove (lSQLDBConnStr.c_str());
+  soci::session* lSociSession_ptr =
+    OPENTREP::DBManager::initSQLDBSession (lDBType, lSQLDBConnStr);
+  BOOST_REQUIRE (lSociSession_ptr != NULL);
+
+  // Index the POR into the SQL database only
+  std::ifstream lPORFileStream (K_POR_FILEPATH.c_str());
+  BOOST_REQUIRE (lPORFileStream.is_open() == true);
+  const OPENTREP::OTransliterator lTransliterator;
+  const OPENTREP::PORParserType lPORParserType (OPENTREP::PORParserType::SIMD);
+  {
+    OPENTREP::IndexingPipeline lIndexingPipeline (NULL, lSociSession_ptr,
+                                                  K_ALL_POR, lTransliterator,
+                                                  lPORParserType, 2, 4);
+    BOOST_CHECK_THROW (lIndexingPipeline.run (lPORFileStream),
+                       OPENTREP::SQLDatabaseException);
+  }
+
+  OPENTREP::DBManager::terminateSQLDBSession (lDBType, lSQLDBConnStr,
+                                              *lSociSession_ptr);
+  delete lSociSession_ptr; lSociSession_ptr = NULL;
+  std::remove (lSQLDBConnStr.c_str());
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test that the POR of a SQL database created by a former version of
+ * OpenTREP (version 1 of the schema, i.e., without the optd_por_schema
+ * table, and with the raw data strings of the POR within the
+ * serialised_place column) are still retrieved
+ */
+BOOST_AUTO_TEST_CASE (opentrep_sql_schema_v1) {
+
+  // Output log File
+  std::string lLogFilename ("IndexBuildingTestSuite_sql_schema_v1.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+  OPENTREP::Logger::instance().setLogParameters (OPENTREP::LOG::DEBUG,
+                                                 logOutputFile);
+
+  // SQLite database, with the optd_por table of the version 1 of the schema
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::SQLITE3);
+  const OPENTREP::SQLDBConnectionString_T
+    lSQLDBConnStr ("/tmp/opentrep_test_sql_schema_v1.db");
+  std::remove (lSQLDBConnStr.c_str());
+  soci::session* lSociSession_ptr =
+    OPENTREP::DBManager::initSQLDBSession (lDBType, lSQLDBConnStr);
+  BOOST_REQUIRE (lSociSession_ptr != NULL);
+  soci::session& lSociSession = *lSociSession_ptr;
+  lSociSession << "create table optd_por (pk varchar(20) NOT NULL, "
+               << "location_type varchar(4) default NULL, "
+               << "iata_code varchar(3) default NULL, "
+               << "icao_code varchar(4) default NULL, "
+               << "faa_code varchar(4) default NULL, "
+               << "unlocode_code varchar(5) default NULL, "
+               << "uic_code int(11) default NULL, "
+               << "is_geonames varchar(1) default NULL, "
+               << "geoname_id int(11) default NULL, "
+               << "envelope_id int(11) default NULL, "
+               << "date_from date default NULL, "
+               << "date_until date default NULL, "
+               << "serialised_place varchar(12000) default NULL);";
+
+  // Insert the raw data strings of the POR of Nice (the airport and
+  // the city), as the former versions of OpenTREP did
+  std::ifstream lPORFileStream (K_POR_FILEPATH.c_str());
+  BOOST_REQUIRE (lPORFileStream.is_open() == true);
+  std::string lReadLine;
+  OPENTREP::NbOfDBEntries_T lNbOfInsertedPOR = 0;
+  while (std::getline (lPORFileStream, lReadLine)) {
+    if (lReadLine.compare (0, 4, "NCE^") != 0) {
+      continue;
+    }
+    // The Geonames ID is the fifth field
+    std::istringstream lLineStream (lReadLine);
+    std::string lField;
+    for (unsigned short idx = 0; idx != 5; ++idx) {
+      std::getline (lLineStream, lField, '^');
+    }
+    const int lGeonameID = std::atoi (lField.c_str());
+    const std::string lPK ("NCE-" + lField);
+    const std::string lIataCode ("NCE");
+    lSociSession << "insert into optd_por (pk, iata_code, geoname_id, "
+                 << "serialised_place) values (:pk, :iata_code, "
+                 << ":geoname_id, :serialised_place)",
+      soci::use (lPK), soci::use (lIataCode), soci::use (lGeonameID),
+      soci::use (lReadLine);
+    ++lNbOfInsertedPOR;
+  }
+  BOOST_REQUIRE_EQUAL (lNbOfInsertedPOR, 2);
+
+  {
+    OPENTREP::SelectStatementCache lSelectStatementCache (lSociSession);
+    BOOST_CHECK_EQUAL (OPENTREP::DBManager::getSQLDBSchemaVersion
+                       (lSociSession), 1);
+
+    // Retrieve the POR by IATA code
+    OPENTREP::LocationList_T lLocationList;
+    const OPENTREP::NbOfDBEntries_T lNbOfRetrievedPOR =
+      OPENTREP::DBManager::getPORByIATACode (lSelectStatementCache,
+                                             OPENTREP::IATACode_T ("NCE"),
+                                             lLocationList, false);
+    BOOST_CHECK_EQUAL (lNbOfRetrievedPOR, 2);
+    BOOST_REQUIRE_EQUAL (lLocationList.size(), 2);
+    std::set<OPENTREP::GeonamesID_T> lGeonameIDSet;
+    for (OPENTREP::LocationList_T::const_iterator itLocation =
+           lLocationList.begin(); itLocation != lLocationList.end();
+         ++itLocation) {
+      const OPENTREP::Location& lLocation = *itLocation;
+      BOOST_CHECK_EQUAL (lLocation.getIataCode(), "NCE");
+      lGeonameIDSet.insert (lLocation.getGeonamesID());
+    }
+    BOOST_CHECK (lGeonameIDSet.count (6299418) == 1
+                 && lGeonameIDSet.count (2990440) == 1);
+
+    // Retrieve the city by Geonames ID, through the multi-code query
+    OPENTREP::DBManager::TypedCodeList_T lCodeList;
+    lCodeList.push_back (OPENTREP::DBManager::
+                         TypedCode_T (OPENTREP::SelectStatementCache::
+                                      GEONAME_ID, "2990440"));
+    OPENTREP::LocationList_T lCityList;
+    OPENTREP::DBManager::getPORByCodeList (lSelectStatementCache, lCodeList,
+                                           lCityList);
+    BOOST_REQUIRE_EQUAL (lCityList.size(), 1);
+    BOOST_CHECK_EQUAL (lCityList.front().getCommonName(), "Nice");
+  }
+
+  OPENTREP::DBManager::terminateSQLDBSession (lDBType, lSQLDBConnStr,
+                                              lSociSession);
+  delete lSociSession_ptr; lSociSession_ptr = NULL;
+  std::remove (lSQLDBConnStr.c_str());
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
 // End the test suite
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -11,13 +11,17 @@
 #include <fstream>
 #include <string>
 #include <list>
+#include <set>
 // Boost Unit Test Framework (UTF)
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_MODULE PartitionTestSuite
 #include <boost/test/unit_test.hpp>
 // OpenTrep
+#include <opentrep/basic/BasChronometer.hpp>
+#include <opentrep/basic/Utilities.hpp>
 #include <opentrep/bom/StringPartition.hpp>
+#include <opentrep/bom/WordCombinationHolder.hpp>
 
 namespace boost_utf = boost::unit_test;
 
@@ -51,6 +55,48 @@ struct UnitTestConfig {
 // Set the UTF configuration (re-direct the output to a specific file)
 BOOST_GLOBAL_FIXTURE (UnitTestConfig);
 
+/**
+ * Derive the word combinations of the given string, as WordCombinationHolder
+ * historically did: from all the partitions of the string (see
+ * StringPartition), and then by removing the groups of words in the middle
+ * of the string.
+ */
+OPENTREP::WordCombinationHolder::StringList_T
+deriveWordCombinationsFromPartitions (const std::string& iPhrase) {
+  OPENTREP::WordCombinationHolder::StringList_T oList;
+
+  // Unique word combinations of the partitions, in alphabetical order
+  std::set<std::string> lStringSet;
+  const OPENTREP::StringPartition lStringPartitionHolder (iPhrase);
+  const OPENTREP::StringPartition::StringPartition_T& lStringPartition =
+    lStringPartitionHolder._partition;
+  for (OPENTREP::StringPartition::StringPartition_T::const_iterator itSet =
+         lStringPartition.begin(); itSet != lStringPartition.end(); ++itSet) {
+    const OPENTREP::StringSet::StringSet_T& lStringList = itSet->_set;
+    lStringSet.insert (lStringList.begin(), lStringList.end());
+  }
+  oList.insert (oList.end(), lStringSet.begin(), lStringSet.end());
+
+  // Word combinations with some words removed in the middle
+  OPENTREP::WordList_T lWordList;
+  OPENTREP::tokeniseStringIntoWordList (iPhrase, lWordList);
+  const short nbOfWords = lWordList.size();
+  for (short mdl_string_len = 1; mdl_string_len < nbOfWords-1;
+       ++mdl_string_len) {
+    for (short idx_word=1; idx_word != nbOfWords-mdl_string_len; ++idx_word) {
+      std::ostringstream lConcatenatedStr;
+      lConcatenatedStr
+        << OPENTREP::createStringFromWordList (lWordList, idx_word) << " "
+        << OPENTREP::createStringFromWordList (lWordList,
+                                               idx_word + mdl_string_len,
+                                               false);
+      oList.push_back (lConcatenatedStr.str());
+    }
+  }
+
+  return oList;
+}
+
 // Start the test suite
 BOOST_AUTO_TEST_SUITE (master_test_suite)
 
@@ -97,6 +143,81 @@ BOOST_AUTO_TEST_CASE (partition_small_string) {
   logOutputFile.close();
 }
 
+/**
+ * Test that the word combinations, indexed for every name of the POR,
+ * are the same as the ones derived from the partitions of the names
+ */
+BOOST_AUTO_TEST_CASE (word_combination_string) {
+
+  // Output log File
+  std::string lLogFilename ("PartitionTestSuite_combination.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Names of POR, from a single word to more words than the partitions
+  // may handle (see K_DEFAULT_MAXIMUM_NUMBER_OF_WORDS_IN_STRING)
+  const std::string lNameArray[] = {
+    "", "--", "reikjavik", "los angeles", "rio de janeiro",
+    "san francisco international airport", "new york new york",
+    "  Aéroport de Paris-Charles-de-Gaulle ",
+    "Aeropuerto Internacional de la Ciudad de Mexico Licenciado Benito Juarez",
+    "Krung Thep Maha Nakhon Amon Rattanakosin Mahinthara Ayuthaya Mahadilok"
+    " Phop Noppharat Ratchathani Burirom Udomratchaniwet Mahasathan"
+    " Amon Piman Awatan Sathit Sakkathattiya Witsanukam Prasit" };
+  const unsigned short lNbOfNames = sizeof (lNameArray) / sizeof (std::string);
+
+  for (unsigned short idx = 0; idx != lNbOfNames; ++idx) {
+    const std::string& lName = lNameArray[idx];
+    const OPENTREP::WordCombinationHolder lWordCombinationHolder (lName);
+    logOutputFile << "'" << lName << "': " << lWordCombinationHolder
+                  << std::endl;
+
+    const OPENTREP::WordCombinationHolder::StringList_T& lExpectedList =
+      deriveWordCombinationsFromPartitions (lName);
+    BOOST_CHECK_MESSAGE (lWordCombinationHolder._list == lExpectedList,
+                         "The word combinations of '" << lName << "' ("
+                         << lWordCombinationHolder.size() << " of them) are "
+                         << "not the ones derived from the partitions ("
+                         << lExpectedList.size() << " of them)");
+  }
+
+  // Measure the time spent on the long names, with both derivations
+  const unsigned short lNbOfLongNames = 2;
+  const unsigned short lNbOfRuns = 5;
+  OPENTREP::BasChronometer lChronometer;
+
+  lChronometer.start();
+  for (unsigned short idx_run = 0; idx_run != lNbOfRuns; ++idx_run) {
+    for (unsigned short idx = lNbOfNames - lNbOfLongNames; idx != lNbOfNames;
+         ++idx) {
+      deriveWordCombinationsFromPartitions (lNameArray[idx]);
+    }
+  }
+  const double lPartitionMeasure = lChronometer.elapsed();
+
+  lChronometer.start();
+  for (unsigned short idx_run = 0; idx_run != lNbOfRuns; ++idx_run) {
+    for (unsigned short idx = lNbOfNames - lNbOfLongNames; idx != lNbOfNames;
+         ++idx) {
+      const OPENTREP::WordCombinationHolder lWordCombinationHolder
+        (lNameArray[idx]);
+    }
+  }
+  const double lCombinationMeasure = lChronometer.elapsed();
+
+  BOOST_TEST_MESSAGE ("Word combinations of the " << lNbOfLongNames
+                      << " long names, " << lNbOfRuns << " times: "
+                      << lPartitionMeasure << "s from the partitions, "
+                      << lCombinationMeasure << "s directly");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
 // End the test suite
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -9,6 +9,11 @@
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <cmath>
+// Boost
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
 // Boost Unit Test Framework (UTF)
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
@@ -17,8 +22,12 @@
 // OpenTrep
 #include <opentrep/OPENTREP_Service.hpp>
 #include <opentrep/basic/BasConst_OPENTREP_Service.hpp>
+#include <opentrep/basic/BasChronometer.hpp>
+#include <opentrep/basic/GeoDistance.hpp>
+#include <opentrep/basic/Utilities.hpp>
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
+#include <opentrep/config/opentrep-paths.hpp>
 
 namespace boost_utf = boost::unit_test;
 
@@ -63,6 +72,12 @@ const std::string X_SQL_DB_STR ("");
  */
 const OPENTREP::DeploymentNumber_T X_DEPLOYMENT_NUMBER (0);
 
+/**
+ * File-path of the POR (points of reference) file.
+ */
+const std::string K_POR_FILEPATH (OPENTREP_POR_DATA_DIR
+                                  "/test_optd_por_public.csv");
+
 // /////////////// Main: Unit Test Suite //////////////
 
 // Set the UTF configuration (re-direct the output to a specific file)
@@ -112,6 +127,784 @@ BOOST_AUTO_TEST_CASE (opentrep_simple_search) {
   logOutputFile.close();
 }
 
+/**
+ * Test a search biased by an origin hint, given by the caller
+ */
+BOOST_AUTO_TEST_CASE (opentrep_origin_hint_search) {
+    
+  // Output log File
+  std::string lLogFilename ("SearchingTestSuite_origin.log");
+    
+  // Travel query
+  std::string lTravelQuery ("nce");
+    
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber);
+  
+  // Origin close to Nice, France
+  const OPENTREP::OriginHint lNiceOriginHint (43.70, 7.25,
+                                              OPENTREP::CountryCode_T ("fr"));
+  OPENTREP::WordList_T lNiceNonMatchedWordList;
+  OPENTREP::LocationList_T lNiceLocationList;
+  const OPENTREP::NbOfMatches_T nbOfNiceMatches =
+    opentrepService.interpretTravelRequest (lTravelQuery, lNiceLocationList,
+                                            lNiceNonMatchedWordList,
+                                            lNiceOriginHint);
+  BOOST_CHECK_MESSAGE (nbOfNiceMatches == 1,
+                       "The travel query ('" << lTravelQuery
+                       << "'), from " << lNiceOriginHint.describe()
+                       << ", matches with " << nbOfNiceMatches
+                       << " key-words, whereas 1 is expected.");
+
+  // Origin in San Francisco, USA. The POR far away from the origin are
+  // weighed down, but never disqualified.
+  const OPENTREP::OriginHint lSFOriginHint (37.77, -122.42,
+                                            OPENTREP::CountryCode_T ("US"));
+  OPENTREP::WordList_T lSFNonMatchedWordList;
+  OPENTREP::LocationList_T lSFLocationList;
+  const OPENTREP::NbOfMatches_T nbOfSFMatches =
+    opentrepService.interpretTravelRequest (lTravelQuery, lSFLocationList,
+                                            lSFNonMatchedWordList,
+                                            lSFOriginHint);
+  BOOST_CHECK_MESSAGE (nbOfSFMatches == 1,
+                       "The travel query ('" << lTravelQuery
+                       << "'), from " << lSFOriginHint.describe()
+                       << ", matches with " << nbOfSFMatches
+                       << " key-words, whereas 1 is expected.");
+
+  // The Nice POR are weighed down when searched from San Francisco
+  BOOST_REQUIRE (lNiceLocationList.size() == 1 && lSFLocationList.size() == 1);
+  const OPENTREP::Location& lNiceLocation = lNiceLocationList.front();
+  const OPENTREP::Location& lSFLocation = lSFLocationList.front();
+  BOOST_CHECK_MESSAGE (lNiceLocation.getIataCode() == "NCE"
+                       && lSFLocation.getIataCode() == "NCE",
+                       "The travel query ('" << lTravelQuery
+                       << "') gives " << lNiceLocation.getIataCode()
+                       << " from " << lNiceOriginHint.describe() << ", and "
+                       << lSFLocation.getIataCode() << " from "
+                       << lSFOriginHint.describe() << ", whereas NCE is "
+                       << "expected in both cases.");
+  BOOST_CHECK_MESSAGE (lSFLocation.getPercentage()
+                       < lNiceLocation.getPercentage(),
+                       "The travel query ('" << lTravelQuery
+                       << "') matches at " << lSFLocation.getPercentage()
+                       << "% from " << lSFOriginHint.describe() << ", and at "
+                       << lNiceLocation.getPercentage() << "% from "
+                       << lNiceOriginHint.describe() << ", whereas the "
+                       << "former is expected to be lower.");
+
+  // 'Flygplats' (airport, in Swedish) is an alternate name of both
+  // the Keflavik and the Nice airports: the origin decides
+  const std::string lAmbiguousQuery ("flygplats");
+  const OPENTREP::OriginHint lReykjavikOriginHint (64.13, -21.90,
+                                                   OPENTREP::CountryCode_T
+                                                   ("IS"));
+  OPENTREP::WordList_T lFromNiceNonMatchedWordList;
+  OPENTREP::LocationList_T lFromNiceLocationList;
+  opentrepService.interpretTravelRequest (lAmbiguousQuery,
+                                          lFromNiceLocationList,
+                                          lFromNiceNonMatchedWordList,
+                                          lNiceOriginHint);
+  OPENTREP::WordList_T lFromReykjavikNonMatchedWordList;
+  OPENTREP::LocationList_T lFromReykjavikLocationList;
+  opentrepService.interpretTravelRequest (lAmbiguousQuery,
+                                          lFromReykjavikLocationList,
+                                          lFromReykjavikNonMatchedWordList,
+                                          lReykjavikOriginHint);
+  BOOST_REQUIRE (lFromNiceLocationList.size() == 1
+                 && lFromReykjavikLocationList.size() == 1);
+  const OPENTREP::Location& lFromNiceLocation = lFromNiceLocationList.front();
+  const OPENTREP::Location& lFromReykjavikLocation =
+    lFromReykjavikLocationList.front();
+  BOOST_CHECK_MESSAGE (lFromNiceLocation.getIataCode() == "NCE",
+                       "The travel query ('" << lAmbiguousQuery
+                       << "'), from " << lNiceOriginHint.describe()
+                       << ", gives " << lFromNiceLocation.getIataCode()
+                       << ", whereas NCE is expected.");
+  BOOST_CHECK_MESSAGE (lFromReykjavikLocation.getIataCode() == "KEF",
+                       "The travel query ('" << lAmbiguousQuery
+                       << "'), from " << lReykjavikOriginHint.describe()
+                       << ", gives " << lFromReykjavikLocation.getIataCode()
+                       << ", whereas KEF is expected.");
+  
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test a geographical (nearby) search on the Xapian index just created above,
+ * and measure the throughput (number of queries per second) of the
+ * underlying spatial index
+ */
+BOOST_AUTO_TEST_CASE (opentrep_nearby_search) {
+    
+  // Output log File
+  std::string lLogFilename ("SearchingTestSuite_nearby.log");
+
+  // Geographical point, close to Nice, France
+  const OPENTREP::Latitude_T lLatitude (43.70);
+  const OPENTREP::Longitude_T lLongitude (7.25);
+  const OPENTREP::Distance_T lRadius (50.0);
+  const OPENTREP::NbOfMatches_T lK (10);
+    
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber);
+  
+  // Only the airport of Nice (NCE) is expected
+  OPENTREP::LocationList_T lAirportList;
+  const OPENTREP::NbOfMatches_T nbOfAirports =
+    opentrepService.findNearby (lLatitude, lLongitude, lRadius, lK, "AIRP",
+                                lAirportList);
+  BOOST_CHECK_MESSAGE (nbOfAirports == 1,
+                       "The nearby search for airports gives " << nbOfAirports
+                       << " POR, whereas 1 is expected.");
+
+  // Both the airport and the city of Nice (NCE) are expected
+  OPENTREP::LocationList_T lPORList;
+  const OPENTREP::NbOfMatches_T nbOfPOR =
+    opentrepService.findNearby (lLatitude, lLongitude, lRadius, lK, "",
+                                lPORList);
+  BOOST_CHECK_MESSAGE (nbOfPOR == 2,
+                       "The nearby search for any POR gives " << nbOfPOR
+                       << " POR, whereas 2 are expected.");
+
+  // Throughput of the nearest-POR queries, first on the Xapian index kept
+  // open for the nearby searches, then on the hot-swapped deployment
+  const unsigned int lNbOfQueries = 10000;
+  for (unsigned short idxPath = 0; idxPath != 2; ++idxPath) {
+    if (idxPath == 1) {
+      const OPENTREP::PollingPeriod_T lNoPolling = 0;
+      opentrepService.startIndexHotSwap (lNoPolling);
+    }
+
+    OPENTREP::BasChronometer lNearbyChronometer; lNearbyChronometer.start();
+    for (unsigned int idx = 0; idx != lNbOfQueries; ++idx) {
+      const OPENTREP::Latitude_T lQueryLatitude (-80.0 + (idx % 160));
+      const OPENTREP::Longitude_T lQueryLongitude (-180.0 + (idx % 360));
+      OPENTREP::LocationList_T lNearestList;
+      const OPENTREP::NbOfMatches_T nbOfNearest =
+        opentrepService.findNearby (lQueryLatitude, lQueryLongitude, 0.0, 1,
+                                    "", lNearestList);
+      BOOST_REQUIRE_EQUAL (nbOfNearest, 1);
+    }
+    const double lNearbyMeasure = lNearbyChronometer.elapsed();
+    const double lNbOfQPS =
+      (lNearbyMeasure > 0.0 ? lNbOfQueries / lNearbyMeasure : 0.0);
+    const std::string lPathDescription (idxPath == 0 ? "without hot-swap"
+                                        : "with hot-swap");
+    logOutputFile << "Nearby search (" << lPathDescription << "): "
+                  << lNbOfQueries << " queries in " << lNearbyMeasure
+                  << "s, i.e., " << lNbOfQPS << " queries per second"
+                  << std::endl;
+    BOOST_TEST_MESSAGE ("Nearby search (" << lPathDescription << "): "
+                        << lNbOfQPS << " queries per second");
+  }
+  opentrepService.stopIndexHotSwap();
+  
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Search for the airports close to Nice, France. That function is run
+ * by several threads at once, sharing the same OpenTREP service.
+ */
+void findAirportsNearNice (OPENTREP::OPENTREP_Service& ioOpentrepService,
+                           OPENTREP::NbOfMatches_T& ioNbOfAirports) {
+  const OPENTREP::Latitude_T lLatitude (43.70);
+  const OPENTREP::Longitude_T lLongitude (7.25);
+  OPENTREP::LocationList_T lAirportList;
+  ioNbOfAirports = ioOpentrepService.findNearby (lLatitude, lLongitude, 50.0,
+                                                 10, "AIRP", lAirportList);
+}
+
+/**
+ * Test nearby searches by several threads at once, the first ones of
+ * which trigger the build of the spatial index
+ */
+BOOST_AUTO_TEST_CASE (opentrep_nearby_search_threads) {
+
+  // Output log File
+  std::string lLogFilename ("SearchingTestSuite_nearby_threads.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context, the spatial index of which is not built yet
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber);
+
+  // Only the airport of Nice (NCE) is expected, by every thread
+  const unsigned short lNbOfThreads = 8;
+  std::vector<OPENTREP::NbOfMatches_T> lNbOfAirportsList (lNbOfThreads, 0);
+  boost::thread_group lThreadGroup;
+  for (unsigned short idx = 0; idx != lNbOfThreads; ++idx) {
+    OPENTREP::NbOfMatches_T& lNbOfAirports = lNbOfAirportsList[idx];
+    lThreadGroup.create_thread (boost::bind (findAirportsNearNice,
+                                             boost::ref (opentrepService),
+                                             boost::ref (lNbOfAirports)));
+  }
+  lThreadGroup.join_all();
+
+  for (unsigned short idx = 0; idx != lNbOfThreads; ++idx) {
+    const OPENTREP::NbOfMatches_T& lNbOfAirports = lNbOfAirportsList[idx];
+    BOOST_CHECK_MESSAGE (lNbOfAirports == 1,
+                         "The nearby search of the thread #" << idx
+                         << " gives " << lNbOfAirports
+                         << " airports, whereas 1 is expected.");
+  }
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Search for the given travel queries, and describe the matching POR
+ * by their IATA codes.
+ */
+std::string describeSearches (OPENTREP::OPENTREP_Service& ioOpentrepService,
+                              const std::vector<std::string>& iQueryList) {
+  std::ostringstream oStr;
+  for (std::vector<std::string>::const_iterator itQuery = iQueryList.begin();
+       itQuery != iQueryList.end(); ++itQuery) {
+    OPENTREP::WordList_T lNonMatchedWordList;
+    OPENTREP::LocationList_T lLocationList;
+    ioOpentrepService.interpretTravelRequest (*itQuery, lLocationList,
+                                              lNonMatchedWordList);
+    oStr << *itQuery << ":";
+    for (OPENTREP::LocationList_T::const_iterator itLocation =
+           lLocationList.begin(); itLocation != lLocationList.end();
+         ++itLocation) {
+      oStr << " " << itLocation->getIataCode();
+    }
+    oStr << "; ";
+  }
+  return oStr.str();
+}
+
+/**
+ * Search, several times in a row, for the given travel queries. That
+ * function is run by several threads at once, sharing the same OpenTREP
+ * service.
+ */
+void searchManyTimes (OPENTREP::OPENTREP_Service& ioOpentrepService,
+                      const std::vector<std::string>& iQueryList,
+                      const unsigned short iNbOfRuns,
+                      std::vector<std::string>& ioDescriptionList) {
+  for (unsigned short idxRun = 0; idxRun != iNbOfRuns; ++idxRun) {
+    ioDescriptionList.push_back (describeSearches (ioOpentrepService,
+                                                   iQueryList));
+  }
+}
+
+/**
+ * Test travel searches by several threads at once, sharing the same
+ * OpenTREP service: every thread must get the same results as a single
+ * thread would
+ */
+BOOST_AUTO_TEST_CASE (opentrep_search_threads) {
+
+  // Output log File
+  std::string lLogFilename ("SearchingTestSuite_search_threads.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber);
+
+  // Reference results, given by a single thread
+  std::vector<std::string> lQueryList;
+  lQueryList.push_back ("nce");
+  lQueryList.push_back ("sfo");
+  lQueryList.push_back ("rio de janero");
+  lQueryList.push_back ("sna francicso lso angles reykyavki");
+  const std::string& lReference = describeSearches (opentrepService,
+                                                    lQueryList);
+
+  // The same searches, by several threads at once
+  const unsigned short lNbOfThreads = 8;
+  const unsigned short lNbOfRuns = 20;
+  std::vector<std::vector<std::string> > lDescriptionListList (lNbOfThreads);
+  boost::thread_group lThreadGroup;
+  for (unsigned short idx = 0; idx != lNbOfThreads; ++idx) {
+    std::vector<std::string>& lDescriptionList = lDescriptionListList[idx];
+    lThreadGroup.create_thread (boost::bind (searchManyTimes,
+                                             boost::ref (opentrepService),
+                                             boost::cref (lQueryList),
+                                             lNbOfRuns,
+                                             boost::ref (lDescriptionList)));
+  }
+  lThreadGroup.join_all();
+
+  for (unsigned short idx = 0; idx != lNbOfThreads; ++idx) {
+    const std::vector<std::string>& lDescriptionList =
+      lDescriptionListList[idx];
+    BOOST_REQUIRE_EQUAL (lDescriptionList.size(), lNbOfRuns);
+    for (unsigned short idxRun = 0; idxRun != lNbOfRuns; ++idxRun) {
+      BOOST_CHECK_MESSAGE (lDescriptionList[idxRun] == lReference,
+                           "The searches of the thread #" << idx
+                           << " give '" << lDescriptionList[idxRun]
+                           << "', whereas '" << lReference
+                           << "' is expected.");
+    }
+  }
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test the batch calculation of great circle distance matrices
+ */
+BOOST_AUTO_TEST_CASE (opentrep_distance_matrix) {
+    
+  // Output log File
+  std::string lLogFilename ("SearchingTestSuite_distance.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Spread pseudo-random points all over the Earth
+  const unsigned int lNbOfPoints = 1000;
+  std::vector<OPENTREP::Latitude_T> lLatitudeList;
+  std::vector<OPENTREP::Longitude_T> lLongitudeList;
+  OPENTREP::GeoCoordBuffer lCoordBuffer;
+  lCoordBuffer.reserve (lNbOfPoints);
+  for (unsigned int idx = 0; idx != lNbOfPoints; ++idx) {
+    const OPENTREP::Latitude_T lLatitude (-90.0 + (idx * 7919 % 18001) / 100.0);
+    const OPENTREP::Longitude_T lLongitude (-180.0 + (idx * 104729 % 36001)
+                                            / 100.0);
+    lLatitudeList.push_back (lLatitude);
+    lLongitudeList.push_back (lLongitude);
+    lCoordBuffer.addPoint (lLatitude, lLongitude);
+  }
+
+  // Batch calculation
+  OPENTREP::DistanceMatrix_T lDistanceMatrix;
+  OPENTREP::BasChronometer lBatchChronometer; lBatchChronometer.start();
+  OPENTREP::calculateGreatCircleDistanceMatrix (lCoordBuffer, lCoordBuffer,
+                                                lDistanceMatrix);
+  const double lBatchMeasure = lBatchChronometer.elapsed();
+
+  // Scalar calculation, and comparison with the batch results
+  OPENTREP::Distance_T lMaxError (0.0);
+  OPENTREP::BasChronometer lScalarChronometer; lScalarChronometer.start();
+  for (unsigned int idx = 0; idx != lNbOfPoints; ++idx) {
+    for (unsigned int jdx = 0; jdx != lNbOfPoints; ++jdx) {
+      const OPENTREP::Distance_T lDistance =
+        OPENTREP::calculateGreatCircleDistance (lLatitudeList[idx],
+                                                lLongitudeList[idx],
+                                                lLatitudeList[jdx],
+                                                lLongitudeList[jdx]);
+      const OPENTREP::Distance_T lError =
+        std::fabs (lDistance - lDistanceMatrix[idx][jdx]);
+      if (lError > lMaxError) {
+        lMaxError = lError;
+      }
+    }
+  }
+  const double lScalarMeasure = lScalarChronometer.elapsed();
+
+  BOOST_CHECK_MESSAGE (lMaxError < 0.01,
+                       "The batch distances differ from the scalar ones by "
+                       << lMaxError << " km.");
+
+  logOutputFile << "Distance matrix (" << lNbOfPoints << "x" << lNbOfPoints
+                << "): batch in " << lBatchMeasure << "s, scalar (including "
+                << "the comparison) in " << lScalarMeasure << "s; maximum "
+                << "error: " << lMaxError << " km" << std::endl;
+
+  // Initialise the context
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber);
+
+  // Distances between codes: Nice (NCE) is around 9,650 km away from
+  // San Francisco (SFO). The codes are resolved exactly from the Xapian
+  // index (as there is no SQL database), and ZZZ corresponds to no POR
+  OPENTREP::WordList_T lRowCodeList;
+  lRowCodeList.push_back ("nce");
+  lRowCodeList.push_back ("sfo");
+  lRowCodeList.push_back ("zzz");
+  OPENTREP::WordList_T lColCodeList;
+  lColCodeList.push_back ("sfo");
+  OPENTREP::DistanceMatrix_T lCodeDistanceMatrix;
+  const OPENTREP::NbOfMatches_T nbOfResolvedCodes =
+    opentrepService.calculateDistanceMatrix (lRowCodeList, lColCodeList,
+                                             lCodeDistanceMatrix);
+  BOOST_CHECK_MESSAGE (nbOfResolvedCodes == 2,
+                       "The distance matrix resolves " << nbOfResolvedCodes
+                       << " distinct codes, whereas 2 are expected.");
+  BOOST_REQUIRE (lCodeDistanceMatrix.size() == 3);
+  BOOST_CHECK_MESSAGE (lCodeDistanceMatrix[0][0] > 9600.0
+                       && lCodeDistanceMatrix[0][0] < 9700.0,
+                       "The NCE-SFO distance is " << lCodeDistanceMatrix[0][0]
+                       << " km, whereas around 9,650 km are expected.");
+  BOOST_CHECK_MESSAGE (lCodeDistanceMatrix[1][0] < 50.0,
+                       "The SFO-SFO distance is " << lCodeDistanceMatrix[1][0]
+                       << " km, whereas around 0 km are expected.");
+  BOOST_CHECK_MESSAGE (std::isnan (lCodeDistanceMatrix[2][0]) == true,
+                       "The ZZZ-SFO distance is " << lCodeDistanceMatrix[2][0]
+                       << " km, whereas NaN is expected.");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test the hot-swap of the Xapian index, once the other deployment
+ * has been indexed
+ */
+BOOST_AUTO_TEST_CASE (opentrep_index_hot_swap) {
+    
+  // Output log File
+  std::string lLogFilename ("SearchingTestSuite_hotswap.log");
+
+  // Travel query
+  std::string lTravelQuery ("nce");
+    
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Initialise the context, for the searches on the current deployment
+  const OPENTREP::TravelDBFilePath_T lTravelDBFilePath (X_XAPIAN_DB_FP);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::NODB);
+  const OPENTREP::SQLDBConnectionString_T lSQLDBConnStr (X_SQL_DB_STR);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber);
+
+  // Keep the current deployment open, without any background thread
+  const OPENTREP::PollingPeriod_T lNoPolling = 0;
+  opentrepService.startIndexHotSwap (lNoPolling);
+
+  OPENTREP::WordList_T lNonMatchedWordList;
+  OPENTREP::LocationList_T lLocationList;
+  OPENTREP::NbOfMatches_T nbOfMatches =
+    opentrepService.interpretTravelRequest (lTravelQuery, lLocationList,
+                                            lNonMatchedWordList);
+  BOOST_CHECK_MESSAGE (nbOfMatches == 1
+                       && opentrepService.getActiveDeploymentNumber() == 0,
+                       "The travel query ('" << lTravelQuery
+                       << "') matches with " << nbOfMatches
+                       << " key-words on the deployment #"
+                       << opentrepService.getActiveDeploymentNumber()
+                       << ", whereas 1 is expected on the deployment #0.");
+
+  // Index the other deployment, which marks it as ready
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::DeploymentNumber_T lOtherDeploymentNumber (1);
+  OPENTREP::OPENTREP_Service opentrepIndexingService (logOutputFile,
+                                                      lPORFilePath,
+                                                      lTravelDBFilePath,
+                                                      lDBType, lSQLDBConnStr,
+                                                      lOtherDeploymentNumber,
+                                                      false, true, false);
+  opentrepIndexingService.insertIntoDBAndXapian();
+
+  // Hot-swap to the other deployment
+  const bool hasSwapped = opentrepService.checkIndexHotSwap();
+  BOOST_CHECK_MESSAGE (hasSwapped == true
+                       && opentrepService.getActiveDeploymentNumber() == 1,
+                       "The searches use the deployment #"
+                       << opentrepService.getActiveDeploymentNumber()
+                       << ", whereas the deployment #1 is expected.");
+
+  // The searches go on
+  lNonMatchedWordList.clear();
+  lLocationList.clear();
+  nbOfMatches =
+    opentrepService.interpretTravelRequest (lTravelQuery, lLocationList,
+                                            lNonMatchedWordList);
+  BOOST_CHECK_MESSAGE (nbOfMatches == 1,
+                       "After the hot-swap, the travel query ('"
+                       << lTravelQuery << "') matches with " << nbOfMatches
+                       << " key-words, whereas 1 is expected.");
+
+  // The nearby searches use the spatial index of the new deployment, and
+  // retrieve the POR from its Xapian index: only the airport of Nice (NCE)
+  // is expected
+  const OPENTREP::Latitude_T lLatitude (43.70);
+  const OPENTREP::Longitude_T lLongitude (7.25);
+  OPENTREP::LocationList_T lAirportList;
+  const OPENTREP::NbOfMatches_T nbOfAirports =
+    opentrepService.findNearby (lLatitude, lLongitude, 50.0, 10, "AIRP",
+                                lAirportList);
+  BOOST_CHECK_MESSAGE (nbOfAirports == 1 && lAirportList.size() == 1
+                       && lAirportList.front().getIataCode() == "NCE",
+                       "After the hot-swap, the nearby search for airports "
+                       << "gives " << nbOfAirports << " POR, whereas only "
+                       << "the airport of Nice (NCE) is expected.");
+
+  // The random draws are made on the new deployment too
+  OPENTREP::LocationList_T lRandomList;
+  const OPENTREP::NbOfMatches_T nbOfDraws =
+    opentrepService.drawRandomLocations (3, lRandomList);
+  BOOST_CHECK_MESSAGE (nbOfDraws == 3,
+                       "After the hot-swap, " << nbOfDraws << " POR are "
+                       << "randomly drawn, whereas 3 are expected.");
+
+  // Nothing new on the other deployment (now the deployment #0)
+  const bool hasSwappedAgain = opentrepService.checkIndexHotSwap();
+  BOOST_CHECK_MESSAGE (hasSwappedAgain == false,
+                       "The searches have been swapped back to the"
+                       << " deployment #0, which is not more recent.");
+
+  // Update the deployment in use (#1) in place, which marks it as ready
+  // again: the searches are swapped to a new version of that deployment
+  opentrepIndexingService.updateDBAndXapian();
+  const bool hasReloaded = opentrepService.checkIndexHotSwap();
+  BOOST_CHECK_MESSAGE (hasReloaded == true
+                       && opentrepService.getActiveDeploymentNumber() == 1,
+                       "After its update in place, the deployment #1 has "
+                       << "not been reopened (the searches use the "
+                       << "deployment #"
+                       << opentrepService.getActiveDeploymentNumber() << ").");
+
+  lNonMatchedWordList.clear();
+  lLocationList.clear();
+  nbOfMatches =
+    opentrepService.interpretTravelRequest (lTravelQuery, lLocationList,
+                                            lNonMatchedWordList);
+  BOOST_CHECK_MESSAGE (nbOfMatches == 1,
+                       "After the update in place, the travel query ('"
+                       << lTravelQuery << "') matches with " << nbOfMatches
+                       << " key-words, whereas 1 is expected.");
+
+  opentrepService.stopIndexHotSwap();
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Index the two deployments of the test POR file, in the Xapian index
+ * and in the given SQLite database
+ */
+void indexSQLDeployments (std::ostream& ioLogStream,
+                          const OPENTREP::TravelDBFilePath_T& iTravelDBPath,
+                          const OPENTREP::SQLDBConnectionString_T& iConnStr) {
+  const OPENTREP::PORFilePath_T lPORFilePath (K_POR_FILEPATH);
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::SQLITE3);
+  for (OPENTREP::DeploymentNumber_T idx = 0; idx != 2; ++idx) {
+    OPENTREP::OPENTREP_Service opentrepIndexingService (ioLogStream,
+                                                        lPORFilePath,
+                                                        iTravelDBPath,
+                                                        lDBType, iConnStr,
+                                                        idx, false, true, true);
+    opentrepIndexingService.insertIntoDBAndXapian();
+  }
+}
+
+/**
+ * Test the look-ups by code on a SQLite database, without hot-swap: the
+ * SQL sessions, along with their prepared statements, are kept from
+ * a look-up to the next one, and re-opened on the other deployment when
+ * that latter is toggled
+ */
+BOOST_AUTO_TEST_CASE (opentrep_code_lookup_sessions) {
+    
+  // Output log File
+  std::string lLogFilename ("SearchingTestSuite_code_lookup.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Index both deployments into a SQLite database
+  const OPENTREP::TravelDBFilePath_T
+    lTravelDBFilePath ("/tmp/opentrep/test_sqldb_traveldb");
+  const OPENTREP::SQLDBConnectionString_T
+    lSQLDBConnStr ("/tmp/opentrep/test_sqldb_travel.db");
+  indexSQLDeployments (logOutputFile, lTravelDBFilePath, lSQLDBConnStr);
+
+  // Initialise the context, for the look-ups on the deployment #0
+  const OPENTREP::DBType lDBType (OPENTREP::DBType::SQLITE3);
+  const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+  OPENTREP::OPENTREP_Service opentrepService (logOutputFile, lTravelDBFilePath,
+                                              lDBType, lSQLDBConnStr,
+                                              lDeploymentNumber);
+
+  // Both the airport and the city of Nice (NCE) are expected, every time
+  const unsigned int lNbOfLookUps = 1000;
+  OPENTREP::BasChronometer lLookUpChronometer; lLookUpChronometer.start();
+  for (unsigned int idx = 0; idx != lNbOfLookUps; ++idx) {
+    OPENTREP::LocationList_T lLocationList;
+    const OPENTREP::NbOfMatches_T nbOfMatches =
+      opentrepService.listByIataCode (OPENTREP::IATACode_T ("NCE"),
+                                      lLocationList);
+    BOOST_REQUIRE_MESSAGE (nbOfMatches == 2,
+                           "The look-up #" << idx << " of NCE gives "
+                           << nbOfMatches << " POR, whereas 2 are expected.");
+  }
+  const double lLookUpMeasure = lLookUpChronometer.elapsed();
+  logOutputFile << "Look-up by IATA code: " << lNbOfLookUps
+                << " look-ups in " << lLookUpMeasure << "s, i.e., "
+                << (lLookUpMeasure > 0.0 ? lNbOfLookUps / lLookUpMeasure : 0.0)
+                << " look-ups per second" << std::endl;
+
+  // The full-text searches borrow the same SQL sessions
+  std::string lTravelQuery ("nce");
+  OPENTREP::WordList_T lNonMatchedWordList;
+  OPENTREP::LocationList_T lLocationList;
+  OPENTREP::NbOfMatches_T nbOfMatches =
+    opentrepService.interpretTravelRequest (lTravelQuery, lLocationList,
+                                            lNonMatchedWordList);
+  BOOST_CHECK_MESSAGE (nbOfMatches == 1,
+                       "The travel query ('" << lTravelQuery
+                       << "') matches with " << nbOfMatches
+                       << " key-words, whereas 1 is expected.");
+
+  // Toggle to the deployment #1: the look-ups are made on its SQL database
+  const OPENTREP::DeploymentNumber_T lNewDeploymentNumber =
+    opentrepService.toggleDeploymentNumber();
+  BOOST_REQUIRE_EQUAL (lNewDeploymentNumber, 1);
+  lLocationList.clear();
+  nbOfMatches =
+    opentrepService.listByIcaoCode (OPENTREP::ICAOCode_T ("LFMN"),
+                                    lLocationList);
+  BOOST_CHECK_MESSAGE (nbOfMatches == 1 && lLocationList.size() == 1
+                       && lLocationList.front().getIataCode() == "NCE",
+                       "On the deployment #1, the look-up of LFMN gives "
+                       << nbOfMatches << " POR, whereas only the airport "
+                       << "of Nice (NCE) is expected.");
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Test the look-ups by code on a SQLite database copied in memory, and
+ * then mapped in memory, with and without hot-swap
+ */
+BOOST_AUTO_TEST_CASE (opentrep_index_hot_swap_sql_load_modes) {
+    
+  // Output log File
+  std::string lLogFilename ("SearchingTestSuite_sql_load_modes.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Index both deployments into a SQLite database
+  const OPENTREP::TravelDBFilePath_T
+    lTravelDBFilePath ("/tmp/opentrep/test_sqldb_traveldb");
+  const OPENTREP::SQLDBConnectionString_T
+    lSQLDBConnStr ("/tmp/opentrep/test_sqldb_travel.db");
+  indexSQLDeployments (logOutputFile, lTravelDBFilePath, lSQLDBConnStr);
+
+  const OPENTREP::SQLDBLoadMode::EN_SQLDBLoadMode lLoadModeList[] =
+    { OPENTREP::SQLDBLoadMode::IN_MEMORY, OPENTREP::SQLDBLoadMode::MMAP };
+  for (unsigned short idx = 0; idx != 2; ++idx) {
+    const OPENTREP::SQLDBLoadMode lLoadMode (lLoadModeList[idx]);
+
+    // Initialise the context, for the look-ups on the deployment #0
+    const OPENTREP::DBType lDBType (OPENTREP::DBType::SQLITE3);
+    const OPENTREP::DeploymentNumber_T lDeploymentNumber (X_DEPLOYMENT_NUMBER);
+    OPENTREP::OPENTREP_Service opentrepService (logOutputFile,
+                                                lTravelDBFilePath,
+                                                lDBType, lSQLDBConnStr,
+                                                lDeploymentNumber);
+    opentrepService.setSQLDBLoadMode (lLoadMode);
+
+    // First without hot-swap (from the pool of sessions), then with it
+    for (unsigned short idxHotSwap = 0; idxHotSwap != 2; ++idxHotSwap) {
+      const bool isHotSwapped = (idxHotSwap == 1);
+      if (isHotSwapped == true) {
+        const OPENTREP::PollingPeriod_T lNoPolling = 0;
+        opentrepService.startIndexHotSwap (lNoPolling);
+      }
+      const std::string lContext (lLoadMode.describe()
+                                  + (isHotSwapped == true ?
+                                     " mode, with hot-swap" :
+                                     " mode, without hot-swap"));
+
+      // Both the airport and the city of Nice (NCE) are expected
+      OPENTREP::LocationList_T lLocationList;
+      OPENTREP::NbOfMatches_T nbOfMatches =
+        opentrepService.listByIataCode (OPENTREP::IATACode_T ("NCE"),
+                                        lLocationList);
+      BOOST_CHECK_MESSAGE (nbOfMatches == 2,
+                           "With the " << lContext << ", the look-up of NCE "
+                           << "gives " << nbOfMatches
+                           << " POR, whereas 2 are expected.");
+
+      // Only the airport of Nice (NCE) is expected
+      lLocationList.clear();
+      nbOfMatches =
+        opentrepService.listByIcaoCode (OPENTREP::ICAOCode_T ("LFMN"),
+                                        lLocationList);
+      BOOST_CHECK_MESSAGE (nbOfMatches == 1 && lLocationList.size() == 1
+                           && lLocationList.front().getIataCode() == "NCE",
+                           "With the " << lContext << ", the look-up of LFMN "
+                           << "gives " << nbOfMatches << " POR, whereas only "
+                           << "the airport of Nice (NCE) is expected.");
+    }
+
+    opentrepService.stopIndexHotSwap();
+  }
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
 // End the test suite
 BOOST_AUTO_TEST_SUITE_END()
 
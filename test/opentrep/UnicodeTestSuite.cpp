@@ -11,13 +11,22 @@
 #include <fstream>
 #include <string>
 #include <list>
+#include <vector>
+// Boost
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
 // Boost Unit Test Framework (UTF)
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_MODULE UnicodeTestSuite
 #include <boost/test/unit_test.hpp>
+// ICU
+#include <unicode/translit.h>
 // OpenTrep
+#include <opentrep/basic/BasChronometer.hpp>
+#include <opentrep/basic/BasConst_Unicode.hpp>
 #include <opentrep/basic/OTransliterator.hpp>
+#include <opentrep/basic/icu_util.hpp>
 
 namespace boost_utf = boost::unit_test;
 
@@ -212,6 +221,191 @@ BOOST_AUTO_TEST_CASE (unicode_strings) {
   logOutputFile.close();
 }
 
+/**
+ * Apply the given ICU transliterator, the way the OTransliterator class
+ * used to do it for every string.
+ */
+std::string transliterateWithICU (icu::Transliterator& ioTransliterator,
+                                  const std::string& iString) {
+  icu::UnicodeString lString (iString.c_str());
+  ioTransliterator.transliterate (lString);
+  return OPENTREP::getUTF8 (lString);
+}
+
+/**
+ * Check that the ASCII fast path and the memo cache of the Unicode
+ * transliterator give the same results as ICU, and measure their speed
+ */
+BOOST_AUTO_TEST_CASE (unicode_transliteration_speed) {
+
+  // Output log File
+  std::string lLogFilename ("UnicodeTestSuite_speed.log");
+
+  // Set the log parameters
+  std::ofstream logOutputFile;
+  // Open and clean the log outputfile
+  logOutputFile.open (lLogFilename.c_str());
+  logOutputFile.clear();
+
+  // Unicode transliterator
+  OPENTREP::OTransliterator lTransliterator;
+
+  // Reference ICU transliterators
+  UErrorCode lStatus = U_ZERO_ERROR;
+  UParseError lParseError;
+  icu::Transliterator* lPunctuationRemover =
+    icu::Transliterator::createInstance(OPENTREP::K_ICU_PUNCTUATION_REMOVAL_RULE,
+                                        UTRANS_FORWARD, lStatus);
+  const icu::UnicodeString lQuotationRules(OPENTREP::K_ICU_QUOTATION_REMOVAL_RULE);
+  icu::Transliterator* lQuoteRemover =
+    icu::Transliterator::createFromRules ("RBTUnquote", lQuotationRules,
+                                          UTRANS_FORWARD, lParseError, lStatus);
+  icu::Transliterator* lAccentRemover =
+    icu::Transliterator::createInstance (OPENTREP::K_ICU_ACCENT_REMOVAL_RULE,
+                                         UTRANS_FORWARD, lStatus);
+  icu::Transliterator* lTranslit =
+    icu::Transliterator::createInstance(OPENTREP::K_ICU_GENERIC_TRANSLITERATOR_RULE,
+                                        UTRANS_FORWARD, lStatus);
+  BOOST_REQUIRE (U_SUCCESS (lStatus));
+
+  // Plain ASCII strings, with punctuation and quotes, and non-ASCII ones
+  std::list<std::string> lStringList;
+  lStringList.push_back ("San Francisco International Airport");
+  lStringList.push_back ("Saint-Denis-de-l'Ile (St. Pierre)");
+  lStringList.push_back ("rio de janeiro, galeão/antonio carlos jobim");
+  lStringList.push_back ("O'Hare Int'l; \"Chicago\" [ORD] {IL} #1 & 2?");
+  lStringList.push_back ("À côté de Nice Côte d'Azur");
+  lStringList.push_back ("Аэропорт «Аннаба», Биологическом");
+  lStringList.push_back ("サンフランシスコ国際空港");
+
+  // Check that the results are the same as with ICU
+  for (std::list<std::string>::const_iterator itString = lStringList.begin();
+       itString != lStringList.end(); ++itString) {
+    const std::string& lString = *itString;
+    BOOST_CHECK_EQUAL (lTransliterator.unpunctuate (lString),
+                       transliterateWithICU (*lPunctuationRemover, lString));
+    BOOST_CHECK_EQUAL (lTransliterator.unquote (lString),
+                       transliterateWithICU (*lQuoteRemover, lString));
+    BOOST_CHECK_EQUAL (lTransliterator.unaccent (lString),
+                       transliterateWithICU (*lAccentRemover, lString));
+    BOOST_CHECK_EQUAL (lTransliterator.transliterate (lString),
+                       transliterateWithICU (*lTranslit, lString));
+
+    std::string lNormalisedString =
+      transliterateWithICU (*lAccentRemover, lString);
+    lNormalisedString = transliterateWithICU (*lQuoteRemover,
+                                              lNormalisedString);
+    lNormalisedString = transliterateWithICU (*lPunctuationRemover,
+                                              lNormalisedString);
+    lNormalisedString = transliterateWithICU (*lTranslit, lNormalisedString);
+    BOOST_CHECK_EQUAL (lTransliterator.normalise (lString), lNormalisedString);
+  }
+
+  // Speed of every transformation, with the OTransliterator class
+  // and directly with ICU
+  const unsigned int lNbOfRuns = 2000;
+  for (std::list<std::string>::const_iterator itString = lStringList.begin();
+       itString != lStringList.end(); ++itString) {
+    const std::string& lString = *itString;
+    size_t lTotalSize = 0;
+
+    OPENTREP::BasChronometer lChronometer; lChronometer.start();
+    for (unsigned int idx = 0; idx != lNbOfRuns; ++idx) {
+      lTotalSize += lTransliterator.unaccent (lString).size();
+      lTotalSize += lTransliterator.unquote (lString).size();
+      lTotalSize += lTransliterator.unpunctuate (lString).size();
+      lTotalSize += lTransliterator.transliterate (lString).size();
+      lTotalSize += lTransliterator.normalise (lString).size();
+    }
+    const double lOTransliteratorMeasure = lChronometer.elapsed();
+
+    lChronometer.start();
+    for (unsigned int idx = 0; idx != lNbOfRuns; ++idx) {
+      lTotalSize += transliterateWithICU (*lAccentRemover, lString).size();
+      lTotalSize += transliterateWithICU (*lQuoteRemover, lString).size();
+      lTotalSize += transliterateWithICU (*lPunctuationRemover, lString).size();
+      lTotalSize += transliterateWithICU (*lTranslit, lString).size();
+    }
+    const double lICUMeasure = lChronometer.elapsed();
+
+    logOutputFile << "'" << lString << "': " << lNbOfRuns << " runs in "
+                  << lOTransliteratorMeasure << "s (accent, quote and "
+                  << "punctuation removers, transliterator and normaliser), "
+                  << "compared to " << lICUMeasure << "s directly with ICU "
+                  << "(without the normaliser) - " << lTotalSize << std::endl;
+  }
+
+  delete lPunctuationRemover;
+  delete lQuoteRemover;
+  delete lAccentRemover;
+  delete lTranslit;
+
+  // Close the Log outputFile
+  logOutputFile.close();
+}
+
+/**
+ * Normalise, several times, all the strings of the given list, storing
+ * the results of the last round. That function is run by several threads
+ * at once, sharing the same transliterator.
+ */
+void normaliseStringList (const OPENTREP::OTransliterator& iTransliterator,
+                          const std::vector<std::string>& iStringList,
+                          const unsigned int iNbOfRounds,
+                          std::vector<std::string>& ioNormalisedStringList) {
+  for (unsigned int idx = 0; idx != iNbOfRounds; ++idx) {
+    ioNormalisedStringList.clear();
+    for (std::vector<std::string>::const_iterator itString =
+           iStringList.begin(); itString != iStringList.end(); ++itString) {
+      const std::string& lString = *itString;
+      ioNormalisedStringList.push_back (iTransliterator.normalise (lString));
+    }
+  }
+}
+
+/**
+ * Check that a single Unicode transliterator can be used by several
+ * threads at once
+ */
+BOOST_AUTO_TEST_CASE (unicode_transliteration_threads) {
+
+  // Unicode transliterator, shared by all the threads
+  const OPENTREP::OTransliterator lTransliterator;
+
+  // Non-ASCII strings, which have to go through the ICU transliterators
+  std::vector<std::string> lStringList;
+  lStringList.push_back ("rio de janeiro, galeão/antonio carlos jobim");
+  lStringList.push_back ("À côté de Nice Côte d'Azur");
+  lStringList.push_back ("Аэропорт «Аннаба», Биологическом");
+  lStringList.push_back ("サンフランシスコ国際空港");
+  lStringList.push_back ("München Franz Josef Strauß");
+  lStringList.push_back ("Αθήνα Ελευθέριος Βενιζέλος");
+
+  // Reference results, from the main thread
+  std::vector<std::string> lReferenceList;
+  normaliseStringList (lTransliterator, lStringList, 1, lReferenceList);
+
+  // The same normalisations, by several threads at once. The first round
+  // of every thread goes through the ICU transliterators (clones specific
+  // to that thread), and the next rounds through the cache of the thread.
+  const unsigned short lNbOfThreads = 8;
+  std::vector<std::vector<std::string> > lResultList (lNbOfThreads);
+  boost::thread_group lThreadGroup;
+  for (unsigned short idx = 0; idx != lNbOfThreads; ++idx) {
+    lThreadGroup.create_thread (boost::bind (normaliseStringList,
+                                             boost::cref (lTransliterator),
+                                             boost::cref (lStringList), 20,
+                                             boost::ref (lResultList[idx])));
+  }
+  lThreadGroup.join_all();
+
+  // Check that every thread got the same results as the main thread
+  for (unsigned short idx = 0; idx != lNbOfThreads; ++idx) {
+    const std::vector<std::string>& lResults = lResultList[idx];
+    BOOST_CHECK (lResults == lReferenceList);
+  }
+}
+
 // End the test suite
 BOOST_AUTO_TEST_SUITE_END()
 
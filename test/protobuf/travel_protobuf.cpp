@@ -1,12 +1,73 @@
 // STL
+#include <cstdlib>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <new>
 // OpenTrep Protobuf
 #include <opentrep/Travel.pb.h>
 // OpenTrep
 #include <opentrep/Location.hpp>
 #include <opentrep/CityDetails.hpp>
+#include <opentrep/basic/BasChronometer.hpp>
+#include <opentrep/bom/PORParserHelper.hpp>
 #include <opentrep/bom/LocationExchange.hpp>
 #include <opentrep/service/Logger.hpp>
+#include <opentrep/config/opentrep-paths.hpp>
+
+/**
+ * Number of memory allocations made so far by the program.
+ */
+static unsigned long long gNbOfAllocations = 0;
+
+// ////////////////////////////////////////////////////////////////////
+void* operator new (std::size_t iSize) {
+  ++gNbOfAllocations;
+  void* oPtr = std::malloc (iSize == 0 ? 1 : iSize);
+  if (oPtr == NULL) {
+    throw std::bad_alloc();
+  }
+  return oPtr;
+}
+
+// ////////////////////////////////////////////////////////////////////
+void operator delete (void* ioPtr) noexcept {
+  std::free (ioPtr);
+}
+
+// ////////////////////////////////////////////////////////////////////
+void operator delete (void* ioPtr, std::size_t) noexcept {
+  std::free (ioPtr);
+}
+
+/**
+ * Export a list of Location structures as it used to be done, i.e.,
+ * with a Protobuf structure allocated for every export.
+ */
+// ////////////////////////////////////////////////////////////////////
+std::string
+exportWithNewQueryAnswer (const OPENTREP::LocationList_T& iLocationList,
+                          const OPENTREP::WordList_T& iWordList) {
+  std::string oStr ("");
+  treppb::QueryAnswer lQueryAnswer;
+  lQueryAnswer.set_ok_status (true);
+  treppb::PlaceList* lPlaceListPtr = lQueryAnswer.mutable_place_list();
+  for (OPENTREP::LocationList_T::const_iterator itLocation =
+         iLocationList.begin(); itLocation != iLocationList.end();
+       ++itLocation) {
+    treppb::Place* lPlacePtr = lPlaceListPtr->add_place();
+    OPENTREP::LocationExchange::exportLocation (*lPlacePtr, *itLocation);
+  }
+  treppb::UnknownKeywordList* lUnknownKeywordListPtr =
+    lQueryAnswer.mutable_unmatched_keyword_list();
+  for (OPENTREP::WordList_T::const_iterator itWord = iWordList.begin();
+       itWord != iWordList.end(); ++itWord) {
+    lUnknownKeywordListPtr->add_word (*itWord);
+  }
+  lQueryAnswer.SerializeToString (&oStr);
+  return oStr;
+}
 
 // ////////////// M A I N //////////////
 int main (int argc, char* argv[]) {
@@ -39,6 +100,77 @@ int main (int argc, char* argv[]) {
   // DEBUG
   OPENTREP_LOG_DEBUG ("Serialised location: " << lSerialisedLocation);
   
+  // Parse the POR of the test file, so as to export larger lists, every
+  // Location structure coming with the former ones as alternate matches
+  const std::string lPORFilePath (OPENTREP_POR_DATA_DIR
+                                  "/test_optd_por_public.csv");
+  OPENTREP::LocationList_T lPORList;
+  OPENTREP::LocationList_T lAlternateLocationList;
+  std::ifstream lPORFile (lPORFilePath.c_str());
+  std::string lPORLine;
+  // Skip the header of the POR file
+  std::getline (lPORFile, lPORLine);
+  while (std::getline (lPORFile, lPORLine)) {
+    OPENTREP::PORStringParser lPORParser (lPORLine);
+    const OPENTREP::Location& lPORLocation = lPORParser.generateLocation();
+    OPENTREP::Location lMatchingLocation (lPORLocation);
+    for (OPENTREP::LocationList_T::const_iterator itLocation =
+           lAlternateLocationList.begin();
+         itLocation != lAlternateLocationList.end(); ++itLocation) {
+      lMatchingLocation.addAlternateLocation (*itLocation);
+    }
+    lPORList.push_back (lMatchingLocation);
+    lAlternateLocationList.push_back (lPORLocation);
+  }
+  if (lPORList.empty() == true) {
+    std::cerr << "No POR can be read from " << lPORFilePath << std::endl;
+    return 1;
+  }
+
+  // Compare the former export (one Protobuf structure for every export)
+  // and the export re-using the Protobuf structure and the output buffer
+  const unsigned int lNbOfRuns = 1000;
+  std::size_t lNbOfBytes = 0;
+  unsigned long long lNbOfAllocations = gNbOfAllocations;
+  OPENTREP::BasChronometer lFormerChronometer; lFormerChronometer.start();
+  for (unsigned int idxRun = 0; idxRun != lNbOfRuns; ++idxRun) {
+    const std::string& lPBStr = exportWithNewQueryAnswer (lPORList,
+                                                          lNonMatchedWordList);
+    lNbOfBytes += lPBStr.size();
+  }
+  const double lFormerElapsed = lFormerChronometer.elapsed();
+  const unsigned long long lFormerNbOfAllocations =
+    gNbOfAllocations - lNbOfAllocations;
+
+  std::string lPBBuffer;
+  lNbOfAllocations = gNbOfAllocations;
+  OPENTREP::BasChronometer lReusedChronometer; lReusedChronometer.start();
+  for (unsigned int idxRun = 0; idxRun != lNbOfRuns; ++idxRun) {
+    OPENTREP::LocationExchange::exportLocationList (lPBBuffer, lPORList,
+                                                    lNonMatchedWordList);
+    lNbOfBytes += lPBBuffer.size();
+  }
+  const double lReusedElapsed = lReusedChronometer.elapsed();
+  const unsigned long long lReusedNbOfAllocations =
+    gNbOfAllocations - lNbOfAllocations;
+
+  // Both ways must give the same serialisation
+  const std::string& lFormerPBStr =
+    exportWithNewQueryAnswer (lPORList, lNonMatchedWordList);
+  if (lFormerPBStr != lPBBuffer) {
+    std::cerr << "The serialisations of the " << lPORList.size()
+              << " POR differ (" << lFormerPBStr.size() << " vs "
+              << lPBBuffer.size() << " bytes)" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Protobuf export of " << lPORList.size() << " POR ("
+            << lPBBuffer.size() << " bytes), " << lNbOfRuns << " times ("
+            << lNbOfBytes << " bytes): new structures: " << lFormerElapsed
+            << "s, " << lFormerNbOfAllocations << " allocations; re-used "
+            << "structures: " << lReusedElapsed << "s, "
+            << lReusedNbOfAllocations << " allocations" << std::endl;
+
   // Optional:  Delete all global objects allocated by libprotobuf.
   google::protobuf::ShutdownProtobufLibrary();
 
@@ -1,9 +1,78 @@
 #!/usr/bin/env python
 
-import os, json, urllib.request, shutil, pathlib
+import os, json, math, time, urllib.request, shutil, pathlib
+import asyncio
+import concurrent.futures
 import pytest
 import pyopentrep
 
+# Parameters of the OpenTREP resources
+tmp_dir = "/tmp/opentrep"
+optd_por_test_url = \
+    'https://github.com/trep/opentrep/blob/master/data/por/test_optd_por_public.csv?raw=true'
+xapianDBPath = f"{tmp_dir}/xapian_traveldb"
+sqlDBType = "sqlite"
+sqlDBConnStr = f"{tmp_dir}/sqlite_travel.db"
+deploymentNb = 0
+flagDontIndexIATAPOR = False
+flagIndexPORInXapian = True
+flagAddPORInDB = True
+
+
+def get_por_path():
+    """
+    Retrieve the file-path of the POR sample data, downloading it if needed
+    """
+    porPath1 = "/usr/share/opentrep/data/por/test_optd_por_public.csv"
+    porPath2 = "/usr/local/share/opentrep/data/por/test_optd_por_public.csv"
+    porPath3 = f"{tmp_dir}/test_optd_por_public.csv"
+    porPath = None
+
+    # Create the OpenTREP temporary directory if not already existing
+    pathlib.Path(tmp_dir).mkdir(parents=True, exist_ok=True)
+    
+    # If the POR sample data cannot be found, download it
+    porFileExists = os.path.exists (porPath1)
+    if porFileExists:
+        # The POR sample data has been found
+        porPath = porPath1
+    else:
+        # Try the other location for the POR sample data
+        porFileExists = os.path.exists (porPath2)
+    if porFileExists:
+        # The POR sample data has been found
+        porPath = porPath2
+    else:        
+        # No POR sample data has been found. Download it
+        with urllib.request.urlopen (optd_por_test_url) as response, \
+             open (porPath3, 'wb') as out_file:
+            shutil.copyfileobj (response, out_file)
+        porPath = porPath3
+
+    #
+    porFileExists = os.path.exists (porPath)
+    assert porFileExists, (
+        f"The POR sample data file does not seem to exist"
+    )
+    return porPath
+
+
+def init_library(porPath, logPath):
+    """
+    Initialise the OpenTrep C++ library
+    """
+    openTrepLibrary = pyopentrep.OpenTrepSearcher()
+    initOK = openTrepLibrary.init (porPath, xapianDBPath,
+                                   sqlDBType, sqlDBConnStr,
+                                   deploymentNb,
+                                   flagDontIndexIATAPOR, flagIndexPORInXapian,
+                                   flagAddPORInDB,
+                                   logPath)
+    assert initOK, (
+        f"The OpenTREP library could not be initialised"
+    )
+    return openTrepLibrary
+
 
 def test_e2e_simple():
     """
@@ -84,3 +153,488 @@ def test_e2e_simple():
         f"The results for the query ({nce_sfo_query}, are not as expected.\n"
         f"Expected: 'NCE/0,SFO/0' expected) - Got: '{nce_sfo_result}'"
     )
+
+
+def test_e2e_find_nearby():
+    """
+    Test searching the POR nearby a geographical point
+    """
+    porPath = get_por_path()
+    logPath = f"{tmp_dir}/test_trep_e2e_nearby.log"
+    openTrepLibrary = init_library(porPath, logPath)
+
+    # Create the Xapian index
+    nb_of_por = openTrepLibrary.index()
+    assert nb_of_por == "9", (
+        f"Number of index POR: {nb_of_por}"
+    )
+
+    # Search the airports nearby a geographical point (close to Nice)
+    nearby_result = openTrepLibrary.findNearby("S", 43.70, 7.25, 50.0, 1,
+                                               "AIRP")
+    assert nearby_result.startswith("NCE/"), (
+        f"The nearest airport is expected to be NCE - Got: '{nearby_result}'"
+    )
+
+    openTrepLibrary.finalize()
+
+
+def test_e2e_distance_matrix():
+    """
+    Test calculating the great circle distances between POR
+    """
+    porPath = get_por_path()
+    logPath = f"{tmp_dir}/test_trep_e2e_distance.log"
+    openTrepLibrary = init_library(porPath, logPath)
+
+    # Create the Xapian index
+    nb_of_por = openTrepLibrary.index()
+    assert nb_of_por == "9", (
+        f"Number of index POR: {nb_of_por}"
+    )
+
+    # Great circle distances between codes (Nice - San Francisco). An
+    # unknown code (ZZZ) gives NaN distances
+    distance_matrix = openTrepLibrary.distanceMatrix(["nce", "zzz"],
+                                                     ["sfo", "nce"])
+    assert 9600.0 < distance_matrix[0][0] < 9700.0, (
+        f"The NCE-SFO distance is not as expected - Got: {distance_matrix}"
+    )
+    assert math.isnan(distance_matrix[1][0]), (
+        f"The ZZZ-SFO distance is not NaN - Got: {distance_matrix}"
+    )
+
+    # Great circle distances between (latitude, longitude) pairs
+    distance_matrix = openTrepLibrary.distanceMatrix([(43.66, 7.21)],
+                                                     [(37.62, -122.38)])
+    assert 9600.0 < distance_matrix[0][0] < 9700.0, (
+        f"The Nice-San Francisco distance is not as expected - "
+        f"Got: {distance_matrix}"
+    )
+
+    openTrepLibrary.finalize()
+
+
+def test_e2e_search_with_origin():
+    """
+    Test searching with a bias towards a caller-given origin
+    """
+    porPath = get_por_path()
+    logPath = f"{tmp_dir}/test_trep_e2e_origin.log"
+    openTrepLibrary = init_library(porPath, logPath)
+
+    # Create the Xapian index
+    nb_of_por = openTrepLibrary.index()
+    assert nb_of_por == "9", (
+        f"Number of index POR: {nb_of_por}"
+    )
+
+    # Search biased towards an origin (San Francisco)
+    origin_result = openTrepLibrary.searchWithOrigin("S", "nce", 37.77, -122.42,
+                                                     "US")
+    assert origin_result.startswith("NCE/"), (
+        f"The results for 'nce' from San Francisco are not as expected - "
+        f"Got: '{origin_result}'"
+    )
+
+    openTrepLibrary.finalize()
+
+
+def test_e2e_concurrent_search():
+    """
+    Test searching from several Python threads at once. As the GIL is
+    released while the C++ library searches, the searches overlap, and
+    the throughput increases with the number of threads.
+    """
+    porPath = get_por_path()
+    logPath = f"{tmp_dir}/test_trep_e2e_concurrent.log"
+    openTrepLibrary = init_library(porPath, logPath)
+
+    # Create the Xapian index
+    nb_of_por = openTrepLibrary.index()
+    assert nb_of_por == "9", (
+        f"Number of index POR: {nb_of_por}"
+    )
+
+    # The same queries are searched sequentially, then from several threads
+    expectedResult = "NCE/0,SFO/0"
+    queries = ["nce sfo"] * 200
+    nb_of_threads = 4
+
+    start_time = time.perf_counter()
+    sequential_results = [openTrepLibrary.search("S", query)
+                          for query in queries]
+    sequential_duration = time.perf_counter() - start_time
+
+    start_time = time.perf_counter()
+    with concurrent.futures.ThreadPoolExecutor(max_workers=nb_of_threads) \
+         as executor:
+        concurrent_results = list(executor.map(
+            lambda query: openTrepLibrary.search("S", query), queries))
+    concurrent_duration = time.perf_counter() - start_time
+
+    # The results do not depend on the threads
+    assert sequential_results == [expectedResult] * len(queries), (
+        f"Unexpected sequential results: {set(sequential_results)}"
+    )
+    assert concurrent_results == sequential_results, (
+        f"Unexpected concurrent results: {set(concurrent_results)}"
+    )
+
+    # Report the throughput gain, which depends on the free cores of
+    # the machine, and is therefore not checked
+    speedup = sequential_duration / concurrent_duration
+    print(f"Searches from {nb_of_threads} threads: "
+          f"sequential: {sequential_duration:.3f}s, "
+          f"concurrent: {concurrent_duration:.3f}s, "
+          f"speedup: {speedup:.2f}")
+
+    openTrepLibrary.finalize()
+
+
+def read_pb_varint(buffer, position):
+    """
+    Read a Protobuf varint, and return it with the position following it
+    """
+    value, shift = 0, 0
+    while True:
+        byte = buffer[position]
+        position += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, position
+
+
+def read_pb_fields(buffer):
+    """
+    Walk through the (varint and length-delimited) fields of a Protobuf
+    message, and return them as a list of (field number, value) pairs
+    """
+    fields = []
+    position = 0
+    while position < len(buffer):
+        key, position = read_pb_varint(buffer, position)
+        field_number, wire_type = key >> 3, key & 0x7
+        if wire_type == 0:
+            value, position = read_pb_varint(buffer, position)
+        else:
+            assert wire_type == 2, f"Unexpected Protobuf wire type: {wire_type}"
+            size, position = read_pb_varint(buffer, position)
+            value = buffer[position:position + size]
+            position += size
+        fields.append((field_number, value))
+    return fields
+
+
+def decode_pb_batch_status(pb_batch):
+    """
+    Extract the status (ok_status) and the error message (error_msg) of
+    every answer of a Protobuf batch (treppb::QueryAnswerList), without
+    needing the generated Travel_pb2 module
+    """
+    statuses = []
+    for field_number, answer in read_pb_fields(pb_batch):
+        assert field_number == 1, f"Unexpected field: {field_number}"
+        ok_status, error_msg = False, ""
+        for answer_field, value in read_pb_fields(answer):
+            if answer_field == 1:
+                ok_status = bool(value)
+            elif answer_field == 2:
+                for message_field, message in read_pb_fields(value):
+                    if message_field == 1:
+                        error_msg = message.decode("utf-8")
+        statuses.append((ok_status, error_msg))
+    return statuses
+
+
+def test_e2e_batch_search():
+    """
+    Test searching a batch of queries within a single call
+    """
+    porPath = get_por_path()
+    logPath = f"{tmp_dir}/test_trep_e2e_batch.log"
+    openTrepLibrary = init_library(porPath, logPath)
+
+    # Create the Xapian index
+    nb_of_por = openTrepLibrary.index()
+    assert nb_of_por == "9", (
+        f"Number of index POR: {nb_of_por}"
+    )
+
+    # The results are the same as with one call per query, and in the order
+    # of the queries, whatever the number of threads
+    queries = ["nce sfo", "sfo", "nce", "sna"]
+    for output_format in ["S", "F", "J", "C", "T"]:
+        expected_results = [openTrepLibrary.search(output_format, query)
+                            for query in queries]
+        for nb_of_threads in [1, 3, 0]:
+            batch_results = openTrepLibrary.searchMany(output_format,
+                                                       queries,
+                                                       nb_of_threads)
+            assert batch_results == expected_results, (
+                f"Unexpected batch results ({output_format} format, "
+                f"{nb_of_threads} threads): {batch_results}"
+            )
+
+    # Any iterable of queries is accepted
+    batch_results = openTrepLibrary.searchMany("S", iter(queries), 2)
+    assert batch_results[0] == "NCE/0,SFO/0", (
+        f"Unexpected batch results: {batch_results}"
+    )
+
+    # Protobuf: a single batch of query answers
+    pb_batch = openTrepLibrary.searchMany("P", queries, 2)
+    assert isinstance(pb_batch, bytes) and len(pb_batch) > 0, (
+        f"Unexpected Protobuf batch: {pb_batch}"
+    )
+    pb_statuses = decode_pb_batch_status(pb_batch)
+    assert pb_statuses == [(True, "")] * len(queries), (
+        f"Unexpected Protobuf statuses: {pb_statuses}"
+    )
+
+    # A failed query (here, an empty one) is reported in its own slot,
+    # the other queries being searched as usual
+    failing_queries = ["nce", "", "sfo"]
+    for nb_of_threads in [1, 3]:
+        batch_results = openTrepLibrary.searchMany("S", failing_queries,
+                                                   nb_of_threads)
+        assert len(batch_results) == len(failing_queries) \
+            and batch_results[0] == openTrepLibrary.search("S", "nce") \
+            and isinstance(batch_results[1], RuntimeError) \
+            and str(batch_results[1]) != "" \
+            and batch_results[2] == openTrepLibrary.search("S", "sfo"), (
+            f"Unexpected batch results with a failed query "
+            f"({nb_of_threads} threads): {batch_results}"
+        )
+
+    # Protobuf: the answer to the failed query has a false status, and
+    # an error message
+    pb_batch = openTrepLibrary.searchMany("P", failing_queries, 2)
+    pb_statuses = decode_pb_batch_status(pb_batch)
+    assert len(pb_statuses) == len(failing_queries) \
+        and pb_statuses[0] == (True, "") and pb_statuses[2] == (True, "") \
+        and pb_statuses[1][0] is False and pb_statuses[1][1] != "", (
+        f"Unexpected Protobuf statuses with a failed query: {pb_statuses}"
+    )
+
+    openTrepLibrary.finalize()
+
+
+def test_e2e_batch_search_threads():
+    """
+    Test batch searches running on many threads, several batches being
+    searched at once (from several Python threads) on the same service.
+    The searches of all those threads share the same OpenTREP service.
+    """
+    porPath = get_por_path()
+    logPath = f"{tmp_dir}/test_trep_e2e_batch_threads.log"
+    openTrepLibrary = init_library(porPath, logPath)
+
+    # Create the Xapian index
+    nb_of_por = openTrepLibrary.index()
+    assert nb_of_por == "9", (
+        f"Number of index POR: {nb_of_por}"
+    )
+
+    distinct_queries = ["nce sfo", "sfo", "nce", "sna", "rio de janero",
+                        "sna francicso lso angles reykyavki"]
+    expected_by_query = {query: openTrepLibrary.search("S", query)
+                         for query in distinct_queries}
+    queries = distinct_queries * 100
+    expected_results = [expected_by_query[query] for query in queries]
+
+    # A single batch, on many threads
+    batch_results = openTrepLibrary.searchMany("S", queries, 8)
+    assert batch_results == expected_results, (
+        f"Unexpected batch results on 8 threads: "
+        f"{set(batch_results) - set(expected_results)}"
+    )
+
+    # Several batches at once, each on several threads
+    nb_of_batches = 4
+    with concurrent.futures.ThreadPoolExecutor(max_workers=nb_of_batches) \
+         as executor:
+        batch_result_lists = list(executor.map(
+            lambda idx: openTrepLibrary.searchMany("S", queries, 4),
+            range(nb_of_batches)))
+    for batch_results in batch_result_lists:
+        assert batch_results == expected_results, (
+            f"Unexpected results of concurrent batches: "
+            f"{set(batch_results) - set(expected_results)}"
+        )
+
+    openTrepLibrary.finalize()
+
+
+async def submit_async_search(openTrepLibrary, format, query):
+    """
+    Submit a travel query to the asynchronous search, waiting (through
+    the event loop) for a free slot while the submission queue is full
+    """
+    while True:
+        try:
+            return openTrepLibrary.searchAsync(format, query)
+        except pyopentrep.AsyncSearchQueueFull:
+            await openTrepLibrary.waitAsyncSearchSlot()
+
+
+def test_e2e_async_search():
+    """
+    Test searching from an asyncio event loop, with thousands of travel
+    queries in flight at once
+    """
+    porPath = get_por_path()
+    logPath = f"{tmp_dir}/test_trep_e2e_async.log"
+    openTrepLibrary = init_library(porPath, logPath)
+
+    # Create the Xapian index
+    nb_of_por = openTrepLibrary.index()
+    assert nb_of_por == "9", (
+        f"Number of index POR: {nb_of_por}"
+    )
+
+    # A small submission queue, so that the submissions wait for the threads
+    started = openTrepLibrary.startAsyncSearch(4, 64)
+    assert started, (
+        f"The asynchronous search could not be started"
+    )
+
+    distinct_queries = ["nce sfo", "sfo", "nce", "sna", "rio de janero",
+                        "sna francicso lso angles reykyavki"]
+    queries = (distinct_queries[:4] * 500) + (distinct_queries * 100)
+
+    async def search_all():
+        futures = [await submit_async_search(openTrepLibrary, "S", query)
+                   for query in queries]
+        return await asyncio.gather(*futures)
+
+    # The expected results come from sequential searches, the asynchronous
+    # searches running on the 4 threads at once
+    async_results = asyncio.run(search_all())
+    expected_by_query = {query: openTrepLibrary.search("S", query)
+                         for query in distinct_queries}
+    expected_results = [expected_by_query[query] for query in queries]
+    assert async_results == expected_results, (
+        f"Unexpected asynchronous results: {set(async_results)}"
+    )
+    assert async_results[0] == "NCE/0,SFO/0", (
+        f"Unexpected asynchronous result: {async_results[0]}"
+    )
+
+    # Protobuf results are bytes objects
+    async def search_pb():
+        return await openTrepLibrary.searchAsync("P", "nce")
+
+    pb_result = asyncio.run(search_pb())
+    assert isinstance(pb_result, bytes) and len(pb_result) > 0, (
+        f"Unexpected Protobuf result: {pb_result}"
+    )
+
+    # The travel queries not searched yet when stopping give exceptions
+    async def search_and_stop():
+        futures = [openTrepLibrary.searchAsync("S", query)
+                   for query in queries[:50]]
+        openTrepLibrary.stopAsyncSearch()
+        return await asyncio.gather(*futures, return_exceptions=True)
+
+    stop_results = asyncio.run(search_and_stop())
+    assert all(isinstance(result, (str, RuntimeError))
+               for result in stop_results), (
+        f"Unexpected results when stopping: {stop_results}"
+    )
+
+    openTrepLibrary.finalize()
+
+
+def test_e2e_async_search_queue_full():
+    """
+    Test that a full submission queue of the asynchronous search is
+    reported at once, while the event loop keeps running
+    """
+    porPath = get_por_path()
+    logPath = f"{tmp_dir}/test_trep_e2e_async_full.log"
+    openTrepLibrary = init_library(porPath, logPath)
+
+    # Create the Xapian index
+    nb_of_por = openTrepLibrary.index()
+    assert nb_of_por == "9", (
+        f"Number of index POR: {nb_of_por}"
+    )
+
+    # A single thread, and a tiny submission queue, which fills up at once
+    queue_size = 2
+    started = openTrepLibrary.startAsyncSearch(1, queue_size)
+    assert started, (
+        f"The asynchronous search could not be started"
+    )
+
+    queries = ["nce sfo", "sfo", "nce", "sna"] * 50
+
+    async def fill_queue():
+        # The event loop ticks while the travel queries are submitted
+        nb_of_ticks = 0
+        stop_ticking = asyncio.Event()
+
+        async def tick():
+            nonlocal nb_of_ticks
+            while not stop_ticking.is_set():
+                nb_of_ticks += 1
+                await asyncio.sleep(0)
+
+        ticker = asyncio.create_task(tick())
+        await asyncio.sleep(0)
+
+        # Submit without waiting, until the queue be full
+        futures = []
+        is_full = False
+        for query in queries:
+            try:
+                futures.append(openTrepLibrary.searchAsync("S", query))
+            except pyopentrep.AsyncSearchQueueFull:
+                is_full = True
+                break
+        submitted_ticks = nb_of_ticks
+
+        # Then, submit the remaining ones, with the back-pressure
+        for query in queries[len(futures):]:
+            futures.append(await submit_async_search(openTrepLibrary,
+                                                     "S", query))
+        results = await asyncio.gather(*futures)
+
+        stop_ticking.set()
+        await ticker
+        return is_full, submitted_ticks, nb_of_ticks, results
+
+    is_full, submitted_ticks, nb_of_ticks, results = asyncio.run(fill_queue())
+    assert is_full, (
+        f"The submission queue has never been reported as full"
+    )
+    assert nb_of_ticks > submitted_ticks, (
+        f"The event loop has not kept running: {nb_of_ticks} ticks"
+    )
+    expected_results = openTrepLibrary.searchMany("S", queries, 0)
+    assert results == expected_results, (
+        f"Unexpected asynchronous results: {set(results)}"
+    )
+
+    # Once the pool stopped, waiting for a slot gives an exception
+    async def wait_and_stop():
+        futures = []
+        for query in queries:
+            try:
+                futures.append(openTrepLibrary.searchAsync("S", query))
+            except pyopentrep.AsyncSearchQueueFull:
+                break
+        slot = openTrepLibrary.waitAsyncSearchSlot()
+        openTrepLibrary.stopAsyncSearch()
+        await asyncio.gather(*futures, return_exceptions=True)
+        return await asyncio.gather(slot, return_exceptions=True)
+
+    slot_results = asyncio.run(wait_and_stop())
+    assert len(slot_results) == 1 and \
+        isinstance(slot_results[0], (type(None), RuntimeError)), (
+        f"Unexpected result when stopping: {slot_results}"
+    )
+
+    openTrepLibrary.finalize()